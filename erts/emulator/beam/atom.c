@@ -28,6 +28,7 @@
 #include "global.h"
 #include "hash.h"
 #include "atom.h"
+#include "erl_thr_progress.h"
 
 
 #define ATOM_SIZE  3000
@@ -43,6 +44,44 @@ static erts_smp_rwmtx_t atom_table_lock;
 #define atom_write_lock()	erts_smp_rwmtx_rwlock(&atom_table_lock)
 #define atom_write_unlock()	erts_smp_rwmtx_rwunlock(&atom_table_lock)
 
+/*
+ * Lock-free lookup table
+ *
+ * Besides the index table, which is protected by atom_table_lock, all
+ * atoms are kept in an open addressing hash table of atom pointers
+ * that managed threads (that is, schedulers) read without taking any
+ * lock. Since atoms are never removed, a slot only ever changes from
+ * empty to occupied, and a lookup that finds an empty slot can safely
+ * conclude that the atom does not exist. New atoms are inserted with
+ * the write lock held. When the table becomes half full, a copy of
+ * twice the size is published and the old table is deallocated when
+ * all managed threads have passed a thread progress point. Unmanaged
+ * threads, which thread progress does not wait for, use the same
+ * lookup table but hold the read lock while doing so; the table is
+ * only replaced with the write lock held, so it cannot be retired
+ * under them.
+ */
+
+#define ATOM_LOOKUP_MIN_SIZE 8192
+
+typedef struct atom_lookup_table_ {
+#ifdef ERTS_SMP
+    ErtsThrPrgrLaterOp lop;
+    struct atom_lookup_table_ *next; /* Retired tables */
+#endif
+    Uint size;			/* Number of slots; a power of two */
+    Uint count;			/* Number of atoms; protected by lock */
+    erts_smp_atomic_t slot[1];	/* Atom pointers */
+} AtomLookupTable;
+
+#define ATOM_LOOKUP_TABLE_BYTES(SZ) \
+    (offsetof(AtomLookupTable, slot) + (SZ) * sizeof(erts_smp_atomic_t))
+
+static erts_smp_atomic_t atom_lookup_table;
+#ifdef ERTS_SMP
+static AtomLookupTable *retired_lookup_tables; /* Protected by lock */
+#endif
+
 #if 0
 #define ERTS_ATOM_PUT_OPS_STAT
 #endif
@@ -202,6 +241,142 @@ atom_free(Atom* obj)
     erts_free(ERTS_ALC_T_ATOM, (void*) obj);
 }
 
+static AtomLookupTable *
+alloc_lookup_table(Uint size)
+{
+    AtomLookupTable *tab;
+    Uint i;
+
+    tab = erts_alloc(ERTS_ALC_T_ATOM_TABLE, ATOM_LOOKUP_TABLE_BYTES(size));
+    tab->size = size;
+    tab->count = 0;
+    for (i = 0; i < size; i++)
+	erts_smp_atomic_init_nob(&tab->slot[i], (erts_aint_t) NULL);
+    return tab;
+}
+
+static void
+free_lookup_table(void *vtab)
+{
+    erts_free(ERTS_ALC_T_ATOM_TABLE, vtab);
+}
+
+static ERTS_INLINE AtomLookupTable *
+get_lookup_table(void)
+{
+    return (AtomLookupTable *) erts_smp_atomic_read_ddrb(&atom_lookup_table);
+}
+
+/*
+ * Look up an atom without any locking. Must only be called by
+ * managed threads, or with the atom table lock held.
+ */
+static int
+lookup_atom(Atom *tmpl)
+{
+    AtomLookupTable *tab = get_lookup_table();
+    Uint mask = tab->size - 1;
+    HashValue hval = atom_hash(tmpl);
+    Uint ix = hval & mask;
+
+    while (1) {
+	Atom *ap = (Atom *) erts_smp_atomic_read_ddrb(&tab->slot[ix]);
+	if (!ap)
+	    return -1;
+	if (ap->slot.bucket.hvalue == hval && atom_cmp(tmpl, ap) == 0)
+	    return ap->slot.index;
+	ix = (ix + 1) & mask;
+    }
+}
+
+static void
+lookup_table_put(AtomLookupTable *tab, Atom *ap)
+{
+    Uint mask = tab->size - 1;
+    Uint ix = ap->slot.bucket.hvalue & mask;
+
+    while (erts_smp_atomic_read_nob(&tab->slot[ix]))
+	ix = (ix + 1) & mask;
+    erts_smp_atomic_set_relb(&tab->slot[ix], (erts_aint_t) ap);
+    tab->count++;
+}
+
+/*
+ * Deallocate a replaced lookup table when no managed thread can be
+ * reading it any more. Thread progress operations can only be
+ * scheduled from ordinary schedulers; tables replaced by other
+ * threads are kept until the next time a scheduler grows the table.
+ */
+static void
+retire_lookup_table(AtomLookupTable *old)
+{
+#ifdef ERTS_SMP
+    ErtsSchedulerData *esdp = erts_get_scheduler_data();
+
+    old->next = retired_lookup_tables;
+    retired_lookup_tables = old;
+    if (!esdp || ERTS_SCHEDULER_IS_DIRTY(esdp))
+	return;
+    while (retired_lookup_tables) {
+	old = retired_lookup_tables;
+	retired_lookup_tables = old->next;
+	erts_schedule_thr_prgr_later_cleanup_op(free_lookup_table,
+						(void *) old,
+						&old->lop,
+						ATOM_LOOKUP_TABLE_BYTES(old->size));
+    }
+#else
+    free_lookup_table(old);
+#endif
+}
+
+/*
+ * Make a newly created atom visible to lock-free lookups. Must be
+ * called with the write lock held.
+ */
+static void
+publish_atom(Atom *ap)
+{
+    AtomLookupTable *tab = get_lookup_table();
+
+    if (2 * (tab->count + 1) > tab->size) {
+	AtomLookupTable *old = tab;
+	Uint i;
+
+	tab = alloc_lookup_table(2 * old->size);
+	for (i = 0; i < old->size; i++) {
+	    Atom *oap = (Atom *) erts_smp_atomic_read_nob(&old->slot[i]);
+	    if (oap)
+		lookup_table_put(tab, oap);
+	}
+	lookup_table_put(tab, ap);
+	erts_smp_atomic_set_relb(&atom_lookup_table, (erts_aint_t) tab);
+	retire_lookup_table(old);
+    }
+    else {
+	lookup_table_put(tab, ap);
+    }
+}
+
+/*
+ * Look up an existing atom; take the read lock unless this thread
+ * is known by thread progress.
+ */
+static ERTS_INLINE int
+get_atom_index(Atom *tmpl)
+{
+#ifdef ERTS_SMP
+    if (!erts_thr_progress_is_managed_thread()) {
+	int aix;
+	atom_read_lock();
+	aix = lookup_atom(tmpl);
+	atom_read_unlock();
+	return aix;
+    }
+#endif
+    return lookup_atom(tmpl);
+}
+
 static void latin1_to_utf8(byte* conv_buf, const byte** srcp, int* lenp)
 {
     byte* dst;
@@ -243,7 +418,7 @@ erts_atom_put(const byte *name, int len, ErtsAtomEncoding enc, int trunc)
     int tlen = len;
     Sint no_latin1_chars;
     Atom a;
-    int aix;
+    int aix, entries;
 
 #ifdef ERTS_ATOM_PUT_OPS_STAT
     erts_smp_atomic_inc_nob(&atom_put_ops);
@@ -290,9 +465,7 @@ erts_atom_put(const byte *name, int len, ErtsAtomEncoding enc, int trunc)
 
     a.len = tlen;
     a.name = (byte *) text;
-    atom_read_lock();
-    aix = index_get(&erts_atom_table, (void*) &a);
-    atom_read_unlock();
+    aix = get_atom_index(&a);
     if (aix >= 0) {
 	/* Already in table no need to verify it */
 	return make_atom(aix);
@@ -331,7 +504,10 @@ erts_atom_put(const byte *name, int len, ErtsAtomEncoding enc, int trunc)
     a.latin1_chars = (Sint16) no_latin1_chars;
     a.name = (byte *) text;
     atom_write_lock();
+    entries = erts_atom_table.entries;
     aix = index_put(&erts_atom_table, (void*) &a);
+    if (erts_atom_table.entries != entries)
+	publish_atom(atom_tab(aix));
     atom_write_unlock();
     return make_atom(aix);
 }
@@ -367,7 +543,8 @@ int atom_table_sz(void)
     if (lock)
 	atom_read_lock();
 #endif
-    ret = index_table_sz(&erts_atom_table);
+    ret = index_table_sz(&erts_atom_table)
+	+ ATOM_LOOKUP_TABLE_BYTES(get_lookup_table()->size);
 #ifdef ERTS_SMP
     if (lock)
 	atom_read_unlock();
@@ -389,10 +566,8 @@ erts_atom_get(const char *name, int len, Eterm* ap, ErtsAtomEncoding enc)
 	latin1_to_utf8(utf8_copy, (const byte**)&a.name, &len);
 	a.len = (Sint16) len;
     }
-    atom_read_lock();
-    i = index_get(&erts_atom_table, (void*) &a);
+    i = get_atom_index(&a);
     res = i < 0 ? 0 : (*ap = make_atom(i), 1);
-    atom_read_unlock();
     return res;
 }
 
@@ -447,6 +622,11 @@ init_atom_table(void)
 
     erts_index_init(ERTS_ALC_T_ATOM_TABLE, &erts_atom_table,
 		    "atom_tab", ATOM_SIZE, erts_atom_table_size, f);
+    erts_smp_atomic_init_nob(&atom_lookup_table,
+			     (erts_aint_t) alloc_lookup_table(ATOM_LOOKUP_MIN_SIZE));
+#ifdef ERTS_SMP
+    retired_lookup_tables = NULL;
+#endif
     more_atom_space();
 
     /* Ordinary atoms */
@@ -466,6 +646,7 @@ init_atom_table(void)
 	atom_text_pos -= a.len;
 	atom_space -= a.len;
 	atom_tab(ix)->name = (byte*)erl_atom_names[i];
+	publish_atom(atom_tab(ix));
     }
 }
 
@@ -45,8 +45,20 @@ static void set_default_trace_pattern(Eterm module);
 static Eterm check_process_code(Process* rp, Module* modp, Uint flags, int *redsp, int fcalls);
 static void delete_code(Module* modp);
 static void decrement_refc(BeamCodeHeader*);
-static int any_heap_ref_ptrs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size);
-static int any_heap_refs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size);
+
+/*
+ * A batch of literal areas not belonging to any module, sorted on
+ * start address; see erts_queue_release_literal_area().
+ */
+typedef struct {
+    ErtsLiteralArea **areas; /* NULL terminated */
+    Uint n;
+} ErtsLiteralBatch;
+
+static int any_heap_ref_ptrs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size,
+			     ErtsLiteralBatch *batch);
+static int any_heap_refs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size,
+			 ErtsLiteralBatch *batch);
 
 BIF_RETTYPE code_is_module_native_1(BIF_ALIST_1)
 {
@@ -767,10 +779,12 @@ check_mod_funs(Process *p, ErlOffHeap *off_heap, char *area, size_t area_size)
 }
 
 static Uint hfrag_literal_size(Eterm* start, Eterm* end,
-                               char* lit_start, Uint lit_size);
+                               char* lit_start, Uint lit_size,
+                               ErtsLiteralBatch *batch);
 static void hfrag_literal_copy(Eterm **hpp, ErlOffHeap *ohp,
                                Eterm *start, Eterm *end,
-                               char *lit_start, Uint lit_size);
+                               char *lit_start, Uint lit_size,
+                               ErtsLiteralBatch *batch);
 
 static Eterm
 check_process_code(Process* rp, Module* modp, Uint flags, int *redsp, int fcalls)
@@ -882,7 +896,7 @@ check_process_code(Process* rp, Module* modp, Uint flags, int *redsp, int fcalls
                 if (check_mod_funs(rp, &hfrag->off_heap, mod_start, mod_size))
                     return am_true;
                 lit_sz += hfrag_literal_size(&hf->mem[0], &hf->mem[hf->used_size],
-                                             literals, lit_bsize);
+                                             literals, lit_bsize, NULL);
             }
             if (lit_sz > 0) {
                 ErlHeapFragment *bp = new_message_buffer(lit_sz);
@@ -891,7 +905,7 @@ check_process_code(Process* rp, Module* modp, Uint flags, int *redsp, int fcalls
                 for (hf=hfrag; hf; hf = hf->next) {
                     hfrag_literal_copy(&hp, &bp->off_heap,
                                        &hf->mem[0], &hf->mem[hf->used_size],
-                                       literals, lit_bsize);
+                                       literals, lit_bsize, NULL);
                     hfrag=hf;
                 }
                 /* link new hfrag last */
@@ -913,20 +927,20 @@ check_process_code(Process* rp, Module* modp, Uint flags, int *redsp, int fcalls
              */
             return am_false;
         }
-	if (any_heap_ref_ptrs(&rp->fvalue, &rp->fvalue+1, literals, lit_bsize)) {
+	if (any_heap_ref_ptrs(&rp->fvalue, &rp->fvalue+1, literals, lit_bsize, NULL)) {
 	    rp->freason = EXC_NULL;
 	    rp->fvalue = NIL;
 	    rp->ftrace = NIL;
 	}
-	if (any_heap_ref_ptrs(rp->stop, rp->hend, literals, lit_bsize))
+	if (any_heap_ref_ptrs(rp->stop, rp->hend, literals, lit_bsize, NULL))
 	    goto try_literal_gc;
 #ifdef HIPE
 	if (nstack_any_heap_ref_ptrs(rp, literals, lit_bsize))
 	    goto try_literal_gc;
 #endif
-	if (any_heap_refs(rp->heap, rp->htop, literals, lit_bsize))
+	if (any_heap_refs(rp->heap, rp->htop, literals, lit_bsize, NULL))
 	    goto try_literal_gc;
-	if (any_heap_refs(rp->old_heap, rp->old_htop, literals, lit_bsize))
+	if (any_heap_refs(rp->old_heap, rp->old_htop, literals, lit_bsize, NULL))
 	    goto try_literal_gc;
 
 	/* Check dictionary */
@@ -934,7 +948,7 @@ check_process_code(Process* rp, Module* modp, Uint flags, int *redsp, int fcalls
 	    Eterm* start = ERTS_PD_START(rp->dictionary);
 	    Eterm* end = start + ERTS_PD_SIZE(rp->dictionary);
 
-	    if (any_heap_ref_ptrs(start, end, literals, lit_bsize))
+	    if (any_heap_ref_ptrs(start, end, literals, lit_bsize, NULL))
 		goto try_literal_gc;
 	}
 
@@ -946,7 +960,7 @@ check_process_code(Process* rp, Module* modp, Uint flags, int *redsp, int fcalls
 
 	    hp = &hfrag->mem[0];
 	    hp_end = &hfrag->mem[hfrag->used_size];
-	    if (any_heap_refs(hp, hp_end, literals, lit_bsize))
+	    if (any_heap_refs(hp, hp_end, literals, lit_bsize, NULL))
 		goto try_literal_gc;
 	}
 
@@ -965,7 +979,7 @@ check_process_code(Process* rp, Module* modp, Uint flags, int *redsp, int fcalls
 		hp = &hfrag->mem[0];
 		hp_end = &hfrag->mem[hfrag->used_size];
 
-                if (any_heap_refs(hp, hp_end, literals, lit_bsize))
+                if (any_heap_refs(hp, hp_end, literals, lit_bsize, NULL))
                     goto try_literal_gc;
 	    }
 	}
@@ -1015,8 +1029,43 @@ check_process_code(Process* rp, Module* modp, Uint flags, int *redsp, int fcalls
 
 }
 
+/*
+ * Is 'val' a pointer into the literal range [mod_start, mod_start+mod_size)?
+ * When releasing a batch of literal areas the range spans the whole
+ * batch, and may include literals not being released in between the
+ * areas; the pointer then also has to be inside one of the areas.
+ */
+static ERTS_INLINE int
+in_literal_range(Eterm val, char* mod_start, Uint mod_size,
+		 ErtsLiteralBatch *batch)
+{
+    Eterm *ptr;
+    Uint lo, hi;
+
+    if (!ErtsInArea(val, mod_start, mod_size))
+	return 0;
+    if (!batch)
+	return 1;
+
+    ptr = (Eterm *) ptr_val(val);
+    lo = 0;
+    hi = batch->n;
+    while (lo < hi) {
+	Uint mid = (lo + hi) / 2;
+	ErtsLiteralArea *la = batch->areas[mid];
+	if (ptr < la->start)
+	    hi = mid;
+	else if (ptr >= la->start + la->size)
+	    lo = mid + 1;
+	else
+	    return 1;
+    }
+    return 0;
+}
+
 static int
-any_heap_ref_ptrs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size)
+any_heap_ref_ptrs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size,
+		  ErtsLiteralBatch *batch)
 {
     Eterm* p;
     Eterm val;
@@ -1026,7 +1075,7 @@ any_heap_ref_ptrs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size)
 	switch (primary_tag(val)) {
 	case TAG_PRIMARY_BOXED:
 	case TAG_PRIMARY_LIST:
-	    if (ErtsInArea(val, mod_start, mod_size)) {
+	    if (in_literal_range(val, mod_start, mod_size, batch)) {
 		return 1;
 	    }
 	    break;
@@ -1036,7 +1085,8 @@ any_heap_ref_ptrs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size)
 }
 
 static int
-any_heap_refs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size)
+any_heap_refs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size,
+	      ErtsLiteralBatch *batch)
 {
     Eterm* p;
     Eterm val;
@@ -1046,7 +1096,7 @@ any_heap_refs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size)
 	switch (primary_tag(val)) {
 	case TAG_PRIMARY_BOXED:
 	case TAG_PRIMARY_LIST:
-	    if (ErtsInArea(val, mod_start, mod_size)) {
+	    if (in_literal_range(val, mod_start, mod_size, batch)) {
 		return 1;
 	    }
 	    break;
@@ -1056,7 +1106,7 @@ any_heap_refs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size)
                 if (header_is_bin_matchstate(val)) {
                     ErlBinMatchState *ms = (ErlBinMatchState*) p;
                     ErlBinMatchBuffer *mb = &(ms->mb);
-                    if (ErtsInArea(mb->orig, mod_start, mod_size)) {
+                    if (in_literal_range(mb->orig, mod_start, mod_size, batch)) {
                         return 1;
                     }
                 }
@@ -1070,7 +1120,8 @@ any_heap_refs(Eterm* start, Eterm* end, char* mod_start, Uint mod_size)
 }
 
 static Uint
-hfrag_literal_size(Eterm* start, Eterm* end, char* lit_start, Uint lit_size)
+hfrag_literal_size(Eterm* start, Eterm* end, char* lit_start, Uint lit_size,
+		   ErtsLiteralBatch *batch)
 {
     Eterm* p;
     Eterm val;
@@ -1081,7 +1132,7 @@ hfrag_literal_size(Eterm* start, Eterm* end, char* lit_start, Uint lit_size)
         switch (primary_tag(val)) {
         case TAG_PRIMARY_BOXED:
         case TAG_PRIMARY_LIST:
-            if (ErtsInArea(val, lit_start, lit_size)) {
+            if (in_literal_range(val, lit_start, lit_size, batch)) {
                 sz += size_object(val);
             }
             break;
@@ -1091,7 +1142,7 @@ hfrag_literal_size(Eterm* start, Eterm* end, char* lit_start, Uint lit_size)
                 if (header_is_bin_matchstate(val)) {
                     ErlBinMatchState *ms = (ErlBinMatchState*) p;
                     ErlBinMatchBuffer *mb = &(ms->mb);
-                    if (ErtsInArea(mb->orig, lit_start, lit_size)) {
+                    if (in_literal_range(mb->orig, lit_start, lit_size, batch)) {
                         sz += size_object(mb->orig);
                     }
                 }
@@ -1107,7 +1158,8 @@ hfrag_literal_size(Eterm* start, Eterm* end, char* lit_start, Uint lit_size)
 static void
 hfrag_literal_copy(Eterm **hpp, ErlOffHeap *ohp,
                    Eterm *start, Eterm *end,
-                   char *lit_start, Uint lit_size) {
+                   char *lit_start, Uint lit_size,
+                   ErtsLiteralBatch *batch) {
     Eterm* p;
     Eterm val;
     Uint sz;
@@ -1117,7 +1169,7 @@ hfrag_literal_copy(Eterm **hpp, ErlOffHeap *ohp,
         switch (primary_tag(val)) {
         case TAG_PRIMARY_BOXED:
         case TAG_PRIMARY_LIST:
-            if (ErtsInArea(val, lit_start, lit_size)) {
+            if (in_literal_range(val, lit_start, lit_size, batch)) {
                 sz = size_object(val);
                 val = copy_struct(val, sz, hpp, ohp);
                 *p = val; 
@@ -1130,7 +1182,7 @@ hfrag_literal_copy(Eterm **hpp, ErlOffHeap *ohp,
                 if (header_is_bin_matchstate(val)) {
                     ErlBinMatchState *ms = (ErlBinMatchState*) p;
                     ErlBinMatchBuffer *mb = &(ms->mb);
-                    if (ErtsInArea(mb->orig, lit_start, lit_size)) {
+                    if (in_literal_range(mb->orig, lit_start, lit_size, batch)) {
                         sz = size_object(mb->orig);
                         mb->orig = copy_struct(mb->orig, sz, hpp, ohp);
                     }
@@ -1236,6 +1288,324 @@ static void copy_literals_commit(void* null) {
 }
 #endif /* ERTS_SMP */
 
+/*
+ * Release of literal areas not belonging to any module
+ *
+ * Such areas, e.g. the objects of ETS tables created with the
+ * literal_objects option, are handed over by their owner with
+ * erts_queue_release_literal_area() when no longer used. The code
+ * purger is then notified and performs the following steps:
+ *
+ * erts_internal:release_literal_areas(true)
+ *   Switches in all queued areas as the current batch. erts_clrange
+ *   is set to the range spanning the batch so that literals in it
+ *   are copied instead of referred when sent in messages. The range
+ *   may also cover literals not being released; these will then also
+ *   be copied which is harmless.
+ * ------ THR PROG COMMIT -----
+ *
+ *  - copy_literals system task on all processes, see
+ *    erts_proc_copy_literal_area(). Only references into the areas
+ *    of the batch make a process copy or garbage collect.
+ *  ...
+ * erts_internal:release_literal_areas(false)
+ *   Clears erts_clrange.
+ * ------ THR PROG COMMIT -----
+ *   The areas of the batch are freed.
+ */
+
+Eterm erts_code_purger = THE_NON_VALUE;
+
+static erts_smp_mtx_t release_literal_areas_mtx;
+static ErtsLiteralArea *release_literal_areas_queue; /* Protected by mtx */
+static int release_literal_areas_notified;	      /* Protected by mtx */
+
+/* Protected by code_write_permission */
+static ErtsLiteralBatch release_literal_batch;
+
+void
+erts_beam_bif_load_init(void)
+{
+    erts_smp_mtx_init(&release_literal_areas_mtx, "release_literal_areas");
+    release_literal_areas_queue = NULL;
+    release_literal_areas_notified = 0;
+    release_literal_batch.areas = NULL;
+    release_literal_batch.n = 0;
+}
+
+static void
+notify_code_purger(void *unused)
+{
+    Process *rp = erts_proc_lookup(erts_code_purger);
+    if (rp) {
+	ErtsMessage *mp = erts_alloc_message(0, NULL);
+	erts_queue_message(rp, 0, mp, am_release_literal_areas, am_system);
+    }
+}
+
+/*
+ * Hand over a literal area to the code purger which frees 'block',
+ * of allocation type 'type', and cleans up the off heap list 'oh'
+ * when no process refers the terms at 'start' any more. May be
+ * called with arbitrary locks held.
+ */
+void
+erts_queue_release_literal_area(ErtsAlcType_t type, void *block,
+				Eterm *start, Uint size,
+				struct erl_off_heap_header *oh)
+{
+    int notify;
+    ErtsLiteralArea *la = erts_alloc(ERTS_ALC_T_RELEASE_LAREA,
+				     sizeof(ErtsLiteralArea));
+    la->type = type;
+    la->block = block;
+    la->start = start;
+    la->size = size;
+    la->off_heap = oh;
+
+    erts_smp_mtx_lock(&release_literal_areas_mtx);
+    la->next = release_literal_areas_queue;
+    release_literal_areas_queue = la;
+    notify = !release_literal_areas_notified;
+    release_literal_areas_notified = 1;
+    erts_smp_mtx_unlock(&release_literal_areas_mtx);
+
+    if (notify)
+	erts_schedule_misc_aux_work(1, notify_code_purger, NULL);
+}
+
+static int
+cmp_literal_areas(const void *a, const void *b)
+{
+    Eterm *sa = (*(ErtsLiteralArea **) a)->start;
+    Eterm *sb = (*(ErtsLiteralArea **) b)->start;
+    return sa < sb ? -1 : (sa > sb ? 1 : 0);
+}
+
+static void
+free_literal_areas(ErtsLiteralArea **areas)
+{
+    ErtsLiteralArea **lap;
+    for (lap = areas; *lap; lap++) {
+	ErtsLiteralArea *la = *lap;
+	ErlOffHeap oh;
+	oh.first = la->off_heap;
+	erts_cleanup_offheap(&oh);
+	erts_free(la->type, la->block);
+	erts_free(ERTS_ALC_T_RELEASE_LAREA, la);
+    }
+    erts_free(ERTS_ALC_T_RELEASE_LAREA, areas);
+}
+
+#ifdef ERTS_SMP
+static void
+release_literal_areas_commit(void *areas)
+{
+    copy_literals_commit(NULL);
+    if (areas)
+	free_literal_areas((ErtsLiteralArea **) areas);
+}
+#endif
+
+BIF_RETTYPE erts_internal_release_literal_areas_1(BIF_ALIST_1)
+{
+    ErtsLiteralArea **free_areas = NULL;
+    Eterm res = am_true;
+
+    if (am_true != BIF_ARG_1 && am_false != BIF_ARG_1) {
+	BIF_ERROR(BIF_P, BADARG);
+    }
+
+    if (!erts_try_seize_code_write_permission(BIF_P)) {
+	ERTS_BIF_YIELD1(bif_export[BIF_erts_internal_release_literal_areas_1],
+			BIF_P, BIF_ARG_1);
+    }
+
+    if (BIF_ARG_1 == am_true) {
+	ErtsLiteralArea *la, *queue, **areas;
+	Uint n;
+
+	if (erts_clrange.ptr != NULL) {
+	    res = am_aborted;
+	    goto done;
+	}
+
+	erts_smp_mtx_lock(&release_literal_areas_mtx);
+	queue = release_literal_areas_queue;
+	release_literal_areas_queue = NULL;
+	release_literal_areas_notified = 0;
+	erts_smp_mtx_unlock(&release_literal_areas_mtx);
+
+	if (!queue) {
+	    res = am_false;
+	    goto done;
+	}
+
+	for (n = 0, la = queue; la; la = la->next)
+	    n++;
+	areas = erts_alloc(ERTS_ALC_T_RELEASE_LAREA,
+			   (n + 1) * sizeof(ErtsLiteralArea *));
+	for (n = 0, la = queue; la; la = la->next)
+	    areas[n++] = la;
+	areas[n] = NULL;
+	qsort(areas, n, sizeof(ErtsLiteralArea *), cmp_literal_areas);
+
+	release_literal_batch.areas = areas;
+	release_literal_batch.n = n;
+	erts_clrange.ptr = areas[0]->start;
+	erts_clrange.sz  = (areas[n-1]->start + areas[n-1]->size) - areas[0]->start;
+	erts_clrange.pid = BIF_P->common.id;
+    }
+    else {
+	if (!release_literal_batch.areas
+	    || erts_clrange.pid != BIF_P->common.id) {
+	    res = am_false;
+	    goto done;
+	}
+	free_areas = release_literal_batch.areas;
+	release_literal_batch.areas = NULL;
+	release_literal_batch.n = 0;
+	erts_clrange.ptr = NULL;
+	erts_clrange.sz  = 0;
+	erts_clrange.pid = THE_NON_VALUE;
+    }
+
+#ifdef ERTS_SMP
+    ASSERT(committer_state.stager == NULL);
+    committer_state.stager = BIF_P;
+    erts_schedule_thr_prgr_later_op(release_literal_areas_commit,
+				    (void *) free_areas,
+				    &committer_state.lop);
+    erts_proc_inc_refc(BIF_P);
+    erts_suspend(BIF_P, ERTS_PROC_LOCK_MAIN, NULL);
+    ERTS_BIF_YIELD_RETURN(BIF_P, am_true);
+#else
+    if (free_areas)
+	free_literal_areas(free_areas);
+#endif
+done:
+    erts_release_code_write_permission();
+    BIF_RET(res);
+}
+
+/*
+ * Executed as a copy_literals system task by each process while
+ * a batch of literal areas is being released. Literals in the batch
+ * referred from messages in the queue are copied into the messages.
+ * Returns 'aborted' if literals in the batch are referred from the
+ * heap and 'gc_allowed' is false; otherwise, the process is garbage
+ * collected so that it refers its own copies, and 'ok' is returned.
+ * THE_NON_VALUE is returned if garbage collection is disabled.
+ */
+Eterm
+erts_proc_copy_literal_area(Process *c_p, int *redsp, int fcalls,
+			    int gc_allowed)
+{
+    ErtsLiteralBatch *batch = &release_literal_batch;
+    ErtsLiteralArea **areas = batch->areas;
+    Uint n = batch->n;
+    char *literals;
+    Uint lit_bsize;
+    ErtsMessage *msgp;
+    ErlHeapFragment *hfrag;
+
+    if (!areas)
+	return am_ok;
+
+    literals = (char *) erts_clrange.ptr;
+    lit_bsize = erts_clrange.sz * sizeof(Eterm);
+
+    if (c_p->flags & F_DISABLE_GC)
+	return THE_NON_VALUE;
+
+    erts_smp_proc_lock(c_p, ERTS_PROC_LOCK_MSGQ);
+    ERTS_SMP_MSGQ_MV_INQ2PRIVQ(c_p);
+    erts_smp_proc_unlock(c_p, ERTS_PROC_LOCK_MSGQ);
+
+    for (msgp = c_p->msg.first; msgp; msgp = msgp->next) {
+	ErlHeapFragment *hf;
+	Uint lit_sz = 0;
+
+	if (msgp->data.attached == ERTS_MSG_COMBINED_HFRAG)
+	    hfrag = &msgp->hfrag;
+	else if (is_value(ERL_MESSAGE_TERM(msgp)) && msgp->data.heap_frag)
+	    hfrag = msgp->data.heap_frag;
+	else
+	    continue;
+
+	for (hf = hfrag; hf; hf = hf->next)
+	    lit_sz += hfrag_literal_size(&hf->mem[0], &hf->mem[hf->used_size],
+					 literals, lit_bsize, batch);
+	if (lit_sz > 0) {
+	    ErlHeapFragment *bp = new_message_buffer(lit_sz);
+	    Eterm *hp = bp->mem;
+
+	    for (hf = hfrag; hf; hf = hf->next) {
+		hfrag_literal_copy(&hp, &bp->off_heap,
+				   &hf->mem[0], &hf->mem[hf->used_size],
+				   literals, lit_bsize, batch);
+		hfrag = hf;
+	    }
+	    /* link new hfrag last */
+	    ASSERT(hfrag->next == NULL);
+	    hfrag->next = bp;
+	    bp->next = NULL;
+	}
+    }
+
+    if (any_heap_ref_ptrs(&c_p->fvalue, &c_p->fvalue+1, literals, lit_bsize, batch)) {
+	c_p->freason = EXC_NULL;
+	c_p->fvalue = NIL;
+	c_p->ftrace = NIL;
+    }
+    if (any_heap_ref_ptrs(c_p->stop, c_p->hend, literals, lit_bsize, batch))
+	goto literal_gc;
+#ifdef HIPE
+    /* Only checks the range spanning the batch */
+    if (nstack_any_heap_ref_ptrs(c_p, literals, lit_bsize))
+	goto literal_gc;
+#endif
+    if (any_heap_refs(c_p->heap, c_p->htop, literals, lit_bsize, batch))
+	goto literal_gc;
+    if (any_heap_refs(c_p->old_heap, c_p->old_htop, literals, lit_bsize, batch))
+	goto literal_gc;
+    if (c_p->dictionary) {
+	Eterm *start = ERTS_PD_START(c_p->dictionary);
+	Eterm *end = start + ERTS_PD_SIZE(c_p->dictionary);
+	if (any_heap_ref_ptrs(start, end, literals, lit_bsize, batch))
+	    goto literal_gc;
+    }
+    for (hfrag = c_p->mbuf; hfrag; hfrag = hfrag->next) {
+	if (any_heap_refs(&hfrag->mem[0], &hfrag->mem[hfrag->used_size],
+			  literals, lit_bsize, batch))
+	    goto literal_gc;
+    }
+    for (msgp = c_p->msg_frag; msgp; msgp = msgp->next) {
+	for (hfrag = erts_message_to_heap_frag(msgp); hfrag; hfrag = hfrag->next) {
+	    if (any_heap_refs(&hfrag->mem[0], &hfrag->mem[hfrag->used_size],
+			      literals, lit_bsize, batch))
+		goto literal_gc;
+	}
+    }
+
+    return am_ok;
+
+literal_gc:
+
+    if (!gc_allowed)
+	return am_aborted;
+
+    c_p->freason = EXC_NULL;
+    c_p->fvalue = NIL;
+    c_p->ftrace = NIL;
+
+    FLAGS(c_p) |= F_NEED_FULLSWEEP;
+    *redsp += erts_garbage_collect_nobump(c_p, 0, c_p->arg_reg, c_p->arity, fcalls);
+    *redsp += erts_garbage_collect_literal_areas(c_p, areas, n) / 64;
+
+    return am_ok;
+}
+
 
 /* Do the actualy module purging and return:
  * true for success
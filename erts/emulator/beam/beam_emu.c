@@ -1839,6 +1839,7 @@ void process_main(void)
   *             call make_ref/monitor            Optional
   *             ...
   *             recv_set L1                      Optional
+  *             recv_ref Ref                     Optional
   *      L1:          <-------------------+
   *                   <-----------+       |
   *     	     	       	  |   	  |
@@ -1868,6 +1869,23 @@ void process_main(void)
      Next(1);
  }
 
+ OpCase(i_recv_ref_y): {
+     /*
+      * The receive statement that follows can only match out
+      * messages that are tuples containing Ref as an element. If
+      * no other position in the message queue has been saved, use
+      * the index of the message queue to skip the messages that
+      * do not contain Ref.
+      */
+     Eterm ref = yb(Arg(0));
+     if (is_ref(ref) && c_p->msg.save == &c_p->msg.first) {
+	 ErtsMessage **save = erts_msgq_ix_lookup(c_p, ref);
+	 if (save)
+	     c_p->msg.save = save;
+     }
+     Next(1);
+ }
+
  OpCase(i_recv_set): {
      /*
       * If the mark is valid (points to the loop_rec/2
@@ -2162,6 +2180,7 @@ void process_main(void)
 	     SWAPOUT;
 	     c_p->arity = 0;
 	     erts_smp_atomic32_read_band_relb(&c_p->state, ~ERTS_PSFLG_ACTIVE);
+	     ERTS_SMP_MSGQ_SHARDS_CHK_WAIT(c_p);
 	     ASSERT(!ERTS_PROC_IS_EXITING(c_p));
 	     erts_smp_proc_unlock(c_p, ERTS_PROC_LOCKS_MSG_RECEIVE);
 	     c_p->current = NULL;
@@ -6408,9 +6427,13 @@ erts_hibernate(Process* c_p, Eterm module, Eterm function, Eterm args, Eterm* re
 	}
 #else /* ERTS_SMP */
         ERTS_SMP_MSGQ_MV_INQ2PRIVQ(c_p);
-	if (!c_p->msg.len)
+	if (!c_p->msg.len) {
 #endif
 	    erts_smp_atomic32_read_band_relb(&c_p->state, ~ERTS_PSFLG_ACTIVE);
+#ifdef ERTS_SMP
+	    ERTS_SMP_MSGQ_SHARDS_CHK_WAIT(c_p);
+	}
+#endif
 	ASSERT(!ERTS_PROC_IS_EXITING(c_p));
     }
     erts_smp_proc_unlock(c_p, ERTS_PROC_LOCK_MSGQ|ERTS_PROC_LOCK_STATUS);
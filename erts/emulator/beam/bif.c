@@ -1889,6 +1889,12 @@ BIF_RETTYPE process_flag_2(BIF_ALIST_2)
 	   goto error;
        BIF_RET(old_value);
    }
+   else if (BIF_ARG_1 == am_message_queue_shards) {
+       old_value = erts_change_message_queue_shards(BIF_P, BIF_ARG_2);
+       if (is_non_value(old_value))
+	   goto error;
+       BIF_RET(old_value);
+   }
    else if (BIF_ARG_1 == am_sensitive) {
        Uint is_sensitive;
        if (BIF_ARG_2 == am_true) {
@@ -3869,6 +3875,16 @@ BIF_RETTYPE garbage_collect_0(BIF_ALIST_0)
 {
     FLAGS(BIF_P) |= F_NEED_FULLSWEEP;
     erts_garbage_collect(BIF_P, 0, NULL, 0);
+#ifdef ERTS_DIRTY_SCHEDULERS
+    if (FLAGS(BIF_P) & F_DIRTY_MAJOR_GC) {
+	/*
+	 * The collection was handed over to a dirty cpu scheduler.
+	 * It is done before the process executes again, so yield
+	 * before returning in order to keep the call synchronous...
+	 */
+	ERTS_BIF_YIELD_RETURN(BIF_P, am_true);
+    }
+#endif
     BIF_RET(am_true);
 }
 
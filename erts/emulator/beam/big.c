@@ -723,6 +723,251 @@ static dsize_t I_sqr(ErtsDigit* x, dsize_t xl, ErtsDigit* r)
 	return (s - r0) + 1;
 }
 
+/*
+** Karatsuba multiplication and squaring
+**
+** Operands of at least KARATSUBA_MUL_THRESHOLD (KARATSUBA_SQR_THRESHOLD)
+** digits are split as x = x1*B^m + x0 and the product is computed from
+** the three half sized products x0*y0, x1*y1 and (x0+x1)*(y0+y1), which
+** gives O(n^1.585) instead of O(n^2). Below the thresholds the
+** schoolbook I_mul and I_sqr are faster. The thresholds were found with the
+** big_bench group of big_SUITE on x86_64.
+**
+** The K_ functions work on digit vectors that need not be normalized,
+** always write exactly xl+yl digits of result and take their temporary
+** storage from t (see K_mul_scratch and K_sqr_scratch).
+*/
+
+#define KARATSUBA_MUL_THRESHOLD 16
+#define KARATSUBA_SQR_THRESHOLD 32
+
+/*
+** Add y to x and store the xl digits of the result in r, return carry
+** Assumption: xl >= yl
+*/
+static ErtsDigit K_add(ErtsDigit* x, dsize_t xl, ErtsDigit* y, dsize_t yl,
+		       ErtsDigit* r)
+{
+    ErtsDigit c = 0;
+    dsize_t i;
+
+    ASSERT(xl >= yl);
+    for (i = 0; i < yl; i++)
+	DSUMc(x[i], y[i], c, r[i]);
+    for (; i < xl; i++)
+	DSUM(x[i], c, c, r[i]);
+    return c;
+}
+
+/*
+** Add y to the rl digits in r, return carry
+*/
+static ErtsDigit K_add_in(ErtsDigit* r, dsize_t rl, ErtsDigit* y, dsize_t yl)
+{
+    ErtsDigit c = 0;
+    dsize_t i;
+
+    ASSERT(rl >= yl);
+    for (i = 0; i < yl; i++)
+	DSUMc(r[i], y[i], c, r[i]);
+    for (; c && i < rl; i++)
+	DSUM(r[i], c, c, r[i]);
+    return c;
+}
+
+/*
+** Subtract y from the rl digits in r, return borrow
+*/
+static ErtsDigit K_sub_in(ErtsDigit* r, dsize_t rl, ErtsDigit* y, dsize_t yl)
+{
+    ErtsDigit b = 0;
+    dsize_t i;
+
+    ASSERT(rl >= yl);
+    for (i = 0; i < yl; i++)
+	DSUBb(r[i], y[i], b, r[i]);
+    for (; b && i < rl; i++)
+	DSUB(r[i], b, b, r[i]);
+    return b;
+}
+
+/*
+** Number of temporary digits needed by K_mul
+*/
+static dsize_t K_mul_scratch(dsize_t xl, dsize_t yl)
+{
+    dsize_t m, h, ly;
+
+    if (xl < yl) {
+	dsize_t tl = xl;
+	xl = yl;
+	yl = tl;
+    }
+    if (yl < KARATSUBA_MUL_THRESHOLD)
+	return 0;
+    if (xl >= 2*yl)
+	return 2*yl + K_mul_scratch(yl, yl);
+    m = xl / 2;
+    h = xl - m;
+    ly = ((yl - m > m) ? yl - m : m) + 1;
+    return 2*(h + 1 + ly) + K_mul_scratch(h + 1, ly);
+}
+
+/*
+** Multiply digits in x with digits in y and store the xl+yl digits
+** of the product in r
+*/
+static void K_mul(ErtsDigit* x, dsize_t xl, ErtsDigit* y, dsize_t yl,
+		  ErtsDigit* r, ErtsDigit* t)
+{
+    if (xl < yl) {
+	ErtsDigit* tp = x;
+	dsize_t tl = xl;
+	x = y; xl = yl;
+	y = tp; yl = tl;
+    }
+
+    if (yl < KARATSUBA_MUL_THRESHOLD) {
+	ZERO_DIGITS(r, yl);
+	I_mul(x, xl, y, yl, r);
+    }
+    else if (xl >= 2*yl) {
+	/* Unbalanced, multiply y with one yl digit chunk of x at a time */
+	dsize_t rl = xl + yl;
+	dsize_t i;
+
+	ZERO_DIGITS(r, rl);
+	for (i = 0; i < xl; i += yl) {
+	    dsize_t cl = (xl - i < yl) ? xl - i : yl;
+	    K_mul(x+i, cl, y, yl, t, t + 2*yl);
+	    K_add_in(r+i, rl-i, t, cl+yl);
+	}
+    }
+    else {
+	dsize_t m = xl / 2;
+	dsize_t h = xl - m;
+	dsize_t rl = xl + yl;
+	dsize_t ly, zl;
+	ErtsDigit* sx;
+	ErtsDigit* sy;
+	ErtsDigit* z;
+
+	K_mul(x, m, y, m, r, t);		/* x0*y0 */
+	K_mul(x+m, h, y+m, yl-m, r+2*m, t);	/* x1*y1 */
+
+	sx = t;					/* x0+x1 */
+	sx[h] = K_add(x+m, h, x, m, sx);
+	sy = sx + h + 1;			/* y0+y1 */
+	if (yl - m >= m) {
+	    ly = yl - m;
+	    sy[ly] = K_add(y+m, ly, y, m, sy);
+	}
+	else {
+	    ly = m;
+	    sy[ly] = K_add(y, m, y+m, yl-m, sy);
+	}
+	ly++;
+
+	z = sy + ly;			/* (x0+x1)*(y0+y1) - x0*y0 - x1*y1 */
+	zl = h + 1 + ly;
+	K_mul(sx, h+1, sy, ly, z, z + zl);
+	K_sub_in(z, zl, r, 2*m);
+	K_sub_in(z, zl, r+2*m, rl-2*m);
+	while (zl > rl-m) {
+	    ASSERT(z[zl-1] == 0);
+	    zl--;
+	}
+	K_add_in(r+m, rl-m, z, zl);
+    }
+}
+
+/*
+** Number of temporary digits needed by K_sqr
+*/
+static dsize_t K_sqr_scratch(dsize_t xl)
+{
+    dsize_t h = xl - xl/2;
+
+    if (xl < KARATSUBA_SQR_THRESHOLD)
+	return 0;
+    return 3*(h + 1) + K_sqr_scratch(h + 1);
+}
+
+/*
+** Square digits in x and store the 2*xl digits of the result in r
+*/
+static void K_sqr(ErtsDigit* x, dsize_t xl, ErtsDigit* r, ErtsDigit* t)
+{
+    if (xl < KARATSUBA_SQR_THRESHOLD) {
+	ZERO_DIGITS(r, 2*xl);
+	I_sqr(x, xl, r);
+    }
+    else {
+	dsize_t m = xl / 2;
+	dsize_t h = xl - m;
+	dsize_t zl = 2*(h + 1);
+	ErtsDigit* sx = t;
+	ErtsDigit* z = t + h + 1;
+
+	K_sqr(x, m, r, t);			/* x0^2 */
+	K_sqr(x+m, h, r+2*m, t);		/* x1^2 */
+
+	sx[h] = K_add(x+m, h, x, m, sx);	/* x0+x1 */
+	K_sqr(sx, h+1, z, z + zl);		/* 2*x0*x1 */
+	K_sub_in(z, zl, r, 2*m);
+	K_sub_in(z, zl, r+2*m, 2*h);
+	while (zl > 2*xl-m) {
+	    ASSERT(z[zl-1] == 0);
+	    zl--;
+	}
+	K_add_in(r+m, 2*xl-m, z, zl);
+    }
+}
+
+/*
+** Multiply digits in x with digits in y and store in r, choosing
+** between schoolbook and Karatsuba multiplication depending on size
+** Assumption: r has room for xl+yl digits
+** Return normalized size
+*/
+static dsize_t I_mul_karatsuba(ErtsDigit* x, dsize_t xl, ErtsDigit* y,
+			       dsize_t yl, ErtsDigit* r)
+{
+    dsize_t tl = K_mul_scratch(xl, yl);
+    ErtsDigit* t = NULL;
+    dsize_t rl = xl + yl;
+
+    if (tl)
+	t = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP, sizeof(ErtsDigit)*tl);
+    K_mul(x, xl, y, yl, r, t);
+    if (t)
+	erts_free(ERTS_ALC_T_TMP, (void *) t);
+    while (rl > 1 && r[rl-1] == 0)
+	rl--;
+    return rl;
+}
+
+/*
+** Square digits in x and store in r (x and r may not overlap)
+** Assumption: r has room for 2*xl digits
+** Return normalized size
+*/
+static dsize_t I_sqr_karatsuba(ErtsDigit* x, dsize_t xl, ErtsDigit* r)
+{
+    dsize_t tl = K_sqr_scratch(xl);
+    ErtsDigit* t = NULL;
+    dsize_t rl = 2*xl;
+
+    if (tl)
+	t = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP, sizeof(ErtsDigit)*tl);
+    K_sqr(x, xl, r, t);
+    if (t)
+	erts_free(ERTS_ALC_T_TMP, (void *) t);
+    while (rl > 1 && r[rl-1] == 0)
+	rl--;
+    return rl;
+}
+
 
 /*
 ** Multiply digits d with digits in x and store in r
@@ -1051,6 +1296,228 @@ static dsize_t I_rem(ErtsDigit* x, dsize_t xl, ErtsDigit* y, dsize_t yl, ErtsDig
     return rl;
 }
 
+/*
+** Division by large divisors
+**
+** For divisors of at least BARRETT_DIV_THRESHOLD digits the reciprocal
+** v = floor(B^2yl / y) is computed using Newton iteration, and the
+** quotient is then found with two multiplications per yl digits of the
+** dividend (Barrett reduction). Together with Karatsuba multiplication
+** this makes division, and thus conversion of huge integers to decimal
+** form, sub-quadratic.
+*/
+
+#define BARRETT_DIV_THRESHOLD  128
+#define NEWTON_RECIP_THRESHOLD 64
+
+/*
+** Compare x with B^n
+*/
+static int I_comp_pow(ErtsDigit* x, dsize_t xl, dsize_t n)
+{
+    if (xl != n+1)
+	return (xl < n+1) ? -1 : 1;
+    if (x[n] != 1)
+	return 1;
+    while (n--) {
+	if (x[n] != 0)
+	    return 1;
+    }
+    return 0;
+}
+
+/*
+** Compute v = floor(B^2yl / y)
+** Assumption: y is normalized, yl > 1 and v has room for yl+3 digits
+** Return size of v
+*/
+static dsize_t I_recip(ErtsDigit* y, dsize_t yl, ErtsDigit* v)
+{
+    ErtsDigit* p;
+    dsize_t pl;
+    dsize_t vl;
+
+    if (yl < NEWTON_RECIP_THRESHOLD) {
+	dsize_t nl = 2*yl + 1;
+	dsize_t rl;
+	ErtsDigit* n = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP,
+					       sizeof(ErtsDigit)*2*nl);
+
+	ZERO_DIGITS(n, nl-1);
+	n[nl-1] = 1;
+	vl = I_div(n, nl, y, yl, v, n + nl, &rl);
+	erts_free(ERTS_ALC_T_TMP, (void *) n);
+	return vl;
+    }
+    else {
+	/*
+	 * Start from the reciprocal vh of the h most significant digits
+	 * of y, which gives v0 = vh*B^s with about h correct digits, and
+	 * do one Newton step v1 = v0 + v0*(B^2yl - y*v0)/B^2yl. With
+	 * 2h >= yl+4 the result is off by at most a few units, which is
+	 * fixed below.
+	 */
+	dsize_t h = (yl + 5) / 2;
+	dsize_t s = yl - h;
+	ErtsDigit* vh = v + s;
+	ErtsDigit* e;
+	ErtsDigit* t;
+	dsize_t vhl, esz, el, tl;
+	int cmp;
+
+	vhl = I_recip(y + s, h, vh);
+	ZERO_DIGITS(v, s);
+	vl = s + vhl;
+
+	/* e = |B^(yl+h) - y*vh| */
+	esz = yl + (vhl > h ? vhl : h) + 1;
+	e = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP,
+				    sizeof(ErtsDigit)*(2*esz + vhl));
+	t = e + esz;
+	el = I_mul_karatsuba(y, yl, vh, vhl, e);
+	cmp = I_comp_pow(e, el, yl + h);
+	if (cmp != 0) {
+	    if (cmp > 0) {
+		ErtsDigit* ep = e + yl + h;
+		while ((*ep)-- == 0)
+		    ep++;
+		while (el > 1 && e[el-1] == 0)
+		    el--;
+	    }
+	    else {
+		ZERO_DIGITS(e + el, yl + h - el);
+		el = Z_sub(e, yl + h, e);
+	    }
+
+	    /* v1 = v0 -/+ vh*e/B^2h */
+	    tl = I_mul_karatsuba(vh, vhl, e, el, t);
+	    if (tl > 2*h) {
+		if (cmp > 0)
+		    vl = I_sub(v, vl, t + 2*h, tl - 2*h, v);
+		else
+		    vl = I_add(v, vl, t + 2*h, tl - 2*h, v);
+	    }
+	}
+	erts_free(ERTS_ALC_T_TMP, (void *) e);
+    }
+
+    /* Adjust v until 0 <= B^2yl - y*v < y */
+    p = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP,
+				sizeof(ErtsDigit)*(2*yl + 4));
+    pl = I_mul_karatsuba(y, yl, v, vl, p);
+    while (I_comp_pow(p, pl, 2*yl) > 0) {
+	pl = I_sub(p, pl, y, yl, p);
+	vl = D_sub(v, vl, 1, v);
+    }
+    if (I_comp_pow(p, pl, 2*yl) < 0) {
+	ZERO_DIGITS(p + pl, 2*yl - pl);
+	pl = Z_sub(p, 2*yl, p);
+	while (I_comp(p, pl, y, yl) >= 0) {
+	    pl = I_sub(p, pl, y, yl, p);
+	    vl = D_add(v, vl, 1, v);
+	}
+    }
+    erts_free(ERTS_ALC_T_TMP, (void *) p);
+    return vl;
+}
+
+/*
+** Divide digits in x with digits in y using Barrett reduction with
+** v = floor(B^2yl / y) (see I_recip), x is divided yl digits at a time
+** Assumption: x >= y, yl > 1
+** Store quotient in q (xl-yl+1 digits) and remainder in r (yl digits)
+** Return quotient size and remainder size in rlp
+*/
+static dsize_t I_div_barrett(ErtsDigit* x, dsize_t xl, ErtsDigit* y,
+			     dsize_t yl, ErtsDigit* v, dsize_t vl,
+			     ErtsDigit* q, ErtsDigit* r, dsize_t* rlp)
+{
+    dsize_t qsz = xl - yl + 1;
+    dsize_t pos = ((xl - 1) / yl) * yl;
+    dsize_t reml = 0;
+    ErtsDigit* a = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP,
+					   sizeof(ErtsDigit)*(9*yl + 11));
+    ErtsDigit* rem = a + 2*yl + 1;
+    ErtsDigit* qb = rem + 2*yl + 1;
+    ErtsDigit* p = qb + yl + 4;
+    ErtsDigit* qd = p + 2*yl + 4;
+    dsize_t ql;
+
+    ZERO_DIGITS(q, qsz);
+    while (1) {
+	/* a = rem*B^cl + next chunk of x, a < y*B^yl */
+	dsize_t cl = (xl - pos < yl) ? xl - pos : yl;
+	dsize_t al = cl + reml;
+
+	MOVE_DIGITS(a, x + pos, cl);
+	if (reml)
+	    MOVE_DIGITS(a + cl, rem, reml);
+	while (al > 1 && a[al-1] == 0)
+	    al--;
+
+	if (I_comp(a, al, y, yl) < 0) {
+	    MOVE_DIGITS(rem, a, al);
+	    reml = al;
+	}
+	else {
+	    dsize_t qbl, pl, i;
+
+	    /* qb = floor(floor(a/B^(yl-1))*v / B^(yl+1)), at most 2 too small */
+	    pl = I_mul_karatsuba(a + yl - 1, al - yl + 1, v, vl, p);
+	    if (pl > yl + 1) {
+		qbl = pl - (yl + 1);
+		MOVE_DIGITS(qb, p + yl + 1, qbl);
+		pl = I_mul_karatsuba(qb, qbl, y, yl, qd);
+		reml = I_sub(a, al, qd, pl, rem);
+	    }
+	    else {
+		qb[0] = 0;
+		qbl = 1;
+		MOVE_DIGITS(rem, a, al);
+		reml = al;
+	    }
+	    while (I_comp(rem, reml, y, yl) >= 0) {
+		reml = I_sub(rem, reml, y, yl, rem);
+		qbl = D_add(qb, qbl, 1, qb);
+	    }
+	    for (i = 0; i < qbl && pos + i < qsz; i++)
+		q[pos + i] = qb[i];
+	}
+	if (pos == 0)
+	    break;
+	pos -= yl;
+    }
+
+    MOVE_DIGITS(r, rem, reml);
+    *rlp = reml;
+    erts_free(ERTS_ALC_T_TMP, (void *) a);
+
+    ql = qsz;
+    while (ql > 1 && q[ql-1] == 0)
+	ql--;
+    return ql;
+}
+
+/*
+** Divide x with y, using Barrett reduction for large operands
+** Assumption: integer(x) > integer(y), yl > 1
+** Return quotient size and remainder in r (length in rlp)
+*/
+static dsize_t I_div_large(ErtsDigit* x, dsize_t xl, ErtsDigit* y, dsize_t yl,
+			   ErtsDigit* q, ErtsDigit* r, dsize_t* rlp)
+{
+    if (yl >= BARRETT_DIV_THRESHOLD && xl - yl >= BARRETT_DIV_THRESHOLD) {
+	ErtsDigit* v = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP,
+					       sizeof(ErtsDigit)*(yl + 3));
+	dsize_t vl = I_recip(y, yl, v);
+	dsize_t ql = I_div_barrett(x, xl, y, yl, v, vl, q, r, rlp);
+
+	erts_free(ERTS_ALC_T_TMP, (void *) v);
+	return ql;
+    }
+    return I_div(x, xl, y, yl, q, r, rlp);
+}
+
 /*
 ** Remove trailing digits from bitwise operations
 */
@@ -1726,6 +2193,149 @@ int big_decimal_estimate(Wterm x)
     return lg10+1;		/* add null */
 }
 
+/*
+** Write the decimal digits of x, least significant first, padded
+** with zeroes to at least pad digits
+*/
+static Uint write_big_digits(ErtsDigit* x, dsize_t xl, Uint pad,
+			     void (*write_func)(void *, char), void *arg)
+{
+    ErtsDigit* tmp  = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP,
+					      sizeof(ErtsDigit)*xl);
+    dsize_t tmpl = xl;
+    ErtsDigit rem;
+    Uint n = 0;
+    const Uint digits_per_Sint = get_digits_per_signed_int(10);
+    const Sint largest_pow_of_base = get_largest_power_of_base(10);
+
+    MOVE_DIGITS(tmp, x, xl);
+
+    while(1) {
+	tmpl = D_div(tmp, tmpl, largest_pow_of_base, tmp, &rem);
+	if (tmpl == 1 && *tmp == 0) {
+	    while(rem) {
+		(*write_func)(arg, (rem % 10)+'0'); n++;
+		rem /= 10;
+	    }
+	    break;
+	} else {
+	    Uint i = digits_per_Sint;
+	    while(i--) {
+		(*write_func)(arg, (rem % 10)+'0'); n++;
+		rem /= 10;
+	    }
+	}
+    }
+    erts_free(ERTS_ALC_T_TMP, (void *) tmp);
+
+    while(n < pad) {
+	(*write_func)(arg, '0'); n++;
+    }
+    return n;
+}
+
+/*
+** Divide and conquer conversion of huge bignums
+**
+** x is split as x = q*p + r, where p = 10^(digits_per_Sint*2^k) is the
+** largest such power that is less than or equal to x. r is converted
+** with zero padding to exactly digits_per_Sint*2^k digits, and then q,
+** both recursively. The powers are computed once by repeated squaring,
+** together with their reciprocals when Barrett division is used.
+*/
+
+#define BIG_TO_DECIMAL_DC_THRESHOLD 40
+
+typedef struct {
+    ErtsDigit* v;	/* 10^digits */
+    dsize_t vl;
+    ErtsDigit* inv;	/* floor(B^2vl / v) or NULL */
+    dsize_t invl;
+    Uint digits;
+} ErtsBigDecPow;
+
+static Uint write_big_dc(ErtsDigit* x, dsize_t xl, Uint pad,
+			 ErtsBigDecPow* pow, int k,
+			 void (*write_func)(void *, char), void *arg)
+{
+    ErtsDigit* q;
+    ErtsDigit* r;
+    dsize_t ql, rl;
+    Uint n;
+
+    if (xl < BIG_TO_DECIMAL_DC_THRESHOLD)
+	return write_big_digits(x, xl, pad, write_func, arg);
+    while (k >= 0 && I_comp(x, xl, pow[k].v, pow[k].vl) < 0)
+	k--;
+    if (k < 0)
+	return write_big_digits(x, xl, pad, write_func, arg);
+
+    q = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP,
+				sizeof(ErtsDigit)*(2*xl - pow[k].vl + 1));
+    r = q + (xl - pow[k].vl + 1);
+    if (pow[k].inv)
+	ql = I_div_barrett(x, xl, pow[k].v, pow[k].vl, pow[k].inv, pow[k].invl,
+			   q, r, &rl);
+    else if (I_comp(x, xl, pow[k].v, pow[k].vl) == 0) {
+	*q = 1; ql = 1;
+	*r = 0; rl = 1;
+    }
+    else
+	ql = I_div(x, xl, pow[k].v, pow[k].vl, q, r, &rl);
+
+    n = write_big_dc(r, rl, pow[k].digits, pow, k-1, write_func, arg);
+    n += write_big_dc(q, ql, (pad > pow[k].digits) ? pad - pow[k].digits : 0,
+		      pow, k-1, write_func, arg);
+    erts_free(ERTS_ALC_T_TMP, (void *) q);
+    return n;
+}
+
+static Uint write_big_huge(ErtsDigit* x, dsize_t xl,
+			   void (*write_func)(void *, char), void *arg)
+{
+    ErtsBigDecPow pow[sizeof(Uint)*8];
+    ErtsDigit p0 = get_largest_power_of_base(10);
+    int k = 0;
+    int i;
+    Uint n;
+
+    pow[0].v = &p0;
+    pow[0].vl = 1;
+    pow[0].inv = NULL;
+    pow[0].invl = 0;
+    pow[0].digits = get_digits_per_signed_int(10);
+
+    while (2*pow[k].vl - 1 <= xl) {
+	ErtsBigDecPow* p = &pow[k+1];
+
+	p->v = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP,
+				       sizeof(ErtsDigit)*2*pow[k].vl);
+	p->vl = I_sqr_karatsuba(pow[k].v, pow[k].vl, p->v);
+	if (I_comp(p->v, p->vl, x, xl) > 0) {
+	    erts_free(ERTS_ALC_T_TMP, (void *) p->v);
+	    break;
+	}
+	p->digits = 2*pow[k].digits;
+	p->inv = NULL;
+	p->invl = 0;
+	if (p->vl >= BARRETT_DIV_THRESHOLD) {
+	    p->inv = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP,
+					     sizeof(ErtsDigit)*(p->vl + 3));
+	    p->invl = I_recip(p->v, p->vl, p->inv);
+	}
+	k++;
+    }
+
+    n = write_big_dc(x, xl, 0, pow, k, write_func, arg);
+
+    for (i = 1; i <= k; i++) {
+	erts_free(ERTS_ALC_T_TMP, (void *) pow[i].v);
+	if (pow[i].inv)
+	    erts_free(ERTS_ALC_T_TMP, (void *) pow[i].inv);
+    }
+    return n;
+}
+
 /*
 ** Convert a bignum into a string of decimal numbers
 */
@@ -1738,7 +2348,6 @@ static Uint write_big(Wterm x, void (*write_func)(void *, char), void *arg)
     short sign = BIG_SIGN(xp);
     ErtsDigit rem;
     Uint n = 0;
-    const Uint digits_per_Sint = get_digits_per_signed_int(10);
     const Sint largest_pow_of_base = get_largest_power_of_base(10);
 
     if (xl == 1 && *dx < largest_pow_of_base) {
@@ -1751,30 +2360,10 @@ static Uint write_big(Wterm x, void (*write_func)(void *, char), void *arg)
 		rem /= 10;
 	    }
 	}
+    } else if (xl < BIG_TO_DECIMAL_DC_THRESHOLD) {
+	n = write_big_digits(dx, xl, 0, write_func, arg);
     } else {
-	ErtsDigit* tmp  = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP,
-					      sizeof(ErtsDigit)*xl);
-	dsize_t tmpl = xl;
-
-	MOVE_DIGITS(tmp, dx, xl);
-
-	while(1) {
-            tmpl = D_div(tmp, tmpl, largest_pow_of_base, tmp, &rem);
-	    if (tmpl == 1 && *tmp == 0) {
-		while(rem) {
-		    (*write_func)(arg, (rem % 10)+'0'); n++;
-		    rem /= 10;
-		}
-		break;
-	    } else {
-                Uint i = digits_per_Sint;
-		while(i--) {
-		    (*write_func)(arg, (rem % 10)+'0'); n++;
-		    rem /= 10;
-		}
-	    }
-	}
-	erts_free(ERTS_ALC_T_TMP, (void *) tmp);
+	n = write_big_huge(dx, xl, write_func, arg);
     }
 
     if (sign) {
@@ -2332,9 +2921,15 @@ Eterm big_times(Eterm x, Eterm y, Eterm *r)
     else if (xsz == 1)
 	rsz = D_mul(BIG_V(yp), ysz, BIG_DIGIT(xp, 0), BIG_V(r));
     else if (xp == yp) {
-	ZERO_DIGITS(BIG_V(r), xsz+1);
-	rsz = I_sqr(BIG_V(xp), xsz, BIG_V(r));
+	if (xsz >= KARATSUBA_SQR_THRESHOLD)
+	    rsz = I_sqr_karatsuba(BIG_V(xp), xsz, BIG_V(r));
+	else {
+	    ZERO_DIGITS(BIG_V(r), xsz+1);
+	    rsz = I_sqr(BIG_V(xp), xsz, BIG_V(r));
+	}
     }
+    else if (xsz >= KARATSUBA_MUL_THRESHOLD && ysz >= KARATSUBA_MUL_THRESHOLD)
+	rsz = I_mul_karatsuba(BIG_V(xp), xsz, BIG_V(yp), ysz, BIG_V(r));
     else if (xsz >= ysz) {
 	ZERO_DIGITS(BIG_V(r), xsz);
 	rsz = I_mul(BIG_V(xp), xsz, BIG_V(yp), ysz, BIG_V(r));
@@ -2371,8 +2966,8 @@ Eterm big_div(Eterm x, Eterm y, Eterm *q)
 
 	qsz = xsz - ysz + 1;
 	remp = q + BIG_NEED_SIZE(qsz);
-	qsz = I_div(BIG_V(xp), xsz, BIG_V(yp), ysz, BIG_V(q), BIG_V(remp),
-		    &rem_sz);
+	qsz = I_div_large(BIG_V(xp), xsz, BIG_V(yp), ysz, BIG_V(q), BIG_V(remp),
+			  &rem_sz);
     }
     return big_norm(q, qsz, sign);
 }
@@ -2406,6 +3001,15 @@ Eterm big_rem(Eterm x, Eterm y, Eterm *r)
 	    return make_big(r);
 	}
     }
+    else if (ysz >= BARRETT_DIV_THRESHOLD && xsz - ysz >= BARRETT_DIV_THRESHOLD) {
+	ErtsDigit* q = (ErtsDigit*) erts_alloc(ERTS_ALC_T_TMP,
+					       sizeof(ErtsDigit)*(xsz-ysz+1));
+	dsize_t rsz;
+
+	I_div_large(BIG_V(xp), xsz, BIG_V(yp), ysz, q, BIG_V(r), &rsz);
+	erts_free(ERTS_ALC_T_TMP, (void *) q);
+	return big_norm(r, rsz, sign);
+    }
     else {
 	dsize_t rsz = I_rem(BIG_V(xp), xsz, BIG_V(yp), ysz, BIG_V(r));
 	return big_norm(r, rsz, sign);
@@ -104,6 +104,14 @@ dist_msg_dbg(ErtsDistExternal *edep, char *what, byte *buf, int sz)
 
 #define PASS_THROUGH 'p'        /* This code should go */
 
+/*
+ * Messages larger than this are sent in fragments of this size when
+ * the other node supports it, so that other signals on the connection
+ * can be sent in between them.
+ */
+#define ERTS_DIST_FRAGMENT_SIZE (64*1024)
+#define ERTS_DIST_FRAG_HEADER_SIZE (1+1+8+8)
+
 int erts_is_alive; /* System must be blocked on change */
 int erts_dist_buf_busy_limit;
 
@@ -125,6 +133,10 @@ Export* dmonitor_p_trap = NULL;
 /* forward declarations */
 
 static void clear_dist_entry(DistEntry*);
+static void free_dist_fragments(struct ErtsDistFragments_ *);
+static void dsig_send_abort_fragments(ErtsDSigData *,
+				      struct erts_dsig_send_context *);
+static Uint dist_port_commandv(Port *prt, ErtsDistOutputBuf *obuf);
 static int dsig_send_ctl(ErtsDSigData* dsdp, Eterm ctl, int force_busy);
 static void send_nodes_mon_msgs(Process *, Eterm, Eterm, Eterm, Eterm);
 static void init_nodes_monitors(void);
@@ -633,6 +645,9 @@ alloc_dist_obuf(Uint size)
     obuf->dbg_pattern = ERTS_DIST_OUTPUT_BUF_DBG_PATTERN;
     ASSERT(bin == ErtsDistOutputBuf2Binary(obuf));
 #endif
+    obuf->hdrp = NULL;
+    obuf->hdr_endp = NULL;
+    obuf->ext_bin = NULL;
     return obuf;
 }
 
@@ -640,15 +655,20 @@ static ERTS_INLINE void
 free_dist_obuf(ErtsDistOutputBuf *obuf)
 {
     Binary *bin = ErtsDistOutputBuf2Binary(obuf);
+    Binary *ext_bin = obuf->ext_bin;
     ASSERT(obuf->dbg_pattern == ERTS_DIST_OUTPUT_BUF_DBG_PATTERN);
     if (erts_refc_dectest(&bin->refc, 0) == 0)
 	erts_bin_free(bin);
+    if (ext_bin && erts_refc_dectest(&ext_bin->refc, 0) == 0)
+	erts_bin_free(ext_bin);
 }
 
 static ERTS_INLINE Sint
 size_obuf(ErtsDistOutputBuf *obuf)
 {
     Binary *bin = ErtsDistOutputBuf2Binary(obuf);
+    if (obuf->ext_bin)
+	return bin->orig_size + (obuf->ext_endp - obuf->extp);
     return bin->orig_size;
 }
 
@@ -658,10 +678,13 @@ static void clear_dist_entry(DistEntry *dep)
     ErtsAtomCache *cache;
     ErtsProcList *suspendees;
     ErtsDistOutputBuf *obuf;
+    struct ErtsDistFragments_ *fragments;
 
     erts_smp_de_rwlock(dep);
     cache = dep->cache;
     dep->cache = NULL;
+    fragments = dep->fragments;
+    dep->fragments = NULL;
 
 #ifdef DEBUG
     erts_smp_de_links_lock(dep);
@@ -695,6 +718,7 @@ static void clear_dist_entry(DistEntry *dep)
     erts_resume_processes(suspendees);
 
     delete_cache(cache);
+    free_dist_fragments(fragments);
 
     while (obuf) {
 	ErtsDistOutputBuf *fobuf;
@@ -724,7 +748,11 @@ void erts_dsend_context_dtor(Binary* ctx_bin)
 	break;
     default:;
     }
-    if (ctx->dss.phase >= ERTS_DSIG_SEND_PHASE_ALLOC && ctx->dss.obuf) {
+    if (ctx->dss.phase == ERTS_DSIG_SEND_PHASE_FRAGMENTS && ctx->dss.obuf) {
+	/* The sender was killed in the middle of a fragmented message */
+	dsig_send_abort_fragments(&ctx->dsd, &ctx->dss);
+    }
+    else if (ctx->dss.phase >= ERTS_DSIG_SEND_PHASE_ALLOC && ctx->dss.obuf) {
 	free_dist_obuf(ctx->dss.obuf);
     }
     if (ctx->dep_to_deref)
@@ -1107,6 +1135,144 @@ erts_dsig_send_group_leader(ErtsDSigData *dsdp, Eterm leader, Eterm remote)
 #  define PURIFY_MSG(msg)
 #endif
 
+/*
+ * Reassembly of fragmented messages.
+ *
+ * The first fragment of a message carries the distribution header,
+ * which is prepared as soon as the fragment arrives. Messages sent
+ * between the fragments may refer to atom cache entries created by
+ * that header, so it cannot wait until the message is complete.
+ *
+ * The sequence id is the sending process, so a sender has at most one
+ * incomplete message. It is dropped when the sender starts on its next
+ * message, or when an empty fragment with fragment id 0 tells that the
+ * sender died before sending the rest.
+ */
+
+typedef struct ErtsDistFragments_ {
+    struct ErtsDistFragments_ *next;
+    Uint64 seq;			/* Sequence id of the message */
+    Uint64 frag;		/* Fragment id of the last fragment received */
+    Uint ext_offs;		/* Offset of ede.extp in buf */
+    Uint size;			/* Bytes used in buf */
+    Uint buf_size;
+    byte *buf;
+    ErtsDistExternal ede;	/* Prepared from the first fragment */
+} ErtsDistFragments;
+
+static void
+free_dist_fragments(ErtsDistFragments *frags)
+{
+    while (frags) {
+	ErtsDistFragments *next = frags->next;
+	erts_free(ERTS_ALC_T_DIST_FRAGMENTS, frags->buf);
+	erts_free(ERTS_ALC_T_DIST_FRAGMENTS, frags);
+	frags = next;
+    }
+}
+
+static ErtsDistFragments *
+unlink_dist_fragments(DistEntry *dep, Uint64 seq)
+{
+    ErtsDistFragments **fpp;
+    for (fpp = &dep->fragments; *fpp; fpp = &(*fpp)->next) {
+	ErtsDistFragments *frags = *fpp;
+	if (frags->seq == seq) {
+	    *fpp = frags->next;
+	    frags->next = NULL;
+	    return frags;
+	}
+    }
+    return NULL;
+}
+
+/*
+ * Handle a fragment of a message. Returns 1 when the message is
+ * complete, in which case *edep has been prepared and *fragsp has to
+ * be freed by the caller once the message has been handled. Returns 0
+ * if more fragments are expected or the message was aborted, and -1
+ * on protocol errors.
+ */
+static int
+dist_fragment_input(DistEntry *dep, byte *t, ErlDrvSizeT len,
+		    ErtsDistExternal *edep, ErtsDistFragments **fragsp)
+{
+    ErtsDistFragments *frags;
+    Uint64 seq, frag;
+    Uint data_size;
+
+    if (len < ERTS_DIST_FRAG_HEADER_SIZE)
+	return -1;
+    seq = get_int64(t + 2);
+    frag = get_int64(t + 10);
+    data_size = len - ERTS_DIST_FRAG_HEADER_SIZE;
+
+    if (frag == 0) {
+	/* The sender died in the middle of the message */
+	if (t[1] != DIST_FRAG_CONT || data_size != 0)
+	    return -1;
+	free_dist_fragments(unlink_dist_fragments(dep, seq));
+	return 0;
+    }
+
+    if (t[1] == DIST_FRAG_HEADER) {
+	/* The sender has started on its next message; drop the last one */
+	free_dist_fragments(unlink_dist_fragments(dep, seq));
+
+	frags = erts_alloc(ERTS_ALC_T_DIST_FRAGMENTS, sizeof(ErtsDistFragments));
+	frags->next = NULL;
+	frags->seq = seq;
+	frags->frag = frag;
+	frags->buf_size = 2 + data_size;
+	frags->buf = erts_alloc(ERTS_ALC_T_DIST_FRAGMENTS, frags->buf_size);
+	frags->buf[0] = VERSION_MAGIC;
+	frags->buf[1] = DIST_HEADER;
+	sys_memcpy(frags->buf + 2, t + ERTS_DIST_FRAG_HEADER_SIZE, data_size);
+	frags->size = 2 + data_size;
+
+	if (erts_prepare_dist_ext(&frags->ede, frags->buf, frags->size,
+				  dep, dep->cache) < 0) {
+	    free_dist_fragments(frags);
+	    return -1;
+	}
+	frags->ext_offs = frags->ede.extp - frags->buf;
+    }
+    else {
+	ASSERT(t[1] == DIST_FRAG_CONT);
+	frags = unlink_dist_fragments(dep, seq);
+	if (!frags)
+	    return -1;
+	if (frag != frags->frag - 1) {
+	    free_dist_fragments(frags);
+	    return -1;
+	}
+	frags->frag = frag;
+	if (frags->size + data_size > frags->buf_size) {
+	    Uint buf_size = 2 * frags->buf_size;
+	    if (buf_size < frags->size + data_size)
+		buf_size = frags->size + data_size;
+	    frags->buf = erts_realloc(ERTS_ALC_T_DIST_FRAGMENTS,
+				      frags->buf, buf_size);
+	    frags->buf_size = buf_size;
+	}
+	sys_memcpy(frags->buf + frags->size,
+		   t + ERTS_DIST_FRAG_HEADER_SIZE, data_size);
+	frags->size += data_size;
+    }
+
+    if (frag > 1) {
+	frags->next = dep->fragments;
+	dep->fragments = frags;
+	return 0;
+    }
+
+    *edep = frags->ede;
+    edep->extp = frags->buf + frags->ext_offs;
+    edep->ext_endp = frags->buf + frags->size;
+    *fragsp = frags;
+    return 1;
+}
+
 /*
 ** Input from distribution port.
 **  Input follows the distribution protocol v4.5
@@ -1145,6 +1311,7 @@ int erts_net_message(Port *prt,
     ErtsLink *lnk;
     Uint tuple_arity;
     int res;
+    ErtsDistFragments *frags = NULL;
 #ifdef ERTS_DIST_MSG_DBG
     ErlDrvSizeT orig_len = len;
 #endif
@@ -1184,7 +1351,18 @@ int erts_net_message(Port *prt,
 	goto data_error;
     }
 
-    res = erts_prepare_dist_ext(&ede, t, len, dep, dep->cache);
+    if ((dep->flags & DFLAG_FRAGMENTS)
+	&& len >= 2
+	&& t[0] == VERSION_MAGIC
+	&& (t[1] == DIST_FRAG_HEADER || t[1] == DIST_FRAG_CONT)) {
+	res = dist_fragment_input(dep, t, len, &ede, &frags);
+	if (res == 0) {
+	    UnUseTmpHeapNoproc(DIST_CTL_DEFAULT_SIZE);
+	    return 0;
+	}
+    }
+    else
+	res = erts_prepare_dist_ext(&ede, t, len, dep, dep->cache);
 
     if (res >= 0)
 	res = ctl_len = erts_decode_dist_ext_size(&ede);
@@ -1706,6 +1884,7 @@ int erts_net_message(Port *prt,
     if (ctl != ctl_default) {
 	erts_free(ERTS_ALC_T_DCTRL_BUF, (void *) ctl);
     }
+    free_dist_fragments(frags);
     UnUseTmpHeapNoproc(DIST_CTL_DEFAULT_SIZE);
     ERTS_SMP_CHK_NO_PROC_LOCKS;
     return 0;
@@ -1722,6 +1901,7 @@ decode_error:
 	erts_free(ERTS_ALC_T_DCTRL_BUF, (void *) ctl);
     }
 data_error:
+    free_dist_fragments(frags);
     UnUseTmpHeapNoproc(DIST_CTL_DEFAULT_SIZE);
     erts_deliver_port_exit(prt, dep->cid, am_killed, 0, 1);
     ERTS_SMP_CHK_NO_PROC_LOCKS;
@@ -1744,17 +1924,219 @@ static int dsig_send_ctl(ErtsDSigData* dsdp, Eterm ctl, int force_busy)
     return ret;
 }
 
+/* Result of dsig_send_enqueue() when the connection is gone */
+#define ERTS_DSIG_SEND_DROPPED (-1)
+
+/*
+ * Enqueue 'obuf' on the dist entry unless the connection has changed
+ * since the signal was prepared, in which case it is dropped. Returns
+ * ERTS_DSIG_SEND_YIELD if the calling process was suspended since the
+ * dist entry is busy.
+ */
+static int
+dsig_send_enqueue(ErtsDSigData *dsdp, struct erts_dsig_send_context *ctx,
+		  ErtsDistOutputBuf *obuf)
+{
+    DistEntry *dep = dsdp->dep;
+    int suspended = 0;
+    int resume = 0;
+    Eterm cid;
+
+    obuf->next = NULL;
+    erts_smp_de_rlock(dep);
+    cid = dep->cid;
+    if (cid != dsdp->cid
+	|| dep->connection_id != dsdp->connection_id
+	|| dep->status & ERTS_DE_SFLG_EXITING) {
+	/* Not the same connection as when we started; drop message... */
+	erts_smp_de_runlock(dep);
+	free_dist_obuf(obuf);
+	return ERTS_DSIG_SEND_DROPPED;
+    }
+    else {
+	ErtsProcList *plp = NULL;
+	erts_smp_mtx_lock(&dep->qlock);
+	dep->qsize += size_obuf(obuf);
+	if (dep->qsize >= erts_dist_buf_busy_limit)
+	    dep->qflgs |= ERTS_DE_QFLG_BUSY;
+	if (!ctx->force_busy && (dep->qflgs & ERTS_DE_QFLG_BUSY)) {
+	    erts_smp_mtx_unlock(&dep->qlock);
+
+	    plp = erts_proclist_create(ctx->c_p);
+	    erts_suspend(ctx->c_p, ERTS_PROC_LOCK_MAIN, NULL);
+	    suspended = 1;
+	    erts_smp_mtx_lock(&dep->qlock);
+	}
+
+	/* Enqueue obuf on dist entry */
+	if (dep->out_queue.last)
+	    dep->out_queue.last->next = obuf;
+	else
+	    dep->out_queue.first = obuf;
+	dep->out_queue.last = obuf;
+
+	if (!ctx->force_busy) {
+	    if (!(dep->qflgs & ERTS_DE_QFLG_BUSY)) {
+		if (suspended)
+		    resume = 1; /* was busy when we started, but isn't now */
+#ifdef USE_VM_PROBES
+		if (resume && DTRACE_ENABLED(dist_port_not_busy)) {
+		    DTRACE_CHARBUF(port_str, 64);
+		    DTRACE_CHARBUF(remote_str, 64);
+
+		    erts_snprintf(port_str, sizeof(DTRACE_CHARBUF_NAME(port_str)),
+				  "%T", cid);
+		    erts_snprintf(remote_str, sizeof(DTRACE_CHARBUF_NAME(remote_str)),
+				  "%T", dep->sysname);
+		    DTRACE3(dist_port_not_busy, erts_this_node_sysname,
+			    port_str, remote_str);
+		}
+#endif
+	    }
+	    else {
+		/* Enqueue suspended process on dist entry */
+		ASSERT(plp);
+		erts_proclist_store_last(&dep->suspended, plp);
+	    }
+	}
+
+	erts_smp_mtx_unlock(&dep->qlock);
+	erts_schedule_dist_command(NULL, dep);
+	erts_smp_de_runlock(dep);
+
+	if (resume) {
+	    erts_resume(ctx->c_p, ERTS_PROC_LOCK_MAIN);
+	    erts_proclist_destroy(plp);
+	    /*
+	     * Note that the calling process still have to yield as if it
+	     * suspended. If not, the calling process could later be
+	     * erroneously scheduled when it shouldn't be.
+	     */
+	}
+    }
+
+    if (suspended) {
+#ifdef USE_VM_PROBES
+	if (!resume && DTRACE_ENABLED(dist_port_busy)) {
+	    DTRACE_CHARBUF(port_str, 64);
+	    DTRACE_CHARBUF(remote_str, 64);
+	    DTRACE_CHARBUF(pid_str, 16);
+
+	    erts_snprintf(port_str, sizeof(DTRACE_CHARBUF_NAME(port_str)), "%T", cid);
+	    erts_snprintf(remote_str, sizeof(DTRACE_CHARBUF_NAME(remote_str)),
+			  "%T", dep->sysname);
+	    erts_snprintf(pid_str, sizeof(DTRACE_CHARBUF_NAME(pid_str)),
+			  "%T", ctx->c_p->common.id);
+	    DTRACE4(dist_port_busy, erts_this_node_sysname,
+		    port_str, remote_str, pid_str);
+	}
+#endif
+	if (!resume && erts_system_monitor_flags.busy_dist_port)
+	    monitor_generic(ctx->c_p, am_busy_dist_port, cid);
+	return ERTS_DSIG_SEND_YIELD;
+    }
+    return ERTS_DSIG_SEND_OK;
+}
+
+/*
+ * Cut the next fragment off the encoded message in ctx->obuf. The
+ * fragment refers to the data in ctx->obuf instead of copying it;
+ * only the fragment header is written to the fragment buffer. The
+ * header of the first fragment holds the internal dist header, which
+ * is finalized just like the header of an ordinary message.
+ */
+static ErtsDistOutputBuf *
+dsig_send_make_fragment(struct erts_dsig_send_context *ctx)
+{
+    ErtsDistOutputBuf *obuf = ctx->obuf;
+    ErtsDistOutputBuf *fob;
+    byte *ctl_ext = &obuf->data[0] + ctx->dhdr_ext_size;
+    Uint64 seq = ctx->seq;
+    Uint size = obuf->ext_endp - ctx->fragp;
+    Binary *bin;
+
+    ASSERT(ctx->fragments > 0);
+    if (size > ERTS_DIST_FRAGMENT_SIZE)
+	size = ERTS_DIST_FRAGMENT_SIZE;
+
+    if (ctx->fragp == ctl_ext) {
+	Uint hsz = ctl_ext - obuf->extp;
+	fob = alloc_dist_obuf(ERTS_DIST_FRAG_HEADER_SIZE + ctx->dhdr_ext_size);
+	fob->hdr_endp = &fob->data[0] + ERTS_DIST_FRAG_HEADER_SIZE + ctx->dhdr_ext_size;
+	fob->hdrp = fob->hdr_endp - hsz;
+	sys_memcpy((void *) fob->hdrp, (void *) obuf->extp, hsz);
+	/* Sequence and fragment id; moved into place when finalized */
+	put_int64(seq, &fob->data[0]);
+	put_int64(ctx->fragments, &fob->data[8]);
+    }
+    else {
+	fob = alloc_dist_obuf(ERTS_DIST_FRAG_HEADER_SIZE);
+	fob->hdrp = &fob->data[0];
+	fob->hdr_endp = &fob->data[0] + ERTS_DIST_FRAG_HEADER_SIZE;
+	fob->hdrp[0] = VERSION_MAGIC;
+	fob->hdrp[1] = DIST_FRAG_CONT;
+	put_int64(seq, &fob->hdrp[2]);
+	put_int64(ctx->fragments, &fob->hdrp[10]);
+    }
+
+    bin = ErtsDistOutputBuf2Binary(obuf);
+    erts_refc_inc(&bin->refc, 2);
+    fob->ext_bin = bin;
+    fob->extp = ctx->fragp;
+    fob->ext_endp = ctx->fragp + size;
+
+    ctx->fragp += size;
+    ctx->fragments--;
+    ASSERT((ctx->fragments == 0) == (ctx->fragp == obuf->ext_endp));
+    return fob;
+}
+
+/*
+ * Called when the sender of a fragmented message is gone before all
+ * fragments were enqueued. Tell the receiver to drop the fragments it
+ * has got so far with an empty fragment with fragment id 0, and drop
+ * the reference to the dist entry taken when fragmenting started.
+ */
+static void
+dsig_send_abort_fragments(ErtsDSigData *dsdp,
+			  struct erts_dsig_send_context *ctx)
+{
+    DistEntry *dep = dsdp->dep;
+    ErtsDistOutputBuf *fob = alloc_dist_obuf(ERTS_DIST_FRAG_HEADER_SIZE);
+
+    fob->hdrp = &fob->data[0];
+    fob->hdr_endp = &fob->data[0] + ERTS_DIST_FRAG_HEADER_SIZE;
+    fob->hdrp[0] = VERSION_MAGIC;
+    fob->hdrp[1] = DIST_FRAG_CONT;
+    put_int64(ctx->seq, &fob->hdrp[2]);
+    put_int64(0, &fob->hdrp[10]);
+    /* Hand the rest of the message over to the fragment */
+    fob->ext_bin = ErtsDistOutputBuf2Binary(ctx->obuf);
+    fob->extp = fob->ext_endp = ctx->fragp;
+    ctx->obuf = NULL;
+    ctx->fragments = 0;
+
+    ctx->force_busy = 1;
+    (void) dsig_send_enqueue(dsdp, ctx, fob);
+    erts_deref_dist_entry(dep);
+}
+
 int
 erts_dsig_send(ErtsDSigData *dsdp, struct erts_dsig_send_context* ctx)
 {
     int retval;
     Sint initial_reds = ctx->reds;
-    Eterm cid;
 
     while (1) {
 	switch (ctx->phase) {
 	case ERTS_DSIG_SEND_PHASE_INIT:
 	    ctx->flags = dsdp->dep->flags;
+	    /*
+	     * Fragments refer to the encoded message, which only a driver
+	     * taking I/O vectors can send without copying it.
+	     */
+	    if (dsdp->dep->send != dist_port_commandv)
+		ctx->flags &= ~DFLAG_FRAGMENTS;
 	    ctx->c_p = dsdp->proc;
 
 	    if (!ctx->c_p || dsdp->no_suspend)
@@ -1834,9 +2216,6 @@ erts_dsig_send(ErtsDSigData *dsdp, struct erts_dsig_send_context* ctx)
 
 	    ctx->phase = ERTS_DSIG_SEND_PHASE_FIN;
 	case ERTS_DSIG_SEND_PHASE_FIN: {
-	    DistEntry *dep = dsdp->dep;
-	    int suspended = 0;
-	    int resume = 0;
 
 	    ASSERT(ctx->obuf->extp < ctx->obuf->ext_endp);
 	    ASSERT(&ctx->obuf->data[0] <= ctx->obuf->extp - ctx->pass_through_size);
@@ -1844,107 +2223,65 @@ erts_dsig_send(ErtsDSigData *dsdp, struct erts_dsig_send_context* ctx)
 
 	    ctx->data_size = ctx->obuf->ext_endp - ctx->obuf->extp;
 
+	    if ((ctx->flags & DFLAG_FRAGMENTS)
+		&& ctx->acmp
+		&& ctx->c_p
+		&& is_value(ctx->msg)
+		&& ctx->data_size > ERTS_DIST_FRAGMENT_SIZE) {
+		/*
+		 * Send the message in fragments, a few at a time, so that
+		 * signals from other processes are not stuck behind it.
+		 * The dist entry is kept until the last fragment has been
+		 * enqueued, since an abort may have to be sent when the
+		 * sender dies.
+		 */
+		Uint size;
+		erts_refc_inc(&dsdp->dep->refc, 1);
+		ctx->seq = (Uint64) ctx->c_p->common.id;
+		ctx->fragp = &ctx->obuf->data[0] + ctx->dhdr_ext_size;
+		size = ctx->obuf->ext_endp - ctx->fragp;
+		ctx->fragments = ((size + ERTS_DIST_FRAGMENT_SIZE - 1)
+				  / ERTS_DIST_FRAGMENT_SIZE);
+		ctx->phase = ERTS_DSIG_SEND_PHASE_FRAGMENTS;
+		break;
+	    }
+
 	    /*
 	     * Signal encoded; now verify that the connection still exists,
 	     * and if so enqueue the signal and schedule it for send.
 	     */
-	    ctx->obuf->next = NULL;
-	    erts_smp_de_rlock(dep);
-	    cid = dep->cid;
-	    if (cid != dsdp->cid
-		|| dep->connection_id != dsdp->connection_id
-		|| dep->status & ERTS_DE_SFLG_EXITING) {
-		/* Not the same connection as when we started; drop message... */
-		erts_smp_de_runlock(dep);
-		free_dist_obuf(ctx->obuf);
-	    }
-	    else {
-		ErtsProcList *plp = NULL;
-		erts_smp_mtx_lock(&dep->qlock);
-		dep->qsize += size_obuf(ctx->obuf);
-		if (dep->qsize >= erts_dist_buf_busy_limit)
-		    dep->qflgs |= ERTS_DE_QFLG_BUSY;
-		if (!ctx->force_busy && (dep->qflgs & ERTS_DE_QFLG_BUSY)) {
-		    erts_smp_mtx_unlock(&dep->qlock);
-
-		    plp = erts_proclist_create(ctx->c_p);
-		    erts_suspend(ctx->c_p, ERTS_PROC_LOCK_MAIN, NULL);
-		    suspended = 1;
-		    erts_smp_mtx_lock(&dep->qlock);
-		}
-
-		/* Enqueue obuf on dist entry */
-		if (dep->out_queue.last)
-		    dep->out_queue.last->next = ctx->obuf;
-		else
-		    dep->out_queue.first = ctx->obuf;
-		dep->out_queue.last = ctx->obuf;
-
-		if (!ctx->force_busy) {
-		    if (!(dep->qflgs & ERTS_DE_QFLG_BUSY)) {
-			if (suspended)
-			    resume = 1; /* was busy when we started, but isn't now */
-    #ifdef USE_VM_PROBES
-			if (resume && DTRACE_ENABLED(dist_port_not_busy)) {
-			    DTRACE_CHARBUF(port_str, 64);
-			    DTRACE_CHARBUF(remote_str, 64);
-
-			    erts_snprintf(port_str, sizeof(DTRACE_CHARBUF_NAME(port_str)),
-					  "%T", cid);
-			    erts_snprintf(remote_str, sizeof(DTRACE_CHARBUF_NAME(remote_str)),
-					  "%T", dep->sysname);
-			    DTRACE3(dist_port_not_busy, erts_this_node_sysname,
-				    port_str, remote_str);
-			}
-    #endif
-		    }
-		    else {
-			/* Enqueue suspended process on dist entry */
-			ASSERT(plp);
-			erts_proclist_store_last(&dep->suspended, plp);
-		    }
-		}
-
-		erts_smp_mtx_unlock(&dep->qlock);
-		erts_schedule_dist_command(NULL, dep);
-		erts_smp_de_runlock(dep);
-
-		if (resume) {
-		    erts_resume(ctx->c_p, ERTS_PROC_LOCK_MAIN);
-		    erts_proclist_destroy(plp);
-		    /*
-		     * Note that the calling process still have to yield as if it
-		     * suspended. If not, the calling process could later be
-		     * erroneously scheduled when it shouldn't be.
-		     */
-		}
-	    }
+	    retval = dsig_send_enqueue(dsdp, ctx, ctx->obuf);
+	    if (retval == ERTS_DSIG_SEND_DROPPED)
+		retval = ERTS_DSIG_SEND_OK;
 	    ctx->obuf = NULL;
+	    goto done;
+	}
 
-	    if (suspended) {
-    #ifdef USE_VM_PROBES
-		if (!resume && DTRACE_ENABLED(dist_port_busy)) {
-		    DTRACE_CHARBUF(port_str, 64);
-		    DTRACE_CHARBUF(remote_str, 64);
-		    DTRACE_CHARBUF(pid_str, 16);
+	case ERTS_DSIG_SEND_PHASE_FRAGMENTS:
+	    while (1) {
+		ErtsDistOutputBuf *fob = dsig_send_make_fragment(ctx);
+		Uint size = fob->ext_endp - fob->extp;
 
-		    erts_snprintf(port_str, sizeof(DTRACE_CHARBUF_NAME(port_str)), "%T", cid);
-		    erts_snprintf(remote_str, sizeof(DTRACE_CHARBUF_NAME(remote_str)),
-				  "%T", dep->sysname);
-		    erts_snprintf(pid_str, sizeof(DTRACE_CHARBUF_NAME(pid_str)),
-				  "%T", ctx->c_p->common.id);
-		    DTRACE4(dist_port_busy, erts_this_node_sysname,
-			    port_str, remote_str, pid_str);
+		/* Charge for the data as the port will when sending it */
+		ctx->reds -= ((size >> 10) + 1) * TERM_TO_BINARY_LOOP_FACTOR;
+		retval = dsig_send_enqueue(dsdp, ctx, fob);
+		if (ctx->fragments == 0 || retval == ERTS_DSIG_SEND_DROPPED) {
+		    /* Done, or the connection is gone; drop the rest */
+		    free_dist_obuf(ctx->obuf);
+		    ctx->obuf = NULL;
+		    erts_deref_dist_entry(dsdp->dep);
+		    break;
+		}
+		if (retval == ERTS_DSIG_SEND_YIELD || ctx->reds <= 0) {
+		    /* Busy or out of reductions; continue later */
+		    retval = ERTS_DSIG_SEND_CONTINUE;
+		    break;
 		}
-    #endif
-		if (!resume && erts_system_monitor_flags.busy_dist_port)
-		    monitor_generic(ctx->c_p, am_busy_dist_port, cid);
-		retval = ERTS_DSIG_SEND_YIELD;
-	    } else {
-		retval = ERTS_DSIG_SEND_OK;
 	    }
+	    if (retval == ERTS_DSIG_SEND_DROPPED)
+		retval = ERTS_DSIG_SEND_OK;
 	    goto done;
-	}
+
 	default:
 	    erts_exit(ERTS_ABORT_EXIT, "dsig_send invalid phase (%d)\n", (int)ctx->phase);
 	}
@@ -1957,6 +2294,41 @@ done:
     return retval;
 }
 
+/*
+ * Write the external dist header of 'ob' while updating the output
+ * atom cache. Must be done in the order buffers are sent.
+ */
+static ERTS_INLINE void
+finalize_obuf(ErtsDistOutputBuf *ob, DistEntry *dep, Uint32 flags)
+{
+    if (!ob->hdrp) {
+	ob->extp = erts_encode_ext_dist_header_finalize(ob->extp,
+							dep->cache,
+							flags);
+	if (!(flags & DFLAG_DIST_HDR_ATOM_CACHE))
+	    *--ob->extp = PASS_THROUGH; /* Old node; 'pass through'
+					   needed */
+	ASSERT(&ob->data[0] <= ob->extp && ob->extp < ob->ext_endp);
+    }
+    else if (ob->hdrp[1] == DIST_HEADER) {
+	/*
+	 * First fragment of a message; replace the leading
+	 * VERSION_MAGIC, DIST_HEADER of the finalized dist header with
+	 * the fragment header.
+	 */
+	byte ids[ERTS_DIST_FRAG_HEADER_SIZE - 2];
+	byte *ep;
+	sys_memcpy((void *) ids, (void *) &ob->data[0], sizeof(ids));
+	ep = erts_encode_ext_dist_header_finalize(ob->hdrp, dep->cache, flags);
+	ep -= sizeof(ids);
+	ASSERT(&ob->data[0] <= ep);
+	ep[0] = VERSION_MAGIC;
+	ep[1] = DIST_FRAG_HEADER;
+	sys_memcpy((void *) &ep[2], (void *) ids, sizeof(ids));
+	ob->hdrp = ep;
+    }
+}
+
 static Uint
 dist_port_command(Port *prt, ErtsDistOutputBuf *obuf)
 {
@@ -1985,6 +2357,8 @@ dist_port_command(Port *prt, ErtsDistOutputBuf *obuf)
                 remote_str, size);
     }
 #endif
+    /* Messages are only fragmented for drivers with outputv */
+    ASSERT(!obuf->hdrp);
     prt->caller = NIL;
     fpe_was_unmasked = erts_block_fpe();
     (*prt->drv_ptr->output)((ErlDrvData) prt->drv_data,
@@ -1999,8 +2373,8 @@ dist_port_commandv(Port *prt, ErtsDistOutputBuf *obuf)
 {
     int fpe_was_unmasked;
     Uint size = obuf->ext_endp - obuf->extp;
-    SysIOVec iov[2];
-    ErlDrvBinary* bv[2];
+    SysIOVec iov[3];
+    ErlDrvBinary* bv[3];
     ErlIOVec eiov;
 
     ERTS_SMP_CHK_NO_PROC_LOCKS;
@@ -2016,11 +2390,24 @@ dist_port_commandv(Port *prt, ErtsDistOutputBuf *obuf)
     iov[0].iov_len = 0;
     bv[0] = NULL;
 
-    iov[1].iov_base = obuf->extp;
-    iov[1].iov_len = size;
-    bv[1] = Binary2ErlDrvBinary(ErtsDistOutputBuf2Binary(obuf));
+    if (!obuf->hdrp) {
+	iov[1].iov_base = obuf->extp;
+	iov[1].iov_len = size;
+	bv[1] = Binary2ErlDrvBinary(ErtsDistOutputBuf2Binary(obuf));
+	eiov.vsize = 2;
+    }
+    else {
+	/* Fragment; header in obuf, data in the message buffer */
+	iov[1].iov_base = obuf->hdrp;
+	iov[1].iov_len = obuf->hdr_endp - obuf->hdrp;
+	bv[1] = Binary2ErlDrvBinary(ErtsDistOutputBuf2Binary(obuf));
+	iov[2].iov_base = obuf->extp;
+	iov[2].iov_len = size;
+	bv[2] = Binary2ErlDrvBinary(obuf->ext_bin);
+	size += iov[1].iov_len;
+	eiov.vsize = iov[2].iov_len ? 3 : 2;
+    }
 
-    eiov.vsize = 2;
     eiov.size = size;
     eiov.iov = iov;
     eiov.binv = bv;
@@ -2162,13 +2549,7 @@ erts_dist_command(Port *prt, int reds_limit)
 	    ob = oq.first;
 	    ASSERT(ob);
 	    do {
-		ob->extp = erts_encode_ext_dist_header_finalize(ob->extp,
-								dep->cache,
-								flags);
-		if (!(flags & DFLAG_DIST_HDR_ATOM_CACHE))
-		    *--ob->extp = PASS_THROUGH; /* Old node; 'pass through'
-						   needed */
-		ASSERT(&ob->data[0] <= ob->extp && ob->extp < ob->ext_endp);
+		finalize_obuf(ob, dep, flags);
 		reds += ERTS_PORT_REDS_DIST_CMD_FINALIZE;
 		preempt = reds > reds_limit;
 		if (preempt)
@@ -2206,16 +2587,8 @@ erts_dist_command(Port *prt, int reds_limit)
 	while (oq.first && !preempt) {
 	    ErtsDistOutputBuf *fob;
 	    Uint size;
-	    oq.first->extp
-		= erts_encode_ext_dist_header_finalize(oq.first->extp,
-						       dep->cache,
-						       flags);
+	    finalize_obuf(oq.first, dep, flags);
 	    reds += ERTS_PORT_REDS_DIST_CMD_FINALIZE;
-	    if (!(flags & DFLAG_DIST_HDR_ATOM_CACHE))
-		*--oq.first->extp = PASS_THROUGH; /* Old node; 'pass through'
-						     needed */
-	    ASSERT(&oq.first->data[0] <= oq.first->extp
-		   && oq.first->extp < oq.first->ext_endp);
 	    size = (*send)(prt, oq.first);
 	    esdp->io.out += (Uint64) size;
 #ifdef ERTS_RAW_DIST_MSG_DBG
@@ -44,6 +44,7 @@
 #define DFLAG_UTF8_ATOMS          0x10000
 #define DFLAG_MAP_TAG             0x20000
 #define DFLAG_BIG_CREATION        0x40000
+#define DFLAG_FRAGMENTS           0x800000
 
 /* All flags that should be enabled when term_to_binary/1 is used. */
 #define TERM_TO_BINARY_DFLAGS (DFLAG_EXTENDED_REFERENCES	\
@@ -279,7 +280,7 @@ erts_destroy_dist_link(ErtsDistLinkData *dldp)
 #define TERM_TO_BINARY_LOOP_FACTOR 1
 #endif
 
-typedef enum { TTBSize, TTBEncode, TTBCompress } TTBState;
+typedef enum { TTBSize, TTBEncode, TTBCompress, TTBCompressLZ4 } TTBState;
 typedef struct TTBSizeContext_ {
     Uint flags;
     int level;
@@ -306,6 +307,16 @@ typedef struct {
     z_stream stream;
 } TTBCompressContext;
 
+typedef struct {
+    Uint real_size;
+    Uint src_pos;		/* Uncompressed bytes consumed so far */
+    int level;
+    byte *dbytes;
+    byte *dend;
+    Binary *result_bin;
+    Binary *destination_bin;
+} TTBCompressLZ4Context;
+
 typedef struct {
     int alive;
     TTBState state;
@@ -313,6 +324,7 @@ typedef struct {
 	TTBSizeContext sc;
 	TTBEncodeContext ec;
 	TTBCompressContext cc;
+	TTBCompressLZ4Context lc;
     } s;
 } TTBContext;
 
@@ -321,7 +333,8 @@ enum erts_dsig_send_phase {
     ERTS_DSIG_SEND_PHASE_MSG_SIZE,
     ERTS_DSIG_SEND_PHASE_ALLOC,
     ERTS_DSIG_SEND_PHASE_MSG_ENCODE,
-    ERTS_DSIG_SEND_PHASE_FIN
+    ERTS_DSIG_SEND_PHASE_FIN,
+    ERTS_DSIG_SEND_PHASE_FRAGMENTS
 };
 
 struct erts_dsig_send_context {
@@ -335,6 +348,9 @@ struct erts_dsig_send_context {
     Uint data_size, dhdr_ext_size;
     ErtsAtomCacheMap *acmp;
     ErtsDistOutputBuf *obuf;
+    byte *fragp;		/* Start of data in obuf not yet sent */
+    Uint fragments;		/* Number of fragments left to send */
+    Uint64 seq;			/* Sequence id of the fragments */
     Uint32 flags;
     Process *c_p;
     union {
@@ -1637,6 +1637,29 @@ handle_args(int *argc, char **argv, erts_alc_hndl_args_init_t *init)
 #endif
 			    get_amount_value(argv[i]+9, argv, &i);
 		    }
+		    else if (has_prefix("hp", argv[i]+3)) {
+			char *hp = get_value(argv[i]+5, argv, &i);
+			int mode = ERTS_MMAP_HP_NONE;
+			if (strcmp("none", hp) == 0)
+			    mode = ERTS_MMAP_HP_NONE;
+			else if (strcmp("transparent", hp) == 0)
+			    mode = ERTS_MMAP_HP_TRANSPARENT;
+			else if (strcmp("explicit", hp) == 0)
+			    mode = ERTS_MMAP_HP_EXPLICIT;
+			else
+			    bad_value(param, param+4, hp);
+#if HAVE_ERTS_MSEG
+			init->mseg.dflt_mmap.hp = mode;
+#else
+			(void) mode;
+#endif
+		    }
+		    else if (has_prefix("nb", argv[i]+3)) {
+#if HAVE_ERTS_MSEG
+			init->mseg.nb =
+#endif
+			    get_bool_value(argv[i]+5, argv, &i);
+		    }
 		    else {
 			bad_param(param, param+2);
 		    }
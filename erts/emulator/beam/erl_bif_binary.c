@@ -41,11 +41,20 @@
 #include "erl_bits.h"
 #include "erl_bif_unique.h"
 
+#if defined(__GNUC__) && defined(__SSE2__)
+#  include <emmintrin.h>
+#  define ERTS_BINARY_SSE2 1
+#endif
+
 
 /*
  * The native implementation functions for the module binary.
  * Searching is implemented using either Boyer-Moore or Aho-Corasick
  * depending on number of searchstrings (BM if one, AC if more than one).
+ * Short single patterns are scanned for with memchr/SIMD instead of
+ * using the Boyer-Moore shift tables, and the Aho-Corasick search skips
+ * ahead to the next possible pattern start whenever it is in the root
+ * state.
  * Native implementation is mostly for efficiency, nothing
  * (except binary:referenced_byte_size) really *needs* to be implemented
  * in native code.
@@ -171,6 +180,25 @@ static void *my_alloc(MyAllocator *my, Uint size)
 
 #define ALPHABET_SIZE 256
 
+/*
+ * Patterns up to this length are searched for by scanning (see
+ * bm_scan()) instead of with the Boyer-Moore shift tables. Longer
+ * patterns let Boyer-Moore skip enough of the subject to win.
+ */
+#define BM_SCAN_MAX_LEN 16
+
+/*
+ * Maximum number of distinct first bytes of the patterns in an
+ * Aho-Corasick trie for which we scan ahead for a pattern start.
+ */
+#define AC_MAX_FIRST 8
+
+/*
+ * Bytes of subject scanned per loop iteration (i.e. per reduction
+ * unit) by the scanning search paths.
+ */
+#define SCAN_BYTES_PER_LOOP 16
+
 typedef struct _ac_node {
 #ifdef HARDDEBUG
     Uint32 id;                        /* To identify h pointer targets when
@@ -199,11 +227,17 @@ typedef struct _ac_trie {
 #endif
     Uint32 counter;                    /* Number of added patterns */
     ACNode *root;                      /* pointer to the root state */
+    Uint32 nfirst;                     /* Number of distinct first bytes of
+					  the patterns, 0 if too many to
+					  scan for */
+    byte first[AC_MAX_FIRST];          /* The distinct first bytes */
 } ACTrie;
 
 typedef struct _bm_data {
     byte *x;
     Sint len;
+    int scan;                          /* Search by scanning instead of
+					  using the shift tables */
     Sint *goodshift;
     Sint badshift[ALPHABET_SIZE];
 } BMData;
@@ -267,6 +301,7 @@ static ACTrie *create_acdata(MyAllocator *my, Uint len,
     act = my_alloc(my, sizeof(ACTrie)); /* Important that this is the first
 					   allocation */
     act->counter = 0;
+    act->nfirst = 0;
     act->root = acn = my_alloc(my, sizeof(ACNode));
     acn->d = 0;
     acn->final = 0;
@@ -296,6 +331,7 @@ static BMData *create_bmdata(MyAllocator *my, byte *x, Uint len,
     bmd->x = my_alloc(my,len);
     memcpy(bmd->x,x,len);
     bmd->len = len;
+    bmd->scan = (len <= BM_SCAN_MAX_LEN);
     bmd->goodshift = my_alloc(my,sizeof(Uint) * len);
     *the_bin = mb;
     return bmd;
@@ -412,6 +448,90 @@ static void ac_compute_failure_functions(ACTrie *act, ACNode **qbuff)
 }
 
 
+/*
+ * Collect the distinct first bytes of the patterns. While the search
+ * is in the root state, no byte outside this set can start a match, so
+ * the search can skip ahead to the next byte in the set.
+ */
+static void ac_compute_first_bytes(ACTrie *act)
+{
+    Uint32 n = 0;
+    int ch;
+
+    for (ch = 0; ch < ALPHABET_SIZE; ++ch) {
+	if (act->root->g[ch] != NULL) {
+	    if (n == AC_MAX_FIRST) {
+		act->nfirst = 0;
+		return;
+	    }
+	    act->first[n++] = (byte) ch;
+	}
+    }
+    act->nfirst = n;
+}
+
+/*
+ * Return the position of the first byte in haystack[i..end) that may
+ * start a pattern, or end if there is none.
+ */
+static Uint ac_skip_to_first(ACTrie *act, byte *haystack, Uint i, Uint end)
+{
+    ACNode *root = act->root;
+
+    if (act->nfirst == 1) {
+	byte *p = memchr(haystack + i, act->first[0], end - i);
+	return (p != NULL) ? (Uint) (p - haystack) : end;
+    }
+#ifdef ERTS_BINARY_SSE2
+    {
+	__m128i set[AC_MAX_FIRST];
+	Uint32 n = act->nfirst;
+	Uint32 k;
+
+	for (k = 0; k < n; ++k) {
+	    set[k] = _mm_set1_epi8((char) act->first[k]);
+	}
+	while (i + 16 <= end) {
+	    __m128i v = _mm_loadu_si128((__m128i *) (haystack + i));
+	    __m128i eq = _mm_cmpeq_epi8(v, set[0]);
+	    int mask;
+
+	    for (k = 1; k < n; ++k) {
+		eq = _mm_or_si128(eq, _mm_cmpeq_epi8(v, set[k]));
+	    }
+	    mask = _mm_movemask_epi8(eq);
+	    if (mask != 0) {
+		return i + __builtin_ctz(mask);
+	    }
+	    i += 16;
+	}
+    }
+#endif
+    while (i < end && root->g[haystack[i]] == NULL) {
+	++i;
+    }
+    return i;
+}
+
+/*
+ * Skip ahead from the root state, spending at most all but one of the
+ * remaining loop iterations on it.
+ */
+static ERTS_INLINE Uint ac_skip(ACTrie *act, byte *haystack, Uint i, Uint len,
+				Uint *reds)
+{
+    Uint end = len;
+    Uint span = (*reds - 1) * SCAN_BYTES_PER_LOOP;
+    Uint j;
+
+    if (end - i > span) {
+	end = i + span;
+    }
+    j = ac_skip_to_first(act, haystack, i, end);
+    *reds -= (j - i) / SCAN_BYTES_PER_LOOP;
+    return j;
+}
+
 /*
  * The actual searching for needles in the haystack...
  * Find first match using Aho-Coracick Trie
@@ -444,16 +564,18 @@ static void ac_init_find_first_match(ACFindFirstState *state, ACTrie *act, Sint
 
 #define AC_LOOP_FACTOR 10
 
-static int ac_find_first_match(ACFindFirstState *state, byte *haystack,
-				Uint *mpos, Uint *mlen, Uint *reductions)
+static int ac_find_first_match(ACFindFirstState *state, ACTrie *act,
+			       byte *haystack, Uint *mpos, Uint *mlen,
+			       Uint *reductions)
 {
+    ACNode *root = act->root;
     ACNode *q = state->q;
     Uint i = state->pos;
     ACNode *candidate = state->candidate, *r;
     Uint len = state->len;
     Uint candidate_start = state->candidate_start;
     Uint rstart;
-    register Uint reds = *reductions;
+    Uint reds = *reductions;
 
     while (i < len) {
 	if (--reds == 0) {
@@ -464,6 +586,12 @@ static int ac_find_first_match(ACFindFirstState *state, byte *haystack,
 	    state->candidate_start = candidate_start;
 	    return AC_RESTART;
 	}
+	if (q == root && candidate == NULL && act->nfirst != 0) {
+	    i = ac_skip(act, haystack, i, len, &reds);
+	    if (i == len) {
+		break;
+	    }
+	}
 
 	while (q->g[haystack[i]] == NULL && q->h != q) {
 	    q = q->h;
@@ -565,9 +693,10 @@ static void ac_clean_find_all(ACFindAllState *state)
  * Differs to the find_first function in that it stores all matches and the values
  * arte returned only in the state.
  */
-static int ac_find_all_non_overlapping(ACFindAllState *state, byte *haystack,
-				       Uint *reductions)
+static int ac_find_all_non_overlapping(ACFindAllState *state, ACTrie *act,
+				       byte *haystack, Uint *reductions)
 {
+    ACNode *root = act->root;
     ACNode *q = state->q;
     Uint i = state->pos;
     Uint rstart;
@@ -576,7 +705,7 @@ static int ac_find_all_non_overlapping(ACFindAllState *state, byte *haystack,
     Uint m = state->m, save_m;
     Uint allocated = state->allocated;
     FindallData *out = state->out;
-    register Uint reds = *reductions;
+    Uint reds = *reductions;
 
 
     while (i < len) {
@@ -589,6 +718,12 @@ static int ac_find_all_non_overlapping(ACFindAllState *state, byte *haystack,
 	    state->out = out;
 	    return AC_RESTART;
 	}
+	if (q == root && act->nfirst != 0) {
+	    i = ac_skip(act, haystack, i, len, &reds);
+	    if (i == len) {
+		break;
+	    }
+	}
 	while (q->g[haystack[i]] == NULL && q->h != q) {
 	    q = q->h;
 	}
@@ -753,6 +888,102 @@ typedef struct {
 #define BM_RESTART -2
 #define BM_LOOP_FACTOR 10 /* Should we have a higher value? */
 
+/*
+ * Return the start of the first occurrence of needle that starts in
+ * haystack[from..from+n), or -1 if there is none. The caller guarantees
+ * that a full needle fits after each of these start positions. Each
+ * candidate position is checked for the first and last byte of the
+ * needle before the rest is compared.
+ */
+static Sint scan_for_pattern(byte *needle, Sint blen, byte *haystack,
+			     Sint from, Sint n)
+{
+    byte first = needle[0];
+    byte last = needle[blen - 1];
+    Sint i = from;
+    Sint end = from + n;
+
+    if (blen == 1) {
+	byte *p = memchr(haystack + from, first, n);
+	return (p != NULL) ? (Sint) (p - haystack) : -1;
+    }
+#ifdef ERTS_BINARY_SSE2
+    {
+	__m128i vfirst = _mm_set1_epi8((char) first);
+	__m128i vlast = _mm_set1_epi8((char) last);
+
+	while (i + 16 <= end) {
+	    __m128i f = _mm_loadu_si128((__m128i *) (haystack + i));
+	    __m128i l = _mm_loadu_si128((__m128i *) (haystack + i + blen - 1));
+	    int mask = _mm_movemask_epi8(
+		_mm_and_si128(_mm_cmpeq_epi8(f, vfirst),
+			      _mm_cmpeq_epi8(l, vlast)));
+
+	    while (mask != 0) {
+		Sint k = i + __builtin_ctz(mask);
+		if (memcmp(haystack + k + 1, needle + 1, blen - 2) == 0) {
+		    return k;
+		}
+		mask &= mask - 1;
+	    }
+	    i += 16;
+	}
+    }
+#endif
+    while (i < end) {
+	byte *p = memchr(haystack + i, first, end - i);
+	if (p == NULL) {
+	    break;
+	}
+	i = p - haystack;
+	if (haystack[i + blen - 1] == last &&
+	    memcmp(haystack + i + 1, needle + 1, blen - 2) == 0) {
+	    return i;
+	}
+	++i;
+    }
+    return -1;
+}
+
+/*
+ * Search for a short pattern from *posp by scanning, spending at most
+ * all but one of the remaining loop iterations before giving up with
+ * BM_RESTART and *posp updated.
+ */
+static Sint bm_scan(BMData *bmd, byte *haystack, Sint *posp, Sint len,
+		    Uint *reductions)
+{
+    Sint blen = bmd->len;
+    Sint j = *posp;
+    Uint reds = *reductions;
+
+    while (j <= len - blen) {
+	Sint n = len - blen + 1 - j;
+	Uint max_n = (reds - 1) * SCAN_BYTES_PER_LOOP;
+	Sint found;
+	Uint scanned;
+
+	if (max_n == 0) {
+	    *posp = j;
+	    *reductions = reds;
+	    return BM_RESTART;
+	}
+	if ((Uint) n > max_n) {
+	    n = (Sint) max_n;
+	}
+	found = scan_for_pattern(bmd->x, blen, haystack, j, n);
+	scanned = (found < 0) ? n : found - j + 1;
+	reds -= (scanned + SCAN_BYTES_PER_LOOP - 1) / SCAN_BYTES_PER_LOOP;
+	if (found >= 0) {
+	    *reductions = reds;
+	    return found;
+	}
+	j += n;
+    }
+    *reductions = reds;
+    return BM_NOT_FOUND;
+}
+
 static void bm_init_find_first_match(BMFindFirstState *state, Sint startpos,
 				     Uint len)
 {
@@ -773,6 +1004,10 @@ static Sint bm_find_first_match(BMFindFirstState *state, BMData *bmd,
     Sint j = state->pos;
     register Uint reds = *reductions;
 
+    if (bmd->scan) {
+	Sint pos = bm_scan(bmd, haystack, &state->pos, len, reductions);
+	return pos;
+    }
     while (j <= len - blen) {
 	if (--reds == 0) {
 	    state->pos = j;
@@ -856,18 +1091,25 @@ static Sint bm_find_all_non_overlapping(BMFindAllState *state,
     Uint m = state->m;
     Uint allocated = state->allocated;
     FindallData *out = state->out;
-    register Uint reds = *reductions;
+    Uint reds = *reductions;
 
     while (j <= len - blen) {
-	if (--reds == 0) {
-	    state->pos = j;
-	    state->m = m;
-	    state->allocated = allocated;
-	    state->out = out;
-	    return BM_RESTART;
+	if (bmd->scan) {
+	    Sint pos = bm_scan(bmd, haystack, &j, len, &reds);
+	    if (pos == BM_NOT_FOUND) {
+		break;
+	    } else if (pos == BM_RESTART) {
+		goto restart;
+	    }
+	    j = pos;
+	    i = -1;
+	} else {
+	    if (--reds == 0) {
+		goto restart;
+	    }
+	    for (i = blen - 1; i >= 0 && needle[i] == haystack[i + j]; --i)
+		;
 	}
-	for (i = blen - 1; i >= 0 && needle[i] == haystack[i + j]; --i)
-	    ;
 	if (i < 0) { /* found */
 	    if (m >= allocated) {
 		if (!allocated) {
@@ -891,6 +1133,13 @@ static Sint bm_find_all_non_overlapping(BMFindAllState *state,
     state->out = out;
     *reductions = reds;
     return (m == 0) ? BM_NOT_FOUND : BM_OK;
+
+ restart:
+    state->pos = j;
+    state->m = m;
+    state->allocated = allocated;
+    state->out = out;
+    return BM_RESTART;
 }
 
 /*
@@ -991,6 +1240,7 @@ static int do_binary_match_compile(Eterm argument, Eterm *tag, Binary **binp)
 	    erts_free_aligned_binary_bytes(temp_alloc);
 	}
 	ac_compute_failure_functions(act,qbuff);
+	ac_compute_first_bytes(act);
 	CHECK_ALLOCATOR(my);
 	erts_free(ERTS_ALC_T_TMP,qbuff);
 	*tag = am_ac;
@@ -1283,7 +1533,7 @@ static int do_binary_find(Process *p, Eterm subject, BinaryFindState *bfs, Binar
 	    } else {
 		ac_restore_find_all(&state, &(state_ptr->data.acfas));
 	    }
-	    acr = ac_find_all_non_overlapping(&state, bytes, &reds);
+	    acr = ac_find_all_non_overlapping(&state, act, bytes, &reds);
 	    if (acr == AC_NOT_FOUND) {
 		*res_term = bfs->not_found_result(p, subject, bfs);
 	    } else if (acr == AC_RESTART) {
@@ -1371,7 +1621,7 @@ static int do_binary_find(Process *p, Eterm subject, BinaryFindState *bfs, Binar
 	    } else {
 		memcpy(&state, &state_ptr->data.acffs, sizeof(ACFindFirstState));
 	    }
-	    acr = ac_find_first_match(&state, bytes, &pos, &rlen, &reds);
+	    acr = ac_find_first_match(&state, act, bytes, &pos, &rlen, &reds);
 	    if (acr == AC_NOT_FOUND) {
 		*res_term = bfs->not_found_result(p, subject, bfs);
 	    } else if (acr == AC_RESTART) {
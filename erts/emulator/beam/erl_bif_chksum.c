@@ -31,6 +31,21 @@
 #include "big.h"
 #include "zlib.h"
 
+/*
+ * Hardware CRC. PCLMULQDQ (carry-less multiplication) is used to fold
+ * crc32 over 64 bytes at a time, and the SSE4.2 crc32 instruction
+ * computes crc32c. Both are compiled with target attributes and used
+ * only if cpuid reports support for them.
+ */
+#if defined(__GNUC__) && defined(__x86_64__) \
+    && (defined(__clang__) || __GNUC__ > 4 \
+        || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#  include <cpuid.h>
+#  include <immintrin.h>
+#  define ERTS_CRC_X86 1
+#  define ERTS_CRC_FUNC(TARGET) __attribute__((__target__(TARGET)))
+#endif
+
 
 typedef void (*ChksumFun)(void *sum_in_out, unsigned char *buf, 
 			  unsigned buflen);
@@ -40,12 +55,48 @@ static BIF_RETTYPE md5_2(BIF_ALIST_2);
 
 static Export chksum_md5_2_exp;
 
+#define CRC32C_POLY 0x82F63B78 /* Castagnoli, reflected */
+
+static Uint32 crc32c_table[8][256];
+
+#ifdef ERTS_CRC_X86
+static int crc32_have_pclmul;
+static int crc32c_have_sse42;
+#endif
+
 void erts_init_bif_chksum(void)
 {
+    int i, j;
+
     /* Non visual BIF to trap to. */
     erts_init_trap_export(&chksum_md5_2_exp,
 			  am_erlang, am_atom_put("md5_trap",8), 2,
 			  &md5_2);
+
+    /* Tables for crc32c eight bytes at a time (slicing-by-8) */
+    for (i = 0; i < 256; i++) {
+	Uint32 crc = (Uint32) i;
+	for (j = 0; j < 8; j++) {
+	    crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+	}
+	crc32c_table[0][i] = crc;
+    }
+    for (i = 0; i < 256; i++) {
+	for (j = 1; j < 8; j++) {
+	    Uint32 prev = crc32c_table[j-1][i];
+	    crc32c_table[j][i] = (prev >> 8) ^ crc32c_table[0][prev & 0xff];
+	}
+    }
+
+#ifdef ERTS_CRC_X86
+    {
+	unsigned int eax, ebx, ecx, edx;
+	if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+	    crc32_have_pclmul = (ecx & bit_PCLMUL) && (ecx & bit_SSE4_1);
+	    crc32c_have_sse42 = !!(ecx & bit_SSE4_2);
+	}
+    }
+#endif
 }
     
 
@@ -293,10 +344,237 @@ static void adler32_wrap(void *vsum, unsigned char *buf, unsigned buflen)
     *((unsigned long *) vsum) = sum;
 }
 
+#ifdef ERTS_CRC_X86
+
+/*
+ * crc32 of len bytes, a multiple of 16 and at least 64, by folding with
+ * carry-less multiplication as described in "Fast CRC Computation for
+ * Generic Polynomials Using PCLMULQDQ Instruction" (Gopal et al, Intel).
+ * The constants are the bit reflected x^(4*128+32), x^(4*128-32),
+ * x^(128+32), x^(128-32) and x^64 mod P(x), followed by P(x) and the
+ * Barrett constant. crc is not inverted on entry or exit.
+ */
+static ERTS_CRC_FUNC("pclmul,sse4.1") Uint32
+crc32_pclmul(Uint32 crc, unsigned char *buf, Uint len)
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5 = _mm_set_epi64x(0, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128((__m128i *) (buf + 0x00));
+    x2 = _mm_loadu_si128((__m128i *) (buf + 0x10));
+    x3 = _mm_loadu_si128((__m128i *) (buf + 0x20));
+    x4 = _mm_loadu_si128((__m128i *) (buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int) crc));
+    buf += 64;
+    len -= 64;
+
+    /* Fold four 128 bit lanes in parallel */
+    while (len >= 64) {
+	x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+	x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+	x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+	x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+	x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+	x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+	x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+			   _mm_loadu_si128((__m128i *) (buf + 0x00)));
+	x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+			   _mm_loadu_si128((__m128i *) (buf + 0x10)));
+	x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+			   _mm_loadu_si128((__m128i *) (buf + 0x20)));
+	x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+			   _mm_loadu_si128((__m128i *) (buf + 0x30)));
+	buf += 64;
+	len -= 64;
+    }
+
+    /* Fold the lanes into one, and then the remaining 16 byte blocks */
+    x0 = k3k4;
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+    while (len >= 16) {
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+			   _mm_loadu_si128((__m128i *) buf));
+	buf += 16;
+	len -= 16;
+    }
+
+    /* 128 bits to 64 bits */
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    /* Barrett reduction to 32 bits */
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (Uint32) _mm_extract_epi32(x1, 1);
+}
+
+static ERTS_CRC_FUNC("sse4.2") Uint32
+crc32c_sse42(Uint32 crc, unsigned char *buf, Uint len)
+{
+    Uint64 crc64;
+
+    crc = ~crc;
+    while (len && ((UWord) buf & 7)) {
+	crc = _mm_crc32_u8(crc, *buf++);
+	len--;
+    }
+    crc64 = crc;
+    while (len >= 8) {
+	Uint64 word;
+	sys_memcpy(&word, buf, sizeof(word));
+	crc64 = _mm_crc32_u64(crc64, word);
+	buf += 8;
+	len -= 8;
+    }
+    crc = (Uint32) crc64;
+    while (len--) {
+	crc = _mm_crc32_u8(crc, *buf++);
+    }
+    return ~crc;
+}
+
+#endif /* ERTS_CRC_X86 */
+
+static Uint32 erts_crc32(Uint32 crc, unsigned char *buf, unsigned len)
+{
+#ifdef ERTS_CRC_X86
+    if (crc32_have_pclmul && len >= 64) {
+	unsigned blocks = len & ~((unsigned) 15);
+	crc = ~crc32_pclmul(~crc, buf, blocks);
+	buf += blocks;
+	len -= blocks;
+    }
+#endif
+    return (Uint32) crc32(crc, buf, len);
+}
+
+static Uint32 erts_crc32c(Uint32 crc, unsigned char *buf, unsigned len)
+{
+#ifdef ERTS_CRC_X86
+    if (crc32c_have_sse42) {
+	return crc32c_sse42(crc, buf, len);
+    }
+#endif
+    crc = ~crc;
+    while (len >= 8) {
+	Uint32 lo = crc ^ (((Uint32) buf[0]) | ((Uint32) buf[1] << 8)
+			   | ((Uint32) buf[2] << 16) | ((Uint32) buf[3] << 24));
+	Uint32 hi = (((Uint32) buf[4]) | ((Uint32) buf[5] << 8)
+		     | ((Uint32) buf[6] << 16) | ((Uint32) buf[7] << 24));
+	crc = (crc32c_table[7][lo & 0xff]
+	       ^ crc32c_table[6][(lo >> 8) & 0xff]
+	       ^ crc32c_table[5][(lo >> 16) & 0xff]
+	       ^ crc32c_table[4][lo >> 24]
+	       ^ crc32c_table[3][hi & 0xff]
+	       ^ crc32c_table[2][(hi >> 8) & 0xff]
+	       ^ crc32c_table[1][(hi >> 16) & 0xff]
+	       ^ crc32c_table[0][hi >> 24]);
+	buf += 8;
+	len -= 8;
+    }
+    while (len--) {
+	crc = crc32c_table[0][(crc ^ *buf++) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/*
+ * Combining crc32c checksums, as zlib's crc32_combine() does for crc32:
+ * the crc of the first part is advanced over len2 zero bytes by applying
+ * repeatedly squared GF(2) matrices.
+ */
+static Uint32 gf2_matrix_times(Uint32 *mat, Uint32 vec)
+{
+    Uint32 sum = 0;
+    while (vec) {
+	if (vec & 1) {
+	    sum ^= *mat;
+	}
+	vec >>= 1;
+	mat++;
+    }
+    return sum;
+}
+
+static void gf2_matrix_square(Uint32 *square, Uint32 *mat)
+{
+    int n;
+    for (n = 0; n < 32; n++) {
+	square[n] = gf2_matrix_times(mat, mat[n]);
+    }
+}
+
+static Uint32 crc32c_combine(Uint32 crc1, Uint32 crc2, Uint len2)
+{
+    Uint32 even[32]; /* operator for an even power of two zero bits */
+    Uint32 odd[32];  /* operator for an odd power of two zero bits */
+    Uint32 row;
+    int n;
+
+    if (len2 == 0) {
+	return crc1;
+    }
+    odd[0] = CRC32C_POLY; /* one zero bit */
+    row = 1;
+    for (n = 1; n < 32; n++) {
+	odd[n] = row;
+	row <<= 1;
+    }
+    gf2_matrix_square(even, odd); /* two zero bits */
+    gf2_matrix_square(odd, even); /* four zero bits */
+    do {
+	gf2_matrix_square(even, odd);
+	if (len2 & 1) {
+	    crc1 = gf2_matrix_times(even, crc1);
+	}
+	len2 >>= 1;
+	if (len2 == 0) {
+	    break;
+	}
+	gf2_matrix_square(odd, even);
+	if (len2 & 1) {
+	    crc1 = gf2_matrix_times(odd, crc1);
+	}
+	len2 >>= 1;
+    } while (len2 != 0);
+    return crc1 ^ crc2;
+}
+
 static void crc32_wrap(void *vsum, unsigned char *buf, unsigned buflen)
 {
     unsigned long sum = *((unsigned long *) vsum);
-    sum = crc32(sum,buf,buflen);
+    sum = erts_crc32((Uint32) sum,buf,buflen);
+    *((unsigned long *) vsum) = sum;
+}
+
+static void crc32c_wrap(void *vsum, unsigned char *buf, unsigned buflen)
+{
+    unsigned long sum = *((unsigned long *) vsum);
+    sum = erts_crc32c((Uint32) sum,buf,buflen);
     *((unsigned long *) vsum) = sum;
 }
 
@@ -389,6 +667,86 @@ crc32_combine_3(BIF_ALIST_3)
     BIF_RET(res_sum);
 }
 
+BIF_RETTYPE
+crc32c_1(BIF_ALIST_1)
+{
+    unsigned long chksum;
+    int res, err;
+    Eterm rest,res_sum;
+    chksum = 0;
+
+    rest = do_chksum(&crc32c_wrap,BIF_P,BIF_ARG_1,CHUNK_PER_SCHEDULE,
+		     (void *) &chksum,&res,
+		     &err);
+    BUMP_REDS(BIF_P,res / BYTES_PER_REDUCTION);
+    if (err != 0) {
+	BIF_ERROR(BIF_P, BADARG);
+    }
+    res_sum = erts_make_integer(chksum,BIF_P);
+    if (rest != NIL) {
+	BUMP_ALL_REDS(BIF_P);
+	BIF_TRAP2(bif_export[BIF_crc32c_2], BIF_P, res_sum, rest);
+    }
+    BIF_RET(res_sum);
+}
+
+BIF_RETTYPE
+crc32c_2(BIF_ALIST_2)
+{
+    unsigned long chksum;
+    int res, err;
+    Eterm rest,res_sum;
+    Uint u;
+    if (!term_to_Uint(BIF_ARG_1, &u) || ((u >> 16) >> 16) != 0) {
+	BIF_ERROR(BIF_P, BADARG);
+    }
+    chksum = (unsigned long) u;
+
+    rest = do_chksum(&crc32c_wrap,BIF_P,BIF_ARG_2,CHUNK_PER_SCHEDULE,
+		     (void *) &chksum,&res,
+		     &err);
+    BUMP_REDS(BIF_P,res / BYTES_PER_REDUCTION);
+    if (err != 0) {
+	BIF_ERROR(BIF_P, BADARG);
+    }
+    res_sum = erts_make_integer(chksum,BIF_P);
+    if (rest != NIL) {
+	BUMP_ALL_REDS(BIF_P);
+	BIF_TRAP2(bif_export[BIF_crc32c_2], BIF_P, res_sum, rest);
+    }
+    BIF_RET(res_sum);
+}
+
+BIF_RETTYPE
+crc32c_combine_3(BIF_ALIST_3)
+{
+    Uint32 chksum1,chksum2;
+    Uint length;
+    Uint32 res;
+    Eterm res_sum;
+    Uint u;
+
+    if (!term_to_Uint(BIF_ARG_1, &u) || ((u >> 16) >> 16) != 0) {
+	BIF_ERROR(BIF_P, BADARG);
+    }
+    chksum1 = (Uint32) u;
+
+    if (!term_to_Uint(BIF_ARG_2, &u) || ((u >> 16) >> 16) != 0) {
+	BIF_ERROR(BIF_P, BADARG);
+    }
+    chksum2 = (Uint32) u;
+
+    if (!term_to_Uint(BIF_ARG_3, &u) || ((u >> 16) >> 16) != 0) {
+	BIF_ERROR(BIF_P, BADARG);
+    }
+    length = u;
+
+    res = crc32c_combine(chksum1,chksum2,length);
+
+    res_sum = erts_make_integer(res,BIF_P);
+    BIF_RET(res_sum);
+}
+
 BIF_RETTYPE
 adler32_1(BIF_ALIST_1)
 {
@@ -4156,6 +4156,14 @@ BIF_RETTYPE erts_debug_set_internal_state_2(BIF_ALIST_2)
 		BIF_RET(make_small(max_loops));
 	    }
 	}
+	else if (ERTS_IS_ATOM_STR("ms_fused_heads", BIF_ARG_1)) {
+	    /* Used by match_spec_SUITE */
+	    int old;
+	    if (BIF_ARG_2 == am_true || BIF_ARG_2 == am_false) {
+		old = erts_db_match_set_fused_heads(BIF_ARG_2 == am_true);
+		BIF_RET(old ? am_true : am_false);
+	    }
+	}
 	else if (ERTS_IS_ATOM_STR("unicode_loop_limit", BIF_ARG_1)) {
 	    /* Used by unicode_SUITE (stdlib) */
 	    Uint max_loops;
@@ -0,0 +1,356 @@
+/*
+ * %CopyrightBegin%
+ *
+ * Copyright Ericsson AB 2017. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * %CopyrightEnd%
+ */
+
+/*
+ * Persistent terms
+ *
+ * A global key/value store for terms that are seldom or never
+ * updated. Each {Key, Value} pair is copied into a literal area of
+ * its own, so that lookups can return the value to the calling
+ * process without copying it.
+ *
+ * The table itself is an immutable open addressing hash table of
+ * pointers to such areas. Lookups read the current table without
+ * any locking. Updates, which are serialized by a mutex, build a
+ * new table, publish it, and schedule the old table for
+ * deallocation when all schedulers have passed a thread progress
+ * point. A replaced or erased term is handed over to the code purger
+ * which frees it when no process refers it any more; see
+ * erts_queue_release_literal_area(). Since the purger releases all
+ * areas queued in one batch, processes are scanned once per batch
+ * and not once per update.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+#include "sys.h"
+#include "erl_vm.h"
+#include "global.h"
+#include "erl_process.h"
+#include "error.h"
+#include "bif.h"
+#include "erl_binary.h"
+#include "erl_thr_progress.h"
+
+#define PERSISTENT_TERM_MIN_TABLE_SIZE 8
+
+typedef struct {
+    struct erl_off_heap_header *first_oh;
+    Eterm term;			/* {Key, Value} */
+    Uint words;			/* Size of mem in words */
+    Eterm mem[1];
+} PersistentTerm;
+
+typedef struct {
+#ifdef ERTS_SMP
+    ErtsThrPrgrLaterOp lop;
+#endif
+    Uint size;			/* Number of slots; a power of two */
+    Uint count;			/* Number of terms */
+    PersistentTerm *slot[1];
+} PersistentTermTable;
+
+static erts_smp_mtx_t persistent_term_mtx;
+static erts_smp_atomic_t persistent_term_table;
+static erts_smp_atomic_t persistent_term_words; /* Protected by mtx */
+
+#define PT_TABLE_BYTES(SZ) \
+    (offsetof(PersistentTermTable, slot) + (SZ) * sizeof(PersistentTerm *))
+
+static PersistentTermTable *
+alloc_table(Uint size)
+{
+    PersistentTermTable *tab;
+    Uint i;
+
+    tab = erts_alloc(ERTS_ALC_T_PERSISTENT_TERM_TAB, PT_TABLE_BYTES(size));
+    tab->size = size;
+    tab->count = 0;
+    for (i = 0; i < size; i++)
+	tab->slot[i] = NULL;
+    return tab;
+}
+
+static ERTS_INLINE PersistentTermTable *
+get_table(void)
+{
+    return (PersistentTermTable *)
+	erts_smp_atomic_read_ddrb(&persistent_term_table);
+}
+
+static ERTS_INLINE Eterm
+pt_key(PersistentTerm *ptp)
+{
+    return tuple_val(ptp->term)[1];
+}
+
+/*
+ * Return the slot where Key is stored, or the empty slot where it
+ * would be inserted.
+ */
+static Uint
+lookup_slot(PersistentTermTable *tab, Eterm key)
+{
+    Uint mask = tab->size - 1;
+    Uint ix = make_internal_hash(key) & mask;
+
+    while (tab->slot[ix] && !EQ(pt_key(tab->slot[ix]), key))
+	ix = (ix + 1) & mask;
+    return ix;
+}
+
+void
+erts_init_bif_persistent_term(void)
+{
+    erts_smp_mtx_init(&persistent_term_mtx, "persistent_term");
+    erts_smp_atomic_init_nob(&persistent_term_table,
+			     (erts_aint_t) alloc_table(PERSISTENT_TERM_MIN_TABLE_SIZE));
+    erts_smp_atomic_init_nob(&persistent_term_words, 0);
+}
+
+static PersistentTerm *
+create_term(Eterm key, Eterm value)
+{
+    PersistentTerm *ptp;
+    ErlOffHeap oh;
+    Uint key_sz = size_object(key);
+    Uint value_sz = size_object(value);
+    Uint words = 3 + key_sz + value_sz;
+    Eterm *hp, k, v;
+
+    ptp = erts_alloc_fnf(ERTS_ALC_T_PERSISTENT_TERM,
+			 offsetof(PersistentTerm, mem) + words * sizeof(Eterm));
+    if (!ptp)
+	return NULL; /* Literal area exhausted */
+    ERTS_INIT_OFF_HEAP(&oh);
+    hp = ptp->mem + 3;
+    k = copy_struct(key, key_sz, &hp, &oh);
+    v = copy_struct(value, value_sz, &hp, &oh);
+    ASSERT(hp == ptp->mem + words);
+    ptp->term = TUPLE2(ptp->mem, k, v);
+    ptp->first_oh = oh.first;
+    ptp->words = words;
+    return ptp;
+}
+
+static void
+release_term(PersistentTerm *ptp)
+{
+    erts_smp_atomic_add_nob(&persistent_term_words, -(erts_aint_t) ptp->words);
+    erts_queue_release_literal_area(ERTS_ALC_T_PERSISTENT_TERM, ptp,
+				    ptp->mem, ptp->words, ptp->first_oh);
+}
+
+static void
+free_table(void *vtab)
+{
+    erts_free(ERTS_ALC_T_PERSISTENT_TERM_TAB, vtab);
+}
+
+/*
+ * Build a copy of 'old' where the term with key 'key' is replaced
+ * by 'new', or removed if 'new' is NULL. Must be called with the
+ * mutex locked.
+ */
+static PersistentTermTable *
+copy_table(PersistentTermTable *old, Eterm key, PersistentTerm *new)
+{
+    PersistentTermTable *tab;
+    Uint count = old->count + (new ? 1 : 0);
+    Uint size = PERSISTENT_TERM_MIN_TABLE_SIZE;
+    Uint i;
+
+    while (size < 2 * count)
+	size *= 2;
+    tab = alloc_table(size);
+
+    for (i = 0; i < old->size; i++) {
+	PersistentTerm *ptp = old->slot[i];
+	if (ptp && !EQ(pt_key(ptp), key)) {
+	    tab->slot[lookup_slot(tab, pt_key(ptp))] = ptp;
+	    tab->count++;
+	}
+    }
+    if (new) {
+	tab->slot[lookup_slot(tab, key)] = new;
+	tab->count++;
+    }
+    return tab;
+}
+
+/*
+ * Make 'tab' the current table, deallocate the previous table when
+ * no scheduler may be reading it, and release 'old_term' if any.
+ * Must be called with the mutex locked.
+ */
+static void
+publish_table(PersistentTermTable *tab, PersistentTerm *old_term)
+{
+    PersistentTermTable *old = get_table();
+
+    erts_smp_atomic_set_relb(&persistent_term_table, (erts_aint_t) tab);
+#ifdef ERTS_SMP
+    erts_schedule_thr_prgr_later_cleanup_op(free_table, (void *) old,
+					    &old->lop,
+					    PT_TABLE_BYTES(old->size));
+#else
+    free_table(old);
+#endif
+    if (old_term)
+	release_term(old_term);
+}
+
+BIF_RETTYPE persistent_term_put_2(BIF_ALIST_2)
+{
+    PersistentTermTable *tab;
+    PersistentTerm *old_term, *new_term;
+    Eterm key = BIF_ARG_1;
+    Eterm value = BIF_ARG_2;
+    Uint reds;
+
+    erts_smp_mtx_lock(&persistent_term_mtx);
+    tab = get_table();
+    old_term = tab->slot[lookup_slot(tab, key)];
+    if (old_term && EQ(tuple_val(old_term->term)[2], value)) {
+	erts_smp_mtx_unlock(&persistent_term_mtx);
+	BIF_RET(am_ok);
+    }
+    new_term = create_term(key, value);
+    if (!new_term) {
+	erts_smp_mtx_unlock(&persistent_term_mtx);
+	BIF_ERROR(BIF_P, SYSTEM_LIMIT);
+    }
+    erts_smp_atomic_add_nob(&persistent_term_words, new_term->words);
+    reds = tab->size / 16 + new_term->words / 64;
+    publish_table(copy_table(tab, key, new_term), old_term);
+    erts_smp_mtx_unlock(&persistent_term_mtx);
+
+    BUMP_REDS(BIF_P, reds);
+    BIF_RET(am_ok);
+}
+
+static ERTS_INLINE Eterm
+get_value(Process *c_p, PersistentTerm *ptp)
+{
+    Eterm value = tuple_val(ptp->term)[2];
+#ifdef ERTS_HAVE_IS_IN_LITERAL_RANGE
+    (void) c_p;
+    return value;
+#else
+    /*
+     * Literals cannot be told apart from heap terms on this
+     * platform; give the process a copy of its own.
+     */
+    Uint sz = size_object(value);
+    Eterm *hp = HAlloc(c_p, sz);
+    return copy_struct(value, sz, &hp, &MSO(c_p));
+#endif
+}
+
+BIF_RETTYPE persistent_term_get_1(BIF_ALIST_1)
+{
+    PersistentTermTable *tab = get_table();
+    PersistentTerm *ptp = tab->slot[lookup_slot(tab, BIF_ARG_1)];
+
+    if (!ptp)
+	BIF_ERROR(BIF_P, BADARG);
+    BIF_RET(get_value(BIF_P, ptp));
+}
+
+BIF_RETTYPE persistent_term_get_2(BIF_ALIST_2)
+{
+    PersistentTermTable *tab = get_table();
+    PersistentTerm *ptp = tab->slot[lookup_slot(tab, BIF_ARG_1)];
+
+    if (!ptp)
+	BIF_RET(BIF_ARG_2);
+    BIF_RET(get_value(BIF_P, ptp));
+}
+
+BIF_RETTYPE persistent_term_erase_1(BIF_ALIST_1)
+{
+    PersistentTermTable *tab;
+    PersistentTerm *old_term;
+    Eterm key = BIF_ARG_1;
+    Uint reds;
+
+    erts_smp_mtx_lock(&persistent_term_mtx);
+    tab = get_table();
+    old_term = tab->slot[lookup_slot(tab, key)];
+    if (!old_term) {
+	erts_smp_mtx_unlock(&persistent_term_mtx);
+	BIF_RET(am_false);
+    }
+    reds = tab->size / 16;
+    publish_table(copy_table(tab, key, NULL), old_term);
+    erts_smp_mtx_unlock(&persistent_term_mtx);
+
+    BUMP_REDS(BIF_P, reds);
+    BIF_RET(am_true);
+}
+
+BIF_RETTYPE persistent_term_get_0(BIF_ALIST_0)
+{
+    PersistentTermTable *tab = get_table();
+    Eterm res = NIL;
+    Eterm *hp;
+    Uint i;
+
+#ifdef ERTS_HAVE_IS_IN_LITERAL_RANGE
+    hp = HAlloc(BIF_P, 2 * tab->count);
+    for (i = 0; i < tab->size; i++) {
+	if (tab->slot[i]) {
+	    res = CONS(hp, tab->slot[i]->term, res);
+	    hp += 2;
+	}
+    }
+#else
+    for (i = 0; i < tab->size; i++) {
+	if (tab->slot[i]) {
+	    Eterm term = tab->slot[i]->term;
+	    Uint sz = size_object(term);
+	    hp = HAlloc(BIF_P, sz + 2);
+	    term = copy_struct(term, sz, &hp, &MSO(BIF_P));
+	    res = CONS(hp, term, res);
+	}
+    }
+#endif
+    BUMP_REDS(BIF_P, tab->size / 16);
+    BIF_RET(res);
+}
+
+BIF_RETTYPE persistent_term_info_0(BIF_ALIST_0)
+{
+    PersistentTermTable *tab = get_table();
+    Uint words = (Uint) erts_smp_atomic_read_nob(&persistent_term_words);
+    Uint memory = PT_TABLE_BYTES(tab->size) + words * sizeof(Eterm)
+	+ tab->count * offsetof(PersistentTerm, mem);
+    Uint hsz = 2 * 2 + 2 * 3;
+    Eterm *hp, mem, res;
+
+    erts_bld_uint(NULL, &hsz, memory);
+    hp = HAlloc(BIF_P, hsz);
+    mem = erts_bld_uint(&hp, NULL, memory);
+    res = CONS(hp, TUPLE2(hp + 2, am_memory, mem), NIL);
+    hp += 2 + 3;
+    res = CONS(hp, TUPLE2(hp + 2, am_count, make_small(tab->count)), res);
+    BIF_RET(res);
+}
@@ -37,6 +37,17 @@
 #define PCRE_DEFAULT_EXEC_OPTS 0 
 #define LOOP_FACTOR 10
 
+/*
+ * JIT compiled code does not count loops the way the interpreter
+ * does, so the subject length is used to decide whether a match is
+ * cheap enough to run to completion without yielding. Larger jobs
+ * are left to the interpreter, which can trap.
+ */
+#define JIT_BYTES_PER_LOOP 4
+#define JIT_STACK_START (32*1024)
+#define JIT_STACK_MAX (1024*1024)
+#define JIT_EXEC_OPTS (PCRE_NOTBOL | PCRE_NOTEOL | PCRE_NOTEMPTY | \
+		       PCRE_NOTEMPTY_ATSTART)
 
 static const unsigned char *default_table;
 static Uint max_loop_limit;
@@ -44,6 +55,7 @@ static Export re_exec_trap_export;
 static Export *grun_trap_exportp = NULL;
 static Export *urun_trap_exportp = NULL;
 static Export *ucompile_trap_exportp = NULL;
+static pcre_jit_stack **jit_stacks; /* One per scheduler, created on demand */
 
 static BIF_RETTYPE re_exec_trap(BIF_ALIST_3);
 static BIF_RETTYPE re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3);
@@ -73,6 +85,10 @@ void erts_init_bif_re(void)
     default_table = NULL; /* ISO8859-1 default, forced into pcre */
     max_loop_limit = CONTEXT_REDS * LOOP_FACTOR;
 
+    jit_stacks = erts_alloc(ERTS_ALC_T_RE_HEAP,
+			    erts_no_schedulers * sizeof(pcre_jit_stack *));
+    sys_memzero(jit_stacks, erts_no_schedulers * sizeof(pcre_jit_stack *));
+
     erts_init_trap_export(&re_exec_trap_export, am_erlang, am_re_run_trap, 3,
 			  &re_exec_trap);
 
@@ -94,6 +110,90 @@ Sint erts_re_set_loop_limit(Sint limit)
     return save;
 }
 
+/*
+ * JIT machinery. A pattern compiled with the jit option keeps the
+ * pcre code and the result of erts_pcre_study() in a magic binary, as
+ * the generated machine code refers into the compiled pattern.
+ */
+
+typedef struct {
+    pcre *code;
+    erts_pcre_extra *extra;
+} JitCode;
+
+static pcre_jit_stack *get_jit_stack(void *unused)
+{
+    ErtsSchedulerData *esdp = erts_get_scheduler_data();
+    pcre_jit_stack **stackp;
+
+    if (!esdp || ERTS_SCHEDULER_IS_DIRTY(esdp)) {
+	return NULL; /* PCRE uses a small area of the machine stack */
+    }
+    stackp = &jit_stacks[esdp->no - 1];
+    if (*stackp == NULL) {
+	*stackp = erts_pcre_jit_stack_alloc(JIT_STACK_START, JIT_STACK_MAX);
+    }
+    return *stackp;
+}
+
+static void cleanup_jit_code_bin(Binary *bp)
+{
+    JitCode *jc = ERTS_MAGIC_BIN_DATA(bp);
+    erts_pcre_free_study(jc->extra);
+    erts_pcre_free(jc->code);
+}
+
+/*
+ * Returns a magic binary owning code, or NULL (code untouched) if
+ * the pattern could not be JIT compiled.
+ */
+static Binary *make_jit_code(pcre *code)
+{
+    const char *errstr = NULL;
+    erts_pcre_extra *extra;
+    Binary *mbp;
+    JitCode *jc;
+
+    extra = erts_pcre_study(code, PCRE_STUDY_JIT_COMPILE, &errstr);
+    if (extra == NULL) {
+	return NULL;
+    }
+    if (!(extra->flags & PCRE_EXTRA_EXECUTABLE_JIT)) {
+	erts_pcre_free_study(extra);
+	return NULL;
+    }
+    erts_pcre_assign_jit_stack(extra, &get_jit_stack, NULL);
+    mbp = erts_create_magic_binary(sizeof(JitCode), cleanup_jit_code_bin);
+    jc = ERTS_MAGIC_BIN_DATA(mbp);
+    jc->code = code;
+    jc->extra = extra;
+    return mbp;
+}
+
+/*
+ * The sixth element of a compiled pattern is a magic binary when
+ * compiled with the jit option. It is an empty binary if the pattern
+ * has been through the external format, and then the interpreter is used.
+ */
+static JitCode *get_jit_code(Eterm *tp)
+{
+    Binary *mbp;
+
+    if (arityval(*tp) < 6 || !ERTS_TERM_IS_MAGIC_BINARY(tp[6])) {
+	return NULL;
+    }
+    mbp = ((ProcBin *) binary_val(tp[6]))->val;
+    if (ERTS_MAGIC_BIN_DESTRUCTOR(mbp) != cleanup_jit_code_bin) {
+	return NULL;
+    }
+    return ERTS_MAGIC_BIN_DATA(mbp);
+}
+
+#define IS_RE_PATTERN(T)						\
+    (is_tuple(T) && (arityval(*tuple_val(T)) == 5 ||			\
+		     (arityval(*tuple_val(T)) == 6 &&			\
+		      is_binary(tuple_val(T)[6]))))
+
 /*
  * Deal with plain int's and so on for the library interface
  */
@@ -184,6 +284,7 @@ static Eterm make_signed_integer(int x, Process *p)
 #define PARSE_FLAG_REPORT_ERRORS 64
 #define PARSE_FLAG_MATCH_LIMIT 128
 #define PARSE_FLAG_MATCH_LIMIT_RECURSION 256
+#define PARSE_FLAG_JIT 512
 
 #define CAPSPEC_VALUES 0
 #define CAPSPEC_TYPE 1
@@ -390,6 +491,9 @@ parse_options(Eterm listp, /* in */
 		case am_global:
 		    fl |= (PARSE_FLAG_UNIQUE_EXEC_OPT | PARSE_FLAG_GLOBAL);
 		    break;
+		case am_jit:
+		    fl |= (PARSE_FLAG_UNIQUE_COMPILE_OPT | PARSE_FLAG_JIT);
+		    break;
 		case am_bsr_anycrlf: 
 		    eopt |= PCRE_BSR_ANYCRLF; 
 		    copt |= PCRE_BSR_ANYCRLF; 
@@ -424,10 +528,11 @@ parse_options(Eterm listp, /* in */
  */
 
 static Eterm 
-build_compile_result(Process *p, Eterm error_tag, pcre *result, int errcode, const char *errstr, int errofset, int unicode, int with_ok, Eterm extra_err_tag) 
+build_compile_result(Process *p, Eterm error_tag, pcre *result, int errcode, const char *errstr, int errofset, int unicode, int with_ok, Eterm extra_err_tag, int jit) 
 {
     Eterm *hp;
     Eterm ret;
+    Binary *jit_mbp;
     size_t pattern_size;
     int capture_count;
     int use_crlf;
@@ -462,11 +567,20 @@ build_compile_result(Process *p, Eterm error_tag, pcre *result, int errcode, con
 	/* XXX: Optimize - keep in offheap binary to allow this to 
 	   be kept across traps w/o need of copying */
 	ret = new_binary(p, (byte *) result, pattern_size);
-	erts_pcre_free(result);
-	hp = HAlloc(p, (with_ok) ? (3+6) : 6);
-	ret = TUPLE5(hp,am_re_pattern, make_small(capture_count), make_small(unicode),make_small(use_crlf),ret);
-	if (with_ok) {
+	jit_mbp = jit ? make_jit_code(result) : NULL;
+	if (jit_mbp == NULL) {
+	    erts_pcre_free(result);
+	    hp = HAlloc(p, (with_ok) ? (3+6) : 6);
+	    ret = TUPLE5(hp,am_re_pattern, make_small(capture_count), make_small(unicode),make_small(use_crlf),ret);
 	    hp += 6;
+	} else {
+	    Eterm jit_bin;
+	    hp = HAlloc(p, PROC_BIN_SIZE + ((with_ok) ? (3+7) : 7));
+	    jit_bin = erts_mk_magic_binary_term(&hp, &MSO(p), jit_mbp);
+	    ret = TUPLE6(hp,am_re_pattern, make_small(capture_count), make_small(unicode),make_small(use_crlf),ret,jit_bin);
+	    hp += 7;
+	}
+	if (with_ok) {
 	    ret = TUPLE2(hp,am_ok,ret);
 	}	    
     }
@@ -526,7 +640,8 @@ re_compile(Process* p, Eterm arg1, Eterm arg2)
 			   &errstr, &errofset, default_table);
 
     ret = build_compile_result(p, am_error, result, errcode,
-			       errstr, errofset, unicode, 1, NIL);
+			       errstr, errofset, unicode, 1, NIL,
+			       pflags & PARSE_FLAG_JIT);
     erts_free(ERTS_ALC_T_RE_TMP_BUF, expr);
     BIF_RET(ret);
 }
@@ -1083,6 +1198,7 @@ re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3)
     int is_list_cap;
     int match_limit = 0;
     int match_limit_recursion = 0;
+    JitCode *jit = NULL;
 
     if (parse_options(arg3,&comp_options,&options,&pflags,&startoffset,capture,
 		      &match_limit,&match_limit_recursion)
@@ -1092,7 +1208,7 @@ re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3)
     is_list_cap = ((pflags & PARSE_FLAG_CAPTURE_OPT) && 
 		   (capture[CAPSPEC_TYPE] == am_list));
 
-    if (is_not_tuple(arg2) || (arityval(*tuple_val(arg2)) != 5)) {
+    if (!IS_RE_PATTERN(arg2)) {
 	if (is_binary(arg2) || is_list(arg2) || is_nil(arg2)) {
 	    /* Compile from textual RE */
 	    ErlDrvSizeT slen;
@@ -1136,7 +1252,7 @@ re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3)
 					       errstr, errofset, 
 					       (pflags & 
 						PARSE_FLAG_UNICODE) ? 1 : 0, 
-					       1, am_compile);
+					       1, am_compile, 0);
 		    erts_free(ERTS_ALC_T_RE_TMP_BUF, expr);
 		    BIF_RET(res);
 		} else {
@@ -1151,7 +1267,7 @@ re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3)
 					 errstr, errofset, 
 					 (pflags & 
 					  PARSE_FLAG_UNICODE) ? 1 : 0,
-					 0, NIL);
+					 0, NIL, pflags & PARSE_FLAG_JIT);
 		Eterm *hp,r;
 		erts_free(ERTS_ALC_T_RE_TMP_BUF, expr);
 		hp = HAlloc(p,4);
@@ -1212,6 +1328,11 @@ re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3)
 	memcpy(restart.code, code_tmp, code_size);
 	erts_free_aligned_binary_bytes(temp_alloc);
 
+	if (!(options & ~JIT_EXEC_OPTS) &&
+	    !(pflags & (PARSE_FLAG_MATCH_LIMIT |
+			PARSE_FLAG_MATCH_LIMIT_RECURSION))) {
+	    jit = get_jit_code(tp);
+	}
     }
 
 
@@ -1299,6 +1420,29 @@ handle_iolist:
 	restart.flags |= RESTART_FLAG_REPORT_MATCH_LIMIT;
     }
 
+    if (jit != NULL && (Uint) (slength - startoffset) <=
+	restart.extra.loop_limit * JIT_BYTES_PER_LOOP) {
+	/* Small enough to run to completion as machine code, match_limit
+	   is set so that pathological backtracking still ends up in the
+	   interpreter below, which can yield */
+	erts_pcre_extra jit_extra = *jit->extra;
+
+	jit_extra.flags = PCRE_EXTRA_EXECUTABLE_JIT | PCRE_EXTRA_MATCH_LIMIT;
+	jit_extra.match_limit = restart.extra.loop_limit;
+	rc = erts_pcre_exec(jit->code, &jit_extra, restart.subject,
+			    slength, startoffset,
+			    options, restart.ovector, ovsize);
+	if (rc != PCRE_ERROR_JIT_STACKLIMIT && rc != PCRE_ERROR_MATCHLIMIT) {
+	    BUMP_REDS(p, 1 + (slength - startoffset) /
+		      (LOOP_FACTOR * JIT_BYTES_PER_LOOP));
+	    res = build_exec_return(p, rc, &restart, arg1);
+	    cleanup_restart_context(&restart);
+	    BIF_RET(res);
+	}
+	BUMP_REDS(p, restart.extra.loop_limit / LOOP_FACTOR);
+	restart.extra.loop_limit = 1;
+    }
+
 #ifdef DEBUG
     loop_count = 0xFFFFFFFF;
 #endif
@@ -1421,7 +1565,7 @@ re_inspect_2(BIF_ALIST_2)
 #endif
     
 
-    if (is_not_tuple(BIF_ARG_1) || (arityval(*tuple_val(BIF_ARG_1)) != 5)) {
+    if (!IS_RE_PATTERN(BIF_ARG_1)) {
 	goto error;
     }
     tp = tuple_val(BIF_ARG_1);
@@ -1430,6 +1574,11 @@ re_inspect_2(BIF_ALIST_2)
 	is_not_binary(tp[5])) {
 	goto error;
     }
+    if (BIF_ARG_2 == am_jit) {
+	hp = HAlloc(BIF_P, 3);
+	res = TUPLE2(hp, am_jit, (get_jit_code(tp) != NULL) ? am_true : am_false);
+	BIF_RET(res);
+    }
     if (BIF_ARG_2 != am_namelist) {
 	goto error;
     }
@@ -434,6 +434,25 @@ processor_order_cmp(const void *vx, const void *vy)
     return 0;
 }
 
+/*
+ * NUMA node of a logical processor according to the topology
+ * detected by the system; -1 if unknown. Called with
+ * cpuinfo_rwmtx locked.
+ */
+static int
+cpu_numa_node(int cpu_id)
+{
+    int ix;
+    for (ix = 0; ix < system_cpudata_size; ix++) {
+	if (system_cpudata[ix].logical == cpu_id) {
+	    if (system_cpudata[ix].node >= 0)
+		return system_cpudata[ix].node;
+	    return system_cpudata[ix].processor_node;
+	}
+    }
+    return -1;
+}
+
 #ifdef ERTS_SMP
 void
 erts_sched_check_cpu_bind_prep_suspend(ErtsSchedulerData *esdp)
@@ -448,6 +467,7 @@ erts_sched_check_cpu_bind_prep_suspend(ErtsSchedulerData *esdp)
     if (scheduler2cpu_map[esdp->no].bound_id >= 0
 	&& erts_unbind_from_cpu(cpuinfo) == 0) {
 	esdp->cpu_id = scheduler2cpu_map[esdp->no].bound_id = -1;
+	esdp->numa_node = -1;
     }
 
     cgcc = erts_alloc(ERTS_ALC_T_TMP,
@@ -504,8 +524,10 @@ erts_sched_check_cpu_bind(ErtsSchedulerData *esdp)
     cpu_id = scheduler2cpu_map[esdp->no].bind_id;
     if (cpu_id >= 0 && cpu_id != scheduler2cpu_map[esdp->no].bound_id) {
 	res = erts_bind_to_cpu(cpuinfo, cpu_id);
-	if (res == 0)
+	if (res == 0) {
 	    esdp->cpu_id = scheduler2cpu_map[esdp->no].bound_id = cpu_id;
+	    esdp->numa_node = cpu_numa_node(cpu_id);
+	}
 	else {
 	    erts_dsprintf_buf_t *dsbufp = erts_create_logger_dsbuf();
 	    erts_dsprintf(dsbufp, "Scheduler %d failed to bind to cpu %d: %s\n",
@@ -519,8 +541,10 @@ erts_sched_check_cpu_bind(ErtsSchedulerData *esdp)
     unbind:
 	/* Get rid of old binding */
 	res = erts_unbind_from_cpu(cpuinfo);
-	if (res == 0)
+	if (res == 0) {
 	    esdp->cpu_id = scheduler2cpu_map[esdp->no].bound_id = -1;
+	    esdp->numa_node = -1;
+	}
 	else if (res != -ENOTSUP) {
 	    erts_dsprintf_buf_t *dsbufp = erts_create_logger_dsbuf();
 	    erts_dsprintf(dsbufp, "Scheduler %d failed to unbind from cpu %d: %s\n",
@@ -176,6 +176,7 @@ typedef enum {
 
 extern DbTableMethod db_hash;
 extern DbTableMethod db_tree;
+extern DbTableMethod db_catree;
 
 int user_requested_db_max_tabs;
 int erts_ets_realloc_always_moves;
@@ -225,10 +226,49 @@ Export ets_select_continue_exp;
  */
 static Export ets_delete_continue_exp;
 	
+DbTableCounters *erts_db_create_counters(void)
+{
+    int i, nshards = erts_no_schedulers + 1;
+    Uint hdr_size = ERTS_ALC_CACHE_LINE_ALIGN_SIZE(sizeof(DbTableCounters));
+    Uint size = (hdr_size + nshards * sizeof(DbTableCounterShard)
+		 + ERTS_CACHE_LINE_SIZE);
+    DbTableCounters *counters = erts_db_alloc_nt(ERTS_ALC_T_DB_COUNTERS, size);
+    UWord shards = (UWord) counters + hdr_size;
+    if (shards & ERTS_CACHE_LINE_MASK)
+	shards = (shards & ~ERTS_CACHE_LINE_MASK) + ERTS_CACHE_LINE_SIZE;
+    ERTS_ETS_MISC_MEM_ADD(size);
+    counters->shard = (DbTableCounterShard *) shards;
+    counters->nshards = nshards;
+    counters->alloc_size = size;
+    for (i = 0; i < nshards; i++) {
+	erts_smp_atomic_init_nob(&counters->shard[i].c.nitems, 0);
+	erts_smp_atomic_init_nob(&counters->shard[i].c.memory_size, 0);
+	erts_smp_atomic_init_nob(&counters->shard[i].c.nupdates, 0);
+    }
+    return counters;
+}
+
+/* Folds the shards into the ordinary counters and frees them.
+ * No one else may access the table. */
+void erts_db_destroy_counters(DbTableCommon *tb)
+{
+    DbTableCounters *counters = tb->counters;
+    Uint size;
+    if (!counters)
+	return;
+    erts_smp_atomic_set_nob(&tb->nitems, erts_db_read_nitems(tb));
+    erts_smp_atomic_set_nob(&tb->memory_size, erts_db_read_memory_size(tb));
+    tb->counters = NULL;
+    size = counters->alloc_size;
+    erts_db_free_nt(ERTS_ALC_T_DB_COUNTERS, counters, size);
+    ERTS_ETS_MISC_MEM_ADD(-size);
+}
+
 static void
 free_dbtable(void *vtb)
 {
     DbTable *tb = (DbTable *) vtb;
+    erts_db_destroy_counters(&tb->common);
 #ifdef HARDDEBUG
 	if (erts_smp_atomic_read_nob(&tb->common.memory_size) != sizeof(DbTable)) {
 	    erts_fprintf(stderr, "ets: free_dbtable memory remain=%ld fix=%x\n",
@@ -798,7 +838,8 @@ BIF_RETTYPE ets_update_element_3(BIF_ALIST_3)
 	BIF_ERROR(BIF_P, BADARG);
     }
     UseTmpHeap(2,BIF_P);
-    if (!(tb->common.status & (DB_SET | DB_ORDERED_SET))) {
+    if (!(tb->common.status & (DB_SET | DB_ORDERED_SET))
+	|| tb->common.literal) {
 	goto bail_out;
     }
     if (is_tuple(BIF_ARG_3)) {
@@ -891,7 +932,8 @@ do_update_counter(Process *p, Eterm arg1, Eterm arg2, Eterm arg3, Eterm arg4)
 
     UseTmpHeap(5, p);
 
-    if (!(tb->common.status & (DB_SET | DB_ORDERED_SET))) {
+    if (!(tb->common.status & (DB_SET | DB_ORDERED_SET))
+	|| tb->common.literal) {
 	goto bail_out;
     }
     if (is_integer(arg3)) { /* Incr */
@@ -1332,9 +1374,9 @@ BIF_RETTYPE ets_new_2(BIF_ALIST_2)
     UWord heir_data;
     Uint32 status;
     Sint keypos;
-    int is_named, is_compressed;
+    int is_named, is_compressed, is_literal;
 #ifdef ERTS_SMP
-    int is_fine_locked, frequent_read;
+    int is_fine_locked, frequent_read, is_decentralized_counters;
 #endif
 #ifdef DEBUG
     int cret;
@@ -1356,10 +1398,12 @@ BIF_RETTYPE ets_new_2(BIF_ALIST_2)
 #ifdef ERTS_SMP
     is_fine_locked = 0;
     frequent_read = 0;
+    is_decentralized_counters = 0;
 #endif
     heir = am_none;
     heir_data = (UWord) am_undefined;
     is_compressed = erts_ets_always_compress;
+    is_literal = 0;
 
     list = BIF_ARG_2;
     while(is_list(list)) {
@@ -1409,6 +1453,19 @@ BIF_RETTYPE ets_new_2(BIF_ALIST_2)
 		    }
 #endif
 		    
+		}
+		else if (tp[1] == am_decentralized_counters) {
+#ifdef ERTS_SMP
+		    if (tp[2] == am_true) {
+			is_decentralized_counters = 1;
+		    } else if (tp[2] == am_false) {
+			is_decentralized_counters = 0;
+		    } else break;
+#else
+		    if ((tp[2] != am_true) &&  (tp[2] != am_false)) {
+			break;
+		    }
+#endif
 		}
 		else if (tp[1] == am_heir && tp[2] == am_none) {
 		    heir = am_none;
@@ -1437,6 +1494,9 @@ BIF_RETTYPE ets_new_2(BIF_ALIST_2)
 	else if (val == am_compressed) {
 	    is_compressed = 1;
 	}
+	else if (val == am_literal_objects) {
+	    is_literal = 1;
+	}
 	else if (val == am_set || val == am_protected)
 	    ;
 	else break;
@@ -1456,6 +1516,12 @@ BIF_RETTYPE ets_new_2(BIF_ALIST_2)
     }
     else if (IS_TREE_TABLE(status)) {
 	meth = &db_tree;
+#ifdef ERTS_SMP
+	if (is_fine_locked && !(status & DB_PRIVATE)) {
+	    meth = &db_catree;
+	    status |= DB_CA_ORDERED_SET | DB_FINE_LOCKED;
+	}
+#endif
     }
     else {
 	BIF_ERROR(BIF_P, BADARG);
@@ -1474,11 +1540,19 @@ BIF_RETTYPE ets_new_2(BIF_ALIST_2)
         DbTable init_tb;
 
 	erts_smp_atomic_init_nob(&init_tb.common.memory_size, 0);
+	init_tb.common.counters = NULL;
 	tb = (DbTable*) erts_db_alloc(ERTS_ALC_T_DB_TABLE,
 				      &init_tb, sizeof(DbTable));
 	erts_smp_atomic_init_nob(&tb->common.memory_size,
 				 erts_smp_atomic_read_nob(&init_tb.common.memory_size));
     }
+    tb->common.counters = NULL;
+#ifdef ERTS_SMP
+    if (is_decentralized_counters && (status & DB_FINE_LOCKED)
+	&& IS_HASH_TABLE(status)) {
+	tb->common.counters = erts_db_create_counters();
+    }
+#endif
 
     tb->common.meth = meth;
     tb->common.the_name = BIF_ARG_1;
@@ -1498,6 +1572,13 @@ BIF_RETTYPE ets_new_2(BIF_ALIST_2)
 
     tb->common.fixations = NULL;
     tb->common.compress = is_compressed;
+#ifdef ERTS_HAVE_IS_IN_LITERAL_RANGE
+    tb->common.literal = (is_literal && !is_compressed
+			  && IS_HASH_TABLE(status));
+#else
+    (void) is_literal;
+    tb->common.literal = 0;
+#endif
 
 #ifdef DEBUG
     cret = 
@@ -2061,7 +2142,7 @@ BIF_RETTYPE ets_select_delete_2(BIF_ALIST_2)
 	if ((tb = db_get_table(BIF_P, BIF_ARG_1, DB_WRITE, LCK_WRITE)) == NULL) {
 	    BIF_ERROR(BIF_P, BADARG);
 	}
-	nitems = erts_smp_atomic_read_nob(&tb->common.nitems);
+	nitems = erts_db_read_nitems(&tb->common);
 	tb->common.meth->db_delete_all_objects(BIF_P, tb);
 	db_unlock(tb, LCK_WRITE);
 	BIF_RET(erts_make_integer(nitems,BIF_P));
@@ -2689,7 +2770,8 @@ BIF_RETTYPE ets_info_1(BIF_ALIST_1)
     static Eterm fields[] = {am_protection, am_keypos, am_type, am_named_table,
                              am_node, am_size, am_name, am_heir, am_owner, am_memory, am_compressed,
                              am_write_concurrency,
-                             am_read_concurrency};
+                             am_read_concurrency,
+                             am_decentralized_counters};
     Eterm results[sizeof(fields)/sizeof(Eterm)];
     DbTable* tb;
     Eterm res;
@@ -2964,16 +3046,19 @@ void init_db(ErtsDbSpinCount db_spin_count)
 
     db_initialize_hash();
     db_initialize_tree();
+    db_initialize_catree();
 
     /*TT*/
     /* Create meta table invertion. */
     erts_smp_atomic_init_nob(&init_tb.common.memory_size, 0);
+    init_tb.common.counters = NULL;
     meta_pid_to_tab = (DbTable*) erts_db_alloc(ERTS_ALC_T_DB_TABLE,
 					       &init_tb,
 					       sizeof(DbTable));
     erts_smp_atomic_init_nob(&meta_pid_to_tab->common.memory_size,
 			     erts_smp_atomic_read_nob(&init_tb.common.memory_size));
 
+    meta_pid_to_tab->common.counters = NULL;
     meta_pid_to_tab->common.id = NIL;
     meta_pid_to_tab->common.the_name = am_true;
     meta_pid_to_tab->common.status = (DB_NORMAL | DB_BAG | DB_PUBLIC | DB_FINE_LOCKED);
@@ -2989,6 +3074,7 @@ void init_db(ErtsDbSpinCount db_spin_count)
     meta_pid_to_tab->common.slot   = -1;
     meta_pid_to_tab->common.meth   = &db_hash;
     meta_pid_to_tab->common.compress = 0;
+    meta_pid_to_tab->common.literal = 0;
 
     erts_refc_init(&meta_pid_to_tab->common.ref, 0);
     /* Neither rwlock or fixlock used
@@ -3005,6 +3091,7 @@ void init_db(ErtsDbSpinCount db_spin_count)
     erts_smp_atomic_init_nob(&meta_pid_to_fixed_tab->common.memory_size,
 			     erts_smp_atomic_read_nob(&init_tb.common.memory_size));
 
+    meta_pid_to_fixed_tab->common.counters = NULL;
     meta_pid_to_fixed_tab->common.id = NIL;
     meta_pid_to_fixed_tab->common.the_name = am_true;
     meta_pid_to_fixed_tab->common.status = (DB_NORMAL | DB_BAG | DB_PUBLIC | DB_FINE_LOCKED);
@@ -3020,6 +3107,7 @@ void init_db(ErtsDbSpinCount db_spin_count)
     meta_pid_to_fixed_tab->common.slot   = -1;
     meta_pid_to_fixed_tab->common.meth   = &db_hash;
     meta_pid_to_fixed_tab->common.compress = 0;
+    meta_pid_to_fixed_tab->common.literal = 0;
 
     erts_refc_init(&meta_pid_to_fixed_tab->common.ref, 0);
     /* Neither rwlock or fixlock used
@@ -3725,7 +3813,7 @@ static Eterm table_info(Process* p, DbTable* tb, Eterm What)
     int use_monotonic;
 
     if (What == am_size) {
-	ret = make_small(erts_smp_atomic_read_nob(&tb->common.nitems));
+	ret = make_small(erts_db_read_nitems(&tb->common));
     } else if (What == am_type) {
 	if (tb->common.status & DB_SET)  {
 	    ret = am_set;
@@ -3738,7 +3826,7 @@ static Eterm table_info(Process* p, DbTable* tb, Eterm What)
 	    ret = am_bag;
 	}
     } else if (What == am_memory) {
-	Uint words = (Uint) ((erts_smp_atomic_read_nob(&tb->common.memory_size)
+	Uint words = (Uint) ((erts_db_read_memory_size(&tb->common)
 			      + sizeof(Uint)
 			      - 1)
 			     / sizeof(Uint));
@@ -3758,6 +3846,8 @@ static Eterm table_info(Process* p, DbTable* tb, Eterm What)
         ret = tb->common.status & DB_FINE_LOCKED ? am_true : am_false;
     } else if (What == am_read_concurrency) {
         ret = tb->common.status & DB_FREQ_READ ? am_true : am_false;
+    } else if (What == am_decentralized_counters) {
+        ret = tb->common.counters ? am_true : am_false;
     } else if (What == am_name) {
 	ret = tb->common.the_name;
     } else if (What == am_keypos) {
@@ -3878,9 +3968,9 @@ static void print_table(int to, void *to_arg, int show,  DbTable* tb)
 
     tb->common.meth->db_print(to, to_arg, show, tb);
 
-    erts_print(to, to_arg, "Objects: %d\n", (int)erts_smp_atomic_read_nob(&tb->common.nitems));
+    erts_print(to, to_arg, "Objects: %d\n", (int)erts_db_read_nitems(&tb->common));
     erts_print(to, to_arg, "Words: %bpu\n",
-	       (Uint) ((erts_smp_atomic_read_nob(&tb->common.memory_size)
+	       (Uint) ((erts_db_read_memory_size(&tb->common)
 			+ sizeof(Uint)
 			- 1)
 		       / sizeof(Uint)));
@@ -37,6 +37,7 @@
 #include "erl_db_util.h" /* Flags */
 #include "erl_db_hash.h" /* DbTableHash */
 #include "erl_db_tree.h" /* DbTableTree */
+#include "erl_db_catree.h" /* DbTableCATree */
 /*TT*/
 
 Uint erts_get_ets_misc_mem_size(void);
@@ -54,6 +55,7 @@ union db_table {
     DbTableCommon common; /* Any type of db table */
     DbTableHash hash;     /* Linear hash array specific data */
     DbTableTree tree;     /* AVL tree specific data */
+    DbTableCATree catree; /* CA tree specific data */
     DbTableRelease release;
     /*TT*/
 };
@@ -110,12 +112,118 @@ do {									\
     erts_aint_t sz__ = (((erts_aint_t) (ALLOC_SZ))			\
 			- ((erts_aint_t) (FREE_SZ)));			\
     ASSERT((TAB));							\
-    erts_smp_atomic_add_nob(&(TAB)->common.memory_size, sz__);		\
+    if ((TAB)->common.counters)						\
+	erts_smp_atomic_add_nob(					\
+	    &erts_db_counter_shard(&(TAB)->common)->c.memory_size, sz__); \
+    else								\
+	erts_smp_atomic_add_nob(&(TAB)->common.memory_size, sz__);	\
 } while (0)
 
 #define ERTS_ETS_MISC_MEM_ADD(SZ) \
   erts_smp_atomic_add_nob(&erts_ets_misc_mem_size, (SZ));
 
+/*
+ * Item and memory counters of a table. With decentralized_counters
+ * updates only touch the shard of the current scheduler and reads sum
+ * up all shards.
+ */
+
+/* Only every ERTS_DB_COUNTERS_CHECK_INTERVAL:th update of a shard
+ * makes erts_db_nitems_check_due() say that it is time to read the
+ * (expensive) sum and reconsider the size of the table. */
+#define ERTS_DB_COUNTERS_CHECK_INTERVAL 64
+
+DbTableCounters *erts_db_create_counters(void);
+void erts_db_destroy_counters(DbTableCommon *tb);
+
+ERTS_GLB_INLINE DbTableCounterShard *erts_db_counter_shard(DbTableCommon *tb);
+ERTS_GLB_INLINE void erts_db_add_nitems(DbTableCommon *tb, erts_aint_t n);
+ERTS_GLB_INLINE erts_aint_t erts_db_read_nitems(DbTableCommon *tb);
+ERTS_GLB_INLINE void erts_db_reset_nitems(DbTableCommon *tb);
+ERTS_GLB_INLINE int erts_db_nitems_check_due(DbTableCommon *tb);
+ERTS_GLB_INLINE erts_aint_t erts_db_read_memory_size(DbTableCommon *tb);
+
+#if ERTS_GLB_INLINE_INCL_FUNC_DEF
+
+ERTS_GLB_INLINE DbTableCounterShard *
+erts_db_counter_shard(DbTableCommon *tb)
+{
+    Uint ix = erts_get_scheduler_id();
+    if (ix == 0) {
+	/* Dirty schedulers and other threads are spread over all
+	 * shards by the address of their thread specific event. */
+	erts_tse_t *tse = erts_tse_fetch();
+	UWord h = (UWord) tse / sizeof(void *);
+	erts_tse_return(tse);
+	h ^= h >> 7;
+	ix = (Uint) (h % tb->counters->nshards);
+    }
+    ASSERT(tb->counters && ix < tb->counters->nshards);
+    return &tb->counters->shard[ix];
+}
+
+ERTS_GLB_INLINE void
+erts_db_add_nitems(DbTableCommon *tb, erts_aint_t n)
+{
+    if (tb->counters)
+	erts_smp_atomic_add_nob(&erts_db_counter_shard(tb)->c.nitems, n);
+    else
+	erts_smp_atomic_add_nob(&tb->nitems, n);
+}
+
+ERTS_GLB_INLINE erts_aint_t
+erts_db_read_nitems(DbTableCommon *tb)
+{
+    erts_aint_t res = erts_smp_atomic_read_nob(&tb->nitems);
+    if (tb->counters) {
+	int i;
+	for (i = 0; i < tb->counters->nshards; i++)
+	    res += erts_smp_atomic_read_nob(&tb->counters->shard[i].c.nitems);
+	/* Shards are read one at a time; a delete counted in a shard
+	 * already read may precede the insert counted in a later one. */
+	if (res < 0)
+	    res = 0;
+    }
+    return res;
+}
+
+/* Requires exclusive access to the table */
+ERTS_GLB_INLINE void
+erts_db_reset_nitems(DbTableCommon *tb)
+{
+    erts_smp_atomic_set_nob(&tb->nitems, 0);
+    if (tb->counters) {
+	int i;
+	for (i = 0; i < tb->counters->nshards; i++)
+	    erts_smp_atomic_set_nob(&tb->counters->shard[i].c.nitems, 0);
+    }
+}
+
+ERTS_GLB_INLINE int
+erts_db_nitems_check_due(DbTableCommon *tb)
+{
+    erts_aint_t n;
+    if (!tb->counters)
+	return 1;
+    n = erts_smp_atomic_inc_read_nob(&erts_db_counter_shard(tb)->c.nupdates);
+    return (n % ERTS_DB_COUNTERS_CHECK_INTERVAL) == 0;
+}
+
+ERTS_GLB_INLINE erts_aint_t
+erts_db_read_memory_size(DbTableCommon *tb)
+{
+    erts_aint_t res = erts_smp_atomic_read_nob(&tb->memory_size);
+    if (tb->counters) {
+	int i;
+	for (i = 0; i < tb->counters->nshards; i++)
+	    res += erts_smp_atomic_read_nob(
+		&tb->counters->shard[i].c.memory_size);
+    }
+    return res;
+}
+
+#endif /* #if ERTS_GLB_INLINE_INCL_FUNC_DEF */
+
 ERTS_GLB_INLINE void *erts_db_alloc(ErtsAlcType_t type,
 				    DbTable *tab,
 				    Uint size);
@@ -241,6 +349,13 @@ ERTS_GLB_INLINE void erts_db_free_nt(ErtsAlcType_t type,
 				     void *ptr,
 				     Uint size);
 
+ERTS_GLB_INLINE void erts_db_release_literal(DbTable *tab,
+					     void *ptr,
+					     Uint size,
+					     Eterm *start,
+					     Uint words,
+					     struct erl_off_heap_header *oh);
+
 #if ERTS_GLB_INLINE_INCL_FUNC_DEF
 
 ERTS_GLB_INLINE void
@@ -265,6 +380,23 @@ erts_db_free_nt(ErtsAlcType_t type, void *ptr, Uint size)
     erts_free(type, ptr);
 }
 
+/*
+ * Free an object of a literal_objects table. Processes may still refer
+ * the object, so the memory is handed over to the code purger.
+ */
+ERTS_GLB_INLINE void
+erts_db_release_literal(DbTable *tab, void *ptr, Uint size,
+			Eterm *start, Uint words,
+			struct erl_off_heap_header *oh)
+{
+    ASSERT(ptr != 0);
+    ASSERT(size == ERTS_ALC_DBG_BLK_SZ(ptr));
+    ERTS_DB_ALC_MEM_UPDATE_(tab, size, 0);
+
+    erts_queue_release_literal_area(ERTS_ALC_T_DB_LITERAL_TERM, ptr,
+				    start, words, oh);
+}
+
 #endif /* #if ERTS_GLB_INLINE_INCL_FUNC_DEF */
 
 #undef ERTS_DB_ALC_MEM_UPDATE_
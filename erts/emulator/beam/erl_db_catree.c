@@ -0,0 +1,971 @@
+/*
+ * %CopyrightBegin%
+ *
+ * Copyright Ericsson AB 2017. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * %CopyrightEnd%
+ */
+
+/*
+** Implementation of ordered ETS tables with write_concurrency
+** as a contention adapting search tree (CA tree).
+**
+** The table consists of a routing layer of route nodes, each holding a
+** copy of a key, and leaves called base nodes. Each base node holds an
+** AVL tree (see erl_db_tree.c) and a lock. Keys smaller than the key of
+** a route node are found to the left of it, other keys to the right.
+**
+** Single key operations read lock the routing layer and lock the base
+** node that may contain the key. The base node lock records whether it
+** was contended. A base node that is often contended is split in two
+** and base nodes that are seldom contended are joined with a neighbour.
+** Both require the routing layer to be write locked, which excludes all
+** users of base nodes.
+**
+** Operations that traverse the whole table (select, slot etc.) write
+** lock the routing layer, join all base nodes into one tree and let the
+** ordinary tree implementation do the job. The table will then split
+** again if it is contended.
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "sys.h"
+#include "erl_vm.h"
+#include "global.h"
+#include "erl_process.h"
+#include "error.h"
+#define ERTS_WANT_DB_INTERNAL__
+#include "erl_db.h"
+#include "bif.h"
+#include "big.h"
+
+#include "erl_db_catree.h"
+
+extern DbTableMethod db_tree;
+
+#define NITEMS(tb) ((int)erts_smp_atomic_read_nob(&(tb)->common.nitems))
+
+/*
+ * Lock statistics are updated each time a base node lock is taken.
+ * A contended lock adds ERL_DB_CATREE_LOCK_FAILURE_CONTRIBUTION and an
+ * uncontended one adds ERL_DB_CATREE_LOCK_SUCCESS_CONTRIBUTION. The
+ * base node is split when the statistics goes above the high limit and
+ * joined with a neighbour when it goes below the low limit.
+ */
+#define ERL_DB_CATREE_LOCK_FAILURE_CONTRIBUTION 250
+#define ERL_DB_CATREE_LOCK_SUCCESS_CONTRIBUTION (-1)
+#define ERL_DB_CATREE_HIGH_CONTENTION_LIMIT 1000
+#define ERL_DB_CATREE_LOW_CONTENTION_LIMIT (-1000)
+#define ERL_DB_CATREE_MAX_ROUTE_NODE_LAYER_HEIGHT 14
+
+#define BASE_NODE_SIZE (sizeof(DbTableCATreeNode))
+#define ROUTE_NODE_SIZE(KeySize) \
+    (offsetof(DbTableCATreeNode, u.route.key.heap) + (KeySize)*sizeof(Eterm))
+
+#define GET_BASE(Node) (&(Node)->u.base)
+#define GET_ROUTE(Node) (&(Node)->u.route)
+#define GET_ROUTE_KEY(Node) ((Node)->u.route.key.term)
+
+/*
+** Forward declarations
+*/
+
+static int db_first_catree(Process *p, DbTable *tbl,
+			   Eterm *ret);
+static int db_next_catree(Process *p, DbTable *tbl,
+			  Eterm key, Eterm *ret);
+static int db_last_catree(Process *p, DbTable *tbl,
+			  Eterm *ret);
+static int db_prev_catree(Process *p, DbTable *tbl,
+			  Eterm key,
+			  Eterm *ret);
+static int db_put_catree(DbTable *tbl, Eterm obj, int key_clash_fail);
+static int db_get_catree(Process *p, DbTable *tbl,
+			 Eterm key,  Eterm *ret);
+static int db_member_catree(DbTable *tbl, Eterm key, Eterm *ret);
+static int db_get_element_catree(Process *p, DbTable *tbl,
+				 Eterm key,int ndex,
+				 Eterm *ret);
+static int db_erase_catree(DbTable *tbl, Eterm key, Eterm *ret);
+static int db_erase_object_catree(DbTable *tbl, Eterm object,Eterm *ret);
+static int db_slot_catree(Process *p, DbTable *tbl,
+			  Eterm slot_term,  Eterm *ret);
+static int db_select_catree(Process *p, DbTable *tbl,
+			    Eterm pattern, int reversed, Eterm *ret);
+static int db_select_count_catree(Process *p, DbTable *tbl,
+				  Eterm pattern,  Eterm *ret);
+static int db_select_chunk_catree(Process *p, DbTable *tbl,
+				  Eterm pattern, Sint chunk_size,
+				  int reversed, Eterm *ret);
+static int db_select_continue_catree(Process *p, DbTable *tbl,
+				     Eterm continuation, Eterm *ret);
+static int db_select_count_continue_catree(Process *p, DbTable *tbl,
+					   Eterm continuation, Eterm *ret);
+static int db_select_delete_catree(Process *p, DbTable *tbl,
+				   Eterm pattern,  Eterm *ret);
+static int db_select_delete_continue_catree(Process *p, DbTable *tbl,
+					    Eterm continuation, Eterm *ret);
+static int db_take_catree(Process *, DbTable *, Eterm, Eterm *);
+static void db_print_catree(int to, void *to_arg,
+			    int show, DbTable *tbl);
+static int db_free_table_catree(DbTable *tbl);
+static int db_free_table_continue_catree(DbTable *tbl);
+static void db_foreach_offheap_catree(DbTable *,
+				      void (*)(ErlOffHeap *, void *),
+				      void *);
+static int db_delete_all_objects_catree(Process* p, DbTable* tbl);
+static int
+db_lookup_dbterm_catree(Process *, DbTable *, Eterm key, Eterm obj,
+			DbUpdateHandle*);
+static void
+db_finalize_dbterm_catree(int cret, DbUpdateHandle *);
+
+/*
+** External interface
+*/
+DbTableMethod db_catree =
+{
+    db_create_catree,
+    db_first_catree,
+    db_next_catree,
+    db_last_catree,
+    db_prev_catree,
+    db_put_catree,
+    db_get_catree,
+    db_get_element_catree,
+    db_member_catree,
+    db_erase_catree,
+    db_erase_object_catree,
+    db_slot_catree,
+    db_select_chunk_catree,
+    db_select_catree,
+    db_select_delete_catree,
+    db_select_continue_catree,
+    db_select_delete_continue_catree,
+    db_select_count_catree,
+    db_select_count_continue_catree,
+    db_take_catree,
+    db_delete_all_objects_catree,
+    db_free_table_catree,
+    db_free_table_continue_catree,
+    db_print_catree,
+    db_foreach_offheap_catree,
+    NULL,
+    db_lookup_dbterm_catree,
+    db_finalize_dbterm_catree
+};
+
+/*
+** Functions for handling the route keys
+*/
+
+static ERTS_INLINE Uint route_key_size(Eterm key)
+{
+    return is_immed(key) ? 0 : size_object(key);
+}
+
+static ERTS_INLINE void copy_route_key(DbRouteKey *dst, Eterm key,
+				       Uint key_size)
+{
+    dst->size = key_size;
+    if (key_size != 0) {
+	Eterm *hp = &dst->heap[0];
+	ErlOffHeap tmp_offheap;
+	tmp_offheap.first = NULL;
+	dst->term = copy_struct(key, key_size, &hp, &tmp_offheap);
+	dst->oh = tmp_offheap.first;
+    }
+    else {
+	ASSERT(is_immed(key));
+	dst->term = key;
+	dst->oh = NULL;
+    }
+}
+
+static ERTS_INLINE void destroy_route_key(DbRouteKey *key)
+{
+    if (key->oh) {
+	ErlOffHeap oh;
+	oh.first = key->oh;
+	erts_cleanup_offheap(&oh);
+    }
+}
+
+/*
+** Allocation and deallocation of nodes
+*/
+
+static DbTableCATreeNode *create_base_node(DbTableCATree *tb,
+					   TreeDbTerm *root)
+{
+    DbTableCATreeNode *p;
+    p = erts_db_alloc(ERTS_ALC_T_DB_CATREE_BASE_NODE, (DbTable *) tb,
+		      BASE_NODE_SIZE);
+    p->is_base_node = 1;
+    erts_smp_mtx_init_x(&p->u.base.lock, "db_catree_base_node",
+			tb->tree.common.the_name);
+    p->u.base.lock_statistics = 0;
+    p->u.base.root = root;
+    return p;
+}
+
+static DbTableCATreeNode *create_route_node(DbTableCATree *tb,
+					    DbTableCATreeNode *left,
+					    DbTableCATreeNode *right,
+					    Eterm key)
+{
+    Uint key_size = route_key_size(key);
+    DbTableCATreeNode *p;
+    p = erts_db_alloc(ERTS_ALC_T_DB_CATREE_ROUTE_NODE, (DbTable *) tb,
+		      ROUTE_NODE_SIZE(key_size));
+    p->is_base_node = 0;
+    p->u.route.left = left;
+    p->u.route.right = right;
+    copy_route_key(&p->u.route.key, key, key_size);
+    return p;
+}
+
+static void free_base_node(DbTableCATree *tb, DbTableCATreeNode *p)
+{
+    ASSERT(p->is_base_node);
+    erts_smp_mtx_destroy(&p->u.base.lock);
+    erts_db_free(ERTS_ALC_T_DB_CATREE_BASE_NODE, (DbTable *) tb,
+		 p, BASE_NODE_SIZE);
+}
+
+static void free_route_node(DbTableCATree *tb, DbTableCATreeNode *p)
+{
+    ASSERT(!p->is_base_node);
+    destroy_route_key(&p->u.route.key);
+    erts_db_free(ERTS_ALC_T_DB_CATREE_ROUTE_NODE, (DbTable *) tb,
+		 p, ROUTE_NODE_SIZE(p->u.route.key.size));
+}
+
+/*
+** Locking of base nodes
+*/
+
+static ERTS_INLINE void lock_base_node(DbTableCATreeNode *base_node)
+{
+    DbTableCATreeBaseNode *p = GET_BASE(base_node);
+#ifdef ERTS_SMP
+    if (erts_smp_mtx_trylock(&p->lock) == EBUSY) {
+	erts_smp_mtx_lock(&p->lock);
+	p->lock_statistics += ERL_DB_CATREE_LOCK_FAILURE_CONTRIBUTION;
+    }
+    else
+#endif
+    {
+	p->lock_statistics += ERL_DB_CATREE_LOCK_SUCCESS_CONTRIBUTION;
+    }
+}
+
+static ERTS_INLINE void unlock_base_node(DbTableCATreeNode *base_node)
+{
+    erts_smp_mtx_unlock(&GET_BASE(base_node)->lock);
+}
+
+static ERTS_INLINE int base_node_needs_adaptation(DbTableCATreeNode *base_node)
+{
+    Sint stat = GET_BASE(base_node)->lock_statistics;
+    return (stat > ERL_DB_CATREE_HIGH_CONTENTION_LIMIT
+	    || stat < ERL_DB_CATREE_LOW_CONTENTION_LIMIT);
+}
+
+/*
+** Search in the routing layer
+*/
+
+static ERTS_INLINE DbTableCATreeNode *find_base_node(DbTableCATree *tb,
+						     Eterm key)
+{
+    DbTableCATreeNode *node = tb->root;
+    while (!node->is_base_node) {
+	if (CMP(key, GET_ROUTE_KEY(node)) < 0) {
+	    node = GET_ROUTE(node)->left;
+	} else {
+	    node = GET_ROUTE(node)->right;
+	}
+    }
+    return node;
+}
+
+/* Read locks the routing layer and returns the locked base node
+ * that may contain key. Released with release_base_node(). */
+static ERTS_INLINE DbTableCATreeNode *acquire_base_node(DbTableCATree *tb,
+							Eterm key)
+{
+    DbTableCATreeNode *base_node;
+    erts_smp_rwmtx_rlock(&tb->route_lock);
+    base_node = find_base_node(tb, key);
+    lock_base_node(base_node);
+    return base_node;
+}
+
+/*
+** Adaptation of the routing layer. Called with the routing layer
+** write locked, which means that no base node lock is held by anyone.
+*/
+
+static void split_base_node(DbTableCATree *tb,
+			    DbTableCATreeNode **base_node_ptr,
+			    int depth)
+{
+    DbTableCATreeNode *base_node = *base_node_ptr;
+    TreeDbTerm *root = GET_BASE(base_node)->root;
+    TreeDbTerm *left_tree, *right_tree, *split_node;
+    DbTableCATreeNode *left_base;
+
+    GET_BASE(base_node)->lock_statistics = 0;
+    if (depth >= ERL_DB_CATREE_MAX_ROUTE_NODE_LAYER_HEIGHT
+	|| root == NULL || root->left == NULL) {
+	return; /* Too deep or too few elements to split */
+    }
+    split_node = db_split_tree(root, &left_tree, &right_tree);
+    left_base = create_base_node(tb, left_tree);
+    GET_BASE(base_node)->root = right_tree;
+    *base_node_ptr = create_route_node(tb, left_base, base_node,
+				       GETKEY(tb, split_node->dbterm.tpl));
+}
+
+static void join_base_node(DbTableCATree *tb,
+			   DbTableCATreeNode **parent_ptr,
+			   DbTableCATreeNode *base_node)
+{
+    DbTableCATreeNode *parent = *parent_ptr;
+    DbTableCATreeNode *neighbour;
+
+    if (GET_ROUTE(parent)->left == base_node) {
+	/* Join with the leftmost base node of the right subtree */
+	neighbour = GET_ROUTE(parent)->right;
+	while (!neighbour->is_base_node)
+	    neighbour = GET_ROUTE(neighbour)->left;
+	GET_BASE(neighbour)->root =
+	    db_join_trees(GET_BASE(base_node)->root,
+			  GET_BASE(neighbour)->root);
+	*parent_ptr = GET_ROUTE(parent)->right;
+    } else {
+	/* Join with the rightmost base node of the left subtree */
+	ASSERT(GET_ROUTE(parent)->right == base_node);
+	neighbour = GET_ROUTE(parent)->left;
+	while (!neighbour->is_base_node)
+	    neighbour = GET_ROUTE(neighbour)->right;
+	GET_BASE(neighbour)->root =
+	    db_join_trees(GET_BASE(neighbour)->root,
+			  GET_BASE(base_node)->root);
+	*parent_ptr = GET_ROUTE(parent)->left;
+    }
+    GET_BASE(neighbour)->lock_statistics = 0;
+    free_route_node(tb, parent);
+    free_base_node(tb, base_node);
+}
+
+static void adapt_base_node(DbTableCATree *tb, Eterm key)
+{
+    DbTableCATreeNode **parent_ptr = NULL;
+    DbTableCATreeNode **node_ptr = &tb->root;
+    DbTableCATreeNode *base_node;
+    int depth = 0;
+
+    erts_smp_rwmtx_rwlock(&tb->route_lock);
+    while (!(*node_ptr)->is_base_node) {
+	parent_ptr = node_ptr;
+	if (CMP(key, GET_ROUTE_KEY(*node_ptr)) < 0) {
+	    node_ptr = &GET_ROUTE(*node_ptr)->left;
+	} else {
+	    node_ptr = &GET_ROUTE(*node_ptr)->right;
+	}
+	depth++;
+    }
+    base_node = *node_ptr;
+    /* The node may have been adapted by someone else in the meantime */
+    if (GET_BASE(base_node)->lock_statistics
+	> ERL_DB_CATREE_HIGH_CONTENTION_LIMIT) {
+	split_base_node(tb, node_ptr, depth);
+    } else if (GET_BASE(base_node)->lock_statistics
+	       < ERL_DB_CATREE_LOW_CONTENTION_LIMIT) {
+	if (parent_ptr == NULL)
+	    GET_BASE(base_node)->lock_statistics = 0;
+	else
+	    join_base_node(tb, parent_ptr, base_node);
+    }
+    erts_smp_rwmtx_rwunlock(&tb->route_lock);
+}
+
+/* Releases a base node acquired with acquire_base_node() and adapts the
+ * routing layer if the contention of the base node calls for it. */
+static ERTS_INLINE void release_base_node(DbTableCATree *tb,
+					  DbTableCATreeNode *base_node,
+					  Eterm key)
+{
+    int adapt = base_node_needs_adaptation(base_node);
+    if (adapt && GET_BASE(base_node)->lock_statistics < 0
+	&& tb->root == base_node) {
+	/* Nothing to join with */
+	GET_BASE(base_node)->lock_statistics = 0;
+	adapt = 0;
+    }
+    unlock_base_node(base_node);
+    erts_smp_rwmtx_runlock(&tb->route_lock);
+    if (adapt)
+	adapt_base_node(tb, key);
+}
+
+/*
+** Operations on the whole table. The routing layer is write locked and
+** all base nodes are joined into tb->tree.root, making the table look
+** like an ordinary tree table to the functions in erl_db_tree.c.
+*/
+
+static TreeDbTerm *join_all(DbTableCATree *tb, DbTableCATreeNode *node)
+{
+    TreeDbTerm *res;
+    if (node->is_base_node) {
+	res = GET_BASE(node)->root;
+	free_base_node(tb, node);
+    } else {
+	TreeDbTerm *left = join_all(tb, GET_ROUTE(node)->left);
+	TreeDbTerm *right = join_all(tb, GET_ROUTE(node)->right);
+	free_route_node(tb, node);
+	res = db_join_trees(left, right);
+    }
+    return res;
+}
+
+static void join_all_base_nodes(DbTableCATree *tb)
+{
+    if (!tb->root->is_base_node) {
+	TreeDbTerm *root = join_all(tb, tb->root);
+	tb->root = create_base_node(tb, root);
+    }
+}
+
+static void lock_as_tree(DbTableCATree *tb)
+{
+    erts_smp_rwmtx_rwlock(&tb->route_lock);
+    join_all_base_nodes(tb);
+    tb->tree.root = GET_BASE(tb->root)->root;
+    /* The tree may have changed since the static stack was used */
+    tb->tree.static_stack.pos = 0;
+    tb->tree.static_stack.slot = 0;
+}
+
+static void unlock_as_tree(DbTableCATree *tb)
+{
+    GET_BASE(tb->root)->root = tb->tree.root;
+    tb->tree.root = NULL;
+    erts_smp_rwmtx_rwunlock(&tb->route_lock);
+}
+
+/*
+** Table interface routines ie what's called by the bif's
+*/
+
+void db_initialize_catree(void)
+{
+    return;
+};
+
+int db_create_catree(Process *p, DbTable *tbl)
+{
+    DbTableCATree *tb = &tbl->catree;
+#ifdef ERTS_SMP
+    erts_smp_rwmtx_opt_t rwmtx_opt = ERTS_SMP_RWMTX_OPT_DEFAULT_INITER;
+    rwmtx_opt.type = ERTS_SMP_RWMTX_TYPE_FREQUENT_READ;
+    if (erts_ets_rwmtx_spin_count >= 0)
+	rwmtx_opt.main_spincount = erts_ets_rwmtx_spin_count;
+    erts_smp_rwmtx_init_opt_x(&tb->route_lock, &rwmtx_opt,
+			      "db_catree_route", tb->tree.common.the_name);
+#endif
+    db_tree.db_create(p, tbl);
+    tb->root = create_base_node(tb, NULL);
+    return DB_ERROR_NONE;
+}
+
+/*
+ * Iteration over the base nodes in key order. The route nodes that
+ * still have base nodes to visit are kept on a stack.
+ */
+typedef struct {
+    int pos;
+    DbTableCATreeNode *array[ERL_DB_CATREE_MAX_ROUTE_NODE_LAYER_HEIGHT + 1];
+} CATreeRouteStack;
+
+static DbTableCATreeNode *leftmost_base_node(DbTableCATreeNode *node,
+					     CATreeRouteStack *stack)
+{
+    while (!node->is_base_node) {
+	stack->array[stack->pos++] = node;
+	node = GET_ROUTE(node)->left;
+    }
+    return node;
+}
+
+static DbTableCATreeNode *rightmost_base_node(DbTableCATreeNode *node,
+					      CATreeRouteStack *stack)
+{
+    while (!node->is_base_node) {
+	stack->array[stack->pos++] = node;
+	node = GET_ROUTE(node)->right;
+    }
+    return node;
+}
+
+/* Find the base node that may contain key. Route nodes with base nodes
+ * holding greater (next) or smaller (!next) keys are pushed. */
+static DbTableCATreeNode *find_base_node_with_stack(DbTableCATree *tb,
+						    Eterm key, int next,
+						    CATreeRouteStack *stack)
+{
+    DbTableCATreeNode *node = tb->root;
+    while (!node->is_base_node) {
+	if (CMP(key, GET_ROUTE_KEY(node)) < 0) {
+	    if (next)
+		stack->array[stack->pos++] = node;
+	    node = GET_ROUTE(node)->left;
+	} else {
+	    if (!next)
+		stack->array[stack->pos++] = node;
+	    node = GET_ROUTE(node)->right;
+	}
+    }
+    return node;
+}
+
+static int do_next_catree(Process *p, DbTableCATree *tb,
+			  DbTableCATreeNode *base_node,
+			  CATreeRouteStack *stack,
+			  Eterm key, Eterm *ret)
+{
+    TreeDbTerm *this;
+    for (;;) {
+	lock_base_node(base_node);
+	if (is_value(key)) {
+	    this = db_find_next_node_tree(&tb->tree.common,
+					  GET_BASE(base_node)->root, key);
+	} else {
+	    this = GET_BASE(base_node)->root;
+	    if (this != NULL)
+		while (this->left != NULL)
+		    this = this->left;
+	}
+	if (this != NULL) {
+	    *ret = db_copy_key(p, (DbTable *) tb, &this->dbterm);
+	    unlock_base_node(base_node);
+	    return DB_ERROR_NONE;
+	}
+	unlock_base_node(base_node);
+	if (stack->pos == 0) {
+	    *ret = am_EOT;
+	    return DB_ERROR_NONE;
+	}
+	base_node = leftmost_base_node(
+	    GET_ROUTE(stack->array[--stack->pos])->right, stack);
+	key = THE_NON_VALUE;
+    }
+}
+
+static int do_prev_catree(Process *p, DbTableCATree *tb,
+			  DbTableCATreeNode *base_node,
+			  CATreeRouteStack *stack,
+			  Eterm key, Eterm *ret)
+{
+    TreeDbTerm *this;
+    for (;;) {
+	lock_base_node(base_node);
+	if (is_value(key)) {
+	    this = db_find_prev_node_tree(&tb->tree.common,
+					  GET_BASE(base_node)->root, key);
+	} else {
+	    this = GET_BASE(base_node)->root;
+	    if (this != NULL)
+		while (this->right != NULL)
+		    this = this->right;
+	}
+	if (this != NULL) {
+	    *ret = db_copy_key(p, (DbTable *) tb, &this->dbterm);
+	    unlock_base_node(base_node);
+	    return DB_ERROR_NONE;
+	}
+	unlock_base_node(base_node);
+	if (stack->pos == 0) {
+	    *ret = am_EOT;
+	    return DB_ERROR_NONE;
+	}
+	base_node = rightmost_base_node(
+	    GET_ROUTE(stack->array[--stack->pos])->left, stack);
+	key = THE_NON_VALUE;
+    }
+}
+
+static int db_first_catree(Process *p, DbTable *tbl, Eterm *ret)
+{
+    DbTableCATree *tb = &tbl->catree;
+    CATreeRouteStack stack;
+    int res;
+    stack.pos = 0;
+    erts_smp_rwmtx_rlock(&tb->route_lock);
+    res = do_next_catree(p, tb, leftmost_base_node(tb->root, &stack),
+			 &stack, THE_NON_VALUE, ret);
+    erts_smp_rwmtx_runlock(&tb->route_lock);
+    return res;
+}
+
+static int db_next_catree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
+{
+    DbTableCATree *tb = &tbl->catree;
+    CATreeRouteStack stack;
+    int res;
+    if (is_atom(key) && key == am_EOT)
+	return DB_ERROR_BADKEY;
+    stack.pos = 0;
+    erts_smp_rwmtx_rlock(&tb->route_lock);
+    res = do_next_catree(p, tb, find_base_node_with_stack(tb, key, 1, &stack),
+			 &stack, key, ret);
+    erts_smp_rwmtx_runlock(&tb->route_lock);
+    return res;
+}
+
+static int db_last_catree(Process *p, DbTable *tbl, Eterm *ret)
+{
+    DbTableCATree *tb = &tbl->catree;
+    CATreeRouteStack stack;
+    int res;
+    stack.pos = 0;
+    erts_smp_rwmtx_rlock(&tb->route_lock);
+    res = do_prev_catree(p, tb, rightmost_base_node(tb->root, &stack),
+			 &stack, THE_NON_VALUE, ret);
+    erts_smp_rwmtx_runlock(&tb->route_lock);
+    return res;
+}
+
+static int db_prev_catree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
+{
+    DbTableCATree *tb = &tbl->catree;
+    CATreeRouteStack stack;
+    int res;
+    if (is_atom(key) && key == am_EOT)
+	return DB_ERROR_BADKEY;
+    stack.pos = 0;
+    erts_smp_rwmtx_rlock(&tb->route_lock);
+    res = do_prev_catree(p, tb, find_base_node_with_stack(tb, key, 0, &stack),
+			 &stack, key, ret);
+    erts_smp_rwmtx_runlock(&tb->route_lock);
+    return res;
+}
+
+static int db_put_catree(DbTable *tbl, Eterm obj, int key_clash_fail)
+{
+    DbTableCATree *tb = &tbl->catree;
+    DbTableCATreeNode *base_node;
+    Eterm key = db_getkey(tb->tree.common.keypos, obj);
+    int res;
+    if (is_non_value(key))
+	return DB_ERROR_BADITEM;
+    base_node = acquire_base_node(tb, key);
+    res = db_put_tree_common(&tb->tree.common, &GET_BASE(base_node)->root,
+			     obj, key_clash_fail, NULL);
+    release_base_node(tb, base_node, key);
+    return res;
+}
+
+static int db_get_catree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
+{
+    DbTableCATree *tb = &tbl->catree;
+    DbTableCATreeNode *base_node = acquire_base_node(tb, key);
+    int res = db_get_tree_common(p, &tb->tree.common,
+				 GET_BASE(base_node)->root, key, ret, NULL);
+    release_base_node(tb, base_node, key);
+    return res;
+}
+
+static int db_member_catree(DbTable *tbl, Eterm key, Eterm *ret)
+{
+    DbTableCATree *tb = &tbl->catree;
+    DbTableCATreeNode *base_node = acquire_base_node(tb, key);
+    int res = db_member_tree_common(&tb->tree.common,
+				    GET_BASE(base_node)->root, key, ret, NULL);
+    release_base_node(tb, base_node, key);
+    return res;
+}
+
+static int db_get_element_catree(Process *p, DbTable *tbl,
+				 Eterm key, int ndex, Eterm *ret)
+{
+    DbTableCATree *tb = &tbl->catree;
+    DbTableCATreeNode *base_node = acquire_base_node(tb, key);
+    int res = db_get_element_tree_common(p, &tb->tree.common,
+					 GET_BASE(base_node)->root,
+					 key, ndex, ret, NULL);
+    release_base_node(tb, base_node, key);
+    return res;
+}
+
+static int db_erase_catree(DbTable *tbl, Eterm key, Eterm *ret)
+{
+    DbTableCATree *tb = &tbl->catree;
+    DbTableCATreeNode *base_node = acquire_base_node(tb, key);
+    int res = db_erase_tree_common(tbl, &GET_BASE(base_node)->root,
+				   key, ret, NULL);
+    release_base_node(tb, base_node, key);
+    return res;
+}
+
+static int db_erase_object_catree(DbTable *tbl, Eterm object, Eterm *ret)
+{
+    DbTableCATree *tb = &tbl->catree;
+    DbTableCATreeNode *base_node;
+    Eterm key = db_getkey(tb->tree.common.keypos, object);
+    int res;
+    if (is_non_value(key))
+	return DB_ERROR_BADITEM;
+    base_node = acquire_base_node(tb, key);
+    res = db_erase_object_tree_common(tbl, &GET_BASE(base_node)->root,
+				      object, ret, NULL);
+    release_base_node(tb, base_node, key);
+    return res;
+}
+
+static int db_take_catree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
+{
+    DbTableCATree *tb = &tbl->catree;
+    DbTableCATreeNode *base_node = acquire_base_node(tb, key);
+    int res = db_take_tree_common(p, tbl, &GET_BASE(base_node)->root,
+				  key, ret, NULL);
+    release_base_node(tb, base_node, key);
+    return res;
+}
+
+static int db_slot_catree(Process *p, DbTable *tbl,
+			  Eterm slot_term, Eterm *ret)
+{
+    int res;
+    lock_as_tree(&tbl->catree);
+    res = db_tree.db_slot(p, tbl, slot_term, ret);
+    unlock_as_tree(&tbl->catree);
+    return res;
+}
+
+static int db_select_continue_catree(Process *p, DbTable *tbl,
+				     Eterm continuation, Eterm *ret)
+{
+    int res;
+    lock_as_tree(&tbl->catree);
+    res = db_tree.db_select_continue(p, tbl, continuation, ret);
+    unlock_as_tree(&tbl->catree);
+    return res;
+}
+
+static int db_select_catree(Process *p, DbTable *tbl,
+			    Eterm pattern, int reverse, Eterm *ret)
+{
+    int res;
+    lock_as_tree(&tbl->catree);
+    res = db_tree.db_select(p, tbl, pattern, reverse, ret);
+    unlock_as_tree(&tbl->catree);
+    return res;
+}
+
+static int db_select_count_continue_catree(Process *p, DbTable *tbl,
+					   Eterm continuation, Eterm *ret)
+{
+    int res;
+    lock_as_tree(&tbl->catree);
+    res = db_tree.db_select_count_continue(p, tbl, continuation, ret);
+    unlock_as_tree(&tbl->catree);
+    return res;
+}
+
+static int db_select_count_catree(Process *p, DbTable *tbl,
+				  Eterm pattern, Eterm *ret)
+{
+    int res;
+    lock_as_tree(&tbl->catree);
+    res = db_tree.db_select_count(p, tbl, pattern, ret);
+    unlock_as_tree(&tbl->catree);
+    return res;
+}
+
+static int db_select_chunk_catree(Process *p, DbTable *tbl,
+				  Eterm pattern, Sint chunk_size,
+				  int reversed, Eterm *ret)
+{
+    int res;
+    lock_as_tree(&tbl->catree);
+    res = db_tree.db_select_chunk(p, tbl, pattern, chunk_size,
+				  reversed, ret);
+    unlock_as_tree(&tbl->catree);
+    return res;
+}
+
+static int db_select_delete_continue_catree(Process *p, DbTable *tbl,
+					    Eterm continuation, Eterm *ret)
+{
+    int res;
+    lock_as_tree(&tbl->catree);
+    res = db_tree.db_select_delete_continue(p, tbl, continuation, ret);
+    unlock_as_tree(&tbl->catree);
+    return res;
+}
+
+static int db_select_delete_catree(Process *p, DbTable *tbl,
+				   Eterm pattern, Eterm *ret)
+{
+    int res;
+    lock_as_tree(&tbl->catree);
+    res = db_tree.db_select_delete(p, tbl, pattern, ret);
+    unlock_as_tree(&tbl->catree);
+    return res;
+}
+
+static int db_delete_all_objects_catree(Process* p, DbTable* tbl)
+{
+    int res;
+    lock_as_tree(&tbl->catree);
+    res = db_tree.db_delete_all_objects(p, tbl);
+    unlock_as_tree(&tbl->catree);
+    return res;
+}
+
+static void db_print_catree(int to, void *to_arg,
+			    int show, DbTable *tbl)
+{
+    erts_print(to, to_arg, "Ordered set (CA tree), Elements: %d\n",
+	       NITEMS(&tbl->catree.tree));
+}
+
+/* release all memory occupied by a single table */
+static int db_free_table_catree(DbTable *tbl)
+{
+    while (!db_free_table_continue_catree(tbl))
+	;
+    return 1;
+}
+
+static int db_free_table_continue_catree(DbTable *tbl)
+{
+    DbTableCATree *tb = &tbl->catree;
+    int result;
+
+    if (tb->root != NULL) {
+	/* First call, hand over all elements to the tree implementation */
+	join_all_base_nodes(tb);
+	tb->tree.root = GET_BASE(tb->root)->root;
+	free_base_node(tb, tb->root);
+	tb->root = NULL;
+    }
+    result = db_tree.db_free_table_continue(tbl);
+    if (result) {
+	erts_smp_rwmtx_destroy(&tb->route_lock);
+    }
+    return result;
+}
+
+static void do_foreach_offheap_catree(DbTableCATree *tb,
+				      DbTableCATreeNode *node,
+				      void (*func)(ErlOffHeap *, void *),
+				      void *arg)
+{
+    if (node->is_base_node) {
+	TreeDbTerm *save = tb->tree.root;
+	tb->tree.root = GET_BASE(node)->root;
+	db_tree.db_foreach_offheap((DbTable *) tb, func, arg);
+	tb->tree.root = save;
+    } else {
+	ErlOffHeap tmp_offheap;
+	do_foreach_offheap_catree(tb, GET_ROUTE(node)->left, func, arg);
+	tmp_offheap.first = GET_ROUTE(node)->key.oh;
+	tmp_offheap.overhead = 0;
+	(*func)(&tmp_offheap, arg);
+	GET_ROUTE(node)->key.oh = tmp_offheap.first;
+	do_foreach_offheap_catree(tb, GET_ROUTE(node)->right, func, arg);
+    }
+}
+
+static void db_foreach_offheap_catree(DbTable *tbl,
+				      void (*func)(ErlOffHeap *, void *),
+				      void *arg)
+{
+    DbTableCATree *tb = &tbl->catree;
+    if (tb->root == NULL) {
+	/* Being deleted, everything has been handed over to the tree */
+	db_tree.db_foreach_offheap(tbl, func, arg);
+    } else {
+	do_foreach_offheap_catree(tb, tb->root, func, arg);
+    }
+}
+
+static int
+db_lookup_dbterm_catree(Process *p, DbTable *tbl, Eterm key, Eterm obj,
+			DbUpdateHandle* handle)
+{
+    DbTableCATree *tb = &tbl->catree;
+    DbTableCATreeNode *base_node = acquire_base_node(tb, key);
+    int res = db_lookup_dbterm_tree_common(p, tbl, &GET_BASE(base_node)->root,
+					   key, obj, handle, NULL);
+    if (res == 0) {
+	release_base_node(tb, base_node, key);
+    } else {
+	/* Released in db_finalize_dbterm_catree */
+	handle->lck = base_node;
+    }
+    return res;
+}
+
+static void
+db_finalize_dbterm_catree(int cret, DbUpdateHandle *handle)
+{
+    DbTableCATree *tb = &handle->tb->catree;
+    DbTableCATreeNode *base_node = handle->lck;
+    Eterm key_copy = THE_NON_VALUE;
+    Eterm *key_heap = NULL;
+    Uint key_size = 0;
+
+    if (base_node_needs_adaptation(base_node)) {
+	/* The object, and thereby the key, may go away when finalized */
+	Eterm key = GETKEY(tb, handle->dbterm->tpl);
+	key_size = route_key_size(key);
+	if (key_size == 0) {
+	    key_copy = key;
+	} else {
+	    Eterm *hp;
+	    ErlOffHeap tmp_offheap;
+	    key_heap = erts_alloc(ERTS_ALC_T_DB_TMP, key_size * sizeof(Eterm));
+	    hp = key_heap;
+	    tmp_offheap.first = NULL;
+	    key_copy = copy_struct(key, key_size, &hp, &tmp_offheap);
+	    if (tmp_offheap.first) {
+		/* Keep it simple and do not adapt on keys with off heap data */
+		erts_cleanup_offheap(&tmp_offheap);
+		erts_free(ERTS_ALC_T_DB_TMP, key_heap);
+		key_heap = NULL;
+		key_copy = THE_NON_VALUE;
+	    }
+	}
+    }
+    db_finalize_dbterm_tree_common(cret, handle, &GET_BASE(base_node)->root,
+				   NULL);
+    if (is_value(key_copy)) {
+	release_base_node(tb, base_node, key_copy);
+    } else {
+	unlock_base_node(base_node);
+	erts_smp_rwmtx_runlock(&tb->route_lock);
+    }
+    if (key_heap)
+	erts_free(ERTS_ALC_T_DB_TMP, key_heap);
+}
@@ -0,0 +1,77 @@
+/*
+ * %CopyrightBegin%
+ *
+ * Copyright Ericsson AB 2017. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * %CopyrightEnd%
+ */
+
+#ifndef _DB_CATREE_H
+#define _DB_CATREE_H
+
+#include "erl_db_tree.h"
+
+/*
+ * A copy of a key that separates two parts of the routing layer.
+ * Lives as long as the route node it belongs to.
+ */
+typedef struct {
+    Eterm term;
+    struct erl_off_heap_header* oh;
+    Uint size;
+    Eterm heap[1];
+} DbRouteKey;
+
+typedef struct {
+    erts_smp_mtx_t lock;      /* Protects lock_statistics and root */
+    Sint lock_statistics;     /* Contention observed on lock */
+    TreeDbTerm *root;         /* The AVL tree holding the elements */
+} DbTableCATreeBaseNode;
+
+typedef struct {
+    struct db_table_catree_node *left;  /* Keys smaller than key */
+    struct db_table_catree_node *right; /* Keys equal to or greater than key */
+    DbRouteKey key;                     /* Must be last */
+} DbTableCATreeRouteNode;
+
+typedef struct db_table_catree_node {
+    int is_base_node;
+    union {
+	DbTableCATreeBaseNode base;
+	DbTableCATreeRouteNode route;
+    } u;
+} DbTableCATreeNode;
+
+typedef struct db_table_catree {
+    /* The tree part is used as a view of the whole table when all base
+     * nodes have been joined into one, see lock_as_tree(). */
+    DbTableTree tree;
+
+    /* CA tree specific fields */
+    erts_smp_rwmtx_t route_lock; /* Read locked while base nodes are used,
+                                    write locked while the routing layer
+                                    is changed */
+    DbTableCATreeNode *root;     /* The routing layer */
+} DbTableCATree;
+
+/*
+** Function prototypes, looks the same (except the suffix) for all
+** table types. The process is always an [in out] parameter.
+*/
+void db_initialize_catree(void);
+
+int db_create_catree(Process *p, DbTable *tbl);
+
+#endif /* _DB_CATREE_H */
@@ -121,7 +121,7 @@
      : ((struct segment**) erts_smp_atomic_read_nob(&(tb)->segtab)))
 #endif
 #define NACTIVE(tb) ((int)erts_smp_atomic_read_nob(&(tb)->nactive))
-#define NITEMS(tb) ((int)erts_smp_atomic_read_nob(&(tb)->common.nitems))
+#define NITEMS(tb) ((int)erts_db_read_nitems(&(tb)->common))
 
 #define BUCKET(tb, i) SEGTAB(tb)[(i) >> SEGSZ_EXP]->buckets[(i) & SEGSZ_MASK]
 
@@ -463,12 +463,24 @@ db_finalize_dbterm_hash(int cret, DbUpdateHandle* handle);
 static ERTS_INLINE void try_shrink(DbTableHash* tb)
 {
     int nactive = NACTIVE(tb);
-    if (nactive > SEGSZ && NITEMS(tb) < (nactive * CHAIN_LEN)
-	&& !IS_FIXED(tb)) {
+    if (nactive > SEGSZ && !IS_FIXED(tb)
+	&& erts_db_nitems_check_due(&tb->common)
+	&& NITEMS(tb) < (nactive * CHAIN_LEN)) {
 	shrink(tb, nactive);
     }
 }	
 
+/* Called after an item has been added */
+static ERTS_INLINE void try_grow(DbTableHash* tb)
+{
+    if (!IS_FIXED(tb) && erts_db_nitems_check_due(&tb->common)) {
+	int nactive = NACTIVE(tb);
+	if (NITEMS(tb) > nactive * (CHAIN_LEN+1)) {
+	    grow(tb, nactive);
+	}
+    }
+}
+
 /* Is this a live object (not pseodo-deleted) with the specified key? 
 */
 static ERTS_INLINE int has_live_key(DbTableHash* tb, HashDbTerm* b,
@@ -784,7 +796,6 @@ int db_put_hash(DbTable *tbl, Eterm obj, int key_clash_fail)
     HashDbTerm* b;
     HashDbTerm* q;
     erts_smp_rwmtx_t* lck;
-    int nitems;
     int ret = DB_ERROR_NONE;
 
     key = GETKEY(tb, tuple_val(obj));
@@ -809,7 +820,7 @@ int db_put_hash(DbTable *tbl, Eterm obj, int key_clash_fail)
     if (tb->common.status & DB_SET) {
 	HashDbTerm* bnext = b->next;
 	if (b->hvalue == INVALID_HASH) {
-	    erts_smp_atomic_inc_nob(&tb->common.nitems);
+	    erts_db_add_nitems(&tb->common, 1);
 	}
 	else if (key_clash_fail) {
 	    ret = DB_ERROR_BADKEY;
@@ -837,7 +848,7 @@ int db_put_hash(DbTable *tbl, Eterm obj, int key_clash_fail)
 	do {
 	    if (db_eq(&tb->common,obj,&q->dbterm)) {
 		if (q->hvalue == INVALID_HASH) {
-		    erts_smp_atomic_inc_nob(&tb->common.nitems);
+		    erts_db_add_nitems(&tb->common, 1);
 		    q->hvalue = hval;
 		    if (q != b) { /* must move to preserve key insertion order */
 			*qp = q->next;
@@ -858,14 +869,9 @@ Lnew:
     q->hvalue = hval;
     q->next = b;
     *bp = q;
-    nitems = erts_smp_atomic_inc_read_nob(&tb->common.nitems);
+    erts_db_add_nitems(&tb->common, 1);
     WUNLOCK_HASH(lck);
-    {
-	int nactive = NACTIVE(tb);       
-	if (nitems > nactive * (CHAIN_LEN+1) && !IS_FIXED(tb)) {
-	    grow(tb, nactive);
-	}
-    }
+    try_grow(tb);
     CHECK_TABLES();
     return DB_ERROR_NONE;
 
@@ -880,12 +886,12 @@ get_term_list(Process *p, DbTableHash *tb, Eterm key, HashValue hval,
 {
     HashDbTerm* b2 = b1->next;
     Eterm copy;
-    Uint sz = b1->dbterm.size + 2;
+    Uint sz = DB_COPY_OBJECT_SIZE(tb, &b1->dbterm) + 2;
 
     if (tb->common.status & (DB_BAG | DB_DUPLICATE_BAG)) {
         while (b2 && has_key(tb, b2, key, hval)) {
 	    if (b2->hvalue != INVALID_HASH)
-		sz += b2->dbterm.size + 2;
+		sz += DB_COPY_OBJECT_SIZE(tb, &b2->dbterm) + 2;
 
             b2 = b2->next;
         }
@@ -1109,7 +1115,7 @@ int db_erase_bag_exact2(DbTable *tbl, Eterm key, Eterm value)
 		EQ(value, b->dbterm.tpl[2])) {
 		*bp = b->next;
 		free_term(tb, b);
-		erts_smp_atomic_dec_nob(&tb->common.nitems);
+		erts_db_add_nitems(&tb->common, -1);
 		b = *bp;
 		break;
 	    }
@@ -1168,7 +1174,7 @@ int db_erase_hash(DbTable *tbl, Eterm key, Eterm *ret)
     }
     WUNLOCK_HASH(lck);
     if (nitems_diff) {
-	erts_smp_atomic_add_nob(&tb->common.nitems, nitems_diff);
+	erts_db_add_nitems(&tb->common, nitems_diff);
 	try_shrink(tb);
     }
     *ret = am_true;
@@ -1226,7 +1232,7 @@ static int db_erase_object_hash(DbTable *tbl, Eterm object, Eterm *ret)
     }
     WUNLOCK_HASH(lck);
     if (nitems_diff) {
-	erts_smp_atomic_add_nob(&tb->common.nitems, nitems_diff);
+	erts_db_add_nitems(&tb->common, nitems_diff);
 	try_shrink(tb);
     }
     *ret = am_true;
@@ -1840,7 +1846,7 @@ static int db_select_delete_hash(Process *p,
 		    free_term(tb, del);
 		    did_erase = 1;
 		}
-		erts_smp_atomic_dec_nob(&tb->common.nitems);
+		erts_db_add_nitems(&tb->common, -1);
 		++got;
 	    }	    
 	    --num_left;
@@ -1954,7 +1960,7 @@ static int db_select_delete_continue_hash(Process *p,
 		    free_term(tb, del);
 		    did_erase = 1;
 		}
-		erts_smp_atomic_dec_nob(&tb->common.nitems);
+		erts_db_add_nitems(&tb->common, -1);
 		++got;
 	    }
 	    
@@ -2117,7 +2123,7 @@ static int db_take_hash(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
     }
     WUNLOCK_HASH(lck);
     if (nitems_diff) {
-        erts_smp_atomic_add_nob(&tb->common.nitems, nitems_diff);
+        erts_db_add_nitems(&tb->common, nitems_diff);
         try_shrink(tb);
     }
     return DB_ERROR_NONE;
@@ -2149,7 +2155,7 @@ int db_mark_all_deleted_hash(DbTable *tbl)
 	    }while(list != NULL);
 	}
     }
-    erts_smp_atomic_set_nob(&tb->common.nitems, 0);    
+    erts_db_reset_nitems(&tb->common);
     return DB_ERROR_NONE;
 }
 
@@ -2270,7 +2276,7 @@ static int db_free_table_continue_hash(DbTable *tbl)
 	tb->locks = NULL;
     }
 #endif    
-    ASSERT(erts_smp_atomic_read_nob(&tb->common.memory_size) == sizeof(DbTable));
+    ASSERT(erts_db_read_memory_size(&tb->common) == sizeof(DbTable));
     return 1;			/* Done */
 }
 
@@ -2579,7 +2585,7 @@ static Eterm build_term_list(Process* p, HashDbTerm* ptr1, HashDbTerm* ptr2,
 	ptr = ptr1;
 	while(ptr != ptr2) {
 	    if (ptr->hvalue != INVALID_HASH)
-		sz += ptr->dbterm.size + 2;
+		sz += DB_COPY_OBJECT_SIZE(tb, &ptr->dbterm) + 2;
 	    ptr = ptr->next;
 	}
     }
@@ -2875,7 +2881,7 @@ db_lookup_dbterm_hash(Process *p, DbTable *tbl, Eterm key, Eterm obj,
             q->next = next;
             q->hvalue = hval;
             *bp = b = q;
-            erts_smp_atomic_inc_nob(&tb->common.nitems);
+            erts_db_add_nitems(&tb->common, 1);
         }
 
         HRelease(p, hend, htop);
@@ -2918,7 +2924,7 @@ db_finalize_dbterm_hash(int cret, DbUpdateHandle* handle)
         }
 
         WUNLOCK_HASH(lck);
-        erts_smp_atomic_dec_nob(&tb->common.nitems);
+        erts_db_add_nitems(&tb->common, -1);
         try_shrink(tb);
     } else {
         if (handle->flags & DB_MUST_RESIZE) {
@@ -2926,14 +2932,9 @@ db_finalize_dbterm_hash(int cret, DbUpdateHandle* handle)
             free_me = b;
         }
         if (handle->flags & DB_INC_TRY_GROW) {
-            int nactive;
-            int nitems = erts_smp_atomic_inc_read_nob(&tb->common.nitems);
+            erts_db_add_nitems(&tb->common, 1);
             WUNLOCK_HASH(lck);
-            nactive = NACTIVE(tb);
-
-            if (nitems > nactive * (CHAIN_LEN + 1) && !IS_FIXED(tb)) {
-                grow(tb, nactive);
-            }
+            try_grow(tb);
         } else {
             WUNLOCK_HASH(lck);
         }
@@ -2955,7 +2956,7 @@ static int db_delete_all_objects_hash(Process* p, DbTable* tbl)
     } else {
 	db_free_table_hash(tbl);
 	db_create_hash(p, tbl);
-	erts_smp_atomic_set_nob(&tbl->hash.common.nitems, 0);
+	erts_db_reset_nitems(&tbl->hash.common);
     }
     return 0;
 }
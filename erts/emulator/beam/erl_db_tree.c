@@ -85,7 +85,7 @@
 */
 static DbTreeStack* get_static_stack(DbTableTree* tb)
 {
-    if (!erts_smp_atomic_xchg_acqb(&tb->is_stack_busy, 1)) {
+    if (tb != NULL && !erts_smp_atomic_xchg_acqb(&tb->is_stack_busy, 1)) {
 	return &tb->static_stack;
     }
     return NULL;
@@ -122,36 +122,38 @@ static void release_stack(DbTableTree* tb, DbTreeStack* stack)
 
 static ERTS_INLINE void reset_static_stack(DbTableTree* tb)
 {
-    tb->static_stack.pos = 0;
-    tb->static_stack.slot = 0;
+    if (tb != NULL) {
+	tb->static_stack.pos = 0;
+	tb->static_stack.slot = 0;
+    }
 }
 
-static ERTS_INLINE void free_term(DbTableTree *tb, TreeDbTerm* p)
+static ERTS_INLINE void free_term(DbTableCommon *tb, TreeDbTerm* p)
 {
     db_free_term((DbTable*)tb, p, offsetof(TreeDbTerm, dbterm));
 }
 
-static ERTS_INLINE TreeDbTerm* new_dbterm(DbTableTree *tb, Eterm obj)
+static ERTS_INLINE TreeDbTerm* new_dbterm(DbTableCommon *tb, Eterm obj)
 {
     TreeDbTerm* p;
-    if (tb->common.compress) {
-	p = db_store_term_comp(&tb->common, NULL, offsetof(TreeDbTerm,dbterm), obj);
+    if (tb->compress) {
+	p = db_store_term_comp(tb, NULL, offsetof(TreeDbTerm,dbterm), obj);
     }
     else {
-	p = db_store_term(&tb->common, NULL, offsetof(TreeDbTerm,dbterm), obj);
+	p = db_store_term(tb, NULL, offsetof(TreeDbTerm,dbterm), obj);
     }
     return p;
 }
-static ERTS_INLINE TreeDbTerm* replace_dbterm(DbTableTree *tb, TreeDbTerm* old,
+static ERTS_INLINE TreeDbTerm* replace_dbterm(DbTableCommon *tb, TreeDbTerm* old,
 					      Eterm obj)
 {
     TreeDbTerm* p;
     ASSERT(old != NULL);
-    if (tb->common.compress) {
-	p = db_store_term_comp(&tb->common, &(old->dbterm), offsetof(TreeDbTerm,dbterm), obj);
+    if (tb->compress) {
+	p = db_store_term_comp(tb, &(old->dbterm), offsetof(TreeDbTerm,dbterm), obj);
     }
     else {
-	p = db_store_term(&tb->common, &(old->dbterm), offsetof(TreeDbTerm,dbterm), obj);
+	p = db_store_term(tb, &(old->dbterm), offsetof(TreeDbTerm,dbterm), obj);
     }
     return p;
 }
@@ -280,19 +282,24 @@ struct select_delete_context {
 /*
 ** Forward declarations 
 */
-static TreeDbTerm *linkout_tree(DbTableTree *tb, Eterm key);
-static TreeDbTerm *linkout_object_tree(DbTableTree *tb, 
-				       Eterm object);
+static TreeDbTerm *linkout_tree(DbTableCommon *tb, TreeDbTerm **root,
+				Eterm key, DbTableTree *stack_container);
+static TreeDbTerm *linkout_object_tree(DbTableCommon *tb, TreeDbTerm **root,
+				       Eterm object,
+				       DbTableTree *stack_container);
 static int do_free_tree_cont(DbTableTree *tb, int num_left);
-static void free_term(DbTableTree *tb, TreeDbTerm* p);
 static int balance_left(TreeDbTerm **this); 
 static int balance_right(TreeDbTerm **this); 
 static int delsub(TreeDbTerm **this); 
 static TreeDbTerm *slot_search(Process *p, DbTableTree *tb, Sint slot);
-static TreeDbTerm *find_node(DbTableTree *tb, Eterm key);
-static TreeDbTerm **find_node2(DbTableTree *tb, Eterm key);
-static TreeDbTerm *find_next(DbTableTree *tb, DbTreeStack*, Eterm key);
-static TreeDbTerm *find_prev(DbTableTree *tb, DbTreeStack*, Eterm key);
+static TreeDbTerm *find_node(DbTableCommon *tb, TreeDbTerm *root,
+			     Eterm key, DbTableTree *stack_container);
+static TreeDbTerm **find_node2(DbTableCommon *tb, TreeDbTerm **root,
+			       Eterm key);
+static TreeDbTerm *find_next(DbTableCommon *tb, TreeDbTerm *root,
+			     DbTreeStack*, Eterm key);
+static TreeDbTerm *find_prev(DbTableCommon *tb, TreeDbTerm *root,
+			     DbTreeStack*, Eterm key);
 static TreeDbTerm *find_next_from_pb_key(DbTableTree *tb, DbTreeStack*,
 					 Eterm key);
 static TreeDbTerm *find_prev_from_pb_key(DbTableTree *tb, DbTreeStack*,
@@ -517,7 +524,7 @@ static int db_next_tree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
     if (is_atom(key) && key == am_EOT)
 	return DB_ERROR_BADKEY;
     stack = get_any_stack(tb);
-    this = find_next(tb, stack, key);
+    this = find_next(&tb->common, tb->root, stack, key);
     release_stack(tb,stack);
     if (this == NULL) {
 	*ret = am_EOT;
@@ -563,7 +570,7 @@ static int db_prev_tree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
     if (is_atom(key) && key == am_EOT)
 	return DB_ERROR_BADKEY;
     stack = get_any_stack(tb);
-    this = find_prev(tb, stack, key);
+    this = find_prev(&tb->common, tb->root, stack, key);
     release_stack(tb,stack);
     if (this == NULL) {
 	*ret = am_EOT;
@@ -573,25 +580,25 @@ static int db_prev_tree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
     return DB_ERROR_NONE;
 }
 
-static ERTS_INLINE Sint cmp_key(DbTableTree* tb, Eterm key, TreeDbTerm* obj) {
+static ERTS_INLINE Sint cmp_key(DbTableCommon* tb, Eterm key, TreeDbTerm* obj) {
     return CMP(key, GETKEY(tb,obj->dbterm.tpl));
 }
 
-static ERTS_INLINE int cmp_key_eq(DbTableTree* tb, Eterm key, TreeDbTerm* obj) {
+static ERTS_INLINE int cmp_key_eq(DbTableCommon* tb, Eterm key, TreeDbTerm* obj) {
     Eterm obj_key = GETKEY(tb,obj->dbterm.tpl);
     return is_same(key, obj_key) || CMP(key, obj_key) == 0;
 }
 
-static int db_put_tree(DbTable *tbl, Eterm obj, int key_clash_fail)
+int db_put_tree_common(DbTableCommon *tb, TreeDbTerm **root, Eterm obj,
+		       int key_clash_fail, DbTableTree *stack_container)
 {
-    DbTableTree *tb = &tbl->tree;
     /* Non recursive insertion in AVL tree, building our own stack */
     TreeDbTerm **tstack[STACK_NEED];
     int tpos = 0;
     int dstack[STACK_NEED+1];
     int dpos = 0;
     int state = 0;
-    TreeDbTerm **this = &tb->root;
+    TreeDbTerm **this = root;
     Sint c;
     Eterm key;
     int dir;
@@ -599,14 +606,14 @@ static int db_put_tree(DbTable *tbl, Eterm obj, int key_clash_fail)
 
     key = GETKEY(tb, tuple_val(obj));
 
-    reset_static_stack(tb);
+    reset_static_stack(stack_container);
 
     dstack[dpos++] = DIR_END;
     for (;;)
 	if (!*this) { /* Found our place */
 	    state = 1;
-	    if (erts_smp_atomic_inc_read_nob(&tb->common.nitems) >= TREE_MAX_ELEMENTS) {
-		erts_smp_atomic_dec_nob(&tb->common.nitems);
+	    if (erts_smp_atomic_inc_read_nob(&tb->nitems) >= TREE_MAX_ELEMENTS) {
+		erts_smp_atomic_dec_nob(&tb->nitems);
 		return DB_ERROR_SYSRES;
 	    }
 	    *this = new_dbterm(tb, obj);
@@ -697,9 +704,15 @@ static int db_put_tree(DbTable *tbl, Eterm obj, int key_clash_fail)
     return DB_ERROR_NONE;
 }
 
-static int db_get_tree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
+static int db_put_tree(DbTable *tbl, Eterm obj, int key_clash_fail)
 {
     DbTableTree *tb = &tbl->tree;
+    return db_put_tree_common(&tb->common, &tb->root, obj, key_clash_fail, tb);
+}
+
+int db_get_tree_common(Process *p, DbTableCommon *tb, TreeDbTerm *root,
+		       Eterm key, Eterm *ret, DbTableTree *stack_container)
+{
     Eterm copy;
     Eterm *hp, *hend;
     TreeDbTerm *this;
@@ -710,13 +723,13 @@ static int db_get_tree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
      * The list created around it is purely for interface conformance.
      */
     
-    this = find_node(tb,key);
+    this = find_node(tb,root,key,stack_container);
     if (this == NULL) {
 	*ret = NIL;
     } else {
 	hp = HAlloc(p, this->dbterm.size + 2);
 	hend = hp + this->dbterm.size + 2;
-	copy = db_copy_object_from_ets(&tb->common, &this->dbterm, &hp, &MSO(p));
+	copy = db_copy_object_from_ets(tb, &this->dbterm, &hp, &MSO(p));
 	*ret = CONS(hp, copy, NIL);
 	hp += 2;
 	HRelease(p,hend,hp);
@@ -724,18 +737,29 @@ static int db_get_tree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
     return DB_ERROR_NONE;
 }
 
-static int db_member_tree(DbTable *tbl, Eterm key, Eterm *ret)
+static int db_get_tree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
 {
     DbTableTree *tb = &tbl->tree;
+    return db_get_tree_common(p, &tb->common, tb->root, key, ret, tb);
+}
 
-    *ret = (find_node(tb,key) == NULL) ? am_false : am_true;
+int db_member_tree_common(DbTableCommon *tb, TreeDbTerm *root, Eterm key,
+			  Eterm *ret, DbTableTree *stack_container)
+{
+    *ret = (find_node(tb,root,key,stack_container) == NULL) ? am_false : am_true;
     return DB_ERROR_NONE;
 }
 
-static int db_get_element_tree(Process *p, DbTable *tbl,
-			       Eterm key, int ndex, Eterm *ret)
+static int db_member_tree(DbTable *tbl, Eterm key, Eterm *ret)
 {
     DbTableTree *tb = &tbl->tree;
+    return db_member_tree_common(&tb->common, tb->root, key, ret, tb);
+}
+
+int db_get_element_tree_common(Process *p, DbTableCommon *tb, TreeDbTerm *root,
+			       Eterm key, int ndex, Eterm *ret,
+			       DbTableTree *stack_container)
+{
     /*
      * Look the node up:
      */
@@ -749,44 +773,64 @@ static int db_get_element_tree(Process *p, DbTable *tbl,
      * around the element here either.
      */
     
-    this = find_node(tb,key);
+    this = find_node(tb,root,key,stack_container);
     if (this == NULL) {
 	return DB_ERROR_BADKEY;
     } else {
 	if (ndex > arityval(this->dbterm.tpl[0])) {
 	    return DB_ERROR_BADPARAM;
 	}
-	*ret = db_copy_element_from_ets(&tb->common, p, &this->dbterm, ndex, &hp, 0);
+	*ret = db_copy_element_from_ets(tb, p, &this->dbterm, ndex, &hp, 0);
     }
     return DB_ERROR_NONE;
 }
 
-static int db_erase_tree(DbTable *tbl, Eterm key, Eterm *ret)
+static int db_get_element_tree(Process *p, DbTable *tbl,
+			       Eterm key, int ndex, Eterm *ret)
 {
     DbTableTree *tb = &tbl->tree;
+    return db_get_element_tree_common(p, &tb->common, tb->root, key,
+				      ndex, ret, tb);
+}
+
+int db_erase_tree_common(DbTable *tbl, TreeDbTerm **root, Eterm key,
+			 Eterm *ret, DbTableTree *stack_container)
+{
     TreeDbTerm *res;
 
     *ret = am_true;
 
-    if ((res = linkout_tree(tb, key)) != NULL) {
-	free_term(tb, res);
+    if ((res = linkout_tree(&tbl->common, root, key, stack_container)) != NULL) {
+	free_term(&tbl->common, res);
     }
     return DB_ERROR_NONE;
 }
 
-static int db_erase_object_tree(DbTable *tbl, Eterm object, Eterm *ret)
+static int db_erase_tree(DbTable *tbl, Eterm key, Eterm *ret)
+{
+    return db_erase_tree_common(tbl, &tbl->tree.root, key, ret, &tbl->tree);
+}
+
+int db_erase_object_tree_common(DbTable *tbl, TreeDbTerm **root, Eterm object,
+				Eterm *ret, DbTableTree *stack_container)
 {
-    DbTableTree *tb = &tbl->tree;
     TreeDbTerm *res;
 
     *ret = am_true;
 
-    if ((res = linkout_object_tree(tb, object)) != NULL) {
-	free_term(tb, res);
+    if ((res = linkout_object_tree(&tbl->common, root, object,
+				   stack_container)) != NULL) {
+	free_term(&tbl->common, res);
     }
     return DB_ERROR_NONE;
 }
 
+static int db_erase_object_tree(DbTable *tbl, Eterm object, Eterm *ret)
+{
+    return db_erase_object_tree_common(tbl, &tbl->tree.root, object, ret,
+				       &tbl->tree);
+}
+
 
 static int db_slot_tree(Process *p, DbTable *tbl, 
 			Eterm slot_term, Eterm *ret)
@@ -1541,7 +1585,7 @@ static int db_select_delete_continue_tree(Process *p,
 
 #define RET_TO_BIF(Term, State) do { 		\
 	if (sc.erase_lastterm) {		\
-	    free_term(tb, sc.lastterm);		\
+	    free_term(&tb->common, sc.lastterm);		\
 	}					\
 	*ret = (Term); 				\
 	return State; 				\
@@ -1630,7 +1674,7 @@ static int db_select_delete_tree(Process *p, DbTable *tbl,
 	    erts_bin_free(mpi.mp);       	\
 	}					\
 	if (sc.erase_lastterm) {                \
-	    free_term(tb, sc.lastterm);         \
+	    free_term(&tb->common, sc.lastterm);         \
 	}                                       \
 	*ret = (Term); 				\
 	return RetVal; 			        \
@@ -1703,7 +1747,7 @@ static int db_select_delete_tree(Process *p, DbTable *tbl,
 
     /* Don't free mpi.mp, so don't use macro */
     if (sc.erase_lastterm) {
-	free_term(tb, sc.lastterm);
+	free_term(&tb->common, sc.lastterm);
     }
     *ret = bif_trap1(&ets_select_delete_continue_exp, p, continuation); 
     return DB_ERROR_NONE;
@@ -1712,28 +1756,35 @@ static int db_select_delete_tree(Process *p, DbTable *tbl,
 
 }
 
-static int db_take_tree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
+int db_take_tree_common(Process *p, DbTable *tbl, TreeDbTerm **root,
+                        Eterm key, Eterm *ret,
+                        DbTableTree *stack_container)
 {
-    DbTableTree *tb = &tbl->tree;
     TreeDbTerm *this;
 
     *ret = NIL;
-    this = linkout_tree(tb, key);
+    this = linkout_tree(&tbl->common, root, key, stack_container);
     if (this) {
         Eterm copy, *hp, *hend;
 
         hp = HAlloc(p, this->dbterm.size + 2);
         hend = hp + this->dbterm.size + 2;
-        copy = db_copy_object_from_ets(&tb->common,
+        copy = db_copy_object_from_ets(&tbl->common,
                                        &this->dbterm, &hp, &MSO(p));
         *ret = CONS(hp, copy, NIL);
         hp += 2;
         HRelease(p, hend, hp);
-        free_term(tb, this);
+        free_term(&tbl->common, this);
     }
     return DB_ERROR_NONE;
 }
 
+static int db_take_tree(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
+{
+    DbTableTree *tb = &tbl->tree;
+    return db_take_tree_common(p, tbl, &tb->root, key, ret, tb);
+}
+
 /*
 ** Other interface routines (not directly coupled to one bif)
 */
@@ -1829,13 +1880,15 @@ do_db_tree_foreach_offheap(TreeDbTerm *tdbt,
     do_db_tree_foreach_offheap(tdbt->right, func, arg);
 }
 
-static TreeDbTerm *linkout_tree(DbTableTree *tb, Eterm key) {
+static TreeDbTerm *linkout_tree(DbTableCommon *tb, TreeDbTerm **root,
+				Eterm key, DbTableTree *stack_container)
+{
     TreeDbTerm **tstack[STACK_NEED];
     int tpos = 0;
     int dstack[STACK_NEED+1];
     int dpos = 0;
     int state = 0;
-    TreeDbTerm **this = &tb->root;
+    TreeDbTerm **this = root;
     Sint c;
     int dir;
     TreeDbTerm *q = NULL;
@@ -1846,7 +1899,7 @@ static TreeDbTerm *linkout_tree(DbTableTree *tb, Eterm key) {
      * keep the balance. As in insert, we do the stacking ourselves.
      */
 
-    reset_static_stack(tb);
+    reset_static_stack(stack_container);
     dstack[dpos++] = DIR_END;
     for (;;) {
 	if (!*this) { /* Failure */
@@ -1872,7 +1925,7 @@ static TreeDbTerm *linkout_tree(DbTableTree *tb, Eterm key) {
 		tstack[tpos++] = this;
 		state = delsub(this);
 	    }
-	    erts_smp_atomic_dec_nob(&tb->common.nitems);
+	    erts_smp_atomic_dec_nob(&tb->nitems);
 	    break;
 	}
     }
@@ -1887,15 +1940,16 @@ static TreeDbTerm *linkout_tree(DbTableTree *tb, Eterm key) {
     return q;
 }
 
-static TreeDbTerm *linkout_object_tree(DbTableTree *tb, 
-				       Eterm object)
+static TreeDbTerm *linkout_object_tree(DbTableCommon *tb, TreeDbTerm **root,
+				       Eterm object,
+				       DbTableTree *stack_container)
 {
     TreeDbTerm **tstack[STACK_NEED];
     int tpos = 0;
     int dstack[STACK_NEED+1];
     int dpos = 0;
     int state = 0;
-    TreeDbTerm **this = &tb->root;
+    TreeDbTerm **this = root;
     Sint c;
     int dir;
     TreeDbTerm *q = NULL;
@@ -1910,7 +1964,7 @@ static TreeDbTerm *linkout_object_tree(DbTableTree *tb,
     
     key = GETKEY(tb, tuple_val(object));
 
-    reset_static_stack(tb);
+    reset_static_stack(stack_container);
     dstack[dpos++] = DIR_END;
     for (;;) {
 	if (!*this) { /* Failure */
@@ -1924,7 +1978,7 @@ static TreeDbTerm *linkout_object_tree(DbTableTree *tb,
 	    tstack[tpos++] = this;
 	    this = &((*this)->right);
 	} else { /* Equal key, found the only possible matching object*/
-	    if (!db_eq(&tb->common,object,&(*this)->dbterm)) {
+	    if (!db_eq(tb,object,&(*this)->dbterm)) {
 		return NULL;
 	    }
 	    q = (*this);
@@ -1939,7 +1993,7 @@ static TreeDbTerm *linkout_object_tree(DbTableTree *tb,
 		tstack[tpos++] = this;
 		state = delsub(this);
 	    }
-	    erts_smp_atomic_dec_nob(&tb->common.nitems);
+	    erts_smp_atomic_dec_nob(&tb->nitems);
 	    break;
 	}
     }
@@ -2086,7 +2140,7 @@ static int do_free_tree_cont(DbTableTree *tb, int num_left)
 		PUSH_NODE(&tb->static_stack, root);
 		root = p;
 	    } else {
-		free_term(tb, root);
+		free_term(&tb->common, root);
 		if (--num_left > 0) {
 		    break;
 		} else {
@@ -2223,6 +2277,165 @@ static int delsub(TreeDbTerm **this)
     return h;
 }
 
+/*
+ * Join and split helpers, used by the contention adapting tree
+ * (erl_db_catree.c) to move elements between its base nodes
+ * in logarithmic time.
+ */
+
+static int tree_height(TreeDbTerm *t)
+{
+    int h = 0;
+
+    while (t != NULL) {
+	++h;
+	t = (t->balance < 0) ? t->left : t->right;
+    }
+    return h;
+}
+
+/* The right subtree of *this has grown by one, returns true if the
+ * height of *this also grew. */
+static int grow_right(TreeDbTerm **this)
+{
+    TreeDbTerm *p = *this;
+    int h;
+
+    switch (p->balance) {
+    case -1:
+	p->balance = 0;
+	return 0;
+    case 0:
+	p->balance = 1;
+	return 1;
+    default:
+	/* Same rotations as when the left subtree has shrunk */
+	h = (p->right->balance == 0);
+	balance_left(this);
+	return h;
+    }
+}
+
+static int grow_left(TreeDbTerm **this)
+{
+    TreeDbTerm *p = *this;
+    int h;
+
+    switch (p->balance) {
+    case 1:
+	p->balance = 0;
+	return 0;
+    case 0:
+	p->balance = -1;
+	return 1;
+    default:
+	h = (p->left->balance == 0);
+	balance_right(this);
+	return h;
+    }
+}
+
+/* All keys in left < key of pivot < all keys in right */
+static TreeDbTerm *join_with_pivot(TreeDbTerm *left, TreeDbTerm *pivot,
+				   TreeDbTerm *right)
+{
+    TreeDbTerm **tstack[STACK_NEED];
+    int tpos = 0;
+    int lh = tree_height(left);
+    int rh = tree_height(right);
+    TreeDbTerm *root;
+    TreeDbTerm **this;
+    int h;
+
+    if (lh > rh + 1) {
+	/* Walk down the right spine of left to a subtree as high as right */
+	root = left;
+	this = &root;
+	h = lh;
+	while (h > rh + 1) {
+	    h -= ((*this)->balance < 0) ? 2 : 1;
+	    tstack[tpos++] = this;
+	    this = &((*this)->right);
+	}
+	pivot->left = *this;
+	pivot->right = right;
+	pivot->balance = rh - h;
+	*this = pivot;
+	while (tpos && grow_right(tstack[--tpos]))
+	    ;
+	return root;
+    } else if (rh > lh + 1) {
+	root = right;
+	this = &root;
+	h = rh;
+	while (h > lh + 1) {
+	    h -= ((*this)->balance > 0) ? 2 : 1;
+	    tstack[tpos++] = this;
+	    this = &((*this)->left);
+	}
+	pivot->left = left;
+	pivot->right = *this;
+	pivot->balance = h - lh;
+	*this = pivot;
+	while (tpos && grow_left(tstack[--tpos]))
+	    ;
+	return root;
+    }
+    pivot->left = left;
+    pivot->right = right;
+    pivot->balance = rh - lh;
+    return pivot;
+}
+
+static TreeDbTerm *linkout_min(TreeDbTerm **root)
+{
+    TreeDbTerm **tstack[STACK_NEED];
+    int tpos = 0;
+    TreeDbTerm **this = root;
+    TreeDbTerm *q;
+
+    while ((*this)->left != NULL) {
+	tstack[tpos++] = this;
+	this = &((*this)->left);
+    }
+    q = *this;
+    *this = q->right;
+    while (tpos && balance_left(tstack[--tpos]))
+	;
+    return q;
+}
+
+/*
+ * Join two trees where all keys in left are smaller than all keys in right.
+ */
+TreeDbTerm *db_join_trees(TreeDbTerm *left, TreeDbTerm *right)
+{
+    TreeDbTerm *pivot;
+
+    if (left == NULL)
+	return right;
+    if (right == NULL)
+	return left;
+    pivot = linkout_min(&right);
+    return join_with_pivot(left, pivot, right);
+}
+
+/*
+ * Split a tree in two at its root. The elements smaller than the root
+ * end up in *left and the root together with all greater elements in
+ * *right. Returns the root, which has the smallest key of *right.
+ */
+TreeDbTerm *db_split_tree(TreeDbTerm *root, TreeDbTerm **left,
+			  TreeDbTerm **right)
+{
+    TreeDbTerm *l = root->left;
+    TreeDbTerm *r = root->right;
+
+    *left = l;
+    *right = join_with_pivot(NULL, root, r);
+    return root;
+}
+
 /*
  * Helper for db_slot
  */
@@ -2301,7 +2514,8 @@ done:
  * Find next and previous in sort order
  */
 
-static TreeDbTerm *find_next(DbTableTree *tb, DbTreeStack* stack, Eterm key) {
+static TreeDbTerm *find_next(DbTableCommon *tb, TreeDbTerm *root,
+			     DbTreeStack* stack, Eterm key) {
     TreeDbTerm *this;
     TreeDbTerm *tmp;
     Sint c;
@@ -2313,7 +2527,7 @@ static TreeDbTerm *find_next(DbTableTree *tb, DbTreeStack* stack, Eterm key) {
 	}
     }
     if (EMPTY_NODE(stack)) { /* Have to rebuild the stack */
-	if (( this = tb->root ) == NULL)
+	if (( this = root ) == NULL)
 	    return NULL;
 	for (;;) {
 	    PUSH_NODE(stack, this);
@@ -2357,7 +2571,8 @@ static TreeDbTerm *find_next(DbTableTree *tb, DbTreeStack* stack, Eterm key) {
     return this;
 }
 
-static TreeDbTerm *find_prev(DbTableTree *tb, DbTreeStack* stack, Eterm key) {
+static TreeDbTerm *find_prev(DbTableCommon *tb, TreeDbTerm *root,
+			     DbTreeStack* stack, Eterm key) {
     TreeDbTerm *this;
     TreeDbTerm *tmp;
     Sint c;
@@ -2369,7 +2584,7 @@ static TreeDbTerm *find_prev(DbTableTree *tb, DbTreeStack* stack, Eterm key) {
 	}
     }
     if (EMPTY_NODE(stack)) { /* Have to rebuild the stack */
-	if (( this = tb->root ) == NULL)
+	if (( this = root ) == NULL)
 	    return NULL;
 	for (;;) {
 	    PUSH_NODE(stack, this);
@@ -2483,16 +2698,17 @@ static TreeDbTerm *find_prev_from_pb_key(DbTableTree *tb, DbTreeStack* stack,
 /*
  * Just lookup a node
  */
-static TreeDbTerm *find_node(DbTableTree *tb, Eterm key)
+static TreeDbTerm *find_node(DbTableCommon *tb, TreeDbTerm *root,
+			     Eterm key, DbTableTree *stack_container)
 {
     TreeDbTerm *this;
     Sint res;
-    DbTreeStack* stack = get_static_stack(tb);
+    DbTreeStack* stack = get_static_stack(stack_container);
 
     if(!stack || EMPTY_NODE(stack)
        || !cmp_key_eq(tb, key, (this=TOP_NODE(stack)))) {
 
-	this = tb->root;
+	this = root;
 	while (this != NULL && (res = cmp_key(tb,key,this)) != 0) {
 	    if (res < 0)
 		this = this->left;
@@ -2501,7 +2717,7 @@ static TreeDbTerm *find_node(DbTableTree *tb, Eterm key)
 	}
     }
     if (stack) {
-	release_stack(tb,stack);
+	release_stack(stack_container,stack);
     }
     return this;
 }
@@ -2509,12 +2725,12 @@ static TreeDbTerm *find_node(DbTableTree *tb, Eterm key)
 /*
  * Lookup a node and return the address of the node pointer in the tree
  */
-static TreeDbTerm **find_node2(DbTableTree *tb, Eterm key)
+static TreeDbTerm **find_node2(DbTableCommon *tb, TreeDbTerm **root, Eterm key)
 {
     TreeDbTerm **this;
     Sint res;
 
-    this = &tb->root;
+    this = root;
     while ((*this) != NULL && (res = cmp_key(tb, key, *this)) != 0) {
 	if (res < 0)
 	    this = &((*this)->left);
@@ -2526,12 +2742,49 @@ static TreeDbTerm **find_node2(DbTableTree *tb, Eterm key)
     return this;
 }
 
-static int
-db_lookup_dbterm_tree(Process *p, DbTable *tbl, Eterm key, Eterm obj,
-                      DbUpdateHandle* handle)
+/*
+ * Find the closest element after (or before) key in the tree rooted at
+ * root without using the static stack.
+ */
+TreeDbTerm *db_find_next_node_tree(DbTableCommon *tb, TreeDbTerm *root,
+				   Eterm key)
 {
-    DbTableTree *tb = &tbl->tree;
-    TreeDbTerm **pp = find_node2(tb, key);
+    TreeDbTerm *this = root;
+    TreeDbTerm *candidate = NULL;
+
+    while (this != NULL) {
+	if (cmp_key(tb, key, this) < 0) {
+	    candidate = this;
+	    this = this->left;
+	} else {
+	    this = this->right;
+	}
+    }
+    return candidate;
+}
+
+TreeDbTerm *db_find_prev_node_tree(DbTableCommon *tb, TreeDbTerm *root,
+				   Eterm key)
+{
+    TreeDbTerm *this = root;
+    TreeDbTerm *candidate = NULL;
+
+    while (this != NULL) {
+	if (cmp_key(tb, key, this) > 0) {
+	    candidate = this;
+	    this = this->right;
+	} else {
+	    this = this->left;
+	}
+    }
+    return candidate;
+}
+
+int db_lookup_dbterm_tree_common(Process *p, DbTable *tbl, TreeDbTerm **root,
+                                 Eterm key, Eterm obj, DbUpdateHandle* handle,
+                                 DbTableTree *stack_container)
+{
+    TreeDbTerm **pp = find_node2(&tbl->common, root, key);
     int flags = 0;
 
     if (pp == NULL) {
@@ -2542,18 +2795,19 @@ db_lookup_dbterm_tree(Process *p, DbTable *tbl, Eterm key, Eterm obj,
             int arity = arityval(*objp);
             Eterm *htop, *hend;
 
-            ASSERT(arity >= tb->common.keypos);
+            ASSERT(arity >= tbl->common.keypos);
             htop = HAlloc(p, arity + 1);
             hend = htop + arity + 1;
             sys_memcpy(htop, objp, sizeof(Eterm) * (arity + 1));
-            htop[tb->common.keypos] = key;
+            htop[tbl->common.keypos] = key;
             obj = make_tuple(htop);
 
-            if (db_put_tree(tbl, obj, 1) != DB_ERROR_NONE) {
+            if (db_put_tree_common(&tbl->common, root,
+                                   obj, 1, stack_container) != DB_ERROR_NONE) {
                 return 0;
             }
 
-            pp = find_node2(tb, key);
+            pp = find_node2(&tbl->common, root, key);
             ASSERT(pp != NULL);
             HRelease(p, hend, htop);
             flags |= DB_NEW_OBJECT;
@@ -2568,27 +2822,45 @@ db_lookup_dbterm_tree(Process *p, DbTable *tbl, Eterm key, Eterm obj,
     return 1;
 }
 
-static void
-db_finalize_dbterm_tree(int cret, DbUpdateHandle *handle)
+static int
+db_lookup_dbterm_tree(Process *p, DbTable *tbl, Eterm key, Eterm obj,
+                      DbUpdateHandle* handle)
 {
-    DbTable *tbl = handle->tb;
     DbTableTree *tb = &tbl->tree;
+    return db_lookup_dbterm_tree_common(p, tbl, &tb->root, key,
+                                        obj, handle, tb);
+}
+
+void db_finalize_dbterm_tree_common(int cret, DbUpdateHandle *handle,
+                                    TreeDbTerm **root,
+                                    DbTableTree *stack_container)
+{
+    DbTable *tbl = handle->tb;
     TreeDbTerm *bp = (TreeDbTerm *) *handle->bp;
 
     if (handle->flags & DB_NEW_OBJECT && cret != DB_ERROR_NONE) {
         Eterm ret;
-        db_erase_tree(tbl, GETKEY(tb, bp->dbterm.tpl), &ret);
+        db_erase_tree_common(tbl, root, GETKEY(tbl, bp->dbterm.tpl),
+                             &ret, stack_container);
     } else if (handle->flags & DB_MUST_RESIZE) {
 	db_finalize_resize(handle, offsetof(TreeDbTerm,dbterm));
-        reset_static_stack(tb);
+        reset_static_stack(stack_container);
 
-        free_term(tb, bp);
+        free_term(&tbl->common, bp);
     }
 #ifdef DEBUG
     handle->dbterm = 0;
 #endif
     return;
-}   
+}
+
+static void
+db_finalize_dbterm_tree(int cret, DbUpdateHandle *handle)
+{
+    DbTable *tbl = handle->tb;
+    DbTableTree *tb = &tbl->tree;
+    db_finalize_dbterm_tree_common(cret, handle, &tb->root, tb);
+}
 
 /*
  * Traverse the tree with a callback function, used by db_match_xxx
@@ -2614,15 +2886,17 @@ static void traverse_backwards(DbTableTree *tb,
 	    this = this->right;
 	}
 	this = TOP_NODE(stack);
-	next = find_prev(tb, stack, GETKEY(tb, this->dbterm.tpl));
+	next = find_prev(&tb->common, tb->root, stack,
+			 GETKEY(tb, this->dbterm.tpl));
 	if (!((*doit)(tb, this, context, 0)))
 	    return;
     } else {
-	next = find_prev(tb, stack, lastkey);
+	next = find_prev(&tb->common, tb->root, stack, lastkey);
     }
 
     while ((this = next) != NULL) {
-	next = find_prev(tb, stack, GETKEY(tb, this->dbterm.tpl));
+	next = find_prev(&tb->common, tb->root, stack,
+			 GETKEY(tb, this->dbterm.tpl));
 	if (!((*doit)(tb, this, context, 0)))
 	    return;
     }
@@ -2652,15 +2926,17 @@ static void traverse_forward(DbTableTree *tb,
 	    this = this->left;
 	}
 	this = TOP_NODE(stack);
-	next = find_next(tb, stack, GETKEY(tb, this->dbterm.tpl));
+	next = find_next(&tb->common, tb->root, stack,
+			 GETKEY(tb, this->dbterm.tpl));
 	if (!((*doit)(tb, this, context, 1)))
 	    return;
     } else {
-	next = find_next(tb, stack, lastkey);
+	next = find_next(&tb->common, tb->root, stack, lastkey);
     }
 
     while ((this = next) != NULL) {
-	next = find_next(tb, stack, GETKEY(tb, this->dbterm.tpl));
+	next = find_next(&tb->common, tb->root, stack,
+			 GETKEY(tb, this->dbterm.tpl));
 	if (!((*doit)(tb, this, context, 1)))
 	    return;
     }
@@ -2683,7 +2959,7 @@ static int key_given(DbTableTree *tb, Eterm pattern, TreeDbTerm **ret,
     if (is_non_value(key))
 	return -1;  /* can't possibly match anything */
     if (!db_has_variable(key)) {   /* Bound key */
-	if (( this = find_node(tb, key) ) == NULL) {
+	if (( this = find_node(&tb->common, tb->root, key, tb) ) == NULL) {
 	    return -1;
 	}
 	*ret = this;
@@ -3084,7 +3360,7 @@ static int doit_select_delete(DbTableTree *tb, TreeDbTerm *this, void *ptr,
     Eterm key;
 
     if (sc->erase_lastterm)
-	free_term(tb, sc->lastterm);
+	free_term(&tb->common, sc->lastterm);
     sc->erase_lastterm = 0;
     sc->lastterm = this;
     
@@ -3096,7 +3372,7 @@ static int doit_select_delete(DbTableTree *tb, TreeDbTerm *this, void *ptr,
 			  &this->dbterm, NULL, 0);
     if (ret == am_true) {
 	key = GETKEY(sc->tb, this->dbterm.tpl);
-	linkout_tree(sc->tb, key);
+	linkout_tree(&sc->tb->common, &sc->tb->root, key, sc->tb);
 	sc->erase_lastterm = 1;
 	++sc->accum;
     }
@@ -53,4 +53,38 @@ void db_initialize_tree(void);
 
 int db_create_tree(Process *p, DbTable *tbl);
 
+/*
+** Operations on a tree given by its root, shared with the contention
+** adapting tree (erl_db_catree.c). A NULL stack_container means that
+** the static stack of the table is neither used nor invalidated.
+*/
+int db_put_tree_common(DbTableCommon *tb, TreeDbTerm **root, Eterm obj,
+		       int key_clash_fail, DbTableTree *stack_container);
+int db_get_tree_common(Process *p, DbTableCommon *tb, TreeDbTerm *root,
+		       Eterm key, Eterm *ret, DbTableTree *stack_container);
+int db_member_tree_common(DbTableCommon *tb, TreeDbTerm *root, Eterm key,
+			  Eterm *ret, DbTableTree *stack_container);
+int db_get_element_tree_common(Process *p, DbTableCommon *tb, TreeDbTerm *root,
+			       Eterm key, int ndex, Eterm *ret,
+			       DbTableTree *stack_container);
+int db_erase_tree_common(DbTable *tbl, TreeDbTerm **root, Eterm key,
+			 Eterm *ret, DbTableTree *stack_container);
+int db_erase_object_tree_common(DbTable *tbl, TreeDbTerm **root, Eterm object,
+				Eterm *ret, DbTableTree *stack_container);
+int db_take_tree_common(Process *p, DbTable *tbl, TreeDbTerm **root,
+			Eterm key, Eterm *ret, DbTableTree *stack_container);
+int db_lookup_dbterm_tree_common(Process *p, DbTable *tbl, TreeDbTerm **root,
+				 Eterm key, Eterm obj, DbUpdateHandle* handle,
+				 DbTableTree *stack_container);
+void db_finalize_dbterm_tree_common(int cret, DbUpdateHandle *handle,
+				    TreeDbTerm **root,
+				    DbTableTree *stack_container);
+TreeDbTerm *db_find_next_node_tree(DbTableCommon *tb, TreeDbTerm *root,
+				   Eterm key);
+TreeDbTerm *db_find_prev_node_tree(DbTableCommon *tb, TreeDbTerm *root,
+				   Eterm key);
+TreeDbTerm *db_join_trees(TreeDbTerm *left, TreeDbTerm *right);
+TreeDbTerm *db_split_tree(TreeDbTerm *root, TreeDbTerm **left,
+			  TreeDbTerm **right);
+
 #endif /* _DB_TREE_H */
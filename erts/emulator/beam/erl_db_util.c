@@ -252,7 +252,8 @@ typedef enum {
     matchSilent,
     matchSetSeqTokenFake,
     matchTrace2,
-    matchTrace3
+    matchTrace3,
+    matchSkipN /* Fused matchSkip's, see dmc_fuse_head() */
 } MatchOps;
 
 /*
@@ -486,6 +487,9 @@ erts_match_set_release_result(Process* c_p)
 
 static erts_smp_atomic32_t trace_control_word;
 
+/* Head optimizations in db_match_compile(), see dmc_fuse_head() */
+static int dmc_fused_heads = 1;
+
 /* This needs to be here, before the bif table... */
 
 static Eterm db_set_trace_control_word_fake_1(BIF_ALIST_1);
@@ -891,6 +895,8 @@ static DMCRet dmc_one_term(DMCContext *context,
 			   Eterm c);
 static Eterm
 dmc_private_copy(DMCContext *context, Eterm c);
+static Uint dmc_fuse_head(UWord *text, Uint start, Uint end);
+static void dmc_head_filter(MatchProg *prog, Uint head_end);
 
 
 #ifdef DMC_DEBUG
@@ -1331,6 +1337,7 @@ Binary *db_match_compile(Eterm *matchexpr,
     int current_try_label;
     Binary *bp = NULL;
     unsigned clause_start;
+    Uint head_end = 0;
 
     DMC_INIT_STACK(stack);
     DMC_INIT_STACK(text);
@@ -1589,6 +1596,13 @@ restart:
 	    }
 	}
 
+	if (dmc_fused_heads && !context.special) {
+	    DMC_STACK_NUM(text) = dmc_fuse_head(DMC_STACK_DATA(text),
+						clause_start,
+						DMC_STACK_NUM(text));
+	}
+	head_end = DMC_STACK_NUM(text);
+
 
 	/*
 	** ... and the guards
@@ -1676,6 +1690,11 @@ restart:
 	       DMC_STACK_NUM(text) * sizeof(UWord));
     ret->stack_offset = heap.vars_used*sizeof(MatchVariable) + FENCE_PATTERN_SIZE;
     ret->heap_size = ret->stack_offset + context.stack_need * sizeof(Eterm*) + FENCE_PATTERN_SIZE;
+    ret->filter_arity = 0;
+    ret->filter_num = 0;
+    if (dmc_fused_heads && num_progs == 1 && !(flags & DCOMP_TRACE)) {
+	dmc_head_filter(ret, head_end);
+    }
 
 #ifdef DMC_DEBUG
     ret->prog_end = ret->text + DMC_STACK_NUM(text);
@@ -1749,6 +1768,20 @@ static Eterm dpm_array_to_list(Process *psp, Eterm *arr, int arity)
     return ret;
 }
 
+/*
+** With jump tables available, each instruction of the match program
+** dispatches the next one directly (threaded code) instead of going
+** back through the switch.
+*/
+#if !defined(NO_JUMP_TABLE) && !defined(DMC_DEBUG)
+#  define DMC_THREADED_CODE 1
+#  define DMC_OP(Op) case Op: lb_##Op
+#  define DMC_NEXT() goto *dmc_jump_table[*pc++]
+#else
+#  define DMC_OP(Op) case Op
+#  define DMC_NEXT() break
+#endif
+
 /*
 ** Execution of the match program, this is Pam.
 ** May return THE_NON_VALUE, which is a bailout.
@@ -1785,6 +1818,73 @@ Eterm db_prog_match(Process *c_p,
     Eterm (*bif)(Process*, ...);
     Eterm bif_args[3];
     int fail_label;
+#ifdef DMC_THREADED_CODE
+    static void * const dmc_jump_table[] = {
+	[matchTryMeElse] = &&lb_matchTryMeElse,
+	[matchArray] = &&lb_matchArray,
+	[matchArrayBind] = &&lb_matchArrayBind,
+	[matchTuple] = &&lb_matchTuple,
+	[matchPushT] = &&lb_matchPushT,
+	[matchList] = &&lb_matchList,
+	[matchPushL] = &&lb_matchPushL,
+	[matchMap] = &&lb_matchMap,
+	[matchPushM] = &&lb_matchPushM,
+	[matchKey] = &&lb_matchKey,
+	[matchPop] = &&lb_matchPop,
+	[matchSwap] = &&lb_matchSwap,
+	[matchBind] = &&lb_matchBind,
+	[matchCmp] = &&lb_matchCmp,
+	[matchEqBin] = &&lb_matchEqBin,
+	[matchEqFloat] = &&lb_matchEqFloat,
+	[matchEqRef] = &&lb_matchEqRef,
+	[matchEqBig] = &&lb_matchEqBig,
+	[matchEq] = &&lb_matchEq,
+	[matchSkip] = &&lb_matchSkip,
+	[matchSkipN] = &&lb_matchSkipN,
+	[matchPushC] = &&lb_matchPushC,
+	[matchConsA] = &&lb_matchConsA,
+	[matchConsB] = &&lb_matchConsB,
+	[matchMkTuple] = &&lb_matchMkTuple,
+	[matchMkFlatMap] = &&lb_matchMkFlatMap,
+	[matchMkHashMap] = &&lb_matchMkHashMap,
+	[matchCall0] = &&lb_matchCall0,
+	[matchCall1] = &&lb_matchCall1,
+	[matchCall2] = &&lb_matchCall2,
+	[matchCall3] = &&lb_matchCall3,
+	[matchPushVResult] = &&lb_matchPushVResult,
+	[matchPushV] = &&lb_matchPushV,
+	[matchPushExpr] = &&lb_matchPushExpr,
+	[matchPushArrayAsList] = &&lb_matchPushArrayAsList,
+	[matchPushArrayAsListU] = &&lb_matchPushArrayAsListU,
+	[matchTrue] = &&lb_matchTrue,
+	[matchOr] = &&lb_matchOr,
+	[matchAnd] = &&lb_matchAnd,
+	[matchOrElse] = &&lb_matchOrElse,
+	[matchAndAlso] = &&lb_matchAndAlso,
+	[matchJump] = &&lb_matchJump,
+	[matchSelf] = &&lb_matchSelf,
+	[matchWaste] = &&lb_matchWaste,
+	[matchReturn] = &&lb_matchReturn,
+	[matchProcessDump] = &&lb_matchProcessDump,
+	[matchDisplay] = &&lb_matchDisplay,
+	[matchSetReturnTrace] = &&lb_matchSetReturnTrace,
+	[matchSetExceptionTrace] = &&lb_matchSetExceptionTrace,
+	[matchIsSeqTrace] = &&lb_matchIsSeqTrace,
+	[matchSetSeqToken] = &&lb_matchSetSeqToken,
+	[matchSetSeqTokenFake] = &&lb_matchSetSeqTokenFake,
+	[matchGetSeqToken] = &&lb_matchGetSeqToken,
+	[matchEnableTrace] = &&lb_matchEnableTrace,
+	[matchEnableTrace2] = &&lb_matchEnableTrace2,
+	[matchDisableTrace] = &&lb_matchDisableTrace,
+	[matchDisableTrace2] = &&lb_matchDisableTrace2,
+	[matchCaller] = &&lb_matchCaller,
+	[matchSilent] = &&lb_matchSilent,
+	[matchTrace2] = &&lb_matchTrace2,
+	[matchTrace3] = &&lb_matchTrace3,
+	[matchCatch] = &&lb_matchCatch,
+	[matchHalt] = &&lb_matchHalt
+    };
+#endif
 #ifdef DMC_DEBUG
     Uint *heap_fence;
     Uint *stack_fence;
@@ -1796,6 +1896,21 @@ Eterm db_prog_match(Process *c_p,
 
     ASSERT(c_p || !(in_flags & ERTS_PAM_COPY_RESULT));
 
+    if (prog->filter_arity != 0) {
+	if (!is_tuple(term)) {
+	    goto reject;
+	}
+	tp = tuple_val(term);
+	if (arityval(*tp) != prog->filter_arity) {
+	    goto reject;
+	}
+	for (i = 0; i < prog->filter_num; i++) {
+	    if (tp[prog->filter[i].ix] != prog->filter[i].value) {
+		goto reject;
+	    }
+	}
+    }
+
     mpsp = get_match_pseudo_process(c_p, prog->heap_size);
     psp = &mpsp->process;
 
@@ -1859,23 +1974,23 @@ restart:
 	save_op = *pc;
     #endif
 	switch (*pc++) {
-	case matchTryMeElse:
+	DMC_OP(matchTryMeElse):
 	    ASSERT(fail_label == -1);
 	    fail_label = *pc++;
-	    break;
-	case matchArray: /* only when DCOMP_TRACE, is always first
+	    DMC_NEXT();
+	DMC_OP(matchArray): /* only when DCOMP_TRACE, is always first
 			    instruction. */
 	    n = *pc++;
 	    if ((int) n != arity)
 		FAIL();
 	    ep = termp;
-	    break;
-	case matchArrayBind: /* When the array size is unknown. */
+	    DMC_NEXT();
+	DMC_OP(matchArrayBind): /* When the array size is unknown. */
 	    ASSERT(termp || arity==0);
 	    n = *pc++;
 	    variables[n].term = dpm_array_to_list(psp, termp, arity);
-	    break;
-	case matchTuple: /* *ep is a tuple of arity n */
+	    DMC_NEXT();
+	DMC_OP(matchTuple): /* *ep is a tuple of arity n */
 	    if (!is_tuple(*ep))
 		FAIL();
 	    ep = tuple_val(*ep);
@@ -1883,8 +1998,8 @@ restart:
 	    if (arityval(*ep) != n)
 		FAIL();
 	    ++ep;
-	    break;
-	case matchPushT: /* *ep is a tuple of arity n, 
+	    DMC_NEXT();
+	DMC_OP(matchPushT): /* *ep is a tuple of arity n, 
 			    push ptr to first element */
 	    if (!is_tuple(*ep))
 		FAIL();
@@ -1894,19 +2009,19 @@ restart:
 		FAIL();
 	    *sp++ = tp + 1;
 	    ++ep;
-	    break;
-	case matchList:
+	    DMC_NEXT();
+	DMC_OP(matchList):
 	    if (!is_list(*ep))
 		FAIL();
 	    ep = list_val(*ep);
-	    break;
-	case matchPushL:
+	    DMC_NEXT();
+	DMC_OP(matchPushL):
 	    if (!is_list(*ep))
 		FAIL();
 	    *sp++ = list_val(*ep);
 	    ++ep;
-	    break;
-        case matchMap:
+	    DMC_NEXT();
+        DMC_OP(matchMap):
             if (!is_map(*ep)) {
                 FAIL();
             }
@@ -1922,8 +2037,8 @@ restart:
 		}
 	    }
             ep = flatmap_val(*ep);
-            break;
-        case matchPushM:
+            DMC_NEXT();
+        DMC_OP(matchPushM):
             if (!is_map(*ep)) {
                 FAIL();
             }
@@ -1939,8 +2054,8 @@ restart:
 		}
 	    }
             *sp++ = flatmap_val(*ep++);
-            break;
-        case matchKey:
+            DMC_NEXT();
+        DMC_OP(matchKey):
             t = (Eterm) *pc++;
             tp = erts_maps_get(t, make_boxed(ep));
             if (!tp) {
@@ -1948,40 +2063,40 @@ restart:
             }
             *sp++ = ep;
             ep = tp;
-            break;
-	case matchPop:
+            DMC_NEXT();
+	DMC_OP(matchPop):
 	    ep = *(--sp);
-	    break;
-        case matchSwap:
+	    DMC_NEXT();
+        DMC_OP(matchSwap):
             tp = sp[-1];
             sp[-1] = sp[-2];
             sp[-2] = tp;
-            break;
-	case matchBind:
+            DMC_NEXT();
+	DMC_OP(matchBind):
 	    n = *pc++;
 	    variables[n].term = *ep++;
-	    break;
-	case matchCmp:
+	    DMC_NEXT();
+	DMC_OP(matchCmp):
 	    n = *pc++;
 	    if (!EQ(variables[n].term, *ep))
 		FAIL();
 	    ++ep;
-	    break;
-	case matchEqBin:
+	    DMC_NEXT();
+	DMC_OP(matchEqBin):
 	    t = (Eterm) *pc++;
 	    if (!EQ(t,*ep))
 		FAIL();
 	    ++ep;
-	    break;
-	case matchEqFloat:
+	    DMC_NEXT();
+	DMC_OP(matchEqFloat):
 	    if (!is_float(*ep))
 		FAIL();
 	    if (memcmp(float_val(*ep) + 1, pc, sizeof(double)))
 		FAIL();
 	    pc += TermWords(2);
 	    ++ep;
-	    break;
-	case matchEqRef: {
+	    DMC_NEXT();
+	DMC_OP(matchEqRef): {
 	    Eterm* epc = (Eterm*)pc;
 	    if (!is_ref(*ep))
 		FAIL();
@@ -1991,9 +2106,9 @@ restart:
 	    i = thing_arityval(*epc);
 	    pc += TermWords(i+1);
 	    ++ep;
-	    break;
+	    DMC_NEXT();
 	}
-	case matchEqBig:
+	DMC_OP(matchEqBig):
 	    if (!is_big(*ep))
 		FAIL();
 	    tp = big_val(*ep);
@@ -2010,20 +2125,23 @@ restart:
 		}
 	    }
 	    ++ep;
-	    break;
-	case matchEq:
+	    DMC_NEXT();
+	DMC_OP(matchEq):
 	    t = (Eterm) *pc++;
 	    ASSERT(is_immed(t));
 	    if (t != *ep++)
 		FAIL();
-	    break;
-	case matchSkip:
+	    DMC_NEXT();
+	DMC_OP(matchSkip):
 	    ++ep;
-	    break;
+	    DMC_NEXT();
+	DMC_OP(matchSkipN):
+	    ep += *pc++;
+	    DMC_NEXT();
 	/* 
 	 * Here comes guard & body instructions
 	 */
-	case matchPushC: /* Push constant */
+	DMC_OP(matchPushC): /* Push constant */
 	    if ((in_flags & ERTS_PAM_COPY_RESULT)
 		&& do_catch && !is_immed(*pc)) {
 		*esp++ = copy_object(*pc++, c_p);
@@ -2031,20 +2149,20 @@ restart:
 	    else {
 		*esp++ = *pc++;
 	    }
-	    break;
-	case matchConsA:
+	    DMC_NEXT();
+	DMC_OP(matchConsA):
 	    ehp = HAllocX(build_proc, 2, HEAP_XTRA);
 	    CDR(ehp) = *--esp;
 	    CAR(ehp) = esp[-1];
 	    esp[-1] = make_list(ehp);
-	    break;
-	case matchConsB:
+	    DMC_NEXT();
+	DMC_OP(matchConsB):
 	    ehp = HAllocX(build_proc, 2, HEAP_XTRA);
 	    CAR(ehp) = *--esp;
 	    CDR(ehp) = esp[-1];
 	    esp[-1] = make_list(ehp);
-	    break;
-	case matchMkTuple:
+	    DMC_NEXT();
+	DMC_OP(matchMkTuple):
 	    n = *pc++;
 	    ehp = HAllocX(build_proc, n+1, HEAP_XTRA);
 	    t = make_tuple(ehp);
@@ -2053,8 +2171,8 @@ restart:
 		*ehp++ = *--esp;
 	    }
 	    *esp++ = t;
-	    break;
-        case matchMkFlatMap:
+	    DMC_NEXT();
+        DMC_OP(matchMkFlatMap):
             n = *pc++;
             ehp = HAllocX(build_proc, MAP_HEADER_FLATMAP_SZ + n, HEAP_XTRA);
             t = *--esp;
@@ -2070,8 +2188,8 @@ restart:
                 *ehp++ = *--esp;
             }
             *esp++ = t;
-            break;
-        case matchMkHashMap:
+            DMC_NEXT();
+        DMC_OP(matchMkHashMap):
             n = *pc++;
             esp -= 2*n;
             ehp = HAllocX(build_proc, 2*n, HEAP_XTRA);
@@ -2086,8 +2204,8 @@ restart:
                 erts_factory_close(&factory);
             }
             *esp++ = t;
-            break;
-	case matchCall0:
+            DMC_NEXT();
+	DMC_OP(matchCall0):
 	    bif = (Eterm (*)(Process*, ...)) *pc++;
 	    t = (*bif)(build_proc, bif_args);
 	    if (is_non_value(t)) {
@@ -2097,8 +2215,8 @@ restart:
 		    FAIL();
 	    }
 	    *esp++ = t;
-	    break;
-	case matchCall1:
+	    DMC_NEXT();
+	DMC_OP(matchCall1):
 	    bif = (Eterm (*)(Process*, ...)) *pc++;
 	    t = (*bif)(build_proc, esp-1);
 	    if (is_non_value(t)) {
@@ -2108,8 +2226,8 @@ restart:
 		    FAIL();
 	    }
 	    esp[-1] = t;
-	    break;
-	case matchCall2:
+	    DMC_NEXT();
+	DMC_OP(matchCall2):
 	    bif = (Eterm (*)(Process*, ...)) *pc++;
 	    bif_args[0] = esp[-1];
 	    bif_args[1] = esp[-2];
@@ -2122,8 +2240,8 @@ restart:
 	    }
 	    --esp;
 	    esp[-1] = t;
-	    break;
-	case matchCall3:
+	    DMC_NEXT();
+	DMC_OP(matchCall3):
 	    bif = (Eterm (*)(Process*, ...)) *pc++;
 	    bif_args[0] = esp[-1];
 	    bif_args[1] = esp[-2];
@@ -2137,8 +2255,8 @@ restart:
 	    }
 	    esp -= 2;
 	    esp[-1] = t;
-	    break;
-	case matchPushVResult:
+	    DMC_NEXT();
+	DMC_OP(matchPushVResult):
 	    if (!(in_flags & ERTS_PAM_COPY_RESULT)) goto case_matchPushV;
 	    /* Build copy on callers heap */
 	    n = *pc++;
@@ -2149,14 +2267,14 @@ restart:
 	    #ifdef DEBUG
 	    variables[n].proc = c_p;
 	    #endif
-	    break;
-	case matchPushV:
+	    DMC_NEXT();
+	DMC_OP(matchPushV):
 	case_matchPushV:
 	    n = *pc++;
 	    ASSERT(is_value(variables[n].term));
 	    *esp++ = variables[n].term;
-	    break;
-	case matchPushExpr:
+	    DMC_NEXT();
+	DMC_OP(matchPushExpr):
 	    if (in_flags & ERTS_PAM_COPY_RESULT) {
 		Uint sz;
 		Eterm* top;
@@ -2173,8 +2291,8 @@ restart:
 	    else {
 		*esp = term;
 	    }
-	    break;
-	case matchPushArrayAsList:
+	    DMC_NEXT();
+	DMC_OP(matchPushArrayAsList):
 	    n = arity; /* Only happens when 'term' is an array */
 	    tp = termp;
 	    ehp = HAllocX(build_proc, n*2, HEAP_XTRA);
@@ -2187,16 +2305,16 @@ restart:
 			  had written here has undefined behaviour. */
 	    }
 	    ehp[-1] = NIL;
-	    break;
-	case matchPushArrayAsListU:
+	    DMC_NEXT();
+	DMC_OP(matchPushArrayAsListU):
 	    /* This instruction is NOT efficient. */
 	    *esp++  = dpm_array_to_list(build_proc, termp, arity);
-	    break;
-	case matchTrue:
+	    DMC_NEXT();
+	DMC_OP(matchTrue):
 	    if (*--esp != am_true)
 		FAIL();
-	    break;
-	case matchOr:
+	    DMC_NEXT();
+	DMC_OP(matchOr):
 	    n = *pc++;
 	    t = am_false;
 	    while (n--) {
@@ -2213,8 +2331,8 @@ restart:
 		}
 	    }
 	    *esp++ = t;
-	    break;
-	case matchAnd:
+	    DMC_NEXT();
+	DMC_OP(matchAnd):
 	    n = *pc++;
 	    t = am_true;
 	    while (n--) {
@@ -2231,8 +2349,8 @@ restart:
 		}
 	    }
 	    *esp++ = t;
-	    break;
-	case matchOrElse:
+	    DMC_NEXT();
+	DMC_OP(matchOrElse):
 	    n = *pc++;
 	    if (*--esp == am_true) {
 		++esp;
@@ -2245,8 +2363,8 @@ restart:
 		    FAIL();
 		}
 	    }
-	    break;
-	case matchAndAlso:
+	    DMC_NEXT();
+	DMC_OP(matchAndAlso):
 	    n = *pc++;
 	    if (*--esp == am_false) {
 		esp++;
@@ -2259,49 +2377,49 @@ restart:
 		    FAIL();
 		}
 	    }
-	    break;
-	case matchJump:
+	    DMC_NEXT();
+	DMC_OP(matchJump):
 	    n = *pc++;
 	    pc += n;
-	    break;
-	case matchSelf:
+	    DMC_NEXT();
+	DMC_OP(matchSelf):
 	    *esp++ = self->common.id;
-	    break;
-	case matchWaste:
+	    DMC_NEXT();
+	DMC_OP(matchWaste):
 	    --esp;
-	    break;
-	case matchReturn:
+	    DMC_NEXT();
+	DMC_OP(matchReturn):
 	    ret = *--esp;
-	    break;
-	case matchProcessDump: {
+	    DMC_NEXT();
+	DMC_OP(matchProcessDump): {
 	    erts_dsprintf_buf_t *dsbufp = erts_create_tmp_dsbuf(0);
             ASSERT(c_p == self);
 	    print_process_info(ERTS_PRINT_DSBUF, (void *) dsbufp, c_p);
 	    *esp++ = new_binary(build_proc, (byte *)dsbufp->str,
 				dsbufp->str_len);
 	    erts_destroy_tmp_dsbuf(dsbufp);
-	    break;
+	    DMC_NEXT();
 	}
-	case matchDisplay: /* Debugging, not for production! */
+	DMC_OP(matchDisplay): /* Debugging, not for production! */
 	    erts_printf("%T\n", esp[-1]);
 	    esp[-1] = am_true;
-	    break;
-	case matchSetReturnTrace:
+	    DMC_NEXT();
+	DMC_OP(matchSetReturnTrace):
 	    *return_flags |= MATCH_SET_RETURN_TRACE;
 	    *esp++ = am_true;
-	    break;
-	case matchSetExceptionTrace:
+	    DMC_NEXT();
+	DMC_OP(matchSetExceptionTrace):
 	    *return_flags |= MATCH_SET_EXCEPTION_TRACE;
 	    *esp++ = am_true;
-	    break;
-        case matchIsSeqTrace:
+	    DMC_NEXT();
+        DMC_OP(matchIsSeqTrace):
             ASSERT(c_p == self);
             if (have_seqtrace(SEQ_TRACE_TOKEN(c_p)))
 		*esp++ = am_true;
 	    else
 		*esp++ = am_false;
-	    break;
-	case matchSetSeqToken:
+	    DMC_NEXT();
+	DMC_OP(matchSetSeqToken):
             ASSERT(c_p == self);
             t = erts_seq_trace(c_p, esp[-1], esp[-2], 0);
 	    if (is_non_value(t)) {
@@ -2310,8 +2428,8 @@ restart:
 		esp[-2] = t;
 	    }
 	    --esp;
-	    break;
-        case matchSetSeqTokenFake:
+	    DMC_NEXT();
+        DMC_OP(matchSetSeqTokenFake):
             ASSERT(c_p == self);
 	    t = seq_trace_fake(c_p, esp[-1]);
 	    if (is_non_value(t)) {
@@ -2320,8 +2438,8 @@ restart:
 		esp[-2] = t;
 	    }
 	    --esp;
-	    break;
-        case matchGetSeqToken:
+	    DMC_NEXT();
+        DMC_OP(matchGetSeqToken):
             ASSERT(c_p == self);
             if (have_no_seqtrace(SEQ_TRACE_TOKEN(c_p)))
 		*esp++ = NIL;
@@ -2345,8 +2463,8 @@ restart:
 		ASSERT(is_immed(ehp[3]));
 		ASSERT(is_immed(ehp[5]));
 	    } 
-	    break;
-        case matchEnableTrace:
+	    DMC_NEXT();
+        DMC_OP(matchEnableTrace):
             ASSERT(c_p == self);
 	    if ( (n = erts_trace_flag2bit(esp[-1]))) {
                 erts_smp_proc_lock(c_p, ERTS_PROC_LOCKS_ALL_MINOR);
@@ -2356,8 +2474,8 @@ restart:
 	    } else {
 		esp[-1] = FAIL_TERM;
 	    }
-	    break;
-        case matchEnableTrace2:
+	    DMC_NEXT();
+        DMC_OP(matchEnableTrace2):
             ASSERT(c_p == self);
 	    n = erts_trace_flag2bit((--esp)[-1]);
 	    esp[-1] = FAIL_TERM;
@@ -2372,8 +2490,8 @@ restart:
                     esp[-1] = am_true;
 		}
 	    }
-	    break;
-        case matchDisableTrace:
+	    DMC_NEXT();
+        DMC_OP(matchDisableTrace):
             ASSERT(c_p == self);
 	    if ( (n = erts_trace_flag2bit(esp[-1]))) {
                 erts_smp_proc_lock(c_p, ERTS_PROC_LOCKS_ALL_MINOR);
@@ -2383,8 +2501,8 @@ restart:
 	    } else {
 		esp[-1] = FAIL_TERM;
 	    }
-	    break;
-        case matchDisableTrace2:
+	    DMC_NEXT();
+        DMC_OP(matchDisableTrace2):
             ASSERT(c_p == self);
 	    n = erts_trace_flag2bit((--esp)[-1]);
 	    esp[-1] = FAIL_TERM;
@@ -2399,8 +2517,8 @@ restart:
                     esp[-1] = am_true;
 		}
 	    }
-	    break;
-        case matchCaller:
+	    DMC_NEXT();
+        DMC_OP(matchCaller):
             ASSERT(c_p == self);
 	    if (!(c_p->cp) || !(cp = find_function_from_pc(c_p->cp))) {
  		*esp++ = am_undefined;
@@ -2412,12 +2530,12 @@ restart:
 		ehp[2] = cp[1];
 		ehp[3] = make_small((Uint) cp[2]);
 	    }
-	    break;
-        case matchSilent:
+	    DMC_NEXT();
+        DMC_OP(matchSilent):
             ASSERT(c_p == self);
 	    --esp;
 	    if (in_flags & ERTS_PAM_IGNORE_TRACE_SILENT)
-	      break;
+	      DMC_NEXT();
 	    if (*esp == am_true) {
 		erts_smp_proc_lock(c_p, ERTS_PROC_LOCKS_ALL_MINOR);
 		ERTS_TRACE_FLAGS(c_p) |= F_TRACE_SILENT;
@@ -2428,8 +2546,8 @@ restart:
 		ERTS_TRACE_FLAGS(c_p) &= ~F_TRACE_SILENT;
 		erts_smp_proc_unlock(c_p, ERTS_PROC_LOCKS_ALL_MINOR);
 	    }
-	    break;
-        case matchTrace2:
+	    DMC_NEXT();
+        DMC_OP(matchTrace2):
             ASSERT(c_p == self);
 	    {
 		/*    disable         enable                                */
@@ -2453,7 +2571,7 @@ restart:
 		    cputs ) {
 		    (--esp)[-1] = FAIL_TERM;
                     ERTS_TRACER_CLEAR(&tracer);
-		    break;
+		    DMC_NEXT();
 		}
 		erts_smp_proc_lock(c_p, ERTS_PROC_LOCKS_ALL_MINOR);
 		(--esp)[-1] = set_match_trace(c_p, FAIL_TERM, tracer,
@@ -2461,8 +2579,8 @@ restart:
 		erts_smp_proc_unlock(c_p, ERTS_PROC_LOCKS_ALL_MINOR);
                 ERTS_TRACER_CLEAR(&tracer);
 	    }
-	    break;
-        case matchTrace3:
+	    DMC_NEXT();
+        DMC_OP(matchTrace3):
             ASSERT(c_p == self);
 	    {
 		/*    disable         enable                                */
@@ -2483,7 +2601,7 @@ restart:
 				       tracee, ERTS_PROC_LOCKS_ALL))) {
 		    (--esp)[-1] = FAIL_TERM;
                     ERTS_TRACER_CLEAR(&tracer);
-		    break;
+		    DMC_NEXT();
 		}
 		if (tmpp == c_p) {
 		    (--esp)[-1] = set_match_trace(c_p, FAIL_TERM, tracer,
@@ -2498,15 +2616,15 @@ restart:
 		}
                 ERTS_TRACER_CLEAR(&tracer);
 	    }
-	    break;
-	case matchCatch:  /* Match success, now build result */
+	    DMC_NEXT();
+	DMC_OP(matchCatch):  /* Match success, now build result */
 	    do_catch = 1;
 	    if (in_flags & ERTS_PAM_COPY_RESULT) {
 		build_proc = c_p;
 		esdp->current_process = c_p;
 	    }
-	    break;
-	case matchHalt:
+	    DMC_NEXT();
+	DMC_OP(matchHalt):
 	    goto success;
 	default:
 	    erts_exit(ERTS_ERROR_EXIT, "Internal error: unexpected opcode in match program.");
@@ -2540,6 +2658,10 @@ success:
         esdp->current_process = current_scheduled;
 
     return ret;
+
+reject:
+    *return_flags = 0U;
+    return THE_NON_VALUE;
 #undef FAIL
 #undef FAIL_TERM
 }
@@ -2788,7 +2910,13 @@ void db_free_term(DbTable *tb, void* basep, Uint offset)
 {
     DbTerm* db = (DbTerm*) ((byte*)basep + offset);
     Uint size;
-    if (tb->common.compress) {
+    if (DB_IS_LITERAL_TERM(&tb->common, db)) {
+	size = offset + offsetof(DbTerm,tpl) + db->size*sizeof(Eterm);
+	erts_db_release_literal(tb, basep, size, db->tpl, db->size,
+				db->first_oh);
+	return;
+    }
+    else if (tb->common.compress) {
 	db_cleanup_offheap_comp(db);
 	size = db_alloced_size_comp(db);
     }
@@ -2900,7 +3028,26 @@ void* db_store_term(DbTableCommon *tb, DbTerm* old, Uint offset, Eterm obj)
     int size = size_object(obj);
     ErlOffHeap tmp_offheap;
 
-    if (old != 0) {
+    if (tb->literal) {
+	/*
+	 * Processes may refer the old object, so it is never
+	 * reused. The header preceding the DbTerm is kept. If the
+	 * literal area is exhausted the object is stored as in an
+	 * ordinary table, and is then copied on lookup.
+	 */
+	Uint new_sz = offset + sizeof(DbTerm) + sizeof(Eterm)*(size-1);
+	basep = erts_db_alloc_fnf(ERTS_ALC_T_DB_LITERAL_TERM, (DbTable *)tb,
+				  new_sz);
+	if (!basep)
+	    basep = erts_db_alloc(ERTS_ALC_T_DB_TERM, (DbTable *)tb, new_sz);
+	if (old != 0) {
+	    byte* old_basep = ((byte*) old) - offset;
+	    sys_memcpy(basep, old_basep, offset);
+	    db_free_term((DbTable *)tb, old_basep, offset);
+	}
+	newp = (DbTerm*) (basep + offset);
+    }
+    else if (old != 0) {
 	basep = ((byte*) old) - offset;
 	tmp_offheap.first  = old->first_oh;
 	erts_cleanup_offheap(&tmp_offheap);
@@ -3056,7 +3203,7 @@ Eterm db_copy_element_from_ets(DbTableCommon* tb, Process* p,
 			       DbTerm* obj, Uint pos,
 			       Eterm** hpp, Uint extra)
 {
-    if (is_immed(obj->tpl[pos])) {
+    if (is_immed(obj->tpl[pos]) || DB_IS_LITERAL_TERM(tb, obj)) {
 	*hpp = HAlloc(p, extra);
 	return obj->tpl[pos];
     }
@@ -3273,10 +3420,106 @@ int erts_db_is_compiled_ms(Eterm term)
 	    && IsMatchProgBinary((((ProcBin *) binary_val(term))->val)));
 }
 
+int erts_db_match_set_fused_heads(int enable)
+{
+    int old = dmc_fused_heads;
+    dmc_fused_heads = enable;
+    return old;
+}
+
 /* 
 ** Local (static) utilities.
 */
 
+/*
+** Size in words of a head matching instruction
+*/
+static Uint dmc_head_instr_size(const UWord *pc)
+{
+    switch (*pc) {
+    case matchEqFloat:
+	return 1 + TermWords(2);
+    case matchEqRef:
+	return 1 + TermWords(thing_arityval(pc[1]) + 1);
+    case matchEqBig:
+	return 1 + TermWords(BIG_ARITY((Eterm *) (pc + 1)) + 1);
+    case matchPushL:
+    case matchList:
+    case matchPop:
+    case matchSwap:
+    case matchSkip:
+	return 1;
+    default:
+	return 2;
+    }
+}
+
+/*
+** Rewrite the head of a clause (text[start..end)) in place. Runs of
+** matchSkip become one matchSkipN, and skips are dropped altogether
+** when followed by matchPop or the end of the head, as the position
+** is not used after that. Returns the new end of the head.
+*/
+static Uint dmc_fuse_head(UWord *text, Uint start, Uint end)
+{
+    Uint r = start, w = start;
+    Uint n;
+
+    while (r < end) {
+	if (text[r] == matchSkip) {
+	    for (n = 0; r < end && text[r] == matchSkip; ++r) {
+		++n;
+	    }
+	    if (r == end || text[r] == matchPop) {
+		continue;
+	    }
+	    if (n == 1) {
+		text[w++] = matchSkip;
+	    } else {
+		text[w++] = matchSkipN;
+		text[w++] = n;
+	    }
+	} else {
+	    n = dmc_head_instr_size(text + r);
+	    while (n--) {
+		text[w++] = text[r++];
+	    }
+	}
+    }
+    return w;
+}
+
+/*
+** Set up the head filter of a single clause program, i.e. the arity
+** and the immediate elements of a tuple head, which db_prog_match()
+** checks before anything else. The top level elements are the
+** instructions up to the first matchPop.
+*/
+static void dmc_head_filter(MatchProg *prog, Uint head_end)
+{
+    const UWord *pc = prog->text;
+    const UWord *end = prog->text + head_end;
+    Uint ix;
+
+    if (pc >= end || *pc != matchTuple || pc[1] == 0) {
+	return;
+    }
+    prog->filter_arity = pc[1];
+    pc += 2;
+    for (ix = 1; pc < end && *pc != matchPop; pc += dmc_head_instr_size(pc)) {
+	if (*pc == matchSkipN) {
+	    ix += pc[1];
+	    continue;
+	}
+	if (*pc == matchEq && prog->filter_num < DMC_HEAD_FILTER_SIZE) {
+	    prog->filter[prog->filter_num].ix = ix;
+	    prog->filter[prog->filter_num].value = (Eterm) pc[1];
+	    ++prog->filter_num;
+	}
+	++ix;
+    }
+}
+
 /*
 ***************************************************************************
 ** Compiled matches 
@@ -5360,6 +5603,12 @@ void db_match_dis(Binary *bp)
 	    ++t;
 	    erts_printf("Skip\n");
 	    break;
+	case matchSkipN:
+	    ++t;
+	    n = *t;
+	    ++t;
+	    erts_printf("SkipN\t%beu\n", n);
+	    break;
 	case matchPushC:
 	    ++t;
 	    p = (Eterm) *t;
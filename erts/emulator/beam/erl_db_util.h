@@ -202,6 +202,30 @@ typedef struct db_fixation {
     struct db_fixation *next;
 } DbFixation;
 
+/*
+ * Shards of the item and memory counters of a table created with
+ * {decentralized_counters,true}. There is one shard per scheduler
+ * plus one more; dirty schedulers and other threads hash to any of
+ * them. Each shard is on its own cache line, so that updates made by
+ * different schedulers do not compete for the same cache line. The
+ * true values are the sums over all shards.
+ */
+typedef union {
+    struct {
+	erts_smp_atomic_t nitems;      /* Items added minus items removed */
+	erts_smp_atomic_t memory_size; /* Bytes allocated minus bytes freed */
+	erts_smp_atomic_t nupdates;    /* Updates since table creation */
+    } c;
+    byte _cache_line_alignment[ERTS_ALC_CACHE_LINE_ALIGN_SIZE(
+	    3*sizeof(erts_smp_atomic_t))];
+} DbTableCounterShard;
+
+typedef struct db_table_counters {
+    DbTableCounterShard *shard; /* Cache line aligned, in the same block */
+    int nshards;
+    Uint alloc_size;
+} DbTableCounters;
+
 /*
  * This structure contains data for all different types of database
  * tables. Note that these fields must match the same fields
@@ -227,6 +251,8 @@ typedef struct db_table_common {
     DbTableMethod* meth;      /* table methods */
     erts_smp_atomic_t nitems; /* Total number of items in table */
     erts_smp_atomic_t memory_size;/* Total memory size. NOTE: in bytes! */
+    DbTableCounters* counters;/* Shards of nitems and memory_size,
+				 NULL unless decentralized_counters */
     struct {                  /* Last fixation time */
 	ErtsMonotonicTime monotonic;
 	ErtsMonotonicTime offset;
@@ -238,6 +264,7 @@ typedef struct db_table_common {
     int slot;                 /* slot index in meta_main_tab */
     int keypos;               /* defaults to 1 */
     int compress;
+    int literal;              /* Objects are stored as literals */
 } DbTableCommon;
 
 /* These are status bit patterns */
@@ -253,8 +280,9 @@ typedef struct db_table_common {
 #define DB_ORDERED_SET   (1 << 9)
 #define DB_DELETE        (1 << 10) /* table is being deleted */
 #define DB_FREQ_READ     (1 << 11)
+#define DB_CA_ORDERED_SET (1 << 12) /* ordered_set implemented as CA tree */
 
-#define ERTS_ETS_TABLE_TYPES (DB_BAG|DB_SET|DB_DUPLICATE_BAG|DB_ORDERED_SET|DB_FINE_LOCKED|DB_FREQ_READ)
+#define ERTS_ETS_TABLE_TYPES (DB_BAG|DB_SET|DB_DUPLICATE_BAG|DB_ORDERED_SET|DB_CA_ORDERED_SET|DB_FINE_LOCKED|DB_FREQ_READ)
 
 #define IS_HASH_TABLE(Status) (!!((Status) & \
 				  (DB_BAG | DB_SET | DB_DUPLICATE_BAG)))
@@ -269,6 +297,24 @@ typedef struct db_table_common {
  */
 #define GETKEY(dth, tplp)   (*((tplp) + ((DbTableCommon*)(dth))->keypos))
 
+/*
+ * Is the object stored in the literal area? Objects of literal tables
+ * are, unless the literal area was exhausted when they were stored.
+ */
+#ifdef ERTS_HAVE_IS_IN_LITERAL_RANGE
+#define DB_IS_LITERAL_TERM(tb, dbterm) \
+    (((DbTableCommon*)(tb))->literal && erts_is_in_literal_range((dbterm)->tpl))
+#else
+#define DB_IS_LITERAL_TERM(tb, dbterm) 0
+#endif
+
+/*
+ * Heap size needed by db_copy_object_from_ets(). Objects in the
+ * literal area are not copied at all.
+ */
+#define DB_COPY_OBJECT_SIZE(tb, dbterm) \
+    (DB_IS_LITERAL_TERM((tb), (dbterm)) ? 0 : (dbterm)->size)
+
 
 ERTS_GLB_INLINE Eterm db_copy_key(Process* p, DbTable* tb, DbTerm* obj);
 Eterm db_copy_from_comp(DbTableCommon* tb, DbTerm* bp, Eterm** hpp,
@@ -299,7 +345,10 @@ ERTS_GLB_INLINE Eterm db_copy_key(Process* p, DbTable* tb, DbTerm* obj)
 ERTS_GLB_INLINE Eterm db_copy_object_from_ets(DbTableCommon* tb, DbTerm* bp,
 					      Eterm** hpp, ErlOffHeap* off_heap)
 {
-    if (tb->compress) {
+    if (DB_IS_LITERAL_TERM(tb, bp)) {
+	return make_tuple(bp->tpl);
+    }
+    else if (tb->compress) {
 	return db_copy_from_comp(tb, bp, hpp, off_heap);
     }
     else {
@@ -357,6 +406,12 @@ Binary *db_match_set_compile(Process *p, Eterm matchexpr,
 			     Uint flags);
 void erts_db_match_prog_destructor(Binary *);
 
+/*
+ * Number of constant elements of a tuple head that are checked
+ * before the match program is started.
+ */
+#define DMC_HEAD_FILTER_SIZE 4
+
 typedef struct match_prog {
     ErlHeapFragment *term_save; /* Only if needed, a list of message 
 				    buffers for off heap copies 
@@ -369,6 +424,14 @@ typedef struct match_prog {
     Eterm saved_program;
     Uint heap_size;          /* size of: heap + eheap + stack */
     Uint stack_offset;
+    /* Quick rejection of objects that cannot match a single clause
+       tuple head, only used if filter_arity != 0 */
+    Uint filter_arity;
+    int filter_num;
+    struct {
+	Uint ix;
+	Eterm value;
+    } filter[DMC_HEAD_FILTER_SIZE];
 #ifdef DMC_DEBUG
     UWord* prog_end;		/* End of program */
 #endif
@@ -460,6 +523,9 @@ Eterm db_make_mp_binary(Process *p, Binary *mp, Eterm **hpp);
 /* Convert a match program to a erlang "magic" binary to be returned to userspace,
    increments the reference counter. */
 int erts_db_is_compiled_ms(Eterm term);
+/* Turns the head optimizations of db_match_compile() on or off, returns
+   the previous setting. */
+int erts_db_match_set_fused_heads(int enable);
 
 /*
 ** Convenience when compiling into Binary structures
@@ -109,6 +109,7 @@ typedef struct {
 } Rootset;
 
 static Uint setup_rootset(Process*, Eterm*, int, Rootset*);
+static void collect_literal_areas(Process* p, ErtsLiteralArea **areas, Uint n);
 static void cleanup_rootset(Rootset *rootset);
 static void remove_message_buffers(Process* p);
 static Eterm *full_sweep_heaps(Process *p,
@@ -166,6 +167,7 @@ static Sint heap_sizes[MAX_HEAP_SIZES];	/* Suitable heap sizes. */
 static int num_heap_sizes;	/* Number of heap sizes. */
 
 Uint erts_test_long_gc_sleep; /* Only used for testing... */
+Uint erts_dirty_gc_heap_size = ERTS_DIRTY_GC_DEFAULT_HEAP_SIZE;
 
 typedef struct {
     Process *proc;
@@ -551,6 +553,27 @@ young_gen_usage(Process *p)
     return hsz;
 }
 
+#ifdef ERTS_DIRTY_SCHEDULERS
+/*
+ * Should a major collection be moved from the ordinary scheduler
+ * we are executing on to a dirty cpu scheduler? The collection is
+ * then delayed, and the process keeps running on a heap fragment
+ * until it is scheduled out.
+ */
+static ERTS_INLINE int
+dirty_major_gc(Process *p)
+{
+    Uint size;
+
+    if (erts_dirty_gc_heap_size == 0 || erts_no_dirty_cpu_schedulers == 0)
+	return 0;
+    size = young_gen_usage(p) + (p->hend - p->stop);
+    if (OLD_HEAP(p))
+	size += OLD_HTOP(p) - OLD_HEAP(p);
+    return size >= erts_dirty_gc_heap_size;
+}
+#endif
+
 #define ERTS_GET_ORIG_HEAP(Proc, Heap, HTop)			\
     do {							\
 	Eterm *aheap__ = (Proc)->abandoned_heap;		\
@@ -598,6 +621,20 @@ garbage_collect(Process* p, ErlHeapFragment *live_hf_end,
     if (p->flags & (F_DISABLE_GC|F_DELAY_GC) || state & ERTS_PSFLG_EXITING)
 	return delay_garbage_collection(p, live_hf_end, need, fcalls);
 
+    esdp = erts_get_scheduler_data();
+
+#ifdef ERTS_DIRTY_SCHEDULERS
+    /*
+     * System tasks (check_process_code et al) depend on the collection
+     * being done when we return, so these always collect right here.
+     */
+    if ((p->flags & F_DIRTY_MAJOR_GC) && !ERTS_SCHEDULER_IS_DIRTY(esdp)
+	&& !(state & ERTS_PSFLG_RUNNING_SYS)) {
+	/* Already waiting for a dirty major collection */
+	return delay_garbage_collection(p, live_hf_end, need, fcalls);
+    }
+#endif
+
     if (p->abandoned_heap)
 	live_hf_end = ERTS_INVALID_HFRAG_PTR;
     else if (p->live_hf_end != ERTS_INVALID_HFRAG_PTR)
@@ -605,8 +642,6 @@ garbage_collect(Process* p, ErlHeapFragment *live_hf_end,
 
     ERTS_MSACC_SET_STATE_CACHED_M(ERTS_MSACC_STATE_GC);
 
-    esdp = erts_get_scheduler_data();
-
     erts_smp_atomic32_read_bor_nob(&p->state, ERTS_PSFLG_GC);
     if (erts_system_monitor_long_gc != 0)
 	start_time = erts_get_monotonic_time(esdp);
@@ -644,6 +679,23 @@ garbage_collect(Process* p, ErlHeapFragment *live_hf_end,
         gc_trace_end_tag = am_gc_minor_end;
     } else {
 do_major_collection:
+#ifdef ERTS_DIRTY_SCHEDULERS
+        if (!ERTS_SCHEDULER_IS_DIRTY(esdp)
+            && !(state & ERTS_PSFLG_RUNNING_SYS)
+            && dirty_major_gc(p)) {
+            /*
+             * Copying this heap would stall the scheduler for too
+             * long; let a dirty cpu scheduler do it instead...
+             */
+            int res;
+            erts_smp_atomic32_read_band_nob(&p->state, ~ERTS_PSFLG_GC);
+            FLAGS(p) |= F_DIRTY_MAJOR_GC|F_NEED_FULLSWEEP;
+            erts_schedule_dirty_sys_execution(p);
+            res = delay_garbage_collection(p, live_hf_end, need, fcalls);
+            ERTS_MSACC_POP_STATE_M();
+            return res;
+        }
+#endif
         ERTS_MSACC_SET_STATE_CACHED_M_X(ERTS_MSACC_STATE_GC_FULL);
         if (IS_TRACED_FL(p, F_TRACE_GC)) {
             trace_gc(p, am_gc_major_start, need, THE_NON_VALUE);
@@ -942,16 +994,152 @@ erts_garbage_collect_literals(Process* p, Eterm* literals,
 			      Uint byte_lit_size,
 			      struct erl_off_heap_header* oh)
 {
-    Uint lit_size = byte_lit_size / sizeof(Eterm);
+    ErtsLiteralArea la, *lap = &la;
+
+    la.start = literals;
+    la.size = byte_lit_size / sizeof(Eterm);
+    la.off_heap = oh;
+    collect_literal_areas(p, &lap, 1);
+}
+
+static ERTS_INLINE void
+mark_literal_area(ErtsLiteralArea **areas, Uint n, char *used, Eterm *ptr)
+{
+    Uint lo = 0, hi = n;
+
+    while (lo < hi) {
+	Uint mid = (lo + hi) / 2;
+	if (ptr < areas[mid]->start)
+	    hi = mid;
+	else if (ptr >= areas[mid]->start + areas[mid]->size)
+	    lo = mid + 1;
+	else {
+	    used[mid] = 1;
+	    return;
+	}
+    }
+}
+
+static void
+mark_literal_area_ptrs(Eterm *start, Uint sz, char *area, Uint area_size,
+		       ErtsLiteralArea **areas, Uint n, char *used)
+{
+    Eterm *p;
+
+    for (p = start; p < start + sz; p++) {
+	Eterm val = *p;
+	switch (primary_tag(val)) {
+	case TAG_PRIMARY_BOXED:
+	case TAG_PRIMARY_LIST:
+	    if (ErtsInArea(ptr_val(val), area, area_size))
+		mark_literal_area(areas, n, used, ptr_val(val));
+	    break;
+	default:
+	    break;
+	}
+    }
+}
+
+static void
+mark_literal_area_heap(Eterm *start, Eterm *end, char *area, Uint area_size,
+		       ErtsLiteralArea **areas, Uint n, char *used)
+{
+    Eterm *p;
+
+    for (p = start; p < end; p++) {
+	Eterm val = *p;
+	switch (primary_tag(val)) {
+	case TAG_PRIMARY_BOXED:
+	case TAG_PRIMARY_LIST:
+	    if (ErtsInArea(ptr_val(val), area, area_size))
+		mark_literal_area(areas, n, used, ptr_val(val));
+	    break;
+	case TAG_PRIMARY_HEADER:
+	    if (!header_is_transparent(val)) {
+		if (header_is_bin_matchstate(val)) {
+		    ErlBinMatchState *ms = (ErlBinMatchState*) p;
+		    Eterm orig = ms->mb.orig;
+		    if (ErtsInArea(ptr_val(orig), area, area_size))
+			mark_literal_area(areas, n, used, ptr_val(orig));
+		}
+		p += thing_arityval(val);
+	    }
+	    break;
+	}
+    }
+}
+
+/*
+ * Garbage collect literals referred by the process in any of the
+ * 'n' literal areas in 'areas', sorted on start address. Only the
+ * areas actually referred are copied. As for
+ * erts_garbage_collect_literals(), the caller has to have done a
+ * major collection first. Returns the number of words in the areas
+ * that were copied.
+ */
+Uint
+erts_garbage_collect_literal_areas(Process *p, ErtsLiteralArea **areas,
+				   Uint n)
+{
+    Rootset rootset;
+    Roots *roots;
+    char *area;
+    Uint area_size, i, j, nroots, words = 0;
+    char *used;
+    ErtsLiteralArea **refd;
+
+    if (n == 0 || (p->flags & F_DISABLE_GC))
+	return 0;
+
+    ASSERT(p->old_heap == 0);
+
+    area = (char *) areas[0]->start;
+    area_size = (char *) (areas[n-1]->start + areas[n-1]->size) - area;
+    used = erts_alloc(ERTS_ALC_T_TMP, n);
+    sys_memzero(used, n);
+
+    nroots = setup_rootset(p, p->arg_reg, p->arity, &rootset);
+    for (roots = rootset.roots; nroots--; roots++)
+	mark_literal_area_ptrs(roots->v, roots->sz, area, area_size,
+			       areas, n, used);
+    cleanup_rootset(&rootset);
+#ifdef HIPE
+    if (p->hipe.nstack)
+	mark_literal_area_ptrs(hipe_nstack_start(p), hipe_nstack_used(p),
+			       area, area_size, areas, n, used);
+#endif
+    mark_literal_area_heap(p->heap, p->htop, area, area_size,
+			   areas, n, used);
+
+    refd = erts_alloc(ERTS_ALC_T_TMP, n * sizeof(ErtsLiteralArea *));
+    for (i = 0, j = 0; i < n; i++) {
+	if (used[i]) {
+	    refd[j++] = areas[i];
+	    words += areas[i]->size;
+	}
+    }
+    if (j > 0)
+	collect_literal_areas(p, refd, j);
+    erts_free(ERTS_ALC_T_TMP, refd);
+    erts_free(ERTS_ALC_T_TMP, used);
+    return words;
+}
+
+static void
+collect_literal_areas(Process* p, ErtsLiteralArea **areas, Uint n)
+{
+    Uint lit_size, byte_lit_size;
     Uint old_heap_size;
     Eterm* temp_lit;
-    Sint offs;
+    Eterm* tp;
+    struct erl_off_heap_header** ohs;
+    struct erl_off_heap_header* oh;
     Rootset rootset;            /* Rootset for GC (stack, dictionary, etc). */
     Roots* roots;
     char* area;
     Uint area_size;
     Eterm* old_htop;
-    Uint n;
+    Uint i, n_roots;
     struct erl_off_heap_header** prev = NULL;
 
     if (p->flags & F_DISABLE_GC)
@@ -961,6 +1149,11 @@ erts_garbage_collect_literals(Process* p, Eterm* literals,
      */
     erts_smp_atomic32_read_bor_nob(&p->state, ERTS_PSFLG_GC);
 
+    lit_size = 0;
+    for (i = 0; i < n; i++)
+	lit_size += areas[i]->size;
+    byte_lit_size = lit_size * sizeof(Eterm);
+
     /*
      * We assume that the caller has already done a major collection
      * (which has discarded the old heap), so that we don't have to cope
@@ -977,16 +1170,28 @@ erts_garbage_collect_literals(Process* p, Eterm* literals,
     /*
      * We soon want to garbage collect the literals. But since a GC is
      * destructive (MOVED markers are written), we must copy the literals
-     * to a temporary area and change all references to literals.
+     * to a temporary area and change all references to literals. The
+     * areas are placed after each other in the temporary area, each
+     * one with its own offset.
      */
     temp_lit = (Eterm *) erts_alloc(ERTS_ALC_T_TMP, byte_lit_size);
-    sys_memcpy(temp_lit, literals, byte_lit_size);
-    offs = temp_lit - literals;
-    offset_heap(temp_lit, lit_size, offs, (char *) literals, byte_lit_size);
-    offset_heap(p->heap, p->htop - p->heap, offs, (char *) literals, byte_lit_size);
-    offset_rootset(p, offs, (char *) literals, byte_lit_size, p->arg_reg, p->arity);
-    if (oh) {
-	oh = (struct erl_off_heap_header *) ((Eterm *)(void *) oh + offs);
+    ohs = erts_alloc(ERTS_ALC_T_TMP, n * sizeof(struct erl_off_heap_header*));
+    tp = temp_lit;
+    for (i = 0; i < n; i++) {
+	Eterm *literals = areas[i]->start;
+	Uint sz = areas[i]->size;
+	Sint offs = tp - literals;
+
+	sys_memcpy(tp, literals, sz * sizeof(Eterm));
+	offset_heap(tp, sz, offs, (char *) literals, sz * sizeof(Eterm));
+	offset_heap(p->heap, p->htop - p->heap, offs,
+		    (char *) literals, sz * sizeof(Eterm));
+	offset_rootset(p, offs, (char *) literals, sz * sizeof(Eterm),
+		       p->arg_reg, p->arity);
+	oh = areas[i]->off_heap;
+	ohs[i] = oh ? (struct erl_off_heap_header *) ((Eterm *)(void *) oh + offs)
+		    : NULL;
+	tp += sz;
     }
 
     /*
@@ -997,10 +1202,10 @@ erts_garbage_collect_literals(Process* p, Eterm* literals,
 
     area = (char *) temp_lit;
     area_size = byte_lit_size;
-    n = setup_rootset(p, p->arg_reg, p->arity, &rootset);
+    n_roots = setup_rootset(p, p->arg_reg, p->arity, &rootset);
     roots = rootset.roots;
     old_htop = sweep_literals_nstack(p, p->old_htop, area, area_size);
-    while (n--) {
+    while (n_roots--) {
         Eterm* g_ptr = roots->v;
         Uint g_sz = roots->sz;
 	Eterm* ptr;
@@ -1062,46 +1267,53 @@ erts_garbage_collect_literals(Process* p, Eterm* literals,
      * current MSO list and use that as a starting point.
      */
 
-    if (oh) {
-        prev = &MSO(p).first;
-        while (*prev) {
-            prev = &(*prev)->next;
-        }
+    prev = &MSO(p).first;
+    while (*prev) {
+	prev = &(*prev)->next;
     }
 
     /*
      * Sweep through all binaries in the temporary literal area.
      */
 
-    while (oh) {
+    for (i = 0; i < n; i++) {
+      for (oh = ohs[i]; oh; oh = oh->next) {
 	if (IS_MOVED_BOXED(oh->thing_word)) {
-	    Binary* bptr;
 	    struct erl_off_heap_header* ptr;
 
 	    ptr = (struct erl_off_heap_header*) boxed_val(oh->thing_word);
-	    ASSERT(thing_subtag(ptr->thing_word) == REFC_BINARY_SUBTAG);
-	    bptr = ((ProcBin*)ptr)->val;
 
 	    /*
-	     * This binary has been copied to the heap.
-	     * We must increment its reference count and
-	     * link it into the MSO list for the process.
+	     * This binary (or, in a literal area not belonging
+	     * to a module, fun or external term) has been copied
+	     * to the heap. We must increment its reference count
+	     * and link it into the MSO list for the process.
 	     */
 
-	    erts_refc_inc(&bptr->refc, 1);
+	    switch (thing_subtag(ptr->thing_word)) {
+	    case REFC_BINARY_SUBTAG:
+		erts_refc_inc(&((ProcBin*)ptr)->val->refc, 1);
+		break;
+	    case FUN_SUBTAG:
+		erts_refc_inc(&((ErlFunThing*)ptr)->fe->refc, 1);
+		break;
+	    default:
+		ASSERT(is_external_header(ptr->thing_word));
+		erts_refc_inc(&((ExternalThing*)ptr)->node->refc, 1);
+		break;
+	    }
 	    *prev = ptr;
 	    prev = &ptr->next;
 	}
-	oh = oh->next;
+      }
     }
 
-    if (prev) {
-        *prev = NULL;
-    }
+    *prev = NULL;
 
     /*
      * We no longer need this temporary area.
      */
+    erts_free(ERTS_ALC_T_TMP, (void *) ohs);
     erts_free(ERTS_ALC_T_TMP, (void *) temp_lit);
 
     /*
@@ -127,6 +127,13 @@ ERTS_GLB_INLINE Eterm follow_moved(Eterm term, Eterm xptr_tag)
 
 extern Uint erts_test_long_gc_sleep;
 
+/*
+ * Major collections of heaps of at least this many words are moved
+ * to a dirty cpu scheduler (+hdgc). Zero disables.
+ */
+#define ERTS_DIRTY_GC_DEFAULT_HEAP_SIZE (1024*1024)
+extern Uint erts_dirty_gc_heap_size;
+
 typedef struct {
   Uint64 reclaimed;
   Uint64 garbage_cols;
@@ -140,6 +147,7 @@ Eterm erts_process_gc_info(struct process*, Uint *, Eterm **, Uint, Uint);
 void erts_gc_info(ErtsGCInfo *gcip);
 void erts_init_gc(void);
 int erts_garbage_collect_nobump(struct process*, int, Eterm*, int, int);
+struct ErtsLiteralArea_;
 void erts_garbage_collect(struct process*, int, Eterm*, int);
 void erts_garbage_collect_hibernate(struct process* p);
 Eterm erts_gc_after_bif_call_lhf(struct process* p, ErlHeapFragment *live_hf_end,
@@ -148,6 +156,9 @@ Eterm erts_gc_after_bif_call(struct process* p, Eterm result, Eterm* regs, Uint
 void erts_garbage_collect_literals(struct process* p, Eterm* literals,
 				   Uint lit_size,
 				   struct erl_off_heap_header* oh);
+Uint erts_garbage_collect_literal_areas(struct process* p,
+					struct ErtsLiteralArea_ **areas,
+					Uint n);
 Uint erts_next_heap_size(Uint, Uint);
 Eterm erts_heap_sizes(struct process* p);
 
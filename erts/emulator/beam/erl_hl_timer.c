@@ -120,28 +120,11 @@ typedef enum {
 typedef struct ErtsHLTimer_ ErtsHLTimer;
 
 #define ERTS_HLT_PFLG_RED		(((UWord) 1) << 0)
-#define ERTS_HLT_PFLG_SAME_TIME		(((UWord) 1) << 1)
 
-#define ERTS_HLT_PFLGS_MASK \
-    (ERTS_HLT_PFLG_RED|ERTS_HLT_PFLG_SAME_TIME)
+#define ERTS_HLT_PFLGS_MASK ERTS_HLT_PFLG_RED
 
 #define ERTS_HLT_PFIELD_NOT_IN_TABLE	(~((UWord) 0))
 
-typedef struct {
-    UWord parent; /* parent pointer and flags... */
-    union {
-	struct {
-	    ErtsHLTimer *right;
-	    ErtsHLTimer *left;
-	} t;
-	struct {
-	    ErtsHLTimer *prev;
-	    ErtsHLTimer *next;
-	} l;
-    } u;
-    ErtsHLTimer *same_time;
-} ErtsHLTimerTimeTree;
-
 typedef struct {
     UWord parent; /* parent pointer and flags... */
     ErtsHLTimer *right;
@@ -161,7 +144,7 @@ struct ErtsHLTimer_ {
     ErtsTmrHead head; /* NEED to be first! */
     union {
 	ErtsThrPrgrLaterOp cleanup;
-	ErtsHLTimerTimeTree tree;
+	ErtsTWheelTimer tw_tmr;
     } time;
     ErtsMonotonicTime timeout;
     union {
@@ -171,10 +154,6 @@ struct ErtsHLTimer_ {
 	void (*callback)(void *);
     } receiver;
 
-#ifdef ERTS_HLT_HARD_DEBUG
-    int pending_timeout;
-#endif
-
     erts_smp_atomic32_t state;
 
     /* BIF timer only fields follow... */
@@ -233,20 +212,9 @@ ERTS_SCHED_PREF_QUICK_ALLOC_IMPL(tw_timer,
 				 PTIMER_PREALC_SZ,
 				 ERTS_ALC_T_LL_PTIMER)
 
-#ifdef ERTS_HLT_DEBUG
-#define ERTS_TMR_TIMEOUT_YIELD_LIMIT 5
-#else
-#define ERTS_TMR_TIMEOUT_YIELD_LIMIT 100
-#endif
 #define ERTS_TMR_CANCELED_TIMER_LIMIT 100
 #define ERTS_TMR_CANCELED_TIMER_SMALL_LIMIT 5
 
-#define ERTS_TMR_TIMEOUT_YIELD_STATE_T same_time_list_yield_state_t
-#define ERTS_TMR_YIELDING_TIMEOUT_STATE_INITER {NULL, {0}}
-typedef struct {
-    int dummy;
-} ERTS_TMR_TIMEOUT_YIELD_STATE_T;
-
 typedef struct {
     ErtsTmrHead marker;
     erts_atomic_t last;
@@ -286,20 +254,11 @@ typedef struct {
 
 #endif /* ERTS_SMP */
 
-typedef struct {
-    ErtsHLTimer *root;
-    ERTS_TMR_TIMEOUT_YIELD_STATE_T state;
-} ErtsYieldingTimeoutState;
-
 struct ErtsHLTimerService_ {
 #ifdef ERTS_SMP
     ErtsHLTCncldTmrQ canceled_queue;
 #endif
-    ErtsHLTimer *time_tree;
     ErtsHLTimer *btm_tree;
-    ErtsHLTimer *next_timeout;
-    ErtsYieldingTimeoutState yield;
-    ErtsTWheelTimer service_timer;
 };
 
 static ERTS_INLINE int
@@ -317,195 +276,6 @@ refn_is_lt(Uint32 *x, Uint32 *y)
     return x[0] < y[0];
 }
 
-#define ERTS_RBT_PREFIX time
-#define ERTS_RBT_T ErtsHLTimer
-#define ERTS_RBT_KEY_T ErtsMonotonicTime
-#define ERTS_RBT_FLAGS_T UWord
-#define ERTS_RBT_INIT_EMPTY_TNODE(T)					\
-    do {								\
-	(T)->time.tree.parent = (UWord) NULL;				\
-	(T)->time.tree.u.t.right = NULL;				\
-	(T)->time.tree.u.t.left = NULL;					\
-    } while (0)
-#define ERTS_RBT_IS_RED(T)						\
-    ((int) ((T)->time.tree.parent & ERTS_HLT_PFLG_RED))
-#define ERTS_RBT_SET_RED(T)						\
-    ((T)->time.tree.parent |= ERTS_HLT_PFLG_RED)
-#define ERTS_RBT_IS_BLACK(T)						\
-    (!ERTS_RBT_IS_RED((T)))
-#define ERTS_RBT_SET_BLACK(T)						\
-    ((T)->time.tree.parent &= ~ERTS_HLT_PFLG_RED)
-#define ERTS_RBT_GET_FLAGS(T)						\
-    ((T)->time.tree.parent & ERTS_HLT_PFLGS_MASK)
-#define ERTS_RBT_SET_FLAGS(T, F)					\
-    do {								\
-	ERTS_HLT_ASSERT((((UWord) (F)) & ~ERTS_HLT_PFLGS_MASK) == 0);	\
-	(T)->time.tree.parent &= ~ERTS_HLT_PFLGS_MASK;			\
-	(T)->time.tree.parent |= (F);					\
-    } while (0)
-#define ERTS_RBT_GET_PARENT(T)						\
-    ((ErtsHLTimer *) ((T)->time.tree.parent & ~ERTS_HLT_PFLGS_MASK))
-#define ERTS_RBT_SET_PARENT(T, P)					\
-    do {								\
-	ERTS_HLT_ASSERT((((UWord) (P)) & ERTS_HLT_PFLGS_MASK) == 0);	\
-	(T)->time.tree.parent &= ERTS_HLT_PFLGS_MASK;			\
-	(T)->time.tree.parent |= (UWord) (P);				\
-    } while (0)
-#define ERTS_RBT_GET_RIGHT(T) ((T)->time.tree.u.t.right)
-#define ERTS_RBT_SET_RIGHT(T, R) ((T)->time.tree.u.t.right = (R))
-#define ERTS_RBT_GET_LEFT(T) ((T)->time.tree.u.t.left)
-#define ERTS_RBT_SET_LEFT(T, L) ((T)->time.tree.u.t.left = (L))
-#define ERTS_RBT_GET_KEY(T) ((T)->timeout)
-#define ERTS_RBT_IS_LT(KX, KY) ((KX) < (KY))
-#define ERTS_RBT_IS_EQ(KX, KY) ((KX) == (KY))
-#define ERTS_RBT_WANT_DELETE
-#define ERTS_RBT_WANT_SMALLEST
-#define ERTS_RBT_WANT_LOOKUP_INSERT
-#define ERTS_RBT_WANT_REPLACE
-#define ERTS_RBT_WANT_FOREACH
-#ifdef ERTS_HLT_HARD_DEBUG
-#  define ERTS_RBT_WANT_LOOKUP
-#endif
-#define ERTS_RBT_UNDEF
-
-#include "erl_rbtree.h"
-
-/* Use circular list for timers at same time */
-
-static ERTS_INLINE void
-same_time_list_insert(ErtsHLTimer **root, ErtsHLTimer *tmr)
-{
-    ErtsHLTimer *first = *root;
-    if (!first) {
-	ERTS_HLT_ASSERT((((UWord) root) & ERTS_HLT_PFLG_SAME_TIME) == 0);
-	tmr->time.tree.parent = ((UWord) root) | ERTS_HLT_PFLG_SAME_TIME;
-	tmr->time.tree.u.l.next = tmr;
-	tmr->time.tree.u.l.prev = tmr;
-	*root = tmr;
-    }
-    else {
-	tmr->time.tree.parent = ERTS_HLT_PFLG_SAME_TIME;
-	tmr->time.tree.u.l.next = first;
-	tmr->time.tree.u.l.prev = first->time.tree.u.l.prev;
-	first->time.tree.u.l.prev = tmr;
-	tmr->time.tree.u.l.prev->time.tree.u.l.next = tmr;
-    }
-}
-
-static ERTS_INLINE void
-same_time_list_delete(ErtsHLTimer *tmr)
-{
-    ErtsHLTimer **root, *next;
-    
-    root = (ErtsHLTimer **) (tmr->time.tree.parent & ~ERTS_HLT_PFLG_SAME_TIME);
-    next = tmr->time.tree.u.l.next;
-
-    ERTS_HLT_ASSERT((tmr->time.tree.parent
-		     == (((UWord) root) | ERTS_HLT_PFLG_SAME_TIME))
-		    || (tmr->time.tree.parent
-			== ERTS_HLT_PFLG_SAME_TIME));
-
-    if (next == tmr) {
-	ERTS_HLT_ASSERT(root && *root == tmr);
-	ERTS_HLT_ASSERT(tmr->time.tree.u.l.prev == tmr);
-	*root = NULL;
-    }
-    else {
-	if (root) {
-	    ERTS_HLT_ASSERT(*root == tmr);
-	    *root = next;
-	    next->time.tree.parent = ((UWord) root) | ERTS_HLT_PFLG_SAME_TIME;
-	}
-	tmr->time.tree.u.l.next->time.tree.u.l.prev = tmr->time.tree.u.l.prev;
-	tmr->time.tree.u.l.prev->time.tree.u.l.next = next;
-    }
-}
-
-static ERTS_INLINE void
-same_time_list_new_root(ErtsHLTimer **root)
-{
-    ErtsHLTimer *tmr = *root;
-    if (tmr) {
-	ERTS_HLT_ASSERT(root);
-	tmr->time.tree.parent = ((UWord) root) | ERTS_HLT_PFLG_SAME_TIME;
-    }
-}
-
-static ERTS_INLINE int
-same_time_list_foreach_destroy_yielding(ErtsHLTimer **root,
-					void (*op)(ErtsHLTimer *, void *),
-					void *arg,
-					ERTS_TMR_TIMEOUT_YIELD_STATE_T *ys,
-					Sint ylimit)
-{
-    Sint ycnt = ylimit;
-    ErtsHLTimer *end, *tmr = *root;
-    if (!tmr)
-	return 0;
-
-    ERTS_HLT_ASSERT(tmr->time.tree.parent
-		    == (((UWord) root) | ERTS_HLT_PFLG_SAME_TIME));
-
-    end = tmr->time.tree.u.l.prev;
-    end->time.tree.u.l.next = NULL;
-
-    while (1) {
-	ErtsHLTimer *op_tmr = tmr;
-
-	ERTS_HLT_ASSERT((tmr->time.tree.parent
-			 == (((UWord) root) | ERTS_HLT_PFLG_SAME_TIME))
-			|| (tmr->time.tree.parent
-			    == ERTS_HLT_PFLG_SAME_TIME));
-
-	tmr = tmr->time.tree.u.l.next;
-	(*op)(op_tmr, arg);
-	if (!tmr) {
-	    *root = NULL;
-	    return 0;
-	}
-	if (--ycnt <= 0) {
-	    /* Make new circle of timers left to process... */
-	    *root = tmr;
-	    end->time.tree.u.l.next = tmr;
-	    tmr->time.tree.u.l.prev = end;
-	    tmr->time.tree.parent = ((UWord) root) | ERTS_HLT_PFLG_SAME_TIME;
-	    return 1;
-	}
-    }    
-}
-
-static ERTS_INLINE void
-same_time_list_foreach(ErtsHLTimer *root,
-		       void (*op)(ErtsHLTimer *, void *),
-		       void *arg)
-{
-    if (root) {
-	ErtsHLTimer *tmr = root;
-	do {
-	    (*op)(tmr, arg);
-	    tmr = tmr->time.tree.u.l.next;
-	} while (root != tmr);
-    }
-}
-
-#ifdef ERTS_HLT_HARD_DEBUG
-
-static ERTS_INLINE ErtsHLTimer *
-same_time_list_lookup(ErtsHLTimer *root, ErtsHLTimer *x)
-{
-    if (root) {
-	ErtsHLTimer *tmr = root;
-	do {
-	    if (tmr == x)
-		return tmr;
-	    tmr = tmr->time.tree.u.l.next;
-	} while (root != tmr);
-    }
-    return NULL;
-}
-
-#endif /* ERTS_HLT_HARD_DEBUG */
-
 #define ERTS_RBT_PREFIX btm
 #define ERTS_RBT_T ErtsHLTimer
 #define ERTS_RBT_KEY_T Uint32 *
@@ -674,16 +444,11 @@ erts_hl_timer_init(void)
 ErtsHLTimerService *
 erts_create_timer_service(void)
 {
-    ErtsYieldingTimeoutState init_yield = ERTS_TMR_YIELDING_TIMEOUT_STATE_INITER;
     ErtsHLTimerService *srv;
 
     srv = erts_alloc_permanent_cache_aligned(ERTS_ALC_T_TIMER_SERVICE,
 					     sizeof(ErtsHLTimerService));
-    srv->time_tree = NULL;
     srv->btm_tree = NULL;
-    srv->next_timeout = NULL;
-    srv->yield = init_yield;
-    erts_twheel_init_timer(&srv->service_timer);
 
 #ifdef ERTS_SMP
     init_canceled_queue(&srv->canceled_queue);
@@ -992,7 +757,7 @@ hl_timer_dec_refc(ErtsHLTimer *tmr, Uint32 roflgs)
     }
 }
 
-static void hlt_service_timeout(void *vesdp);
+static void hlt_timeout(void *vtmr);
 #ifdef ERTS_SMP
 static void handle_canceled_queue(ErtsSchedulerData *esdp,
 				  ErtsHLTCncldTmrQ *cq,
@@ -1051,7 +816,7 @@ create_hl_timer(ErtsSchedulerData *esdp,
 		void (*callback)(void *), void *arg)
 {
     ErtsHLTimerService *srv = esdp->timer_service;
-    ErtsHLTimer *tmr, *st_tmr;
+    ErtsHLTimer *tmr;
     erts_aint32_t refc;
     Uint32 roflgs;
 
@@ -1181,28 +946,17 @@ create_hl_timer(ErtsSchedulerData *esdp,
     erts_smp_atomic32_init_nob(&tmr->head.refc, refc);
     erts_smp_atomic32_init_nob(&tmr->state, ERTS_TMR_STATE_ACTIVE);
 
-    if (!srv->next_timeout
-	|| tmr->timeout < srv->next_timeout->timeout) {
-	if (srv->next_timeout)
-	    erts_twheel_cancel_timer(esdp->timer_wheel,
-				     &srv->service_timer);
-	erts_twheel_set_timer(esdp->timer_wheel,
-			      &srv->service_timer,
-			      hlt_service_timeout,
-			      NULL,
-			      (void *) esdp,
-			      tmr->timeout);
-	srv->next_timeout = tmr;
-    }
-
-    st_tmr = time_rbt_lookup_insert(&srv->time_tree, tmr);
-    tmr->time.tree.same_time = st_tmr;
-    if (st_tmr)
-	same_time_list_insert(&st_tmr->time.tree.same_time, tmr);
-
-#ifdef ERTS_HLT_HARD_DEBUG
-    tmr->pending_timeout = 0;
-#endif
+    /*
+     * The timer wheel keeps timers of any length, so high
+     * level timers are inserted directly into it.
+     */
+    erts_twheel_init_timer(&tmr->time.tw_tmr);
+    erts_twheel_set_timer(esdp->timer_wheel,
+			  &tmr->time.tw_tmr,
+			  hlt_timeout,
+			  NULL,
+			  (void *) tmr,
+			  timeout_pos);
 
     ERTS_HLT_HDBG_CHK_SRV(srv);
 
@@ -1282,9 +1036,10 @@ hlt_port_timeout(ErtsHLTimer *tmr)
 	hl_timer_dec_refc(tmr, tmr->head.roflgs);
 }
 
-static void hlt_timeout(ErtsHLTimer *tmr, void *vsrv)
+static void hlt_timeout(void *vtmr)
 {
-    ErtsHLTimerService *srv = (ErtsHLTimerService *) vsrv;
+    ErtsHLTimer *tmr = (ErtsHLTimer *) vtmr;
+    ErtsHLTimerService *srv = erts_get_scheduler_data()->timer_service;
     Uint32 roflgs;
     erts_aint32_t state;
 
@@ -1315,7 +1070,6 @@ static void hlt_timeout(ErtsHLTimer *tmr, void *vsrv)
 
     }
 
-    tmr->time.tree.parent = ERTS_HLT_PFIELD_NOT_IN_TABLE;
     if ((roflgs & ERTS_TMR_ROFLG_BIF_TMR)
 	&& tmr->btm.tree.parent != ERTS_HLT_PFIELD_NOT_IN_TABLE) {
 	btm_rbt_delete(&srv->btm_tree, tmr);
@@ -1327,71 +1081,6 @@ static void hlt_timeout(ErtsHLTimer *tmr, void *vsrv)
     hl_timer_dec_refc(tmr, roflgs);
 }
 
-#ifdef ERTS_HLT_HARD_DEBUG
-static void
-set_pending_timeout(ErtsHLTimer *tmr, void *unused)
-{
-    tmr->pending_timeout = -1;
-}
-#endif
-
-static void
-hlt_service_timeout(void *vesdp)
-{
-    ErtsSchedulerData *esdp = (ErtsSchedulerData *) vesdp;
-    ErtsHLTimerService *srv = esdp->timer_service;
-    ErtsHLTimer *tmr = srv->next_timeout;
-    int yield;
-
-    ERTS_HLT_HDBG_CHK_SRV(srv);
-
-    ERTS_HLT_ASSERT(esdp == erts_get_scheduler_data());
-
-    ERTS_HLT_ASSERT(!srv->yield.root || srv->yield.root == tmr);
-    ERTS_HLT_ASSERT(tmr);
-    ERTS_HLT_ASSERT(tmr->timeout <= erts_get_monotonic_time(esdp));
-
-    if (!srv->yield.root) {
-	ERTS_HLT_ASSERT(tmr->time.tree.parent
-			!= ERTS_HLT_PFIELD_NOT_IN_TABLE);
-	time_rbt_delete(&srv->time_tree, tmr);
-	tmr->time.tree.parent = ERTS_HLT_PFIELD_NOT_IN_TABLE;
-#ifdef ERTS_HLT_HARD_DEBUG
-	tmr->pending_timeout = 1;
-	if (tmr->time.tree.same_time)
-	    same_time_list_foreach(tmr->time.tree.same_time, set_pending_timeout, NULL);
-#endif
-    }
-
-    if (!tmr->time.tree.same_time && !srv->yield.root)
-	yield = 0;
-    else {
-	yield = same_time_list_foreach_destroy_yielding(
-	    &tmr->time.tree.same_time, hlt_timeout, (void *) srv,
-	    &srv->yield.state, ERTS_TMR_TIMEOUT_YIELD_LIMIT);
-    }
-
-    if (yield)
-	srv->yield.root = tmr;
-    else {
-	srv->yield.root = NULL;
-	hlt_timeout(tmr, (void *) srv);
-
-	tmr = time_rbt_smallest(srv->time_tree);
-	srv->next_timeout = tmr;
-    }
-
-    ERTS_HLT_HDBG_CHK_SRV(srv);
-
-    if (tmr)
-	erts_twheel_set_timer(esdp->timer_wheel,
-			      &srv->service_timer,
-			      hlt_service_timeout,
-			      NULL,
-			      vesdp,
-			      tmr->timeout);
-}
-
 static void
 hlt_delete_timer(ErtsSchedulerData *esdp, ErtsHLTimer *tmr)
 {
@@ -1412,58 +1101,13 @@ hlt_delete_timer(ErtsSchedulerData *esdp, ErtsHLTimer *tmr)
 #endif
     }
 
-    if (tmr->time.tree.parent == ERTS_HLT_PFIELD_NOT_IN_TABLE) {
+    if (tmr->time.tw_tmr.slot == ERTS_TWHEEL_SLOT_INACTIVE) {
 	/* Already removed... */
 	ERTS_HLT_HDBG_CHK_SRV(srv);
 	return;
     }
 
-    if (tmr->time.tree.parent & ERTS_HLT_PFLG_SAME_TIME) {
-	same_time_list_delete(tmr);
-    }
-    else if (tmr->time.tree.same_time) {
-	ErtsHLTimer *st_container;
-
-	ERTS_HLT_ASSERT((tmr->time.tree.parent & ERTS_HLT_PFLG_SAME_TIME) == 0);
-	st_container = tmr->time.tree.same_time->time.tree.u.l.prev;
-
-	ERTS_HLT_ASSERT(st_container);
-	ERTS_HLT_ASSERT(st_container->time.tree.parent
-			 & ERTS_HLT_PFLG_SAME_TIME);
-	ERTS_HLT_ASSERT(tmr->timeout == st_container->timeout);
-
-	same_time_list_delete(st_container);
-	st_container->time.tree.same_time = tmr->time.tree.same_time;
-	same_time_list_new_root(&st_container->time.tree.same_time);
-
-	time_rbt_replace(&srv->time_tree, tmr, st_container);
-	ERTS_HLT_ASSERT((st_container->time.tree.parent
-			 & ERTS_HLT_PFLG_SAME_TIME) == 0);
-
-	if (srv->next_timeout == tmr)
-	    srv->next_timeout = st_container;
-    }
-    else {
-	ERTS_HLT_ASSERT((tmr->time.tree.parent & ERTS_HLT_PFLG_SAME_TIME) == 0);
-	time_rbt_delete(&srv->time_tree, tmr);
-	if (tmr == srv->next_timeout) {
-	    ErtsHLTimer *smlst;
-	    erts_twheel_cancel_timer(esdp->timer_wheel,
-				     &srv->service_timer);
-	    smlst = time_rbt_smallest(srv->time_tree);
-	    srv->next_timeout = smlst;
-	    if (smlst) {
-		ERTS_HLT_ASSERT(smlst->timeout > tmr->timeout);
-		erts_twheel_set_timer(esdp->timer_wheel,
-				      &srv->service_timer,
-				      hlt_service_timeout,
-				      NULL,
-				      (void *) esdp,
-				      smlst->timeout);
-	    }
-	}
-    }
-    tmr->time.tree.parent = ERTS_HLT_PFIELD_NOT_IN_TABLE;
+    erts_twheel_cancel_timer(esdp->timer_wheel, &tmr->time.tw_tmr);
 
     hl_timer_dec_refc(tmr, tmr->head.roflgs);
 
@@ -2954,29 +2598,14 @@ typedef struct {
 } ErtsDebugForeachCallbackTimer;
 
 static void
-debug_callback_timer_foreach_list(ErtsHLTimer *tmr, void *vdfct)
-{
-    ErtsDebugForeachCallbackTimer *dfct
-	= (ErtsDebugForeachCallbackTimer *) vdfct;
-
-    if ((tmr->head.roflgs & ERTS_TMR_ROFLG_CALLBACK)
-	&& (tmr->receiver.callback == dfct->tclbk))
-	(*dfct->func)(dfct->arg,
-		      tmr->timeout,
-		      tmr->head.u.arg);
-}
-
-static void
-debug_callback_timer_foreach(ErtsHLTimer *tmr, void *vdfct)
+debug_hl_callback_timer(void *vdfct,
+			ErtsMonotonicTime timeout_pos,
+			void *vtmr)
 {
+    ErtsHLTimer *tmr = (ErtsHLTimer *) vtmr;
     ErtsDebugForeachCallbackTimer *dfct
 	= (ErtsDebugForeachCallbackTimer *) vdfct;
 
-    if (tmr->time.tree.same_time)
-	same_time_list_foreach(tmr->time.tree.same_time,
-			       debug_callback_timer_foreach_list,
-			       vdfct);
-
     if ((tmr->head.roflgs & ERTS_TMR_ROFLG_CALLBACK)
 	&& (tmr->receiver.callback == dfct->tclbk))
 	(*dfct->func)(dfct->arg,
@@ -3017,8 +2646,6 @@ erts_debug_callback_timer_foreach(void (*tclbk)(void *),
 	ERTS_INTERNAL_ERROR("Not blocking thread progress");
 
     for (six = 0; six < erts_no_schedulers; six++) {
-	ErtsHLTimerService *srv =
-	    erts_aligned_scheduler_data[six].esd.timer_service;
 	ErtsTimerWheel *twheel =
 	    erts_aligned_scheduler_data[six].esd.timer_wheel;
 
@@ -3027,13 +2654,10 @@ erts_debug_callback_timer_foreach(void (*tclbk)(void *),
 				  debug_tw_callback_timer,
 				  (void *) &dfct);
 
-	if (srv->yield.root)
-	    debug_callback_timer_foreach(srv->yield.root,
-					 (void *) &dfct);
-
-	time_rbt_foreach(srv->time_tree,
-			 debug_callback_timer_foreach,
-			 (void *) &dfct);
+	erts_twheel_debug_foreach(twheel,
+				  hlt_timeout,
+				  debug_hl_callback_timer,
+				  (void *) &dfct);
     }
 }
 
@@ -3045,72 +2669,11 @@ typedef struct {
     ErtsHLTimer **rootpp;
 } ErtsHdbgHLT;
 
-static void
-st_hdbg_func(ErtsHLTimer *tmr, void *vhdbg)
-{
-    ErtsHdbgHLT *hdbg = (ErtsHdbgHLT *) vhdbg;
-    ErtsHLTimer **rootpp;
-    ERTS_HLT_ASSERT(tmr->time.tree.parent & ERTS_HLT_PFLG_SAME_TIME);
-    if (tmr->time.tree.parent == ERTS_HLT_PFLG_SAME_TIME) {
-	ERTS_HLT_ASSERT(tmr != *hdbg->rootpp);
-    }
-    else {
-	rootpp = (ErtsHLTimer **) (tmr->time.tree.parent
-				   & ~ERTS_HLT_PFLG_SAME_TIME);
-	ERTS_HLT_ASSERT(rootpp == hdbg->rootpp);
-	ERTS_HLT_ASSERT(tmr == *rootpp);
-	ERTS_HLT_ASSERT(!hdbg->found_root);
-	hdbg->found_root = 1;
-    }
-    ERTS_HLT_ASSERT(tmr->time.tree.u.l.next->time.tree.u.l.prev == tmr);
-    ERTS_HLT_ASSERT(tmr->time.tree.u.l.prev->time.tree.u.l.next == tmr);
-    ERTS_HLT_ASSERT(btm_rbt_lookup(hdbg->srv->btm_tree, tmr->btm.refn) == tmr);
-}
-
-static void
-tt_hdbg_func(ErtsHLTimer *tmr, void *vhdbg)
-{
-    ErtsHdbgHLT *hdbg = (ErtsHdbgHLT *) vhdbg;
-    ErtsHLTimer *prnt;
-    ERTS_HLT_ASSERT((tmr->time.tree.parent & ERTS_HLT_PFLG_SAME_TIME) == 0);
-    prnt = (ErtsHLTimer *) (tmr->time.tree.parent & ~ERTS_HLT_PFLGS_MASK);
-    if (prnt) {
-	ERTS_HLT_ASSERT(prnt->time.tree.u.t.left == tmr
-			|| prnt->time.tree.u.t.right == tmr);
-    }
-    else {
-	ERTS_HLT_ASSERT(!hdbg->found_root);
-	hdbg->found_root = 1;
-	ERTS_HLT_ASSERT(tmr == *hdbg->rootpp);
-    }
-    if (tmr->time.tree.u.t.left) {
-	prnt = (ErtsHLTimer *) (tmr->time.tree.u.t.left->time.tree.parent
-				& ~ERTS_HLT_PFLGS_MASK);
-	ERTS_HLT_ASSERT(tmr == prnt);
-    }
-    if (tmr->time.tree.u.t.right) {
-	prnt = (ErtsHLTimer *) (tmr->time.tree.u.t.right->time.tree.parent
-				& ~ERTS_HLT_PFLGS_MASK);
-	ERTS_HLT_ASSERT(tmr == prnt);
-    }
-    if (tmr->head.roflgs & ERTS_TMR_ROFLG_BIF_TMR)
-	ERTS_HLT_ASSERT(btm_rbt_lookup(hdbg->srv->btm_tree, tmr->btm.refn) == tmr);
-    if (tmr->time.tree.same_time) {
-	ErtsHdbgHLT st_hdbg;
-	st_hdbg.srv = hdbg->srv;
-	st_hdbg.found_root = 0;
-	st_hdbg.rootpp = &tmr->time.tree.same_time;
-	same_time_list_foreach(tmr->time.tree.same_time, st_hdbg_func, (void *) &st_hdbg);
-	ERTS_HLT_ASSERT(st_hdbg.found_root);
-    }
-}
-
 static void
 bt_hdbg_func(ErtsHLTimer *tmr, void *vhdbg)
 {
     ErtsHdbgHLT *hdbg = (ErtsHdbgHLT *) vhdbg;
     ErtsHLTimer *prnt;
-    ERTS_HLT_ASSERT((tmr->btm.tree.parent & ERTS_HLT_PFLG_SAME_TIME) == 0);
     prnt = (ErtsHLTimer *) (tmr->btm.tree.parent & ~ERTS_HLT_PFLGS_MASK);
     if (prnt) {
 	ERTS_HLT_ASSERT(prnt->btm.tree.left == tmr
@@ -3131,35 +2694,12 @@ bt_hdbg_func(ErtsHLTimer *tmr, void *vhdbg)
 				& ~ERTS_HLT_PFLGS_MASK);
 	ERTS_HLT_ASSERT(tmr == prnt);
     }
-    if (tmr->pending_timeout) {
-	if (tmr->pending_timeout > 0) /* container > 0 */
-	    ERTS_HLT_ASSERT(tmr->time.tree.parent == ERTS_HLT_PFIELD_NOT_IN_TABLE);
-	else {
-	    ERTS_HLT_ASSERT(tmr->time.tree.parent != ERTS_HLT_PFIELD_NOT_IN_TABLE);
-	    ERTS_HLT_ASSERT(tmr->time.tree.parent & ERTS_HLT_PFLG_SAME_TIME);
-	}
-    }
-    else {
-	ErtsHLTimer *ttmr = time_rbt_lookup(hdbg->srv->time_tree, tmr->timeout);
-	ERTS_HLT_ASSERT(ttmr);
-	if (ttmr != tmr) {
-	    ERTS_HLT_ASSERT(ttmr->time.tree.same_time);
-	    ERTS_HLT_ASSERT(tmr == same_time_list_lookup(ttmr->time.tree.same_time, tmr));
-	}
-    }
+    ERTS_HLT_ASSERT(tmr->time.tw_tmr.slot != ERTS_TWHEEL_SLOT_INACTIVE);
 }
 
 static void
 hdbg_chk_srv(ErtsHLTimerService *srv)
 {
-    if (srv->time_tree) {
-	ErtsHdbgHLT hdbg;
-	hdbg.srv = srv;
-	hdbg.found_root = 0;
-	hdbg.rootpp = &srv->time_tree;
-	time_rbt_foreach(srv->time_tree, tt_hdbg_func, (void *) &hdbg);
-	ERTS_HLT_ASSERT(hdbg.found_root);
-    }
     if (srv->btm_tree) {
 	ErtsHdbgHLT hdbg;
 	hdbg.srv = srv;
@@ -375,9 +375,11 @@ erl_init(int ncpu,
     erts_init_async();
     erts_init_io(port_tab_sz, port_tab_sz_ignore_files, legacy_port_tab);
     init_load();
+    erts_beam_bif_load_init();
     erts_init_bif();
     erts_init_bif_chksum();
     erts_init_bif_binary();
+    erts_init_bif_persistent_term();
     erts_init_bif_re();
     erts_init_unicode(); /* after RE to get access to PCRE unicode */
     erts_init_external();
@@ -578,6 +580,9 @@ void erts_usage(void)
 	       VH_DEFAULT_SIZE);
     erts_fprintf(stderr, "-hmax size     set maximum heap size in words (default %d)\n",
 	       H_DEFAULT_MAX_SIZE);
+    erts_fprintf(stderr, "-hdgc size     set heap size in words from which major collections\n");
+    erts_fprintf(stderr, "               are done on dirty cpu schedulers, 0 disables (default %d)\n",
+	       ERTS_DIRTY_GC_DEFAULT_HEAP_SIZE);
     erts_fprintf(stderr, "-hmaxk bool    enable or disable kill at max heap size (default true)\n");
     erts_fprintf(stderr, "-hmaxel bool   enable or disable error_logger report at max heap size (default true)\n");
     erts_fprintf(stderr, "-hpds size     initial process dictionary size (default %d)\n",
@@ -587,6 +592,9 @@ void erts_usage(void)
 
     /*    erts_fprintf(stderr, "-i module  set the boot module (default init)\n"); */
 
+    erts_fprintf(stderr, "-IOt number    set number of dedicated poll threads,\n");
+    erts_fprintf(stderr, "               valid range is [0-%d]\n",
+		 ERTS_MAX_NO_OF_POLL_THREADS);
     erts_fprintf(stderr, "-K boolean     enable or disable kernel poll\n");
     erts_fprintf(stderr, "-n[s|a|d]      Control behavior of signals to ports\n");
     erts_fprintf(stderr, "               Note that this flag is deprecated!\n");
@@ -864,6 +872,23 @@ early_init(int *argc, char **argv) /*
 		    }
 		    break;
 		}
+		case 'I': {
+		    if (has_prefix("IOt", argv[i]+1)) {
+			/* set number of dedicated poll threads */
+			char *arg = get_arg(argv[i]+4, argv[i+1], &i);
+			erts_no_poll_threads = atoi(arg);
+			if (erts_no_poll_threads < 0
+			    || erts_no_poll_threads > ERTS_MAX_NO_OF_POLL_THREADS) {
+			    erts_fprintf(stderr,
+					 "bad number of poll threads %s\n",
+					 arg);
+			    erts_usage();
+			}
+			VERBOSE(DEBUG_SYSTEM, ("using %d poll threads\n",
+					       erts_no_poll_threads));
+		    }
+		    break;
+		}
 		case 'A': {
 		    /* set number of threads in thread pool */
 		    char *arg = get_arg(argv[i]+2, argv[i+1], &i);
@@ -1160,13 +1185,14 @@ early_init(int *argc, char **argv) /*
      * ** Scheduler threads (see erl_process.c)
      * ** Aux thread (see erl_process.c)
      * ** Sys message dispatcher thread (see erl_trace.c)
+     * ** Poll threads (see erl_check_io.c)
      *
      * * Unmanaged threads that need to register:
      * ** Async threads (see erl_async.c)
      * ** Dirty scheduler threads
      */
     erts_thr_progress_init(no_schedulers,
-			   no_schedulers+2,
+			   no_schedulers+2+erts_no_poll_threads,
 #ifndef ERTS_DIRTY_SCHEDULERS
 			   erts_async_max_threads
 #else
@@ -1494,6 +1520,7 @@ erl_start(int argc, char **argv)
 	     * h|mbs   - min_bin_vheap_size
 	     * h|pds   - erts_pd_initial_size
 	     * h|mqd   - message_queue_data
+	     * h|dgc   - erts_dirty_gc_heap_size
              * h|max   - max_heap_size
              * h|maxk  - max_heap_kill
              * h|maxel - max_heap_error_logger
@@ -1514,6 +1541,19 @@ erl_start(int argc, char **argv)
 		    erts_usage();
 		}
 		VERBOSE(DEBUG_SYSTEM, ("using minimum heap size %d\n", H_MIN_SIZE));
+	    } else if (has_prefix("dgc", sub_param)) {
+		long sz;
+		char *endptr;
+		arg = get_arg(sub_param+3, argv[i+1], &i);
+		errno = 0;
+		sz = strtol(arg, &endptr, 10);
+		if (errno != 0 || *arg == '\0' || *endptr != '\0'
+		    || sz < 0 || MAX_SMALL < sz) {
+		    erts_fprintf(stderr, "bad dirty gc heap size %s\n", arg);
+		    erts_usage();
+		}
+		erts_dirty_gc_heap_size = (Uint) sz;
+		VERBOSE(DEBUG_SYSTEM, ("using dirty gc heap size %ld\n", sz));
 	    } else if (has_prefix("pds", sub_param)) {
 		arg = get_arg(sub_param+3, argv[i+1], &i);
 		if (!erts_pd_set_initial_size(atoi(arg))) {
@@ -2013,6 +2053,17 @@ erl_start(int argc, char **argv)
 	    (void) get_arg(argv[i]+2, argv[i+1], &i);
 	    break;
 
+	case 'I':
+	    if (has_prefix("IOt", argv[i]+1)) {
+		/* Was handled in early init just read past it */
+		(void) get_arg(argv[i]+4, argv[i+1], &i);
+	    }
+	    else {
+		erts_fprintf(stderr, "bad I/O option %s\n", argv[i]);
+		erts_usage();
+	    }
+	    break;
+
 	case 'a':
 	    /* suggested stack size (Kilo Words) for threads in thread pool */
 	    arg = get_arg(argv[i]+2, argv[i+1], &i);
@@ -2248,7 +2299,7 @@ erl_start(int argc, char **argv)
     otp_ring0_pid = erl_first_process_otp("otp_ring0", NULL, 0,
 					  boot_argc, boot_argv);
 
-    (void) erl_system_process_otp(otp_ring0_pid, "erts_code_purger");
+    erts_code_purger = erl_system_process_otp(otp_ring0_pid, "erts_code_purger");
 
 #ifdef ERTS_SMP
     erts_start_schedulers();
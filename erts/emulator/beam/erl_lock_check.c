@@ -105,6 +105,10 @@ static erts_lc_lock_order_t erts_lock_order[] = {
     {	"db_tab_fix",				"address"		},
     {	"meta_main_tab_main",			NULL 			},
     {	"db_hash_slot",				"address"		},
+    {	"db_catree_route",			"address"		},
+    {	"db_catree_base_node",			"address"		},
+    {	"persistent_term",			NULL			},
+    {	"release_literal_areas",		NULL			},
     {	"node_table",				NULL			},
     {	"dist_table",				NULL			},
     {	"sys_tracers",				NULL			},
@@ -147,6 +151,7 @@ static erts_lc_lock_order_t erts_lock_order[] = {
     {	"ptimer_pre_alloc_lock",		"address",		},
     {	"btm_pre_alloc_lock",			NULL,			},
     {	"dist_entry_out_queue",			"address"		},
+    {	"proc_msgq_shard",			NULL			},
     {	"port_sched_lock",			"port_id"		},
     {	"sys_msg_q", 				NULL			},
     {	"tracer_mtx", 				NULL			},
@@ -0,0 +1,276 @@
+/*
+ * %CopyrightBegin%
+ *
+ * Copyright Ericsson AB 2017. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * %CopyrightEnd%
+ */
+
+/*
+ * An implementation of the LZ4 block format.
+ *
+ * A block is a sequence of sequences. Each sequence starts with a
+ * token byte, whose high nibble is the number of literals and low
+ * nibble the match length minus 4. A nibble of 15 is followed by
+ * bytes that are added to it, up to and including the first byte
+ * that is not 255. Then follow the literals, and the match offset
+ * as a 16-bit little endian integer, followed by more match length
+ * bytes if needed. The last sequence has literals only, and the last
+ * 5 bytes of a block are always literals.
+ *
+ * The compressor is the usual greedy single pass one, using a hash
+ * table of 4-byte sequences. When no match is found, it skips ahead
+ * faster and faster through data that does not seem to compress.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "sys.h"
+#include "erl_alloc.h"
+#include "erl_lz4.h"
+
+#define LZ4_MIN_MATCH 4
+#define LZ4_LAST_LITERALS 5	/* Last bytes that must be literals */
+#define LZ4_MF_LIMIT 12		/* Last match must start before this */
+#define LZ4_MAX_OFFSET 65535
+#define LZ4_RUN_MASK 15
+
+static ERTS_INLINE Uint32
+read32(const byte *p)
+{
+    Uint32 v;
+    sys_memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static ERTS_INLINE Uint
+hash32(Uint32 v, int bits)
+{
+    return (Uint) ((v * 2654435761U) >> (32 - bits));
+}
+
+/*
+ * Write a length that did not fit in a nibble. Returns NULL if it
+ * does not fit in the buffer.
+ */
+static ERTS_INLINE byte *
+put_length(byte *op, byte *oend, Uint len)
+{
+    while (len >= 255) {
+	if (op >= oend)
+	    return NULL;
+	*op++ = 255;
+	len -= 255;
+    }
+    if (op >= oend)
+	return NULL;
+    *op++ = (byte) len;
+    return op;
+}
+
+static byte *
+put_sequence(byte *op, byte *oend, const byte *lit, Uint lit_len,
+	     Uint offset, Uint match_len)
+{
+    byte *token = op++;
+    Uint ml;
+
+    if (op > oend)
+	return NULL;
+    if (lit_len >= LZ4_RUN_MASK) {
+	*token = LZ4_RUN_MASK << 4;
+	op = put_length(op, oend, lit_len - LZ4_RUN_MASK);
+	if (!op)
+	    return NULL;
+    }
+    else {
+	*token = (byte) (lit_len << 4);
+    }
+    if (lit_len > (Uint) (oend - op))
+	return NULL;
+    sys_memcpy(op, lit, lit_len);
+    op += lit_len;
+
+    if (match_len == 0)		/* Last sequence */
+	return op;
+
+    if (oend - op < 2)
+	return NULL;
+    *op++ = (byte) offset;
+    *op++ = (byte) (offset >> 8);
+    ml = match_len - LZ4_MIN_MATCH;
+    if (ml >= LZ4_RUN_MASK) {
+	*token |= LZ4_RUN_MASK;
+	op = put_length(op, oend, ml - LZ4_RUN_MASK);
+    }
+    else {
+	*token |= (byte) ml;
+    }
+    return op;
+}
+
+Uint
+erl_lz4_compress(byte *dst, Uint dst_size,
+		 const byte *src, Uint size, int level)
+{
+    const byte *ip = src;
+    const byte *anchor = src;
+    const byte *iend = src + size;
+    byte *op = dst;
+    byte *oend = dst + dst_size;
+
+    if (level < ERL_LZ4_MIN_LEVEL)
+	level = ERL_LZ4_MIN_LEVEL;
+    else if (level > ERL_LZ4_MAX_LEVEL)
+	level = ERL_LZ4_MAX_LEVEL;
+
+    if (size > LZ4_MF_LIMIT) {
+	const byte *mflimit = iend - LZ4_MF_LIMIT;
+	const byte *matchlimit = iend - LZ4_LAST_LITERALS;
+	int bits = 12 + level / 2;
+	int skip = 2 + level / 2;
+	Uint32 *table;
+
+	table = erts_alloc(ERTS_ALC_T_TMP, sizeof(Uint32) << bits);
+	sys_memzero(table, sizeof(Uint32) << bits);
+
+	ip++;
+	while (1) {
+	    const byte *ref;
+	    Uint attempts = (Uint) 1 << skip;
+	    Uint len;
+
+	    /* Find a match */
+	    while (1) {
+		Uint h;
+		if (ip > mflimit)
+		    goto last_literals;
+		h = hash32(read32(ip), bits);
+		ref = src + table[h];
+		table[h] = (Uint32) (ip - src);
+		if (ref < ip && ip - ref <= LZ4_MAX_OFFSET
+		    && read32(ref) == read32(ip))
+		    break;
+		ip += attempts++ >> skip;
+	    }
+
+	    /* Extend it backwards and forwards */
+	    while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+		ip--;
+		ref--;
+	    }
+	    len = LZ4_MIN_MATCH;
+	    while (ip + len < matchlimit && ip[len] == ref[len])
+		len++;
+
+	    op = put_sequence(op, oend, anchor, ip - anchor, ip - ref, len);
+	    if (!op) {
+		erts_free(ERTS_ALC_T_TMP, table);
+		return 0;
+	    }
+	    ip += len;
+	    anchor = ip;
+	    if (ip > mflimit)
+		break;
+	    table[hash32(read32(ip - 2), bits)] = (Uint32) (ip - 2 - src);
+	}
+
+    last_literals:
+	erts_free(ERTS_ALC_T_TMP, table);
+    }
+
+    op = put_sequence(op, oend, anchor, iend - anchor, 0, 0);
+    return op ? op - dst : 0;
+}
+
+/*
+ * Read a length that did not fit in a nibble. Returns NULL if the
+ * input ends first.
+ */
+static ERTS_INLINE const byte *
+get_length(const byte *ip, const byte *iend, Uint *lenp)
+{
+    Uint len = *lenp;
+    byte b;
+
+    do {
+	if (ip >= iend)
+	    return NULL;
+	b = *ip++;
+	len += b;
+    } while (b == 255);
+    *lenp = len;
+    return ip;
+}
+
+Sint
+erl_lz4_decompress(byte *dst, Uint dst_size,
+		   const byte *src, Uint src_size)
+{
+    const byte *ip = src;
+    const byte *iend = src + src_size;
+    byte *op = dst;
+    byte *oend = dst + dst_size;
+
+    while (1) {
+	Uint len, offset;
+	byte token;
+	byte *ref;
+
+	if (ip >= iend)
+	    return -1;
+	token = *ip++;
+
+	len = token >> 4;
+	if (len == LZ4_RUN_MASK && !(ip = get_length(ip, iend, &len)))
+	    return -1;
+	if (len > (Uint) (iend - ip) || len > (Uint) (oend - op))
+	    return -1;
+	sys_memcpy(op, ip, len);
+	op += len;
+	ip += len;
+
+	if (ip == iend)
+	    break;		/* Last sequence */
+
+	if (iend - ip < 2)
+	    return -1;
+	offset = ip[0] | (ip[1] << 8);
+	ip += 2;
+	if (offset == 0 || offset > (Uint) (op - dst))
+	    return -1;
+
+	len = token & LZ4_RUN_MASK;
+	if (len == LZ4_RUN_MASK && !(ip = get_length(ip, iend, &len)))
+	    return -1;
+	len += LZ4_MIN_MATCH;
+	if (len > (Uint) (oend - op))
+	    return -1;
+
+	ref = op - offset;
+	if (offset >= len) {
+	    sys_memcpy(op, ref, len);
+	    op += len;
+	}
+	else {
+	    /* Overlapping copy, repeating the last 'offset' bytes */
+	    while (len--)
+		*op++ = *ref++;
+	}
+    }
+    return (Sint) (op - dst);
+}
@@ -0,0 +1,51 @@
+/*
+ * %CopyrightBegin%
+ *
+ * Copyright Ericsson AB 2017. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * %CopyrightEnd%
+ */
+
+/*
+ * Compression and decompression of single blocks in the LZ4 block
+ * format. Blocks are independent of each other; no dictionary or
+ * frame format is supported.
+ */
+
+#ifndef ERL_LZ4_H__
+#define ERL_LZ4_H__
+
+#include "sys.h"
+
+#define ERL_LZ4_MIN_LEVEL 1
+#define ERL_LZ4_MAX_LEVEL 9
+
+/*
+ * Compress 'size' bytes from 'src' into 'dst', which has room for
+ * 'dst_size' bytes. Higher levels search harder for matches. Returns
+ * the compressed size, or 0 if the result did not fit in 'dst'.
+ */
+Uint erl_lz4_compress(byte *dst, Uint dst_size,
+		      const byte *src, Uint size, int level);
+
+/*
+ * Decompress the block 'src' of 'src_size' bytes into 'dst'. Returns
+ * the decompressed size, or -1 if the block is malformed or does not
+ * fit in 'dst_size' bytes.
+ */
+Sint erl_lz4_decompress(byte *dst, Uint dst_size,
+			const byte *src, Uint src_size);
+
+#endif /* ERL_LZ4_H__ */
@@ -369,6 +369,459 @@ erts_queue_dist_message(Process *rcvr,
     }
 }
 
+#ifdef ERTS_SMP
+
+/*
+ * Add messages last in the shard of the sender. Returns -1 if the
+ * messages could not be queued this way; the caller then queues
+ * them in the 'in queue' as usual.
+ */
+static Sint
+queue_messages_shard(Process* receiver,
+                     ErtsMsgQShards *shards,
+                     ErtsMessage* first,
+                     ErtsMessage** last,
+                     Uint len,
+                     Eterm from)
+{
+    ErtsMsgQShard *shard;
+    erts_aint32_t state;
+    Uint ix;
+    Sint res;
+
+    if (is_internal_pid(from))
+        ix = internal_pid_number(from);
+    else if (is_internal_port(from))
+        ix = internal_port_number(from);
+    else
+        return -1;
+
+    shard = &shards->shard[ix % shards->no_shards];
+
+    erts_smp_spin_lock(&shard->s.lock);
+
+    if (!erts_smp_atomic32_read_nob(&shards->enabled)) {
+        erts_smp_spin_unlock(&shard->s.lock);
+        return -1;
+    }
+
+    /*
+     * The receiver sets ERTS_PSFLG_EXITING before it fetches the
+     * shards for the last time, so messages are either fetched or
+     * dropped here. Messages that slip in between are dropped when
+     * the shards are deallocated.
+     */
+    state = erts_smp_atomic32_read_nob(&receiver->state);
+    if (state & (ERTS_PSFLG_PENDING_EXIT|ERTS_PSFLG_EXITING)) {
+        erts_smp_spin_unlock(&shard->s.lock);
+        erts_cleanup_messages(first);
+        return 0;
+    }
+
+    *shard->s.q.last = first;
+    shard->s.q.last = last;
+    shard->s.q.len += len;
+
+    /* Full barrier; pairs with erts_msgq_shards_pending() */
+    res = (Sint) erts_smp_atomic_add_read_mb(&shards->len, (erts_aint_t) len);
+
+    erts_smp_spin_unlock(&shard->s.lock);
+
+    erts_proc_notify_new_message(receiver, 0);
+
+    return res - (Sint) len;
+}
+
+void
+erts_fetch_msgq_shards(Process *p, ErtsMsgQShards *shards)
+{
+    Sint len = 0;
+    int i;
+
+    ERTS_SMP_LC_ASSERT(ERTS_PROC_LOCK_MSGQ & erts_proc_lc_my_proc_locks(p));
+
+    if (!erts_smp_atomic_read_acqb(&shards->len))
+        return;
+
+    for (i = 0; i < shards->no_shards; i++) {
+        ErtsMsgQShard *shard = &shards->shard[i];
+        erts_smp_spin_lock(&shard->s.lock);
+        if (shard->s.q.first) {
+            LINK_MESSAGE_IMPL(p, shard->s.q.first, shard->s.q.last,
+                              shard->s.q.len, msg_inq);
+            len += shard->s.q.len;
+            shard->s.q.first = NULL;
+            shard->s.q.last = &shard->s.q.first;
+            shard->s.q.len = 0;
+        }
+        erts_smp_spin_unlock(&shard->s.lock);
+    }
+
+    if (len)
+        erts_smp_atomic_add_nob(&shards->len, (erts_aint_t) -len);
+}
+
+int
+erts_msgq_shards_pending(Process *p)
+{
+    ErtsMsgQShards *shards = ERTS_PROC_GET_MSGQ_SHARDS(p);
+    /* Full barrier; pairs with queue_messages_shard() */
+    return shards && erts_smp_atomic_read_mb(&shards->len) != 0;
+}
+
+void
+erts_free_msgq_shards(Process *p)
+{
+    ErtsMsgQShards *shards = ERTS_PROC_GET_MSGQ_SHARDS(p);
+    int i;
+
+    if (!shards)
+        return;
+
+    for (i = 0; i < shards->no_shards; i++) {
+        erts_cleanup_messages(shards->shard[i].s.q.first);
+        erts_smp_spinlock_destroy(&shards->shard[i].s.lock);
+    }
+    erts_smp_atomic_set_nob(&p->msgq_shards, (erts_aint_t) NULL);
+    erts_free(ERTS_ALC_T_MSGQ_SHARDS, shards->alloc);
+}
+
+static ErtsMsgQShards *
+create_msgq_shards(void)
+{
+    ErtsMsgQShards *shards;
+    char *alloc, *p;
+    int i, no_shards = (int) erts_no_schedulers;
+
+    alloc = erts_alloc(ERTS_ALC_T_MSGQ_SHARDS,
+                       (sizeof(ErtsMsgQShards)
+                        + ERTS_CACHE_LINE_SIZE
+                        + no_shards * sizeof(ErtsMsgQShard)));
+    shards = (ErtsMsgQShards *) alloc;
+    p = alloc + sizeof(ErtsMsgQShards);
+    if (((UWord) p) & ERTS_CACHE_LINE_MASK)
+        p += ERTS_CACHE_LINE_SIZE - (((UWord) p) & ERTS_CACHE_LINE_MASK);
+
+    shards->alloc = (void *) alloc;
+    erts_smp_atomic32_init_nob(&shards->enabled, 1);
+    erts_smp_atomic_init_nob(&shards->len, 0);
+    shards->no_shards = no_shards;
+    shards->shard = (ErtsMsgQShard *) p;
+    for (i = 0; i < no_shards; i++) {
+        ErtsMsgQShard *shard = &shards->shard[i];
+        erts_smp_spinlock_init(&shard->s.lock, "proc_msgq_shard");
+        shard->s.q.first = NULL;
+        shard->s.q.last = &shard->s.q.first;
+        shard->s.q.len = 0;
+    }
+    return shards;
+}
+
+#endif /* ERTS_SMP */
+
+Eterm
+erts_change_message_queue_shards(Process *c_p, Eterm new_state)
+{
+#ifdef ERTS_SMP
+    ErtsMsgQShards *shards;
+    Eterm res;
+
+    ERTS_SMP_LC_ASSERT(ERTS_PROC_LOCK_MAIN & erts_proc_lc_my_proc_locks(c_p));
+
+    shards = ERTS_PROC_GET_MSGQ_SHARDS(c_p);
+    if (shards && erts_smp_atomic32_read_nob(&shards->enabled))
+        res = am_true;
+    else
+        res = am_false;
+
+    switch (new_state) {
+    case am_true:
+        if (!shards)
+            erts_smp_atomic_set_relb(&c_p->msgq_shards,
+                                     (erts_aint_t) create_msgq_shards());
+        else
+            erts_smp_atomic32_set_nob(&shards->enabled, 1);
+        break;
+    case am_false:
+        /*
+         * The shards are kept until the process terminates, since
+         * senders may still refer to them. Messages already in them
+         * are fetched as usual.
+         */
+        if (shards)
+            erts_smp_atomic32_set_nob(&shards->enabled, 0);
+        break;
+    default:
+        return THE_NON_VALUE;
+    }
+    return res;
+#else
+    if (new_state != am_true && new_state != am_false)
+        return THE_NON_VALUE;
+    return am_false;
+#endif
+}
+
+/*
+ * Message queue index used by the recv_ref/1 instruction.
+ *
+ * The index maps references found as elements of tuple messages to
+ * the locations of the pointers to these messages in the private
+ * message queue. It covers the messages from the first message up to
+ * (but not including) the message pointed to by 'end'. Entries are
+ * kept in message queue order in each bucket, so the first matching
+ * entry found is the first message in the queue containing the
+ * reference. The indexed reference is not saved in the entry, since
+ * a garbage collection may move the message data; it is instead read
+ * from the message using the saved tuple position.
+ */
+
+#define ERTS_MSGQ_IX_MIN_LEN 64
+#define ERTS_MSGQ_IX_INIT_SIZE 64
+
+typedef struct ErtsMsgQIxEntry_ ErtsMsgQIxEntry;
+struct ErtsMsgQIxEntry_ {
+    ErtsMsgQIxEntry *next;
+    ErtsMessage **locp;		/* location of pointer to message */
+    Uint32 hval;
+    Uint32 pos;			/* position of reference in tuple */
+};
+
+typedef struct {
+    ErtsMsgQIxEntry *first;
+    ErtsMsgQIxEntry *last;
+} ErtsMsgQIxBucket;
+
+typedef struct ErtsMsgQIndex_ {
+    ErtsMessage **end;		/* location of first message not indexed */
+    Uint size;			/* number of buckets; a power of two */
+    Uint entries;
+    ErtsMsgQIxBucket *bucket;
+} ErtsMsgQIndex;
+
+static ERTS_INLINE Eterm
+msgq_ix_elem(ErtsMessage **locp, Uint32 pos)
+{
+    return tuple_val(ERL_MESSAGE_TERM(*locp))[pos];
+}
+
+static void
+msgq_ix_append(ErtsMsgQIndex *ix, ErtsMsgQIxEntry *ep)
+{
+    ErtsMsgQIxBucket *bp = &ix->bucket[ep->hval & (ix->size - 1)];
+    ep->next = NULL;
+    if (bp->last)
+	bp->last->next = ep;
+    else
+	bp->first = ep;
+    bp->last = ep;
+}
+
+static void
+msgq_ix_grow(ErtsMsgQIndex *ix)
+{
+    ErtsMsgQIxBucket *old = ix->bucket;
+    Uint i, old_size = ix->size;
+
+    /*
+     * The entries of each new bucket all come from the same old
+     * bucket, so the queue order in the buckets is kept.
+     */
+    ix->size *= 2;
+    ix->bucket = erts_alloc(ERTS_ALC_T_MSGQ_IX,
+			    sizeof(ErtsMsgQIxBucket)*ix->size);
+    sys_memzero(ix->bucket, sizeof(ErtsMsgQIxBucket)*ix->size);
+    for (i = 0; i < old_size; i++) {
+	ErtsMsgQIxEntry *ep = old[i].first;
+	while (ep) {
+	    ErtsMsgQIxEntry *next = ep->next;
+	    msgq_ix_append(ix, ep);
+	    ep = next;
+	}
+    }
+    erts_free(ERTS_ALC_T_MSGQ_IX, old);
+}
+
+static void
+msgq_ix_extend(ErtsMsgQIndex *ix)
+{
+    ErtsMessage **locp = ix->end;
+
+    while (*locp) {
+	Eterm msg = ERL_MESSAGE_TERM(*locp);
+	if (is_non_value(msg))
+	    break; /* Not yet decoded distribution message */
+	if (is_tuple(msg)) {
+	    Eterm *tp = tuple_val(msg);
+	    Uint32 pos, arity = (Uint32) arityval(*tp);
+	    for (pos = 1; pos <= arity; pos++) {
+		if (is_ref(tp[pos])) {
+		    ErtsMsgQIxEntry *ep = erts_alloc(ERTS_ALC_T_MSGQ_IX,
+						     sizeof(ErtsMsgQIxEntry));
+		    ep->locp = locp;
+		    ep->hval = make_internal_hash(tp[pos]);
+		    ep->pos = pos;
+		    if (++ix->entries > 2*ix->size)
+			msgq_ix_grow(ix);
+		    msgq_ix_append(ix, ep);
+		}
+	    }
+	}
+	locp = &(*locp)->next;
+    }
+    ix->end = locp;
+}
+
+/*
+ * Update the locations of the entries of message msgp (currently
+ * located at *oldpp) to newpp. If oldpp is NULL, the entries are
+ * removed instead.
+ */
+static void
+msgq_ix_update(ErtsMsgQIndex *ix, ErtsMessage *msgp,
+	       ErtsMessage **newpp, ErtsMessage **oldpp)
+{
+    Eterm msg = ERL_MESSAGE_TERM(msgp);
+    Eterm *tp;
+    Uint32 pos, arity;
+
+    if (is_non_value(msg) || is_not_tuple(msg))
+	return;
+
+    tp = tuple_val(msg);
+    arity = (Uint32) arityval(*tp);
+    for (pos = 1; pos <= arity; pos++) {
+	ErtsMsgQIxBucket *bp;
+	ErtsMsgQIxEntry *ep, *prev;
+	Uint32 hval;
+
+	if (!is_ref(tp[pos]))
+	    continue;
+
+	hval = make_internal_hash(tp[pos]);
+	bp = &ix->bucket[hval & (ix->size - 1)];
+	for (prev = NULL, ep = bp->first; ep; prev = ep, ep = ep->next) {
+	    if (ep->locp == oldpp && ep->pos == pos)
+		break;
+	}
+	if (!ep)
+	    continue;
+	if (newpp) {
+	    ep->locp = newpp;
+	    continue;
+	}
+	if (prev)
+	    prev->next = ep->next;
+	else
+	    bp->first = ep->next;
+	if (bp->last == ep)
+	    bp->last = prev;
+	erts_free(ERTS_ALC_T_MSGQ_IX, ep);
+	ix->entries--;
+    }
+}
+
+void
+erts_msgq_ix_free(ErlMessageQueue *msgq)
+{
+    ErtsMsgQIndex *ix = msgq->index;
+    Uint i;
+
+    if (!ix)
+	return;
+
+    for (i = 0; i < ix->size; i++) {
+	ErtsMsgQIxEntry *ep = ix->bucket[i].first;
+	while (ep) {
+	    ErtsMsgQIxEntry *next = ep->next;
+	    erts_free(ERTS_ALC_T_MSGQ_IX, ep);
+	    ep = next;
+	}
+    }
+    erts_free(ERTS_ALC_T_MSGQ_IX, ix->bucket);
+    erts_free(ERTS_ALC_T_MSGQ_IX, ix);
+    msgq->index = NULL;
+}
+
+/*
+ * Called by UNLINK_MESSAGE() before the message at msgq->save
+ * is unlinked.
+ */
+void
+erts_msgq_ix_unlink(ErlMessageQueue *msgq, ErtsMessage *msgp)
+{
+    ErtsMsgQIndex *ix = msgq->index;
+    ErtsMessage **locp = msgq->save;
+
+    ASSERT(*locp == msgp);
+
+    if (msgq->len <= ERTS_MSGQ_IX_MIN_LEN/4) {
+	erts_msgq_ix_free(msgq);
+	return;
+    }
+    if (ix->end == locp)
+	return; /* Message not indexed */
+
+    msgq_ix_update(ix, msgp, NULL, locp);
+    if (ix->end == &msgp->next)
+	ix->end = locp;
+    else if (msgp->next)
+	msgq_ix_update(ix, msgp->next, locp, &msgp->next);
+}
+
+/*
+ * Called when the pointer to message msgp is moved from oldpp
+ * to newpp.
+ */
+void
+erts_msgq_ix_move(ErlMessageQueue *msgq, ErtsMessage *msgp,
+		  ErtsMessage **newpp, ErtsMessage **oldpp)
+{
+    ErtsMsgQIndex *ix = msgq->index;
+
+    if (ix->end == oldpp)
+	ix->end = newpp;
+    else if (msgp)
+	msgq_ix_update(ix, msgp, newpp, oldpp);
+}
+
+/*
+ * Return the location of the pointer to the first message in the
+ * private message queue that may contain ref as an element of a
+ * tuple, or NULL if the message queue is too short to be indexed.
+ */
+ErtsMessage **
+erts_msgq_ix_lookup(Process *c_p, Eterm ref)
+{
+    ErtsMsgQIndex *ix = c_p->msg.index;
+    ErtsMsgQIxEntry *ep;
+    Uint32 hval;
+
+    ASSERT(is_ref(ref));
+
+    if (!ix) {
+	if (c_p->msg.len < ERTS_MSGQ_IX_MIN_LEN)
+	    return NULL;
+	ix = erts_alloc(ERTS_ALC_T_MSGQ_IX, sizeof(ErtsMsgQIndex));
+	ix->end = &c_p->msg.first;
+	ix->size = ERTS_MSGQ_IX_INIT_SIZE;
+	ix->entries = 0;
+	ix->bucket = erts_alloc(ERTS_ALC_T_MSGQ_IX,
+				sizeof(ErtsMsgQIxBucket)*ix->size);
+	sys_memzero(ix->bucket, sizeof(ErtsMsgQIxBucket)*ix->size);
+	c_p->msg.index = ix;
+    }
+
+    msgq_ix_extend(ix);
+
+    hval = make_internal_hash(ref);
+    for (ep = ix->bucket[hval & (ix->size - 1)].first; ep; ep = ep->next) {
+	if (ep->hval == hval && EQ(msgq_ix_elem(ep->locp, ep->pos), ref))
+	    return ep->locp;
+    }
+    return ix->end;
+}
+
 /* Add messages last in message queue */
 static Sint
 queue_messages(Process* receiver,
@@ -395,6 +848,16 @@ queue_messages(Process* receiver,
                        receiver_locks == erts_proc_lc_my_proc_locks(receiver));
 #endif
 
+    if (!receiver_locks && !IS_TRACED_FL(receiver, F_TRACE_RECEIVE)) {
+        ErtsMsgQShards *shards = ERTS_PROC_GET_MSGQ_SHARDS(receiver);
+        if (shards && erts_smp_atomic32_read_nob(&shards->enabled)) {
+            res = queue_messages_shard(receiver, shards,
+                                       first, last, len, from);
+            if (res >= 0)
+                return res;
+        }
+    }
+
     if (!(receiver_locks & ERTS_PROC_LOCK_MSGQ)) {
 	if (erts_smp_proc_trylock(receiver, ERTS_PROC_LOCK_MSGQ) == EBUSY) {
             ErtsProcLocks need_locks;
@@ -1628,7 +2091,7 @@ static void reserve_heap(ErtsHeapFactory* factory, Uint need, Uint xtra)
 	}
 
         if (bp) {
-	    ASSERT(factory->hp > bp->mem);
+	    ASSERT(factory->hp >= bp->mem);
 	    ASSERT(factory->hp <= factory->hp_end);
 	    ASSERT(factory->hp_end == bp->mem + bp->alloc_size);
 
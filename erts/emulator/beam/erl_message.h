@@ -172,6 +172,12 @@ typedef struct {
      */
     BeamInstr* mark;		/* address to rec_loop/2 instruction */
     ErtsMessage** saved_last;	/* saved last pointer */
+
+    /*
+     * Index on references in messages used by the recv_ref/1
+     * instruction. Built lazily when the queue is long.
+     */
+    struct ErtsMsgQIndex_ *index;
 } ErlMessageQueue;
 
 #ifdef ERTS_SMP
@@ -182,6 +188,36 @@ typedef struct {
     Sint len;            /* queue length */
 } ErlMessageInQueue;
 
+/*
+ * Sharded 'in queue' used when the process flag message_queue_shards
+ * is set. A sender always selects the same shard (by its own id), so
+ * that messages from one sender keep their order, and only takes the
+ * lock of that shard instead of the message queue lock of the
+ * receiver. The receiver moves the content of the shards into its
+ * 'in queue' whenever it moves the 'in queue' into its private queue.
+ * The content of the 'in queue' is always older than the content of
+ * the shards.
+ */
+typedef union {
+    struct {
+        erts_smp_spinlock_t lock;
+        ErlMessageInQueue q;
+    } s;
+    char align__[ERTS_ALC_CACHE_LINE_ALIGN_SIZE(
+            sizeof(erts_smp_spinlock_t) + sizeof(ErlMessageInQueue))];
+} ErtsMsgQShard;
+
+typedef struct {
+    void *alloc;
+    erts_smp_atomic32_t enabled;
+    erts_smp_atomic_t len;  /* Messages in the shards */
+    int no_shards;
+    ErtsMsgQShard *shard;
+} ErtsMsgQShards;
+
+#define ERTS_PROC_GET_MSGQ_SHARDS(P) \
+    ((ErtsMsgQShards *) erts_smp_atomic_read_ddrb(&(P)->msgq_shards))
+
 typedef struct erl_trace_message_queue__ {
     struct erl_trace_message_queue__ *next; /* point to the next receiver */
     Eterm receiver;
@@ -215,12 +251,37 @@ typedef struct erl_trace_message_queue__ {
         LINK_MESSAGE_IMPL(p, first_msg, last_msg, len, msg);            \
     } while (0)
 
+/* Move the content of the shards (if any) into the 'in queue' */
+#define ERTS_SMP_MSGQ_FETCH_SHARDS(p)                   \
+    do {                                                \
+        ErtsMsgQShards *shards__;                       \
+        shards__ = ERTS_PROC_GET_MSGQ_SHARDS(p);        \
+        if (shards__)                                   \
+            erts_fetch_msgq_shards(p, shards__);        \
+    } while (0)
+
 /* Add message last_msg in message queue */
-#define LINK_MESSAGE(p, first_msg, last_msg, len)       \
-    LINK_MESSAGE_IMPL(p, first_msg, last_msg, len, msg_inq)
+#define LINK_MESSAGE(p, first_msg, last_msg, len)                       \
+    do {                                                                \
+        ERTS_SMP_MSGQ_FETCH_SHARDS(p);                                  \
+        LINK_MESSAGE_IMPL(p, first_msg, last_msg, len, msg_inq);        \
+    } while (0)
+
+/*
+ * Make sure a process that is about to wait stays active if
+ * messages have been added to its shards. Called after
+ * ERTS_PSFLG_ACTIVE has been cleared.
+ */
+#define ERTS_SMP_MSGQ_SHARDS_CHK_WAIT(p)                                \
+    do {                                                                \
+        if (ERTS_PROC_GET_MSGQ_SHARDS(p) && erts_msgq_shards_pending(p)) \
+            erts_smp_atomic32_read_bor_nob(&(p)->state,                 \
+                                           ERTS_PSFLG_ACTIVE);          \
+    } while (0)
 
 #define ERTS_SMP_MSGQ_MV_INQ2PRIVQ(p)                   \
     do {                                                \
+        ERTS_SMP_MSGQ_FETCH_SHARDS(p);                  \
         if (p->msg_inq.first) {                         \
             *p->msg.last = p->msg_inq.first;            \
             p->msg.last = p->msg_inq.last;              \
@@ -234,6 +295,7 @@ typedef struct erl_trace_message_queue__ {
 #else
 
 #define ERTS_SMP_MSGQ_MV_INQ2PRIVQ(p)
+#define ERTS_SMP_MSGQ_SHARDS_CHK_WAIT(p)
 
 /* Add message last_msg in message queue */
 #define LINK_MESSAGE(p, first_msg, last_msg, len)                       \
@@ -246,6 +308,8 @@ typedef struct erl_trace_message_queue__ {
 /* Unlink current message */
 #define UNLINK_MESSAGE(p,msgp) do { \
      ErtsMessage* __mp = (msgp)->next; \
+     if ((p)->msg.index) \
+         erts_msgq_ix_unlink(&(p)->msg, (msgp)); \
      *(p)->msg.save = __mp; \
      (p)->msg.len--; \
      if (__mp == NULL) \
@@ -310,6 +374,18 @@ void erts_save_message_in_proc(Process *p, ErtsMessage *msg);
 Sint erts_move_messages_off_heap(Process *c_p);
 Sint erts_complete_off_heap_message_queue_change(Process *c_p);
 Eterm erts_change_message_queue_management(Process *c_p, Eterm new_state);
+#ifdef ERTS_SMP
+void erts_fetch_msgq_shards(Process *p, ErtsMsgQShards *shards);
+int erts_msgq_shards_pending(Process *p);
+void erts_free_msgq_shards(Process *p);
+#endif
+Eterm erts_change_message_queue_shards(Process *c_p, Eterm new_state);
+
+void erts_msgq_ix_unlink(ErlMessageQueue *msgq, ErtsMessage *msgp);
+void erts_msgq_ix_move(ErlMessageQueue *msgq, ErtsMessage *msgp,
+                       ErtsMessage **newpp, ErtsMessage **oldpp);
+ErtsMessage **erts_msgq_ix_lookup(Process *c_p, Eterm ref);
+void erts_msgq_ix_free(ErlMessageQueue *msgq);
 
 int erts_decode_dist_message(Process *, ErtsProcLocks, ErtsMessage *, int);
 
@@ -494,6 +570,8 @@ erts_msgq_replace_msg_ref(ErlMessageQueue *msgq, ErtsMessage *newp, ErtsMessage
     ErtsMessage *oldp = *oldpp;
     newp->next = oldp->next;
     erts_msgq_update_internal_pointers(msgq, &newp->next, &oldp->next);
+    if (msgq->index)
+	erts_msgq_ix_move(msgq, newp->next, &newp->next, &oldp->next);
     *oldpp = newp;
 }
 
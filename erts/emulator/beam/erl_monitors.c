@@ -30,6 +30,10 @@
  * monitor it is.
  * A monitor is removed either explicitly by reference or all monitors are 
  * removed when the process exits. No need to access the monitor by pid.
+ * When a monitor tree grows deep (a process monitoring or monitored by a
+ * large number of other processes) the root is replaced by a MON_HASH
+ * header, a hash table on the reference where each bucket is a small AVL
+ * tree. This is invisible to the users of the interface below.
  **************************************************************************/ 
 
 #ifdef HAVE_CONFIG_H
@@ -49,6 +53,11 @@
 #define STACK_NEED 50
 #define MAX_MONITORS 0xFFFFFFFFUL
 
+#define MON_HASH_DEPTH 10	/* Tree depth at which a monitor tree is
+				   turned into a hash table */
+#define MON_HASH_LOAD 4		/* Mean number of monitors per bucket */
+#define MON_HASH_MIN_BUCKETS 64
+
 #define DIR_LEFT 0
 #define DIR_RIGHT 1
 #define DIR_END 2 
@@ -60,26 +69,25 @@ static erts_smp_atomic_t tot_link_lh_size;
    No short local ref's should ever exist (the ref is created by the bif's 
    in runtime), therefore:
    All local ref's are less than external ref's
-   Local ref's are inline-compared,
+   Local ref's are compared word by word,
    External ref's are compared by cmp */
 
-#if 0   
-#define CMP_MON_REF(Ref1,Ref2) \
-cmp((Ref1),(Ref2)) /* XXX, the inline comparision yet to be done */
-#else
 #define CMP_MON_REF(Ref1,Ref2) cmp_mon_ref((Ref1),(Ref2))
-#endif
 
 static ERTS_INLINE int cmp_mon_ref(Eterm ref1, Eterm ref2) 
 {
     Eterm *b1, *b2;
-
+    int i;
 
     b1 = boxed_val(ref1);
     b2 = boxed_val(ref2);
     if (is_ref_thing_header(*b1)) {
 	if (is_ref_thing_header(*b2)) {
-	    return memcmp(b1+1,b2+1,ERTS_REF_WORDS*sizeof(Uint));
+	    for (i = 1; i <= ERTS_REF_WORDS; i++) {
+		if (b1[i] != b2[i])
+		    return b1[i] < b2[i] ? -1 : 1;
+	    }
+	    return 0;
 	}
 	return -1;
     }
@@ -88,7 +96,53 @@ static ERTS_INLINE int cmp_mon_ref(Eterm ref1, Eterm ref2)
     }
     return CMP(ref1,ref2);
 }
-	    
+
+/*
+ * Hash of a monitor reference. Only the first three ref numbers are
+ * used; missing numbers count as zero, which is consistent with how
+ * cmp treats external refs of different lengths. The first number is
+ * the low part of a counter and is deliberately left unmixed, so that
+ * refs created in sequence end up in neighbouring buckets.
+ */
+static ERTS_INLINE Uint32 mon_ref_hash(Eterm ref)
+{
+    Uint32 *nums;
+    Uint32 n0, n1 = 0, n2 = 0, h;
+    Uint len;
+
+    if (is_internal_ref(ref)) {
+	nums = internal_ref_numbers(ref);
+	len = internal_ref_no_of_numbers(ref);
+    } else {
+	nums = external_ref_numbers(ref);
+	len = external_ref_no_of_numbers(ref);
+    }
+    n0 = nums[0];
+    if (len > 1)
+	n1 = nums[1];
+    if (len > 2)
+	n2 = nums[2];
+    h = n0 ^ (n1 * 0x9E3779B1) ^ (n2 * 0x85EBCA77);
+    return h;
+}
+
+/* Must begin in a similar way as ErtsMonitor */
+typedef struct {
+    ErtsMonitor *left, *right;	/* Always NULL */
+    Sint16 balance;
+    Uint16 type;		/* MON_HASH */
+    Uint size;			/* Number of buckets, a power of 2 */
+    Uint count;			/* Number of monitors */
+    Uint sweep_ix;		/* Next bucket in a limited sweep */
+    ErtsMonitor *bucket[1];	/* Larger in reality */
+} ErtsMonitorHash;
+
+#define IS_MON_HASH(Root) ((Root) != NULL && (Root)->type == MON_HASH)
+#define MON_HASH_BUCKET(H, Ref) \
+    (&(H)->bucket[mon_ref_hash((Ref)) & ((H)->size - 1)])
+#define MON_HASH_ALLOC_SIZE(Size) \
+    (sizeof(ErtsMonitorHash) + ((Size) - 1)*sizeof(ErtsMonitor *))
+
 #define CP_LINK_VAL(To, Hp, From)				\
 do {								\
     if (IS_CONST(From))						\
@@ -329,8 +383,8 @@ static void insertion_rotation(int dstack[], int dpos,
     }
 }
 
-void erts_add_monitor(ErtsMonitor **root, Uint type, Eterm ref, Eterm pid, 
-		      Eterm name)
+/* Inserts an already created monitor, returns the depth it ended up at */
+static int insert_monitor(ErtsMonitor **root, ErtsMonitor *mon)
 {
     void *tstack[STACK_NEED];
     int tpos = 0;
@@ -344,9 +398,11 @@ void erts_add_monitor(ErtsMonitor **root, Uint type, Eterm ref, Eterm pid,
     for (;;) {
 	if (!*this) { /* Found our place */
 	    state = 1;
-	    *this = create_monitor(type,ref,pid,name);
+	    mon->left = mon->right = NULL;
+	    mon->balance = 0;
+	    *this = mon;
 	    break;
-	} else if ((c = CMP_MON_REF(ref,(*this)->ref)) < 0) { 
+	} else if ((c = CMP_MON_REF(mon->ref,(*this)->ref)) < 0) { 
 	    /* go left */
 	    dstack[dpos++] = DIR_LEFT;
 	    tstack[tpos++] = this;
@@ -361,6 +417,115 @@ void erts_add_monitor(ErtsMonitor **root, Uint type, Eterm ref, Eterm pid,
 	}
     }
     insertion_rotation(dstack, dpos, tstack, tpos, state);
+    return dpos;
+}
+
+/*
+ * Unlinks the leftmost node of a tree that is being torn down. The
+ * rotations leave the tree unbalanced, which does not matter since
+ * nothing is inserted into it again; each node is rotated at most
+ * once, so emptying a tree this way is linear.
+ */
+static ErtsMonitorOrLink *pop_tree_node(ErtsMonitorOrLink **root)
+{
+    ErtsMonitorOrLink *p = *root, *l;
+
+    while ((l = p->left) != NULL) {
+	p->left = l->right;
+	l->right = p;
+	p = l;
+    }
+    *root = p->right;
+    return p;
+}
+
+static ErtsMonitorHash *create_monitor_hash(Uint size)
+{
+    ErtsMonitorHash *h;
+    Uint sz = MON_HASH_ALLOC_SIZE(size);
+    Uint i;
+
+    h = (ErtsMonitorHash *) erts_alloc(ERTS_ALC_T_MONITOR_LH, sz);
+    erts_smp_atomic_add_nob(&tot_link_lh_size, sz);
+    h->left = h->right = NULL;
+    h->balance = 0;
+    h->type = MON_HASH;
+    h->size = size;
+    h->count = 0;
+    h->sweep_ix = 0;
+    for (i = 0; i < size; i++)
+	h->bucket[i] = NULL;
+    return h;
+}
+
+static void destroy_monitor_hash(ErtsMonitorHash *h)
+{
+    erts_smp_atomic_add_nob(&tot_link_lh_size,
+			    -1*MON_HASH_ALLOC_SIZE(h->size));
+    erts_free(ERTS_ALC_T_MONITOR_LH, (void *) h);
+}
+
+/* Moves all monitors in the tree 'from' into the hash table 'h' */
+static void rehash_monitor_tree(ErtsMonitorHash *h, ErtsMonitor *from)
+{
+    ErtsMonitor *mon;
+
+    while (from) {
+	mon = (ErtsMonitor *) pop_tree_node((ErtsMonitorOrLink **) &from);
+	insert_monitor(MON_HASH_BUCKET(h, mon->ref), mon);
+	h->count++;
+    }
+}
+
+static void resize_monitor_hash(ErtsMonitor **root, Uint size)
+{
+    ErtsMonitorHash *old = (ErtsMonitorHash *) *root;
+    ErtsMonitorHash *new = create_monitor_hash(size);
+    Uint i;
+
+    for (i = 0; i < old->size; i++)
+	rehash_monitor_tree(new, old->bucket[i]);
+    ASSERT(new->count == old->count);
+    destroy_monitor_hash(old);
+    *root = (ErtsMonitor *) new;
+}
+
+static void count_one_monitor(ErtsMonitor *mon, void *vcount)
+{
+    (*(Uint *) vcount)++;
+}
+
+static void sweep_monitor_tree(ErtsMonitor *root,
+			       void (*doit)(ErtsMonitor *, void *),
+			       void *context);
+
+/* Turns a deep monitor tree into a hash table */
+static void hash_monitor_tree(ErtsMonitor **root)
+{
+    ErtsMonitorHash *h;
+    Uint count = 0, size = MON_HASH_MIN_BUCKETS;
+
+    sweep_monitor_tree(*root, &count_one_monitor, &count);
+    while (size * MON_HASH_LOAD < count)
+	size <<= 1;
+    h = create_monitor_hash(size);
+    rehash_monitor_tree(h, *root);
+    *root = (ErtsMonitor *) h;
+}
+
+void erts_add_monitor(ErtsMonitor **root, Uint type, Eterm ref, Eterm pid, 
+		      Eterm name)
+{
+    ErtsMonitor *mon = create_monitor(type,ref,pid,name);
+
+    if (IS_MON_HASH(*root)) {
+	ErtsMonitorHash *h = (ErtsMonitorHash *) *root;
+	insert_monitor(MON_HASH_BUCKET(h, ref), mon);
+	if (++h->count > h->size * MON_HASH_LOAD)
+	    resize_monitor_hash(root, h->size << 1);
+    } else if (insert_monitor(root, mon) > MON_HASH_DEPTH) {
+	hash_monitor_tree(root);
+    }
 }
 
 
@@ -597,7 +762,7 @@ static int delsub(ErtsMonitorOrLink **this)
     return h;
 }
 
-ErtsMonitor *erts_remove_monitor(ErtsMonitor **root, Eterm ref) 
+static ErtsMonitor *remove_monitor(ErtsMonitor **root, Eterm ref) 
 {
     ErtsMonitor **tstack[STACK_NEED];
     int tpos = 0;
@@ -648,6 +813,29 @@ ErtsMonitor *erts_remove_monitor(ErtsMonitor **root, Eterm ref)
     return q;
 }
 
+ErtsMonitor *erts_remove_monitor(ErtsMonitor **root, Eterm ref) 
+{
+    ErtsMonitorHash *h;
+    ErtsMonitor *mon;
+
+    if (!IS_MON_HASH(*root))
+	return remove_monitor(root, ref);
+
+    h = (ErtsMonitorHash *) *root;
+    mon = remove_monitor(MON_HASH_BUCKET(h, ref), ref);
+    if (mon) {
+	ASSERT(h->count > 0);
+	if (--h->count == 0) {
+	    destroy_monitor_hash(h);
+	    *root = NULL;
+	} else if (h->size > MON_HASH_MIN_BUCKETS
+		   && h->count * MON_HASH_LOAD < h->size / 2) {
+	    resize_monitor_hash(root, h->size >> 1);
+	}
+    }
+    return mon;
+}
+
 ErtsLink *erts_remove_link(ErtsLink **root, Eterm pid) 
 {
     ErtsLink **tstack[STACK_NEED];
@@ -756,6 +944,9 @@ ErtsMonitor *erts_lookup_monitor(ErtsMonitor *root, Eterm ref)
 {
     Sint c;
 
+    if (IS_MON_HASH(root))
+	root = *MON_HASH_BUCKET((ErtsMonitorHash *) root, ref);
+
     for (;;) {
 	if (root == NULL || (c = CMP_MON_REF(ref,root->ref)) == 0) {
 	    return root;
@@ -798,9 +989,9 @@ erts_lookup_suspend_monitor(ErtsSuspendMonitor *root, Eterm pid)
     }
 }
 
-void erts_sweep_monitors(ErtsMonitor *root, 
-			 void (*doit)(ErtsMonitor *, void *),
-			 void *context) 
+static void sweep_monitor_tree(ErtsMonitor *root,
+			       void (*doit)(ErtsMonitor *, void *),
+			       void *context)
 {
     ErtsMonitor *tstack[STACK_NEED];
     int tpos = 0;
@@ -834,6 +1025,76 @@ void erts_sweep_monitors(ErtsMonitor *root,
     }
 }
 
+void erts_sweep_monitors(ErtsMonitor *root, 
+			 void (*doit)(ErtsMonitor *, void *),
+			 void *context) 
+{
+    if (IS_MON_HASH(root)) {
+	ErtsMonitorHash *h = (ErtsMonitorHash *) root;
+	Uint i;
+	for (i = 0; i < h->size; i++)
+	    sweep_monitor_tree(h->bucket[i], doit, context);
+	destroy_monitor_hash(h);
+    } else {
+	sweep_monitor_tree(root, doit, context);
+    }
+}
+
+/* As erts_sweep_monitors() but leaves the monitors in place */
+void erts_doforall_monitors(ErtsMonitor *root,
+			    void (*doit)(ErtsMonitor *, void *),
+			    void *context)
+{
+    if (IS_MON_HASH(root)) {
+	ErtsMonitorHash *h = (ErtsMonitorHash *) root;
+	Uint i;
+	for (i = 0; i < h->size; i++)
+	    sweep_monitor_tree(h->bucket[i], doit, context);
+    } else {
+	sweep_monitor_tree(root, doit, context);
+    }
+}
+
+/*
+ * Sweeps at most 'limit' monitors out of the detached set in *root and
+ * returns the number swept. *root is NULL when the set is empty, and
+ * otherwise holds what is left for the next call.
+ */
+Sint erts_sweep_monitors_limited(ErtsMonitor **root,
+				 void (*doit)(ErtsMonitor *, void *),
+				 void *context,
+				 Sint limit)
+{
+    ErtsMonitor *mon;
+    Sint swept = 0;
+
+    if (IS_MON_HASH(*root)) {
+	ErtsMonitorHash *h = (ErtsMonitorHash *) *root;
+	ErtsMonitor **bucket = &h->bucket[h->sweep_ix];
+	while (swept < limit) {
+	    while (!*bucket) {
+		ASSERT(h->sweep_ix < h->size);
+		bucket = &h->bucket[++h->sweep_ix];
+	    }
+	    mon = (ErtsMonitor *) pop_tree_node((ErtsMonitorOrLink **) bucket);
+	    (*doit)(mon, context);
+	    swept++;
+	    if (--h->count == 0) {
+		destroy_monitor_hash(h);
+		*root = NULL;
+		break;
+	    }
+	}
+    } else {
+	while (*root && swept < limit) {
+	    mon = (ErtsMonitor *) pop_tree_node((ErtsMonitorOrLink **) root);
+	    (*doit)(mon, context);
+	    swept++;
+	}
+    }
+    return swept;
+}
+
 void erts_sweep_links(ErtsLink *root, 
 		      void (*doit)(ErtsLink *, void *),
 		      void *context) 
@@ -870,6 +1131,22 @@ void erts_sweep_links(ErtsLink *root,
     }
 }
 
+/* See erts_sweep_monitors_limited() */
+Sint erts_sweep_links_limited(ErtsLink **root,
+			      void (*doit)(ErtsLink *, void *),
+			      void *context,
+			      Sint limit)
+{
+    Sint swept = 0;
+
+    while (*root && swept < limit) {
+	(*doit)((ErtsLink *) pop_tree_node((ErtsMonitorOrLink **) root),
+		context);
+	swept++;
+    }
+    return swept;
+}
+
 void erts_sweep_suspend_monitors(ErtsSuspendMonitor *root,
 				 void (*doit)(ErtsSuspendMonitor *, void *),
 				 void *context)
@@ -913,6 +1190,14 @@ static void erts_dump_monitors(ErtsMonitor *root, int indent)
 {
     if (root == NULL)
 	return;
+    if (IS_MON_HASH(root)) {
+	ErtsMonitorHash *h = (ErtsMonitorHash *) root;
+	Uint i;
+	erts_printf("%*s[hash:%bpu:%bpu]\n", indent, "", h->size, h->count);
+	for (i = 0; i < h->size; i++)
+	    erts_dump_monitors(h->bucket[i], indent+2);
+	return;
+    }
     erts_dump_monitors(root->right,indent+2);
     erts_printf("%*s[%b16d:%b16u:%T:%T:%T]\n", indent, "", root->balance,
 		root->type, root->ref, root->pid, root->name);
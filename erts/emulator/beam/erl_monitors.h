@@ -20,7 +20,8 @@
 
 /**********************************************************************
  * Header for monitors and links data structures.
- * Monitors are kept in an AVL tree and the data structures for
+ * Monitors are kept in an AVL tree (which is turned into a hash table
+ * of AVL trees when it grows large) and the data structures for
  * the four different types of monitors are like this:
  **********************************************************************
  * Local monitor by pid/port: 
@@ -84,6 +85,8 @@
 #define MON_ORIGIN 1
 #define MON_TARGET 3
 #define MON_TIME_OFFSET 7
+#define MON_HASH 15 /* Root of a hashed monitor set, never seen by users
+		       of the API */
 
 /* Type tags for links */
 #define LINK_PID 1   /* ...Or port */
@@ -151,6 +154,13 @@ ErtsMonitor *erts_lookup_monitor(ErtsMonitor *root, Eterm ref);
 void erts_sweep_monitors(ErtsMonitor *root, 
 			 void (*doit)(ErtsMonitor *, void *),
 			 void *context);
+void erts_doforall_monitors(ErtsMonitor *root,
+			    void (*doit)(ErtsMonitor *, void *),
+			    void *context);
+Sint erts_sweep_monitors_limited(ErtsMonitor **root,
+				 void (*doit)(ErtsMonitor *, void *),
+				 void *context,
+				 Sint limit);
 
 void erts_destroy_link(ErtsLink *lnk);
 /* Returns 0 if OK, < 0 if already present */
@@ -161,6 +171,10 @@ ErtsLink *erts_lookup_link(ErtsLink *root, Eterm pid);
 void erts_sweep_links(ErtsLink *root, 
 		      void (*doit)(ErtsLink *, void *),
 		      void *context);
+Sint erts_sweep_links_limited(ErtsLink **root,
+			      void (*doit)(ErtsLink *, void *),
+			      void *context,
+			      Sint limit);
 
 void erts_destroy_suspend_monitor(ErtsSuspendMonitor *sproc);
 void erts_sweep_suspend_monitors(ErtsSuspendMonitor *root,
@@ -175,7 +189,6 @@ void erts_init_monitors(void);
 void erts_one_link_size(ErtsLink *lnk, void *vpu);
 void erts_one_mon_size(ErtsMonitor *mon, void *vpu);
 
-#define erts_doforall_monitors erts_sweep_monitors
 #define erts_doforall_links erts_sweep_links
 #define erts_doforall_suspend_monitors erts_sweep_suspend_monitors
 
@@ -126,6 +126,7 @@ dist_table_alloc(void *dep_tmpl)
     erts_port_task_handle_init(&dep->dist_cmd);
     dep->send				= NULL;
     dep->cache				= NULL;
+    dep->fragments			= NULL;
 
     /* Link in */
 
@@ -173,6 +174,7 @@ dist_table_free(void *vdep)
     erts_no_of_not_connected_dist_entries--;
 
     ASSERT(!dep->cache);
+    ASSERT(!dep->fragments);
     erts_smp_rwmtx_destroy(&dep->rwmtx);
     erts_smp_mtx_destroy(&dep->lnk_mtx);
     erts_smp_mtx_destroy(&dep->qlock);
@@ -1283,6 +1285,33 @@ insert_delayed_delete_dist_entry(void *state,
     UnUseTmpHeapNoproc(3);
 }
 
+static void
+insert_messages(ErtsMessage *msg, Eterm id)
+{
+    for (; msg; msg = msg->next) {
+	ErlHeapFragment *heap_frag = NULL;
+	if (msg->data.attached) {
+	    if (msg->data.attached == ERTS_MSG_COMBINED_HFRAG)
+		heap_frag = &msg->hfrag;
+	    else if (is_value(ERL_MESSAGE_TERM(msg)))
+		heap_frag = msg->data.heap_frag;
+	    else {
+		if (msg->data.dist_ext->dep)
+		    insert_dist_entry(msg->data.dist_ext->dep,
+				      HEAP_REF, id, 0);
+		if (is_not_nil(ERL_MESSAGE_TOKEN(msg)))
+		    heap_frag = erts_dist_ext_trailer(msg->data.dist_ext);
+	    }
+	}
+	while (heap_frag) {
+	    insert_offheap(&(heap_frag->off_heap),
+			   HEAP_REF,
+			   id);
+	    heap_frag = heap_frag->next;
+	}
+    }
+}
+
 static void
 setup_reference_table(void)
 {
@@ -1335,6 +1364,9 @@ setup_reference_table(void)
 	Process *proc = erts_pix2proc(i);
 	if (proc) {
 	    int mli;
+#ifdef ERTS_SMP
+	    ErtsMsgQShards *shards;
+#endif
 	    ErtsMessage *msg_list[] = {
 		proc->msg.first,
 #ifdef ERTS_SMP
@@ -1353,31 +1385,17 @@ setup_reference_table(void)
 			       proc->common.id);
 
 	    /* Insert msg buffers */
-	    for (mli = 0; mli < sizeof(msg_list)/sizeof(msg_list[0]); mli++) {
-		ErtsMessage *msg;
-		for (msg = msg_list[mli]; msg; msg = msg->next) {
-		    ErlHeapFragment *heap_frag = NULL;
-		    if (msg->data.attached) {
-			if (msg->data.attached == ERTS_MSG_COMBINED_HFRAG)
-			    heap_frag = &msg->hfrag;
-			else if (is_value(ERL_MESSAGE_TERM(msg)))
-			    heap_frag = msg->data.heap_frag;
-			else {
-			    if (msg->data.dist_ext->dep)
-				insert_dist_entry(msg->data.dist_ext->dep,
-						  HEAP_REF, proc->common.id, 0);
-			    if (is_not_nil(ERL_MESSAGE_TOKEN(msg)))
-				heap_frag = erts_dist_ext_trailer(msg->data.dist_ext);
-			}
-		    }
-		    while (heap_frag) {
-			insert_offheap(&(heap_frag->off_heap),
-				       HEAP_REF,
-				       proc->common.id);
-			heap_frag = heap_frag->next;
-		    }
-		}
+	    for (mli = 0; mli < sizeof(msg_list)/sizeof(msg_list[0]); mli++)
+		insert_messages(msg_list[mli], proc->common.id);
+#ifdef ERTS_SMP
+	    shards = ERTS_PROC_GET_MSGQ_SHARDS(proc);
+	    if (shards) {
+		int si;
+		for (si = 0; si < shards->no_shards; si++)
+		    insert_messages(shards->shard[si].s.q.first,
+				    proc->common.id);
 	    }
+#endif
 	    /* Insert links */
 	    if (ERTS_P_LINKS(proc))
 		insert_links(ERTS_P_LINKS(proc), proc->common.id);
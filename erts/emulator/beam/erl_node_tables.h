@@ -81,6 +81,10 @@ struct ErtsDistOutputBuf_ {
     ErtsDistOutputBuf *next;
     byte *extp;
     byte *ext_endp;
+    byte *hdrp;			/* Fragment header, or NULL */
+    byte *hdr_endp;
+    struct binary *ext_bin;	/* Binary holding extp..ext_endp if not
+				   this buffer; used by fragments */
     byte data[1];
 };
 
@@ -145,6 +149,9 @@ typedef struct dist_entry_ {
     Uint (*send)(Port *prt, ErtsDistOutputBuf *obuf);
 
     struct cache* cache;	/* The atom cache */
+    struct ErtsDistFragments_ *fragments; /* Fragmented messages being
+					     reassembled; protected by
+					     the port lock */
 } DistEntry;
 
 typedef struct erl_node_ {
@@ -598,6 +598,16 @@ reset_executed_io_task_handle(ErtsPortTask *ptp)
     }
 }
 
+static ERTS_INLINE void
+reset_aborted_io_task_handle(ErtsPortTask *ptp)
+{
+    if (ptp->u.alive.handle) {
+	ASSERT(ptp == handle2task(ptp->u.alive.handle));
+	erts_io_notify_port_task_aborted(ptp->u.alive.handle);
+	reset_port_task_handle(ptp->u.alive.handle);
+    }
+}
+
 static ERTS_INLINE void
 set_handle(ErtsPortTask *ptp, ErtsPortTaskHandle *pthp)
 {
@@ -1325,6 +1335,7 @@ erts_port_task_abort(ErtsPortTaskHandle *pthp)
 		ASSERT(erts_smp_atomic_read_nob(
 			   &erts_port_task_outstanding_io_tasks) > 0);
 		erts_smp_atomic_dec_relb(&erts_port_task_outstanding_io_tasks);
+		erts_io_notify_port_task_aborted(pthp);
 		break;
 	    default:
 		break;
@@ -2048,7 +2059,12 @@ begin_port_cleanup(Port *pp, ErtsPortTask **execqp, int *processing_busy_q_p)
 		goto aborted_port_task;
 	    }
 
-	    reset_handle(ptp);
+	    if (ptp->type == ERTS_PORT_TASK_INPUT
+		|| ptp->type == ERTS_PORT_TASK_OUTPUT
+		|| ptp->type == ERTS_PORT_TASK_EVENT)
+		reset_aborted_io_task_handle(ptp);
+	    else
+		reset_handle(ptp);
 
 	    switch (ptp->type) {
 	    case ERTS_PORT_TASK_TIMEOUT:
@@ -449,7 +449,8 @@ typedef enum {
     ERTS_PSTT_GC,	/* Garbage Collect */
     ERTS_PSTT_CPC,	/* Check Process Code */
     ERTS_PSTT_COHMQ,    /* Change off heap message queue */
-    ERTS_PSTT_FTMQ      /* Flush trace msg queue */
+    ERTS_PSTT_FTMQ,     /* Flush trace msg queue */
+    ERTS_PSTT_CLA       /* Copy Literal Area */
 } ErtsProcSysTaskType;
 
 #define ERTS_MAX_PROC_SYS_TASK_ARGS 2
@@ -579,6 +580,7 @@ dbg_chk_aux_work_val(erts_aint32_t value)
 
     valid |= ERTS_SSI_AUX_WORK_SET_TMO;
     valid |= ERTS_SSI_AUX_WORK_MISC;
+    valid |= ERTS_SSI_AUX_WORK_EXIT_SWEEP;
     valid |= ERTS_SSI_AUX_WORK_FIX_ALLOC_LOWER_LIM;
     valid |= ERTS_SSI_AUX_WORK_FIX_ALLOC_DEALLOC;
 #if ERTS_USE_ASYNC_READY_Q
@@ -619,6 +621,7 @@ dbg_chk_aux_work_val(erts_aint32_t value)
 static void do_handle_pending_exiters(ErtsProcList *);
 static void wake_scheduler(ErtsRunQueue *rq);
 #endif
+static int continue_exit_sweep(ErtsAuxWorkData *awdp);
 
 #if defined(ERTS_SMP) && defined(ERTS_ENABLE_LOCK_CHECK)
 int
@@ -686,6 +689,8 @@ erts_pre_init_process(void)
 	= "MISC";
     erts_aux_work_flag_descr[ERTS_SSI_AUX_WORK_PENDING_EXITERS_IX]
 	= "PENDING_EXITERS";
+    erts_aux_work_flag_descr[ERTS_SSI_AUX_WORK_EXIT_SWEEP_IX]
+	= "EXIT_SWEEP";
     erts_aux_work_flag_descr[ERTS_SSI_AUX_WORK_SET_TMO_IX]
 	= "SET_TMO";
     erts_aux_work_flag_descr[ERTS_SSI_AUX_WORK_MSEG_CACHE_CHECK_IX]
@@ -2367,6 +2372,16 @@ handle_pending_exiters(ErtsAuxWorkData *awdp, erts_aint32_t aux_work, int waitin
 
 #endif
 
+static ERTS_INLINE erts_aint32_t
+handle_exit_sweep(ErtsAuxWorkData *awdp, erts_aint32_t aux_work, int waiting)
+{
+    if (continue_exit_sweep(awdp))
+	return aux_work;
+
+    unset_aux_work_flags(awdp->ssi, ERTS_SSI_AUX_WORK_EXIT_SWEEP);
+    return aux_work & ~ERTS_SSI_AUX_WORK_EXIT_SWEEP;
+}
+
 static ERTS_INLINE erts_aint32_t
 handle_setup_aux_work_timer(ErtsAuxWorkData *awdp, erts_aint32_t aux_work, int waiting)
 {
@@ -2463,6 +2478,9 @@ handle_aux_work(ErtsAuxWorkData *awdp, erts_aint32_t orig_aux_work, int waiting)
 		    handle_pending_exiters);
 #endif
 
+    HANDLE_AUX_WORK(ERTS_SSI_AUX_WORK_EXIT_SWEEP,
+		    handle_exit_sweep);
+
     HANDLE_AUX_WORK(ERTS_SSI_AUX_WORK_SET_TMO,
 		    handle_setup_aux_work_timer);
 
@@ -3779,6 +3797,154 @@ check_requeue_process(ErtsRunQueue *rq, int prio_q)
     return 0;
 }
 
+#ifdef ERTS_SMP
+
+/*
+ * The local run queue is a bounded lock-free queue of normal priority
+ * processes. Only the scheduler owning the run queue pushes processes
+ * (at tail), while processes are taken (at head) both by the owner and
+ * by schedulers stealing work. Processes are taken in FIFO order by
+ * updating head using compare and exchange.
+ */
+
+#define ERTS_RUNQ_LOCAL_MAX_STEAL 32
+
+static ERTS_INLINE erts_aint32_t
+runq_local_len(ErtsRunQueue *rq)
+{
+    /* head has to be read before tail... */
+    Uint32 head = (Uint32) erts_smp_atomic32_read_acqb(&rq->local.head);
+    Uint32 tail = (Uint32) erts_smp_atomic32_read_acqb(&rq->local.tail);
+    return (erts_aint32_t) (tail - head);
+}
+
+static ERTS_INLINE int
+runq_local_push(ErtsRunQueue *rq, Process *p)
+{
+    Uint32 head = (Uint32) erts_smp_atomic32_read_acqb(&rq->local.head);
+    Uint32 tail = (Uint32) erts_smp_atomic32_read_nob(&rq->local.tail);
+
+    if (tail - head >= ERTS_RUNQ_LOCAL_SIZE)
+	return 0; /* Full */
+
+    p->schedule_count = 1;
+    erts_smp_atomic_set_nob(&rq->local.proc[tail & ERTS_RUNQ_LOCAL_MASK],
+			    (erts_aint_t) p);
+    erts_smp_atomic32_set_relb(&rq->local.tail, (erts_aint32_t) (tail + 1));
+    return 1;
+}
+
+/*
+ * Take at most max processes from the local run queue of rq. If
+ * half is set, take at most half of the processes in the queue
+ * (rounded up).
+ */
+static ERTS_INLINE int
+runq_local_take(ErtsRunQueue *rq, Process **procs, int max, int half)
+{
+    while (1) {
+	Uint32 head, tail, n, i;
+
+	head = (Uint32) erts_smp_atomic32_read_acqb(&rq->local.head);
+	tail = (Uint32) erts_smp_atomic32_read_acqb(&rq->local.tail);
+	n = tail - head;
+	if (n == 0)
+	    return 0;
+	if (half)
+	    n -= n / 2;
+	if (n > (Uint32) max)
+	    n = (Uint32) max;
+	/*
+	 * The slots may be reused by the owner if other threads
+	 * take the processes before us, in which case the
+	 * compare and exchange below fails...
+	 */
+	for (i = 0; i < n; i++)
+	    procs[i] = (Process *) erts_smp_atomic_read_nob(
+		&rq->local.proc[(head + i) & ERTS_RUNQ_LOCAL_MASK]);
+	if (erts_smp_atomic32_cmpxchg_mb(&rq->local.head,
+					 (erts_aint32_t) (head + n),
+					 (erts_aint32_t) head)
+	    == (erts_aint32_t) head)
+	    return (int) n;
+    }
+}
+
+static ERTS_INLINE Process *
+runq_local_pop(ErtsRunQueue *rq)
+{
+    Process *p;
+    if (!runq_local_take(rq, &p, 1, 0))
+	return NULL;
+    return p;
+}
+
+/*
+ * Move all processes in the local run queue into the ordinary
+ * (locked) normal priority queue. Called by the owner of the run
+ * queue.
+ */
+static void
+runq_local_flush(ErtsRunQueue *rq)
+{
+    Process *procs[ERTS_RUNQ_LOCAL_MAX_STEAL];
+    int i, n;
+
+    ERTS_SMP_LC_ASSERT(erts_smp_lc_runq_is_locked(rq));
+
+    while ((n = runq_local_take(rq, procs, ERTS_RUNQ_LOCAL_MAX_STEAL, 0))) {
+	for (i = 0; i < n; i++)
+	    enqueue_process(rq, PRIORITY_NORMAL, procs[i]);
+    }
+}
+
+/*
+ * Include processes in the local run queue in the max length
+ * statistics used when balancing.
+ */
+static ERTS_INLINE void
+runq_local_update_max_len(ErtsRunQueue *rq)
+{
+    erts_aint32_t len, llen = runq_local_len(rq);
+
+    ERTS_SMP_LC_ASSERT(erts_smp_lc_runq_is_locked(rq));
+
+    if (llen) {
+	ErtsRunQueueInfo *rqi = &rq->procs.prio_info[PRIORITY_NORMAL];
+	len = erts_smp_atomic32_read_dirty(&rq->len) + llen;
+	if (rq->max_len < len)
+	    rq->max_len = len;
+	len = erts_smp_atomic32_read_dirty(&rqi->len) + llen;
+	if (rqi->max_len < len)
+	    rqi->max_len = len;
+    }
+}
+
+/*
+ * Try to push a process that is about to be enqueued in runq into
+ * the local run queue. This is only done when the current thread is
+ * the scheduler owning runq executing a process or a port, since the
+ * scheduler then will inspect the local run queue before it waits
+ * for more work.
+ */
+static ERTS_INLINE int
+try_enqueue_local(ErtsRunQueue *runq, int prio, Process *p,
+		  erts_aint32_t state)
+{
+    ErtsSchedulerData *esdp;
+
+    if (prio != PRIORITY_NORMAL || (state & ERTS_PSFLG_BOUND))
+	return 0;
+    esdp = erts_get_scheduler_data();
+    if (!esdp || esdp->run_queue != runq)
+	return 0;
+    if (!esdp->current_process && !esdp->current_port)
+	return 0;
+    return runq_local_push(runq, p);
+}
+
+#endif /* ERTS_SMP */
+
 static ERTS_INLINE void
 free_proxy_proc(Process *proxy)
 {
@@ -4060,6 +4226,7 @@ evacuate_run_queue(ErtsRunQueue *rq,
     {
 	mps = erts_get_migration_paths_managed();
 	mp = &mps->mpath[rq->ix];
+	runq_local_flush(rq);
     }
 
     /* Evacuate scheduled misc ops */
@@ -4262,6 +4429,26 @@ try_steal_task_from_victim(ErtsRunQueue *rq, int *rq_lockedp, ErtsRunQueue *vrq,
 
     ERTS_SMP_LC_ASSERT(!erts_smp_lc_runq_is_locked(rq));
 
+    if (!(procs_qmask & (MAX_BIT|HIGH_BIT)) && !rq->halt_in_progress) {
+	/*
+	 * Steal up to half of the processes in the local run queue
+	 * of the victim without locking it...
+	 */
+	Process *procs[ERTS_RUNQ_LOCAL_MAX_STEAL];
+	int i, n = runq_local_take(vrq, procs, ERTS_RUNQ_LOCAL_MAX_STEAL, 1);
+	if (n) {
+	    erts_smp_runq_lock(rq);
+	    *rq_lockedp = 1;
+	    for (i = 0; i < n; i++) {
+		ASSERT(!(ERTS_PSFLG_BOUND
+			 & erts_smp_atomic32_read_nob(&procs[i]->state)));
+		RUNQ_SET_RQ(&procs[i]->run_queue, rq);
+		enqueue_process(rq, PRIORITY_NORMAL, procs[i]);
+	    }
+	    return !0;
+	}
+    }
+
     erts_smp_runq_lock(vrq);
 
     if (rq->halt_in_progress)
@@ -5334,6 +5521,7 @@ wakeup_other_check(ErtsRunQueue *rq, Uint32 flags)
     int wo_reds = rq->wakeup_other_reds;
     if (wo_reds) {
 	int left_len = erts_smp_atomic32_read_dirty(&rq->len) - 1;
+	left_len += runq_local_len(rq);
 	if (left_len < 1) {
 	    int wo_reduce = wo_reds << wakeup_other.dec_shift;
 	    wo_reduce &= wakeup_other.dec_mask;
@@ -5407,6 +5595,7 @@ wakeup_other_check_legacy(ErtsRunQueue *rq, Uint32 flags)
     int wo_reds = rq->wakeup_other_reds;
     if (wo_reds) {
 	erts_aint32_t len = erts_smp_atomic32_read_dirty(&rq->len);
+	len += runq_local_len(rq);
 	if (len < 2) {
 	    rq->wakeup_other -= ERTS_WAKEUP_OTHER_DEC_LEGACY*wo_reds;
 	    if (rq->wakeup_other < 0)
@@ -5668,6 +5857,8 @@ init_aux_work_data(ErtsAuxWorkData *awdp, ErtsSchedulerData *esdp, char *dawwp)
 #endif
     awdp->async_ready.queue = NULL;
 #endif
+    awdp->exit_sweep.first = NULL;
+    awdp->exit_sweep.last = NULL;
 #ifdef ERTS_SMP
     awdp->delayed_wakeup.next = ERTS_DELAYED_WAKEUP_INFINITY;
     if (!dawwp) {
@@ -5738,6 +5929,7 @@ init_scheduler_data(ErtsSchedulerData* esdp, int num,
 
     esdp->virtual_reds = 0;
     esdp->cpu_id = -1;
+    esdp->numa_node = -1;
 
     erts_init_atom_cache_map(&esdp->atom_cache_map);
 
@@ -5888,6 +6080,14 @@ erts_init_scheduling(int no_schedulers, int no_schedulers_online
 	init_runq_sched_util(&rq->sched_util, erts_sched_balance_util);
 #endif
 
+#ifdef ERTS_SMP
+	erts_smp_atomic32_init_nob(&rq->local.head, 0);
+	erts_smp_atomic32_init_nob(&rq->local.tail, 0);
+	rq->local.turn = 0;
+	for (rix = 0; rix < ERTS_RUNQ_LOCAL_SIZE; rix++)
+	    erts_smp_atomic_init_nob(&rq->local.proc[rix], ERTS_AINT_NULL);
+#endif
+
     }
 
 #ifdef ERTS_SMP
@@ -6533,6 +6733,11 @@ add2runq(int enqueue, erts_aint32_t prio,
 	    sched_p = make_proxy_proc(pxy, proc, prio);
 	}
 
+#ifdef ERTS_SMP
+	if (enqueue > 0 && try_enqueue_local(runq, (int) prio, proc, state))
+	    return;
+#endif
+
 	erts_smp_runq_lock(runq);
 
 	/* Enqueue the process */
@@ -9102,6 +9307,9 @@ erts_run_queues_len(Uint *qlen, int atomic_queues_read, int incl_active_sched)
 	 {
 	     Sint rq_len = (Sint) erts_smp_atomic32_read_dirty(&rq->len);
 	     ASSERT(rq_len >= 0);
+#ifdef ERTS_SMP
+	     rq_len += (Sint) runq_local_len(rq);
+#endif
 	     if (incl_active_sched
 		 && (ERTS_RUNQ_FLGS_GET_NOB(rq) & ERTS_RUNQ_FLG_EXEC)) {
 		 rq_len++;
@@ -9116,6 +9324,9 @@ erts_run_queues_len(Uint *qlen, int atomic_queues_read, int incl_active_sched)
 	    ErtsRunQueue *rq = ERTS_RUNQ_IX(i);
 	    Sint rq_len = (Sint) erts_smp_atomic32_read_nob(&rq->len);
 	    ASSERT(rq_len >= 0);
+#ifdef ERTS_SMP
+	    rq_len += (Sint) runq_local_len(rq);
+#endif
 	     if (incl_active_sched
 		 && (ERTS_RUNQ_FLGS_GET_NOB(rq) & ERTS_RUNQ_FLG_EXEC)) {
 		 rq_len++;
@@ -9381,6 +9592,13 @@ scheduler_gc_proc(Process *c_p, int reds_left)
     return reds;
 }
 
+#ifdef ERTS_DIRTY_SCHEDULERS
+
+static int execute_dirty_sys_tasks(Process *c_p, erts_aint32_t *statep,
+				   int in_reds);
+
+#endif
+
 /*
  * schedule() is called from BEAM (process_main()) or HiPE
  * (hipe_mode_switch()) when the current process is to be
@@ -9613,6 +9831,8 @@ Process *erts_schedule(ErtsSchedulerData *esdp, Process *p, int calls)
 
 	    if (mp->flags & ERTS_RUNQ_FLGS_IMMIGRATE_QMASK)
 		immigrate(rq, mp);
+
+	    runq_local_update_max_len(rq);
 	}
 
 	ERTS_SMP_LC_ASSERT(erts_smp_lc_runq_is_locked(rq));
@@ -9678,7 +9898,11 @@ Process *erts_schedule(ErtsSchedulerData *esdp, Process *p, int calls)
 	    while (1)
 		erts_milli_sleep(1000*1000);
 	}
-	else if ((!(flags & ERTS_RUNQ_FLGS_QMASK) && !rq->misc.start)
+	else if ((!(flags & ERTS_RUNQ_FLGS_QMASK) && !rq->misc.start
+#ifdef ERTS_SMP
+		  && (!is_normal_sched || !runq_local_len(rq))
+#endif
+		     )
 		 || (rq->halt_in_progress && ERTS_EMPTY_RUNQ_PORTS(rq))) {
 	    /* Prepare for scheduler wait */
 #ifdef ERTS_SMP
@@ -9817,12 +10041,34 @@ Process *erts_schedule(ErtsSchedulerData *esdp, Process *p, int calls)
 	    case NORMAL_BIT:
 	    case LOW_BIT:
 		prio_q = PRIORITY_NORMAL;
+#ifdef ERTS_SMP
+		/*
+		 * Alternate between the local run queue and the
+		 * ordinary normal priority queue...
+		 */
+		if (is_normal_sched && (rq->local.turn ^= 1)) {
+		    p = runq_local_pop(rq);
+		    if (p) {
+			state = erts_smp_atomic32_read_nob(&p->state);
+			goto picked_process;
+		    }
+		}
+#endif
 		if (check_requeue_process(rq, PRIORITY_NORMAL))
 		    goto pick_next_process;
 		break;
 	    case 0:			/* No process at all */
 	    default:
 		ASSERT(qmask == 0);
+#ifdef ERTS_SMP
+		if (is_normal_sched) {
+		    p = runq_local_pop(rq);
+		    if (p) {
+			state = erts_smp_atomic32_read_nob(&p->state);
+			goto picked_process;
+		    }
+		}
+#endif
                 ERTS_MSACC_SET_STATE_CACHED_M(ERTS_MSACC_STATE_OTHER);
 		goto check_activities_to_run;
 	    }
@@ -9832,6 +10078,10 @@ Process *erts_schedule(ErtsSchedulerData *esdp, Process *p, int calls)
 	     */
 	    p = dequeue_process(rq, prio_q, &state);
 
+#ifdef ERTS_SMP
+	picked_process:
+#endif
+
 	    ASSERT(p); /* Wrong qmask in rq->flags? */
 
 	    if (is_normal_sched) {
@@ -10032,6 +10282,13 @@ Process *erts_schedule(ErtsSchedulerData *esdp, Process *p, int calls)
 	    }
 	}
 
+#ifdef ERTS_DIRTY_SCHEDULERS
+	if (!is_normal_sched && (state & ERTS_PSFLG_DIRTY_RUNNING_SYS)) {
+	    calls += execute_dirty_sys_tasks(p, &state, reds);
+	    goto sched_out_proc;
+	}
+#endif
+
 	if (state & (ERTS_PSFLG_RUNNING_SYS
 		     | ERTS_PSFLG_DIRTY_RUNNING_SYS)) {
 	    /*
@@ -10403,6 +10660,25 @@ execute_sys_tasks(Process *c_p, erts_aint32_t *statep, int in_reds)
 	    st_res = am_true;
 	    break;
 #endif
+	case ERTS_PSTT_CLA: {
+	    int fcalls;
+	    int cla_reds = 0;
+	    if (!ERTS_PROC_GET_SAVED_CALLS_BUF(c_p))
+		fcalls = reds;
+	    else
+		fcalls = reds - CONTEXT_REDS;
+	    st_res = erts_proc_copy_literal_area(c_p,
+						 &cla_reds,
+						 fcalls,
+						 st->arg[0] == am_true);
+	    reds -= cla_reds;
+	    if (is_non_value(st_res)) {
+		/* Needed gc, but gc was disabled */
+		save_gc_task(c_p, st, st_prio);
+		st = NULL;
+	    }
+	    break;
+	}
 	default:
 	    ERTS_INTERNAL_ERROR("Invalid process sys task type");
 	    st_res = am_false;
@@ -10422,6 +10698,63 @@ execute_sys_tasks(Process *c_p, erts_aint32_t *statep, int in_reds)
     return in_reds - reds;
 }
 
+#ifdef ERTS_DIRTY_SCHEDULERS
+
+/*
+ * Schedule the currently executing process for execution of dirty
+ * system work, i.e. a major garbage collection that is too expensive
+ * to do on an ordinary scheduler (see garbage_collect() in erl_gc.c).
+ * The work is picked up by a dirty cpu scheduler when the process
+ * is scheduled out.
+ */
+void
+erts_schedule_dirty_sys_execution(Process *c_p)
+{
+    erts_aint32_t a, n, e;
+
+    a = erts_smp_atomic32_read_nob(&c_p->state);
+
+    ASSERT(a & (ERTS_PSFLG_RUNNING|ERTS_PSFLG_RUNNING_SYS));
+
+    while (1) {
+	if (a & (ERTS_PSFLG_DIRTY_ACTIVE_SYS|ERTS_PSFLG_EXITING))
+	    return; /* Already scheduled, or exiting */
+	n = e = a;
+	n |= ERTS_PSFLG_DIRTY_ACTIVE_SYS;
+	a = erts_smp_atomic32_cmpxchg_mb(&c_p->state, n, e);
+	if (a == e)
+	    return;
+    }
+}
+
+static int
+execute_dirty_sys_tasks(Process *c_p, erts_aint32_t *statep, int in_reds)
+{
+    int reds = 0;
+
+    ERTS_SMP_LC_ASSERT(erts_proc_lc_my_proc_locks(c_p) == ERTS_PROC_LOCK_MAIN);
+
+    if ((c_p->flags & F_DIRTY_MAJOR_GC)
+	&& !(c_p->flags & (F_DISABLE_GC|F_DELAY_GC))
+	&& !(*statep & (ERTS_PSFLG_EXITING|ERTS_PSFLG_PENDING_EXIT))) {
+	c_p->flags |= F_NEED_FULLSWEEP;
+	reds = scheduler_gc_proc(c_p, in_reds);
+    }
+
+    /*
+     * If the GC could not be done here, F_FORCE_GC is still set and
+     * it will be done when the process is scheduled on an ordinary
+     * scheduler.
+     */
+    c_p->flags &= ~F_DIRTY_MAJOR_GC;
+    *statep = erts_smp_atomic32_read_band_mb(&c_p->state,
+					     ~ERTS_PSFLG_DIRTY_ACTIVE_SYS);
+    *statep &= ~ERTS_PSFLG_DIRTY_ACTIVE_SYS;
+    return reds;
+}
+
+#endif /* ERTS_DIRTY_SCHEDULERS */
+
 static int
 cleanup_sys_tasks(Process *c_p, erts_aint32_t in_state, int in_reds)
 {
@@ -10451,6 +10784,9 @@ cleanup_sys_tasks(Process *c_p, erts_aint32_t in_state, int in_reds)
 	case ERTS_PSTT_COHMQ:
 	    st_res = am_false;
 	    break;
+	case ERTS_PSTT_CLA:
+	    st_res = am_ok;
+	    break;
 #ifdef ERTS_SMP
         case ERTS_PSTT_FTMQ:
 	    reds -= erts_flush_trace_messages(c_p, ERTS_PROC_LOCK_MAIN);
@@ -10572,6 +10908,15 @@ erts_internal_request_system_task_3(BIF_ALIST_3)
 	    goto noproc;
 	break;
 
+    case am_copy_literals:
+	if (st->arg[0] != am_true && st->arg[0] != am_false)
+	    goto badarg;
+	st->type = ERTS_PSTT_CLA;
+	noproc_res = am_ok;
+	if (!rp)
+	    goto noproc;
+	break;
+
     default:
 	goto badarg;
     }
@@ -11002,6 +11347,7 @@ erts_free_proc(Process *p)
 {
 #ifdef ERTS_SMP
     erts_proc_lock_fin(p);
+    erts_free_msgq_shards(p);
 #endif
     ASSERT(erts_smp_atomic32_read_nob(&p->state) & ERTS_PSFLG_FREE);
     ASSERT(0 == erts_proc_read_refc(p));
@@ -11277,10 +11623,12 @@ erl_create_process(Process* parent, /* Parent of process (default group leader).
     p->msg.last = &p->msg.first;
     p->msg.save = &p->msg.first;
     p->msg.len = 0;
+    p->msg.index = NULL;
 #ifdef ERTS_SMP
     p->msg_inq.first = NULL;
     p->msg_inq.last = &p->msg_inq.first;
     p->msg_inq.len = 0;
+    erts_smp_atomic_init_nob(&p->msgq_shards, (erts_aint_t) NULL);
 #endif
     p->bif_timers = NULL;
 #ifdef ERTS_BTM_ACCESSOR_SUPPORT
@@ -11482,6 +11830,7 @@ void erts_init_empty_process(Process *p)
     p->msg.last = &p->msg.first;
     p->msg.save = &p->msg.first;
     p->msg.len = 0;
+    p->msg.index = NULL;
     p->bif_timers = NULL;
 #ifdef ERTS_BTM_ACCESSOR_SUPPORT
     p->accessor_bif_timers = NULL;
@@ -11539,6 +11888,7 @@ void erts_init_empty_process(Process *p)
     p->msg_inq.first = NULL;
     p->msg_inq.last = &p->msg_inq.first;
     p->msg_inq.len = 0;
+    erts_smp_atomic_init_nob(&p->msgq_shards, (erts_aint_t) NULL);
     p->suspendee = NIL;
     p->pending_suspenders = NULL;
     p->pending_exit.reason = THE_NON_VALUE;
@@ -11727,6 +12077,7 @@ delete_process(Process* p)
     /* free all pending messages */
     erts_cleanup_messages(p->msg.first);
     p->msg.first = NULL;
+    erts_msgq_ix_free(&p->msg);
 
     ASSERT(!p->nodes_monitors);
     ASSERT(!p->suspend_monitors);
@@ -12502,6 +12853,129 @@ static void doit_exit_link(ErtsLink *lnk, void *vpcontext)
     erts_destroy_link(lnk);
 }
 
+/*
+ * Links and monitors are swept after the time of death,
+ * ERTS_EXIT_SWEEP_LIMIT at a time. The first slice is done by the
+ * exiting process itself; if anything is left, the sweep continues as
+ * aux work of the scheduler so that a process with a huge number of
+ * links or monitors does not block it. The process structure, and
+ * with it the exit reason on its heap, is kept until the sweep is
+ * done.
+ */
+
+#define ERTS_EXIT_SWEEP_LIMIT (CONTEXT_REDS/2)
+
+typedef struct ErtsExitSweep_ ErtsExitSweep;
+struct ErtsExitSweep_ {
+    ErtsExitSweep *next;
+    Process *p;
+    ErtsLink *lnk;
+    ErtsMonitor *mon;
+    int delay_del_proc;
+};
+
+static int
+sweep_exit_links_monitors(Process *p, ErtsLink **lnkp, ErtsMonitor **monp)
+{
+    Sint limit = ERTS_EXIT_SWEEP_LIMIT;
+    Eterm reason = p->fvalue;
+
+    if (*lnkp) {
+	DeclareTmpHeap(tmp_heap,4,p);
+	Eterm exit_tuple;
+
+	UseTmpHeap(4,p);
+	exit_tuple = TUPLE3(&tmp_heap[0], am_EXIT, p->common.id, reason);
+	{
+	    ExitLinkContext context = {p, reason, exit_tuple,
+				       size_object(exit_tuple)};
+	    limit -= erts_sweep_links_limited(lnkp, &doit_exit_link,
+					      &context, limit);
+	}
+	UnUseTmpHeap(4,p);
+    }
+
+    if (*monp && limit > 0) {
+	ExitMonitorContext context = {reason, p};
+	limit -= erts_sweep_monitors_limited(monp, &doit_exit_monitor,
+					     &context, limit);
+    }
+
+    return !*lnkp && !*monp;
+}
+
+static void
+finish_exit_process(Process *p, int delay_del_proc)
+{
+#ifdef ERTS_SMP
+    erts_flush_trace_messages(p, 0);
+#endif
+
+    ERTS_TRACER_CLEAR(&ERTS_TRACER(p));
+
+    if (!delay_del_proc)
+	delete_process(p);
+}
+
+/*
+ * Sweeps one slice of the first queued exit sweep of the scheduler.
+ * Returns non-zero if there is more to sweep.
+ */
+static int
+continue_exit_sweep(ErtsAuxWorkData *awdp)
+{
+    ErtsExitSweep *xsp = awdp->exit_sweep.first;
+    Process *p;
+
+    ASSERT(xsp);
+    awdp->exit_sweep.first = xsp->next;
+    p = xsp->p;
+
+    if (sweep_exit_links_monitors(p, &xsp->lnk, &xsp->mon)) {
+	finish_exit_process(p, xsp->delay_del_proc);
+	erts_proc_dec_refc(p);
+	erts_free(ERTS_ALC_T_EXIT_SWEEP, xsp);
+    }
+    else {
+	/* Move it last so that other exit sweeps get their turn */
+	xsp->next = NULL;
+	if (awdp->exit_sweep.first)
+	    awdp->exit_sweep.last->next = xsp;
+	else
+	    awdp->exit_sweep.first = xsp;
+	awdp->exit_sweep.last = xsp;
+    }
+
+    return awdp->exit_sweep.first != NULL;
+}
+
+static void
+schedule_exit_sweep(Process *p, ErtsLink *lnk, ErtsMonitor *mon,
+		    int delay_del_proc)
+{
+    ErtsSchedulerData *esdp = erts_proc_sched_data(p);
+    ErtsAuxWorkData *awdp = &esdp->aux_work_data;
+    ErtsExitSweep *xsp = erts_alloc(ERTS_ALC_T_EXIT_SWEEP,
+				    sizeof(ErtsExitSweep));
+
+    ASSERT(!ERTS_SCHEDULER_IS_DIRTY(esdp));
+
+    erts_proc_inc_refc(p); /* Decremented when the sweep is done */
+    xsp->next = NULL;
+    xsp->p = p;
+    xsp->lnk = lnk;
+    xsp->mon = mon;
+    xsp->delay_del_proc = delay_del_proc;
+
+    if (awdp->exit_sweep.first)
+	awdp->exit_sweep.last->next = xsp;
+    else
+	awdp->exit_sweep.first = xsp;
+    awdp->exit_sweep.last = xsp;
+
+    set_aux_work_flags(esdp->ssi, ERTS_SSI_AUX_WORK_EXIT_SWEEP);
+}
+
 static void
 resume_suspend_monitor(ErtsSuspendMonitor *smon, void *vc_p)
 {
@@ -12821,43 +13295,10 @@ erts_continue_exit_process(Process *p)
 	erts_do_net_exits(dep, reason);
     }
 
-    /*
-     * Pre-build the EXIT tuple if there are any links.
-     */
-    if (lnk) {
-	DeclareTmpHeap(tmp_heap,4,p);
-	Eterm exit_tuple;
-	Uint exit_tuple_sz;
-	Eterm* hp;
-
-	UseTmpHeap(4,p);
-	hp = &tmp_heap[0];
-
-	exit_tuple = TUPLE3(hp, am_EXIT, p->common.id, reason);
-
-	exit_tuple_sz = size_object(exit_tuple);
-
-	{
-	    ExitLinkContext context = {p, reason, exit_tuple, exit_tuple_sz};
-	    erts_sweep_links(lnk, &doit_exit_link, &context);
-	}
-	UnUseTmpHeap(4,p);
-    }
-
-    {
-	ExitMonitorContext context = {reason, p};
-	erts_sweep_monitors(mon,&doit_exit_monitor,&context); /* Allocates TmpHeap, but we
-								 have none here */
-    }
-
-#ifdef ERTS_SMP
-    erts_flush_trace_messages(p, 0);
-#endif
-
-    ERTS_TRACER_CLEAR(&ERTS_TRACER(p));
-
-    if (!delay_del_proc)
-	delete_process(p);
+    if (sweep_exit_links_monitors(p, &lnk, &mon))
+	finish_exit_process(p, delay_del_proc);
+    else
+	schedule_exit_sweep(p, lnk, mon, delay_del_proc);
 
 #ifdef ERTS_SMP
     erts_smp_proc_lock(p, ERTS_PROC_LOCK_MAIN);
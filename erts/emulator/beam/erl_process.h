@@ -305,6 +305,7 @@ typedef enum {
     ERTS_SSI_AUX_WORK_MISC_THR_PRGR_IX,
     ERTS_SSI_AUX_WORK_MISC_IX,
     ERTS_SSI_AUX_WORK_PENDING_EXITERS_IX,
+    ERTS_SSI_AUX_WORK_EXIT_SWEEP_IX,
     ERTS_SSI_AUX_WORK_SET_TMO_IX,
     ERTS_SSI_AUX_WORK_MSEG_CACHE_CHECK_IX,
     ERTS_SSI_AUX_WORK_REAP_PORTS_IX,
@@ -339,6 +340,8 @@ typedef enum {
     (((erts_aint32_t) 1) << ERTS_SSI_AUX_WORK_MISC_IX)
 #define ERTS_SSI_AUX_WORK_PENDING_EXITERS \
     (((erts_aint32_t) 1) << ERTS_SSI_AUX_WORK_PENDING_EXITERS_IX)
+#define ERTS_SSI_AUX_WORK_EXIT_SWEEP \
+    (((erts_aint32_t) 1) << ERTS_SSI_AUX_WORK_EXIT_SWEEP_IX)
 #define ERTS_SSI_AUX_WORK_SET_TMO \
     (((erts_aint32_t) 1) << ERTS_SSI_AUX_WORK_SET_TMO_IX)
 #define ERTS_SSI_AUX_WORK_MSEG_CACHE_CHECK \
@@ -396,6 +399,9 @@ typedef struct {
     Process* last;
 } ErtsRunPrioQueue;
 
+#define ERTS_RUNQ_LOCAL_SIZE 256 /* Needs to be a power of 2 */
+#define ERTS_RUNQ_LOCAL_MASK (ERTS_RUNQ_LOCAL_SIZE - 1)
+
 typedef struct ErtsSchedulerData_ ErtsSchedulerData;
 
 typedef struct ErtsRunQueue_ ErtsRunQueue;
@@ -509,6 +515,21 @@ struct ErtsRunQueue_ {
 #if ERTS_HAVE_SCHED_UTIL_BALANCING_SUPPORT
     ErtsRunQueueSchedUtil sched_util;
 #endif
+#ifdef ERTS_SMP
+    /*
+     * Normal priority processes enqueued by the scheduler owning
+     * the run queue while it executes a process or a port. Only
+     * the owner pushes; the owner and stealing schedulers pop
+     * without taking the run queue lock. These processes are not
+     * included in len and procs.prio_info.
+     */
+    struct {
+	erts_smp_atomic32_t head;
+	erts_smp_atomic32_t tail;
+	int turn;
+	erts_smp_atomic_t proc[ERTS_RUNQ_LOCAL_SIZE];
+    } local;
+#endif
 };
 
 #ifdef ERTS_SMP
@@ -592,6 +613,10 @@ typedef struct {
 	void *queue;
     } async_ready;
 #endif
+    struct {
+	struct ErtsExitSweep_ *first;
+	struct ErtsExitSweep_ *last;
+    } exit_sweep;
 #ifdef ERTS_SMP
     struct {
 	Uint64 next;
@@ -654,6 +679,7 @@ struct ErtsSchedulerData_ {
     ErtsRunQueue *run_queue;
     int virtual_reds;
     int cpu_id;			/* >= 0 when bound */
+    int numa_node;		/* >= 0 when bound and node is known */
     ErtsAuxWorkData aux_work_data;
     ErtsAtomCacheMap atom_cache_map;
 
@@ -1070,6 +1096,7 @@ struct process {
 
 #ifdef ERTS_SMP
     ErlMessageInQueue msg_inq;
+    erts_smp_atomic_t msgq_shards; /* ErtsMsgQShards * */
     ErlTraceMessageQueue *trace_msg_q;
     ErtsPendExit pending_exit;
     erts_proc_lock_t lock;
@@ -1391,6 +1418,7 @@ extern int erts_system_profile_ts_type;
 #define F_HAVE_BLCKD_NMSCHED (1 << 18) /* Process has blocked normal multi-scheduling */
 #define F_HIPE_MODE          (1 << 19)
 #define F_DELAYED_DEL_PROC   (1 << 20) /* Delay delete process (dirty proc exit case) */
+#define F_DIRTY_MAJOR_GC     (1 << 21) /* Major GC scheduled on dirty cpu scheduler */
 
 /*
  * F_DISABLE_GC and F_DELAY_GC are similar. Both will prevent
@@ -1574,6 +1602,9 @@ void erts_init_scheduling(int, int
 			  );
 
 int erts_set_gc_state(Process *c_p, int enable);
+#ifdef ERTS_DIRTY_SCHEDULERS
+void erts_schedule_dirty_sys_execution(Process *c_p);
+#endif
 Eterm erts_sched_wall_time_request(Process *c_p, int set, int enable);
 Eterm erts_system_check_request(Process *c_p);
 Eterm erts_gc_info_request(Process *c_p);
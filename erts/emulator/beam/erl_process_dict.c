@@ -47,11 +47,10 @@
 #define PD_GET_OTHER_PROCESS 1UL
 
 /* Hash constant macros */
-#define MAX_HASH            1342177280UL
 #define INITIAL_SIZE        (erts_pd_initial_size)
 
 /* Hash utility macros  */
-#define HASH_RANGE(PDict) ((PDict)->usedSlots)
+#define HASH_RANGE(PDict) ((PDict)->size)
 
 #define MAKE_HASH(Term)                                \
     ((is_small(Term)) ? unsigned_val(Term) :           \
@@ -59,27 +58,46 @@
       (atom_tab(atom_val(Term))->slot.bucket.hvalue) : \
       make_internal_hash(Term)))
 
-#define PD_SZ2BYTES(Sz) (sizeof(ProcDict) + ((Sz) - 1)*sizeof(Eterm))
+/*
+ * The hash values stored next to the slots always have the top bit
+ * set, a zero marks an empty slot.
+ */
+#define PD_HASH_USED        ((Uint32) 0x80000000)
+#define PD_STORED_HASH(Hx)  ((Uint32) (Hx) | PD_HASH_USED)
+
+/*
+ * The table grows when more than 3/4 of the slots are used and shrinks
+ * when less than 1/8 are.
+ */
+#define PD_NEED_GROW(PDict, N)   (4*(N) > 3*(PDict)->size)
+#define PD_NEED_SHRINK(PDict, N) ((PDict)->size > INITIAL_SIZE && \
+				  8*(N) < (PDict)->size)
+
+/*
+ * Slot index of a stored hash value. Small integers hash to themselves,
+ * so the bits are mixed before masking.
+ */
+static ERTS_INLINE Uint pd_hash_ix(Uint32 stored, Uint mask)
+{
+    Uint32 h = stored * (Uint32) 0x9E3779B9;
+    return (Uint) (h ^ (h >> 16)) & mask;
+}
+
+#define PD_SZ2BYTES(Sz) (sizeof(ProcDict) + ((Sz) - 1)*sizeof(Eterm) + \
+			 (Sz)*sizeof(Uint32))
 
-#define pd_hash_value(Pdict, Key) \
-    pd_hash_value_to_ix(Pdict, MAKE_HASH((Key)))
+#define PD_HASHES(PDict) ((Uint32 *) &(PDict)->data[(PDict)->size])
 
 /* Memory allocation macros */
 #define PD_ALLOC(Sz)				\
      erts_alloc(ERTS_ALC_T_PROC_DICT, (Sz))
 #define PD_FREE(P, Sz)				\
      erts_free(ERTS_ALC_T_PROC_DICT, (P))
-#define PD_REALLOC(P, OSz, NSz) 		\
-     erts_realloc(ERTS_ALC_T_PROC_DICT, (P), (NSz))
-
-
-#define TCAR(Term) CAR(list_val(Term))
-#define TCDR(Term) CDR(list_val(Term))
 
 /* Array access macro */ 
-#define ARRAY_GET(PDict, Index) (ASSERT((Index) < (PDict)->arraySize), \
+#define ARRAY_GET(PDict, Index) (ASSERT((Index) < (PDict)->size), \
 				 (PDict)->data[Index])
-#define ARRAY_PUT(PDict, Index, Val) (ASSERT((Index) < (PDict)->arraySize), \
+#define ARRAY_PUT(PDict, Index, Val) (ASSERT((Index) < (PDict)->size), \
                                       (PDict)->data[Index] = (Val))
 
 #define IS_POW2(X) ((X) && !((X) & ((X)-1)))
@@ -89,20 +107,14 @@
  */
 static void pd_hash_erase(Process *p, Eterm id, Eterm *ret);
 static void pd_hash_erase_all(Process *p);
-static Eterm pd_hash_get_with_hval(Process *p, Eterm bucket, Eterm id);
 static Eterm pd_hash_get_keys(Process *p, Eterm value);
 static Eterm pd_hash_get_all_keys(Process *p, ProcDict *pd);
 static Eterm pd_hash_get_all(Process *p, ProcDict *pd);
 static Eterm pd_hash_put(Process *p, Eterm id, Eterm value);
 
-static void shrink(Process *p, Eterm* ret); 
-static void grow(Process *p);
-
-static void array_shrink(ProcDict **ppd, unsigned int need);
-static void ensure_array_size(ProcDict**, unsigned int size);
-
-static unsigned int pd_hash_value_to_ix(ProcDict *pdict, Uint32 hx);
-static unsigned int next_array_size(unsigned int need);
+static Sint pd_lookup(ProcDict *pd, Uint32 hx, Eterm id);
+static void pd_resize(ProcDict **ppd, Uint size);
+static ProcDict *pd_alloc(Uint size);
 
 /*
 ** Debugging prototypes and macros
@@ -164,10 +176,8 @@ erts_dictionary_dump(int to, void *to_arg, ProcDict *pd)
     /*PD_CHECK(pd);*/
     if (pd == NULL)
 	return;
-    erts_print(to, to_arg, "(size = %d, usedSlots = %d, "
-	       "splitPosition = %d, numElements = %d)\n",
-	       pd->arraySize, pd->usedSlots,
-	       pd->splitPosition, (unsigned int) pd->numElements);
+    erts_print(to, to_arg, "(size = %d, numElements = %d)\n",
+	       (unsigned int) pd->size, (unsigned int) pd->numElements);
     for (i = 0; i < HASH_RANGE(pd); ++i) {
 	erts_print(to, to_arg, "%d: %T\n", i, ARRAY_GET(pd, i));
     }
@@ -181,11 +191,7 @@ erts_dictionary_dump(int to, void *to_arg, ProcDict *pd)
     if (pd != NULL) {
 	for (i = 0; i < HASH_RANGE(pd); ++i) {
 	    t = ARRAY_GET(pd, i);
-	    if (is_list(t)) {
-		for (; t != NIL; t = TCDR(t)) {
-		    erts_print(to, to_arg, written++ ? ",%T" : "%T", TCAR(t));
-		}
-	    } else if (is_tuple(t)) {
+	    if (is_tuple(t)) {
 		erts_print(to, to_arg, written++ ? ",%T" : "%T", t);
 	    }
 	}
@@ -205,11 +211,7 @@ erts_deep_dictionary_dump(int to, void *to_arg,
     if (pd != NULL) {
 	for (i = 0; i < HASH_RANGE(pd); ++i) {
 	    t = ARRAY_GET(pd, i);
-	    if (is_list(t)) {
-		for (; t != NIL; t = TCDR(t)) {
-		    (*cb)(to, to_arg, TCAR(t));
-		}
-	    } else if (is_tuple(t)) {
+	    if (is_tuple(t)) {
 		(*cb)(to, to_arg, t);
 	    }
 	}
@@ -221,7 +223,7 @@ erts_dicts_mem_size(Process *p)
 {
     Uint size = 0;
     if (p->dictionary)
-	size += PD_SZ2BYTES(p->dictionary->arraySize);
+	size += PD_SZ2BYTES(p->dictionary->size);
     return size;
 }
 
@@ -242,7 +244,7 @@ Eterm erts_dictionary_copy(Process *p, ProcDict *pd)
     Eterm* hp;
     Eterm* heap_start;
     Eterm res = NIL;
-    Eterm tmp, tmp2;
+    Eterm tmp;
     unsigned int i, num;
 
     if (pd == NULL) {
@@ -259,13 +261,6 @@ Eterm erts_dictionary_copy(Process *p, ProcDict *pd)
 	    ASSERT(is_tuple(tmp));
 	    res = CONS(hp, tmp, res);
 	    hp += 2;
-	} else if (is_list(tmp)) {
-	    while (tmp != NIL) {
-		tmp2 = TCAR(tmp);
-		res = CONS(hp, tmp2, res);
-		hp += 2;
-		tmp = TCDR(tmp);
-	    }
 	}
     }
     res = copy_object(res, p);
@@ -349,54 +344,43 @@ BIF_RETTYPE erase_1(BIF_ALIST_1)
  */
 static void pd_hash_erase(Process *p, Eterm id, Eterm *ret)
 {
-    unsigned int hval;
-    Eterm old;
-    Eterm tmp;
-    unsigned int range;
+    ProcDict *pd = p->dictionary;
+    Uint32 *hashes;
+    Uint mask, i, j;
+    Sint ix;
 
     *ret = am_undefined;
-    if (p->dictionary == NULL) {
+    if (pd == NULL) {
 	return;
     }
-    hval = pd_hash_value(p->dictionary, id);
-    old = ARRAY_GET(p->dictionary, hval);
-    if (is_boxed(old)) {	/* Tuple */
-	ASSERT(is_tuple(old));
-	if (EQ(tuple_val(old)[1], id)) {
-	    ARRAY_PUT(p->dictionary, hval, NIL);
-	    --(p->dictionary->numElements);
-	    *ret = tuple_val(old)[2];
-	}
-    } else if (is_list(old)) {
-	/* Find cons cell for identical value */
-	Eterm* prev = &p->dictionary->data[hval];
-
-	for (tmp = *prev; tmp != NIL; prev = &TCDR(tmp), tmp = *prev) {
-	    if (EQ(tuple_val(TCAR(tmp))[1], id)) {
-		*prev = TCDR(tmp);
-		*ret = tuple_val(TCAR(tmp))[2];
-		--(p->dictionary->numElements);
-	    }
-	}
+    ix = pd_lookup(pd, MAKE_HASH(id), id);
+    if (ix < 0) {
+	return;
+    }
+    *ret = tuple_val(ARRAY_GET(pd, ix))[2];
+    --(pd->numElements);
 
-	/* If there is only one element left in the list we must remove the list. */
-	old = ARRAY_GET(p->dictionary, hval);
-	ASSERT(is_list(old));
-	if (is_nil(TCDR(old))) {
-	    ARRAY_PUT(p->dictionary, hval, TCAR(old));
+    /*
+     * Linear probing without tombstones: move later entries of the
+     * probe sequence back into the hole as long as that does not put
+     * them in front of their home slot.
+     */
+    hashes = PD_HASHES(pd);
+    mask = pd->size - 1;
+    i = (Uint) ix;
+    for (j = (i + 1) & mask; hashes[j] != 0; j = (j + 1) & mask) {
+	Uint home = pd_hash_ix(hashes[j], mask);
+	if (((j - home) & mask) >= ((j - i) & mask)) {
+	    ARRAY_PUT(pd, i, ARRAY_GET(pd, j));
+	    hashes[i] = hashes[j];
+	    i = j;
 	}
-    } else if (is_not_nil(old)) {
-#ifdef DEBUG
-	erts_fprintf(stderr,
-		     "Process dictionary for process %T is broken, trying to "
-		     "display term found in line %d:\n"
-		     "%T\n", p->common.id, __LINE__, old);
-#endif
-	erts_exit(ERTS_ERROR_EXIT, "Damaged process dictionary found during erase/1.");
     }
-    if ((range = HASH_RANGE(p->dictionary)) > INITIAL_SIZE && 
-	range / 2  > (p->dictionary->numElements)) {
-	shrink(p, ret);
+    ARRAY_PUT(pd, i, NIL);
+    hashes[i] = 0;
+
+    if (PD_NEED_SHRINK(pd, pd->numElements)) {
+	pd_resize(&p->dictionary, pd->size / 2);
     }
 }
 
@@ -410,65 +394,29 @@ static void pd_hash_erase_all(Process *p)
 
 Eterm erts_pd_hash_get_with_hx(Process *p, Uint32 hx, Eterm id)
 {
-    unsigned int hval;
     ProcDict *pd = p->dictionary;
+    Sint ix;
 
     ASSERT(hx == MAKE_HASH(id));
     if (pd == NULL)
 	return am_undefined;
-    hval = pd_hash_value_to_ix(pd, hx);
-    return pd_hash_get_with_hval(p, ARRAY_GET(pd, hval), id);
+    ix = pd_lookup(pd, hx, id);
+    if (ix < 0)
+	return am_undefined;
+    return tuple_val(ARRAY_GET(pd, ix))[2];
 }
 
 Eterm erts_pd_hash_get(Process *p, Eterm id) 
 {
-    unsigned int hval;
-    ProcDict *pd = p->dictionary;
-
-    if (pd == NULL)
+    if (p->dictionary == NULL)
 	return am_undefined;
-    hval = pd_hash_value(pd, id);
-    return pd_hash_get_with_hval(p, ARRAY_GET(pd, hval), id);
+    return erts_pd_hash_get_with_hx(p, MAKE_HASH(id), id);
 }
 
-Eterm pd_hash_get_with_hval(Process *p, Eterm bucket, Eterm id)
-{
-    if (is_boxed(bucket)) {     /* Tuple */
-	ASSERT(is_tuple(bucket));
-	if (EQ(tuple_val(bucket)[1], id)) {
-	    return tuple_val(bucket)[2];
-	}
-    } else if (is_list(bucket)) {
-	for (; bucket != NIL && !EQ(tuple_val(TCAR(bucket))[1], id); bucket = TCDR(bucket)) {
-	    ;
-	}
-	if (bucket != NIL) {
-	    return tuple_val(TCAR(bucket))[2];
-	}
-    } else if (is_not_nil(bucket)) {
-#ifdef DEBUG
-	erts_fprintf(stderr,
-		     "Process dictionary for process %T is broken, trying to "
-		     "display term found in line %d:\n"
-		     "%T\n", p->common.id, __LINE__, bucket);
-#endif
-	erts_exit(ERTS_ERROR_EXIT, "Damaged process dictionary found during get/1.");
-    }
-    return am_undefined;
-}
-
-
-#define PD_GET_TKEY(Dst,Src)                            \
-do {                                                    \
-    ASSERT(is_tuple((Src)));                            \
-    ASSERT(arityval(*((Eterm*)tuple_val((Src)))) == 2); \
-    (Dst) = ((Eterm*)tuple_val((Src)))[1];              \
-} while(0)
-
 static Eterm pd_hash_get_all_keys(Process *p, ProcDict *pd) {
     Eterm* hp;
     Eterm res = NIL;
-    Eterm tmp, tmp2;
+    Eterm tmp;
     unsigned int i;
     unsigned int num;
 
@@ -482,22 +430,14 @@ static Eterm pd_hash_get_all_keys(Process *p, ProcDict *pd) {
     for (i = 0; i < num; ++i) {
 	tmp = ARRAY_GET(pd, i);
 	if (is_boxed(tmp)) {
-	    PD_GET_TKEY(tmp,tmp);
-	    res = CONS(hp, tmp, res);
+	    ASSERT(is_tuple(tmp));
+	    ASSERT(arityval(*tuple_val(tmp)) == 2);
+	    res = CONS(hp, tuple_val(tmp)[1], res);
 	    hp += 2;
-	} else if (is_list(tmp)) {
-	    while (tmp != NIL) {
-		tmp2 = TCAR(tmp);
-		PD_GET_TKEY(tmp2,tmp2);
-		res = CONS(hp, tmp2, res);
-		hp += 2;
-		tmp = TCDR(tmp);
-	    }
 	}
     }
     return res;
 }
-#undef PD_GET_TKEY
 
 static Eterm pd_hash_get_keys(Process *p, Eterm value) 
 {
@@ -505,7 +445,7 @@ static Eterm pd_hash_get_keys(Process *p, Eterm value)
     Eterm res = NIL;
     ProcDict *pd = p->dictionary;
     unsigned int i, num;
-    Eterm tmp, tmp2;
+    Eterm tmp;
 
     if (pd == NULL) {
 	return res;
@@ -520,15 +460,6 @@ static Eterm pd_hash_get_keys(Process *p, Eterm value)
 		hp = HAlloc(p, 2);
 		res = CONS(hp, tuple_val(tmp)[1], res);
 	    }
-	} else if (is_list(tmp)) {
-	    while (tmp != NIL) {
-		tmp2 = TCAR(tmp);
-		if (EQ(tuple_val(tmp2)[2], value)) {
-		    hp = HAlloc(p, 2);
-		    res = CONS(hp, tuple_val(tmp2)[1], res);
-		}
-		tmp = TCDR(tmp);
-	    }
 	}
     }
     return res;
@@ -540,7 +471,7 @@ pd_hash_get_all(Process *p, ProcDict *pd)
 {
     Eterm* hp;
     Eterm res = NIL;
-    Eterm tmp, tmp2;
+    Eterm tmp;
     unsigned int i;
     unsigned int num;
 
@@ -556,13 +487,6 @@ pd_hash_get_all(Process *p, ProcDict *pd)
 	    ASSERT(is_tuple(tmp));
 	    res = CONS(hp, tmp, res);
 	    hp += 2;
-	} else if (is_list(tmp)) {
-	    while (tmp != NIL) {
-		tmp2 = TCAR(tmp);
-		res = CONS(hp, tmp2, res);
-		hp += 2;
-		tmp = TCDR(tmp);
-	    }
 	}
     }
     return res;
@@ -570,463 +494,143 @@ pd_hash_get_all(Process *p, ProcDict *pd)
 
 static Eterm pd_hash_put(Process *p, Eterm id, Eterm value)
 { 
-    unsigned int hval;
+    ProcDict *pd;
+    Uint32 hx = MAKE_HASH(id);
+    Uint32 *hashes;
+    Uint mask, i;
     Eterm *hp;
     Eterm tpl;
-    Eterm old;
-    Eterm tmp;
-    int needed;
-    int i = 0;
-#ifdef DEBUG
-    Eterm *hp_limit;
-#endif
+    Eterm old = am_undefined;
+    Sint ix;
 
     if (p->dictionary == NULL) {
 	/* Create it */
-        ensure_array_size(&p->dictionary, INITIAL_SIZE);
-	p->dictionary->usedSlots = INITIAL_SIZE;
-        p->dictionary->sizeMask = INITIAL_SIZE*2 - 1;
-        p->dictionary->splitPosition = 0;
-        p->dictionary->numElements = 0;
-    }	
-    hval = pd_hash_value(p->dictionary, id);
-    old = ARRAY_GET(p->dictionary, hval);
+	p->dictionary = pd_alloc(INITIAL_SIZE);
+    }
 
     /*
-     * Calculate the number of heap words needed and garbage
-     * collect if necessary. (Might be a slight overestimation.)
+     * Only the {Key,Value} tuple is allocated on the heap; the table
+     * itself is a root set for the garbage collector.
      */
-    needed = 3;			/* {Key,Value} tuple */
-    if (is_boxed(old)) {
-	/*
-	 * We don't want to compare keys twice, so we'll always
-	 * reserve the space for two CONS cells.
-	 */
-	needed += 2+2;
-    } else if (is_list(old)) {
-	i = 0;
-	for (tmp = old; tmp != NIL && !EQ(tuple_val(TCAR(tmp))[1], id); tmp = TCDR(tmp)) {
-	    ++i;
-	}
-	if (is_nil(tmp)) {
-	    i = -1;
-	    needed += 2;
-	} else {
-	    needed += 2*(i+1);
-	}
-    }
-    if (HeapWordsLeft(p) < needed) {
-	Eterm root[3];
+    if (HeapWordsLeft(p) < 3) {
+	Eterm root[2];
 	root[0] = id;
 	root[1] = value;
-	root[2] = old;
-	erts_garbage_collect(p, needed, root, 3);
+	erts_garbage_collect(p, 3, root, 2);
 	id = root[0];
 	value = root[1];
-	old = root[2];
     }
-#ifdef DEBUG
-    hp_limit = p->htop + needed;
-#endif
-
-    /*
-     * Create the {Key,Value} tuple.
-     */
     hp = HeapOnlyAlloc(p, 3);
     tpl = TUPLE2(hp, id, value);
 
-    /*
-     * Update the dictionary.
-     */
-    if (is_nil(old)) {
-	ARRAY_PUT(p->dictionary, hval, tpl);
-	++(p->dictionary->numElements);
-    } else if (is_boxed(old)) {
-	ASSERT(is_tuple(old));
-	if (EQ(tuple_val(old)[1],id)) {
-	    ARRAY_PUT(p->dictionary, hval, tpl);
-	    return tuple_val(old)[2];
-	} else {
-	    hp = HeapOnlyAlloc(p, 4);
-	    tmp = CONS(hp, old, NIL);
-	    hp += 2;
-	    ++(p->dictionary->numElements);
-	    ARRAY_PUT(p->dictionary, hval, CONS(hp, tpl, tmp));
-	    hp += 2;
-	    ASSERT(hp <= hp_limit);
-	}
-    } else if (is_list(old)) {
-	if (i == -1) {
-	    /*
-	     * New key. Simply prepend the tuple to the beginning of the list.
-	     */
-	    hp = HeapOnlyAlloc(p, 2);
-	    ARRAY_PUT(p->dictionary, hval, CONS(hp, tpl, old));
-	    hp += 2;
-	    ASSERT(hp <= hp_limit);
-	    ++(p->dictionary->numElements);
-	} else {
-	    /*
-	     * i = Number of CDRs to skip to reach the changed element in the list.
-	     *
-	     * Replace old value in list. To avoid pointers from the old generation
-	     * to the new, we must rebuild the list from the beginning up to and
-	     * including the changed element.
-	     */
-	    Eterm nlist;
-	    int j;
-
-	    hp = HeapOnlyAlloc(p, (i+1)*2);
-	    
-	    /* Find the list element to change. */
-	    for (j = 0, nlist = old; j < i; j++, nlist = TCDR(nlist)) {
-		;
-	    }
-	    ASSERT(EQ(tuple_val(TCAR(nlist))[1], id));
-	    nlist = TCDR(nlist); /* Unchanged part of list. */
-
-	    /* Rebuild list before the updated element. */
-	    for (tmp = old; i-- > 0; tmp = TCDR(tmp)) {
-		nlist = CONS(hp, TCAR(tmp), nlist);
-		hp += 2;
-	    }
-	    ASSERT(EQ(tuple_val(TCAR(tmp))[1], id));
-
-	    /* Put the updated element first in the new list. */
-	    nlist = CONS(hp, tpl, nlist);
-	    hp += 2;
-	    ASSERT(hp <= hp_limit);
-	    ARRAY_PUT(p->dictionary, hval, nlist);
-	    return tuple_val(TCAR(tmp))[2];
-	}
-    } else {
-#ifdef DEBUG
-	erts_fprintf(stderr,
-		     "Process dictionary for process %T is broken, trying to "
-		     "display term found in line %d:\n"
-		     "%T\n", p->common.id, __LINE__, old);
-#endif
+    pd = p->dictionary;
+    ix = pd_lookup(pd, hx, id);
+    if (ix >= 0) {
+	old = tuple_val(ARRAY_GET(pd, ix))[2];
+	ARRAY_PUT(pd, ix, tpl);
+	return old;
+    }
 
-	erts_exit(ERTS_ERROR_EXIT, "Damaged process dictionary found during put/2.");
+    if (PD_NEED_GROW(pd, pd->numElements + 1)) {
+	pd_resize(&p->dictionary, pd->size * 2);
+	pd = p->dictionary;
     }
-    if (HASH_RANGE(p->dictionary) <= p->dictionary->numElements) {
-	grow(p);
+    hashes = PD_HASHES(pd);
+    mask = pd->size - 1;
+    for (i = pd_hash_ix(PD_STORED_HASH(hx), mask);
+	 hashes[i] != 0;
+	 i = (i + 1) & mask) {
+	;
     }
-    return am_undefined;
+    ARRAY_PUT(pd, i, tpl);
+    hashes[i] = PD_STORED_HASH(hx);
+    ++(pd->numElements);
+    return old;
 }
 
 /*
- * Hash table utilities, rehashing
+ * Hash table utilities
  */
 
-static void shrink(Process *p, Eterm* ret) 
+/*
+ * Return the slot holding the key, or -1. Only slots whose stored hash
+ * matches are compared with the key.
+ */
+static Sint pd_lookup(ProcDict *pd, Uint32 hx, Eterm id)
 {
-    ProcDict *pd = p->dictionary;
-    unsigned int range = HASH_RANGE(p->dictionary);
-    unsigned int steps = (range*3) / 10;
-    Eterm hi, lo, tmp;
-    unsigned int i;
-    Eterm *hp;
-#ifdef DEBUG
-    Eterm *hp_limit;
-#endif
-
-    if (range - steps < INITIAL_SIZE) {
-	steps = range - INITIAL_SIZE; 
-    }
-
-    for (i = 0; i < steps; ++i) {
-	if (pd->splitPosition == 0) {
-            ASSERT(IS_POW2(pd->usedSlots));
-            pd->sizeMask = pd->usedSlots - 1;
-	    pd->splitPosition = pd->usedSlots / 2;
-	}
-	--(pd->splitPosition);
-        /* Must wait to decrement 'usedSlots' for GC rootset below */
-	hi = ARRAY_GET(pd, pd->usedSlots - 1);
-	lo = ARRAY_GET(pd, pd->splitPosition);
-	if (hi != NIL) {
-	    if (lo == NIL) {
-		ARRAY_PUT(pd, pd->splitPosition, hi);
-	    } else {
-		Sint needed = 4;
-		if (is_list(hi) && is_list(lo)) {
-		    needed = 2*erts_list_length(hi);
-		}
-		if (HeapWordsLeft(p) < needed) {
-		    erts_garbage_collect(p, needed, ret, 1);
-		    hi = pd->data[pd->usedSlots - 1];
-		    lo = pd->data[pd->splitPosition];
-		}
-#ifdef DEBUG
-		hp_limit = p->htop + needed;
-#endif
-		if (is_tuple(lo)) {
-		    if (is_tuple(hi)) {
-			hp = HeapOnlyAlloc(p, 4);
-			tmp = CONS(hp, hi, NIL);
-			hp += 2;
-			ARRAY_PUT(pd, pd->splitPosition,
-				  CONS(hp,lo,tmp));
-			hp += 2;
-			ASSERT(hp <= hp_limit);
-		    } else { /* hi is a list */
-			hp = HeapOnlyAlloc(p, 2);
-			ARRAY_PUT(pd, pd->splitPosition,
-				  CONS(hp, lo, hi));
-			hp += 2;
-			ASSERT(hp <= hp_limit);
-		    }
-		} else { /* lo is a list */
-		    if (is_tuple(hi)) {
-			hp = HeapOnlyAlloc(p, 2);
-			ARRAY_PUT(pd, pd->splitPosition,
-				  CONS(hp, hi, lo));
-			hp += 2;
-			ASSERT(hp <= hp_limit);
-
-		    } else { /* Two lists */
-			hp = HeapOnlyAlloc(p, needed);
-			for (tmp = hi; tmp != NIL; tmp = TCDR(tmp)) {
-			    lo = CONS(hp, TCAR(tmp), lo);
-			    hp += 2;
-			}
-			ASSERT(hp <= hp_limit);
-			ARRAY_PUT(pd, pd->splitPosition, lo);
-		    }
-		}
+    Uint32 *hashes = PD_HASHES(pd);
+    Uint32 stored = PD_STORED_HASH(hx);
+    Uint mask = pd->size - 1;
+    Uint i;
+
+    for (i = pd_hash_ix(stored, mask);
+	 hashes[i] != 0;
+	 i = (i + 1) & mask) {
+	if (hashes[i] == stored) {
+	    Eterm tpl = ARRAY_GET(pd, i);
+	    ASSERT(is_tuple(tpl));
+	    if (EQ(tuple_val(tpl)[1], id)) {
+		return (Sint) i;
 	    }
 	}
-        --pd->usedSlots;
-	ARRAY_PUT(pd, pd->usedSlots, NIL);
-    }
-    if (HASH_RANGE(p->dictionary) <= (p->dictionary->arraySize / 4)) {
-	array_shrink(&(p->dictionary), (HASH_RANGE(p->dictionary) * 3) / 2);
     }
+    return -1;
 }
 
-static void grow(Process *p)
+static ProcDict *pd_alloc(Uint size)
 {
-    unsigned int i,j;
-    unsigned int steps = (p->dictionary->usedSlots / 4) & 0xf;
-    Eterm l1,l2;
-    Eterm l;
-    Eterm *hp;
-    unsigned int pos;
-    unsigned int homeSize;
-    Sint needed = 0;
-    ProcDict *pd = p->dictionary;
-#ifdef DEBUG
-    Eterm *hp_limit;
-#endif
-
-    HDEBUGF(("grow: steps = %d", steps));
-    if (steps == 0)
-	steps = 1;
-    /* Dont grow over MAX_HASH */
-    if ((MAX_HASH - steps) <= HASH_RANGE(pd)) {
-	return;
-    }
-
-    ensure_array_size(&p->dictionary, HASH_RANGE(pd) + steps);
-    pd = p->dictionary;
-
-    /*
-     * Calculate total number of heap words needed, and garbage collect
-     * if necessary.
-     */
-
-    pos = pd->splitPosition;
-    homeSize = pd->usedSlots - pd->splitPosition;
-    for (i = 0; i < steps; ++i) {
-	if (pos == homeSize) {
-	    homeSize *= 2;
-	    pos = 0;
-	}
-	l = ARRAY_GET(pd, pos);
-	pos++;
-	if (is_not_tuple(l)) {
-	    while (l != NIL) {
-		needed += 2;
-		l = TCDR(l);
-	    }
-	}
-    }
-    if (HeapWordsLeft(p) < needed) {
-	erts_garbage_collect(p, needed, 0, 0);
+    ProcDict *pd;
+    Uint i;
+
+    ASSERT(IS_POW2(size));
+    pd = PD_ALLOC(PD_SZ2BYTES(size));
+    pd->size = size;
+    pd->numElements = 0;
+    for (i = 0; i < size; ++i) {
+	pd->data[i] = NIL;
     }
-#ifdef DEBUG
-    hp_limit = p->htop + needed;
-#endif
-
-    /*
-     * Now grow.
-     */
-    homeSize = pd->usedSlots - pd->splitPosition;
-    for (i = 0; i < steps; ++i) {
-	if (pd->splitPosition == homeSize) {
-	    homeSize *= 2;
-            pd->sizeMask = homeSize*2 - 1;
-            pd->splitPosition = 0;
-	}
-	pos = pd->splitPosition;
-	++pd->splitPosition; /* For the hashes */
-        ++pd->usedSlots;
-        ASSERT(pos + homeSize == pd->usedSlots - 1);
-	l = ARRAY_GET(pd, pos);
-	if (is_tuple(l)) {
-	    if (pd_hash_value(pd, tuple_val(l)[1]) != pos) {
-		ARRAY_PUT(pd, pos + homeSize, l);
-		ARRAY_PUT(pd, pos, NIL);
-	    }
-	} else {
-	    l2 = NIL;
-	    l1 = l;
-	    for (j = 0; l1 != NIL; l1 = TCDR(l1))
-		j += 2;
-	    hp = HeapOnlyAlloc(p, j);
-	
-	    while (l != NIL) {
-		if (pd_hash_value(pd, tuple_val(TCAR(l))[1]) == pos) 
-		    l1 = CONS(hp, TCAR(l), l1);
-		else
-		    l2 = CONS(hp, TCAR(l), l2);
-		hp += 2;
-		l = TCDR(l);
-	    }
-	    if (l1 != NIL && TCDR(l1) == NIL)
-		l1 = TCAR(l1);
-	    if (l2 != NIL && TCDR(l2) == NIL)
-		l2 = TCAR(l2);
-	    ASSERT(hp <= hp_limit);
-	    ARRAY_PUT(pd, pos, l1);
-	    ARRAY_PUT(pd, pos + homeSize, l2);
-	}
-    }
-
-#ifdef HARDDEBUG
-    dictionary_dump(p->dictionary,CERR);
-#endif
+    sys_memzero(PD_HASHES(pd), size * sizeof(Uint32));
+    return pd;
 }
 
 /*
-** Array oriented operations
-*/
-
-static void array_shrink(ProcDict **ppd, unsigned int need) 
+ * Move all entries to a table of the given size. The stored hash
+ * values are reused, so no key is looked at.
+ */
+static void pd_resize(ProcDict **ppd, Uint size)
 {
-    unsigned int siz = next_array_size(need);
-
-    HDEBUGF(("array_shrink: size = %d, need = %d",
-	     (*ppd)->arraySize, need));
-
-    if (siz >= (*ppd)->arraySize)
-	return; /* Only shrink */
+    ProcDict *old = *ppd;
+    ProcDict *pd;
+    Uint32 *old_hashes = PD_HASHES(old);
+    Uint32 *hashes;
+    Uint mask, i, j;
 
-    *ppd = PD_REALLOC(((void *) *ppd),
-		      PD_SZ2BYTES((*ppd)->arraySize),
-		      PD_SZ2BYTES(siz));
-
-    (*ppd)->arraySize = siz;
-}
-    
-			
-static void ensure_array_size(ProcDict **ppdict, unsigned int size)
-{
-    ProcDict *pd = *ppdict;
-    unsigned int i;
+    HDEBUGF(("pd_resize: size = %d, new size = %d",
+	     (int) old->size, (int) size));
 
-    if (pd == NULL) {
-	Uint siz = next_array_size(size);
-
-        pd = PD_ALLOC(PD_SZ2BYTES(siz));
-	for (i = 0; i < siz; ++i) 
-	    pd->data[i] = NIL;
-	pd->arraySize = siz;
-        *ppdict = pd;
-    } else if (size > pd->arraySize) {
-	Uint osize = pd->arraySize;
-	Uint nsize = next_array_size(size);
-	pd = PD_REALLOC(((void *) pd),
-			     PD_SZ2BYTES(osize),
-			     PD_SZ2BYTES(nsize));
-	for (i = osize; i < nsize; ++i)
-	    pd->data[i] = NIL;
-	pd->arraySize = nsize;
-        *ppdict = pd;
+    if (size < INITIAL_SIZE) {
+	size = INITIAL_SIZE;
     }
-}
-
-/*
-** Basic utilities
-*/
-
-static unsigned int pd_hash_value_to_ix(ProcDict *pdict, Uint32 hx) 
-{ 
-    Uint high;
-
-    ASSERT(IS_POW2(pdict->sizeMask+1));
-    ASSERT(HASH_RANGE(pdict) >= (pdict->sizeMask >> 1));
-    ASSERT(HASH_RANGE(pdict) <= (pdict->sizeMask + 1));
-
-    high = hx & pdict->sizeMask;
-    if (high >= HASH_RANGE(pdict))
-	return hx & (pdict->sizeMask >> 1);
-    return high;
-}
-
-
-static unsigned int next_array_size(unsigned int need)
-{
-    static unsigned int tab[] =
-    {
-	10UL,
-	20UL,
-	40UL,
-	80UL,
-	160UL,
-	320UL,
-	640UL,
-	1280UL,
-	2560UL,
-	5120UL,
-	10240UL,
-	20480UL,
-	40960UL,
-	81920UL,
-	163840UL,
-	327680UL,
-	655360UL,
-	1310720UL,
-	2621440UL,
-	5242880UL,
-	10485760UL,
-	20971520UL,
-	41943040UL,
-	83886080UL,
-	167772160UL,
-	335544320UL,
-	671088640UL,
-	1342177280UL,
-	2684354560UL
-    };
-    int hi = sizeof(tab) / sizeof(Uint) - 1;
-    int lo = 1;
-    int cur = 4;
-
-    while (hi >= lo) {
-	if (tab[cur] >= need && tab[cur - 1] < need)
-	    return tab[cur];
-	if (tab[cur] > need)
-	    hi = cur - 1;
-	else
-	    lo = cur + 1;
-	cur = (hi + lo) / 2;
+    ASSERT(old->numElements < size);
+    pd = pd_alloc(size);
+    hashes = PD_HASHES(pd);
+    mask = size - 1;
+    for (i = 0; i < old->size; ++i) {
+	if (old_hashes[i] != 0) {
+	    for (j = pd_hash_ix(old_hashes[i], mask);
+		 hashes[j] != 0;
+		 j = (j + 1) & mask) {
+		;
+	    }
+	    pd->data[j] = old->data[i];
+	    hashes[j] = old_hashes[i];
+	}
     }
-    return need;
+    pd->numElements = old->numElements;
+    PD_FREE(old, PD_SZ2BYTES(old->size));
+    *ppd = pd;
 }
 
-
 /*
 ** Debug functions 
 */	    
@@ -1034,30 +638,29 @@ static unsigned int next_array_size(unsigned int need)
 
 static void pd_check(ProcDict *pd) 
 {
-    unsigned int i;
-    unsigned int used;
+    Uint32 *hashes;
+    Uint i, mask;
     Uint num;
     if (pd == NULL)
 	return;
-    used = HASH_RANGE(pd);
-    ASSERT(pd->arraySize >= used);
-    ASSERT(HASH_RANGE(pd) <= MAX_HASH);
-    for (i = 0, num = 0; i < used; ++i) {
+    ASSERT(IS_POW2(pd->size));
+    ASSERT(pd->size >= INITIAL_SIZE);
+    hashes = PD_HASHES(pd);
+    mask = pd->size - 1;
+    for (i = 0, num = 0; i < pd->size; ++i) {
 	Eterm t = pd->data[i];
 	if (is_nil(t)) {
+	    ASSERT(hashes[i] == 0);
 	    continue;
 	} else if (is_tuple(t)) {
+	    Uint j;
 	    ++num;
 	    ASSERT(arityval(*tuple_val(t)) == 2);
-            ASSERT(pd_hash_value(pd, tuple_val(t)[1]) == i);
-	    continue;
-	} else if (is_list(t)) {
-	    while (t != NIL) {
-		++num;
-		ASSERT(is_tuple(TCAR(t)));
-		ASSERT(arityval(*(tuple_val(TCAR(t)))) == 2);
-                ASSERT(pd_hash_value(pd, tuple_val(TCAR(t))[1]) == i);
-		t = TCDR(t);
+	    ASSERT(hashes[i] == PD_STORED_HASH(MAKE_HASH(tuple_val(t)[1])));
+	    /* No hole between the home slot and the slot of the entry */
+	    for (j = pd_hash_ix(hashes[i], mask); j != i;
+		 j = (j + 1) & mask) {
+		ASSERT(hashes[j] != 0);
 	    }
 	    continue;
 	} else {
@@ -1067,7 +670,7 @@ static void pd_check(ProcDict *pd)
 	}
     }
     ASSERT(num == pd->numElements);
-    ASSERT(pd->usedSlots >= pd->splitPosition*2);
+    ASSERT(!PD_NEED_GROW(pd, num));
 }
 
 #endif /* DEBUG */
@@ -1088,4 +691,3 @@ static int hdebugf(char *format, ...)
 } 
 
 #endif /* HARDDEBUG */
-
@@ -22,17 +22,19 @@
 #define _ERL_PROCESS_DICT_H
 #include "sys.h"
 
+/*
+ * Open addressed hash table of {Key,Value} tuples. The slots are
+ * followed by an array with the hash value of the key in each slot, so
+ * probing and rehashing never have to look at the keys.
+ */
 typedef struct proc_dict {
-    unsigned int sizeMask;
-    unsigned int usedSlots;
-    unsigned int arraySize;
-    unsigned int splitPosition;
+    Uint size;        /* Number of slots, a power of 2 */
     Uint numElements;
     Eterm data[1]; /* The beginning of an array of erlang terms */
 } ProcDict;
 
 #define ERTS_PD_START(PD) ((PD)->data)
-#define ERTS_PD_SIZE(PD)  ((PD)->usedSlots)
+#define ERTS_PD_SIZE(PD)  ((PD)->size)
 
 int erts_pd_set_initial_size(int size);
 Uint erts_dicts_mem_size(struct process *p);
@@ -37,6 +37,23 @@ typedef struct ErtsPTabListBifData_ ErtsPTabListBifData;
 
 #define ERTS_PTAB_NEW_MAX_RESERVE_FAIL 1000
 
+/*
+ * Number of free_id_data[] positions a scheduler reserves at a
+ * time from aid_ix/fid_ix. Only used when the table has at least
+ * ERTS_PTAB_SCHED_IX_MIN_SLOTS slots per scheduler, so that the
+ * reserved positions are a small part of the table.
+ */
+#define ERTS_PTAB_SCHED_IX_RESERVE 16
+#define ERTS_PTAB_SCHED_IX_MIN_SLOTS (16*ERTS_PTAB_SCHED_IX_RESERVE)
+
+/*
+ * No new ranges are reserved when fewer ids than this are free, and
+ * an allocation that misses then looks for a free id directly in
+ * free_id_data[] instead of stepping aid_ix around the whole ring.
+ */
+#define ERTS_PTAB_SCHED_IX_MIN_FREE \
+    (2*ERTS_PTAB_SCHED_IX_RESERVE*erts_no_schedulers)
+
 #define ERTS_PTAB_LIST_BIF_TAB_INSPECT_INDICES_PER_RED 25
 #define ERTS_PTAB_LIST_BIF_TAB_CHUNK_SIZE 1000
 #define ERTS_PTAB_LIST_BIF_MIN_START_REDS				\
@@ -343,12 +360,163 @@ ix_to_free_id_data_ix(ErtsPTab *ptab, Uint32 ix)
     return dix;
 }
 
+/*
+ * Allocation and freeing of ids operate on the free_id_data[] ring
+ * at positions handed out by the aid_ix and fid_ix counters. In
+ * order not to have all schedulers hammer the same cache line when
+ * spawning and terminating lots of processes, each scheduler
+ * reserves ERTS_PTAB_SCHED_IX_RESERVE consecutive positions at a
+ * time and consumes them locally.
+ *
+ * Positions are still handed out in ring order, so ids are reused
+ * in approximately the same order as before and the time until an
+ * id is reused is unchanged. A position reserved, but not yet used,
+ * by one scheduler is either empty (fid) and skipped by allocators,
+ * or holds a free id (aid) that is skipped by deleters. Both cases
+ * are already handled by the retry loops in erts_ptab_new_element()
+ * and erts_ptab_delete_element().
+ *
+ * A reservation must however not be used after the other counter
+ * has passed it. An aid position consumed after fid_ix has skipped
+ * it would be left empty behind fid_ix, and an fid position filled
+ * after aid_ix has skipped it would leave a free id behind aid_ix.
+ * Either hole makes the other counter step a full lap around the
+ * ring before it gets back in sync. The rest of such a reservation
+ * is therefore dropped; its positions are left as they are, which
+ * is what the other counter expects them to be on its next lap.
+ *
+ * When the table is nearly full, the last free ids may sit in
+ * positions reserved by other schedulers, or in positions that were
+ * filled after aid_ix had passed them. Stepping aid_ix would then
+ * not find them until it has gone a full lap around the ring, so
+ * reservations stop and missing allocations use find_free_id().
+ */
+
+static ERTS_INLINE ErtsPTabSchedIx *
+get_sched_ix(ErtsPTab *ptab)
+{
+#ifdef ERTS_SMP
+    ErtsSchedulerData *esdp;
+    if (!ptab->r.o.sched_ix)
+	return NULL;
+    esdp = erts_get_scheduler_data();
+    if (!esdp || ERTS_SCHEDULER_IS_DIRTY(esdp))
+	return NULL;
+    ASSERT(0 < esdp->no && esdp->no <= erts_no_schedulers);
+    return &ptab->r.o.sched_ix[esdp->no - 1];
+#else
+    return NULL;
+#endif
+}
+
+/*
+ * Has the 'other' counter passed position 'ix' reserved from the
+ * 'own' counter? The other counter trails the own counter in the
+ * ring, so it has passed 'ix' if it is between 'ix' and the own
+ * counter.
+ */
+static ERTS_INLINE int
+reserved_ix_passed(ErtsPTab *ptab, erts_smp_atomic32_t *own,
+		   erts_smp_atomic32_t *other, Uint32 ix)
+{
+    Uint32 mask = ptab->r.o.max - 1;
+    Uint32 own_ix = (Uint32) erts_smp_atomic32_read_nob(own);
+    Uint32 other_ix = (Uint32) erts_smp_atomic32_read_nob(other);
+    return ((other_ix - ix) & mask) < ((own_ix - ix) & mask);
+}
+
+static ERTS_INLINE Uint32
+next_aid_ix(ErtsPTab *ptab, ErtsPTabSchedIx *six, Uint32 free_ids)
+{
+    ErtsPTabIxRange *rng;
+    if (!six)
+	return (Uint32) erts_smp_atomic32_inc_read_acqb(&ptab->vola.tile.aid_ix);
+    rng = &six->data.aid;
+    if (rng->left && reserved_ix_passed(ptab,
+					&ptab->vola.tile.aid_ix,
+					&ptab->vola.tile.fid_ix,
+					rng->ix + 1))
+	rng->left = 0;
+    if (!rng->left) {
+	if (free_ids < ERTS_PTAB_SCHED_IX_MIN_FREE)
+	    return (Uint32) erts_smp_atomic32_inc_read_acqb(&ptab->vola.tile.aid_ix);
+	rng->ix = (Uint32) erts_smp_atomic32_add_read_acqb(&ptab->vola.tile.aid_ix,
+							   ERTS_PTAB_SCHED_IX_RESERVE);
+	rng->ix -= ERTS_PTAB_SCHED_IX_RESERVE;
+	rng->left = ERTS_PTAB_SCHED_IX_RESERVE;
+    }
+    rng->left--;
+    return ++rng->ix;
+}
+
+static ERTS_INLINE Uint32
+next_fid_ix(ErtsPTab *ptab, ErtsPTabSchedIx *six, Uint32 free_ids)
+{
+    ErtsPTabIxRange *rng;
+    if (!six)
+	return (Uint32) erts_smp_atomic32_inc_read_relb(&ptab->vola.tile.fid_ix);
+    rng = &six->data.fid;
+    if (rng->left && reserved_ix_passed(ptab,
+					&ptab->vola.tile.fid_ix,
+					&ptab->vola.tile.aid_ix,
+					rng->ix + 1))
+	rng->left = 0;
+    if (!rng->left) {
+	if (free_ids < ERTS_PTAB_SCHED_IX_MIN_FREE)
+	    return (Uint32) erts_smp_atomic32_inc_read_relb(&ptab->vola.tile.fid_ix);
+	rng->ix = (Uint32) erts_smp_atomic32_add_read_relb(&ptab->vola.tile.fid_ix,
+							   ERTS_PTAB_SCHED_IX_RESERVE);
+	rng->ix -= ERTS_PTAB_SCHED_IX_RESERVE;
+	rng->left = ERTS_PTAB_SCHED_IX_RESERVE;
+    }
+    rng->left--;
+    return ++rng->ix;
+}
+
+/*
+ * Take any free id in free_id_data[], starting at position 'dix'.
+ * Returns invalid_data if there is none, which can happen while the
+ * id counted as free is still being written by its deleter.
+ */
+static Uint32
+find_free_id(ErtsPTab *ptab, Uint32 dix)
+{
+    Uint32 i;
+    for (i = 0; i < ptab->r.o.max; i++) {
+	erts_smp_atomic32_t *fidp = &ptab->r.o.free_id_data[dix];
+	if ((Eterm) erts_smp_atomic32_read_nob(fidp) != ptab->r.o.invalid_data) {
+	    Uint32 data = (Uint32) erts_smp_atomic32_xchg_acqb(
+		fidp, (erts_aint32_t) ptab->r.o.invalid_data);
+	    if ((Eterm) data != ptab->r.o.invalid_data)
+		return data;
+	}
+	if (++dix == ptab->r.o.max)
+	    dix = 0;
+    }
+    return (Uint32) ptab->r.o.invalid_data;
+}
+
+static void
+reset_sched_ix(ErtsPTab *ptab)
+{
+    /* Caller need to read/write lock the table */
+    if (ptab->r.o.sched_ix) {
+	Uint ix;
+	for (ix = 0; ix < erts_no_schedulers; ix++) {
+	    ptab->r.o.sched_ix[ix].data.aid.left = 0;
+	    ptab->r.o.sched_ix[ix].data.fid.left = 0;
+	}
+    }
+}
+
 UWord
 erts_ptab_mem_size(ErtsPTab *ptab)
 {
     UWord size = ptab->r.o.max*sizeof(erts_smp_atomic_t);
     if (ptab->r.o.free_id_data)
 	size += ptab->r.o.max*sizeof(erts_smp_atomic32_t);
+    if (ptab->r.o.sched_ix)
+	size += erts_no_schedulers*sizeof(ErtsPTabSchedIx);
     return size;
 }
 
@@ -419,6 +587,8 @@ erts_ptab_init_table(ErtsPTab *ptab,
 
     ptab->r.o.atomic_refc = atomic_refc;
 
+    ptab->r.o.sched_ix = NULL;
+
     if (legacy) {
 	ptab->r.o.free_id_data = NULL;
 	ptab->r.o.dix_cl_mask = 0;
@@ -457,6 +627,19 @@ erts_ptab_init_table(ErtsPTab *ptab,
 	erts_smp_atomic32_init_nob(&ptab->vola.tile.aid_ix, -1);
 	erts_smp_atomic32_init_nob(&ptab->vola.tile.fid_ix, -1);
 
+#ifdef ERTS_SMP
+	if (erts_no_schedulers > 1
+	    && size / erts_no_schedulers >= ERTS_PTAB_SCHED_IX_MIN_SLOTS) {
+	    ptab->r.o.sched_ix = erts_alloc_permanent_cache_aligned(
+		atype, erts_no_schedulers*sizeof(ErtsPTabSchedIx));
+	    for (ix = 0; ix < erts_no_schedulers; ix++) {
+		ptab->r.o.sched_ix[ix].data.aid.ix = 0;
+		ptab->r.o.sched_ix[ix].data.aid.left = 0;
+		ptab->r.o.sched_ix[ix].data.fid.ix = 0;
+		ptab->r.o.sched_ix[ix].data.fid.left = 0;
+	    }
+	}
+#endif
     }
 
     erts_smp_interval_init(&ptab->list.data.interval);
@@ -527,13 +710,22 @@ erts_ptab_new_element(ErtsPTab *ptab,
 	= erts_smp_current_interval_nob(erts_ptab_interval(ptab));
 
     if (ptab->r.o.free_id_data) {
-	do {
-	    ix = (Uint32) erts_smp_atomic32_inc_read_acqb(&ptab->vola.tile.aid_ix);
+	ErtsPTabSchedIx *six = get_sched_ix(ptab);
+	Uint32 free_ids = ptab->r.o.max - (Uint32) count;
+	while (1) {
+	    ix = next_aid_ix(ptab, six, free_ids);
 	    ix = ix_to_free_id_data_ix(ptab, ix);
 
-	    data = erts_smp_atomic32_xchg_nob(&ptab->r.o.free_id_data[ix],
-					      (erts_aint32_t)ptab->r.o.invalid_data);
-	}while ((Eterm)data == ptab->r.o.invalid_data);
+	    data = erts_smp_atomic32_xchg_acqb(&ptab->r.o.free_id_data[ix],
+					       (erts_aint32_t)ptab->r.o.invalid_data);
+	    if ((Eterm)data != ptab->r.o.invalid_data)
+		break;
+	    if (ptab->r.o.sched_ix && free_ids < ERTS_PTAB_SCHED_IX_MIN_FREE) {
+		data = find_free_id(ptab, ix);
+		if ((Eterm)data != ptab->r.o.invalid_data)
+		    break;
+	    }
+	}
 
 	init_ptab_el(init_arg, (Eterm) data);
 
@@ -689,6 +881,9 @@ erts_ptab_delete_element(ErtsPTab *ptab,
     erts_smp_atomic_set_relb(&ptab->r.o.tab[pix], ERTS_AINT_NULL);
 
     if (ptab->r.o.free_id_data) {
+	ErtsPTabSchedIx *six = get_sched_ix(ptab);
+	Uint32 free_ids = (ptab->r.o.max
+			   - (Uint32) erts_smp_atomic32_read_nob(&ptab->vola.tile.count));
 	Uint32 prev_data;
 	/* Next data for this slot... */
 	data = (Uint32) erts_ptab_id2data(ptab, ptab_el->id);
@@ -702,12 +897,12 @@ erts_ptab_delete_element(ErtsPTab *ptab,
 	ASSERT(pix == erts_ptab_data2pix(ptab, data));
 
 	do { 
-	    ix = (Uint32) erts_smp_atomic32_inc_read_relb(&ptab->vola.tile.fid_ix);
+	    ix = next_fid_ix(ptab, six, free_ids);
 	    ix = ix_to_free_id_data_ix(ptab, ix);
     
-	    prev_data = erts_smp_atomic32_cmpxchg_nob(&ptab->r.o.free_id_data[ix],
-						      data,
-						      ptab->r.o.invalid_data);
+	    prev_data = erts_smp_atomic32_cmpxchg_relb(&ptab->r.o.free_id_data[ix],
+						       data,
+						       ptab->r.o.invalid_data);
 	}while ((Eterm)prev_data != ptab->r.o.invalid_data);
     }
 
@@ -1361,6 +1556,9 @@ erts_ptab_test_next_id(ErtsPTab *ptab, int set, Uint next)
     if (ptab->r.o.free_id_data) {
 	Uint32 id_ix, dix;
 
+	/* Let the next id be taken from aid_ix + 1 */
+	reset_sched_ix(ptab);
+
 	if (set) {
 	    Uint32 i, max_ix, num, stop_id_ix;
 	    max_ix = ptab->r.o.max - 1;
@@ -94,9 +94,29 @@ typedef struct {
     erts_smp_atomic32_t fid_ix;
 } ErtsPTabVolatileData;
 
+/*
+ * Range of free_id_data[] positions reserved by a scheduler
+ * from aid_ix or fid_ix. Only accessed by the scheduler owning
+ * it while read locking the table, or by anyone while read/write
+ * locking the table.
+ */
+typedef struct {
+    Uint32 ix;
+    Uint32 left;
+} ErtsPTabIxRange;
+
+typedef union {
+    struct {
+	ErtsPTabIxRange aid;
+	ErtsPTabIxRange fid;
+    } data;
+    char algn[ERTS_ALC_CACHE_LINE_ALIGN_SIZE(2*sizeof(ErtsPTabIxRange))];
+} ErtsPTabSchedIx;
+
 typedef struct {
     erts_smp_atomic_t *tab;
     erts_smp_atomic32_t *free_id_data;
+    ErtsPTabSchedIx *sched_ix;
     Uint32 max;
     Uint32 pix_mask;
     Uint32 pix_cl_mask;
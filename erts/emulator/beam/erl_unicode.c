@@ -33,6 +33,24 @@
 #include "erl_unicode.h"
 #include "erl_unicode_normalize.h"
 
+/*
+ * Vectorized fast paths. SSE2 is part of the x86_64 base line and is used
+ * for skipping runs of 7-bit ASCII. The AVX2 validation kernel is compiled
+ * with a target attribute and only used if the CPU reports support for it
+ * at runtime (see erts_init_unicode()).
+ */
+#if defined(__GNUC__) && defined(__SSE2__)
+#  include <emmintrin.h>
+#  define ERTS_UTF8_SSE2 1
+#  if defined(__x86_64__) \
+    && (defined(__clang__) || __GNUC__ > 4 \
+        || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#    include <immintrin.h>
+#    define ERTS_UTF8_AVX2 1
+#    define ERTS_UTF8_AVX2_FUNC __attribute__((__target__("avx2")))
+#  endif
+#endif
+
 
 typedef struct _restart_context {
     byte *bytes;
@@ -47,6 +65,9 @@ typedef struct _restart_context {
 #define LOOP_FACTOR_SIMPLE 50 /* When just counting */
 
 static Uint max_loop_limit;
+#ifdef ERTS_UTF8_AVX2
+static int utf8_have_avx2;
+#endif
 
 static BIF_RETTYPE utf8_to_list(Process *p, Eterm arg1);
 static BIF_RETTYPE finalize_list_to_list(Process *p, 
@@ -77,6 +98,10 @@ static Export *c_to_l_int_trap_exportp = NULL;
 void erts_init_unicode(void)
 {
     max_loop_limit = CONTEXT_REDS * LOOP_FACTOR;
+#ifdef ERTS_UTF8_AVX2
+    __builtin_cpu_init();
+    utf8_have_avx2 = __builtin_cpu_supports("avx2");
+#endif
     /* Non visual BIFs to trap to. */
     erts_init_trap_export(&characters_to_utf8_trap_exp,
 			  am_erlang, am_atom_put("characters_to_utf8_trap",23), 3,
@@ -199,6 +224,38 @@ static Sint aligned_binary_size(Eterm binary)
     return binary_size(binary);
 }
 
+#define UTF8_HIGH_BITS ((~((Uint) 0) / 0xFF) * 0x80)
+
+/*
+ * Returns the number of leading 7-bit ASCII bytes in source.
+ */
+static ERTS_INLINE Uint utf8_ascii_prefix(byte *source, Uint size)
+{
+    Uint i = 0;
+#ifdef ERTS_UTF8_SSE2
+    while (size - i >= 16) {
+	int mask = _mm_movemask_epi8(_mm_loadu_si128((__m128i *) (source + i)));
+	if (mask) {
+	    return i + __builtin_ctz(mask);
+	}
+	i += 16;
+    }
+#else
+    while (size - i >= sizeof(Uint)) {
+	Uint w;
+	sys_memcpy(&w, source + i, sizeof(Uint));
+	if (w & UTF8_HIGH_BITS) {
+	    break;
+	}
+	i += sizeof(Uint);
+    }
+#endif
+    while (i < size && (source[i] & ((byte) 0x80)) == 0) {
+	++i;
+    }
+    return i;
+}
+
 static Sint latin1_binary_need(Eterm binary)
 {
     unsigned char *bytes;
@@ -206,8 +263,8 @@ static Sint latin1_binary_need(Eterm binary)
     Uint bitoffs;
     Uint bitsize;
     Uint size;
-    Sint need = 0;
-    Sint i;
+    Sint need;
+    Uint i;
     
     ERTS_GET_BINARY_BYTES(binary, bytes, bitoffs, bitsize);
     if (bitsize != 0) {
@@ -219,12 +276,11 @@ static Sint latin1_binary_need(Eterm binary)
 	   we'we already checked bitsize and that this is a binary */
     }
     size = binary_size(binary);
-    for(i = 0; i < size; ++i) {
-	if (bytes[i] & ((byte) 0x80)) {
-	    need += 2;
-	} else {
-	    need += 1;
-	}
+    need = size;
+    i = 0;
+    while ((i += utf8_ascii_prefix(bytes + i, size - i)) < size) {
+	++need;
+	++i;
     }
     erts_free_aligned_binary_bytes(temp_alloc);
     return need;
@@ -244,6 +300,232 @@ static int utf8_len(byte first)
     return -1;
 }
 
+#ifdef ERTS_UTF8_AVX2
+
+/*
+ * Error classes of the two byte sequences looked up in the tables below.
+ */
+#define UTF8_TOO_SHORT      0x01 /* 11______ 0_______, 11______ 11______ */
+#define UTF8_TOO_LONG       0x02 /* 0_______ 10______ */
+#define UTF8_OVERLONG_3     0x04 /* 11100000 100_____ */
+#define UTF8_TOO_LARGE      0x08 /* 11110100 1001____, 11110100 101_____,
+				    11110101-11111111 10______ */
+#define UTF8_SURROGATE      0x10 /* 11101101 101_____ */
+#define UTF8_OVERLONG_2     0x20 /* 1100000_ 10______ */
+#define UTF8_TOO_LARGE_1000 0x40 /* 11110101-11111111 1000____ */
+#define UTF8_OVERLONG_4     0x40 /* 11110000 1000____ */
+#define UTF8_TWO_CONTS      0x80 /* 10______ 10______ */
+#define UTF8_CARRY          (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+#define UTF8_TBL(A,B,C,D,E,F,G,H,I,J,K,L,M,N,O,P)			\
+    _mm256_broadcastsi128_si256(					\
+	_mm_setr_epi8((char) (A), (char) (B), (char) (C), (char) (D),	\
+		      (char) (E), (char) (F), (char) (G), (char) (H),	\
+		      (char) (I), (char) (J), (char) (K), (char) (L),	\
+		      (char) (M), (char) (N), (char) (O), (char) (P)))
+
+#define UTF8_PREV(IN, PREV, N)						\
+    _mm256_alignr_epi8((IN), _mm256_permute2x128_si256((PREV), (IN), 0x21), \
+		       16 - (N))
+
+#define UTF8_HIGH_NIBBLE(V)						\
+    _mm256_and_si256(_mm256_srli_epi16((V), 4), _mm256_set1_epi8(0x0F))
+
+/*
+ * Validates source in blocks of 32 bytes using the lookup algorithm by
+ * Keiser and Lemire ("Validating UTF-8 In Less Than One Instruction Per
+ * Byte"). Every byte is classified by looking up the nibbles of the
+ * previous byte and the high nibble of the byte itself; the classes that
+ * remain set are errors, except for continuation bytes that belong to a
+ * three or four byte character which are checked against the bytes two
+ * and three positions back.
+ *
+ * Returns the number of bytes in the blocks that were found valid. The
+ * last character of these may continue past the returned size and has
+ * been counted in num_chars. No more than limit characters are counted.
+ */
+static ERTS_UTF8_AVX2_FUNC Uint
+utf8_valid_blocks_avx2(byte *source, Uint size, Uint limit,
+		       Uint *num_chars, int *non_latin1)
+{
+    const __m256i byte_1_high =
+	UTF8_TBL(UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+		 UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+		 UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+		 UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+		 UTF8_TOO_SHORT,
+		 UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+		 UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+		 | UTF8_OVERLONG_4);
+    const __m256i byte_1_low =
+	UTF8_TBL(UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2
+		 | UTF8_OVERLONG_4,
+		 UTF8_CARRY | UTF8_OVERLONG_2,
+		 UTF8_CARRY,
+		 UTF8_CARRY,
+		 UTF8_CARRY | UTF8_TOO_LARGE,
+		 UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		 UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		 UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		 UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		 UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		 UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		 UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		 UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		 UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+		 | UTF8_SURROGATE,
+		 UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		 UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000);
+    const __m256i byte_2_high =
+	UTF8_TBL(UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+		 UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+		 UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS
+		 | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+		 UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS
+		 | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+		 UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS
+		 | UTF8_SURROGATE | UTF8_TOO_LARGE,
+		 UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS
+		 | UTF8_SURROGATE | UTF8_TOO_LARGE,
+		 UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT);
+    /* Largest values of the last three bytes of a block that do not
+       start a character continuing in the next block */
+    const __m256i incomplete_max =
+	_mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+			 -1, -1, -1, -1, -1, -1, -1, -1,
+			 -1, -1, -1, -1, -1, -1, -1, -1,
+			 -1, -1, -1, -1, -1, (char) (0xF0 - 1),
+			 (char) (0xE0 - 1), (char) (0xC0 - 1));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i prev = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+    __m256i max = _mm256_setzero_si256();
+    Uint pos = 0, chars = 0;
+
+    while (size - pos >= 32 && chars + 32 <= limit) {
+	__m256i in = _mm256_loadu_si256((__m256i *) (source + pos));
+
+	if (_mm256_movemask_epi8(in) == 0) {
+	    /* Only ASCII; valid unless the previous block ended with an
+	       incomplete character */
+	    if (!_mm256_testz_si256(prev_incomplete, prev_incomplete)) {
+		break;
+	    }
+	    chars += 32;
+	} else {
+	    __m256i prev1 = UTF8_PREV(in, prev, 1);
+	    __m256i special, must23, err;
+	    int conts;
+
+	    special = _mm256_and_si256(
+		_mm256_and_si256(
+		    _mm256_shuffle_epi8(byte_1_high, UTF8_HIGH_NIBBLE(prev1)),
+		    _mm256_shuffle_epi8(byte_1_low,
+					_mm256_and_si256(prev1, nibble))),
+		_mm256_shuffle_epi8(byte_2_high, UTF8_HIGH_NIBBLE(in)));
+	    must23 = _mm256_or_si256(
+		_mm256_subs_epu8(UTF8_PREV(in, prev, 2),
+				 _mm256_set1_epi8(0xE0 - 0x80)),
+		_mm256_subs_epu8(UTF8_PREV(in, prev, 3),
+				 _mm256_set1_epi8(0xF0 - 0x80)));
+	    err = _mm256_xor_si256(
+		_mm256_and_si256(must23, _mm256_set1_epi8((char) 0x80)),
+		special);
+	    if (!_mm256_testz_si256(err, err)) {
+		break;
+	    }
+	    /* Continuation bytes, 0x80 - 0xBF, are the only ones below
+	       (signed) 0xC0 */
+	    conts = _mm256_movemask_epi8(
+		_mm256_cmpgt_epi8(_mm256_set1_epi8((char) 0xC0), in));
+	    chars += 32 - __builtin_popcount((unsigned) conts);
+	    max = _mm256_max_epu8(max, in);
+	}
+	prev_incomplete = _mm256_subs_epu8(in, incomplete_max);
+	prev = in;
+	pos += 32;
+    }
+
+    *num_chars = chars;
+    *non_latin1 = _mm256_movemask_epi8(
+	_mm256_cmpeq_epi8(_mm256_max_epu8(max, _mm256_set1_epi8((char) 0xC4)),
+			  max)) != 0;
+    return pos;
+}
+
+#undef UTF8_TBL
+#undef UTF8_PREV
+#undef UTF8_HIGH_NIBBLE
+
+#endif /* ERTS_UTF8_AVX2 */
+
+/*
+ * Whether it is worth trying utf8_valid_prefix() at a character starting
+ * with the byte first.
+ */
+static ERTS_INLINE int utf8_prefix_candidate(byte first)
+{
+#ifdef ERTS_UTF8_AVX2
+    if (utf8_have_avx2) {
+	return 1;
+    }
+#endif
+    return (first & ((byte) 0x80)) == 0;
+}
+
+/*
+ * Returns the size of the longest prefix of source, ending at a character
+ * boundary, that could be validated without looking at one character at
+ * a time, and sets num_chars to the number of characters in it, which is
+ * at most limit. Without AVX2 only runs of ASCII are handled here.
+ * is_latin1, if not NULL, is cleared if a character of the prefix does
+ * not fit in latin1.
+ */
+static ERTS_INLINE Uint
+utf8_valid_prefix(byte *source, Uint size, Uint limit, Uint *num_chars,
+		  int *is_latin1)
+{
+    Uint n = 0, chars = 0;
+#ifdef ERTS_UTF8_AVX2
+    if (utf8_have_avx2 && size >= 32 && limit >= 32) {
+	int non_latin1;
+	n = utf8_valid_blocks_avx2(source, size, limit, &chars, &non_latin1);
+	if (n) {
+	    int j;
+	    if (is_latin1 && non_latin1) {
+		*is_latin1 = 0;
+	    }
+	    /* Leave a character continuing past the validated blocks */
+	    for (j = 1; j <= 3 && j <= n; j++) {
+		byte b = source[n - j];
+		int len;
+		if ((b & ((byte) 0xC0)) == 0x80) {
+		    continue;
+		}
+		len = utf8_len(b);
+		if (len < 0 || len > j) {
+		    n -= j;
+		    chars--;
+		}
+		break;
+	    }
+	}
+    }
+#endif
+    if (n < size && chars < limit && (source[n] & ((byte) 0x80)) == 0) {
+	Uint max = size - n;
+	Uint ascii;
+	if (max > limit - chars) {
+	    max = limit - chars;
+	}
+	ascii = utf8_ascii_prefix(source + n, max);
+	n += ascii;
+	chars += ascii;
+    }
+    *num_chars = chars;
+    return n;
+}
+
 static Uint copy_utf8_bin(byte *target, byte *source, Uint size,
 			  byte *leftover, int *num_leftovers,
 			  byte **err_pos, Uint *characters)
@@ -275,6 +557,21 @@ static Uint copy_utf8_bin(byte *target, byte *source, Uint size,
 	source += from_source;
     }
     while (size) {
+	if (utf8_prefix_candidate(*source)) {
+	    Uint chars;
+	    Uint n = utf8_valid_prefix(source, size, ~((Uint) 0), &chars, NULL);
+	    if (n) {
+		sys_memcpy(target, source, n);
+		target += n;
+		source += n;
+		size -= n;
+		copied += n;
+		*characters += chars;
+		if (!size) {
+		    break;
+		}
+	    }
+	}
 	if (((*source) & ((byte) 0x80)) == 0) {
 	    *(target++) = *(source++);
 	    --size; ++copied;
@@ -614,13 +911,17 @@ static Eterm do_build_utf8(Process *p, Eterm ioterm, Sint *left, int latin1,
 	    i = 0;
 	    while(i < size) {
 		if (bytes[i] < 0x80) {
-		    target[(*pos)++] = bytes[i++];
+		    Uint n = utf8_ascii_prefix(bytes + i, size - i);
+		    sys_memcpy(target + (*pos), bytes + i, n);
+		    *pos += n;
+		    i += n;
+		    *characters += n;
 		} else {
 		    target[(*pos)++] = ((bytes[i] >> 6) | ((byte) 0xC0));
 		    target[(*pos)++] = ((bytes[i] & 0x3F) | ((byte) 0x80));
 		    ++i;
+		    ++(*characters);
 		}
-		++(*characters);
 	    }
 	}
 	*left -= size;
@@ -1170,6 +1471,31 @@ analyze_utf8(byte *source, Uint size, byte **err_pos, Uint *num_chars, int *left
     }
     *num_chars = 0;
     while (size) {
+	if (utf8_prefix_candidate(*source)) {
+	    Uint limit = ~((Uint) 0);
+	    Uint n, chars;
+	    /* Stop short of the limits, they are checked below */
+	    if (left) {
+		limit = *left > 1 ? (Uint) (*left - 1) : 0;
+	    }
+	    if (max_chars && max_chars - *num_chars - 1 < limit) {
+		limit = max_chars - *num_chars - 1;
+	    }
+	    n = utf8_valid_prefix(source, size, limit, &chars,
+				  num_latin1_chars ? &is_latin1 : NULL);
+	    if (n) {
+		source += n;
+		size -= n;
+		*num_chars += chars;
+		*err_pos = source;
+		if (num_latin1_chars)
+		    latin1_count += chars;
+		if (left)
+		    *left -= chars;
+		if (!size)
+		    break;
+	    }
+	}
 	if (((*source) & ((byte) 0x80)) == 0) {
 	    source++;
 	    --size;
@@ -45,6 +45,7 @@
 #include "erl_binary.h"
 #include "erl_bits.h"
 #include "erl_zlib.h"
+#include "erl_lz4.h"
 #include "erl_map.h"
 
 #define in_area(ptr,start,nbytes) ((UWord)((char*)(ptr) - (char*)(start)) < (nbytes))
@@ -96,6 +97,14 @@
  *
  */
 
+/*
+ * LZ4 compression is selected by adding TTB_LZ4 to the compression
+ * level; smaller levels are zlib levels.
+ */
+#define TTB_LZ4 (1 << 8)
+#define TTB_IS_LZ4(L) ((L) >= TTB_LZ4)
+#define TTB_LZ4_LEVEL(L) ((L) - TTB_LZ4)
+
 static Export term_to_binary_trap_export;
 
 static byte* enc_term(ErtsAtomCacheMap *, Eterm, byte*, Uint32, struct erl_off_heap_header** off_heap);
@@ -1140,6 +1149,18 @@ BIF_RETTYPE term_to_binary_2(BIF_ALIST_2)
 		if (!(0 <= level && level < 10)) {
 		    goto error;
 		}
+	    } else if (tp[1] == am_compressed && is_tuple_arity(tp[2], 2)) {
+		Eterm *ltp = tuple_val(tp[2]);
+		if (ltp[1] != am_lz4 || !is_small(ltp[2])) {
+		    goto error;
+		}
+		level = signed_val(ltp[2]);
+		if (!(0 <= level && level <= ERL_LZ4_MAX_LEVEL)) {
+		    goto error;
+		}
+		if (level != 0) {
+		    level += TTB_LZ4;
+		}
 	    } else {
 		goto error;
 	    }
@@ -1163,12 +1184,128 @@ BIF_RETTYPE term_to_binary_2(BIF_ALIST_2)
     }
 }
 
+/*
+ * A term compressed with LZ4 is stored as
+ *
+ *   VERSION_MAGIC COMPRESSED_LZ4 UncompressedSize:32 Block...
+ *
+ * Each block holds the next LZ4_EXT_BLOCK_SIZE bytes (or what
+ * remains) of the uncompressed term, compressed independently of
+ * the other blocks, as
+ *
+ *   Size:32 Data:Size
+ *
+ * If the LZ4_EXT_STORED bit of Size is set, Data is not compressed.
+ * Since blocks are independent, both compression and decompression
+ * can be done one block at a time between yields.
+ */
+
+#define LZ4_EXT_BLOCK_SIZE ((Uint) 1 << 16)
+#define LZ4_EXT_STORED ((Uint32) 1 << 31)
+
+/*
+ * Compress 'size' bytes from 'src' into a block at 'dp'. Returns a
+ * pointer past the block, or NULL if it does not fit before 'dend'.
+ */
+static byte *
+lz4_ext_compress_block(byte *dp, byte *dend, byte *src, Uint size, int level)
+{
+    Uint room = dend - dp;
+    Uint csize;
+
+    if (room < 4)
+	return NULL;
+    room -= 4;
+    /* Only keep the compressed data if it is smaller */
+    csize = erl_lz4_compress(dp + 4, room < size ? room : size - 1,
+			     src, size, level);
+    if (csize == 0) {
+	if (size > room)
+	    return NULL;
+	put_int32(size | LZ4_EXT_STORED, dp);
+	sys_memcpy(dp + 4, src, size);
+	csize = size;
+    } else {
+	put_int32(csize, dp);
+    }
+    return dp + 4 + csize;
+}
+
+/*
+ * Decompress the block at 'sp' into the 'size' bytes at 'dp'.
+ * Returns a pointer past the block, or NULL if it is malformed.
+ */
+static byte *
+lz4_ext_decompress_block(byte *dp, Uint size, byte *sp, byte *send)
+{
+    Uint32 bsize;
+
+    if (send - sp < 4)
+	return NULL;
+    bsize = get_int32(sp);
+    sp += 4;
+    if (bsize & LZ4_EXT_STORED) {
+	bsize &= ~LZ4_EXT_STORED;
+	if (bsize != size || bsize > send - sp)
+	    return NULL;
+	sys_memcpy(dp, sp, size);
+    } else if (bsize > send - sp
+	       || erl_lz4_decompress(dp, size, sp, bsize) != (Sint) size) {
+	return NULL;
+    }
+    return sp + bsize;
+}
+
+/*
+ * Check that the block headers of LZ4 data are consistent with 'size'
+ * uncompressed bytes and 'csize' compressed bytes, so that a corrupt
+ * size is detected before memory is allocated for it.
+ */
+static int
+lz4_ext_check_blocks(byte *sp, Uint csize, Uint size)
+{
+    byte *send = sp + csize;
+
+    while (size > 0) {
+	Uint n = size < LZ4_EXT_BLOCK_SIZE ? size : LZ4_EXT_BLOCK_SIZE;
+	Uint32 bsize;
+	if (send - sp < 4)
+	    return 0;
+	bsize = get_int32(sp) & ~LZ4_EXT_STORED;
+	sp += 4;
+	/* LZ4 cannot expand a block more than 255 times */
+	if (bsize > send - sp || 256 * (Uint) bsize < n)
+	    return 0;
+	sp += bsize;
+	size -= n;
+    }
+    return sp == send;
+}
+
+/*
+ * Compress the 'size' bytes at 'src' into LZ4 blocks at 'dp'.
+ * Returns a pointer past the last block, or NULL if they do not fit
+ * before 'dend'.
+ */
+static byte *
+lz4_ext_compress(byte *dp, byte *dend, byte *src, Uint size, int level)
+{
+    while (size > 0 && dp) {
+	Uint n = size < LZ4_EXT_BLOCK_SIZE ? size : LZ4_EXT_BLOCK_SIZE;
+	dp = lz4_ext_compress_block(dp, dend, src, n, level);
+	src += n;
+	size -= n;
+    }
+    return dp;
+}
 
 enum B2TState { /* order is somewhat significant */
     B2TPrepare,
     B2TUncompressChunk,
+    B2TUncompressLZ4,
     B2TSizeInit,
     B2TSize,
+    B2TSizeMore,
     B2TDecodeInit,
     B2TDecode,
     B2TDecodeList,
@@ -1186,15 +1323,20 @@ typedef struct {
     int terms;
     byte* ep;
     int atom_extra_skip;
+    int partial;
+    Uint skip;		/* Bytes not arrived of an open binary (partial) */
+    Uint offs;		/* Offset of 'ep' from the first item (partial) */
+    Uint fun_end;	/* Offset of the end of the last fun (partial) */
 } B2TSizeContext;
 
 typedef struct {
     byte*  ep;
+    byte*  ep_end;	/* End of what has arrived of a stream, or NULL */
     Eterm  res;
     Eterm* next;
     ErtsHeapFactory factory;
     int remaining_n;
-    char* remaining_bytes;
+    ProcBin* remaining_pb;
     ErtsWStack flat_maps;
     ErtsPStack hamt_array;
 } B2TDecodeContext;
@@ -1205,6 +1347,13 @@ typedef struct {
     Uint dleft;
 } B2TUncompressContext;
 
+typedef struct {
+    byte* sbytes;
+    byte* send;
+    byte* dbytes;
+    Uint dleft;
+} B2TUncompressLZ4Context;
+
 typedef struct B2TContext_t {
     Sint heap_size;
     byte* aligned_alloc;
@@ -1219,6 +1368,7 @@ typedef struct B2TContext_t {
 	B2TSizeContext sc;
 	B2TDecodeContext dc;
 	B2TUncompressContext uc;
+	B2TUncompressLZ4Context lc;
     } u;
 } B2TContext;
 
@@ -1266,7 +1416,39 @@ binary2term_prepare(ErtsBinary2TermState *state, byte *data, Sint data_size,
     }
     bytes++;
     size--;
-    if (size < 5 || *bytes != COMPRESSED) {
+    if (size >= 5 && *bytes == COMPRESSED_LZ4) {
+	Uint dest_len = (Uint32) get_int32(bytes+1);
+	bytes += 5;
+	size -= 5;
+	if (!lz4_ext_check_blocks(bytes, size, dest_len)) {
+	    return -1;
+	}
+	state->extp = erts_alloc(ERTS_ALC_T_EXT_TERM_DATA, dest_len);
+	state->exttmp = 1;
+	if (ctx) {
+	    ctx->u.lc.sbytes = bytes;
+	    ctx->u.lc.send = bytes + size;
+	    ctx->u.lc.dbytes = state->extp;
+	    ctx->u.lc.dleft = dest_len;
+	    ctx->state = B2TUncompressLZ4;
+	}
+	else {
+	    byte *dp = state->extp;
+	    byte *send = bytes + size;
+	    Uint left = dest_len;
+	    while (left > 0) {
+		Uint n = left < LZ4_EXT_BLOCK_SIZE ? left : LZ4_EXT_BLOCK_SIZE;
+		bytes = lz4_ext_decompress_block(dp, n, bytes, send);
+		if (!bytes) {
+		    return -1;
+		}
+		dp += n;
+		left -= n;
+	    }
+	}
+	size = (Sint) dest_len;
+    }
+    else if (size < 5 || *bytes != COMPRESSED) {
 	state->extp = bytes;
         if (ctx)
 	    ctx->state = B2TSizeInit;
@@ -1514,8 +1696,29 @@ static BIF_RETTYPE binary_to_term_int(Process* p, Uint32 flags, Eterm bin, Binar
             }
             break;
         }
+	case B2TUncompressLZ4: {
+            Uint n = ctx->u.lc.dleft;
+
+            if (n > LZ4_EXT_BLOCK_SIZE)
+                n = LZ4_EXT_BLOCK_SIZE;
+            ctx->u.lc.sbytes = lz4_ext_decompress_block(ctx->u.lc.dbytes, n,
+                                                        ctx->u.lc.sbytes,
+                                                        ctx->u.lc.send);
+            if (!ctx->u.lc.sbytes) {
+                ctx->state = B2TBadArg;
+                break;
+            }
+            ctx->u.lc.dbytes += n;
+            ctx->u.lc.dleft -= n;
+            ctx->reds -= n / B2T_MEMCPY_FACTOR;
+            if (ctx->u.lc.dleft == 0) {
+                ctx->state = B2TSizeInit;
+            }
+            break;
+        }
 	case B2TSizeInit:
 	    ctx->u.sc.ep = NULL;
+	    ctx->u.sc.partial = 0;
 	    ctx->state = B2TSize;
 	    /*fall through*/
         case B2TSize:
@@ -1532,6 +1735,7 @@ static BIF_RETTYPE binary_to_term_int(Process* p, Uint32 flags, Eterm bin, Binar
                 ctx = b2t_export_context(p, &c_buff);
             }
             ctx->u.dc.ep = ctx->b2ts.extp;
+            ctx->u.dc.ep_end = NULL;
             ctx->u.dc.res = (Eterm) (UWord) NULL;
             ctx->u.dc.next = &ctx->u.dc.res;
 	    erts_factory_proc_prealloc_init(&ctx->u.dc.factory, p, ctx->heap_size);
@@ -1647,6 +1851,711 @@ error:
     BIF_ERROR(BIF_P, BADARG);
 }
 
+/*
+ * Incremental binary_to_term, for erlang:binary_to_term_feed/2.
+ *
+ * Chunks are decoded as they arrive. The size pass (decoded_size()
+ * in partial mode) scans what has arrived up to where dec_term() can
+ * stop, the heap it needs is reserved in heap fragments owned by the
+ * stream, and dec_term() decodes up to there. Each pass keeps its
+ * state in its own B2TContext between chunks, with positions kept as
+ * offsets as a chunk may move while trapping. The data of a large
+ * binary is copied straight from the chunks into the binary. Only an
+ * item that straddles two chunks, typically a header or an atom, is
+ * copied into a carry buffer until it is complete.
+ *
+ * Compressed terms are uncompressed as they arrive into a buffer, as
+ * binary_to_term does, and decoded from there the same way. An LZ4
+ * block that straddles two chunks is collected in the carry buffer,
+ * unless it is stored uncompressed. When the term is done, the heap
+ * fragments holding it are handed over to the process.
+ */
+
+enum B2TStreamStage {
+    B2TStreamHeader,
+    B2TStreamPlain,
+    B2TStreamZlib,
+    B2TStreamLZ4
+};
+
+typedef struct {
+    B2TContext scan;		/* Size pass */
+    B2TContext dec;		/* Decode pass */
+    Eterm owner;
+    SWord reds;
+    enum B2TStreamStage stage;
+    byte header[6];
+    int header_len;
+    Uint cpos;			/* Offset of the first unused byte of the chunk */
+    int in_chunk;		/* Trapped in the middle of a chunk */
+    byte *aligned;		/* Aligned copy of an unaligned chunk, or NULL */
+    Uint scan_pos;		/* Offset of the size pass in the window */
+    Uint dec_pos;		/* Offset of the decode pass in the window */
+    Uint heap_reserved;		/* Heap reserved for what has been scanned */
+    byte *carry;		/* An item or block that straddles chunks */
+    Uint carry_len;
+    Uint carry_size;
+    int in_carry;		/* Decoding from 'carry' */
+    byte *ext;			/* Uncompressed term, or NULL */
+    Uint ext_len;		/* Bytes uncompressed so far */
+    Uint ext_size;		/* Allocated size of 'ext' */
+    Uint ext_total;		/* Uncompressed size of the term */
+    Uint lz4_stored;		/* Bytes left of a stored LZ4 block */
+    z_stream zstream;
+    int zstream_active;
+} B2TStreamContext;
+
+#define B2T_STREAM_ERROR  -1
+#define B2T_STREAM_MORE    0
+#define B2T_STREAM_DONE    1
+#define B2T_STREAM_YIELD   2
+
+#define B2T_STREAM_MIN_CARRY 64
+#define B2T_STREAM_MIN_HEAP 128
+
+static void b2t_stream_reset(B2TStreamContext *sctx)
+{
+    B2TDecodeContext *dc = &sctx->dec.u.dc;
+
+    if (sctx->stage != B2TStreamHeader) {
+	erts_factory_undo(&dc->factory);
+	if (dc->hamt_array.pstart) {
+	    erts_free(dc->hamt_array.alloc_type, dc->hamt_array.pstart);
+	}
+	if (dc->flat_maps.wstart) {
+	    erts_free(dc->flat_maps.alloc_type, dc->flat_maps.wstart);
+	}
+    }
+    if (sctx->zstream_active) {
+	erl_zlib_inflate_finish(&sctx->zstream);
+	sctx->zstream_active = 0;
+    }
+    if (sctx->carry) {
+	erts_free(ERTS_ALC_T_EXT_TERM_DATA, sctx->carry);
+	sctx->carry = NULL;
+    }
+    if (sctx->ext) {
+	erts_free(ERTS_ALC_T_EXT_TERM_DATA, sctx->ext);
+	sctx->ext = NULL;
+    }
+    if (sctx->aligned) {
+	erts_free(ERTS_ALC_T_EXT_TERM_DATA, sctx->aligned);
+	sctx->aligned = NULL;
+    }
+    sctx->stage = B2TStreamHeader;
+    sctx->header_len = 0;
+    sctx->in_chunk = 0;
+    sctx->carry_len = 0;
+    sctx->carry_size = 0;
+    sctx->in_carry = 0;
+    sctx->lz4_stored = 0;
+}
+
+static void b2t_stream_destructor(Binary *context_bin)
+{
+    B2TStreamContext *sctx = ERTS_MAGIC_BIN_DATA(context_bin);
+    ASSERT(ERTS_MAGIC_BIN_DESTRUCTOR(context_bin) == b2t_stream_destructor);
+
+    b2t_stream_reset(sctx);
+}
+
+/* Start the size and decode passes at the first item of the term */
+static void b2t_stream_start(B2TStreamContext *sctx,
+			     enum B2TStreamStage stage, Uint pos)
+{
+    B2TDecodeContext *dc = &sctx->dec.u.dc;
+
+    sctx->stage = stage;
+    sctx->scan.state = B2TSize;
+    sctx->scan.u.sc.ep = NULL;
+    sctx->scan.u.sc.partial = 1;
+    sctx->dec.state = B2TDecode;
+    dc->res = (Eterm) (UWord) NULL;
+    dc->next = &dc->res;
+    dc->flat_maps.wstart = NULL;
+    dc->hamt_array.pstart = NULL;
+    erts_factory_dummy_init(&dc->factory);
+    sctx->heap_reserved = 0;
+    sctx->scan_pos = pos;
+    sctx->dec_pos = pos;
+}
+
+static void b2t_stream_carry(B2TStreamContext *sctx, byte *data, Uint n)
+{
+    Uint need = sctx->carry_len + n;
+
+    if (need > sctx->carry_size) {
+	Uint sz = 2 * sctx->carry_size;
+
+	if (sz < need)
+	    sz = need;
+	if (sz < B2T_STREAM_MIN_CARRY)
+	    sz = B2T_STREAM_MIN_CARRY;
+	if (sctx->carry) {
+	    sctx->carry = erts_realloc(ERTS_ALC_T_EXT_TERM_DATA,
+				       sctx->carry, sz);
+	}
+	else {
+	    sctx->carry = erts_alloc(ERTS_ALC_T_EXT_TERM_DATA, sz);
+	}
+	sctx->carry_size = sz;
+    }
+    sys_memcpy(sctx->carry + sctx->carry_len, data, n);
+    sctx->carry_len = need;
+    sctx->reds -= n / B2T_MEMCPY_FACTOR;
+}
+
+/*
+ * Move bytes of the chunk to the carry buffer until it holds at least
+ * 'len' bytes. Returns false if the chunk ends first.
+ */
+static int b2t_stream_collect(B2TStreamContext *sctx, byte *bytes,
+			      Uint size, Uint len)
+{
+    if (sctx->carry_len < len) {
+	Uint n = len - sctx->carry_len;
+
+	if (n > size - sctx->cpos)
+	    n = size - sctx->cpos;
+	b2t_stream_carry(sctx, bytes + sctx->cpos, n);
+	sctx->cpos += n;
+    }
+    return sctx->carry_len >= len;
+}
+
+/* Make room for 'need' more uncompressed bytes */
+static int b2t_stream_ext_reserve(B2TStreamContext *sctx, Uint need)
+{
+    Uint sz;
+
+    if (sctx->ext_len + need <= sctx->ext_size)
+	return 1;
+    sz = 2 * sctx->ext_size;
+    if (sz < sctx->ext_len + need)
+	sz = sctx->ext_len + need;
+    if (sz > sctx->ext_total)
+	sz = sctx->ext_total;
+    sctx->ext = erts_realloc_fnf(ERTS_ALC_T_EXT_TERM_DATA, sctx->ext, sz);
+    if (!sctx->ext)
+	return 0;
+    sctx->ext_size = sz;
+    return 1;
+}
+
+/*
+ * Reserve the heap for what the size pass has scanned. Unlike in
+ * binary_to_term/1 the sizes claimed by a header cannot be checked
+ * against the size of the input, so failing to allocate is an error
+ * of the stream rather than of the emulator.
+ */
+static int b2t_stream_reserve_heap(B2TStreamContext *sctx, Uint heap_size)
+{
+    ErtsHeapFactory *factory = &sctx->dec.u.dc.factory;
+    Uint need = heap_size - sctx->heap_reserved;
+    ErlHeapFragment *bp;
+    Uint sz;
+
+    if (factory->mode != FACTORY_CLOSED
+	&& factory->hp + need <= factory->hp_end) {
+	sctx->heap_reserved = heap_size;
+	return 1;
+    }
+    sz = need < B2T_STREAM_MIN_HEAP ? B2T_STREAM_MIN_HEAP : need;
+    if (sz > (ERTS_UWORD_MAX - sizeof(ErlHeapFragment)) / sizeof(Eterm))
+	return 0;
+    bp = erts_alloc_fnf(ERTS_ALC_T_HEAP_FRAG, ERTS_HEAP_FRAG_SIZE(sz));
+    if (!bp)
+	return 0;
+    ERTS_INIT_HEAP_FRAG(bp, sz, sz);
+    if (factory->mode == FACTORY_CLOSED) {
+	erts_factory_heap_frag_init(factory, bp);
+    }
+    else {
+	factory->heap_frags->used_size = factory->hp - factory->heap_frags->mem;
+	bp->next = factory->heap_frags;
+	factory->heap_frags = bp;
+	factory->hp = bp->mem;
+	factory->hp_end = bp->mem + sz;
+    }
+    sctx->heap_reserved = heap_size;
+    return 1;
+}
+
+/*
+ * Scan and decode the window of 'len' bytes at 'base', from
+ * sctx->scan_pos and sctx->dec_pos. The decode pass only runs up to
+ * where the size pass has got, and the size pass only runs again when
+ * the decode pass has caught up with it.
+ */
+static int b2t_stream_decode(B2TStreamContext *sctx, byte *base, Uint len)
+{
+    B2TContext *scan = &sctx->scan;
+    B2TContext *dec = &sctx->dec;
+    int stuck = 0;
+
+    while (1) {
+	if (dec->state == B2TDone) {
+	    return B2T_STREAM_DONE;
+	}
+	if (sctx->reds <= 0) {
+	    return B2T_STREAM_YIELD;
+	}
+	if (sctx->dec_pos < sctx->scan_pos
+	    || dec->state == B2TDecodeList
+	    || dec->state == B2TDecodeTuple
+	    || scan->state == B2TDecodeInit) {
+	    ErtsDistExternal fakedep;
+	    byte *ep;
+
+	    fakedep.flags = dec->flags;
+	    dec->u.dc.ep = base + sctx->dec_pos;
+	    dec->u.dc.ep_end = base + sctx->scan_pos;
+	    dec->reds = sctx->reds;
+	    ep = dec_term(&fakedep, NULL, NULL, NULL, dec);
+	    sctx->reds = dec->reds;
+	    if (dec->state == B2TDone) {
+		sctx->dec_pos = ep - base;
+	    }
+	    else if (dec->state == B2TDecodeFail) {
+		return B2T_STREAM_ERROR;
+	    }
+	    else {
+		sctx->dec_pos = dec->u.dc.ep - base;
+	    }
+	}
+	else if (stuck) {
+	    return B2T_STREAM_MORE;
+	}
+	else {
+	    Sint heap_size;
+	    Uint end;
+
+	    if (scan->u.sc.ep) {
+		scan->u.sc.ep = base + sctx->scan_pos;
+	    }
+	    scan->state = B2TSize;
+	    scan->reds = sctx->reds;
+	    heap_size = decoded_size(base + sctx->scan_pos, base + len, 0, scan);
+	    sctx->reds = scan->reds;
+	    switch (scan->state) {
+	    case B2TDecodeInit:
+		/* A fun must end within the term */
+		end = (sctx->stage == B2TStreamPlain ?
+		       scan->u.sc.offs : sctx->ext_total);
+		if (scan->u.sc.fun_end > end) {
+		    return B2T_STREAM_ERROR;
+		}
+		break;
+	    case B2TSizeMore:
+		stuck = 1;
+		/*fall through*/
+	    case B2TSize:
+		heap_size = scan->u.sc.heap_size;
+		break;
+	    default:
+		return B2T_STREAM_ERROR;
+	    }
+	    sctx->scan_pos = scan->u.sc.ep - base;
+	    if (!b2t_stream_reserve_heap(sctx, heap_size)) {
+		return B2T_STREAM_ERROR;
+	    }
+	}
+    }
+}
+
+/* Collect the header; done when the first item or block is next */
+static int b2t_stream_header(B2TStreamContext *sctx, byte *bytes, Uint size)
+{
+    while (sctx->cpos < size) {
+	byte b = bytes[sctx->cpos];
+
+	if (sctx->header_len == 0 && b != VERSION_MAGIC) {
+	    return B2T_STREAM_ERROR;
+	}
+	if (sctx->header_len == 1 && b != COMPRESSED && b != COMPRESSED_LZ4) {
+	    /* The tag of the first item */
+	    b2t_stream_start(sctx, B2TStreamPlain, sctx->cpos);
+	    return B2T_STREAM_DONE;
+	}
+	sctx->header[sctx->header_len++] = b;
+	sctx->cpos++;
+	if (sctx->header_len == 6) {
+	    Uint sz;
+
+	    sctx->ext_total = (Uint32) get_int32(sctx->header + 2);
+	    sctx->ext_len = 0;
+	    /* Grows as needed beyond what binary_to_term allocates at once */
+	    sz = sctx->ext_total;
+	    if (sz > 32*1024*1024)
+		sz = 32*1024*1024;
+	    sctx->ext_size = sz;
+	    sctx->ext = erts_alloc_fnf(ERTS_ALC_T_EXT_TERM_DATA, sz ? sz : 1);
+	    if (!sctx->ext) {
+		return B2T_STREAM_ERROR;
+	    }
+	    if (sctx->header[1] == COMPRESSED) {
+		if (erl_zlib_inflate_start(&sctx->zstream, NULL, 0) != Z_OK) {
+		    return B2T_STREAM_ERROR;
+		}
+		sctx->zstream_active = 1;
+		b2t_stream_start(sctx, B2TStreamZlib, 0);
+	    }
+	    else {
+		b2t_stream_start(sctx, B2TStreamLZ4, 0);
+	    }
+	    return B2T_STREAM_DONE;
+	}
+    }
+    return B2T_STREAM_MORE;
+}
+
+static int b2t_stream_plain(B2TStreamContext *sctx, byte *bytes, Uint size)
+{
+    int res;
+
+    while (sctx->carry_len) {
+	if (!sctx->in_carry) {
+	    /* Add to the straddling item, doubling it, until it is complete */
+	    Uint n = sctx->carry_len;
+
+	    if (n < B2T_STREAM_MIN_CARRY)
+		n = B2T_STREAM_MIN_CARRY;
+	    if (n > size - sctx->cpos)
+		n = size - sctx->cpos;
+	    if (n == 0) {
+		return B2T_STREAM_MORE;
+	    }
+	    b2t_stream_carry(sctx, bytes + sctx->cpos, n);
+	    sctx->cpos += n;
+	    sctx->in_carry = 1;
+	}
+	res = b2t_stream_decode(sctx, sctx->carry, sctx->carry_len);
+	if (res == B2T_STREAM_YIELD || res == B2T_STREAM_ERROR) {
+	    return res;
+	}
+	sctx->in_carry = 0;
+	if (res == B2T_STREAM_DONE) {
+	    sctx->cpos -= sctx->carry_len - sctx->dec_pos;
+	    sctx->carry_len = 0;
+	    return res;
+	}
+	if (sctx->scan_pos > 0) {
+	    /* Past the straddling item; go on in the chunk */
+	    sctx->cpos -= sctx->carry_len - sctx->scan_pos;
+	    sctx->carry_len = 0;
+	    sctx->scan_pos = sctx->cpos;
+	    sctx->dec_pos = sctx->cpos;
+	}
+    }
+
+    res = b2t_stream_decode(sctx, bytes, size);
+    if (res == B2T_STREAM_DONE) {
+	sctx->cpos = sctx->dec_pos;
+    }
+    else if (res == B2T_STREAM_MORE) {
+	/* Keep the start of an item that has not fully arrived */
+	b2t_stream_carry(sctx, bytes + sctx->scan_pos, size - sctx->scan_pos);
+	sctx->scan_pos = 0;
+	sctx->dec_pos = 0;
+	sctx->cpos = size;
+    }
+    return res;
+}
+
+/*
+ * Uncompress what has arrived of a zlib compressed term. Returns
+ * -1 on error, and otherwise whether any progress was made.
+ */
+static int b2t_stream_inflate(B2TStreamContext *sctx, byte *bytes, Uint size)
+{
+    z_stream *zs = &sctx->zstream;
+    Uint avail = size - sctx->cpos;
+    uLongf chunk;
+    int zret;
+
+    if (!b2t_stream_ext_reserve(sctx, sctx->ext_len < sctx->ext_total)) {
+	return -1;
+    }
+    chunk = sctx->ext_size - sctx->ext_len;
+    if ((SWord) chunk > sctx->reds)
+	chunk = sctx->reds;
+    if (avail > (Uint) 1 << 30)
+	avail = (Uint) 1 << 30;
+    zs->next_in = bytes + sctx->cpos;
+    zs->avail_in = (uInt) avail;
+    zret = erl_zlib_inflate_chunk(zs, sctx->ext + sctx->ext_len, &chunk);
+    sctx->cpos = zs->next_in - bytes;
+    sctx->ext_len += chunk;
+    sctx->reds -= chunk;
+    if (zret == Z_STREAM_END) {
+	erl_zlib_inflate_finish(zs);
+	sctx->zstream_active = 0;
+	return sctx->ext_len == sctx->ext_total ? 1 : -1;
+    }
+    if (zret != Z_OK && zret != Z_BUF_ERROR) {
+	return -1;
+    }
+    return chunk > 0 || zs->avail_in < avail;
+}
+
+/*
+ * Uncompress the LZ4 blocks that have arrived. Returns -1 on error,
+ * and otherwise whether any progress was made.
+ */
+static int b2t_stream_unlz4(B2TStreamContext *sctx, byte *bytes, Uint size)
+{
+    int progress = 0;
+
+    while (sctx->ext_len < sctx->ext_total && sctx->reds > 0) {
+	Uint n = sctx->ext_total - sctx->ext_len;
+	Uint avail = size - sctx->cpos;
+	byte *sp;
+	Uint32 bsize;
+
+	if (sctx->lz4_stored) {
+	    /* A stored block is copied as it arrives */
+	    n = sctx->lz4_stored < avail ? sctx->lz4_stored : avail;
+	    if (n == 0)
+		break;
+	    sys_memcpy(sctx->ext + sctx->ext_len, bytes + sctx->cpos, n);
+	    sctx->cpos += n;
+	    sctx->ext_len += n;
+	    sctx->lz4_stored -= n;
+	    sctx->reds -= n / B2T_MEMCPY_FACTOR;
+	    progress = 1;
+	    continue;
+	}
+	if (n > LZ4_EXT_BLOCK_SIZE)
+	    n = LZ4_EXT_BLOCK_SIZE;
+	if (sctx->carry_len == 0 && avail >= 4) {
+	    sp = bytes + sctx->cpos;
+	}
+	else if (b2t_stream_collect(sctx, bytes, size, 4)) {
+	    sp = sctx->carry;
+	}
+	else {
+	    break;
+	}
+	bsize = get_int32(sp);
+	if (!b2t_stream_ext_reserve(sctx, n)) {
+	    return -1;
+	}
+	if (bsize & LZ4_EXT_STORED) {
+	    if ((bsize & ~LZ4_EXT_STORED) != n) {
+		return -1;
+	    }
+	    if (sp == sctx->carry)
+		sctx->carry_len = 0;
+	    else
+		sctx->cpos += 4;
+	    sctx->lz4_stored = n;
+	    progress = 1;
+	    continue;
+	}
+	/* LZ4 cannot expand a block more than 255 times */
+	if (256 * (Uint) bsize < n) {
+	    return -1;
+	}
+	if (sp == sctx->carry || avail - 4 < bsize) {
+	    /* Collect the block in the carry buffer */
+	    if (!b2t_stream_collect(sctx, bytes, size, 4 + bsize)) {
+		break;
+	    }
+	    sp = sctx->carry;
+	    sctx->carry_len = 0;
+	}
+	else {
+	    sctx->cpos += 4 + bsize;
+	}
+	if (!lz4_ext_decompress_block(sctx->ext + sctx->ext_len, n,
+				      sp, sp + 4 + bsize)) {
+	    return -1;
+	}
+	sctx->ext_len += n;
+	sctx->reds -= n / B2T_MEMCPY_FACTOR;
+	progress = 1;
+    }
+    return progress;
+}
+
+static int b2t_stream_compressed(B2TStreamContext *sctx, byte *bytes, Uint size)
+{
+    while (1) {
+	int progress;
+	int res;
+
+	if (sctx->reds <= 0) {
+	    return B2T_STREAM_YIELD;
+	}
+	if (sctx->stage == B2TStreamZlib) {
+	    progress = (sctx->zstream_active ?
+			b2t_stream_inflate(sctx, bytes, size) : 0);
+	}
+	else {
+	    progress = b2t_stream_unlz4(sctx, bytes, size);
+	}
+	if (progress < 0) {
+	    return B2T_STREAM_ERROR;
+	}
+	res = b2t_stream_decode(sctx, sctx->ext, sctx->ext_len);
+	if (res == B2T_STREAM_YIELD || res == B2T_STREAM_ERROR) {
+	    return res;
+	}
+	if (sctx->ext_len == sctx->ext_total && !sctx->zstream_active) {
+	    /* The whole term has been uncompressed */
+	    return res == B2T_STREAM_DONE ? res : B2T_STREAM_ERROR;
+	}
+	if (!progress && sctx->reds > 0) {
+	    return sctx->cpos == size ? B2T_STREAM_MORE : B2T_STREAM_ERROR;
+	}
+    }
+}
+
+static int b2t_stream_feed(B2TStreamContext *sctx, byte *bytes, Uint size)
+{
+    if (sctx->stage == B2TStreamHeader) {
+	int res = b2t_stream_header(sctx, bytes, size);
+	if (res != B2T_STREAM_DONE) {
+	    return res;
+	}
+    }
+    if (sctx->stage == B2TStreamPlain) {
+	return b2t_stream_plain(sctx, bytes, size);
+    }
+    return b2t_stream_compressed(sctx, bytes, size);
+}
+
+static Eterm b2t_stream_sub_binary(Eterm **hpp, Eterm bin, Uint offs, Uint size)
+{
+    ErlSubBin *sb = (ErlSubBin *) *hpp;
+    Eterm orig;
+    Uint offset, bitoffs, bitsize;
+
+    ERTS_GET_REAL_BIN(bin, orig, offset, bitoffs, bitsize);
+    ASSERT(bitsize == 0);
+    sb->thing_word = HEADER_SUB_BIN;
+    sb->size = size;
+    sb->offs = offset + offs;
+    sb->orig = orig;
+    sb->bitoffs = bitoffs;
+    sb->bitsize = 0;
+    sb->is_writable = 0;
+    *hpp += ERL_SUB_BIN_SIZE;
+    return make_binary(sb);
+}
+
+BIF_RETTYPE erts_internal_binary_to_term_stream_1(BIF_ALIST_1)
+{
+    Binary *mbp;
+    B2TStreamContext *sctx;
+    Eterm *hp;
+
+    if (BIF_ARG_1 != am_true && BIF_ARG_1 != am_false) {
+	BIF_ERROR(BIF_P, BADARG);
+    }
+    mbp = erts_create_magic_binary(sizeof(B2TStreamContext),
+				   b2t_stream_destructor);
+    sctx = ERTS_MAGIC_BIN_DATA(mbp);
+    sctx->dec.flags = BIF_ARG_1 == am_true ? ERTS_DIST_EXT_BTT_SAFE : 0;
+    sctx->owner = BIF_P->common.id;
+    sctx->stage = B2TStreamHeader;
+    sctx->header_len = 0;
+    sctx->in_chunk = 0;
+    sctx->aligned = NULL;
+    sctx->carry = NULL;
+    sctx->carry_len = 0;
+    sctx->carry_size = 0;
+    sctx->in_carry = 0;
+    sctx->ext = NULL;
+    sctx->lz4_stored = 0;
+    sctx->zstream_active = 0;
+
+    hp = HAlloc(BIF_P, PROC_BIN_SIZE);
+    BIF_RET(erts_mk_magic_binary_term(&hp, &MSO(BIF_P), mbp));
+}
+
+BIF_RETTYPE erts_internal_binary_to_term_feed_2(BIF_ALIST_2)
+{
+    Eterm bin = BIF_ARG_2;
+    Binary *mbp;
+    B2TStreamContext *sctx;
+    SWord initial_reds;
+    byte *data;
+    Uint bitoffs, bitsize;
+    Uint size;
+    Eterm *hp;
+    int res;
+
+    if (!ERTS_TERM_IS_MAGIC_BINARY(BIF_ARG_1) || is_not_binary(bin)) {
+	BIF_RET(am_badarg);
+    }
+    mbp = ((ProcBin *) binary_val(BIF_ARG_1))->val;
+    if (ERTS_MAGIC_BIN_DESTRUCTOR(mbp) != b2t_stream_destructor) {
+	BIF_RET(am_badarg);
+    }
+    sctx = ERTS_MAGIC_BIN_DATA(mbp);
+    if (sctx->owner != BIF_P->common.id) {
+	BIF_RET(am_badarg);
+    }
+    ERTS_GET_BINARY_BYTES(bin, data, bitoffs, bitsize);
+    if (bitsize != 0) {
+	BIF_RET(am_badarg);
+    }
+    size = binary_size(bin);
+
+    initial_reds = (Uint)(ERTS_BIF_REDS_LEFT(BIF_P) * B2T_BYTES_PER_REDUCTION);
+    sctx->reds = initial_reds;
+
+    if (!sctx->in_chunk) {
+	sctx->cpos = 0;
+	if (bitoffs != 0) {
+	    sctx->aligned = erts_alloc(ERTS_ALC_T_EXT_TERM_DATA, size);
+	    erts_copy_bits(data, bitoffs, 1, sctx->aligned, 0, 1, size * 8);
+	    sctx->reds -= size / B2T_MEMCPY_FACTOR;
+	}
+    }
+    if (sctx->aligned) {
+	data = sctx->aligned;
+    }
+
+    res = b2t_stream_feed(sctx, data, size);
+
+    if (res == B2T_STREAM_YIELD) {
+	sctx->in_chunk = 1;
+	BUMP_ALL_REDS(BIF_P);
+	BIF_TRAP2(bif_export[BIF_erts_internal_binary_to_term_feed_2],
+		  BIF_P, BIF_ARG_1, BIF_ARG_2);
+    }
+    sctx->in_chunk = 0;
+    if (sctx->aligned) {
+	erts_free(ERTS_ALC_T_EXT_TERM_DATA, sctx->aligned);
+	sctx->aligned = NULL;
+    }
+    BUMP_REDS(BIF_P, (initial_reds - sctx->reds) / B2T_BYTES_PER_REDUCTION);
+
+    switch (res) {
+    case B2T_STREAM_MORE:
+	BIF_RET(am_more);
+
+    case B2T_STREAM_DONE: {
+	ErtsHeapFactory *factory = &sctx->dec.u.dc.factory;
+	Eterm term = sctx->dec.u.dc.res;
+	Eterm rest;
+
+	erts_factory_trim_and_close(factory, &term, 1);
+	erts_link_mbuf_to_proc(BIF_P, factory->heap_frags);
+	hp = HAlloc(BIF_P, ERL_SUB_BIN_SIZE + 4);
+	rest = b2t_stream_sub_binary(&hp, bin, sctx->cpos, size - sctx->cpos);
+	b2t_stream_reset(sctx);
+	BIF_RET(TUPLE3(hp, am_done, term, rest));
+    }
+
+    default:
+	b2t_stream_reset(sctx);
+	BIF_RET(am_badarg);
+    }
+}
+
 Eterm
 external_size_1(BIF_ALIST_1)
 {
@@ -1749,7 +2658,18 @@ erts_term_to_binary_simple(Process* p, Eterm Term, Uint size, int level, Uint fl
 	bin = new_binary(p, NULL, real_size+1);
 	out_bytes = binary_bytes(bin);
 	out_bytes[0] = VERSION_MAGIC;
-	if (erl_zlib_compress2(out_bytes+6, &dest_len, bytes, real_size, level) != Z_OK) {
+	if (TTB_IS_LZ4(level)) {
+	    byte *dend = lz4_ext_compress(out_bytes + 6, out_bytes + 6 + dest_len,
+					  bytes, real_size, TTB_LZ4_LEVEL(level));
+	    if (dend == NULL) {
+		sys_memcpy(out_bytes+1, bytes, real_size);
+		bin = erts_realloc_binary(bin, real_size+1);
+	    } else {
+		out_bytes[1] = COMPRESSED_LZ4;
+		put_int32(real_size, out_bytes+2);
+		bin = erts_realloc_binary(bin, dend - out_bytes);
+	    }
+	} else if (erl_zlib_compress2(out_bytes+6, &dest_len, bytes, real_size, level) != Z_OK) {
 	    sys_memcpy(out_bytes+1, bytes, real_size);
 	    bin = erts_realloc_binary(bin, real_size+1);
 	} else {
@@ -1796,6 +2716,8 @@ erts_term_to_binary(Process* p, Eterm Term, int level, Uint flags) {
 #define TERM_TO_BINARY_COMPRESS_CHUNK 10
 #endif
 #define TERM_TO_BINARY_MEMCPY_FACTOR 8
+/* LZ4 compresses this many times faster than zlib */
+#define TERM_TO_BINARY_LZ4_FACTOR 4
 
 static void ttb_context_destructor(Binary *context_bin)
 {
@@ -1829,6 +2751,16 @@ static void ttb_context_destructor(Binary *context_bin)
 		context->s.cc.result_bin = NULL;
 	    }
 	    break;
+	case TTBCompressLZ4:
+	    if (context->s.lc.destination_bin != NULL) {
+		erts_bin_free(context->s.lc.destination_bin);
+		context->s.lc.destination_bin = NULL;
+	    }
+	    if (context->s.lc.result_bin != NULL) {
+		erts_bin_free(context->s.lc.result_bin);
+		context->s.lc.result_bin = NULL;
+	    }
+	    break;
 	}
     }
 }
@@ -1958,6 +2890,25 @@ static Eterm erts_term_to_binary_int(Process* p, Eterm Term, int level, Uint fla
 		   we make sure it's "exported" before doing anything compession-like */
 		EXPORT_CONTEXT();
 		bytes = (byte *) result_bin->orig_bytes; /* result_bin is reallocated */
+		if (TTB_IS_LZ4(level)) {
+		    context->state = TTBCompressLZ4;
+		    context->s.lc.real_size = real_size;
+		    context->s.lc.src_pos = 1;
+		    context->s.lc.level = TTB_LZ4_LEVEL(level);
+		    context->s.lc.result_bin = result_bin;
+
+		    /* Never make the result larger than the uncompressed one */
+		    result_bin = erts_bin_nrml_alloc(real_size);
+		    erts_refc_init(&result_bin->refc, 0);
+		    result_bin->orig_bytes[0] = VERSION_MAGIC;
+		    result_bin->orig_bytes[1] = COMPRESSED_LZ4;
+		    put_int32(real_size - 1, result_bin->orig_bytes + 2);
+
+		    context->s.lc.destination_bin = result_bin;
+		    context->s.lc.dbytes = (byte *) result_bin->orig_bytes + 6;
+		    context->s.lc.dend = (byte *) result_bin->orig_bytes + real_size;
+		    break;
+		}
 		if (erl_zlib_deflate_start(&(context->s.cc.stream),bytes+1,real_size-1,level) 
 		    != Z_OK) {
 		    goto return_normal;
@@ -2054,6 +3005,63 @@ static Eterm erts_term_to_binary_int(Process* p, Eterm Term, int level, Uint fla
 		    return make_binary(pb);
 		}
 	    }
+	case TTBCompressLZ4:
+	    {
+		TTBCompressLZ4Context *lc = &context->s.lc;
+		byte *src = (byte *) lc->result_bin->orig_bytes;
+		Sint max = ERTS_BIF_REDS_LEFT(p);
+		Sint used = 0;
+		Binary *result_bin;
+		ProcBin *pb;
+
+		/* Compress one block at a time until out of reductions */
+		do {
+		    Uint n = lc->real_size - lc->src_pos;
+		    if (n > LZ4_EXT_BLOCK_SIZE) {
+			n = LZ4_EXT_BLOCK_SIZE;
+		    }
+		    lc->dbytes = lz4_ext_compress_block(lc->dbytes, lc->dend,
+							src + lc->src_pos, n,
+							lc->level);
+		    lc->src_pos += n;
+		    used += 1 + (n * CONTEXT_REDS) /
+			(TERM_TO_BINARY_COMPRESS_CHUNK * TERM_TO_BINARY_LZ4_FACTOR);
+		} while (lc->dbytes && lc->src_pos < lc->real_size && used < max);
+
+		if (lc->dbytes == NULL) {
+		    /* Compression did not pay off; use the uncompressed binary */
+		    result_bin = lc->result_bin;
+		    lc->result_bin = NULL;
+		    erts_bin_free(lc->destination_bin);
+		    pb = (ProcBin *) HAlloc(p, PROC_BIN_SIZE);
+		    pb->size = lc->real_size;
+		} else if (lc->src_pos < lc->real_size) {
+		    RETURN_STATE();
+		} else {
+		    byte *dstart = (byte *) lc->destination_bin->orig_bytes;
+		    Uint size = lc->dbytes - dstart;
+		    result_bin = erts_bin_realloc(lc->destination_bin, size);
+		    erts_bin_free(lc->result_bin);
+		    lc->result_bin = NULL;
+		    pb = (ProcBin *) HAlloc(p, PROC_BIN_SIZE);
+		    pb->size = size;
+		}
+		lc->destination_bin = NULL;
+		pb->thing_word = HEADER_PROC_BIN;
+		pb->next = MSO(p).first;
+		MSO(p).first = (struct erl_off_heap_header*)pb;
+		pb->val = result_bin;
+		pb->bytes = (byte*) result_bin->orig_bytes;
+		pb->flags = 0;
+		OH_OVERHEAD(&(MSO(p)), pb->size / sizeof(Eterm));
+		erts_refc_inc(&result_bin->refc, 1);
+		context->alive = 0;
+		BUMP_REDS(p, used);
+		if (context_b && erts_refc_read(&context_b->refc,0) == 0) {
+		    erts_bin_free(context_b);
+		}
+		return make_binary(pb);
+	    }
 	}
     }
 #undef EXPORT_CONTEXT
@@ -2984,6 +3992,7 @@ dec_term(ErtsDistExternal *edep,
     DECLARE_WSTACK(flat_maps); /* for preprocessing of small maps */
     Eterm* next;
     SWord reds;
+    byte* ep_end = NULL;
 #ifdef DEBUG
     Eterm* dbg_resultp = ctx ? &ctx->u.dc.res : objp;
 #endif
@@ -2992,19 +4001,47 @@ dec_term(ErtsDistExternal *edep,
         reds     = ctx->reds;
         next     = ctx->u.dc.next;
         ep       = ctx->u.dc.ep;
+        ep_end   = ctx->u.dc.ep_end;
 	factory  = &ctx->u.dc.factory;
 
-        if (ctx->state != B2TDecode) {
+        if (ctx->state == B2TDecodeBinary) {
+            ProcBin* pb = ctx->u.dc.remaining_pb;
+            Uint offs = pb->size - ctx->u.dc.remaining_n;
+            int n_limit = reds * B2T_MEMCPY_FACTOR;
+
+            /* A stream may not have all of it yet */
+            if (ep_end && n_limit > ep_end - ep) {
+                n_limit = ep_end - ep;
+            }
+            n = ctx->u.dc.remaining_n;
+            if (n > n_limit) {
+                n = n_limit;
+            }
+            if (offs + n > pb->val->orig_size) {
+                /* The binary of a stream grows as the data arrives */
+                Uint sz = 2 * pb->val->orig_size;
+                if (sz < offs + n) {
+                    sz = offs + n;
+                }
+                if (sz > pb->size) {
+                    sz = pb->size;
+                }
+                pb->val = erts_bin_realloc(pb->val, sz);
+                pb->bytes = (byte*) pb->val->orig_bytes;
+            }
+            sys_memcpy(pb->bytes + offs, ep, n);
+            ctx->u.dc.remaining_n -= n;
+            ep += n;
+            reds -= n / B2T_MEMCPY_FACTOR;
+            if (!ctx->u.dc.remaining_n) {
+                ctx->state = B2TDecode;
+            }
+        }
+        else if (ctx->state != B2TDecode) {
             int n_limit = reds;
 
 	    n = ctx->u.dc.remaining_n;
-            if (ctx->state == B2TDecodeBinary) {
-                n_limit *= B2T_MEMCPY_FACTOR;
-                ASSERT(n_limit >= reds);
-		reds -= n / B2T_MEMCPY_FACTOR;
-            }
-	    else
-		reds -= n;
+	    reds -= n;
 
             if (n > n_limit) {
                 ctx->u.dc.remaining_n -= n_limit;
@@ -3048,24 +4085,19 @@ dec_term(ErtsDistExternal *edep,
 		factory->hp = hp;
                 break;
 
-            case B2TDecodeBinary:
-                sys_memcpy(ctx->u.dc.remaining_bytes, ep, n);
-                ctx->u.dc.remaining_bytes += n;
-                ep += n;
-                break;
-
             default:
                 ASSERT(!"Unknown state");
             }
             if (!ctx->u.dc.remaining_n) {
                 ctx->state = B2TDecode;
             }
-            if (reds <= 0) {
-                ctx->u.dc.next = next;
-                ctx->u.dc.ep = ep;
-                ctx->reds = 0;
-                return NULL;
-            }
+        }
+        if (reds <= 0
+            || (ep == ep_end && (next || ctx->state != B2TDecode))) {
+            ctx->u.dc.next = next;
+            ctx->u.dc.ep = ep;
+            ctx->reds = reds > 0 ? reds : 0;
+            return NULL;
         }
 	PSTACK_CHANGE_ALLOCATOR(hamt_array, ERTS_ALC_T_SAVED_ESTACK);
         WSTACK_CHANGE_ALLOCATOR(flat_maps, ERTS_ALC_T_SAVED_ESTACK);
@@ -3494,8 +4526,15 @@ dec_term_atom_common:
 		    sys_memcpy(hb->data, ep, n);
 		    *objp = make_binary(hb);
 		} else {
-		    Binary* dbin = erts_bin_nrml_alloc(n);
+		    Binary* dbin;
 		    ProcBin* pb;
+		    Uint alloc_n = n;
+
+		    if (ep_end && alloc_n > (Uint) (ep_end - ep)) {
+			/* Grown as the data of a stream arrives */
+			alloc_n = ep_end - ep;
+		    }
+		    dbin = erts_bin_nrml_alloc(alloc_n);
 		    erts_refc_init(&dbin->refc, 1);
 		    pb = (ProcBin *) hp;
 		    hp += PROC_BIN_SIZE;
@@ -3510,15 +4549,16 @@ dec_term_atom_common:
 		    *objp = make_binary(pb);
                     if (ctx) {
                         int n_limit = reds * B2T_MEMCPY_FACTOR;
+                        if (ep_end && n_limit > ep_end - ep) {
+                            n_limit = ep_end - ep;
+                        }
                         if (n > n_limit) {
                             ctx->state = B2TDecodeBinary;
                             ctx->u.dc.remaining_n = n - n_limit;
-                            ctx->u.dc.remaining_bytes = dbin->orig_bytes + n_limit;
+                            ctx->u.dc.remaining_pb = pb;
                             n = n_limit;
-                            reds = 0;
                         }
-                        else
-                            reds -= n / B2T_MEMCPY_FACTOR;
+                        reds -= n / B2T_MEMCPY_FACTOR;
                     }
                     sys_memcpy(dbin->orig_bytes, ep, n);
                 }
@@ -3546,9 +4586,15 @@ dec_term_atom_common:
 		    hp += heap_bin_size(n);
                     ep += n;
 		} else {
-		    Binary* dbin = erts_bin_nrml_alloc(n);
+		    Binary* dbin;
 		    ProcBin* pb;
+		    Uint alloc_n = n;
 
+		    if (ep_end && alloc_n > (Uint) (ep_end - ep)) {
+			/* Grown as the data of a stream arrives */
+			alloc_n = ep_end - ep;
+		    }
+		    dbin = erts_bin_nrml_alloc(alloc_n);
 		    erts_refc_init(&dbin->refc, 1);
 		    pb = (ProcBin *) hp;
 		    pb->thing_word = HEADER_PROC_BIN;
@@ -3563,15 +4609,16 @@ dec_term_atom_common:
 		    hp += PROC_BIN_SIZE;
                     if (ctx) {
                         int n_limit = reds * B2T_MEMCPY_FACTOR;
+                        if (ep_end && n_limit > ep_end - ep) {
+                            n_limit = ep_end - ep;
+                        }
                         if (n > n_limit) {
                             ctx->state = B2TDecodeBinary;
                             ctx->u.dc.remaining_n = n - n_limit;
-                            ctx->u.dc.remaining_bytes = dbin->orig_bytes + n_limit;
+                            ctx->u.dc.remaining_pb = pb;
                             n = n_limit;
-                            reds = 0;
                         }
-                        else
-                            reds -= n / B2T_MEMCPY_FACTOR;
+                        reds -= n / B2T_MEMCPY_FACTOR;
                     }
                     sys_memcpy(dbin->orig_bytes, ep, n);
                     ep += n;
@@ -3735,6 +4782,11 @@ dec_term_atom_common:
 		}
 		old_uniq = unsigned_val(temp);
 
+		/* The creator is decoded below, but must be a pid */
+		if (*ep != PID_EXT && *ep != NEW_PID_EXT) {
+		    goto error;
+		}
+
 		/*
 		 * It is safe to link the fun into the fun list only when
 		 * no more validity tests can fail.
@@ -3899,7 +4951,7 @@ dec_term_atom_common:
 	    goto error;
 	}
 
-        if (--reds <= 0) {
+        if (--reds <= 0 || ep == ep_end) {
             if (ctx) {
                 if (next || ctx->state != B2TDecode) {
                     ctx->u.dc.ep = ep;
@@ -3911,7 +4963,7 @@ dec_term_atom_common:
 		    if (!PSTACK_IS_EMPTY(hamt_array)) {
 			PSTACK_SAVE(hamt_array, &ctx->u.dc.hamt_array);
 		    }
-                    ctx->reds = 0;
+                    ctx->reds = reds > 0 ? reds : 0;
                     return NULL;
                 }
             }
@@ -4314,14 +5366,51 @@ encode_size_struct_int(TTBSizeContext* ctx, ErtsAtomCacheMap *acmp, Eterm obj,
 
 
 
+/*
+ * The tags of the items that dec_term() decodes together with the
+ * item before them: the node of a pid, port or reference, and the
+ * fields of an export or a fun. When scanning part of a stream, the
+ * size pass only stops between the items dec_term() decodes one at
+ * a time, so it rejects anything else in these places.
+ */
+static ERTS_INLINE int
+b2t_inline_tag(int tag)
+{
+    switch (tag) {
+    case ATOM_EXT:
+    case ATOM_UTF8_EXT:
+    case SMALL_ATOM_EXT:
+    case SMALL_ATOM_UTF8_EXT:
+    case ATOM_CACHE_REF:
+    case ATOM_INTERNAL_REF2:
+    case ATOM_INTERNAL_REF3:
+    case SMALL_INTEGER_EXT:
+    case INTEGER_EXT:
+    case SMALL_BIG_EXT:
+    case LARGE_BIG_EXT:
+    case PID_EXT:
+    case NEW_PID_EXT:
+	return 1;
+    default:
+	return 0;
+    }
+}
+
 static Sint
 decoded_size(byte *ep, byte* endp, int internal_tags, B2TContext* ctx)
 {
     int heap_size;
     int terms;
     int atom_extra_skip;
+    int inline_items;
+    byte *item_ep;
+    int item_skip;
+    int item_heap_size;
+    int item_terms;
+    byte *base;
     Uint n;
     SWord reds;
+    int partial = ctx && ctx->u.sc.partial;
 
     if (ctx) {
         reds = ctx->reds;
@@ -4339,26 +5428,35 @@ decoded_size(byte *ep, byte* endp, int internal_tags, B2TContext* ctx)
     heap_size = 0;
     terms = 1;
     atom_extra_skip = 0;
+    if (ctx) {
+        ctx->u.sc.skip = 0;
+        ctx->u.sc.offs = 0;
+        ctx->u.sc.fun_end = 0;
+    }
 init_done:
+    base = ep;
+    inline_items = 0;
 
 #define SKIP(sz)				\
     do {					\
 	if ((sz) <= endp-ep) {			\
 	    ep += (sz);				\
-        } else { goto error; };			\
+        } else { goto truncated; };		\
     } while (0)
 
 #define SKIP2(sz1, sz2)				\
     do {					\
 	Uint sz = (sz1) + (sz2);		\
-	if (sz1 < sz && (sz) <= endp-ep) {	\
+	if (sz1 >= sz) {			\
+	    goto error;				\
+	} else if ((sz) <= endp-ep) {		\
 	    ep += (sz);				\
-        } else { goto error; }			\
+        } else { goto truncated; }		\
     } while (0)
 
 #define CHKSIZE(sz)				\
     do {					\
-	 if ((sz) > endp-ep) { goto error; }	\
+	 if ((sz) > endp-ep) { goto truncated; }	\
     } while (0)
 
 #define ADDTERMS(n)				\
@@ -4368,11 +5466,39 @@ init_done:
 	if (terms < before) goto error;     	\
     } while (0)
 
+#define OFFS(p) (ctx->u.sc.offs + (Uint) ((p) - base))
+
+    if (partial && ctx->u.sc.skip) {
+	/* The data of a binary, which dec_term() copies as it arrives */
+	if (ctx->u.sc.skip > endp - ep) {
+	    ctx->u.sc.skip -= endp - ep;
+	    ep = endp;
+	    goto more;
+	}
+	ep += ctx->u.sc.skip;
+	ctx->u.sc.skip = 0;
+	if (terms == 0) {
+	    goto done;
+	}
+    }
+
     ASSERT(terms > 0);
     do {
         int tag;
+	if (inline_items == 0) {
+	    item_ep = ep;
+	    item_skip = atom_extra_skip;
+	    item_heap_size = heap_size;
+	    item_terms = terms;
+	}
 	CHKSIZE(1);
 	tag = ep++[0];
+	if (inline_items > 0) {
+	    inline_items--;
+	    if (partial && !b2t_inline_tag(tag)) {
+		goto error;
+	    }
+	}
 	switch (tag) {
 	case INTEGER_EXT:
 	    SKIP(4);
@@ -4449,6 +5575,7 @@ init_done:
 	    /* In case it is an external pid */
 	    heap_size += EXTERNAL_THING_HEAD_SIZE + 1;
 	    terms++;
+	    inline_items++;
 	    break;
         case NEW_PORT_EXT:
 	    atom_extra_skip = 8;
@@ -4459,6 +5586,7 @@ init_done:
 	    /* In case it is an external port */
 	    heap_size += EXTERNAL_THING_HEAD_SIZE + 1;
 	    terms++;
+	    inline_items++;
 	    break;
 	case NEWER_REFERENCE_EXT:
 	    atom_extra_skip = 4;
@@ -4484,6 +5612,7 @@ init_done:
 		heap_size += EXTERNAL_THING_HEAD_SIZE + id_words;
 #endif
 		terms++;
+		inline_items++;
 		break;
 	    }
 	case REFERENCE_EXT:
@@ -4491,6 +5620,7 @@ init_done:
 	    heap_size += EXTERNAL_THING_HEAD_SIZE + 1;
 	    atom_extra_skip = 5;
 	    terms++;
+	    inline_items++;
 	    break;
 	case NIL_EXT:
 	    break;
@@ -4519,7 +5649,9 @@ init_done:
 	    CHKSIZE(4);
 	    n = get_int32(ep);
 	    ep += 4;
-	    ADDTERMS(2*n);
+	    /* Add keys and values separately, so that overflow is noticed */
+	    ADDTERMS(n);
+	    ADDTERMS(n);
             if (n <= MAP_SMALL_MAP_LIMIT) {
                 heap_size += 3 + n + 1 + n;
             } else {
@@ -4543,6 +5675,15 @@ init_done:
 	case BINARY_EXT:
 	    CHKSIZE(4);
 	    n = get_int32(ep);
+	    if (partial && n > ERL_ONHEAP_BIN_LIMIT
+		&& n > (Uint) (endp - ep) - 4) {
+		if (n > (Uint) INT_MAX) {
+		    goto error;
+		}
+		ep += 4;
+		heap_size += PROC_BIN_SIZE;
+		goto open_binary;
+	    }
 	    SKIP2(n, 4);
 	    if (n <= ERL_ONHEAP_BIN_LIMIT) {
 		heap_size += heap_bin_size(n);
@@ -4554,6 +5695,15 @@ init_done:
 	    {
 		CHKSIZE(5);
 		n = get_int32(ep);
+		if (partial && n > ERL_ONHEAP_BIN_LIMIT
+		    && n > (Uint) (endp - ep) - 5) {
+		    if (n > (Uint) INT_MAX) {
+			goto error;
+		    }
+		    ep += 5;
+		    heap_size += PROC_BIN_SIZE + ERL_SUB_BIN_SIZE;
+		    goto open_binary;
+		}
 		SKIP2(n, 5);
 		if (n <= ERL_ONHEAP_BIN_LIMIT) {
 		    heap_size += heap_bin_size(n) + ERL_SUB_BIN_SIZE;
@@ -4564,6 +5714,7 @@ init_done:
 	    break;
 	case EXPORT_EXT:
 	    terms += 3;
+	    inline_items += 3;
 	    heap_size += 2;
 	    break;
 	case NEW_FUN_EXT:
@@ -4573,7 +5724,15 @@ init_done:
 
 		CHKSIZE(1+16+4+4);
 		total_size = get_int32(ep);
-		CHKSIZE(total_size);		
+		if (partial) {
+		    /* Checked by the caller when the whole term has arrived */
+		    if (OFFS(ep) + total_size > ctx->u.sc.fun_end) {
+			ctx->u.sc.fun_end = OFFS(ep) + total_size;
+		    }
+		}
+		else {
+		    CHKSIZE(total_size);
+		}
 		ep += 1+16+4+4;
 		/*FALLTHROUGH*/
 
@@ -4585,6 +5744,7 @@ init_done:
 		    goto error;
 		}
 		terms += 4 + num_free;
+		inline_items += 4;
 		heap_size += ERL_FUN_SIZE + num_free;
 		break;
 	    }
@@ -4616,7 +5776,8 @@ init_done:
 	}
         terms--;
 
-        if (ctx && --reds <= 0 && terms > 0) {
+        if (ctx && --reds <= 0 && terms > 0 && inline_items == 0) {
+            ctx->u.sc.offs = OFFS(ep);
             ctx->u.sc.heap_size = heap_size;
             ctx->u.sc.terms = terms;
             ctx->u.sc.ep = ep;
@@ -4626,14 +5787,53 @@ init_done:
         }
     }while (terms > 0);
 
+done:
     /* 'terms' may be non-zero if it has wrapped around */
     if (terms == 0) {
         if (ctx) {
+            ctx->u.sc.offs = OFFS(ep);
+            ctx->u.sc.ep = ep;
             ctx->state = B2TDecodeInit;
             ctx->reds = reds;
         }
         return heap_size;
     }
+    goto error;
+
+truncated:
+    if (!partial) {
+        goto error;
+    }
+    /*
+     * The input ends inside the current item, or inside the items
+     * dec_term() decodes along with it. Save the state from before
+     * them, so that scanning can resume when more has arrived.
+     */
+    heap_size = item_heap_size;
+    terms = item_terms;
+    ep = item_ep;
+    atom_extra_skip = item_skip;
+    goto more;
+
+open_binary:
+    /*
+     * A binary too large for the heap that has not fully arrived.
+     * Let dec_term() copy what is there, and skip the rest of it as
+     * it arrives.
+     */
+    ctx->u.sc.skip = n - (Uint) (endp - ep);
+    ep = endp;
+    terms--;
+
+more:
+    ctx->u.sc.offs = OFFS(ep);
+    ctx->u.sc.heap_size = heap_size;
+    ctx->u.sc.terms = terms;
+    ctx->u.sc.ep = ep;
+    ctx->u.sc.atom_extra_skip = atom_extra_skip;
+    ctx->state = B2TSizeMore;
+    ctx->reds = reds;
+    return 0;
 
 error:
     if (ctx) {
@@ -4643,4 +5843,5 @@ error:
 #undef SKIP
 #undef SKIP2
 #undef CHKSIZE
+#undef OFFS
 }
@@ -1010,6 +1010,31 @@ typedef struct {
 
 extern copy_literals_t erts_clrange;
 
+/*
+ * A literal area not belonging to any module, e.g. an object of an ETS
+ * table created with the literal_objects option. Processes may refer
+ * such an area directly, so it may only be freed after all processes
+ * have copied what they refer into their own heaps. This is handled by
+ * the code purger; see erts_queue_release_literal_area().
+ */
+typedef struct ErtsLiteralArea_ {
+    struct ErtsLiteralArea_ *next;
+    ErtsAlcType_t type;                 /* Allocation type of block */
+    void *block;                        /* Memory to free on release */
+    Eterm *start;                       /* Start of terms */
+    Uint size;                          /* Size of terms in words */
+    struct erl_off_heap_header *off_heap;
+} ErtsLiteralArea;
+
+extern Eterm erts_code_purger;
+
+void erts_beam_bif_load_init(void);
+void erts_queue_release_literal_area(ErtsAlcType_t type, void *block,
+                                     Eterm *start, Uint size,
+                                     struct erl_off_heap_header *oh);
+Eterm erts_proc_copy_literal_area(Process *c_p, int *redsp, int fcalls,
+                                  int gc_allowed);
+
 /* beam_load.c */
 typedef struct {
     BeamInstr* current;		/* Pointer to: Mod, Name, Arity */
@@ -1296,6 +1321,8 @@ Sint erts_re_set_loop_limit(Sint limit);
 /* erl_bif_binary.c */
 void erts_init_bif_binary(void);
 Sint erts_binary_set_loop_limit(Sint limit);
+/* erl_bif_persistent.c */
+void erts_init_bif_persistent_term(void);
 
 /* external.c */
 void erts_init_external(void);
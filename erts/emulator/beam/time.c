@@ -68,6 +68,21 @@
  * 9   [                                            )
  *     <3   <2   <2   <2.                          0.1  0.2  0.3  0.0
  * 
+ * LATER WHEEL
+ *
+ * Timers further away than the wheel above (the "soon" wheel) can
+ * hold are kept in a coarser "later" wheel where each slot covers
+ * ERTS_TIW_LATER_SLOT_SIZE clock ticks, i.e. half of the soon wheel.
+ * When the position of the soon wheel gets close enough for a whole
+ * later slot to fit in the soon wheel, the timers of that slot are
+ * moved into the soon wheel. Timers further away than a lap of the
+ * later wheel are put back into their later slot when it is moved.
+ *
+ * Insertion, cancellation and timeout are all O(1) operations, and
+ * each timer is moved at most once per lap of the later wheel. Since
+ * a timer is only put in the soon wheel if it expires before the
+ * next later slot to move, timers with the same timeout are
+ * triggered in the order they were set.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -119,8 +134,34 @@ static int tiw_itime; /* Constant after init */
 #  define TIW_ITIME tiw_itime
 #endif
 
+/* Later wheel size NEED to be a power of 2 */
+#ifdef SMALL_MEMORY
+#  define ERTS_TIW_LATER_SIZE (1 << 10)
+#else
+#  define ERTS_TIW_LATER_SIZE (1 << 14)
+#endif
+#define ERTS_TIW_LATER_SLOT_SIZE (ERTS_TIW_SIZE/2)
+
+#define ERTS_TIW_LATER_SLOT_IX(POS)					\
+    ((int) ((((Uint64) (POS)) / ERTS_TIW_LATER_SLOT_SIZE)		\
+	    & (ERTS_TIW_LATER_SIZE-1)))
+#define ERTS_TIW_LATER_SLOT_START(POS)					\
+    ((POS) & ~((ErtsMonotonicTime) (ERTS_TIW_LATER_SLOT_SIZE-1)))
+/*
+ * First later slot that does not fit in the soon wheel
+ * when it is at position POS.
+ */
+#define ERTS_TIW_LATER_POS(POS)						\
+    (ERTS_TIW_LATER_SLOT_START((POS) + ERTS_TIW_LATER_SLOT_SIZE)	\
+     + ERTS_TIW_LATER_SLOT_SIZE)
+
 struct ErtsTimerWheel_ {
     ErtsTWheelTimer *w[ERTS_TIW_SIZE];
+    struct {
+	ErtsTWheelTimer *w[ERTS_TIW_LATER_SIZE];
+	ErtsMonotonicTime pos; /* Start of next slot to move */
+	Uint nto;
+    } later;
     ErtsMonotonicTime pos;
     Uint nto;
     struct {
@@ -136,6 +177,28 @@ struct ErtsTimerWheel_ {
     ErtsMonotonicTime next_timeout_time;
 };
 
+/*
+ * Returns the position at which the first non-empty later
+ * slot needs to be moved into the soon wheel, or max_pos if
+ * no such slot is found before max_pos.
+ */
+static ERTS_INLINE ErtsMonotonicTime
+find_next_later_move_pos(ErtsTimerWheel *tiw, ErtsMonotonicTime max_pos)
+{
+    ErtsMonotonicTime slot_pos = tiw->later.pos;
+    int slots = ERTS_TIW_LATER_SIZE;
+
+    while (slots-- > 0) {
+	ErtsMonotonicTime move_pos = slot_pos - ERTS_TIW_LATER_SLOT_SIZE;
+	if (move_pos >= max_pos)
+	    break;
+	if (tiw->later.w[ERTS_TIW_LATER_SLOT_IX(slot_pos)])
+	    return move_pos;
+	slot_pos += ERTS_TIW_LATER_SLOT_SIZE;
+    }
+    return max_pos;
+}
+
 static ERTS_INLINE ErtsMonotonicTime
 find_next_timeout(ErtsSchedulerData *esdp,
 		  ErtsTimerWheel *tiw,
@@ -165,6 +228,17 @@ find_next_timeout(ErtsSchedulerData *esdp,
     else
 	min_timeout_pos = ERTS_MONOTONIC_TO_CLKTCKS(curr_time + max_search_time);
 
+    if (tiw->later.nto) {
+	ErtsMonotonicTime move_pos;
+	move_pos = find_next_later_move_pos(tiw, min_timeout_pos);
+	if (move_pos < min_timeout_pos) {
+	    true_min_timeout = 1;
+	    min_timeout_pos = move_pos;
+	}
+	if (tiw->nto == tiw->later.nto)
+	    goto found_next;
+    }
+
     start_ix = tiw_pos_ix = (int) (tiw->pos & (ERTS_TIW_SIZE-1));
 
     do {
@@ -204,19 +278,16 @@ found_next:
 }
 
 static ERTS_INLINE void
-insert_timer_into_slot(ErtsTimerWheel *tiw, int slot, ErtsTWheelTimer *p)
+insert_timer_into_list(ErtsTWheelTimer **list, ErtsTWheelTimer *p)
 {
-    ERTS_TW_ASSERT(slot >= 0);
-    ERTS_TW_ASSERT(slot < ERTS_TIW_SIZE);
-    p->slot = slot;
-    if (!tiw->w[slot]) {
-	tiw->w[slot] = p;
+    if (!*list) {
+	*list = p;
 	p->next = p;
 	p->prev = p;
     }
     else {
 	ErtsTWheelTimer *next, *prev;
-	next = tiw->w[slot];
+	next = *list;
 	prev = next->prev;
 	p->next = next;
 	p->prev = prev;
@@ -225,30 +296,78 @@ insert_timer_into_slot(ErtsTimerWheel *tiw, int slot, ErtsTWheelTimer *p)
     }
 }
 
+static ERTS_INLINE void
+remove_timer_from_list(ErtsTWheelTimer **list, ErtsTWheelTimer *p)
+{
+    if (p->next == p) {
+	ERTS_TW_ASSERT(*list == p);
+	*list = NULL;
+    }
+    else {
+	if (*list == p)
+	    *list = p->next;
+	p->prev->next = p->next;
+	p->next->prev = p->prev;
+    }
+}
+
+static ERTS_INLINE void
+insert_timer_into_slot(ErtsTimerWheel *tiw, int slot, ErtsTWheelTimer *p)
+{
+    ERTS_TW_ASSERT(slot >= 0);
+    ERTS_TW_ASSERT(slot < ERTS_TIW_SIZE);
+    p->slot = slot;
+    insert_timer_into_list(&tiw->w[slot], p);
+}
+
+static ERTS_INLINE void
+insert_timer_into_later_slot(ErtsTimerWheel *tiw, ErtsTWheelTimer *p)
+{
+    int slot = ERTS_TIW_LATER_SLOT_IX(p->timeout_pos);
+    p->slot = ERTS_TIW_SIZE + slot;
+    insert_timer_into_list(&tiw->later.w[slot], p);
+    tiw->later.nto++;
+}
+
+static ERTS_INLINE void
+insert_timer_into_at_once_queue(ErtsTimerWheel *tiw, ErtsTWheelTimer *p)
+{
+    p->next = NULL;
+    p->prev = tiw->at_once.tail;
+    if (tiw->at_once.tail) {
+	ERTS_TW_ASSERT(tiw->at_once.head);
+	tiw->at_once.tail->next = p;
+    }
+    else {
+	ERTS_TW_ASSERT(!tiw->at_once.head);
+	tiw->at_once.head = p;
+    }
+    tiw->at_once.tail = p;
+    tiw->at_once.nto++;
+    p->slot = ERTS_TWHEEL_SLOT_AT_ONCE;
+}
+
 static ERTS_INLINE void
 remove_timer(ErtsTimerWheel *tiw, ErtsTWheelTimer *p)
 {
     int slot = p->slot;
     ERTS_TW_ASSERT(slot != ERTS_TWHEEL_SLOT_INACTIVE);
 
-    if (slot >= 0) {
+    if (slot >= ERTS_TIW_SIZE) {
+	/* Timer in later wheel... */
+	slot -= ERTS_TIW_SIZE;
+	ERTS_TW_ASSERT(slot < ERTS_TIW_LATER_SIZE);
+	remove_timer_from_list(&tiw->later.w[slot], p);
+	ERTS_TW_ASSERT(tiw->later.nto > 0);
+	tiw->later.nto--;
+    }
+    else if (slot >= 0) {
 	/*
 	 * Timer in wheel or in circular
 	 * list of timers currently beeing
 	 * triggered (referred by sentinel).
 	 */
-	ERTS_TW_ASSERT(slot < ERTS_TIW_SIZE);
-
-	if (p->next == p) {
-	    ERTS_TW_ASSERT(tiw->w[slot] == p);
-	    tiw->w[slot] = NULL;
-	}
-	else {
-	    if (tiw->w[slot] == p)
-		tiw->w[slot] = p->next;
-	    p->prev->next = p->next;
-	    p->next->prev = p->prev;
-	}
+	remove_timer_from_list(&tiw->w[slot], p);
     }
     else {
 	/* Timer in "at once" queue... */
@@ -324,6 +443,87 @@ debug_check_safe_to_skip_to(ErtsTimerWheel *tiw, ErtsMonotonicTime skip_to_pos)
 }
 #endif
 
+static ERTS_INLINE void
+prepend_list(ErtsTWheelTimer **list, ErtsTWheelTimer *first)
+{
+    if (first) {
+	if (*list) {
+	    ErtsTWheelTimer *last = first->prev;
+	    last->next = *list;
+	    first->prev = (*list)->prev;
+	    (*list)->prev->next = first;
+	    (*list)->prev = last;
+	}
+	*list = first;
+    }
+}
+
+/*
+ * Move timers of later slots that fit in the soon wheel when
+ * it has been bumped to bump_to into the soon wheel. Returns
+ * 0 if we need to yield, and !0 when done.
+ */
+static int
+move_later_timers(ErtsTimerWheel *tiw, ErtsMonotonicTime bump_to,
+		  int *yield_count)
+{
+    ErtsMonotonicTime later_pos = ERTS_TIW_LATER_POS(bump_to);
+    int slots = ERTS_TIW_LATER_SIZE;
+
+    while (tiw->later.pos < later_pos) {
+	ErtsTWheelTimer *keep = NULL;
+	int ix;
+
+	if (!tiw->later.nto) {
+	    tiw->later.pos = later_pos;
+	    break;
+	}
+
+	ix = ERTS_TIW_LATER_SLOT_IX(tiw->later.pos);
+
+	while (tiw->later.w[ix]) {
+	    ErtsTWheelTimer *p = tiw->later.w[ix];
+
+	    if (--(*yield_count) <= 0) {
+		prepend_list(&tiw->later.w[ix], keep);
+		return 0;
+	    }
+
+	    remove_timer_from_list(&tiw->later.w[ix], p);
+
+	    if (p->timeout_pos >= later_pos) {
+		/* In a later lap; keep it in this slot... */
+		insert_timer_into_list(&keep, p);
+	    }
+	    else {
+		ERTS_TW_ASSERT(tiw->later.nto > 0);
+		tiw->later.nto--;
+		if (p->timeout_pos <= tiw->pos) {
+		    p->timeout_pos = tiw->pos;
+		    insert_timer_into_at_once_queue(tiw, p);
+		}
+		else
+		    insert_timer_into_slot(tiw,
+					   (int) (p->timeout_pos
+						  & (ERTS_TIW_SIZE-1)),
+					   p);
+	    }
+	}
+
+	tiw->later.w[ix] = keep;
+
+	if (--slots == 0) {
+	    /* Inspected the whole later wheel... */
+	    tiw->later.pos = later_pos;
+	    break;
+	}
+
+	tiw->later.pos += ERTS_TIW_LATER_SLOT_SIZE;
+    }
+
+    return !0;
+}
+
 static ERTS_INLINE void
 timeout_timer(ErtsTWheelTimer *p)
 {
@@ -416,6 +616,15 @@ erts_bump_timers(ErtsTimerWheel *tiw, ErtsMonotonicTime curr_time)
 	    if (tiw->nto == 0)
 		goto empty_wheel;
 
+	    if (tiw->later.pos < ERTS_TIW_LATER_POS(bump_to)
+		&& !move_later_timers(tiw, bump_to, &yield_count)) {
+		tiw->true_next_timeout_time = 1;
+		tiw->next_timeout_time = ERTS_CLKTCKS_TO_MONOTONIC(old_pos);
+		tiw->yield_slot = ERTS_TWHEEL_SLOT_INACTIVE;
+		ERTS_MSACC_POP_STATE_M_X();
+		return; /* Yield! */
+	    }
+
 	    if (tiw->true_next_timeout_time) {
 		ErtsMonotonicTime skip_until_pos;
 		/*
@@ -530,10 +739,14 @@ erts_create_timer_wheel(ErtsSchedulerData *esdp)
 					     sizeof(ErtsTimerWheel));
     for(i = 0; i < ERTS_TIW_SIZE; i++)
 	tiw->w[i] = NULL;
+    for(i = 0; i < ERTS_TIW_LATER_SIZE; i++)
+	tiw->later.w[i] = NULL;
 
     mtime = erts_get_monotonic_time(esdp);
     tiw->pos = ERTS_MONOTONIC_TO_CLKTCKS(mtime);
     tiw->nto = 0;
+    tiw->later.pos = ERTS_TIW_LATER_POS(tiw->pos);
+    tiw->later.nto = 0;
     tiw->at_once.head = NULL;
     tiw->at_once.tail = NULL;
     tiw->at_once.nto = 0;
@@ -591,34 +804,41 @@ erts_twheel_set_timer(ErtsTimerWheel *tiw,
 
     if (timeout_pos <= tiw->pos) {
 	tiw->nto++;
-	tiw->at_once.nto++;
-	p->next = NULL;
-	p->prev = tiw->at_once.tail;
-	if (tiw->at_once.tail) {
-	    ERTS_TW_ASSERT(tiw->at_once.head);
-	    tiw->at_once.tail->next = p;
-	}
-	else {	
-	    ERTS_TW_ASSERT(!tiw->at_once.head);
-	    tiw->at_once.head = p;
-	}
-	tiw->at_once.tail = p;
+	insert_timer_into_at_once_queue(tiw, p);
 	p->timeout_pos = tiw->pos;
-	p->slot = ERTS_TWHEEL_SLOT_AT_ONCE;
 	timeout_time = ERTS_CLKTCKS_TO_MONOTONIC(tiw->pos);
     }
     else {
-	int slot;
+	p->timeout_pos = timeout_pos;
 
-	/* calculate slot */
-	slot = (int) (timeout_pos & (ERTS_TIW_SIZE-1));
+	if (!tiw->later.nto) {
+	    ErtsMonotonicTime later_pos = ERTS_TIW_LATER_POS(tiw->pos);
+	    if (tiw->later.pos < later_pos)
+		tiw->later.pos = later_pos;
+	}
 
-	insert_timer_into_slot(tiw, slot, p);
+	if (timeout_pos < tiw->later.pos) {
+	    int slot;
 
-	tiw->nto++;
+	    /* calculate slot */
+	    slot = (int) (timeout_pos & (ERTS_TIW_SIZE-1));
 
-	timeout_time = ERTS_CLKTCKS_TO_MONOTONIC(timeout_pos);
-	p->timeout_pos = timeout_pos;
+	    insert_timer_into_slot(tiw, slot, p);
+
+	    timeout_time = ERTS_CLKTCKS_TO_MONOTONIC(timeout_pos);
+	}
+	else {
+	    ErtsMonotonicTime move_pos;
+
+	    insert_timer_into_later_slot(tiw, p);
+
+	    /* Time when the later slot is moved into the soon wheel */
+	    move_pos = (ERTS_TIW_LATER_SLOT_START(timeout_pos)
+			- ERTS_TIW_LATER_SLOT_SIZE);
+	    timeout_time = ERTS_CLKTCKS_TO_MONOTONIC(move_pos);
+	}
+
+	tiw->nto++;
     }
 
     if (timeout_time < tiw->next_timeout_time) {
@@ -677,6 +897,17 @@ erts_twheel_debug_foreach(ErtsTimerWheel *tiw,
 	    } while (tmr != tiw->w[ix]);
 	}
     }
+
+    for (ix = 0; ix < ERTS_TIW_LATER_SIZE; ix++) {
+	tmr = tiw->later.w[ix];
+	if (tmr) {
+	    do {
+		if (tmr->u.func.timeout == tclbk)
+		    (*func)(arg, tmr->timeout_pos, tmr->u.func.arg);
+		tmr = tmr->next;
+	    } while (tmr != tiw->later.w[ix]);
+	}
+    }
 }
 
 #ifdef ERTS_TW_DEBUG
@@ -339,6 +339,17 @@ static unsigned long one_value = 1;
 #include <setns.h>
 #endif
 
+#if defined(HAVE_SENDFILE) && defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
+/* sendfile(2) directly from the tcp driver, see tcp_inet_sendfile() */
+#if defined(HAVE_SENDFILE) && \
+    (defined(__linux__) || defined(__FreeBSD__) || defined(__DragonFly__) || \
+     (defined(__APPLE__) && defined(__MACH__)))
+#define HAVE_TCP_SENDFILE
+#endif
+
 #define HAVE_UDP
 
 /* SCTP support -- currently for UNIX platforms only: */
@@ -709,6 +720,7 @@ static int is_nonzero(const char *s, size_t n)
 #define TCP_REQ_RECV           42
 #define TCP_REQ_UNRECV         43
 #define TCP_REQ_SHUTDOWN       44
+#define TCP_REQ_SENDFILE       45
 /* UDP and SCTP requests */
 #define PACKET_REQ_RECV        60 /* Common for UDP and SCTP         */
 /* #define SCTP_REQ_LISTEN       61 MERGED Different from TCP; not for UDP */
@@ -731,6 +743,7 @@ static int is_nonzero(const char *s, size_t n)
 #define TCP_ADDF_DELAYED_ECONNRESET 128 /* An ECONNRESET error occured on send or shutdown */
 #define TCP_ADDF_SHUTDOWN_WR_DONE 256 /* A shutdown(sock, SHUT_WR) or SHUT_RDWR was made */
 #define TCP_ADDF_LINGER_ZERO 	  512 /* Discard driver queue on port close */
+#define TCP_ADDF_SENDFILE        1024 /* Send from file descriptor pending */
 
 /* *_REQ_* replies */
 #define INET_REP_ERROR       0
@@ -1242,6 +1255,16 @@ typedef struct {
     inet_async_multi_op *multi_first;/* NULL == no multi-accept-queue, op is in ordinary queue */
     inet_async_multi_op *multi_last;
     MultiTimerData *mtd;        /* Timer structures for multiple accept */
+#ifdef HAVE_TCP_SENDFILE
+    struct {
+	ErlDrvSizeT ioq_skip;   /* queued bytes to send before the file */
+	ErlDrvTermData caller;  /* process to notify when done */
+	int dup_file_fd;        /* our own copy of the file descriptor */
+	Uint64 bytes_sent;
+	Uint64 offset;
+	Uint64 length;          /* bytes left to send, 0 = until EOF */
+    } sendfile;
+#endif
 } tcp_descriptor;
 
 /* send function */
@@ -1252,6 +1275,11 @@ static int tcp_deliver(tcp_descriptor* desc, int len);
 
 static int tcp_shutdown_error(tcp_descriptor* desc, int err);
 
+#ifdef HAVE_TCP_SENDFILE
+static int tcp_inet_sendfile(tcp_descriptor* desc);
+static int tcp_sendfile_aborted(tcp_descriptor* desc, ErlDrvTermData reason);
+#endif
+
 static int tcp_inet_output(tcp_descriptor* desc, HANDLE event);
 static int tcp_inet_input(tcp_descriptor* desc, HANDLE event);
 
@@ -1300,6 +1328,9 @@ static ErlDrvTermData am_tcp_passive;
 static ErlDrvTermData am_tcp_closed;
 static ErlDrvTermData am_tcp_error;
 static ErlDrvTermData am_empty_out_q;
+#ifdef HAVE_TCP_SENDFILE
+static ErlDrvTermData am_sendfile;
+#endif
 static ErlDrvTermData am_ssl_tls;
 #ifdef HAVE_UDP
 static ErlDrvTermData am_udp;
@@ -1448,6 +1479,12 @@ static void *realloc_wrapper(void *current, ErlDrvSizeT size){
   ((vec)[(i)+1] = (ErlDrvTermData)(val)), \
   ((i)+LOAD_UINT_CNT))
 
+#define LOAD_UINT64_CNT 2
+#define LOAD_UINT64(vec, i, ptr) \
+  (((vec)[(i)] = ERL_DRV_UINT64), \
+  ((vec)[(i)+1] = (ErlDrvTermData)(ptr)), \
+  ((i)+LOAD_UINT64_CNT))
+
 #define LOAD_PORT_CNT 2
 #define LOAD_PORT(vec, i, port) \
   (((vec)[(i)] = ERL_DRV_PORT), \
@@ -3860,6 +3897,9 @@ static int inet_init()
     INIT_ATOM(local);
 #endif
     INIT_ATOM(empty_out_q);
+#ifdef HAVE_TCP_SENDFILE
+    INIT_ATOM(sendfile);
+#endif
     INIT_ATOM(ssl_tls);
 
     INIT_ATOM(http_eoh);
@@ -8920,6 +8960,9 @@ static void tcp_clear_output(tcp_descriptor* desc)
     ErlDrvSizeT qsz = driver_sizeq(ix);
 
     driver_deq(ix, qsz);
+#ifdef HAVE_TCP_SENDFILE
+    desc->sendfile.ioq_skip = 0;
+#endif
     send_empty_out_q_msgs(INETP(desc));
 }
 
@@ -8969,6 +9012,9 @@ static ErlDrvData prep_tcp_inet_start(ErlDrvPort port, char* args)
     desc->http_state = 0;
     desc->mtd = NULL;
     desc->multi_first = desc->multi_last = NULL;
+#ifdef HAVE_TCP_SENDFILE
+    desc->sendfile.dup_file_fd = -1;
+#endif
     DEBUGF(("tcp_inet_start(%ld) }\r\n", (long)port));
     return (ErlDrvData) desc;
 }
@@ -9050,6 +9096,10 @@ static tcp_descriptor* tcp_inet_copy(tcp_descriptor* desc,SOCKET s,
 */
 static void tcp_close_check(tcp_descriptor* desc)
 {
+#ifdef HAVE_TCP_SENDFILE
+    if (desc->tcp_add_flags & TCP_ADDF_SENDFILE)
+	tcp_sendfile_aborted(desc, am_closed);
+#endif
     /* XXX:PaN - multiple clients to handle! */
     if (desc->inet.state == INET_STATE_ACCEPTING) {
 	inet_async_op *this_op = desc->inet.opt;
@@ -9432,6 +9482,44 @@ static ErlDrvSSizeT tcp_inet_ctl(ErlDrvData e, unsigned int cmd,
 	    return ctl_reply(INET_REP_OK, NULL, 0, rbuf, rsize);
 	}
     }
+    case TCP_REQ_SENDFILE: {
+#ifdef HAVE_TCP_SENDFILE
+	int fd;
+
+	DEBUGF(("tcp_inet_ctl(%ld): SENDFILE\r\n", (long)desc->inet.port));
+	/* INPUT: FileFd(4), Offset(8), Length(8) */
+	if (!IS_CONNECTED(INETP(desc)))
+	    return ctl_error(ENOTCONN, rbuf, rsize);
+	if (len != 20)
+	    return ctl_error(EINVAL, rbuf, rsize);
+	if (INETP(desc)->is_ignored)
+	    return ctl_error(ENOTSUP, rbuf, rsize);
+	if (desc->tcp_add_flags & TCP_ADDF_SENDFILE)
+	    return ctl_error(EALREADY, rbuf, rsize);
+
+	/* The file may be closed by its owner while we are still sending
+	 * from it, so we keep a descriptor of our own. */
+	if ((fd = dup(get_int32(buf))) < 0)
+	    return ctl_error(errno, rbuf, rsize);
+
+	desc->sendfile.dup_file_fd = fd;
+	desc->sendfile.caller = driver_caller(desc->inet.port);
+	desc->sendfile.offset = get_int64(buf + 4);
+	desc->sendfile.length = get_int64(buf + 12);
+	desc->sendfile.bytes_sent = 0;
+	desc->sendfile.ioq_skip = driver_sizeq(desc->inet.port);
+	desc->tcp_add_flags |= TCP_ADDF_SENDFILE;
+
+	/* Anything already queued goes first; tcp_inet_output() will start
+	 * the transfer once the queue has been drained up to this point. */
+	if (desc->sendfile.ioq_skip == 0)
+	    tcp_inet_sendfile(desc);
+
+	return ctl_reply(INET_REP_OK, NULL, 0, rbuf, rsize);
+#else
+	return ctl_error(ENOTSUP, rbuf, rsize);
+#endif
+    }
     default:
 	DEBUGF(("tcp_inet_ctl(%ld): %u\r\n", (long)desc->inet.port, cmd)); 
 	return inet_ctl(INETP(desc), cmd, buf, len, rbuf, rsize);
@@ -10474,7 +10562,8 @@ static int tcp_sendv(tcp_descriptor* desc, ErlIOVec* ev)
 	ev->size += h_len;
     }
 
-    if ((sz = driver_sizeq(ix)) > 0) {
+    if ((sz = driver_sizeq(ix)) > 0 ||
+	(desc->tcp_add_flags & TCP_ADDF_SENDFILE)) {
 	driver_enqv(ix, ev, 0);
 	if (sz+ev->size >= desc->high) {
 	    DEBUGF(("tcp_sendv(%ld): s=%d, sender forced busy\r\n",
@@ -10569,7 +10658,8 @@ static int tcp_send(tcp_descriptor* desc, char* ptr, ErlDrvSizeT len)
     inet_output_count(INETP(desc), len+h_len);
 
 
-    if ((sz = driver_sizeq(ix)) > 0) {
+    if ((sz = driver_sizeq(ix)) > 0 ||
+	(desc->tcp_add_flags & TCP_ADDF_SENDFILE)) {
 	if (h_len > 0)
 	    driver_enq(ix, buf, h_len);
 	driver_enq(ix, ptr, len);
@@ -10649,6 +10739,165 @@ static void tcp_shutdown_async(tcp_descriptor* desc)
 	desc->tcp_add_flags |= TCP_ADDF_SHUTDOWN_WR_DONE;
 }
 
+#ifdef HAVE_TCP_SENDFILE
+/* Same chunk size as the file driver uses, see efile_sendfile() */
+#define SENDFILE_CHUNK_SIZE ((1UL << 30) - 1)
+
+/* send:
+**   {sendfile, S, Result}
+** and forget about the pending sendfile request
+*/
+static int tcp_sendfile_reply(tcp_descriptor* desc, ErlDrvTermData* spec,
+			      int i)
+{
+    ErlDrvTermData caller = desc->sendfile.caller;
+
+    close(desc->sendfile.dup_file_fd);
+    desc->sendfile.dup_file_fd = -1;
+    desc->sendfile.ioq_skip = 0;
+    desc->sendfile.caller = 0;
+    desc->tcp_add_flags &= ~TCP_ADDF_SENDFILE;
+
+    return erl_drv_send_term(desc->inet.dport, caller, spec, i);
+}
+
+/* send:
+**   {sendfile, S, {ok, BytesSent}}
+*/
+static int tcp_sendfile_completed(tcp_descriptor* desc)
+{
+    ErlDrvTermData spec[2*LOAD_ATOM_CNT + LOAD_PORT_CNT + LOAD_UINT64_CNT +
+			2*LOAD_TUPLE_CNT];
+    ErlDrvUInt64 bytes_sent = desc->sendfile.bytes_sent;
+    int i = 0;
+
+    i = LOAD_ATOM(spec, i, am_sendfile);
+    i = LOAD_PORT(spec, i, desc->inet.dport);
+    i = LOAD_ATOM(spec, i, am_ok);
+    i = LOAD_UINT64(spec, i, &bytes_sent);
+    i = LOAD_TUPLE(spec, i, 2);
+    i = LOAD_TUPLE(spec, i, 3);
+    ASSERT(i == sizeof(spec)/sizeof(*spec));
+
+    return tcp_sendfile_reply(desc, spec, i);
+}
+
+/* send:
+**   {sendfile, S, {error, Reason}}
+*/
+static int tcp_sendfile_aborted(tcp_descriptor* desc, ErlDrvTermData reason)
+{
+    ErlDrvTermData spec[3*LOAD_ATOM_CNT + LOAD_PORT_CNT + 2*LOAD_TUPLE_CNT];
+    int i = 0;
+
+    i = LOAD_ATOM(spec, i, am_sendfile);
+    i = LOAD_PORT(spec, i, desc->inet.dport);
+    i = LOAD_ATOM(spec, i, am_error);
+    i = LOAD_ATOM(spec, i, reason);
+    i = LOAD_TUPLE(spec, i, 2);
+    i = LOAD_TUPLE(spec, i, 3);
+    ASSERT(i == sizeof(spec)/sizeof(*spec));
+
+    return tcp_sendfile_reply(desc, spec, i);
+}
+
+/*
+** Send from the pending sendfile descriptor straight to the socket,
+** without copying the data through the emulator. Must only be called
+** when everything queued ahead of the file has been sent.
+**
+** Returns 1 when the request is finished (the socket can be used for
+** other output), 0 if the socket would block (and output is selected)
+** and -1 if the socket failed.
+*/
+static int tcp_inet_sendfile(tcp_descriptor* desc)
+{
+    ASSERT(desc->tcp_add_flags & TCP_ADDF_SENDFILE);
+    ASSERT(desc->sendfile.ioq_skip == 0);
+
+    DEBUGF(("tcp_inet_sendfile(%ld): s=%d, fd=%d, offset="LLU", length="LLU"\r\n",
+	    (long)desc->inet.port, desc->inet.s, desc->sendfile.dup_file_fd,
+	    (llu_t)desc->sendfile.offset, (llu_t)desc->sendfile.length));
+
+    for (;;) {
+	size_t chunk_size = SENDFILE_CHUNK_SIZE;
+	ssize_t n;
+
+	if (desc->sendfile.length > 0 && desc->sendfile.length < chunk_size)
+	    chunk_size = desc->sendfile.length;
+
+#if defined(__linux__)
+	{
+	    off_t offset = desc->sendfile.offset;
+	    n = sendfile(desc->inet.s, desc->sendfile.dup_file_fd,
+			 &offset, chunk_size);
+	}
+#else
+	{
+	    /* The BSD flavours report partial writes through len, also
+	     * when failing with EAGAIN. */
+	    off_t len;
+	    int res;
+#if defined(__FreeBSD__) || defined(__DragonFly__)
+	    len = 0;
+	    res = sendfile(desc->sendfile.dup_file_fd, desc->inet.s,
+			   desc->sendfile.offset, chunk_size, NULL, &len, 0);
+#else /* Darwin */
+	    len = chunk_size;
+	    res = sendfile(desc->sendfile.dup_file_fd, desc->inet.s,
+			   desc->sendfile.offset, &len, NULL, 0);
+#endif
+	    n = (res < 0 && len == 0) ? -1 : len;
+	}
+#endif
+
+	if (n < 0) {
+	    int err = errno;
+	    if (err == EINTR)
+		continue;
+	    if (err == EAGAIN || err == EWOULDBLOCK) {
+		sock_select(INETP(desc), (FD_WRITE|FD_CLOSE), 1);
+		return 0;
+	    }
+	    DEBUGF(("tcp_inet_sendfile(%ld): s=%d, errno = %d\r\n",
+		    (long)desc->inet.port, desc->inet.s, err));
+	    if (err == EBADF || err == EINVAL || err == EIO ||
+		err == ENOMEM || err == EOVERFLOW || err == ESPIPE) {
+		/* Something is wrong with the file, not the socket; just
+		 * report it and carry on with the output queue. */
+		tcp_sendfile_aborted(desc, error_atom(err));
+		return 1;
+	    }
+	    /* Report the error the same way a failed send would */
+	    if ((err == ECONNRESET || err == EPIPE) &&
+		(desc->tcp_add_flags & TCP_ADDF_SHOW_ECONNRESET))
+		tcp_sendfile_aborted(desc, error_atom(ECONNRESET));
+	    else
+		tcp_sendfile_aborted(desc, am_closed);
+	    return tcp_send_error(desc, err);
+	}
+
+	if (n == 0) {
+	    /* End of file before the requested length was reached */
+	    break;
+	}
+
+	inet_output_count(INETP(desc), n);
+	desc->sendfile.bytes_sent += n;
+	desc->sendfile.offset += n;
+
+	if (desc->sendfile.length > 0) {
+	    desc->sendfile.length -= n;
+	    if (desc->sendfile.length == 0)
+		break;
+	}
+    }
+
+    tcp_sendfile_completed(desc);
+    return 1;
+}
+#endif /* HAVE_TCP_SENDFILE */
+
 static void tcp_inet_drv_output(ErlDrvData data, ErlDrvEvent event)
 {
     (void)tcp_inet_output((tcp_descriptor*)data, (HANDLE)event);
@@ -10722,6 +10971,17 @@ static int tcp_inet_output(tcp_descriptor* desc, HANDLE event)
 	    int vsize;
 	    ssize_t n;
 	    SysIOVec* iov;
+#ifdef HAVE_TCP_SENDFILE
+	    SysIOVec iov_skip[MAX_VSIZE];
+
+	    if ((desc->tcp_add_flags & TCP_ADDF_SENDFILE) &&
+		desc->sendfile.ioq_skip == 0) {
+		if ((ret = tcp_inet_sendfile(desc)) <= 0)
+		    goto done;
+		/* File sent, continue with what was queued behind it */
+		ret = 0;
+	    }
+#endif
 
 	    if ((iov = driver_peekq(ix, &vsize)) == NULL) {
 		sock_select(INETP(desc), FD_WRITE, 0);
@@ -10731,6 +10991,21 @@ static int tcp_inet_output(tcp_descriptor* desc, HANDLE event)
 		goto done;
 	    }
 	    vsize = vsize > MAX_VSIZE ? MAX_VSIZE : vsize;
+#ifdef HAVE_TCP_SENDFILE
+	    if (desc->tcp_add_flags & TCP_ADDF_SENDFILE) {
+		/* Stop at the point where the file is to be inserted */
+		ErlDrvSizeT skip = desc->sendfile.ioq_skip;
+		int i;
+		for (i = 0; i < vsize && skip > 0; i++) {
+		    iov_skip[i] = iov[i];
+		    if (iov_skip[i].iov_len > skip)
+			iov_skip[i].iov_len = skip;
+		    skip -= iov_skip[i].iov_len;
+		}
+		iov = iov_skip;
+		vsize = i;
+	    }
+#endif
 	    DEBUGF(("tcp_inet_output(%ld): s=%d, About to send %d items\r\n", 
 		    (long)desc->inet.port, desc->inet.s, vsize));
 	    if (IS_SOCKET_ERROR(sock_sendv(desc->inet.s, iov, vsize, &n, 0))) {
@@ -10762,6 +11037,10 @@ static int tcp_inet_output(tcp_descriptor* desc, HANDLE event)
 		}
 	      }
 	    }
+#ifdef HAVE_TCP_SENDFILE
+	    if (desc->tcp_add_flags & TCP_ADDF_SENDFILE)
+		desc->sendfile.ioq_skip -= n;
+#endif
 	    if (driver_deq(ix, n) <= desc->low) {
 		if (IS_BUSY(INETP(desc))) {
 		    desc->inet.caller = desc->inet.busy_caller;
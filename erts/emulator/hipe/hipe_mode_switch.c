@@ -528,6 +528,7 @@ Process *hipe_mode_switch(Process *p, unsigned cmd, Eterm reg[])
 	  p->arity = 0;
 	  erts_smp_atomic32_read_band_relb(&p->state,
 					   ~ERTS_PSFLG_ACTIVE);
+	  ERTS_SMP_MSGQ_SHARDS_CHK_WAIT(p);
 	  erts_smp_proc_unlock(p, ERTS_PROC_LOCKS_MSG_RECEIVE);
       do_schedule:
 	  {
@@ -71,6 +71,16 @@
 /* Define to 1 if you have the ANSI C header files. */
 #define STDC_HEADERS 1
 
+/* Define to enable the just-in-time compiler (pcre_jit_compile.c and
+   the bundled sljit) on the architectures that sljit can generate code
+   for. */
+#if defined(__i386__) || defined(__i386) || defined(__x86_64__) || \
+    defined(_M_IX86) || defined(_M_X64) || defined(__arm__) || \
+    defined(__ppc__) || defined(__powerpc__) || defined(_ARCH_PPC) || \
+    (defined(__mips__) && !defined(_LP64))
+#define SUPPORT_JIT
+#endif
+
 /* Define to enable support for Unicode properties */
 #define SUPPORT_UCP
 
@@ -565,6 +565,11 @@ typedef pcre_jit_stack *(*pcre_jit_callback)(void *);
 typedef pcre16_jit_stack *(*pcre16_jit_callback)(void *);
 typedef pcre32_jit_stack *(*pcre32_jit_callback)(void *);
 
+#if defined(ERLANG_INTEGRATION)
+typedef pcre_jit_stack erts_pcre_jit_stack;
+typedef pcre_jit_callback erts_pcre_jit_callback;
+#endif
+
 /* Exported PCRE functions */
 
 #if defined(ERLANG_INTEGRATION)
@@ -98,7 +98,8 @@ $(PCRE_OBJDIR)/pcre_globals.o: $(PCRE_DIR)/pcre_globals.c \
 	$(PCRE_DIR)/pcre.h $(PCRE_DIR)/ucp.h
 $(PCRE_OBJDIR)/pcre_jit_compile.o: $(PCRE_DIR)/pcre_jit_compile.c \
 	$(PCRE_DIR)/pcre_internal.h $(PCRE_DIR)/local_config.h \
-	$(PCRE_DIR)/pcre.h $(PCRE_DIR)/ucp.h
+	$(PCRE_DIR)/pcre.h $(PCRE_DIR)/ucp.h \
+	$(wildcard $(PCRE_DIR)/sljit/*.[ch])
 $(PCRE_OBJDIR)/pcre_latin_1_table.o: $(PCRE_DIR)/pcre_latin_1_table.c \
 	$(PCRE_DIR)/pcre_internal.h $(PCRE_DIR)/local_config.h \
 	$(PCRE_DIR)/pcre.h $(PCRE_DIR)/ucp.h
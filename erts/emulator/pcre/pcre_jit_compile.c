@@ -9530,7 +9530,7 @@ return retval;
 #if defined COMPILE_PCRE8
 #if defined(ERLANG_INTEGRATION)
 PCRE_EXP_DEFN int PCRE_CALL_CONVENTION
-erts_pcre_jit_exec(const pcre *argument_re, const pcre_extra *extra_data,
+erts_pcre_jit_exec(const pcre *argument_re, const erts_pcre_extra *extra_data,
   PCRE_SPTR subject, int length, int start_offset, int options,
   int *offsets, int offset_count, pcre_jit_stack *stack)
 #else
@@ -9694,7 +9694,7 @@ sljit_free_stack((struct sljit_stack *)stack);
 #if defined COMPILE_PCRE8
 #if defined(ERLANG_INTEGRATION)
 PCRE_EXP_DECL void
-erts_pcre_assign_jit_stack(pcre_extra *extra, pcre_jit_callback callback, void *userdata)
+erts_pcre_assign_jit_stack(erts_pcre_extra *extra, pcre_jit_callback callback, void *userdata)
 #else
 PCRE_EXP_DECL void
 pcre_assign_jit_stack(pcre_extra *extra, pcre_jit_callback callback, void *userdata)
@@ -94,9 +94,17 @@ typedef char EventStateFlags;
 
 #define GET_FD(fd) fd
 
-static struct pollset_info
+/*
+ * File descriptors are spread over one or more pollsets. Pollset 0 is
+ * polled by the schedulers via erts_check_io(); every other pollset is
+ * owned by a dedicated poll thread (see the +IOt emulator flag). An fd
+ * always maps to the same pollset (see fd_pollset()), so all state
+ * that is kept per pollset is only touched by the thread polling it.
+ */
+struct pollset_info
 {
     ErtsPollSet ps;
+    ErtsIoPollsetTasks tasks;              /* referred to by io tasks */
     erts_smp_atomic_t in_poll_wait;        /* set while doing poll */
     struct {
 	int six; /* start index */
@@ -109,8 +117,18 @@ static struct pollset_info
     struct removed_fd* removed_list;       /* list of deselected fd's*/
     erts_smp_spinlock_t removed_list_lock;
 #endif
-}pollset;
-#define NUM_OF_POLLSETS 1
+};
+
+typedef union {
+    struct pollset_info psi;
+    byte _cache_line_alignment[ERTS_ALC_CACHE_LINE_ALIGN_SIZE(
+				   sizeof(struct pollset_info))];
+} ErtsPollsetInfo;
+
+static ErtsPollsetInfo *pollsets;
+static int no_pollsets;
+
+#define SCHED_POLLSET (&pollsets[0].psi)
 
 typedef struct {
 #ifndef ERTS_SYS_CONTINOUS_FD_NUMBERS
@@ -167,6 +185,18 @@ static ERTS_INLINE erts_smp_mtx_t* fd_mtx(ErtsSysFdType fd)
 #  define fd_mtx(fd) NULL
 #endif
 
+static ERTS_INLINE struct pollset_info *fd_pollset(ErtsSysFdType fd)
+{
+    unsigned int hash;
+    if (no_pollsets == 1)
+	return SCHED_POLLSET;
+    hash = (unsigned int) fd;
+#ifndef ERTS_SYS_CONTINOUS_FD_NUMBERS
+    hash ^= (hash >> 9);
+#endif
+    return &pollsets[hash % no_pollsets].psi;
+}
+
 #ifdef ERTS_SYS_CONTINOUS_FD_NUMBERS
 
 static erts_smp_atomic_t drv_ev_state_len;
@@ -235,10 +265,11 @@ ERTS_SCHED_PREF_QUICK_ALLOC_IMPL(removed_fd, struct removed_fd, 64, ERTS_ALC_T_F
 #endif
 
 static ERTS_INLINE void
-init_iotask(ErtsIoTask *io_task)
+init_iotask(ErtsIoTask *io_task, struct pollset_info *psi)
 {
     erts_port_task_handle_init(&io_task->task);
     erts_smp_atomic_init_nob(&io_task->executed_time, ~((erts_aint_t) 0));
+    io_task->pollset = &psi->tasks;
 }
 
 static ERTS_INLINE int
@@ -252,14 +283,14 @@ is_iotask_active(ErtsIoTask *io_task, erts_aint_t current_cio_time)
 }
 
 static ERTS_INLINE ErtsDrvSelectDataState *
-alloc_drv_select_data(void)
+alloc_drv_select_data(struct pollset_info *psi)
 {
     ErtsDrvSelectDataState *dsp = erts_alloc(ERTS_ALC_T_DRV_SEL_D_STATE,
 					     sizeof(ErtsDrvSelectDataState));
     dsp->inport = NIL;
     dsp->outport = NIL;
-    init_iotask(&dsp->iniotask);
-    init_iotask(&dsp->outiotask);
+    init_iotask(&dsp->iniotask, psi);
+    init_iotask(&dsp->outiotask, psi);
     return dsp;
 }
 
@@ -274,7 +305,7 @@ free_drv_select_data(ErtsDrvSelectDataState *dsp)
 #if ERTS_CIO_HAVE_DRV_EVENT
 
 static ERTS_INLINE ErtsDrvEventDataState *
-alloc_drv_event_data(void)
+alloc_drv_event_data(struct pollset_info *psi)
 {
     ErtsDrvEventDataState *dep = erts_alloc(ERTS_ALC_T_DRV_EV_D_STATE,
 					    sizeof(ErtsDrvEventDataState));
@@ -284,7 +315,7 @@ alloc_drv_event_data(void)
 #if ERTS_CIO_DEFER_ACTIVE_EVENTS
     dep->deferred_events = 0;
 #endif
-    init_iotask(&dep->iotask);
+    init_iotask(&dep->iotask, psi);
     return dep;
 }
 
@@ -510,6 +541,7 @@ deselect(ErtsDrvEventState *state, int mode)
 {
     int do_wake = 0;
     ErtsPollEvents rm_events;
+    struct pollset_info *psi = fd_pollset(state->fd);
     ERTS_SMP_LC_ASSERT(erts_smp_lc_mtx_is_locked(fd_mtx(state->fd)));
     ASSERT(state->events);
 
@@ -530,7 +562,7 @@ deselect(ErtsDrvEventState *state, int mode)
 	}
     }
 
-    state->events = ERTS_CIO_POLL_CTL(pollset.ps, state->fd, rm_events, 0, &do_wake);
+    state->events = ERTS_CIO_POLL_CTL(psi->ps, state->fd, rm_events, 0, &do_wake);
 
     if (!(state->events)) {
 	switch (state->type) {
@@ -554,7 +586,7 @@ deselect(ErtsDrvEventState *state, int mode)
 	    
 	state->type = ERTS_EV_TYPE_NONE;
 	state->flags &= ~ERTS_EV_FLAG_USED;
-	remember_removed(state, &pollset);
+	remember_removed(state, psi);
     }
 }
 
@@ -575,7 +607,8 @@ check_fd_cleanup(ErtsDrvEventState *state,
 
     ERTS_SMP_LC_ASSERT(erts_smp_lc_mtx_is_locked(fd_mtx(state->fd)));
 
-    current_cio_time = erts_smp_atomic_read_acqb(&erts_check_io_time);
+    current_cio_time = erts_smp_atomic_read_acqb(
+	&fd_pollset(state->fd)->tasks.check_io_time);
     *free_select = NULL;
     if (state->driver.select
 	&& (state->type != ERTS_EV_TYPE_DRV_SEL)
@@ -746,12 +779,13 @@ check_cleanup_active_fd(ErtsSysFdType fd,
 }
 
 static void
-check_cleanup_active_fds(erts_aint_t current_cio_time)
+check_cleanup_active_fds(struct pollset_info *psi,
+			 erts_aint_t current_cio_time)
 {
-    int six = pollset.active_fd.six;
-    int eix = pollset.active_fd.eix;
-    erts_aint32_t no = erts_smp_atomic32_read_dirty(&pollset.active_fd.no);
-    int size = pollset.active_fd.size;
+    int six = psi->active_fd.six;
+    int eix = psi->active_fd.eix;
+    erts_aint32_t no = erts_smp_atomic32_read_dirty(&psi->active_fd.no);
+    int size = psi->active_fd.size;
     int ix = six;
 #if ERTS_CIO_DEFER_ACTIVE_EVENTS
     /* every fd might add two entries */
@@ -763,7 +797,7 @@ check_cleanup_active_fds(erts_aint_t current_cio_time)
 #endif
 
     while (ix != eix) {
-	ErtsSysFdType fd = pollset.active_fd.array[ix];
+	ErtsSysFdType fd = psi->active_fd.array[ix];
 	int nix = ix + 1;
 	if (nix >= size)
 	    nix = 0;
@@ -777,14 +811,14 @@ check_cleanup_active_fds(erts_aint_t current_cio_time)
 	    no--;
 	    if (ix == six) {
 #ifdef DEBUG
-		pollset.active_fd.array[ix] = ERTS_SYS_FD_INVALID;
+		psi->active_fd.array[ix] = ERTS_SYS_FD_INVALID;
 #endif
 		six = nix;
 	    }
 	    else {
-		pollset.active_fd.array[ix] = pollset.active_fd.array[six];
+		psi->active_fd.array[ix] = psi->active_fd.array[six];
 #ifdef DEBUG
-		pollset.active_fd.array[six] = ERTS_SYS_FD_INVALID;
+		psi->active_fd.array[six] = ERTS_SYS_FD_INVALID;
 #endif
 		six++;
 		if (six >= size)
@@ -797,51 +831,51 @@ check_cleanup_active_fds(erts_aint_t current_cio_time)
 #if ERTS_CIO_DEFER_ACTIVE_EVENTS
     ASSERT(pctrl_ix <= pce_sz/sizeof(ErtsPollControlEntry));
     if (pctrl_ix)
-	ERTS_CIO_POLL_CTLV(pollset.ps, pctrl_entries, pctrl_ix);
+	ERTS_CIO_POLL_CTLV(psi->ps, pctrl_entries, pctrl_ix);
     if (pctrl_entries)
 	erts_free(ERTS_ALC_T_TMP, pctrl_entries);
 #endif
 
-    pollset.active_fd.six = six;
-    pollset.active_fd.eix = eix;
-    erts_smp_atomic32_set_relb(&pollset.active_fd.no, no);
+    psi->active_fd.six = six;
+    psi->active_fd.eix = eix;
+    erts_smp_atomic32_set_relb(&psi->active_fd.no, no);
 }
 
 static ERTS_INLINE void
-add_active_fd(ErtsSysFdType fd)
+add_active_fd(struct pollset_info *psi, ErtsSysFdType fd)
 {
-    int eix = pollset.active_fd.eix;
-    int size = pollset.active_fd.size;
+    int eix = psi->active_fd.eix;
+    int size = psi->active_fd.size;
     
 
-    pollset.active_fd.array[eix] = fd;
+    psi->active_fd.array[eix] = fd;
 
-    erts_smp_atomic32_set_relb(&pollset.active_fd.no,
-			       (erts_smp_atomic32_read_dirty(&pollset.active_fd.no)
+    erts_smp_atomic32_set_relb(&psi->active_fd.no,
+			       (erts_smp_atomic32_read_dirty(&psi->active_fd.no)
 				+ 1));
 
     eix++;
     if (eix >= size)
 	eix = 0;
-    if (pollset.active_fd.six == eix) {
-	pollset.active_fd.six = 0;
+    if (psi->active_fd.six == eix) {
+	psi->active_fd.six = 0;
 	eix = size;
 	size += ERTS_ACTIVE_FD_INC;
-	pollset.active_fd.array = erts_realloc(ERTS_ALC_T_ACTIVE_FD_ARR,
-					       pollset.active_fd.array,
+	psi->active_fd.array = erts_realloc(ERTS_ALC_T_ACTIVE_FD_ARR,
+					       psi->active_fd.array,
 					       sizeof(ErtsSysFdType)*size);
-	pollset.active_fd.size = size;
+	psi->active_fd.size = size;
 #ifdef DEBUG
 	{
 	    int i;
 	    for (i = eix + 1; i < size; i++)
-		pollset.active_fd.array[i] = ERTS_SYS_FD_INVALID;
+		psi->active_fd.array[i] = ERTS_SYS_FD_INVALID;
 	}
 #endif
 
     }
 
-    pollset.active_fd.eix = eix;
+    psi->active_fd.eix = eix;
 }
 
 int
@@ -857,6 +891,7 @@ ERTS_CIO_EXPORT(driver_select)(ErlDrvPort ix,
     ErtsPollEvents ctl_events = (ErtsPollEvents) 0;
     ErtsPollEvents new_events, old_events;
     ErtsDrvEventState *state;
+    struct pollset_info *psi;
     int wake_poller;
     int ret;
 #if ERTS_CIO_HAVE_DRV_EVENT
@@ -885,6 +920,8 @@ ERTS_CIO_EXPORT(driver_select)(ErlDrvPort ix,
     }
 #endif
 
+    psi = fd_pollset(fd);
+
     erts_smp_mtx_lock(fd_mtx(fd));
 
 #ifdef ERTS_SYS_CONTINOUS_FD_NUMBERS
@@ -959,7 +996,7 @@ ERTS_CIO_EXPORT(driver_select)(ErlDrvPort ix,
 	wake_poller = 1;
     }
 
-    new_events = ERTS_CIO_POLL_CTL(pollset.ps, state->fd, ctl_events, on, &wake_poller);
+    new_events = ERTS_CIO_POLL_CTL(psi->ps, state->fd, ctl_events, on, &wake_poller);
 
     if (new_events & (ERTS_POLL_EV_ERR|ERTS_POLL_EV_NVAL)) {
 	if (state->type == ERTS_EV_TYPE_DRV_SEL && !state->events) {
@@ -985,7 +1022,7 @@ ERTS_CIO_EXPORT(driver_select)(ErlDrvPort ix,
     if (ctl_events) {
 	if (on) {
 	    if (!state->driver.select)
-		state->driver.select = alloc_drv_select_data();
+		state->driver.select = alloc_drv_select_data(psi);
 	    if (state->type == ERTS_EV_TYPE_NONE)
 		state->type = ERTS_EV_TYPE_DRV_SEL;
 	    ASSERT(state->type == ERTS_EV_TYPE_DRV_SEL);
@@ -1009,7 +1046,7 @@ ERTS_CIO_EXPORT(driver_select)(ErlDrvPort ix,
 		}
 		if (new_events == 0) {
 		    if (old_events != 0) {
-			remember_removed(state, &pollset);
+			remember_removed(state, psi);
 		    }		    
 		    if ((mode & ERL_DRV_USE) || !(state->flags & ERTS_EV_FLAG_USED)) {
 			state->type = ERTS_EV_TYPE_NONE;
@@ -1084,6 +1121,7 @@ ERTS_CIO_EXPORT(driver_event)(ErlDrvPort ix,
     ErtsPollEvents remove_events;
     Eterm id = erts_drvport2id(ix);
     ErtsDrvEventState *state;
+    struct pollset_info *psi;
     int do_wake = 0;
     int ret;
 #if ERTS_CIO_HAVE_DRV_EVENT
@@ -1109,6 +1147,8 @@ ERTS_CIO_EXPORT(driver_event)(ErlDrvPort ix,
     }
 #endif
 
+    psi = fd_pollset(fd);
+
     erts_smp_mtx_lock(fd_mtx(fd));
 
 #ifdef ERTS_SYS_CONTINOUS_FD_NUMBERS
@@ -1151,14 +1191,14 @@ ERTS_CIO_EXPORT(driver_event)(ErlDrvPort ix,
     }
 
     if (add_events) {
-	events = ERTS_CIO_POLL_CTL(pollset.ps, state->fd, add_events, 1, &do_wake);
+	events = ERTS_CIO_POLL_CTL(psi->ps, state->fd, add_events, 1, &do_wake);
 	if (events & (ERTS_POLL_EV_ERR|ERTS_POLL_EV_NVAL)) {
 	    ret = -1;
 	    goto done;
 	}
     }
     if (remove_events) {
-	events = ERTS_CIO_POLL_CTL(pollset.ps, state->fd, remove_events, 0, &do_wake);
+	events = ERTS_CIO_POLL_CTL(psi->ps, state->fd, remove_events, 0, &do_wake);
 	if (events & (ERTS_POLL_EV_ERR|ERTS_POLL_EV_NVAL)) {
 	    ret = -1;
 	    goto done;
@@ -1171,7 +1211,7 @@ ERTS_CIO_EXPORT(driver_event)(ErlDrvPort ix,
 	}
 	else {
 	    if (!state->driver.event)
-		state->driver.event = alloc_drv_event_data();
+		state->driver.event = alloc_drv_event_data(psi);
 	    state->driver.event->port = id;
 	    state->driver.event->removed_events = (ErtsPollEvents) 0;
 	    state->type = ERTS_EV_TYPE_DRV_EV;
@@ -1186,7 +1226,7 @@ ERTS_CIO_EXPORT(driver_event)(ErlDrvPort ix,
 	    state->driver.event->removed_events = (ErtsPollEvents) 0;
 	}
 	state->type = ERTS_EV_TYPE_NONE;
-	remember_removed(state, &pollset);
+	remember_removed(state, psi);
     }
     state->events = events;
     ASSERT(event_data ? events == event_data->events : events == 0); 
@@ -1517,60 +1557,93 @@ io_task_schedule_allowed(ErtsDrvEventState *state,
     return !is_iotask_active(io_task, current_cio_time);
 }
 
+/*
+ * Poll threads keep track of the I/O tasks they have scheduled and do
+ * not poll again until all of them have been executed or aborted;
+ * otherwise a level triggered fd would be reported over and over
+ * again while its task is waiting in a run queue. Schedulers get the
+ * same behaviour from erts_port_task_have_outstanding_io_tasks().
+ */
+static ERTS_INLINE void
+inc_outstanding_io_tasks(struct pollset_info *psi)
+{
+#ifdef ERTS_SMP
+    if (psi->tasks.event)
+	erts_smp_atomic32_inc_nob(&psi->tasks.outstanding_io_tasks);
+#endif
+}
+
 static ERTS_INLINE void
-iready(Eterm id, ErtsDrvEventState *state, erts_aint_t current_cio_time)
+dec_outstanding_io_tasks(struct pollset_info *psi)
+{
+#ifdef ERTS_SMP
+    if (psi->tasks.event)
+	erts_smp_atomic32_dec_nob(&psi->tasks.outstanding_io_tasks);
+#endif
+}
+
+static ERTS_INLINE void
+iready(struct pollset_info *psi, Eterm id, ErtsDrvEventState *state,
+       erts_aint_t current_cio_time)
 {
     if (io_task_schedule_allowed(state,
 				 ERTS_PORT_TASK_INPUT,
 				 current_cio_time)) {
 	ErtsIoTask *iotask = &state->driver.select->iniotask;
 	erts_smp_atomic_set_nob(&iotask->executed_time, current_cio_time);
+	inc_outstanding_io_tasks(psi);
 	if (erts_port_task_schedule(id,
 				    &iotask->task,
 				    ERTS_PORT_TASK_INPUT,
 				    (ErlDrvEvent) state->fd) != 0) {
+	    dec_outstanding_io_tasks(psi);
 	    stale_drv_select(id, state, ERL_DRV_READ);
 	}
-	add_active_fd(state->fd);
+	add_active_fd(psi, state->fd);
     }
 }
 
 static ERTS_INLINE void
-oready(Eterm id, ErtsDrvEventState *state, erts_aint_t current_cio_time)
+oready(struct pollset_info *psi, Eterm id, ErtsDrvEventState *state,
+       erts_aint_t current_cio_time)
 {
     if (io_task_schedule_allowed(state,
 				 ERTS_PORT_TASK_OUTPUT,
 				 current_cio_time)) {
 	ErtsIoTask *iotask = &state->driver.select->outiotask;
 	erts_smp_atomic_set_nob(&iotask->executed_time, current_cio_time);
+	inc_outstanding_io_tasks(psi);
 	if (erts_port_task_schedule(id,
 				    &iotask->task,
 				    ERTS_PORT_TASK_OUTPUT,
 				    (ErlDrvEvent) state->fd) != 0) {
+	    dec_outstanding_io_tasks(psi);
 	    stale_drv_select(id, state, ERL_DRV_WRITE);
 	}
-	add_active_fd(state->fd);
+	add_active_fd(psi, state->fd);
     }
 }
 
 #if ERTS_CIO_HAVE_DRV_EVENT
 static ERTS_INLINE void
-eready(Eterm id, ErtsDrvEventState *state, ErlDrvEventData event_data,
-       erts_aint_t current_cio_time)
+eready(struct pollset_info *psi, Eterm id, ErtsDrvEventState *state,
+       ErlDrvEventData event_data, erts_aint_t current_cio_time)
 {
     if (io_task_schedule_allowed(state,
 				 ERTS_PORT_TASK_EVENT,
 				 current_cio_time)) {
 	ErtsIoTask *iotask = &state->driver.event->iotask;
 	erts_smp_atomic_set_nob(&iotask->executed_time, current_cio_time);
+	inc_outstanding_io_tasks(psi);
 	if (erts_port_task_schedule(id,
 				    &iotask->task,
 				    ERTS_PORT_TASK_EVENT,
 				    (ErlDrvEvent) state->fd,
 				    event_data) != 0) {
+	    dec_outstanding_io_tasks(psi);
 	    stale_drv_select(id, state, 0);
 	}
-	add_active_fd(state->fd);
+	add_active_fd(psi, state->fd);
     }
 }
 #endif
@@ -1581,85 +1654,88 @@ static void bad_fd_in_pollset( ErtsDrvEventState *, Eterm, Eterm, ErtsPollEvents
 void
 ERTS_CIO_EXPORT(erts_check_io_async_sig_interrupt)(void)
 {
-    ERTS_CIO_POLL_AS_INTR(pollset.ps);
+    ERTS_CIO_POLL_AS_INTR(SCHED_POLLSET->ps);
 }
 #endif
 
 void
 ERTS_CIO_EXPORT(erts_check_io_interrupt)(int set)
 {
-    ERTS_CIO_POLL_INTR(pollset.ps, set);
+    ERTS_CIO_POLL_INTR(SCHED_POLLSET->ps, set);
 }
 
 void
 ERTS_CIO_EXPORT(erts_check_io_interrupt_timed)(int set,
 					       ErtsMonotonicTime timeout_time)
 {
-    ERTS_CIO_POLL_INTR_TMD(pollset.ps, set, timeout_time);
+    ERTS_CIO_POLL_INTR_TMD(SCHED_POLLSET->ps, set, timeout_time);
 }
 
-void
-ERTS_CIO_EXPORT(erts_check_io)(int do_wait)
+/*
+ * Poll one pollset and schedule I/O tasks for the fds that are ready.
+ * Returns EAGAIN if the caller should poll again immediately. When
+ * called from a poll thread, the thread is inactive with respect to
+ * thread progress while it is blocked in erts_poll_wait().
+ */
+static int
+check_io_pollset(struct pollset_info *psi,
+		 ErtsMonotonicTime timeout_time,
+		 int poll_thread)
 {
     ErtsPollResFd *pollres;
     int pollres_len;
-    ErtsMonotonicTime timeout_time;
     int poll_ret, i;
     erts_aint_t current_cio_time;
-    ErtsSchedulerData *esdp = erts_get_scheduler_data();
-
-    ASSERT(esdp);
-
- restart:
-
-#ifdef ERTS_BREAK_REQUESTED
-    if (ERTS_BREAK_REQUESTED)
-	erts_do_break_handling();
-#endif
-
-    /* Figure out timeout value */
-    timeout_time = (do_wait
-		    ? erts_check_next_timeout_time(esdp)
-		    : ERTS_POLL_NO_TIMEOUT /* poll only */);
 
     /*
      * No need for an atomic inc op when incrementing
-     * erts_check_io_time, since only one thread can
-     * check io at a time.
+     * check_io_time, since only one thread can
+     * check io on a pollset at a time.
      */
-    current_cio_time = erts_smp_atomic_read_dirty(&erts_check_io_time);
+    current_cio_time = erts_smp_atomic_read_dirty(&psi->tasks.check_io_time);
     current_cio_time++;
-    erts_smp_atomic_set_relb(&erts_check_io_time, current_cio_time);
+    erts_smp_atomic_set_relb(&psi->tasks.check_io_time, current_cio_time);
 
-    check_cleanup_active_fds(current_cio_time);
+    check_cleanup_active_fds(psi, current_cio_time);
 
 #ifdef ERTS_ENABLE_LOCK_CHECK
     erts_lc_check_exact(NULL, 0); /* No locks should be locked */
 #endif
 
-    pollres_len = erts_smp_atomic32_read_dirty(&pollset.active_fd.no) + ERTS_CHECK_IO_POLL_RES_LEN;
+    pollres_len = erts_smp_atomic32_read_dirty(&psi->active_fd.no) + ERTS_CHECK_IO_POLL_RES_LEN;
 
     pollres = erts_alloc(ERTS_ALC_T_TMP, sizeof(ErtsPollResFd)*pollres_len);
 
-    erts_smp_atomic_set_nob(&pollset.in_poll_wait, 1);
+    erts_smp_atomic_set_nob(&psi->in_poll_wait, 1);
 
-    poll_ret = ERTS_CIO_POLL_WAIT(pollset.ps, pollres, &pollres_len, timeout_time);
+#ifdef ERTS_SMP
+    /* erts_poll_wait() handles prepare/finalize wait itself */
+    if (poll_thread)
+	erts_thr_progress_active(NULL, 0);
+#endif
+
+    poll_ret = ERTS_CIO_POLL_WAIT(psi->ps, pollres, &pollres_len, timeout_time);
+
+#ifdef ERTS_SMP
+    if (poll_thread)
+	erts_thr_progress_active(NULL, 1);
+#endif
 
 #ifdef ERTS_ENABLE_LOCK_CHECK
     erts_lc_check_exact(NULL, 0); /* No locks should be locked */
 #endif
 
 #ifdef ERTS_BREAK_REQUESTED
-    if (ERTS_BREAK_REQUESTED)
+    if (!poll_thread && ERTS_BREAK_REQUESTED)
 	erts_do_break_handling();
 #endif
 
     if (poll_ret != 0) {
-	erts_smp_atomic_set_nob(&pollset.in_poll_wait, 0);
-	forget_removed(&pollset);
+	erts_smp_atomic_set_nob(&psi->in_poll_wait, 0);
+	forget_removed(psi);
 	erts_free(ERTS_ALC_T_TMP, pollres);
 	if (poll_ret == EAGAIN) {
-	    goto restart;
+	    return EAGAIN;
 	}
 
 	if (poll_ret != ETIMEDOUT
@@ -1673,7 +1749,7 @@ ERTS_CIO_EXPORT(erts_check_io)(int do_wait)
 			  erl_errno_id(poll_ret), poll_ret);
 	    erts_send_error_to_logger_nogl(dsbufp);
 	}
-	return;
+	return poll_ret;
     }
 
     for (i = 0; i < pollres_len; i++) {
@@ -1717,15 +1793,15 @@ ERTS_CIO_EXPORT(erts_check_io)(int do_wait)
 		if ((revents & ERTS_POLL_EV_IN)
 		    || (!(revents & ERTS_POLL_EV_OUT)
 			&& state->events & ERTS_POLL_EV_IN)) {
-		    iready(state->driver.select->inport, state, current_cio_time);
+		    iready(psi, state->driver.select->inport, state, current_cio_time);
 		}
 		else if (state->events & ERTS_POLL_EV_OUT) {
-		    oready(state->driver.select->outport, state, current_cio_time);
+		    oready(psi, state->driver.select->outport, state, current_cio_time);
 		}
 	    }
 	    else if (revents & (ERTS_POLL_EV_IN|ERTS_POLL_EV_OUT)) {
 		if (revents & ERTS_POLL_EV_OUT) {
-		    oready(state->driver.select->outport, state, current_cio_time);
+		    oready(psi, state->driver.select->outport, state, current_cio_time);
 		}
 		/* Someone might have deselected input since revents
 		   was read (true also on the non-smp emulator since
@@ -1733,7 +1809,7 @@ ERTS_CIO_EXPORT(erts_check_io)(int do_wait)
 		   revents... */
 		revents &= ~(~state->events & ERTS_POLL_EV_IN);
 		if (revents & ERTS_POLL_EV_IN) {
-		    iready(state->driver.select->inport, state, current_cio_time);
+		    iready(psi, state->driver.select->inport, state, current_cio_time);
 		}
 	    }
 	    else if (revents & ERTS_POLL_EV_NVAL) {
@@ -1741,7 +1817,7 @@ ERTS_CIO_EXPORT(erts_check_io)(int do_wait)
 				  state->driver.select->inport,
 				  state->driver.select->outport,
 				  state->events);
-		add_active_fd(state->fd);
+		add_active_fd(psi, state->fd);
 	    }
 	    break;
 	}
@@ -1759,7 +1835,7 @@ ERTS_CIO_EXPORT(erts_check_io)(int do_wait)
 	    if (revents) {
 		event_data->events = state->events;
 		event_data->revents = revents;
-		eready(state->driver.event->port, state, event_data, current_cio_time);
+		eready(psi, state->driver.event->port, state, event_data, current_cio_time);
 	    }
 	    break;
 	}
@@ -1777,7 +1853,7 @@ ERTS_CIO_EXPORT(erts_check_io)(int do_wait)
 			  (int) state->type);
 	    ASSERT(0);
 	    deselect(state, 0);
-	    add_active_fd(state->fd);
+	    add_active_fd(psi, state->fd);
 	    break;
 	}
 	}
@@ -1788,11 +1864,140 @@ ERTS_CIO_EXPORT(erts_check_io)(int do_wait)
 #endif
     }
 
-    erts_smp_atomic_set_nob(&pollset.in_poll_wait, 0);
+    erts_smp_atomic_set_nob(&psi->in_poll_wait, 0);
     erts_free(ERTS_ALC_T_TMP, pollres);
-    forget_removed(&pollset);
+    forget_removed(psi);
+    return 0;
+}
+
+void
+ERTS_CIO_EXPORT(erts_check_io)(int do_wait)
+{
+    ErtsMonotonicTime timeout_time;
+    ErtsSchedulerData *esdp = erts_get_scheduler_data();
+
+    ASSERT(esdp);
+
+    do {
+#ifdef ERTS_BREAK_REQUESTED
+	if (ERTS_BREAK_REQUESTED)
+	    erts_do_break_handling();
+#endif
+
+	/* Figure out timeout value */
+	timeout_time = (do_wait
+			? erts_check_next_timeout_time(esdp)
+			: ERTS_POLL_NO_TIMEOUT /* poll only */);
+
+    } while (check_io_pollset(SCHED_POLLSET, timeout_time, 0) == EAGAIN);
 }
 
+#ifdef ERTS_SMP
+
+/*
+ * Poll threads have nothing to do but poll, so the timeout is only
+ * there to keep the timeout value within range of every erts_poll
+ * implementation.
+ */
+#define ERTS_POLL_THREAD_TIMEOUT ERTS_SEC_TO_MONOTONIC(60*60)
+
+static void
+poll_thread_wakeup(void *vpsi)
+{
+    struct pollset_info *psi = (struct pollset_info *) vpsi;
+    erts_tse_set(psi->tasks.event);
+    ERTS_CIO_POLL_INTR(psi->ps, 1);
+}
+
+static void
+poll_thread_prep_wait(void *vpsi)
+{
+    struct pollset_info *psi = (struct pollset_info *) vpsi;
+    erts_tse_reset(psi->tasks.event);
+}
+
+static void
+poll_thread_wait(void *vpsi)
+{
+    struct pollset_info *psi = (struct pollset_info *) vpsi;
+    int res;
+    do {
+	res = erts_tse_wait(psi->tasks.event);
+    } while (res == EINTR);
+}
+
+static void
+poll_thread_fin_wait(void *vpsi)
+{
+
+}
+
+static void
+wait_outstanding_io_tasks(struct pollset_info *psi)
+{
+    while (1) {
+	int res;
+	erts_tse_reset(psi->tasks.event);
+	if (erts_smp_atomic32_read_acqb(&psi->tasks.outstanding_io_tasks) == 0)
+	    break;
+	erts_thr_progress_active(NULL, 0);
+	erts_thr_progress_prepare_wait(NULL);
+	do {
+	    res = erts_tse_wait(psi->tasks.event);
+	} while (res == EINTR);
+	erts_thr_progress_finalize_wait(NULL);
+	erts_thr_progress_active(NULL, 1);
+    }
+}
+
+static void *
+poll_thread(void *vpsi)
+{
+    struct pollset_info *psi = (struct pollset_info *) vpsi;
+    ErtsThrPrgrCallbacks callbacks;
+
+#ifdef ERTS_ENABLE_LOCK_CHECK
+    {
+	char buf[] = "poll_thread";
+	erts_lc_set_thread_name(buf);
+    }
+#endif
+
+    /*
+     * Only this thread schedules I/O tasks for its pollset, so no task
+     * can be counted as outstanding before the event has been set.
+     */
+    psi->tasks.event = erts_tse_fetch();
+
+    callbacks.arg = vpsi;
+    callbacks.wakeup = poll_thread_wakeup;
+    callbacks.prepare_wait = poll_thread_prep_wait;
+    callbacks.wait = poll_thread_wait;
+    callbacks.finalize_wait = poll_thread_fin_wait;
+
+    erts_thr_progress_register_managed_thread(NULL, &callbacks, 0);
+
+    while (1) {
+	ErtsMonotonicTime timeout_time;
+
+	wait_outstanding_io_tasks(psi);
+
+	/* Clear any earlier wakeup before blocking in the poll again */
+	ERTS_CIO_POLL_INTR(psi->ps, 0);
+
+	timeout_time = (erts_get_monotonic_time(NULL)
+			+ ERTS_POLL_THREAD_TIMEOUT);
+	(void) check_io_pollset(psi, timeout_time, 1);
+
+	if (erts_thr_progress_update(NULL))
+	    erts_thr_progress_leader_update(NULL);
+    }
+
+    return NULL;
+}
+
+#endif /* ERTS_SMP */
+
 static void
 bad_fd_in_pollset(ErtsDrvEventState *state, Eterm inport, 
 		  Eterm outport, ErtsPollEvents events)
@@ -1902,44 +2107,64 @@ static void drv_ev_state_free(void *des)
 }
 #endif
 
-void
-ERTS_CIO_EXPORT(erts_init_check_io)(void)
+static void
+init_pollset_info(struct pollset_info *psi)
 {
-    erts_smp_atomic_init_nob(&erts_check_io_time, 0);
-    erts_smp_atomic_init_nob(&pollset.in_poll_wait, 0);
+    erts_smp_atomic_init_nob(&psi->tasks.check_io_time, 0);
+#ifdef ERTS_SMP
+    erts_smp_atomic32_init_nob(&psi->tasks.outstanding_io_tasks, 0);
+    psi->tasks.event = NULL;
+#endif
+    erts_smp_atomic_init_nob(&psi->in_poll_wait, 0);
 
-    ERTS_CIO_POLL_INIT();
-    pollset.ps = ERTS_CIO_NEW_POLLSET();
-
-    pollset.active_fd.six = 0;
-    pollset.active_fd.eix = 0;
-    erts_smp_atomic32_init_nob(&pollset.active_fd.no, 0);
-    pollset.active_fd.size = ERTS_ACTIVE_FD_INC;
-    pollset.active_fd.array = erts_alloc(ERTS_ALC_T_ACTIVE_FD_ARR,
-					 sizeof(ErtsSysFdType)*ERTS_ACTIVE_FD_INC);
+    psi->ps = ERTS_CIO_NEW_POLLSET();
+
+    psi->active_fd.six = 0;
+    psi->active_fd.eix = 0;
+    erts_smp_atomic32_init_nob(&psi->active_fd.no, 0);
+    psi->active_fd.size = ERTS_ACTIVE_FD_INC;
+    psi->active_fd.array = erts_alloc(ERTS_ALC_T_ACTIVE_FD_ARR,
+				      sizeof(ErtsSysFdType)*ERTS_ACTIVE_FD_INC);
 #ifdef DEBUG
     {
 	int i;
 	for (i = 0; i < ERTS_ACTIVE_FD_INC; i++)
-	    pollset.active_fd.array[i] = ERTS_SYS_FD_INVALID;
+	    psi->active_fd.array[i] = ERTS_SYS_FD_INVALID;
     }
 #endif
 
+#ifdef ERTS_SMP
+    psi->removed_list = NULL;
+    erts_smp_spinlock_init(&psi->removed_list_lock,
+			   "pollset_rm_list");
+#endif
+}
+
+void
+ERTS_CIO_EXPORT(erts_init_check_io)(void)
+{
+    int i;
+
+    ERTS_CIO_POLL_INIT();
+
+#ifdef ERTS_SMP
+    no_pollsets = 1 + erts_no_poll_threads;
+#else
+    no_pollsets = 1;
+#endif
+    pollsets = erts_alloc_permanent_cache_aligned(
+	ERTS_ALC_T_POLLSET, sizeof(ErtsPollsetInfo)*no_pollsets);
+    for (i = 0; i < no_pollsets; i++)
+	init_pollset_info(&pollsets[i].psi);
 
 #ifdef ERTS_SMP
     init_removed_fd_alloc();
-    pollset.removed_list = NULL;
-    erts_smp_spinlock_init(&pollset.removed_list_lock,
-			   "pollset_rm_list");
-    {
-	int i;
-	for (i=0; i<DRV_EV_STATE_LOCK_CNT; i++) {
+    for (i=0; i<DRV_EV_STATE_LOCK_CNT; i++) {
 #ifdef ERTS_ENABLE_LOCK_COUNT
-	    erts_smp_mtx_init_x(&drv_ev_state_locks[i].lck, "drv_ev_state", make_small(i));
+	erts_smp_mtx_init_x(&drv_ev_state_locks[i].lck, "drv_ev_state", make_small(i));
 #else
-	    erts_smp_mtx_init(&drv_ev_state_locks[i].lck, "drv_ev_state");
+	erts_smp_mtx_init(&drv_ev_state_locks[i].lck, "drv_ev_state");
 #endif
-	}
     }
 #endif
 #ifdef ERTS_SYS_CONTINOUS_FD_NUMBERS
@@ -1962,6 +2187,19 @@ ERTS_CIO_EXPORT(erts_init_check_io)(void)
 		       DRV_EV_STATE_HTAB_SIZE, hf);
     }
 #endif
+
+#ifdef ERTS_SMP
+    for (i = 1; i < no_pollsets; i++) {
+	erts_smp_thr_opts_t thr_opts = ERTS_SMP_THR_OPTS_DEFAULT_INITER;
+	erts_smp_tid_t tid;
+	char name[16];
+	thr_opts.detached = 1;
+	thr_opts.name = name;
+	erts_snprintf(thr_opts.name, 16, "%d_poll_thread", i);
+	erts_smp_thr_create(&tid, poll_thread, (void *) &pollsets[i].psi,
+			    &thr_opts);
+    }
+#endif
 }
 
 int
@@ -1977,10 +2215,13 @@ ERTS_CIO_EXPORT(erts_check_io_max_files)(void)
 Uint
 ERTS_CIO_EXPORT(erts_check_io_size)(void)
 {
-    Uint res;
+    Uint res = 0;
     ErtsPollInfo pi;
-    ERTS_CIO_POLL_INFO(pollset.ps, &pi);
-    res = pi.memory_size;
+    int i;
+    for (i = 0; i < no_pollsets; i++) {
+	ERTS_CIO_POLL_INFO(pollsets[i].psi.ps, &pi);
+	res += pi.memory_size;
+    }
 #ifdef ERTS_SYS_CONTINOUS_FD_NUMBERS
     res += sizeof(ErtsDrvEventState) * erts_smp_atomic_read_nob(&drv_ev_state_len);
 #else
@@ -2001,28 +2242,47 @@ Eterm
 ERTS_CIO_EXPORT(erts_check_io_info)(void *proc)
 {
     Process *p = (Process *) proc;
-    Eterm tags[16], values[16], res;
+    Eterm tags[17], values[17], res;
     Uint sz, *szp, *hp, **hpp, memory_size;
     Sint i;
     ErtsPollInfo pi;
-    erts_aint_t cio_time = erts_smp_atomic_read_acqb(&erts_check_io_time);
-    int active_fds = (int) erts_smp_atomic32_read_acqb(&pollset.active_fd.no);
+    int active_fds = 0;
 
-    while (1) {
-	erts_aint_t post_cio_time;
-	int post_active_fds;
+    memory_size = 0;
+    for (i = 0; i < no_pollsets; i++) {
+	struct pollset_info *psi = &pollsets[i].psi;
+	ErtsPollInfo psi_pi, *pip = i == 0 ? &pi : &psi_pi;
+	erts_aint_t cio_time = erts_smp_atomic_read_acqb(&psi->tasks.check_io_time);
+	int psi_active_fds = (int) erts_smp_atomic32_read_acqb(&psi->active_fd.no);
 
-	ERTS_CIO_POLL_INFO(pollset.ps, &pi);
+	while (1) {
+	    erts_aint_t post_cio_time;
+	    int post_active_fds;
 
-	post_cio_time = erts_smp_atomic_read_mb(&erts_check_io_time);
-	post_active_fds = (int) erts_smp_atomic32_read_acqb(&pollset.active_fd.no);
-	if (cio_time == post_cio_time && active_fds == post_active_fds)
-	    break;
-	cio_time = post_cio_time;
-	active_fds = post_active_fds;
+	    ERTS_CIO_POLL_INFO(psi->ps, pip);
+
+	    post_cio_time = erts_smp_atomic_read_mb(&psi->tasks.check_io_time);
+	    post_active_fds = (int) erts_smp_atomic32_read_acqb(&psi->active_fd.no);
+	    if (cio_time == post_cio_time && psi_active_fds == post_active_fds)
+		break;
+	    cio_time = post_cio_time;
+	    psi_active_fds = post_active_fds;
+	}
+
+	active_fds += psi_active_fds;
+	memory_size += pip->memory_size;
+	if (i > 0) {
+	    pi.poll_set_size += psi_pi.poll_set_size;
+	    pi.fallback_poll_set_size += psi_pi.fallback_poll_set_size;
+	    pi.pending_updates += psi_pi.pending_updates;
+#ifdef ERTS_POLL_COUNT_AVOIDED_WAKEUPS
+	    pi.no_avoided_wakeups += psi_pi.no_avoided_wakeups;
+	    pi.no_avoided_interrupts += psi_pi.no_avoided_interrupts;
+	    pi.no_interrupt_timed += psi_pi.no_interrupt_timed;
+#endif
+	}
     }
 
-    memory_size = pi.memory_size;
 #ifdef ERTS_SYS_CONTINOUS_FD_NUMBERS
     memory_size += sizeof(ErtsDrvEventState) * erts_smp_atomic_read_nob(&drv_ev_state_len);
 #else
@@ -2085,6 +2345,9 @@ ERTS_CIO_EXPORT(erts_check_io_info)(void *proc)
     tags[i] = erts_bld_atom(hpp, szp, "max_fds");
     values[i++] = erts_bld_uint(hpp, szp, (Uint) pi.max_fds);
 
+    tags[i] = erts_bld_atom(hpp, szp, "poll_threads");
+    values[i++] = erts_bld_uint(hpp, szp, (Uint) (no_pollsets - 1));
+
     tags[i] = erts_bld_atom(hpp, szp, "active_fds");
     values[i++] = erts_bld_uint(hpp, szp, (Uint) active_fds);
 
@@ -2416,7 +2679,21 @@ ERTS_CIO_EXPORT(erts_check_io_debug)(ErtsCheckIoDebugInfo *ciodip)
 
 #ifdef ERTS_SYS_CONTINOUS_FD_NUMBERS
     counters.epep = erts_alloc(ERTS_ALC_T_TMP, sizeof(ErtsPollEvents)*max_fds);
-    ERTS_POLL_EXPORT(erts_poll_get_selected_events)(pollset.ps, counters.epep, max_fds);
+    ERTS_POLL_EXPORT(erts_poll_get_selected_events)(pollsets[0].psi.ps,
+						    counters.epep, max_fds);
+    if (no_pollsets > 1) {
+	/* Each fd is only in one pollset; merge what the others have */
+	ErtsPollEvents *epep = erts_alloc(ERTS_ALC_T_TMP,
+					  sizeof(ErtsPollEvents)*max_fds);
+	int i;
+	for (i = 1; i < no_pollsets; i++) {
+	    ERTS_POLL_EXPORT(erts_poll_get_selected_events)(pollsets[i].psi.ps,
+							    epep, max_fds);
+	    for (fd = 0; fd < max_fds; fd++)
+		counters.epep[fd] |= epep[fd];
+	}
+	erts_free(ERTS_ALC_T_TMP, epep);
+    }
     counters.internal_fds = 0;
 #endif
     counters.used_fds = 0;
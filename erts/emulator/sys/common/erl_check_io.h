@@ -72,23 +72,57 @@ void erts_init_check_io(void);
 
 #endif
 
-extern erts_smp_atomic_t erts_check_io_time;
+/*
+ * Per pollset information that I/O tasks refer to. check_io_time is
+ * incremented each time the pollset is polled. outstanding_io_tasks
+ * and event are only used by pollsets owned by a poll thread; the
+ * poll thread is woken when its last outstanding task is done.
+ */
+typedef struct {
+    erts_smp_atomic_t check_io_time;
+#ifdef ERTS_SMP
+    erts_smp_atomic32_t outstanding_io_tasks;
+    erts_tse_t *event;
+#endif
+} ErtsIoPollsetTasks;
 
 typedef struct {
     ErtsPortTaskHandle task;
     erts_smp_atomic_t executed_time;
+    ErtsIoPollsetTasks *pollset;
 } ErtsIoTask;
 
+ERTS_GLB_INLINE void erts_io_task_done__(ErtsIoTask *itp);
 ERTS_GLB_INLINE void erts_io_notify_port_task_executed(ErtsPortTaskHandle *pthp);
+ERTS_GLB_INLINE void erts_io_notify_port_task_aborted(ErtsPortTaskHandle *pthp);
 
 #if ERTS_GLB_INLINE_INCL_FUNC_DEF
 
+ERTS_GLB_INLINE void
+erts_io_task_done__(ErtsIoTask *itp)
+{
+#ifdef ERTS_SMP
+    ErtsIoPollsetTasks *ptp = itp->pollset;
+    if (ptp->event
+	&& erts_smp_atomic32_dec_read_relb(&ptp->outstanding_io_tasks) == 0)
+	erts_tse_set(ptp->event);
+#endif
+}
+
 ERTS_GLB_INLINE void
 erts_io_notify_port_task_executed(ErtsPortTaskHandle *pthp)
 {
     ErtsIoTask *itp = (ErtsIoTask *) (((char *) pthp) - offsetof(ErtsIoTask, task));
-    erts_aint_t ci_time = erts_smp_atomic_read_acqb(&erts_check_io_time);
+    erts_aint_t ci_time = erts_smp_atomic_read_acqb(&itp->pollset->check_io_time);
     erts_smp_atomic_set_relb(&itp->executed_time, ci_time);
+    erts_io_task_done__(itp);
+}
+
+ERTS_GLB_INLINE void
+erts_io_notify_port_task_aborted(ErtsPortTaskHandle *pthp)
+{
+    ErtsIoTask *itp = (ErtsIoTask *) (((char *) pthp) - offsetof(ErtsIoTask, task));
+    erts_io_task_done__(itp);
 }
 
 #endif
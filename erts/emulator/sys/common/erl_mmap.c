@@ -28,6 +28,13 @@
 #include "erl_mmap.h"
 #include <stddef.h>
 
+#if defined(__linux__) && HAVE_MMAP
+#  include <sys/syscall.h>
+#  if defined(SYS_mbind) && defined(SYS_get_mempolicy)
+#    define ERTS_HAVE_OS_NUMA_BIND 1
+#  endif
+#endif
+
 #if HAVE_ERTS_MMAP
 
 /* #define ERTS_MMAP_OP_RINGBUF_SZ 100 */
@@ -295,12 +302,18 @@ typedef struct {
     Uint nseg;
 }ErtsFreeSegMap;
 
+typedef struct {
+    erts_smp_atomic_t no;
+    erts_smp_atomic_t sz;
+} ErtsMMapNumaNode;
+
 struct ErtsMemMapper_ {
     int (*reserve_physical)(char *, UWord, int exec);
     void (*unreserve_physical)(char *, UWord);
     int supercarrier;
     int no_os_mmap;
     int executable;   /* is client a native code allocator? */
+    int huge_pages;   /* ERTS_MMAP_HP_* used by the super carrier */
     /*
      * Super unaligned area is located above super aligned
      * area. That is, `sa.bot` is beginning of the super
@@ -348,6 +361,8 @@ struct ErtsMemMapper_ {
 	    UWord used;
 	} os;
     } size;
+    /* Segments bound to NUMA nodes by erts_mmap_numa_bind() */
+    ErtsMMapNumaNode numa[ERTS_MMAP_MAX_NUMA_NODES];
 };
 
 ErtsMemMapper erts_dflt_mmapper;
@@ -1327,6 +1342,30 @@ os_mremap(void *ptr, UWord old_size, UWord new_size, int try_superalign)
 }
 #endif
 
+static ERTS_INLINE void
+os_advise_huge_pages(void *ptr, UWord size)
+{
+#if HAVE_MMAP && defined(MADV_HUGEPAGE)
+    /* Only advice; failure is not an error... */
+    (void) madvise(ptr, (size_t) size, MADV_HUGEPAGE);
+#endif
+}
+
+static void *
+os_mmap_huge_pages(UWord size, int executable)
+{
+#if HAVE_MMAP && defined(MAP_HUGETLB)
+    const int prot = executable ? ERTS_MMAP_PROT_EXEC : ERTS_MMAP_PROT;
+    void *res = mmap(NULL, size, prot,
+		     ERTS_MMAP_FLAGS|MAP_HUGETLB, ERTS_MMAP_FD, 0);
+    if (res == MAP_FAILED)
+	return NULL;
+    return res;
+#else
+    return NULL;
+#endif
+}
+
 #ifdef ERTS_HAVE_OS_PHYSICAL_MEMORY_RESERVATION
 #if HAVE_MMAP
 
@@ -1699,6 +1738,9 @@ erts_mmap(ErtsMemMapper* mm, Uint32 flags, UWord *sizep)
 	    }
 	}
 
+	if (mm->huge_pages != ERTS_MMAP_HP_NONE)
+	    os_advise_huge_pages(seg, asize);
+
 	ERTS_MMAP_OP_LCK(seg, *sizep, asize);
 	ERTS_MMAP_SIZE_OS_INC(asize);
 	*sizep = asize;
@@ -1726,6 +1768,16 @@ supercarrier_success:
     ERTS_MMAP_OP_END(seg, asize);
     erts_smp_mtx_unlock(&mm->mtx);
 
+#if ERTS_HAVE_OS_MMAP
+    /*
+     * Physical memory is reserved per segment, i.e., the advice
+     * given to the whole super carrier at creation is lost...
+     */
+    if (mm->huge_pages != ERTS_MMAP_HP_NONE
+	&& mm->reserve_physical != reserve_noop)
+	os_advise_huge_pages(seg, asize);
+#endif
+
     *sizep = asize;
     return (void *) seg;
 
@@ -2108,6 +2160,103 @@ int erts_mmap_in_supercarrier(ErtsMemMapper* mm, void *ptr)
     return ERTS_MMAP_IN_SUPERCARRIER(ptr);
 }
 
+#ifdef ERTS_HAVE_OS_NUMA_BIND
+
+#define ERTS_MPOL_DEFAULT	0
+#define ERTS_MPOL_PREFERRED	1
+#define ERTS_MPOL_F_ADDR	(1 << 1)
+#define ERTS_MPOL_MF_MOVE	(1 << 1)
+
+/* Need to be at least as large as the amount of nodes the kernel supports */
+#define ERTS_NUMA_MASK_BITS	1024
+#define ERTS_NUMA_MASK_WORDS	(ERTS_NUMA_MASK_BITS/(8*sizeof(unsigned long)))
+
+static int
+os_numa_bind(void *ptr, UWord size, int node, int move)
+{
+    unsigned long mask[ERTS_NUMA_MASK_WORDS];
+    int mode = ERTS_MPOL_DEFAULT;
+
+    sys_memzero((void *) mask, sizeof(mask));
+    if (node >= 0) {
+	mask[node / (8*sizeof(unsigned long))]
+	    = 1UL << (node % (8*sizeof(unsigned long)));
+	mode = ERTS_MPOL_PREFERRED;
+    }
+    return syscall(SYS_mbind, ptr, (unsigned long) size, mode,
+		   node >= 0 ? mask : NULL,
+		   (unsigned long) (node >= 0 ? ERTS_NUMA_MASK_BITS + 1 : 0),
+		   move ? ERTS_MPOL_MF_MOVE : 0) == 0;
+}
+
+static int
+os_numa_node(void *ptr)
+{
+    unsigned long mask[ERTS_NUMA_MASK_WORDS];
+    int mode, ix;
+
+    if (syscall(SYS_get_mempolicy, &mode, mask,
+		(unsigned long) ERTS_NUMA_MASK_BITS + 1,
+		ptr, (unsigned long) ERTS_MPOL_F_ADDR) != 0
+	|| mode != ERTS_MPOL_PREFERRED)
+	return -1;
+    for (ix = 0; ix < ERTS_MMAP_MAX_NUMA_NODES; ix++) {
+	if (mask[ix / (8*sizeof(unsigned long))]
+	    & (1UL << (ix % (8*sizeof(unsigned long)))))
+	    return ix;
+    }
+    return -1;
+}
+
+#endif
+
+/*
+ * Prefer physical memory of the segment to be allocated
+ * on NUMA node 'node'. If 'move' is set, pages already
+ * allocated elsewhere are moved there. Returns !0 if the
+ * segment was bound.
+ */
+int erts_mmap_numa_bind(ErtsMemMapper* mm, void *ptr, UWord size, int node,
+			int move)
+{
+#ifdef ERTS_HAVE_OS_NUMA_BIND
+    if (node < 0 || node >= ERTS_MMAP_MAX_NUMA_NODES)
+	return 0;
+    if (!os_numa_bind(ptr, size, node, move))
+	return 0;
+    erts_smp_atomic_inc_nob(&mm->numa[node].no);
+    erts_smp_atomic_add_nob(&mm->numa[node].sz, (erts_aint_t) size);
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Has to be called before a segment that might have been
+ * bound by erts_mmap_numa_bind() is unmapped or remapped,
+ * or kept unused for later reuse. Returns the node it was
+ * bound to, or -1 if not bound.
+ */
+int erts_mmap_numa_unbind(ErtsMemMapper* mm, void *ptr, UWord size)
+{
+#ifdef ERTS_HAVE_OS_NUMA_BIND
+    int node = os_numa_node(ptr);
+    if (node < 0)
+	return -1;
+    /*
+     * The policy would otherwise stick to the next segment placed
+     * here in the super carrier, or to a segment that is kept.
+     */
+    (void) os_numa_bind(ptr, size, -1, 0);
+    erts_smp_atomic_dec_nob(&mm->numa[node].no);
+    erts_smp_atomic_add_nob(&mm->numa[node].sz, -((erts_aint_t) size));
+    return node;
+#else
+    return -1;
+#endif
+}
+
 static struct {
     Eterm options;
     Eterm total;
@@ -2127,6 +2276,13 @@ static struct {
     Eterm sco;
     Eterm scrpm;
     Eterm scrfsd;
+    Eterm hp;
+    Eterm none;
+    Eterm transparent;
+    Eterm explicit;
+    Eterm numa_nodes;
+    Eterm carriers;
+    Eterm carriers_size;
 
     int is_initialized;
     erts_mtx_t init_mutex;
@@ -2161,6 +2317,13 @@ static void init_atoms(void)
         AM_INIT(sco);
         AM_INIT(scrpm);
         AM_INIT(scrfsd);
+        AM_INIT(hp);
+        AM_INIT(none);
+        AM_INIT(transparent);
+        AM_INIT(explicit);
+        AM_INIT(numa_nodes);
+        AM_INIT(carriers);
+        AM_INIT(carriers_size);
         am.is_initialized = 1;
     }
     erts_mtx_unlock(&am.init_mutex);
@@ -2176,6 +2339,8 @@ erts_mmap_init(ErtsMemMapper* mm, ErtsMMapInit *init, int executable)
 {
     static int is_first_call = 1;
     int virtual_map = 0;
+    int explicit_huge_pages = 0;
+    int i;
     char *start = NULL, *end = NULL;
     UWord pagesize;
 #if defined(__WIN32__)
@@ -2205,6 +2370,7 @@ erts_mmap_init(ErtsMemMapper* mm, ErtsMMapInit *init, int executable)
     mm->reserve_physical = reserve_noop;
     mm->unreserve_physical = unreserve_noop;
     mm->executable = executable;
+    mm->huge_pages = init->hp;
 
 #if HAVE_MMAP && !defined(MAP_ANON)
     mm->mmap_fd = open("/dev/zero", O_RDWR);
@@ -2261,7 +2427,16 @@ erts_mmap_init(ErtsMemMapper* mm, ErtsMMapInit *init, int executable)
 	     * The whole supercarrier will by physically
 	     * reserved all the time.
 	     */
-	    start = os_mmap(NULL, sz, 1, executable);
+	    start = NULL;
+	    if (mm->huge_pages == ERTS_MMAP_HP_EXPLICIT) {
+		start = os_mmap_huge_pages(sz, executable);
+		explicit_huge_pages = !!start;
+	    }
+	    if (!start) {
+		start = os_mmap(NULL, sz, 1, executable);
+		if (start && mm->huge_pages != ERTS_MMAP_HP_NONE)
+		    os_advise_huge_pages(start, sz);
+	    }
 	}
 	if (!start)
 	    erts_exit(1,
@@ -2289,6 +2464,11 @@ erts_mmap_init(ErtsMemMapper* mm, ErtsMMapInit *init, int executable)
     mm->size.supercarrier.used.sua = 0;
     mm->size.os.used = 0;
 
+    for (i = 0; i < ERTS_MMAP_MAX_NUMA_NODES; i++) {
+	erts_smp_atomic_init_nob(&mm->numa[i].no, 0);
+	erts_smp_atomic_init_nob(&mm->numa[i].sz, 0);
+    }
+
     mm->desc.new_area_hint = NULL;
 
     if (!start) {
@@ -2367,6 +2547,18 @@ erts_mmap_init(ErtsMemMapper* mm, ErtsMMapInit *init, int executable)
 
 #if !ERTS_HAVE_OS_MMAP
     mm->no_os_mmap = 1;
+    mm->huge_pages = ERTS_MMAP_HP_NONE;
+#else
+    /*
+     * Explicit huge pages can only back a physically reserved
+     * super carrier; other carriers use transparent huge pages.
+     */
+    if (mm->huge_pages == ERTS_MMAP_HP_EXPLICIT && !explicit_huge_pages)
+	mm->huge_pages = ERTS_MMAP_HP_TRANSPARENT;
+#  if !HAVE_MMAP || !defined(MADV_HUGEPAGE)
+    if (mm->huge_pages == ERTS_MMAP_HP_TRANSPARENT)
+	mm->huge_pages = ERTS_MMAP_HP_NONE;
+#  endif
 #endif
 
 #ifdef HARD_DEBUG_MSEG
@@ -2399,9 +2591,9 @@ Eterm erts_mmap_info(ErtsMemMapper* mm,
     Eterm seg_tags[] = { am.used, am.max, am.allocated, am.reserved, am.used_sa, am.used_sua };
     Eterm group[2];
     Eterm group_tags[] = { am.sizes, am.free_segs };
-    Eterm list[3];
-    Eterm list_tags[3]; /* { am.options, am.supercarrier, am.os } */
-    int lix = 0;
+    Eterm list[4];
+    Eterm list_tags[4]; /* { am.options, am.supercarrier, am.os, am.numa_nodes } */
+    int lix = 0, i;
     Eterm res = THE_NON_VALUE;
 
     if (!hpp) {
@@ -2422,6 +2614,11 @@ Eterm erts_mmap_info(ErtsMemMapper* mm,
 
         emis->os_used = mm->size.os.used;
         erts_smp_mtx_unlock(&mm->mtx);
+
+        for (i = 0; i < ERTS_MMAP_MAX_NUMA_NODES; i++) {
+            emis->numa_no[i] = (UWord) erts_smp_atomic_read_nob(&mm->numa[i].no);
+            emis->numa_sz[i] = (UWord) erts_smp_atomic_read_nob(&mm->numa[i].sz);
+        }
     }
 
     list[lix] = erts_mmap_info_options(mm, "option ", print_to_p, print_to_arg,
@@ -2451,6 +2648,14 @@ Eterm erts_mmap_info(ErtsMemMapper* mm,
         if (!mm->no_os_mmap) {
             erts_print(to, arg, "os mmap size used: %bpu\n", emis->os_used);
         }
+        for (i = 0; i < ERTS_MMAP_MAX_NUMA_NODES; i++) {
+            if (emis->numa_no[i]) {
+                erts_print(to, arg, "numa node %d carriers: %bpu\n",
+                           i, emis->numa_no[i]);
+                erts_print(to, arg, "numa node %d carriers size: %bpu\n",
+                           i, emis->numa_sz[i]);
+            }
+        }
     }
 
 
@@ -2478,6 +2683,26 @@ Eterm erts_mmap_info(ErtsMemMapper* mm,
             list_tags[lix] = am.os;
             lix++;
         }
+
+        group[0] = NIL;
+        for (i = ERTS_MMAP_MAX_NUMA_NODES - 1; i >= 0; i--) {
+            if (emis->numa_no[i]) {
+                Eterm tags[2];
+                UWord values[2];
+                tags[0] = am.carriers;
+                values[0] = emis->numa_no[i];
+                tags[1] = am.carriers_size;
+                values[1] = emis->numa_sz[i];
+                add_2tup(hpp, szp, &group[0], make_small(i),
+                         erts_bld_atom_uword_2tup_list(hpp, szp, 2,
+                                                       tags, values));
+            }
+        }
+        if (is_not_nil(group[0])) {
+            list[lix] = group[0];
+            list_tags[lix] = am.numa_nodes;
+            lix++;
+        }
         res = erts_bld_2tup_list(hpp, szp, lix, list_tags, list);
     }
     return res;
@@ -2493,6 +2718,7 @@ Eterm erts_mmap_info_options(ErtsMemMapper* mm,
     const UWord scs = mm->sua.top - mm->sa.bot;
     const Eterm sco = mm->no_os_mmap ? am_true : am_false;
     const Eterm scrpm = (mm->reserve_physical == reserve_noop) ? am_true : am_false;
+    static const char *hp_str[] = {"none", "transparent", "explicit"};
     Eterm res = THE_NON_VALUE;
 
     if (print_to_p) {
@@ -2504,14 +2730,24 @@ Eterm erts_mmap_info_options(ErtsMemMapper* mm,
             erts_print(to, arg, "%sscrpm: %T\n", prefix, scrpm);
             erts_print(to, arg, "%sscrfsd: %beu\n", prefix, mm->desc.reserved);
         }
+        erts_print(to, arg, "%shp: %s\n", prefix, hp_str[mm->huge_pages]);
     }
 
     if (hpp || szp) {
+        Eterm hp;
+
         if (!am.is_initialized) {
             init_atoms();
         }
 
+        switch (mm->huge_pages) {
+        case ERTS_MMAP_HP_TRANSPARENT: hp = am.transparent; break;
+        case ERTS_MMAP_HP_EXPLICIT: hp = am.explicit; break;
+        default: hp = am.none; break;
+        }
+
         res = NIL;
+        add_2tup(hpp, szp, &res, am.hp, hp);
         if (mm->supercarrier) {
             add_2tup(hpp, szp, &res, am.scrfsd,
                      erts_bld_uint(hpp,szp, mm->desc.reserved));
@@ -69,6 +69,11 @@
 
 extern UWord erts_page_inv_mask;
 
+/* Huge page modes */
+#define ERTS_MMAP_HP_NONE		0
+#define ERTS_MMAP_HP_TRANSPARENT	1
+#define ERTS_MMAP_HP_EXPLICIT		2
+
 typedef struct {
     struct {
 	char *start;
@@ -82,20 +87,23 @@ typedef struct {
     int sco;    /* super carrier only? */
     UWord scrfsd; /* super carrier reserved free segment descriptors */
     int scrpm; /* super carrier reserve physical memory */
+    int hp; /* huge pages */
 }ErtsMMapInit;
 
 #define ERTS_MMAP_INIT_DEFAULT_INITER \
-    {{NULL, NULL}, {NULL, NULL}, 0, 1, (1 << 16), 1}
+    {{NULL, NULL}, {NULL, NULL}, 0, 1, (1 << 16), 1, ERTS_MMAP_HP_NONE}
 
 #define ERTS_LITERAL_VIRTUAL_AREA_SIZE (UWORD_CONSTANT(1)*1024*1024*1024)
 
 #define ERTS_MMAP_INIT_LITERAL_INITER \
-    {{NULL, NULL}, {NULL, NULL}, ERTS_LITERAL_VIRTUAL_AREA_SIZE, 1, (1 << 10), 0}
+    {{NULL, NULL}, {NULL, NULL}, ERTS_LITERAL_VIRTUAL_AREA_SIZE, 1, (1 << 10), 0, \
+     ERTS_MMAP_HP_NONE}
 
 #define ERTS_HIPE_EXEC_VIRTUAL_AREA_SIZE (UWORD_CONSTANT(512)*1024*1024)
 
 #define ERTS_MMAP_INIT_HIPE_EXEC_INITER \
-    {{NULL, NULL}, {NULL, NULL}, ERTS_HIPE_EXEC_VIRTUAL_AREA_SIZE, 1, (1 << 10), 0}
+    {{NULL, NULL}, {NULL, NULL}, ERTS_HIPE_EXEC_VIRTUAL_AREA_SIZE, 1, (1 << 10), 0, \
+     ERTS_MMAP_HP_NONE}
 
 
 #define ERTS_SUPERALIGNED_SIZE \
@@ -139,12 +147,18 @@ void *erts_mmap(ErtsMemMapper*, Uint32 flags, UWord *sizep);
 void erts_munmap(ErtsMemMapper*, Uint32 flags, void *ptr, UWord size);
 void *erts_mremap(ErtsMemMapper*, Uint32 flags, void *ptr, UWord old_size, UWord *sizep);
 int erts_mmap_in_supercarrier(ErtsMemMapper*, void *ptr);
+int erts_mmap_numa_bind(ErtsMemMapper*, void *ptr, UWord size, int node,
+			int move);
+int erts_mmap_numa_unbind(ErtsMemMapper*, void *ptr, UWord size);
 void erts_mmap_init(ErtsMemMapper*, ErtsMMapInit*, int executable);
+#define ERTS_MMAP_MAX_NUMA_NODES 64
 struct erts_mmap_info_struct
 {
     UWord sizes[6];
     UWord segs[6];
     UWord os_used;
+    UWord numa_no[ERTS_MMAP_MAX_NUMA_NODES];
+    UWord numa_sz[ERTS_MMAP_MAX_NUMA_NODES];
 };
 Eterm erts_mmap_info(ErtsMemMapper*, int *print_to_p, void *print_to_arg,
                      Eterm** hpp, Uint* szp, struct erts_mmap_info_struct*);
@@ -131,6 +131,7 @@ typedef struct cache_t_ cache_t;
 struct cache_t_ {
     UWord size;
     void *seg;
+    int numa_node;		/* Node the pages were bound to, or -1 */
     cache_t *next;
     cache_t *prev;
 };
@@ -174,6 +175,7 @@ struct ErtsMsegAllctr_t_ {
     Uint max_cache_size;
     Uint abs_max_cache_bad_fit;
     Uint rel_max_cache_bad_fit;
+    int numa_bind;
 
     ErtsMsegCalls calls;
 };
@@ -281,6 +283,24 @@ schedule_cache_check(ErtsMsegAllctr_t *ma) {
 
 /* #define ERTS_PRINT_ERTS_MMAP */
 
+/*
+ * Bind a segment to the NUMA node of the scheduler if it is bound.
+ * 'old_node' is the node a segment taken from the cache was bound
+ * to; its pages are moved when that is another node.
+ */
+static ERTS_INLINE void
+mseg_numa_bind(ErtsMsegAllctr_t *ma, void *seg, UWord size, int old_node)
+{
+    ErtsSchedulerData *esdp;
+    if (!ma->numa_bind)
+	return;
+    esdp = erts_get_scheduler_data();
+    if (esdp && esdp->numa_node >= 0)
+	(void) erts_mmap_numa_bind(&erts_dflt_mmapper, seg, size,
+				   esdp->numa_node,
+				   old_node >= 0 && old_node != esdp->numa_node);
+}
+
 static ERTS_INLINE void *
 mseg_create(ErtsMsegAllctr_t *ma, Uint flags, UWord *sizep)
 {
@@ -294,6 +314,9 @@ mseg_create(ErtsMsegAllctr_t *ma, Uint flags, UWord *sizep)
 
     seg = erts_mmap(&erts_dflt_mmapper, mmap_flags, sizep);
 
+    if (seg)
+	mseg_numa_bind(ma, seg, *sizep, -1);
+
 #ifdef ERTS_PRINT_ERTS_MMAP
     erts_fprintf(stderr, "%p = erts_mmap(%s, {%bpu, %bpu});\n", seg,
 		 (mmap_flags & ERTS_MMAPFLG_SUPERALIGNED) ? "sa" : "sua",
@@ -312,6 +335,9 @@ mseg_destroy(ErtsMsegAllctr_t *ma, Uint flags, void *seg_p, UWord size) {
     if (MSEG_FLG_IS_2POW(flags))
 	 mmap_flags |= ERTS_MMAPFLG_SUPERALIGNED;
 
+    if (ma->numa_bind)
+	(void) erts_mmap_numa_unbind(&erts_dflt_mmapper, seg_p, size);
+
     erts_munmap(&erts_dflt_mmapper, mmap_flags, seg_p, size);
 #ifdef ERTS_PRINT_ERTS_MMAP
     erts_fprintf(stderr, "erts_munmap(%s, %p, %bpu);\n",
@@ -329,12 +355,26 @@ mseg_recreate(ErtsMsegAllctr_t *ma, Uint flags, void *old_seg, UWord old_size, U
     UWord req_size = *sizep;	
 #endif
     void *new_seg;
+    int numa_node = -1;
     Uint32 mmap_flags = 0;
     if (MSEG_FLG_IS_2POW(flags))
 	mmap_flags |= ERTS_MMAPFLG_SUPERALIGNED;
 
+    if (ma->numa_bind)
+	numa_node = erts_mmap_numa_unbind(&erts_dflt_mmapper, old_seg, old_size);
+
     new_seg = erts_mremap(&erts_dflt_mmapper, mmap_flags, old_seg, old_size, sizep);
 
+    if (numa_node >= 0) {
+	/* Keep the segment on the same node when moved or resized */
+	if (new_seg)
+	    (void) erts_mmap_numa_bind(&erts_dflt_mmapper, new_seg, *sizep,
+				       numa_node, 0);
+	else
+	    (void) erts_mmap_numa_bind(&erts_dflt_mmapper, old_seg, old_size,
+				       numa_node, 0);
+    }
+
 #ifdef ERTS_PRINT_ERTS_MMAP
     erts_fprintf(stderr, "%p = erts_mremap(%s, %p, %bpu, {%bpu, %bpu});\n",
 		 new_seg, (mmap_flags & ERTS_MMAPFLG_SUPERALIGNED) ? "sa" : "sua",
@@ -367,10 +407,24 @@ do {									\
 static ERTS_INLINE void mseg_cache_clear_node(cache_t *c) {
     c->seg = NULL;
     c->size = 0;
+    c->numa_node = -1;
     c->next = c;
     c->prev = c;
 }
 
+/*
+ * Cached segments are not counted as bound, and are bound again for
+ * the scheduler that takes them from the cache, which need not be on
+ * the node they were bound to.
+ */
+static ERTS_INLINE int
+mseg_cache_numa_unbind(ErtsMsegAllctr_t *ma, void *seg, UWord size)
+{
+    if (!ma->numa_bind)
+	return -1;
+    return erts_mmap_numa_unbind(&erts_dflt_mmapper, seg, size);
+}
+
 static ERTS_INLINE int cache_bless_segment(ErtsMsegAllctr_t *ma, void *seg, UWord size, Uint flags) {
 
     cache_t *c;
@@ -392,6 +446,7 @@ static ERTS_INLINE int cache_bless_segment(ErtsMsegAllctr_t *ma, void *seg, UWor
 
 	c->seg  = seg;
 	c->size = size;
+	c->numa_node = mseg_cache_numa_unbind(ma, seg, size);
 
 	if (MSEG_FLG_IS_2POW(flags)) {
 	    int ix = SIZE_TO_CACHE_AREA_IDX(size);
@@ -419,6 +474,7 @@ static ERTS_INLINE int cache_bless_segment(ErtsMsegAllctr_t *ma, void *seg, UWor
 
 	c->seg  = seg;
 	c->size = size;
+	c->numa_node = mseg_cache_numa_unbind(ma, seg, size);
 
 	erts_circleq_push_head(&(ma->cache_unpowered_node), c);
 
@@ -446,6 +502,7 @@ static ERTS_INLINE int cache_bless_segment(ErtsMsegAllctr_t *ma, void *seg, UWor
 
 	    c->seg  = seg;
 	    c->size = size;
+	    c->numa_node = mseg_cache_numa_unbind(ma, seg, size);
 
 	    erts_circleq_push_head(&(ma->cache_unpowered_node), c);
 
@@ -468,6 +525,7 @@ static ERTS_INLINE void *cache_get_segment(ErtsMsegAllctr_t *ma, UWord *size_p,
 	char *seg;
 	cache_t *c;
 	UWord csize;
+	int numa_node;
 
 	ASSERT(IS_2POW(size));
 
@@ -484,6 +542,7 @@ static ERTS_INLINE void *cache_get_segment(ErtsMsegAllctr_t *ma, UWord *size_p,
 
 	    csize = c->size;
 	    seg   = (char*) c->seg;
+	    numa_node = c->numa_node;
 
 	    ma->cache_size--;
 	    ma->cache_hits++;
@@ -497,6 +556,7 @@ static ERTS_INLINE void *cache_get_segment(ErtsMsegAllctr_t *ma, UWord *size_p,
 	    if (csize != size)
 		mseg_destroy(ma, ERTS_MSEG_FLG_2POW, seg + size, csize - size);
 
+	    mseg_numa_bind(ma, seg, size, numa_node);
 	    return seg;
 	}
     } 
@@ -506,6 +566,7 @@ static ERTS_INLINE void *cache_get_segment(ErtsMsegAllctr_t *ma, UWord *size_p,
 	cache_t *best = NULL;
 	UWord bdiff = 0;
 	UWord csize;
+	int numa_node;
 	UWord bad_max_abs = ma->abs_max_cache_bad_fit;
 	UWord bad_max_rel = ma->rel_max_cache_bad_fit;
 
@@ -515,6 +576,7 @@ static ERTS_INLINE void *cache_get_segment(ErtsMsegAllctr_t *ma, UWord *size_p,
 		if (((csize - size)*100 < bad_max_rel*size) && (csize - size) < bad_max_abs ) {
 
 		    seg = c->seg;
+		    numa_node = c->numa_node;
 
 		    erts_circleq_remove(c);
 
@@ -526,6 +588,7 @@ static ERTS_INLINE void *cache_get_segment(ErtsMsegAllctr_t *ma, UWord *size_p,
 
 		    *size_p = csize;
 
+		    mseg_numa_bind(ma, seg, csize, numa_node);
 		    return seg;
 
 		} else if (!best || (csize - size) < bdiff) {
@@ -557,6 +620,7 @@ static ERTS_INLINE void *cache_get_segment(ErtsMsegAllctr_t *ma, UWord *size_p,
 
 	    *size_p = size;
 
+	    mseg_numa_bind(ma, seg, size, best->numa_node);
 	    return seg;
 
 	}
@@ -852,6 +916,7 @@ static struct {
     Eterm amcbf;
     Eterm rmcbf;
     Eterm mcs;
+    Eterm nb;
 
     Eterm memkind;
     Eterm name;
@@ -908,6 +973,7 @@ init_atoms(ErtsMsegAllctr_t *ma)
 	AM_INIT(amcbf);
 	AM_INIT(rmcbf);
 	AM_INIT(mcs);
+	AM_INIT(nb);
 
 	AM_INIT(status);
 	AM_INIT(cached_segments);
@@ -1004,6 +1070,8 @@ info_options(ErtsMsegAllctr_t *ma,
 	erts_print(to, arg, "%samcbf: %beu\n", prefix, ma->abs_max_cache_bad_fit);
 	erts_print(to, arg, "%srmcbf: %beu\n", prefix, ma->rel_max_cache_bad_fit);
 	erts_print(to, arg, "%smcs: %beu\n", prefix, ma->max_cache_size);
+	erts_print(to, arg, "%snb: %s\n", prefix,
+		   ma->numa_bind ? "true" : "false");
     }
 
     if (hpp || szp) {
@@ -1011,6 +1079,9 @@ info_options(ErtsMsegAllctr_t *ma,
 	if (!atoms_initialized)
 	    init_atoms(ma);
 
+	add_2tup(hpp, szp, &res,
+		 am.nb,
+		 ma->numa_bind ? am_true : am_false);
 	add_2tup(hpp, szp, &res,
 		 am.mcs,
 		 bld_uint(hpp, szp, ma->max_cache_size));
@@ -1451,6 +1522,7 @@ erts_mseg_init(ErtsMsegInit_t *init)
 	ma->abs_max_cache_bad_fit = init->amcbf;
 	ma->rel_max_cache_bad_fit = init->rmcbf;
 	ma->max_cache_size = init->mcs;
+	ma->numa_bind = init->nb;
 
 	if (ma->max_cache_size > MAX_CACHE_SIZE)
 	    ma->max_cache_size = MAX_CACHE_SIZE;
@@ -59,6 +59,7 @@ typedef struct {
     Uint rmcbf;
     Uint mcs;
     Uint nos;
+    int nb;
     ErtsMMapInit dflt_mmap;
     ErtsMMapInit literal_mmap;
     ErtsMMapInit exec_mmap;
@@ -70,6 +71,7 @@ typedef struct {
     20,			/* rmcbf: Relative max cache bad fit	*/	\
     10,			/* mcs:   Max cache size		*/	\
     1000,		/* cci:   Cache check interval		*/	\
+    0,			/* nb:    NUMA bind			*/	\
     ERTS_MMAP_INIT_DEFAULT_INITER,					\
     ERTS_MMAP_INIT_LITERAL_INITER,                                      \
     ERTS_MMAP_INIT_HIPE_EXEC_INITER                                     \
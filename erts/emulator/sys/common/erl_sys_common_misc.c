@@ -46,12 +46,13 @@
 #endif
 
 /*
- * erts_check_io_time is used by the erl_check_io implementation. The
- * global erts_check_io_time variable is declared here since there
+ * erts_no_poll_threads is used by the erl_check_io implementation. The
+ * global erts_no_poll_threads variable is declared here since there
  * (often) exist two versions of erl_check_io (kernel-poll and
  * non-kernel-poll), and we dont want two versions of this variable.
+ * It is set by the +IOt emulator flag.
  */
-erts_smp_atomic_t erts_check_io_time;
+int erts_no_poll_threads = 0;
 
 /* Written once and only once */
 
@@ -30,6 +30,7 @@
 	 rbtree/1,
 	 mseg_clear_cache/1,
 	 erts_mmap/1,
+	 erts_mmap_hp_nb/1,
 	 cpool/1,
 	 migration/1]).
 
@@ -41,7 +42,8 @@ suite() ->
 
 all() -> 
     [basic, coalesce, threads, realloc_copy, bucket_index,
-     bucket_mask, rbtree, mseg_clear_cache, erts_mmap, cpool, migration].
+     bucket_mask, rbtree, mseg_clear_cache, erts_mmap, erts_mmap_hp_nb,
+     cpool, migration].
 
 init_per_testcase(Case, Config) when is_list(Config) ->
     [{testcase, Case},{debug,false}|Config].
@@ -143,6 +145,76 @@ erts_mmap_do(Config, SCO, SCRPM, SCRFSD) ->
     stop_node(Node),
     Result.
 
+%% Huge pages (+MMhp) and NUMA binding (+MMnb) of carriers
+erts_mmap_hp_nb(Config) when is_list(Config) ->
+    case {os:type(), mmsc_flags()} of
+	{{unix,_}, false} ->
+	    [erts_mmap_hp_nb_do(Config, HP, SCRPM)
+	     || HP <- [none, transparent, explicit], SCRPM <- [true,false]],
+	    ok;
+	{{unix,_}, Flags} ->
+	    {skipped, Flags};
+	{{SkipOs,_},_} ->
+	    {skipped,
+		   lists:flatten(["Not run on "
+				  | io_lib:format("~p",[SkipOs])])}
+    end.
+
+erts_mmap_hp_nb_do(Config, HP, SCRPM) ->
+    Opts = "+MMscs 100 +MMsco false +MMscrpm " ++ atom_to_list(SCRPM)
+	++ " +MMhp " ++ atom_to_list(HP) ++ " +MMnb true +sbt db",
+    {ok, Node} = start_node(Config, Opts),
+    Self = self(),
+    Ref = make_ref(),
+    F = fun() ->
+                SI = erlang:system_info({allocator,erts_mmap}),
+                {default_mmap,EM} = lists:keyfind(default_mmap, 1, SI),
+                {options,EMO} = lists:keyfind(options, 1, EM),
+                {hp,UsedHP} = lists:keyfind(hp, 1, EMO),
+                io:format("Requested ~w huge pages, got ~w~n", [HP, UsedHP]),
+                true = case HP of
+                           none -> UsedHP == none;
+                           transparent -> lists:member(UsedHP, [none,
+                                                                transparent]);
+                           explicit -> true
+                       end,
+                {_,_,_,AOpts} = erlang:system_info(allocator),
+                {mseg_alloc,MO} = lists:keyfind(mseg_alloc, 1, AOpts),
+                {nb,true} = lists:keyfind(nb, 1, MO),
+
+                %% Create some carriers on all schedulers...
+                Ps = [spawn_opt(fun () ->
+                                        L = lists:seq(1, 500000),
+                                        500000 = length(L),
+                                        receive {Self, done} -> ok end
+                                end,
+                                [{scheduler, S}, monitor])
+                      || S <- lists:seq(1, erlang:system_info(schedulers))],
+                SI2 = erlang:system_info({allocator,erts_mmap}),
+                {default_mmap,EM2} = lists:keyfind(default_mmap, 1, SI2),
+                case lists:keyfind(numa_nodes, 1, EM2) of
+                    false ->
+                        ok;
+                    {numa_nodes, NNs} ->
+                        io:format("NUMA nodes: ~p~n", [NNs]),
+                        lists:foreach(fun ({NN, NI}) when is_integer(NN) ->
+                                              {carriers, C} = lists:keyfind(carriers, 1, NI),
+                                              {carriers_size, CS} = lists:keyfind(carriers_size, 1, NI),
+                                              true = C > 0,
+                                              true = CS > 0
+                                      end, NNs)
+                end,
+                [P ! {Self, done} || {P, _} <- Ps],
+                [receive {'DOWN', M, process, P, normal} -> ok end
+                 || {P, M} <- Ps],
+                Self ! {Ref, ok}
+        end,
+
+    spawn_link(Node, F),
+    Result = receive {Ref, Rslt} -> Rslt end,
+    stop_node(Node),
+    Result.
+
 
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %%                                                                        %%
@@ -22,14 +22,16 @@
 
 -include_lib("common_test/include/ct.hrl").
 -include_lib("kernel/include/file.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
--export([all/0, suite/0,
+-export([all/0, suite/0, groups/0,
 	 display/1, display_huge/0,
 	 erl_bif_types/1,guard_bifs_in_erl_bif_types/1,
 	 shadow_comments/1,
 	 specs/1,improper_bif_stubs/1,auto_imports/1,
 	 t_list_to_existing_atom/1,os_env/1,otp_7526/1,
 	 binary_to_atom/1,binary_to_existing_atom/1,
+	 existing_atom_while_growing/1, existing_atom_bench/1,
 	 atom_to_binary/1,min_max/1, erlang_halt/1,
 	 is_builtin/1]).
 
@@ -43,8 +45,12 @@ all() ->
      t_list_to_existing_atom, os_env, otp_7526,
      display,
      atom_to_binary, binary_to_atom, binary_to_existing_atom,
+     existing_atom_while_growing,
      min_max, erlang_halt, is_builtin].
 
+groups() ->
+    [{atom_bench, [], [existing_atom_bench]}].
+
 %% Uses erlang:display to test that erts_printf does not do deep recursion
 display(Config) when is_list(Config) ->
     Pa = filename:dirname(code:which(?MODULE)),
@@ -532,6 +538,65 @@ binary_to_existing_atom(Config) when is_list(Config) ->
     UnlikelyAtom = binary_to_existing_atom(UnlikelyBin, latin1),
     ok.
 
+%% Existing atoms must be found at all times, also while other
+%% processes create new atoms and the atom table grows.
+existing_atom_while_growing(Config) when is_list(Config) ->
+    Prefix = "existing_atom_while_growing_" ++
+	integer_to_list(erlang:unique_integer([positive])) ++ "_",
+    Old = [list_to_atom(Prefix ++ "old_" ++ integer_to_list(I)) ||
+	      I <- lists:seq(1, 1000)],
+    Self = self(),
+    Readers = [spawn_link(fun() -> existing_atom_reader(Old, Self, 0) end) ||
+		  _ <- lists:seq(1, erlang:system_info(schedulers_online))],
+    New = [list_to_atom(Prefix ++ "new_" ++ integer_to_list(I)) ||
+	      I <- lists:seq(1, 50000)],
+    [R ! stop || R <- Readers],
+    [receive {R, done, N} when N > 0 -> ok end || R <- Readers],
+    [A = binary_to_existing_atom(atom_to_binary(A, utf8), utf8) ||
+	A <- New],
+    [A = list_to_existing_atom(atom_to_list(A)) || A <- New],
+    ok.
+
+existing_atom_reader(Atoms, Parent, N) ->
+    receive
+	stop ->
+	    Parent ! {self(), done, N}
+    after 0 ->
+	    [A = binary_to_existing_atom(atom_to_binary(A, latin1), latin1) ||
+		A <- Atoms],
+	    existing_atom_reader(Atoms, Parent, N+1)
+    end.
+
+%% Benchmark of binary_to_existing_atom/2 running on all schedulers
+%% at the same time.
+existing_atom_bench(Config) when is_list(Config) ->
+    Bins = [atom_to_binary(F, utf8) || {F,_} <- erlang:module_info(exports)],
+    Rounds = 20000,
+    Schedulers = erlang:system_info(schedulers_online),
+    Self = self(),
+    Pids = [spawn_opt(fun() ->
+			      receive go -> ok end,
+			      existing_atom_loop(Bins, Rounds),
+			      Self ! {self(), done}
+		      end, [link, {scheduler, I}]) ||
+	       I <- lists:seq(1, Schedulers)],
+    T0 = erlang:monotonic_time(),
+    [P ! go || P <- Pids],
+    [receive {P, done} -> ok end || P <- Pids],
+    T1 = erlang:monotonic_time(),
+    Time = erlang:convert_time_unit(T1 - T0, native, micro_seconds),
+    Lookups = length(Bins) * Rounds * Schedulers,
+    ct_event:notify(#event{name = benchmark_data,
+			   data = [{suite, "bif"},
+				   {name, "binary_to_existing_atom"},
+				   {value, round(Lookups * 1000000 / Time)}]}),
+    {comment, integer_to_list(Schedulers) ++ " schedulers"}.
+
+existing_atom_loop(_, 0) -> ok;
+existing_atom_loop(Bins, N) ->
+    _ = [binary_to_existing_atom(B, utf8) || B <- Bins],
+    existing_atom_loop(Bins, N-1).
+
 
 atom_to_binary(Config) when is_list(Config) ->
     HalfLong = lists:seq(0, 127),
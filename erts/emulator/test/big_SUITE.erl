@@ -24,7 +24,8 @@
 
 -export([t_div/1, eq_28/1, eq_32/1, eq_big/1, eq_math/1, big_literals/1,
 	 borders/1, negative/1, big_float_1/1, big_float_2/1,
-	 shift_limit_1/1, powmod/1, system_limit/1, toobig/1, otp_6692/1]).
+	 shift_limit_1/1, powmod/1, system_limit/1, toobig/1, otp_6692/1,
+	 karatsuba/1, huge_div/1, huge_to_decimal/1, big_bench/1]).
 
 %% Internal exports.
 -export([eval/1]).
@@ -34,6 +35,7 @@
 
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
 suite() ->
     [{ct_hooks,[ts_install_cth]},
@@ -42,10 +44,12 @@ suite() ->
 all() -> 
     [t_div, eq_28, eq_32, eq_big, eq_math, big_literals,
      borders, negative, {group, big_float}, shift_limit_1,
-     powmod, system_limit, toobig, otp_6692].
+     powmod, system_limit, toobig, otp_6692,
+     karatsuba, huge_div, huge_to_decimal].
 
 groups() -> 
-    [{big_float, [], [big_float_1, big_float_2]}].
+    [{big_float, [], [big_float_1, big_float_2]},
+     {big_bench, [], [big_bench]}].
 
 %%
 %% Syntax of data files:
@@ -396,3 +400,127 @@ loop2(X,Y,N,M) ->
     end,
     loop2(X,Y,N+1,M).
     
+
+%% Operand sizes in bits around and above the thresholds for
+%% Karatsuba multiplication, Barrett division and divide and
+%% conquer decimal conversion.
+huge_sizes() ->
+    [64, 65, 1000, 30*64, 31*64, 32*64, 33*64, 47*64, 48*64, 49*64,
+     63*64, 64*64, 65*64+1, 97*64, 128*64+7, 200*64, 513*64, 1000*64+3,
+     3001*64].
+
+huge_ints(Bits) ->
+    [(1 bsl Bits) - 1,
+     1 bsl (Bits-1),
+     (1 bsl (Bits-1)) bor 1,
+     rand_int(Bits)].
+
+rand_int(Bits) ->
+    Bytes = (Bits + 7) div 8,
+    <<X:Bytes/unit:8>> = << <<(rand:uniform(256)-1)>> || _ <- lists:seq(1, Bytes) >>,
+    (X bsr (Bytes*8 - Bits)) bor (1 bsl (Bits-1)).
+
+%% Multiply the (positive) integers A and B 60 bits of A at a time,
+%% which never uses Karatsuba multiplication.
+mul_ref(A, B) ->
+    mul_ref(A, B, 0, 0).
+
+mul_ref(0, _, _, Acc) -> Acc;
+mul_ref(A, B, Shift, Acc) ->
+    mul_ref(A bsr 60, B, Shift+60,
+	    Acc + (((A band ((1 bsl 60) - 1)) * B) bsl Shift)).
+
+%% Test multiplication and squaring of huge integers.
+karatsuba(Config) when is_list(Config) ->
+    rand:seed(exsplus, {1,2,3}),
+    Sizes = huge_sizes(),
+    _ = [begin
+	     P = mul_ref(A, B),
+	     P = id(A) * id(B),
+	     P = id(B) * id(A),
+	     P = id(-A) * id(-B),
+	     P = -(id(-A) * id(B))
+	 end || SA <- Sizes, SB <- Sizes,
+		A <- huge_ints(SA), B <- [rand_int(SB), (1 bsl SB) - 1]],
+    _ = [begin
+	     P = mul_ref(A, A),
+	     P = A * A
+	 end || SA <- Sizes, A <- huge_ints(SA)],
+    ok.
+
+%% Test division of huge integers.
+huge_div(Config) when is_list(Config) ->
+    rand:seed(exsplus, {4,5,6}),
+    Sizes = huge_sizes(),
+    _ = [begin
+	     Q = id(A) div id(B),
+	     R = id(A) rem id(B),
+	     true = R >= 0 andalso R < B,
+	     A = mul_ref(Q, B) + R,
+	     Q = -(id(-A) div id(B)),
+	     R = -(id(-A) rem id(B))
+	 end || SA <- Sizes, SB <- Sizes, SA > SB,
+		A <- huge_ints(SA), B <- [rand_int(SB), 1 bsl (SB-1)]],
+    ok.
+
+%% Test conversion of huge integers to decimal form.
+huge_to_decimal(Config) when is_list(Config) ->
+    rand:seed(exsplus, {7,8,9}),
+    Ints = [I || S <- huge_sizes(), I <- huge_ints(S)] ++
+	[I || N <- lists:seq(1, 5000, 37),
+	      P <- [pow(10, N)], I <- [P-1, P, P+1]] ++
+	[pow(10, 18 bsl K) + D || K <- lists:seq(0, 9), D <- [-1, 0, 1]],
+    _ = [huge_to_decimal_1(I) || I <- Ints],
+    ok.
+
+huge_to_decimal_1(I) ->
+    L = integer_to_list(I),
+    Bin = list_to_binary(L),
+    Bin = integer_to_binary(I),
+    "-" ++ L = integer_to_list(-I),
+    L = lists:flatten(io_lib:format("~w", [I])),
+    I = list_to_integer(L),
+    case L of
+	"0" ++ _ -> ct:fail({leading_zero, I});
+	_ -> ok
+    end.
+
+%% Benchmark of multiplication, squaring, division and conversion
+%% to decimal form for increasing operand sizes, showing where the
+%% sub-quadratic algorithms take over.
+big_bench(Config) when is_list(Config) ->
+    rand:seed(exsplus, {1,2,3}),
+    Sizes = [8, 16, 24, 32, 40, 48, 64, 96, 128, 256, 512, 1024, 4096],
+    Ops = [{"mul", fun(A, B) -> A * B end, fun(A, B) -> {A, B} end},
+	   {"sqr", fun(A, _) -> A * A end, fun(A, B) -> {A, B} end},
+	   {"div", fun(A, B) -> A div B end, fun(A, B) -> {A * A, B} end},
+	   {"integer_to_list", fun(A, _) -> integer_to_list(A) end,
+	    fun(A, B) -> {A, B} end}],
+    _ = [big_bench_1(Name, Op, Prep, Words) ||
+	    {Name, Op, Prep} <- Ops, Words <- Sizes],
+    ok.
+
+big_bench_1(Name, Op, Prep, Words) ->
+    Bits = Words * erlang:system_info(wordsize) * 8,
+    {A, B} = Prep(rand_int(Bits), rand_int(Bits - 5)),
+    {Time, N} = big_bench_loop(Op, A, B, 1),
+    OpsPerSec = round(N * 1000000 / Time),
+    BenchName = Name ++ "_" ++ integer_to_list(Words) ++ "_words",
+    ct_event:notify(#event{name = benchmark_data,
+			   data = [{suite, "big"},
+				   {name, BenchName},
+				   {value, OpsPerSec}]}),
+    ok.
+
+%% Run Op N times, doubling N until the run takes at least 0.2 seconds.
+big_bench_loop(Op, A, B, N) ->
+    {Time, _} = timer:tc(fun() -> big_bench_run(Op, A, B, N) end),
+    if
+	Time >= 200000 -> {Time, N};
+	true -> big_bench_loop(Op, A, B, 2*N)
+    end.
+
+big_bench_run(_, _, _, 0) -> ok;
+big_bench_run(Op, A, B, N) ->
+    _ = Op(id(A), id(B)),
+    big_bench_run(Op, A, B, N-1).
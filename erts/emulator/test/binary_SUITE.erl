@@ -60,7 +60,8 @@
 	 bit_sized_binary_sizes/1,
 	 otp_6817/1,deep/1,obsolete_funs/1,robustness/1,otp_8117/1,
 	 otp_8180/1, trapping/1, large/1,
-	 error_after_yield/1, cmp_old_impl/1]).
+	 error_after_yield/1, cmp_old_impl/1, lz4_compression/1,
+	 binary_to_term_stream/1]).
 
 %% Internal exports.
 -export([sleeper/0,trapping_loop/4]).
@@ -79,7 +80,8 @@ all() ->
      ordering, unaligned_order, gc_test,
      bit_sized_binary_sizes, otp_6817, otp_8117, deep,
      obsolete_funs, robustness, otp_8180, trapping, large,
-     error_after_yield, cmp_old_impl].
+     error_after_yield, cmp_old_impl, lz4_compression,
+     binary_to_term_stream].
 
 groups() -> 
     [].
@@ -417,6 +419,10 @@ bad_term_to_binary(Config) when is_list(Config) ->
     {'EXIT',{badarg,_}} = (catch term_to_binary(T, [{compressed,10}])),
     {'EXIT',{badarg,_}} = (catch term_to_binary(T, [{compressed,cucumber}])),
     {'EXIT',{badarg,_}} = (catch term_to_binary(T, [{compressed}])),
+    {'EXIT',{badarg,_}} = (catch term_to_binary(T, [{compressed,{lz4,-1}}])),
+    {'EXIT',{badarg,_}} = (catch term_to_binary(T, [{compressed,{lz4,10}}])),
+    {'EXIT',{badarg,_}} = (catch term_to_binary(T, [{compressed,{zlib,1}}])),
+    {'EXIT',{badarg,_}} = (catch term_to_binary(T, [{compressed,{lz4}}])),
     {'EXIT',{badarg,_}} = (catch term_to_binary(T, [{version,1}|bad_tail])),
     {'EXIT',{badarg,_}} = (catch term_to_binary(T, [{minor_version,-1}])),
     {'EXIT',{badarg,_}} = (catch term_to_binary(T, [{minor_version,x}])),
@@ -456,7 +462,9 @@ terms(Config) when is_list(Config) ->
 		      Bin = term_to_binary(Term, [{compressed,0}]),
 		      terms_compression_levels(Term, size(Bin), 1),
 		      UnalignedC = make_unaligned_sub_binary(BinC),
-		      Term = binary_to_term_stress(UnalignedC)
+		      Term = binary_to_term_stress(UnalignedC),
+		      Bin = term_to_binary(Term, [{compressed,{lz4,0}}]),
+		      terms_lz4_levels(Term, size(Bin), 1)
 	      end,
     test_terms(TestFun),
     ok.
@@ -469,6 +477,15 @@ terms_compression_levels(Term, UncompressedSz, Level) when Level < 10 ->
     terms_compression_levels(Term, UncompressedSz, Level+1);
 terms_compression_levels(_, _, _) -> ok.
 
+terms_lz4_levels(Term, UncompressedSz, Level) when Level < 10 ->
+    BinC = erlang:term_to_binary(Term, [{compressed,{lz4,Level}}]),
+    Term = binary_to_term_stress(BinC),
+    Term = binary_to_term_stress(make_unaligned_sub_binary(BinC)),
+    Sz = byte_size(BinC),
+    true = Sz =< UncompressedSz,
+    terms_lz4_levels(Term, UncompressedSz, Level+1);
+terms_lz4_levels(_, _, _) -> ok.
+
 terms_float(Config) when is_list(Config) ->
     test_floats(fun(Term) ->
 			      Bin0 = term_to_binary(Term, [{minor_version,0}]),
@@ -601,6 +618,15 @@ bad_binary_to_term(Config) when is_list(Config) ->
 
     %% Bad float.
     bad_bin_to_term(<<131,70,-1:64>>),
+
+    %% Map whose number of keys and values does not fit in 32 bits.
+    bad_bin_to_term(<<131,116,16#80000001:32,97,1,97,2>>),
+
+    %% Fun whose creator is not a pid.
+    <<131,PidExt/binary>> = term_to_binary(self()),
+    [FunHead,FunTail] = binary:split(term_to_binary(fun() -> ok end), PidExt),
+    <<_,_,PidRest/binary>> = PidExt,
+    bad_bin_to_term(<<FunHead/binary,97,1,PidRest/binary,FunTail/binary>>),
     ok.
 
 bad_bin_to_term(BadBin) ->
@@ -670,7 +696,9 @@ corrupter0(Term) ->
     Bin = term_to_binary(Term),
     corrupter(Bin, size(Bin)-1),
     CompressedBin = term_to_binary(Term, [compressed]),
-    corrupter(CompressedBin, size(CompressedBin)-1).
+    corrupter(CompressedBin, size(CompressedBin)-1),
+    Lz4Bin = term_to_binary(Term, [{compressed,{lz4,5}}]),
+    corrupter(Lz4Bin, size(Lz4Bin)-1).
 
 corrupter(Bin, Pos) when Pos >= 0 ->
     {ShorterBin, Rest} = split_binary(Bin, Pos),
@@ -1344,6 +1372,12 @@ trapping(Config) when is_list(Config)->
 		fun() -> [lists:duplicate(2000000,2000000)] end),
     do_trapping(5, binary_to_term,
 		fun() -> [term_to_binary(lists:duplicate(2000000,2000000))] end),
+    do_trapping(5, term_to_binary,
+		fun() -> [lists:duplicate(2000000,2000000),
+			  [{compressed,{lz4,1}}]] end),
+    do_trapping(5, binary_to_term,
+		fun() -> [term_to_binary(lists:duplicate(2000000,2000000),
+					 [{compressed,{lz4,1}}])] end),
     do_trapping(5, binary_to_list,
 		fun() -> [list_to_binary(lists:duplicate(2000000,$x))] end),
     do_trapping(5, list_to_binary,
@@ -1403,6 +1437,108 @@ large(Config) when is_list(Config) ->
     BitStr2 = list_to_bitstring(bitstring_to_list(BitStr2)),
     ok.
 
+%% Terms spanning many LZ4 blocks, and terms that do not compress,
+%% survive the round trip; inconsistent sizes are rejected.
+lz4_compression(Config) when is_list(Config) ->
+    Big = [{I, integer_to_list(I), <<I:64>>} || I <- lists:seq(1, 100000)],
+    BigBin = term_to_binary(Big),
+    BigLz4 = term_to_binary(Big, [{compressed,{lz4,1}}]),
+    <<131,$Q,Size:32,BlockSz:32,Rest/binary>> = BigLz4,
+    Size = byte_size(BigBin) - 1,
+    true = byte_size(BigLz4) < byte_size(BigBin),
+    Big = binary_to_term(BigLz4),
+    Big = binary_to_term(BigLz4, [safe]),
+    Big = binary_to_term(make_unaligned_sub_binary(BigLz4)),
+
+    Random = << <<(rand:uniform(256)-1)>> || _ <- lists:seq(1, 200000) >>,
+    RandomBin = term_to_binary(Random),
+    RandomBin = term_to_binary(Random, [{compressed,{lz4,9}}]),
+
+    {'EXIT',{badarg,_}} =
+	(catch binary_to_term(<<131,$Q,Size:32,(BlockSz+1):32,Rest/binary>>)),
+    {'EXIT',{badarg,_}} =
+	(catch binary_to_term(<<131,$Q,(Size+1):32,BlockSz:32,Rest/binary>>)),
+    {'EXIT',{badarg,_}} =
+	(catch binary_to_term(<<131,$Q,(Size*1000):32,BlockSz:32,Rest/binary>>)),
+    {'EXIT',{badarg,_}} =
+	(catch binary_to_term(binary:part(BigLz4, 0, byte_size(BigLz4)-1))),
+    {'EXIT',{badarg,_}} = (catch binary_to_term(<<131,$Q,0:32,0:32>>)),
+    ok.
+
+binary_to_term_stream(Config) when is_list(Config) ->
+    Terms = [a, 42, [], "abc", {1,2,3}, 3.14, 1 bsl 300, self(), make_ref(),
+	     #{a => 1, b => [x]}, <<1,2,3>>, fun(X) -> {X, Config} end,
+	     list_to_binary(lists:seq(0, 255)), binary:copy(<<"abc">>, 40000),
+	     <<(binary:copy(<<"abc">>, 40000))/binary, 5:3>>],
+    Big = [{I, integer_to_list(I), <<I:64>>} || I <- lists:seq(1, 100000)],
+    [begin
+	 Bin = term_to_binary(Term, Opt),
+	 [{Term, Rest} = feed_stream(chunk_binary(<<Bin/binary, Rest/binary>>, N))
+	  || N <- chunk_sizes(byte_size(Bin)), Rest <- [<<>>, <<"rest">>]],
+	 {done, Term, <<>>} =
+	     erlang:binary_to_term_feed(binary_to_list(Bin),
+					erlang:binary_to_term_stream([safe])),
+	 {done, Term, <<1,2,3>>} =
+	     erlang:binary_to_term_feed([[Bin, 1] | <<2,3>>],
+					erlang:binary_to_term_stream()),
+	 {done, Term, <<>>} =
+	     erlang:binary_to_term_feed(make_unaligned_sub_binary(Bin),
+					erlang:binary_to_term_stream())
+     end || {Term, Opt} <- [{T, O} || T <- Terms,
+				      O <- [[], [compressed], [{compressed,{lz4,1}}]]]
+		 ++ [{Big, []}, {Big, [{compressed,{lz4,1}}]}]],
+
+    %% Two terms after each other.
+    Two = [term_to_binary(first), term_to_binary(second)],
+    {done, first, Rest1} =
+	erlang:binary_to_term_feed(Two, erlang:binary_to_term_stream()),
+    {done, second, <<>>} =
+	erlang:binary_to_term_feed(Rest1, erlang:binary_to_term_stream()),
+
+    %% Truncated terms need more; broken ones fail as soon as it shows.
+    Stream = erlang:binary_to_term_stream(),
+    {more, Stream} = erlang:binary_to_term_feed(<<>>, Stream),
+    {more, Stream} = erlang:binary_to_term_feed(<<131,108,0,0,0,2>>, Stream),
+    {more, Stream} = erlang:binary_to_term_feed(<<97,1,100,0,3,"ab">>, Stream),
+    {done, [1,abc], <<"x">>} = erlang:binary_to_term_feed(<<"c",106,"x">>, Stream),
+    bad_stream_feed(<<1,2,3>>, erlang:binary_to_term_stream()),
+    bad_stream_feed(<<131,255>>, erlang:binary_to_term_stream()),
+    bad_stream_feed(<<131,97>>, bad_stream),
+    bad_stream_feed(bit_sized_binary(<<131,97,1>>),
+		    erlang:binary_to_term_stream()),
+    bad_stream_feed([<<131>>, oops], erlang:binary_to_term_stream()),
+    bad_stream_feed(<<131,100,17:16,"no_such_atom_here">>,
+		    erlang:binary_to_term_stream([safe])),
+    {'EXIT',{badarg,_}} = (catch erlang:binary_to_term_stream([unsafe])),
+
+    %% A stream belongs to the process that created it.
+    Self = self(),
+    Other = spawn_link(fun() ->
+			       Self ! {self(), catch erlang:binary_to_term_feed(<<131>>, Stream)}
+		       end),
+    receive {Other, {'EXIT',{badarg,_}}} -> ok end,
+    ok.
+
+feed_stream(Chunks) ->
+    feed_stream(Chunks, erlang:binary_to_term_stream()).
+
+feed_stream([Chunk|Chunks], Stream0) ->
+    case erlang:binary_to_term_feed(Chunk, Stream0) of
+	{more, Stream} -> feed_stream(Chunks, Stream);
+	{done, Term, Rest} -> {Term, iolist_to_binary([Rest|Chunks])}
+    end.
+
+chunk_sizes(Size) when Size < 1000 -> [1, 2, 7, 100, Size];
+chunk_sizes(Size) -> [999, 65536, Size].
+
+chunk_binary(Bin, N) when byte_size(Bin) =< N -> [Bin];
+chunk_binary(Bin, N) ->
+    <<Chunk:N/binary, Rest/binary>> = Bin,
+    [Chunk | chunk_binary(Rest, N)].
+
+bad_stream_feed(Data, Stream) ->
+    {'EXIT',{badarg,_}} = (catch erlang:binary_to_term_feed(Data, Stream)).
+
 error_after_yield(Config) when is_list(Config) ->
     L2BTrap = {erts_internal, list_to_binary_continue, 1},
     error_after_yield(badarg, erlang, list_to_binary, 1, fun () -> [[mk_list(1000000), oops]] end, L2BTrap),
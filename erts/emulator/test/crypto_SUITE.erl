@@ -21,19 +21,23 @@
 -module(crypto_SUITE).
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
--export([all/0, suite/0,
+-export([all/0, suite/0, groups/0,
          t_md5/1,t_md5_update/1,error/1,unaligned_context/1,random_lists/1,
-         misc_errors/1]).
+         misc_errors/1,crc_sizes/1,crc_throughput/1]).
 
 suite() ->
     [{ct_hooks,[ts_install_cth]}].
 
 all() -> 
     [t_md5, t_md5_update, error, unaligned_context,
-     random_lists, misc_errors].
+     random_lists, misc_errors, crc_sizes].
 
-%% Test crc32, adler32 and md5 error cases not covered by other tests"
+groups() ->
+    [{crc_bench, [], [crc_throughput]}].
+
+%% Test crc32, crc32c, adler32 and md5 error cases not covered by other tests"
 misc_errors(Config) when is_list(Config) ->
     ct:timetrap({minutes, 2}),
     1 = erlang:adler32([]),
@@ -51,6 +55,17 @@ misc_errors(Config) when is_list(Config) ->
     {'EXIT', {badarg,_}} = (catch erlang:crc32_combine(Big,3,3)),
     {'EXIT', {badarg,_}} = (catch erlang:crc32_combine(3,Big,3)),
     {'EXIT', {badarg,_}} = (catch erlang:crc32_combine(3,3,Big)),
+    16#E3069283 = erlang:crc32c(<<"123456789">>),
+    16#E3069283 = erlang:crc32c(erlang:crc32c("1234"),<<"56789">>),
+    0 = erlang:crc32c([]),
+    {'EXIT', {badarg,_}} = (catch erlang:crc32c(L++[a])),
+    {'EXIT', {badarg,_}} = (catch erlang:crc32c([1,2,3|<<25:7>>])),
+    {'EXIT', {badarg,_}} = (catch erlang:crc32c([1,2,3|4])),
+    {'EXIT', {badarg,_}} = (catch erlang:crc32c(Big,<<"hej">>)),
+    {'EXIT', {badarg,_}} = (catch erlang:crc32c(25,[1,2,3|4])),
+    {'EXIT', {badarg,_}} = (catch erlang:crc32c_combine(Big,3,3)),
+    {'EXIT', {badarg,_}} = (catch erlang:crc32c_combine(3,Big,3)),
+    {'EXIT', {badarg,_}} = (catch erlang:crc32c_combine(3,3,Big)),
     {'EXIT', {badarg,_}} = (catch erlang:adler32(Big,<<"hej">>)),
     {'EXIT', {badarg,_}} = (catch erlang:adler32(25,[1,2,3|4])),
     {'EXIT', {badarg,_}} = (catch erlang:adler32_combine(Big,3,3)),
@@ -105,7 +120,8 @@ collect_workers([{L,{Pid,Ref}}|T]) ->
             exit({error_at_line,L,Other})
     end.
 
-%% Test crc32, adler32 and md5 on a number of pseudo-randomly generated lists.
+%% Test crc32, crc32c, adler32 and md5 on a number of pseudo-randomly
+%% generated lists.
 random_lists(Config) when is_list(Config) ->
     ct:timetrap({minutes, 5}),
     Num = erlang:system_info(schedulers_online),
@@ -114,6 +130,8 @@ random_lists(Config) when is_list(Config) ->
             (erlang:system_info(context_reductions)*10) - 50,$!)),
     CRC32_1 = fun(L) -> erlang:crc32(L) end,
     CRC32_2 = fun(L) -> ?REF:crc32(L) end,
+    CRC32C_1 = fun(L) -> erlang:crc32c(L) end,
+    CRC32C_2 = fun(L) -> ?REF:crc32c(L) end,
     ADLER32_1 = fun(L) -> erlang:adler32(L) end,
     ADLER32_2 = fun(L) -> ?REF:adler32(L) end,
     MD5_1 = fun(L) -> erlang:md5(L) end,
@@ -123,6 +141,8 @@ random_lists(Config) when is_list(Config) ->
                          erlang:md5_update(erlang:md5_init(),L)) end,
     CRC32_1_L = fun(L) -> erlang:crc32([B|L]) end,
     CRC32_2_L = fun(L) -> ?REF:crc32([B|L]) end,
+    CRC32C_1_L = fun(L) -> erlang:crc32c([B|L]) end,
+    CRC32C_2_L = fun(L) -> ?REF:crc32c([B|L]) end,
     ADLER32_1_L = fun(L) -> erlang:adler32([B|L]) end,
     ADLER32_2_L = fun(L) -> ?REF:adler32([B|L]) end,
     MD5_1_L = fun(L) -> erlang:md5([B|L]) end,
@@ -133,10 +153,12 @@ random_lists(Config) when is_list(Config) ->
                              erlang:md5_init(),[B|L])) end,
     Wlist0 = 
     [{?LINE, fun() -> random_iolist:run(150, CRC32_1, CRC32_2) end},
+     {?LINE, fun() -> random_iolist:run(150, CRC32C_1, CRC32C_2) end},
      {?LINE, fun() -> random_iolist:run(150, ADLER32_1, ADLER32_2) end},
      {?LINE, fun() -> random_iolist:run(150,MD5_1,MD5_2) end},
      {?LINE, fun() -> random_iolist:run(150,MD5_1,MD5_3) end},
      {?LINE, fun() -> random_iolist:run(150, CRC32_1_L, CRC32_2_L) end},
+     {?LINE, fun() -> random_iolist:run(150, CRC32C_1_L, CRC32C_2_L) end},
      {?LINE, 
       fun() -> random_iolist:run(150, ADLER32_1_L, ADLER32_2_L) end},
      {?LINE, fun() -> random_iolist:run(150,MD5_1_L,MD5_2_L) end},
@@ -149,6 +171,13 @@ random_lists(Config) when is_list(Config) ->
                                 erlang:crc32(L2),
                                 erlang:iolist_size(L2)) 
                 end,
+    CRC32C_1_2 = fun(L1,L2) -> erlang:crc32c([L1,L2]) end,
+    CRC32C_2_2 = fun(L1,L2) -> erlang:crc32c(erlang:crc32c(L1),L2) end,
+    CRC32C_3_2 = fun(L1,L2) -> erlang:crc32c_combine(
+                                 erlang:crc32c(L1),
+                                 erlang:crc32c(L2),
+                                 erlang:iolist_size(L2))
+                 end,
     ADLER32_1_2 = fun(L1,L2) -> erlang:adler32([L1,L2]) end,
     ADLER32_2_2 = fun(L1,L2) -> erlang:adler32(
                                   erlang:adler32(L1),L2) end,
@@ -174,6 +203,14 @@ random_lists(Config) when is_list(Config) ->
                                   erlang:crc32([B|L2]),
                                   erlang:iolist_size([B|L2])) 
                   end,
+    CRC32C_1_L_2 = fun(L1,L2) -> erlang:crc32c([[B|L1],[B|L2]]) end,
+    CRC32C_2_L_2 = fun(L1,L2) -> erlang:crc32c(
+                                   erlang:crc32c([B|L1]),[B|L2]) end,
+    CRC32C_3_L_2 = fun(L1,L2) -> erlang:crc32c_combine(
+                                   erlang:crc32c([B|L1]),
+                                   erlang:crc32c([B|L2]),
+                                   erlang:iolist_size([B|L2]))
+                   end,
     ADLER32_1_L_2 = fun(L1,L2) -> erlang:adler32([[B|L1],[B|L2]]) end,
     ADLER32_2_L_2 = fun(L1,L2) -> erlang:adler32(
                                     erlang:adler32([B|L1]),
@@ -196,11 +233,17 @@ random_lists(Config) when is_list(Config) ->
     Wlist1 = 
     [{?LINE, fun() -> random_iolist:run2(150,CRC32_1_2,CRC32_2_2) end},
      {?LINE, fun() -> random_iolist:run2(150,CRC32_1_2,CRC32_3_2) end},
+     {?LINE, fun() -> random_iolist:run2(150,CRC32C_1_2,CRC32C_2_2) end},
+     {?LINE, fun() -> random_iolist:run2(150,CRC32C_1_2,CRC32C_3_2) end},
      {?LINE, fun() -> random_iolist:run2(150,ADLER32_1_2,ADLER32_2_2) end},
      {?LINE, fun() -> random_iolist:run2(150,ADLER32_1_2,ADLER32_3_2) end},
      {?LINE, fun() -> random_iolist:run2(150,MD5_1_2,MD5_2_2) end},
      {?LINE, fun() -> random_iolist:run2(150,CRC32_1_L_2,CRC32_2_L_2) end},
      {?LINE, fun() -> random_iolist:run2(150,CRC32_1_L_2,CRC32_3_L_2) end},
+     {?LINE,
+      fun() -> random_iolist:run2(150,CRC32C_1_L_2,CRC32C_2_L_2) end},
+     {?LINE,
+      fun() -> random_iolist:run2(150,CRC32C_1_L_2,CRC32C_3_L_2) end},
      {?LINE, 
       fun() -> random_iolist:run2(150,ADLER32_1_L_2,ADLER32_2_L_2) end},
      {?LINE, 
@@ -209,6 +252,63 @@ random_lists(Config) when is_list(Config) ->
     run_in_para(Wlist1,Num),
     ok.
 
+%% Test crc32 and crc32c on binaries of every size and alignment around
+%% the block sizes used by the accelerated implementations.
+crc_sizes(Config) when is_list(Config) ->
+    ct:timetrap({minutes, 5}),
+    Data = list_to_binary([I band 255 || I <- lists:seq(1, 1100)]),
+    Sizes = lists:seq(0, 300) ++ [511,512,513,1023,1024,1025,1100-7],
+    [begin
+         <<_:Offs/binary,Bin:Size/binary,_/binary>> = Data,
+         Crc32 = ?REF:crc32(Bin),
+         Crc32 = erlang:crc32(Bin),
+         Crc32 = erlang:crc32(unaligned_sub_bin(Bin)),
+         Crc32C = ?REF:crc32c(Bin),
+         Crc32C = erlang:crc32c(Bin),
+         Crc32C = erlang:crc32c(unaligned_sub_bin(Bin)),
+         Half = Size div 2,
+         <<B1:Half/binary,B2/binary>> = Bin,
+         Crc32 = erlang:crc32(erlang:crc32(B1), B2),
+         Crc32C = erlang:crc32c(erlang:crc32c(B1), B2),
+         Crc32C = erlang:crc32c_combine(erlang:crc32c(B1), erlang:crc32c(B2),
+                                        byte_size(B2))
+     end || Size <- Sizes, Offs <- lists:seq(0, 7)],
+    ok.
+
+%% Measure checksum throughput for a number of input sizes.
+crc_throughput(Config) when is_list(Config) ->
+    ct:timetrap({minutes, 5}),
+    Funs = [{crc32, fun erlang:crc32/1},
+            {crc32c, fun erlang:crc32c/1},
+            {adler32, fun erlang:adler32/1}],
+    Sizes = [64, 1024, 64*1024, 1024*1024],
+    Res = [crc_throughput(Name, F, Size) || {Name, F} <- Funs, Size <- Sizes],
+    {comment, lists:flatten([io_lib:format("~s ~w: ~w MB/s; ", [N, S, V])
+                             || {N, S, V} <- Res])}.
+
+crc_throughput(Name, F, Size) ->
+    Bin = list_to_binary([I band 255 || I <- lists:seq(1, Size)]),
+    N = max(1, (64*1024*1024) div Size),
+    T0 = erlang:monotonic_time(),
+    crc_loop(N, F, Bin),
+    T1 = erlang:monotonic_time(),
+    Us = max(1, erlang:convert_time_unit(T1 - T0, native, micro_seconds)),
+    MBs = (N * Size) div Us,
+    ct_event:notify(
+      #event{name = benchmark_data,
+             data = [{suite, "crypto"},
+                     {name, lists:flatten(
+                              io_lib:format("~s ~w bytes MB/s",
+                                            [Name, Size]))},
+                     {value, MBs}]}),
+    {Name, Size, MBs}.
+
+crc_loop(0, _F, _Bin) ->
+    ok;
+crc_loop(N, F, Bin) ->
+    _ = F(Bin),
+    crc_loop(N - 1, F, Bin).
+
 %% Generate MD5 message digests and check the result. Examples are from RFC-1321.
 t_md5(Config) when is_list(Config) ->
     t_md5_test("", "d41d8cd98f00b204e9800998ecf8427e"),
@@ -19,13 +19,13 @@
 %%
 
 %%
-%% Reference implementations of crc32, adler32 and md5 in erlang. Used
+%% Reference implementations of crc32, crc32c, adler32 and md5 in erlang. Used
 %% by crypto_SUITE.
 %%
 
 -module(crypto_reference).
 
--export([adler32/1, crc32/1, md5_init/0, md5_update/2, md5_final/1]).
+-export([adler32/1, crc32/1, crc32c/1, md5_init/0, md5_update/2, md5_final/1]).
 -export([crc32_table/0, reflect8_table/0]).
 
 -define(BASE, 65521).
@@ -84,6 +84,26 @@ crc32(Bin) when is_binary(Bin) ->
 crc32(L) ->
     crc32(erlang:iolist_to_binary(L)).
 
+%% crc32c (Castagnoli) computed bitwise on the reflected polynomial.
+-define(CRC32C_POLYNOMIAL,16#82F63B78).
+
+crc32c(Bin) when is_binary(Bin) ->
+    crc32c(Bin,?INITIAL_REMAINDER);
+crc32c(L) ->
+    crc32c(erlang:iolist_to_binary(L)).
+
+crc32c(<<>>,Remainder) ->
+    Remainder bxor ?FINAL_XOR_VALUE;
+crc32c(<<CH:8,T/binary>>,Remainder) ->
+    crc32c(T,crc32c_bits(8,Remainder bxor CH)).
+
+crc32c_bits(0,Remainder) ->
+    Remainder;
+crc32c_bits(N,Remainder) when Remainder band 1 =:= 1 ->
+    crc32c_bits(N-1,(Remainder bsr 1) bxor ?CRC32C_POLYNOMIAL);
+crc32c_bits(N,Remainder) ->
+    crc32c_bits(N-1,Remainder bsr 1).
+
 bitmod2(0,Remainder,_Topbit,_Polynomial,_Mask) ->
     %io:format("~p ",[Remainder]),
     Remainder;
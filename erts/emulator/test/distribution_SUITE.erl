@@ -51,6 +51,8 @@
          atom_roundtrip_r15b/1,
          contended_atom_cache_entry/1,
          contended_unicode_atom_cache_entry/1,
+         fragmented_roundtrip/1, fragmented_interleave/1,
+         fragmented_sender_killed/1,
          bad_dist_structure/1,
          bad_dist_ext_receive/1,
          bad_dist_ext_process_info/1,
@@ -80,6 +82,8 @@ all() ->
      {group, trap_bif}, {group, dist_auto_connect},
      dist_parallel_send, atom_roundtrip, unicode_atom_roundtrip, atom_roundtrip_r15b,
      contended_atom_cache_entry, contended_unicode_atom_cache_entry,
+     fragmented_roundtrip, fragmented_interleave,
+     fragmented_sender_killed,
      bad_dist_structure, {group, bad_dist_ext},
      start_epmd_false, epmd_module].
 
@@ -1347,6 +1351,116 @@ start_link(Offender,P) ->
     io:format("Ref is ~p~n",[Ref]),
     ok.
 
+%% Large messages, sent in fragments, are reassembled correctly, also
+%% when other messages using the atom cache are passed in between.
+fragmented_roundtrip(Config) when is_list(Config) ->
+    {ok, Node} = start_node(Config),
+    Self = self(),
+    Echo = spawn_link(Node, fun () -> echo_loop() end),
+    Terms = [{I,
+              [list_to_atom("fragmented_" ++ integer_to_list(J))
+               || J <- lists:seq(1, I rem 300)],
+              binary:copy(<<I:32>>, 100000 + I*997),
+              lists:seq(1, 20000)}
+             || I <- lists:seq(1, 40)],
+    Senders = [spawn_link(fun () ->
+                                  [begin
+                                       Echo ! {self(), T},
+                                       receive {Echo, T} -> ok end
+                                   end || T <- Terms],
+                                  Self ! {self(), done}
+                          end) || _ <- lists:seq(1, 4)],
+    Small = spawn_link(fun () -> small_echo_loop(Echo, 0) end),
+    [receive {S, done} -> ok end || S <- Senders],
+    Small ! {stop, Self},
+    receive {Small, N} -> io:format("~p small roundtrips~n", [N]) end,
+    unlink(Echo),
+    stop_node(Node),
+    ok.
+
+echo_loop() ->
+    receive
+        {From, Term} ->
+            From ! {self(), Term},
+            echo_loop()
+    end.
+
+small_echo_loop(Echo, N) ->
+    receive
+        {stop, From} ->
+            From ! {self(), N}
+    after 0 ->
+            Atom = list_to_atom("fragmented_small_" ++ integer_to_list(N rem 500)),
+            Echo ! {self(), Atom},
+            receive {Echo, Atom} -> ok end,
+            small_echo_loop(Echo, N+1)
+    end.
+
+%% A small message is not stuck behind a large one whose sender has
+%% been suspended on a busy connection.
+fragmented_interleave(Config) when is_list(Config) ->
+    {ok, Node} = start_node(Config),
+    Self = self(),
+    Size = 64*1024*1024,
+    Collector = spawn_link(Node,
+                           fun () ->
+                                   Order = [receive
+                                                {big, Bin} when byte_size(Bin) =:= Size ->
+                                                    big;
+                                                small ->
+                                                    small
+                                            end || _ <- [1,2]],
+                                   Self ! {self(), Order}
+                           end),
+    Big = binary:copy(<<"0123456789abcdef">>, Size div 16),
+    Sender = spawn_link(fun () -> Collector ! {big, Big} end),
+    wait_until_suspended(Sender),
+    Collector ! small,
+    receive {Collector, Order} -> [small, big] = Order end,
+    unlink(Collector),
+    stop_node(Node),
+    ok.
+
+%% A sender killed in the middle of a fragmented message does not
+%% leave the message half delivered, nor break the connection.
+fragmented_sender_killed(Config) when is_list(Config) ->
+    {ok, Node} = start_node(Config),
+    Self = self(),
+    Size = 64*1024*1024,
+    Collector = spawn_link(Node,
+                           fun () ->
+                                   Ids = [receive
+                                              {big, Id, Bin} when byte_size(Bin) =:= Size ->
+                                                  Id
+                                          end || _ <- [1,2]],
+                                   Self ! {self(), Ids}
+                           end),
+    Big = binary:copy(<<"0123456789abcdef">>, Size div 16),
+    Killed = spawn(fun () -> Collector ! {big, killed, Big} end),
+    wait_until_suspended(Killed),
+    exit(Killed, kill),
+    [spawn_link(fun () -> Collector ! {big, Id, Big} end)
+     || Id <- [first, second]],
+    receive {Collector, Ids} -> [first, second] = lists:sort(Ids) end,
+    true = lists:member(Node, nodes()),
+    unlink(Collector),
+    stop_node(Node),
+    ok.
+
+wait_until_suspended(Pid) ->
+    wait_until_suspended(Pid, 1000).
+
+wait_until_suspended(Pid, 0) ->
+    ct:fail({not_suspended, Pid, process_info(Pid, status)});
+wait_until_suspended(Pid, Retries) ->
+    case process_info(Pid, status) of
+        {status, suspended} ->
+            ok;
+        _ ->
+            receive after 10 -> ok end,
+            wait_until_suspended(Pid, Retries-1)
+    end.
+
 %% Test dist messages with valid structure (binary to term ok) but malformed control content
 bad_dist_structure(Config) when is_list(Config) ->
     ct:timetrap({seconds, 15}),
@@ -76,6 +76,7 @@
          missing_callbacks/1,
          smp_select/1,
          driver_select_use/1,
+         poll_threads/1,
          thread_mseg_alloc_cache_clean/1,
          otp_9302/1,
          thr_free_drv/1,
@@ -84,7 +85,7 @@
          consume_timeslice/1,
          z_test/1]).
 
--export([bin_prefix/2]).
+-export([bin_prefix/2, poll_threads_echo/2]).
 
 -include_lib("common_test/include/ct.hrl").
 
@@ -148,7 +149,7 @@ all() -> %% Keep a_test first and z_test last...
      larger_minor_vsn_drv, smaller_major_vsn_drv,
      smaller_minor_vsn_drv, peek_non_existing_queue,
      otp_6879, caller, many_events, missing_callbacks,
-     smp_select, driver_select_use,
+     smp_select, driver_select_use, poll_threads,
      thread_mseg_alloc_cache_clean,
      otp_9302,
      thr_free_drv,
@@ -1720,6 +1721,66 @@ driver_select_use0(Config) ->
     ok = erl_ddll:stop(),
     ok.
 
+%% Test that I/O is handled when fds are spread over the pollsets
+%% of dedicated poll threads (+IOt).
+poll_threads(Config) when is_list(Config) ->
+    case erlang:system_info(smp_support) of
+        false -> {skipped, "Poll threads are only used by the SMP emulator"};
+        true -> poll_threads0(Config)
+    end.
+
+poll_threads0(Config) ->
+    {ok, Node} = start_node(Config, "+IOt 3"),
+    {poll_threads, 3} = lists:keyfind(poll_threads, 1,
+                                      rpc:call(Node, erlang, system_info,
+                                               [check_io])),
+    ok = rpc:call(Node, ?MODULE, poll_threads_echo, [100, 10]),
+    stop_node(Node),
+    ok.
+
+poll_threads_echo(NoConns, NoMsgs) ->
+    {ok, L} = gen_tcp:listen(0, [binary, {active, false}, {backlog, NoConns}]),
+    {ok, Port} = inet:port(L),
+    Parent = self(),
+    Acceptor = spawn_link(fun () -> poll_threads_accept(L, NoConns) end),
+    Clients = [spawn_link(
+                 fun () ->
+                         {ok, S} = gen_tcp:connect({127,0,0,1}, Port,
+                                                   [binary, {active, true},
+                                                    {nodelay, true}]),
+                         lists:foreach(
+                           fun (N) ->
+                                   ok = gen_tcp:send(S, <<N:32>>),
+                                   receive
+                                       {tcp, S, <<N:32>>} -> ok
+                                   end
+                           end, lists:seq(1, NoMsgs)),
+                         ok = gen_tcp:close(S),
+                         Parent ! {done, self()}
+                 end) || _ <- lists:seq(1, NoConns)],
+    lists:foreach(fun (C) -> receive {done, C} -> ok end end, Clients),
+    unlink(Acceptor),
+    exit(Acceptor, kill),
+    ok = gen_tcp:close(L).
+
+poll_threads_accept(_L, 0) ->
+    ok;
+poll_threads_accept(L, N) ->
+    {ok, S} = gen_tcp:accept(L),
+    Pid = spawn(fun () -> receive go -> poll_threads_loop(S) end end),
+    ok = gen_tcp:controlling_process(S, Pid),
+    Pid ! go,
+    poll_threads_accept(L, N-1).
+
+poll_threads_loop(S) ->
+    case gen_tcp:recv(S, 4) of
+        {ok, B} ->
+            ok = gen_tcp:send(S, B),
+            poll_threads_loop(S);
+        {error, closed} ->
+            gen_tcp:close(S)
+    end.
+
 thread_mseg_alloc_cache_clean(Config) when is_list(Config) ->
     case {erlang:system_info(threads),
           erlang:system_info({allocator,mseg_alloc}),
@@ -2476,6 +2537,9 @@ sleep(Ms) when is_integer(Ms), Ms >= 0 ->
 
 
 start_node(Config) when is_list(Config) ->
+    start_node(Config, "").
+
+start_node(Config, Args) when is_list(Config) ->
     Pa = filename:dirname(code:which(?MODULE)),
     Name = list_to_atom(atom_to_list(?MODULE)
                         ++ "-"
@@ -2484,7 +2548,7 @@ start_node(Config) when is_list(Config) ->
                         ++ integer_to_list(erlang:system_time(seconds))
                         ++ "-"
                         ++ integer_to_list(erlang:unique_integer([positive]))),
-    test_server:start_node(Name, slave, [{args, "-pa "++Pa}]).
+    test_server:start_node(Name, slave, [{args, "-pa "++Pa++" "++Args}]).
 
 stop_node(Node) ->
     test_server:stop_node(Node).
@@ -1 +1,11 @@
 {groups,"../emulator_test",estone_SUITE,[estone_bench]}.
+{groups,"../emulator_test",big_SUITE,[big_bench]}.
+{groups,"../emulator_test",match_spec_SUITE,[ms_bench]}.
+{groups,"../emulator_test",bif_SUITE,[atom_bench]}.
+{groups,"../emulator_test",message_queue_data_SUITE,[mqd_bench]}.
+{groups,"../emulator_test",receive_SUITE,[receive_bench]}.
+{groups,"../emulator_test",scheduler_SUITE,[scheduler_bench]}.
+{groups,"../emulator_test",process_SUITE,[spawn_bench]}.
+{groups,"../emulator_test",timer_bif_SUITE,[timer_bench]}.
+{groups,"../emulator_test",crypto_SUITE,[crc_bench]}.
+{groups,"../emulator_test",monitor_SUITE,[monitor_bench]}.
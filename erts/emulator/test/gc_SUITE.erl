@@ -25,13 +25,17 @@
 -include_lib("common_test/include/ct.hrl").
 -export([all/0, suite/0]).
 
--export([grow_heap/1, grow_stack/1, grow_stack_heap/1, max_heap_size/1]).
+-export([grow_heap/1, grow_stack/1, grow_stack_heap/1, max_heap_size/1,
+         dirty_major_gc/1, dirty_gc_heap_size/1]).
+
+-export([dirty_gc_time/1]).
 
 suite() ->
     [{ct_hooks,[ts_install_cth]}].
 
 all() -> 
-    [grow_heap, grow_stack, grow_stack_heap, max_heap_size].
+    [grow_heap, grow_stack, grow_stack_heap, max_heap_size, dirty_major_gc,
+     dirty_gc_heap_size].
 
 
 %% Produce a growing list of elements,
@@ -185,6 +189,76 @@ max_heap_size(_Config) ->
             ct:fail({process_did_not_die, Pid, erlang:process_info(Pid)})
     end.
 
+%% Major collections of large heaps should be done on a dirty cpu
+%% scheduler, without losing any data.
+dirty_major_gc(_Config) ->
+    try erlang:system_info(dirty_cpu_schedulers) of
+        N when is_integer(N), N > 0 ->
+            dirty_major_gc_test()
+    catch
+        error:badarg ->
+            {skipped, "No dirty scheduler support"}
+    end.
+
+dirty_major_gc_test() ->
+    %% Well above the default +hdgc size
+    true = dirty_gc_time(2000000) > 0,
+    ok.
+
+%% The +hdgc size given to erl should decide which major collections
+%% are moved to a dirty cpu scheduler.
+dirty_gc_heap_size(_Config) ->
+    try erlang:system_info(dirty_cpu_schedulers) of
+        N when is_integer(N), N > 0 ->
+            %% Well below the default +hdgc size
+            Len = 100000,
+            0 = dirty_gc_time_on_node("+hdgc 0", Len),
+            true = dirty_gc_time_on_node("+hdgc 4096", Len) > 0,
+            ok
+    catch
+        error:badarg ->
+            {skipped, "No dirty scheduler support"}
+    end.
+
+dirty_gc_time_on_node(Args, Len) ->
+    Pa = filename:dirname(code:which(?MODULE)),
+    {ok, Node} = test_server:start_node(dirty_gc_heap_size, slave,
+                                        [{args, Args ++ " -pa " ++ Pa}]),
+    Time = rpc:call(Node, ?MODULE, dirty_gc_time, [Len]),
+    true = test_server:stop_node(Node),
+    Time.
+
+%% Collects a heap holding a list of length Len and returns the time
+%% dirty cpu schedulers spent collecting meanwhile.
+dirty_gc_time(Len) ->
+    Old = erlang:system_flag(microstate_accounting, true),
+    erlang:system_flag(microstate_accounting, reset),
+    {Pid, Ref} =
+        spawn_monitor(
+          fun() ->
+                  L = lists:seq(1, Len),
+                  Sum = lists:sum(L),
+                  [begin
+                       _ = [X || X <- L, X rem 3 =:= I],
+                       true = erlang:garbage_collect(),
+                       %% The major collection is done when
+                       %% garbage_collect/0 returns
+                       {garbage_collection, GC} =
+                           process_info(self(), garbage_collection),
+                       {minor_gcs, 0} = lists:keyfind(minor_gcs, 1, GC)
+                   end || I <- [0, 1, 2]],
+                  Sum = lists:sum(L),
+                  exit({ok, length(L)})
+          end),
+    receive
+        {'DOWN', Ref, process, Pid, Res} ->
+            {ok, Len} = Res
+    end,
+    erlang:system_flag(microstate_accounting, Old),
+    lists:sum([maps:get(gc, Cnt) ||
+                  #{type := dirty_cpu_scheduler, counters := Cnt}
+                      <- erlang:statistics(microstate_accounting)]).
+
 long_receive() ->
     receive
     after 10000 ->
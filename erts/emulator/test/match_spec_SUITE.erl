@@ -20,7 +20,7 @@
 
 -module(match_spec_SUITE).
 
--export([all/0, suite/0, not_run/1]).
+-export([all/0, suite/0, groups/0, not_run/1]).
 -export([test_1/1, test_2/1, test_3/1, bad_match_spec_bin/1,
 	 trace_control_word/1, silent/1, silent_no_ms/1, silent_test/1,
 	 ms_trace2/1, ms_trace3/1, ms_trace_dead/1, boxed_and_small/1,
@@ -31,6 +31,7 @@
 -export([otp_9422/1]).
 -export([faulty_seq_trace/1, do_faulty_seq_trace/0]).
 -export([maps/1]).
+-export([fused_heads/1, ms_bench/1]).
 -export([runner/2, loop_runner/3]).
 -export([f1/1, f2/2, f3/2, fn/1, fn/2, fn/3]).
 -export([do_boxed_and_small/0]).
@@ -39,6 +40,7 @@
 % the match spec functionality.
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
 suite() ->
     [{ct_hooks,[ts_install_cth]},
@@ -55,10 +57,14 @@ all() ->
 	     faulty_seq_trace,
 	     empty_list,
              otp_9422,
-             maps];
+             maps,
+             fused_heads];
 	true -> [not_run]
     end.
 
+groups() ->
+    [{ms_bench, [], [ms_bench]}].
+
 not_run(Config) when is_list(Config) ->
     {skipped, "Native Code"}.
 
@@ -877,6 +883,115 @@ maps_check_loop(Orig,M0,MsM0,Rm0,[K|Ks],[Rk|Rks],Ix) ->
 maps_check_loop(_,_,_,_,[],[],_) -> ok.
 
 
+%% Check that the head optimizations done by the match spec compiler
+%% (fused skips and the tuple pre-filter) do not change any result.
+fused_heads(Config) when is_list(Config) ->
+    erts_debug:set_internal_state(available_internal_state, true),
+    Ref = make_ref(),
+    Objs = [{I, I rem 3, {x, I rem 2, [I]}, a, <<"abc">>, #{k => I rem 2}, 1.5}
+	    || I <- lists:seq(1, 30)] ++
+	[{big, 1 bsl 70, Ref, 2.5},
+	 {a, b},
+	 {1, 2, 3, 4, 5, 6, 7, 8},
+	 {[], [a|b], {}, "str", self(), 1, 2}],
+    Mss = [[{{'_','_','_','_','_','_','_'}, [], ['$_']}],
+	   [{{'$1','_','_','_','_','_','_'}, [], ['$1']}],
+	   [{{'_','_','_','_','_','_','$1'}, [], ['$1']}],
+	   [{{'$1',1,'_','_','_','_','_'}, [], ['$1']}],
+	   [{{'_','_','_',a,'_','_',1.5}, [], ['$_']}],
+	   [{{'$1','_',{x,1,'_'},'_','_','_','_'}, [], ['$1']}],
+	   [{{'$1','_',{'_','_',['$2']},'_','_','_','_'},
+	     [{'>','$2',10}], [{{'$1','$2'}}]}],
+	   [{{'$1','_','_','_',<<"abc">>,#{k => 0},'_'}, [], ['$1']}],
+	   [{{'$1','_','_','_','_',#{k => '$2'},'_'},
+	     [{'=:=','$2',1}], ['$1']}],
+	   [{{'$1','$2','_','_','_','_','_'}, [{'=:=','$1','$2'}], ['$1']}],
+	   [{{'_','_','_','_','_','_','_'}, [], [true]},
+	    {{'_','_'}, [], [false]}],
+	   [{{big,1 bsl 70,Ref,2.5}, [], [found]}],
+	   [{{big,'_','_','$1'}, [], ['$1']}],
+	   [{{'_','_','_','_','_','_','_','$1'}, [], ['$1']}],
+	   [{{'_','_','_','_','_','_','_',9}, [], ['$_']}],
+	   [{{'$1','$1','_','_','_','_','_'}, [], ['$1']}],
+	   [{{[],[a|'_'],{},"str",'_',1,'$1'}, [], ['$1']}],
+	   [{{'_',b}, [], ['$_']}],
+	   [{'$1', [{is_tuple,'$1'}], [{size,'$1'}]}],
+	   [{'_', [], [any]}]],
+    Types = [set, bag, ordered_set],
+    %% The flag must be set before each pass runs, so it is toggled
+    %% in the fun body and not in a generator.
+    Results =
+	lists:map(fun(Flag) ->
+			  _ = ms_fused_heads(Flag),
+			  Flag = ms_fused_heads(Flag),
+			  [fused_heads_run(Type, Ms, Objs) ||
+			      Type <- Types, Ms <- Mss]
+		  end, [true, false]),
+    [Fused, Plain] = Results,
+    Fused = Plain,
+    false = ms_fused_heads(true),
+    erts_debug:set_internal_state(available_internal_state, false),
+    ok.
+
+fused_heads_run(Type, Ms, Objs) ->
+    T = ets:new(fused_heads, [Type]),
+    ets:insert(T, Objs),
+    Sel = lists:sort(ets:select(T, Ms)),
+    Count = ets:select_count(T, [{H,G,[true]} || {H,G,_} <- Ms]),
+    Run = [erlang:match_spec_test(O, Ms, table) || O <- Objs],
+    Ets = ets:match_spec_run(Objs, ets:match_spec_compile(Ms)),
+    ets:delete(T),
+    {Sel, Count, Run, Ets}.
+
+ms_fused_heads(Bool) ->
+    erts_debug:set_internal_state(ms_fused_heads, Bool).
+
+%% Select throughput with and without the match spec head optimizations.
+ms_bench(Config) when is_list(Config) ->
+    erts_debug:set_internal_state(available_internal_state, true),
+    N = 10000,
+    T = ets:new(ms_bench, [set]),
+    ets:insert(T, [{I, I rem 10, {x, I}, a, <<"abc">>} ||
+		      I <- lists:seq(1, N)]),
+    Mss = [{"skip", [{{'$1','_','_','_','_'}, [], ['$1']}]},
+	   {"const", [{{'$1',3,'_','_','_'}, [], ['$1']}]},
+	   {"guard", [{{'$1','$2','_','_','_'}, [{'=:=','$2',3}], ['$1']}]},
+	   {"nomatch", [{{'_',11,'_','_','_'}, [], [true]}]}],
+    _ = [ms_bench_1(T, N, Name, Ms, Fused) ||
+	    {Name, Ms} <- Mss, Fused <- [false, true]],
+    ets:delete(T),
+    true = ms_fused_heads(true),
+    erts_debug:set_internal_state(available_internal_state, false),
+    ok.
+
+ms_bench_1(T, N, Name, Ms, Fused) ->
+    ms_fused_heads(Fused),
+    {Time, Iter} = ms_bench_loop(T, Ms, 1),
+    ObjsPerSec = round(N * Iter * 1000000 / Time),
+    BenchName = case Fused of
+		    true -> "select_" ++ Name ++ "_fused";
+		    false -> "select_" ++ Name
+		end,
+    ct_event:notify(#event{name = benchmark_data,
+			   data = [{suite, "match_spec"},
+				   {name, BenchName},
+				   {value, ObjsPerSec}]}),
+    ok.
+
+%% Run select_count/2 Iter times, doubling Iter until the run takes at
+%% least 0.2 seconds.
+ms_bench_loop(T, Ms, Iter) ->
+    {Time, _} = timer:tc(fun() -> ms_bench_run(T, Ms, Iter) end),
+    if
+	Time >= 200000 -> {Time, Iter};
+	true -> ms_bench_loop(T, Ms, 2*Iter)
+    end.
+
+ms_bench_run(_, _, 0) -> ok;
+ms_bench_run(T, Ms, Iter) ->
+    _ = ets:select_count(T, Ms),
+    ms_bench_run(T, Ms, Iter-1).
+
 empty_list(Config) when is_list(Config) ->
     Val=[{'$1',[], [{message,'$1'},{message,{caller}},{return_trace}]}],
      %% Did crash debug VM in faulty assert:
@@ -20,19 +20,24 @@
 
 -module(message_queue_data_SUITE).
 
--export([all/0, suite/0]).
--export([basic/1, process_info_messages/1, total_heap_size/1]).
+-export([all/0, suite/0, groups/0]).
+-export([basic/1, process_info_messages/1, total_heap_size/1,
+         shards/1, shards_bench/1]).
 
 -export([basic_test/1]).
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
 suite() ->
     [{ct_hooks,[ts_install_cth]},
      {timetrap, {minutes, 2}}].
 
 all() -> 
-    [basic, process_info_messages, total_heap_size].
+    [basic, process_info_messages, total_heap_size, shards].
+
+groups() ->
+    [{mqd_bench, [], [shards_bench]}].
 
 %%
 %%
@@ -186,6 +191,140 @@ total_heap_size(_Config) ->
     ct:log("OffSize = ~p, OffSizeAfter = ~p",[OffSize, OffSizeAfter]),
     true = OffSize == OffSizeAfter.
 
+shards(Config) when is_list(Config) ->
+    Tester = self(),
+    Senders = 50,
+    N = 2000,
+    Recv = fun () ->
+                   receive {go, Pids} -> ok end,
+                   ok = receive_in_order(maps:from_list([{P,1} || P <- Pids]),
+                                         Senders*N),
+                   Tester ! {self(), done}
+           end,
+    %% Messages from each sender arrive in order
+    P1 = spawn_link(fun () ->
+                            false = process_flag(message_queue_shards, true),
+                            true = process_flag(message_queue_shards, true),
+                            Recv()
+                    end),
+    shards_send(P1, Senders, N),
+    receive {P1, done} -> ok end,
+    %% ... also when the flag is switched while messages are arriving
+    P2 = spawn_link(fun () ->
+                            false = process_flag(message_queue_shards, true),
+                            receive after 1 -> ok end,
+                            true = process_flag(message_queue_shards, false),
+                            receive after 1 -> ok end,
+                            false = process_flag(message_queue_shards, true),
+                            Recv()
+                    end),
+    shards_send(P2, Senders, N),
+    receive {P2, done} -> ok end,
+    {'EXIT', {badarg, _}} = (catch process_flag(message_queue_shards, blupp)),
+    false = process_flag(message_queue_shards, false),
+
+    %% Messages are seen by process_info/2 and by a hibernated process
+    P3 = spawn_link(fun () ->
+                            process_flag(message_queue_shards, true),
+                            Tester ! {self(), ready},
+                            receive go -> ok end,
+                            {message_queue_len, 2} =
+                                process_info(self(), message_queue_len),
+                            {messages, [a, b]} = process_info(self(), messages),
+                            erlang:hibernate(?MODULE, shards, [Tester])
+                    end),
+    receive {P3, ready} -> ok end,
+    P3 ! a, P3 ! b, P3 ! go,
+    receive after 100 -> ok end,
+    spawn(fun () -> P3 ! c end),
+    receive {P3, [a, b, c]} -> ok end,
+
+    %% Processes terminating with messages still in the shards
+    Ps = [spawn(fun () ->
+                        process_flag(message_queue_shards, true),
+                        receive stop -> ok end
+                end) || _ <- lists:seq(1, 100)],
+    [spawn(fun () -> [P ! I || I <- lists:seq(1, 100)], P ! stop end)
+     || P <- Ps],
+    [begin
+         M = erlang:monitor(process, P),
+         receive {'DOWN', M, process, P, _} -> ok end
+     end || P <- Ps],
+    ok;
+shards(Tester) when is_pid(Tester) ->
+    %% Woken from hibernation in shards/1 above
+    Tester ! {self(), [receive X -> X end || _ <- [1, 2, 3]]}.
+
+shards_send(To, Senders, N) ->
+    Pids = [spawn_link(fun () ->
+                               receive go -> ok end,
+                               [To ! {self(), I} || I <- lists:seq(1, N)]
+                       end) || _ <- lists:seq(1, Senders)],
+    To ! {go, Pids},
+    [P ! go || P <- Pids],
+    ok.
+
+receive_in_order(_Expect, 0) ->
+    ok;
+receive_in_order(Expect, Left) ->
+    receive
+        {P, I} ->
+            I = maps:get(P, Expect),
+            receive_in_order(Expect#{P := I+1}, Left-1)
+    end.
+
+%% Benchmark of many processes sending to one process, with and
+%% without the message_queue_shards flag, for an increasing number of
+%% schedulers online.
+shards_bench(Config) when is_list(Config) ->
+    Online = erlang:system_info(schedulers_online),
+    Counts = lists:usort([1, Online | [S || S <- [2, 4, 8, 16], S < Online]]),
+    try
+        [shards_bench(Shards, S) || Shards <- [false, true], S <- Counts]
+    after
+        erlang:system_flag(schedulers_online, Online)
+    end,
+    ok.
+
+shards_bench(Shards, Schedulers) ->
+    erlang:system_flag(schedulers_online, Schedulers),
+    Senders = 100,
+    N = 10000,
+    Tester = self(),
+    Recv = spawn_link(fun () ->
+                              process_flag(message_queue_shards, Shards),
+                              receive go -> ok end,
+                              shards_bench_sink(Senders*N),
+                              Tester ! {self(), done}
+                      end),
+    Pids = [spawn_link(fun () ->
+                               receive go -> ok end,
+                               shards_bench_send(Recv, N)
+                       end) || _ <- lists:seq(1, Senders)],
+    T0 = erlang:monotonic_time(),
+    Recv ! go,
+    [P ! go || P <- Pids],
+    receive {Recv, done} -> ok end,
+    T1 = erlang:monotonic_time(),
+    Time = erlang:convert_time_unit(T1 - T0, native, micro_seconds),
+    Name = io_lib:format("~p senders, ~p schedulers, shards ~p",
+                         [Senders, Schedulers, Shards]),
+    ct_event:notify(#event{name = benchmark_data,
+                           data = [{suite, "message_queue_data"},
+                                   {name, lists:flatten(Name)},
+                                   {value, round(Senders*N*1000000 / Time)}]}).
+
+shards_bench_send(_To, 0) ->
+    ok;
+shards_bench_send(To, N) ->
+    To ! N,
+    shards_bench_send(To, N-1).
+
+shards_bench_sink(0) ->
+    ok;
+shards_bench_sink(N) ->
+    receive _ -> shards_bench_sink(N-1) end.
+
 %%
 %%
 %% helpers
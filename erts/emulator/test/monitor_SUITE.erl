@@ -22,13 +22,15 @@
 
 -include_lib("common_test/include/ct.hrl").
 -include_lib("eunit/include/eunit.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
 -export([all/0, suite/0, groups/0,
          case_1/1, case_1a/1, case_2/1, case_2a/1, mon_e_1/1, demon_e_1/1, demon_1/1,
          demon_2/1, demon_3/1, demonitor_flush/1,
          local_remove_monitor/1, remote_remove_monitor/1, mon_1/1, mon_2/1,
          large_exit/1, list_cleanup/1, mixer/1, named_down/1, otp_5827/1,
-         monitor_time_offset/1]).
+         monitor_time_offset/1, many_monitors/1, many_exit_signals/1,
+         down_after_death/1, monitor_throughput/1, down_throughput/1]).
 
 -export([y2/1, g/1, g0/0, g1/0, large_exit_sub/1]).
 
@@ -41,11 +43,13 @@ all() ->
      demon_1, mon_1, mon_2, demon_2, demon_3,
      demonitor_flush, {group, remove_monitor}, large_exit,
      list_cleanup, mixer, named_down, otp_5827,
-     monitor_time_offset].
+     monitor_time_offset, many_monitors, many_exit_signals,
+     down_after_death].
 
 groups() -> 
     [{remove_monitor, [],
-      [local_remove_monitor, remote_remove_monitor]}].
+      [local_remove_monitor, remote_remove_monitor]},
+     {monitor_bench, [], [monitor_throughput, down_throughput]}].
 
 %% A monitors B, B kills A and then exits (yielded core dump)
 case_1(Config) when is_list(Config) ->
@@ -512,6 +516,214 @@ large_exit_sub(S) ->
     receive _X -> ok end,
     exit(S).
 
+%%% Monitor sets large enough to be kept in hash tables, both in the
+%%% monitoring and in the monitored process.
+
+many_monitors(Config) when is_list(Config) ->
+    N = 20000,
+    Ps = [spawn(fun () -> receive _ -> ok end end) || _ <- lists:seq(1, N)],
+    Rs = [{erlang:monitor(process, P), P} || P <- Ps],
+    N = length(monitors_of(self())),
+    {Demon, Keep} = split_alternate(Rs),
+    [true = erlang:demonitor(R, [info]) || {R, _} <- Demon],
+    [false = erlang:demonitor(R, [info]) || {R, _} <- Demon],
+    Left = N - length(Demon),
+    Left = length(monitors_of(self())),
+    [P ! bye || P <- Ps],
+    Downs = lists:sort(Keep),
+    Downs = lists:sort(receive_downs(Left, normal)),
+    expect_no_msg(),
+    [] = monitors_of(self()),
+
+    %% Many monitors on one process
+    T = spawn(fun () -> receive _ -> exit(bye) end end),
+    TRs = [erlang:monitor(process, T) || _ <- lists:seq(1, N)],
+    N = length(monitored_by(T)),
+    {TDemon, TKeep} = split_alternate(TRs),
+    [true = erlang:demonitor(R, [info]) || R <- TDemon],
+    TLeft = length(TKeep),
+    TLeft = length(monitored_by(T)),
+    T ! bye,
+    TDowns = lists:sort([{R, T} || R <- TKeep]),
+    TDowns = lists:sort(receive_downs(TLeft, bye)),
+    expect_no_msg(),
+    ok.
+
+%%% A process with a lot of links and monitors exits; all of them
+%%% should be notified exactly once, also those set up while the
+%%% process is terminating.
+
+many_exit_signals(Config) when is_list(Config) ->
+    Self = self(),
+    NLinks = 5000,
+    NMons = 50000,
+    P = spawn(fun () ->
+                      [spawn_link(fun () ->
+                                          process_flag(trap_exit, true),
+                                          Self ! {linked, self()},
+                                          receive
+                                              {'EXIT', _, Reason} ->
+                                                  Self ! {exit, self(), Reason}
+                                          end
+                                  end) || _ <- lists:seq(1, NLinks)],
+                      receive _ -> ok end
+              end),
+    Ls = [receive {linked, L} -> L end || _ <- lists:seq(1, NLinks)],
+    Rs = [erlang:monitor(process, P) || _ <- lists:seq(1, NMons)],
+    exit(P, bang),
+    Late = late_monitors(P, []),
+    Msgs = [receive M -> M end || _ <- lists:seq(1, NLinks + NMons + length(Late))],
+    Exits = lists:sort(Ls),
+    Exits = lists:sort([L || {exit, L, bang} <- Msgs]),
+    Downs = lists:sort(Rs ++ Late),
+    Downs = lists:sort([R || {'DOWN', R, process, P1, _} <- Msgs, P1 =:= P]),
+    expect_no_msg(),
+    ok.
+
+%%% When 'DOWN' arrives the process is gone; it is not alive, not
+%%% counted, and its slot can be reused. Checked on a node with a full
+%%% process table, both for a process with a single monitor and for
+%%% one with more monitors than are swept in one go.
+
+down_after_death(Config) when is_list(Config) ->
+    Pa = filename:dirname(code:which(?MODULE)),
+    {ok, N} = test_server:start_node(down_after_death, slave,
+                                     [{args, "+P 1024 -pa " ++ Pa}]),
+    Self = self(),
+    Ref = make_ref(),
+    %% Nothing may spawn on the node while it is full, so the test
+    %% runs in one process there and only reports back when done.
+    spawn(N, fun () ->
+                     Self ! {Ref, [down_after_death_test(NMons)
+                                   || NMons <- [1, 20000]]}
+             end),
+    Result = receive {Ref, Res} -> Res end,
+    true = test_server:stop_node(N),
+    [ok, ok] = Result,
+    ok.
+
+down_after_death_test(NMons) ->
+    P = spawn(fun () -> receive _ -> exit(bye) end end),
+    [erlang:monitor(process, P) || _ <- lists:seq(1, NMons)],
+    Fillers = fill_process_table([]),
+    Count = erlang:system_info(process_count),
+    P ! bye,
+    receive {'DOWN', _, process, P, bye} -> ok end,
+    Count = erlang:system_info(process_count) + 1,
+    false = is_process_alive(P),
+    false = lists:member(P, processes()),
+    {Q, _} = spawn_monitor(fun () -> receive _ -> ok end end),
+    [receive {'DOWN', _, process, P, bye} -> ok end
+     || _ <- lists:seq(2, NMons)],
+    exit(Q, kill),
+    [exit(F, kill) || {F, _} <- Fillers],
+    [receive {'DOWN', M, process, F, killed} -> ok end
+     || {F, M} <- Fillers],
+    receive {'DOWN', _, process, Q, killed} -> ok end,
+    expect_no_msg(),
+    ok.
+
+%% Each filler is waiting in receive before the next is spawned, so
+%% that they do not delay anyone once the table is full.
+fill_process_table(Acc) ->
+    Self = self(),
+    try spawn_monitor(fun () -> Self ! {filler, self()},
+                                receive _ -> ok end
+                      end) of
+        {F, _} = FM ->
+            receive {filler, F} -> ok end,
+            fill_process_table([FM | Acc])
+    catch
+        error:system_limit -> Acc
+    end.
+
+late_monitors(P, Acc) ->
+    R = erlang:monitor(process, P),
+    case is_process_alive(P) of
+        true -> late_monitors(P, [R | Acc]);
+        false -> [R | Acc]
+    end.
+
+%% The order of the messages is unspecified, so collect them instead
+%% of receiving each one selectively.
+receive_downs(0, _Reason) ->
+    [];
+receive_downs(N, Reason) ->
+    receive
+        {'DOWN', R, process, P, Reason} ->
+            [{R, P} | receive_downs(N - 1, Reason)]
+    end.
+
+split_alternate(L) ->
+    split_alternate(L, [], []).
+
+split_alternate([A, B | T], As, Bs) ->
+    split_alternate(T, [A | As], [B | Bs]);
+split_alternate([A], As, Bs) ->
+    {[A | As], Bs};
+split_alternate([], As, Bs) ->
+    {As, Bs}.
+
+monitors_of(Pid) ->
+    {monitors, Monitors} = process_info(Pid, monitors),
+    Monitors.
+
+monitored_by(Pid) ->
+    {monitored_by, MonitoredBy} = process_info(Pid, monitored_by),
+    MonitoredBy.
+
+%%% Benchmarks
+
+%% monitor/demonitor pairs done by a process that already has a
+%% large number of monitors.
+monitor_throughput(Config) when is_list(Config) ->
+    Target = spawn(fun () -> receive _ -> ok end end),
+    Base = [erlang:monitor(process, Target) || _ <- lists:seq(1, 200000)],
+    Ops = 1000000,
+    T0 = erlang:monotonic_time(),
+    monitor_demonitor(Target, Ops),
+    T1 = erlang:monotonic_time(),
+    [erlang:demonitor(R) || R <- Base],
+    exit(Target, kill),
+    Time = erlang:convert_time_unit(T1 - T0, native, micro_seconds),
+    PerSec = Ops * 1000000 div max(Time, 1),
+    ct_event:notify(#event{name = benchmark_data,
+                           data = [{suite, "monitor"},
+                                   {name, "monitor_demonitor_per_second"},
+                                   {value, PerSec}]}),
+    {comment, integer_to_list(PerSec) ++ " monitor/demonitor per second"}.
+
+monitor_demonitor(_Target, 0) ->
+    ok;
+monitor_demonitor(Target, N) ->
+    R = erlang:monitor(process, Target),
+    true = erlang:demonitor(R),
+    monitor_demonitor(Target, N - 1).
+
+%% Time from the exit of a process monitored from a large number of
+%% processes until all of them have seen the 'DOWN' message.
+down_throughput(Config) when is_list(Config) ->
+    N = 200000,
+    Self = self(),
+    Target = spawn(fun () -> receive _ -> ok end end),
+    Ws = [spawn(fun () ->
+                        R = erlang:monitor(process, Target),
+                        Self ! {monitoring, self()},
+                        receive {'DOWN', R, _, _, _} -> Self ! {down, self()} end
+                end) || _ <- lists:seq(1, N)],
+    [receive {monitoring, W} -> ok end || W <- Ws],
+    T0 = erlang:monotonic_time(),
+    Target ! die,
+    [receive {down, _} -> ok end || _ <- Ws],
+    T1 = erlang:monotonic_time(),
+    Time = erlang:convert_time_unit(T1 - T0, native, micro_seconds),
+    PerSec = N * 1000000 div max(Time, 1),
+    ct_event:notify(#event{name = benchmark_data,
+                           data = [{suite, "monitor"},
+                                   {name, "down_per_second"},
+                                   {value, PerSec}]}),
+    {comment, integer_to_list(PerSec) ++ " 'DOWN' messages per second"}.
+
 %%% Testing of monitor link list cleanup
 %%% by using erlang:process_info(self(), monitors)
 %%% and      erlang:process_info(self(), monitored_by)
@@ -0,0 +1,180 @@
+%%
+%% %CopyrightBegin%
+%%
+%% Copyright Ericsson AB 2017. All Rights Reserved.
+%%
+%% Licensed under the Apache License, Version 2.0 (the "License");
+%% you may not use this file except in compliance with the License.
+%% You may obtain a copy of the License at
+%%
+%%     http://www.apache.org/licenses/LICENSE-2.0
+%%
+%% Unless required by applicable law or agreed to in writing, software
+%% distributed under the License is distributed on an "AS IS" BASIS,
+%% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+%% See the License for the specific language governing permissions and
+%% limitations under the License.
+%%
+%% %CopyrightEnd%
+%%
+-module(persistent_term_SUITE).
+-export([all/0, suite/0, init_per_testcase/2, end_per_testcase/2,
+	 basic/1, many/1, shared/1, update_while_reading/1,
+	 off_heap_values/1, info/1]).
+-include_lib("common_test/include/ct.hrl").
+
+suite() -> [{ct_hooks,[ts_install_cth]},
+	    {timetrap, {minutes, 2}}].
+
+all() ->
+    [basic, many, shared, update_while_reading, off_heap_values, info].
+
+init_per_testcase(_Case, Config) ->
+    [{keys, [K || {K,_} <- persistent_term:get()]} | Config].
+
+end_per_testcase(_Case, Config) ->
+    Keys = proplists:get_value(keys, Config),
+    [persistent_term:erase(K) || {K,_} <- persistent_term:get(),
+				 not lists:member(K, Keys)],
+    ok.
+
+basic(Config) when is_list(Config) ->
+    Key = {?MODULE, basic},
+    {'EXIT',{badarg,_}} = (catch persistent_term:get(Key)),
+    default = persistent_term:get(Key, default),
+    false = persistent_term:erase(Key),
+
+    ok = persistent_term:put(Key, value),
+    value = persistent_term:get(Key),
+    value = persistent_term:get(Key, default),
+    true = lists:member({Key,value}, persistent_term:get()),
+
+    ok = persistent_term:put(Key, {new,value}),
+    {new,value} = persistent_term:get(Key),
+    ok = persistent_term:put(Key, {new,value}),
+    {new,value} = persistent_term:get(Key),
+
+    %% Keys are compared using exact equality.
+    ok = persistent_term:put({?MODULE, 1}, integer),
+    ok = persistent_term:put({?MODULE, 1.0}, float),
+    integer = persistent_term:get({?MODULE, 1}),
+    float = persistent_term:get({?MODULE, 1.0}),
+
+    true = persistent_term:erase(Key),
+    false = persistent_term:erase(Key),
+    default = persistent_term:get(Key, default),
+    ok.
+
+many(Config) when is_list(Config) ->
+    N = 2000,
+    Keys = [{?MODULE, many, I} || I <- lists:seq(1, N)],
+    [ok = persistent_term:put(K, element(3, K)) || K <- Keys],
+    [I = persistent_term:get(K) || {_,_,I}=K <- Keys],
+    [true = persistent_term:erase(K) || {_,_,I}=K <- Keys, I rem 2 =:= 0],
+    [none = persistent_term:get(K, none) || {_,_,I}=K <- Keys, I rem 2 =:= 0],
+    [I = persistent_term:get(K) || {_,_,I}=K <- Keys, I rem 2 =:= 1],
+    [true = persistent_term:erase(K) || {_,_,I}=K <- Keys, I rem 2 =:= 1],
+    [none = persistent_term:get(K, none) || K <- Keys],
+    ok.
+
+%% Stored terms are not copied by get/1, and stay intact in
+%% processes still referring them after having been replaced.
+shared(Config) when is_list(Config) ->
+    Key = {?MODULE, shared},
+    Big = lists:seq(1, 10000),
+    Sum = lists:sum(Big),
+    ok = persistent_term:put(Key, Big),
+    true = erts_debug:same(persistent_term:get(Key), persistent_term:get(Key)),
+    {heap_size, HeapSz} = process_info(self(), heap_size),
+    true = erts_debug:flat_size(persistent_term:get(Key)) > HeapSz,
+
+    Self = self(),
+    Pids = [spawn_link(fun() ->
+			       L = persistent_term:get(Key),
+			       Self ! {self(), ready},
+			       receive go -> ok end,
+			       erlang:garbage_collect(),
+			       Self ! {self(), lists:sum(L)}
+		       end) || _ <- lists:seq(1, 10)],
+    [receive {P, ready} -> ok end || P <- Pids],
+    Held = persistent_term:get(Key),
+    ok = persistent_term:put(Key, replaced),
+    true = persistent_term:erase(Key),
+    wait_for_release(),
+    [begin P ! go, receive {P, Sum} -> ok end end || P <- Pids],
+    Sum = lists:sum(Held),
+    ok.
+
+update_while_reading(Config) when is_list(Config) ->
+    Key = {?MODULE, update_while_reading},
+    ok = persistent_term:put(Key, {0, lists:seq(0, 999)}),
+    Self = self(),
+    Readers = [spawn_link(fun() -> reader(Key, Self, 0) end)
+	       || _ <- lists:seq(1, 4)],
+    [ok = persistent_term:put(Key, {I, lists:seq(I, I+999)})
+     || I <- lists:seq(1, 2000)],
+    [R ! stop || R <- Readers],
+    [receive {R, done} -> ok end || R <- Readers],
+    true = persistent_term:erase(Key),
+    ok.
+
+reader(Key, Parent, N) ->
+    receive
+	stop ->
+	    Parent ! {self(), done}
+    after 0 ->
+	    {I, L} = persistent_term:get(Key),
+	    I = hd(L),
+	    1000 = length(L),
+	    case N rem 100 of
+		0 -> erlang:garbage_collect();
+		_ -> ok
+	    end,
+	    reader(Key, Parent, N+1)
+    end.
+
+%% Off heap terms such as refc binaries and funs are
+%% kept alive while stored.
+off_heap_values(Config) when is_list(Config) ->
+    Key = {?MODULE, off_heap_values},
+    Bin = list_to_binary(lists:duplicate(1000, 17)),
+    Fun = fun(X) -> X + 1 end,
+    Value = {Bin, Fun, make_ref()},
+    ok = persistent_term:put(Key, Value),
+    erlang:garbage_collect(),
+    Value = persistent_term:get(Key),
+    {Bin2, Fun2, _} = persistent_term:get(Key),
+    Bin = Bin2,
+    2 = Fun2(1),
+    Pid = spawn_link(fun() ->
+			     receive {From, go} ->
+				     {B, F, _} = persistent_term:get(Key),
+				     From ! {self(), byte_size(B), F(2)}
+			     end
+		     end),
+    Pid ! {self(), go},
+    receive {Pid, 1000, 3} -> ok end,
+    true = persistent_term:erase(Key),
+    wait_for_release(),
+    Bin = Bin2,
+    ok.
+
+info(Config) when is_list(Config) ->
+    Info0 = persistent_term:info(),
+    Count0 = proplists:get_value(count, Info0),
+    Mem0 = proplists:get_value(memory, Info0),
+    Key = {?MODULE, info},
+    ok = persistent_term:put(Key, lists:seq(1, 1000)),
+    Info1 = persistent_term:info(),
+    Count1 = Count0 + 1,
+    Count1 = proplists:get_value(count, Info1),
+    true = proplists:get_value(memory, Info1) >=
+	Mem0 + 2000 * erlang:system_info(wordsize),
+    true = persistent_term:erase(Key),
+    Count0 = proplists:get_value(count, persistent_term:info()),
+    ok.
+
+%% The code purger releases replaced terms in the background. Make
+%% sure it has processed what was queued.
+wait_for_release() ->
+    ok = erts_code_purger:release_literal_areas().
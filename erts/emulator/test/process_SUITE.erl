@@ -27,11 +27,13 @@
 %%	register/2 (partially)
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
 -define(heap_binary_size, 64).
 
 -export([all/0, suite/0,groups/0,init_per_suite/1, end_per_suite/1, 
 	 init_per_group/2,end_per_group/2, spawn_with_binaries/1,
+	 spawn_unique_pids/1, spawn_reserved_ids/1, spawn_throughput/1,
 	 t_exit_1/1, t_exit_2_other/1, t_exit_2_other_normal/1,
 	 self_exit/1, normal_suicide_exit/1, abnormal_suicide_exit/1,
 	 t_exit_2_catch/1, trap_exit_badarg/1, trap_exit_badarg_in_bif/1,
@@ -65,6 +67,7 @@
 -export([init_per_testcase/2, end_per_testcase/2]).
 
 -export([hangaround/2, processes_bif_test/0, do_processes/1,
+	 spawn_reserved_ids_test/0,
 	 processes_term_proc_list_test/1]).
 
 suite() ->
@@ -72,7 +75,8 @@ suite() ->
      {timetrap, {minutes, 9}}].
 
 all() -> 
-    [spawn_with_binaries, t_exit_1, {group, t_exit_2},
+    [spawn_with_binaries, spawn_unique_pids, spawn_reserved_ids,
+     t_exit_1, {group, t_exit_2},
      trap_exit_badarg, trap_exit_badarg_in_bif,
      t_process_info, process_info_other, process_info_other_msg,
      process_info_other_dist_msg, process_info_2_list,
@@ -105,7 +109,8 @@ groups() ->
      {system_task, [],
       [no_priority_inversion, no_priority_inversion2,
        system_task_blast, system_task_on_suspended,
-       gc_request_when_gc_disabled, gc_request_blast_when_gc_disabled]}].
+       gc_request_when_gc_disabled, gc_request_blast_when_gc_disabled]},
+     {spawn_bench, [], [spawn_throughput]}].
 
 init_per_suite(Config) ->
     A0 = case application:start(sasl) of
@@ -153,6 +158,105 @@ spawn_with_binaries(Config) when is_list(Config) ->
 binary_owner(Bin) when is_binary(Bin) ->
     ok.
 
+%% Spawn lots of short lived processes from all schedulers at the
+%% same time and check that no pid is handed out twice. Pids are
+%% expected to be reused only after the whole table has been cycled
+%% through a large number of times.
+spawn_unique_pids(Config) when is_list(Config) ->
+    Spawners = erlang:system_info(schedulers_online) + 1,
+    Ids = spawners(Spawners, 40000, fun () -> ok end),
+    Sorted = lists:sort(Ids),
+    Unique = lists:usort(Ids),
+    Total = Spawners * 40000,
+    Total = length(Sorted),
+    Sorted = Unique,
+    ok.
+
+%% A scheduler consuming its reserved allocation ids after other
+%% schedulers have spawned and terminated lots of processes used to
+%% leave holes in the free id ring, making the following exits step
+%% around the whole process table.
+spawn_reserved_ids(Config) when is_list(Config) ->
+    {ok, Node} = start_node(Config, "+P 8000000 +S 4:4"),
+    Times = [rpc:call(Node, ?MODULE, spawn_reserved_ids_test, [])
+             || _ <- lists:seq(1, 3)],
+    stop_node(Node),
+    io:format("Times: ~p us~n", [Times]),
+    true = lists:max(Times) < 50000,
+    ok.
+
+spawn_reserved_ids_test() ->
+    Tester = self(),
+    Holder = spawn_opt(fun () -> reserved_ids_holder(Tester) end,
+                       [link, {scheduler, 2}]),
+    receive {Holder, first} -> ok end,
+    Churner = spawn_opt(fun () ->
+                                _ = spawn_batches(5000, fun () -> ok end, []),
+                                Tester ! {self(), done}
+                        end, [link, {scheduler, 1}]),
+    receive {Churner, done} -> ok end,
+    Holder ! more,
+    Ps = receive {Holder, Ps0} -> Ps0 end,
+    T0 = erlang:monotonic_time(),
+    lists:foreach(fun (P) ->
+                          M = erlang:monitor(process, P),
+                          exit(P, kill),
+                          receive {'DOWN', M, process, P, _} -> ok end
+                  end, Ps),
+    _ = spawn_batches(100, fun () -> ok end, []),
+    T1 = erlang:monotonic_time(),
+    unlink(Holder),
+    exit(Holder, kill),
+    erlang:convert_time_unit(T1 - T0, native, micro_seconds).
+
+%% Spawn one process, which reserves a range of allocation ids on
+%% this scheduler, and the rest of the range when told to.
+reserved_ids_holder(Tester) ->
+    Sleep = fun () -> receive after infinity -> ok end end,
+    P = spawn(Sleep),
+    Tester ! {self(), first},
+    receive more -> ok end,
+    Ps = [spawn(Sleep) || _ <- lists:seq(1, 15)],
+    Tester ! {self(), [P|Ps]},
+    receive after infinity -> ok end.
+
+spawn_throughput(Config) when is_list(Config) ->
+    Spawners = erlang:system_info(schedulers_online),
+    N = 1000000 div Spawners,
+    T0 = erlang:monotonic_time(),
+    _ = spawners(Spawners, N, fun () -> ok end),
+    T1 = erlang:monotonic_time(),
+    Time = erlang:convert_time_unit(T1 - T0, native, micro_seconds),
+    Procs = Spawners * N * 1000000 div max(Time, 1),
+    ct_event:notify(#event{name = benchmark_data,
+                           data = [{suite, "process_spawn"},
+                                   {name, "procs_per_second"},
+                                   {value, Procs}]}),
+    {comment, integer_to_list(Procs) ++ " processes/s"}.
+
+%% Start one spawner per scheduler, each spawning N processes in
+%% batches and waiting for them to terminate. Returns all pids.
+spawners(Spawners, N, Fun) ->
+    Tester = self(),
+    Ps = [spawn_opt(fun () ->
+                            Tester ! {self(), spawn_batches(N, Fun, [])}
+                    end,
+                    [link, {scheduler, (S rem
+                                        erlang:system_info(schedulers_online))
+                            + 1}])
+          || S <- lists:seq(1, Spawners)],
+    lists:append([receive {P, Ids} -> Ids end || P <- Ps]).
+
+spawn_batches(0, _Fun, Acc) ->
+    Acc;
+spawn_batches(N, Fun, Acc0) ->
+    B = min(N, 1000),
+    Ms = [spawn_monitor(Fun) || _ <- lists:seq(1, B)],
+    Acc = lists:foldl(fun ({P, M}, A) ->
+                              receive {'DOWN', M, process, P, _} -> [P|A] end
+                      end, Acc0, Ms),
+    spawn_batches(N - B, Fun, Acc).
+
 %% Tests exit/1 with a big message.
 t_exit_1(Config) when is_list(Config) ->
     ct:timetrap({seconds, 20}),
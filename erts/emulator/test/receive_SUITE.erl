@@ -23,19 +23,22 @@
 %% Tests receive after.
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
--export([all/0, suite/0,
-	 call_with_huge_message_queue/1,receive_in_between/1]).
+-export([all/0, suite/0, groups/0,
+	 call_with_huge_message_queue/1,receive_in_between/1,
+	 ref_with_huge_message_queue/1,ref_receive_bench/1]).
 
 suite() ->
     [{ct_hooks,[ts_install_cth]},
      {timetrap, {minutes, 3}}].
 
 all() -> 
-    [call_with_huge_message_queue, receive_in_between].
+    [call_with_huge_message_queue, receive_in_between,
+     ref_with_huge_message_queue].
 
 groups() -> 
-    [].
+    [{receive_bench, [], [ref_receive_bench]}].
 
 call_with_huge_message_queue(Config) when is_list(Config) ->
     Pid = spawn_link(fun echo_loop/0),
@@ -75,6 +78,97 @@ call(Pid, Msg) ->
 	    exit(Reason)
     end.
 
+%% The reference is not created in the function that receives the
+%% reply, so the recv_mark/recv_set optimization does not apply; the
+%% message queue index should be used instead.
+ref_with_huge_message_queue(Config) when is_list(Config) ->
+    Pid = spawn_link(fun echo_loop/0),
+
+    {Time,ok} = tc(fun() -> ref_calls(10, Pid) end),
+
+    [self() ! {msg,N} || N <- lists:seq(1, 500000)],
+    erlang:garbage_collect(),
+    {NewTime1,ok} = tc(fun() -> ref_calls(10, Pid) end),
+    {NewTime2,ok} = tc(fun() -> ref_calls(10, Pid) end),
+
+    io:format("Time for empty message queue: ~p", [Time]),
+    io:format("Time1 for huge message queue: ~p", [NewTime1]),
+    io:format("Time2 for huge message queue: ~p", [NewTime2]),
+
+    case hd(lists:sort([(NewTime1+1) / (Time+1), (NewTime2+1) / (Time+1)])) of
+	Q when Q < 10 ->
+	    ok;
+	Q ->
+	    ct:fail("Best Q = ~p", [Q])
+    end,
+
+    %% All other messages must still be there, in order.
+    ok = flush_msgs(1, 500000),
+    ok.
+
+ref_calls(0, _) -> ok;
+ref_calls(N, Pid) ->
+    {ok,{ultimate_answer,42}} = ref_call(Pid, {ultimate_answer,42}),
+    ref_calls(N-1, Pid).
+
+ref_call(Pid, Msg) ->
+    Mref = erlang:monitor(process, Pid),
+    Pid ! {Mref,{self(),Msg}},
+    wait_reply(Mref).
+
+wait_reply(Mref) ->
+    receive
+	{Mref,Reply} ->
+	    erlang:demonitor(Mref, [flush]),
+	    {ok,Reply};
+	{'DOWN',Mref,_,_,Reason} ->
+	    exit(Reason)
+    end.
+
+flush_msgs(N, Max) when N > Max ->
+    receive
+	Msg -> {unexpected,Msg}
+    after 0 ->
+	    ok
+    end;
+flush_msgs(N, Max) ->
+    receive
+	{msg,N} -> flush_msgs(N+1, Max)
+    after 0 ->
+	    {missing,N}
+    end.
+
+ref_receive_bench(Config) when is_list(Config) ->
+    Pid = spawn_link(fun echo_loop/0),
+    [ref_receive_bench(Pid, QLen) || QLen <- [0,1000,100000]],
+    unlink(Pid),
+    exit(Pid, kill),
+    ok.
+
+ref_receive_bench(Pid, QLen) ->
+    Calls = 20000,
+    Parent = self(),
+    {Bench,Mref} =
+	spawn_monitor(
+	  fun() ->
+		  [self() ! {msg,N} || N <- lists:seq(1, QLen)],
+		  erlang:garbage_collect(),
+		  ok = ref_calls(10, Pid),
+		  {T,ok} = tc(fun() -> ref_calls(Calls, Pid) end),
+		  Parent ! {self(),T}
+	  end),
+    receive
+	{Bench,Time} ->
+	    receive {'DOWN',Mref,process,Bench,normal} -> ok end,
+	    Name = io_lib:format("ref_receive_~p_msgs", [QLen]),
+	    ct_event:notify(#event{name = benchmark_data,
+				   data = [{suite, "receive"},
+					   {name, lists:flatten(Name)},
+					   {value, round(Calls*1000000 / Time)}]});
+	{'DOWN',Mref,process,Bench,Reason} ->
+	    ct:fail(Reason)
+    end.
+
 receive_in_between(Config) when is_list(Config) ->
     Pid = spawn_link(fun echo_loop/0),
     [{ok,{a,b}} = call2(Pid, {a,b}) || _ <- lists:seq(1, 100000)],
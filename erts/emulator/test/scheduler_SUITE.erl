@@ -32,6 +32,7 @@
 %-define(line_trace, 1).
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
 %-compile(export_all).
 -export([all/0, suite/0, groups/0,
@@ -47,6 +48,8 @@
 	 equal_with_high/1,
 	 equal_with_high_max/1,
 	 bound_process/1,
+	 local_runq_steal/1,
+	 local_runq_bench/1,
 	
 	 scheduler_bind_types/1,
 	 cpu_topology/1,
@@ -68,7 +71,7 @@ all() ->
      equal_with_part_time_max,
      equal_and_high_with_part_time_max, equal_with_high,
      equal_with_high_max,
-     bound_process,
+     bound_process, local_runq_steal,
      {group, scheduler_bind}, scheduler_threads,
      scheduler_suspend_basic, scheduler_suspend,
      dirty_scheduler_threads,
@@ -77,7 +80,8 @@ all() ->
 groups() -> 
     [{scheduler_bind, [],
       [scheduler_bind_types, cpu_topology, update_cpu_info,
-       sct_cmd, sbt_cmd]}].
+       sct_cmd, sbt_cmd]},
+     {scheduler_bench, [], [local_runq_bench]}].
 
 init_per_suite(Config) ->
     Config.
@@ -248,6 +252,69 @@ bound_process(Config) when is_list(Config) ->
             {skipped, "Functionality not supported"}
     end.
 
+%% Processes woken by a running process are pushed onto the
+%% lock-free local run queue of its scheduler; idle schedulers
+%% steal from it. Mix that with priorities, bound processes and
+%% changes of schedulers online and check that everything is run.
+local_runq_steal(Config) when is_list(Config) ->
+    Tester = self(),
+    Schedulers = erlang:system_info(schedulers),
+    ok = runq_burst(2000, normal),
+    ok = runq_burst(1000, low),
+    ok = runq_burst(1000, high),
+    Worker = spawn_link(fun () ->
+                                [ok = runq_burst(1000, normal)
+                                 || _ <- lists:seq(1, 10)],
+                                Tester ! {self(), done}
+                        end),
+    lists:foreach(fun (N) ->
+                          erlang:system_flag(schedulers_online, N),
+                          receive after 10 -> ok end
+                  end,
+                  [1, (Schedulers div 2) + 1, Schedulers]),
+    receive {Worker, done} -> ok end,
+    erlang:system_flag(multi_scheduling, block_normal),
+    ok = runq_burst(500, normal),
+    erlang:system_flag(multi_scheduling, unblock_normal),
+    Bound = [spawn_opt(fun () ->
+                               ok = runq_burst(200, normal),
+                               Tester ! {self(), done}
+                       end,
+                       [link, {scheduler, (I rem Schedulers) + 1}])
+             || I <- lists:seq(1, 4)],
+    [receive {P, done} -> ok end || P <- Bound],
+    ok.
+
+local_runq_bench(Config) when is_list(Config) ->
+    N = 20,
+    T0 = erlang:monotonic_time(),
+    [ok = runq_burst(5000, normal) || _ <- lists:seq(1, N)],
+    T1 = erlang:monotonic_time(),
+    Time = erlang:convert_time_unit(T1 - T0, native, micro_seconds),
+    Procs = 5000 * N * 1000000 div max(Time, 1),
+    ct_event:notify(#event{name = benchmark_data,
+                           data = [{suite, "scheduler_local_runq"},
+                                   {name, "procs_per_second"},
+                                   {value, Procs}]}),
+    {comment, integer_to_list(Procs) ++ " processes/s"}.
+
+runq_burst(N, Prio) ->
+    Tester = self(),
+    Procs = [spawn_opt(fun () ->
+                               runq_yield_loop(50),
+                               Tester ! {self(), done}
+                       end,
+                       [{priority, Prio}])
+             || _ <- lists:seq(1, N)],
+    [receive {P, done} -> ok end || P <- Procs],
+    ok.
+
+runq_yield_loop(0) ->
+    ok;
+runq_yield_loop(N) ->
+    erlang:yield(),
+    runq_yield_loop(N-1).
+
 bound_loop(_, 0, 0, _) ->
     ok;
 bound_loop(NS, 0, M, false) ->
@@ -20,7 +20,7 @@
 
 -module(timer_bif_SUITE).
 
--export([all/0, suite/0, init_per_suite/1, end_per_suite/1,
+-export([all/0, suite/0, groups/0, init_per_suite/1, end_per_suite/1,
 	 init_per_testcase/2,end_per_testcase/2]).
 -export([start_timer_1/1, send_after_1/1, send_after_2/1, send_after_3/1,
 	 cancel_timer_1/1,
@@ -30,9 +30,10 @@
 	 cleanup/1, evil_timers/1, registered_process/1, same_time_yielding/1,
 	 same_time_yielding_with_cancel/1, same_time_yielding_with_cancel_other/1,
 %	 same_time_yielding_with_cancel_other_accessor/1,
-	 auto_cancel_yielding/1]).
+	 auto_cancel_yielding/1, long_timers/1, timer_wheel_bench/1]).
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
 -define(SHORT_TIMEOUT, 5000). %% Bif timers as short as this may be pre-allocated
 -define(TIMEOUT_YIELD_LIMIT, 100).
@@ -68,7 +69,10 @@ all() ->
      same_time_yielding, same_time_yielding_with_cancel,
      same_time_yielding_with_cancel_other,
 %     same_time_yielding_with_cancel_other_accessor,
-     auto_cancel_yielding].
+     auto_cancel_yielding, long_timers].
+
+groups() ->
+    [{timer_bench, [], [timer_wheel_bench]}].
 
 
 %% Basic start_timer/3 functionality
@@ -614,6 +618,71 @@ auto_cancel_yielding(Config) when is_list(Config) ->
     Mem = mem(),
     ok.
 
+%% Timers far beyond the timer wheel, mixed with short ones
+long_timers(Config) when is_list(Config) ->
+    Day = 24*60*60*1000,
+    TOs = [100, 200, 70*1000, 20*60*1000, 90*60*1000,
+           Day, 7*Day, 30*Day, 400*Day],
+    Ts = [{erlang:send_after(TO, self(), {long, TO}), TO}
+          || _ <- lists:seq(1, 100), TO <- TOs],
+    receive after 1 -> ok end,
+    lists:foreach(fun ({R, TO}) when TO > 1000 ->
+                          Left = erlang:read_timer(R),
+                          true = Left =< TO,
+                          true = Left > TO - 1000;
+                      (_) ->
+                          ok
+                  end, Ts),
+    timer:sleep(500),
+    Short = [M || {_, TO} <- Ts, TO < 1000,
+                  M <- [receive {long, TO} = Msg -> Msg after 0 -> none end]],
+    200 = length([M || M <- Short, M /= none]),
+    lists:foreach(fun ({R, TO}) when TO > 1000 ->
+                          Left = erlang:cancel_timer(R),
+                          true = Left =< TO - 500,
+                          true = Left > TO - 2000;
+                      ({R, _}) ->
+                          false = erlang:cancel_timer(R)
+                  end, Ts),
+    empty = get_msg(),
+    ok.
+
+%% Start, cancel and time out a large amount of timers
+timer_wheel_bench(Config) when is_list(Config) ->
+    N = 1000000,
+    Day = 24*60*60*1000,
+    TOs = [10*60*1000 + (I * 7919) rem Day || I <- lists:seq(1, N)],
+    {StartTime, Rs} = timer:tc(fun () ->
+                                       [erlang:send_after(TO, self(), hej)
+                                        || TO <- TOs]
+                               end),
+    {CancelTime, _} = timer:tc(fun () ->
+                                       [erlang:cancel_timer(R, [{info, false}])
+                                        || R <- Rs]
+                               end),
+    {TimeoutTime, ok} = timer:tc(fun () ->
+                                         [erlang:send_after(I rem 1000,
+                                                            self(), hej)
+                                          || I <- lists:seq(1, N)],
+                                         timer_bench_recv(N)
+                                 end),
+    empty = get_msg(),
+    Rates = [{"start_per_second", N * 1000000 div max(StartTime, 1)},
+             {"cancel_per_second", N * 1000000 div max(CancelTime, 1)},
+             {"timeout_per_second", N * 1000000 div max(TimeoutTime, 1)}],
+    lists:foreach(fun ({Name, Value}) ->
+                          ct_event:notify(#event{name = benchmark_data,
+                                                 data = [{suite, "timer_wheel"},
+                                                         {name, Name},
+                                                         {value, Value}]})
+                  end, Rates),
+    {comment, lists:flatten(io_lib:format("~w", [Rates]))}.
+
+timer_bench_recv(0) ->
+    ok;
+timer_bench_recv(N) ->
+    receive hej -> timer_bench_recv(N-1) end.
+
 process_is_cleaned_up(P) when is_pid(P) ->
     undefined == erts_debug:get_internal_state({process_status, P}).
 
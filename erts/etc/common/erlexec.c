@@ -119,6 +119,8 @@ static char *plusM_other_switches[] = {
     "Mscrfsd",
     "Msco",
     "Mscrpm",
+    "Mhp",
+    "Mnb",
     "Ye",
     "Ym",
     "Ytp",
@@ -149,6 +151,7 @@ static char *pluss_val_switches[] = {
 static char *plush_val_switches[] = {
     "ms",
     "mbs",
+    "dgc",
     "pds",
     "max",
     "maxk",
@@ -991,6 +994,16 @@ int main(int argc, char **argv)
 			  i++;
 		      }
 		      break;
+		  case 'I':
+		      if (strcmp(argv[i]+2, "Ot") != 0)
+			  goto the_default;
+		      if (i+1 >= argc)
+			  usage(argv[i]);
+		      argv[i][0] = '-';
+		      add_Eargs(argv[i]);
+		      add_Eargs(argv[i+1]);
+		      i++;
+		      break;
 		  case 'p':
 		      if (argv[i][2] != 'c' || argv[i][3] != '\0')
 			  goto the_default;
@@ -39,6 +39,8 @@
 
 -export([integer_to_list/2]).
 -export([integer_to_binary/2]).
+-export([binary_to_term_stream/0, binary_to_term_stream/1,
+         binary_to_term_feed/2]).
 -export([set_cpu_topology/1, format_cpu_topology/1]).
 -export([await_proc_exit/3]).
 -export([memory/0, memory/1]).
@@ -57,7 +59,7 @@
 -compile({no_auto_import,[spawn_opt/4]}).
 -compile({no_auto_import,[spawn_opt/5]}).
 
--export_type([timestamp/0]).
+-export_type([timestamp/0, binary_to_term_stream/0]).
 -export_type([time_unit/0]).
 
 -type ext_binary() :: binary().
@@ -65,6 +67,9 @@
                       Secs :: non_neg_integer(),
                       MicroSecs :: non_neg_integer()}.
 
+-opaque binary_to_term_stream() ::
+        {'b2t_stream', Handle :: binary()}.
+
 -type time_unit() ::
 	pos_integer()
       | 'seconds'
@@ -93,7 +98,8 @@
 -export([bump_reductions/1, byte_size/1, call_on_load_function/1]).
 -export([cancel_timer/1, cancel_timer/2, check_old_code/1, check_process_code/2,
 	 check_process_code/3, crc32/1]).
--export([crc32/2, crc32_combine/3, date/0, decode_packet/3]).
+-export([crc32/2, crc32_combine/3, crc32c/1, crc32c/2, crc32c_combine/3,
+         date/0, decode_packet/3]).
 -export([delete_element/2]).
 -export([delete_module/1, demonitor/1, demonitor/2, display/1]).
 -export([display_nl/0, display_string/1, dist_exit/3, erase/0, erase/1]).
@@ -519,6 +525,27 @@ crc32(_OldCrc, _Data) ->
 crc32_combine(_FirstCrc, _SecondCrc, _SecondSize) ->
     erlang:nif_error(undefined).
 
+%% crc32c/1
+-spec erlang:crc32c(Data) -> non_neg_integer() when
+      Data :: iodata().
+crc32c(_Data) ->
+    erlang:nif_error(undefined).
+
+%% crc32c/2
+-spec erlang:crc32c(OldCrc, Data) -> non_neg_integer() when
+      OldCrc :: non_neg_integer(),
+      Data :: iodata().
+crc32c(_OldCrc, _Data) ->
+    erlang:nif_error(undefined).
+
+%% crc32c_combine/3
+-spec erlang:crc32c_combine(FirstCrc, SecondCrc, SecondSize) -> non_neg_integer() when
+      FirstCrc :: non_neg_integer(),
+      SecondCrc :: non_neg_integer(),
+      SecondSize :: non_neg_integer().
+crc32c_combine(_FirstCrc, _SecondCrc, _SecondSize) ->
+    erlang:nif_error(undefined).
+
 %% date/0
 -spec date() -> Date when
       Date :: calendar:date().
@@ -2081,6 +2108,9 @@ open_port(PortName, PortSettings) ->
                   (message_queue_data, MQD) -> OldMQD when
       MQD :: message_queue_data(),
       OldMQD :: message_queue_data();
+                  (message_queue_shards, Boolean) -> OldBoolean when
+      Boolean :: boolean(),
+      OldBoolean :: boolean();
                   (priority, Level) -> OldLevel when
       Level :: priority_level(),
       OldLevel :: priority_level();
@@ -2375,6 +2405,7 @@ term_to_binary(_Term) ->
       Term :: term(),
       Options :: [compressed |
                   {compressed, Level :: 0..9} |
+                  {compressed, {lz4, Level :: 0..9}} |
                   {minor_version, Version :: 0..1} ].
 term_to_binary(_Term, _Options) ->
     erlang:nif_error(undefined).
@@ -3327,6 +3358,69 @@ integer_to_binary(I0, Base, R0) ->
         true -> integer_to_binary(I1, Base, R1)
     end.
 
+%% Incremental binary_to_term. The emulator decodes each binary of
+%% the iodata as it is fed, and returns the term when it is complete.
+
+-spec binary_to_term_stream() -> Stream when
+      Stream :: binary_to_term_stream().
+binary_to_term_stream() ->
+    binary_to_term_stream([]).
+
+-spec binary_to_term_stream(Opts) -> Stream when
+      Opts :: ['safe'],
+      Stream :: binary_to_term_stream().
+binary_to_term_stream(Opts) ->
+    case b2t_stream_opts(Opts, false) of
+        badarg -> erlang:error(badarg, [Opts]);
+        Safe -> {b2t_stream, erts_internal:binary_to_term_stream(Safe)}
+    end.
+
+b2t_stream_opts([safe|Opts], _Safe) -> b2t_stream_opts(Opts, true);
+b2t_stream_opts([], Safe) -> Safe;
+b2t_stream_opts(_, _Safe) -> badarg.
+
+-spec binary_to_term_feed(Data, Stream) ->
+                                 {'more', Stream} |
+                                 {'done', Term, Rest} when
+      Data :: iodata(),
+      Stream :: binary_to_term_stream(),
+      Term :: term(),
+      Rest :: binary().
+binary_to_term_feed(Data, {b2t_stream, Handle}=Stream) ->
+    case b2t_feed(Data, [], Handle) of
+        more ->
+            {more, Stream};
+        {done, Term, Rest, Cont} ->
+            {done, Term, b2t_rest(Rest, Cont)};
+        badarg ->
+            erlang:error(badarg, [Data, Stream])
+    end;
+binary_to_term_feed(Data, Stream) ->
+    erlang:error(badarg, [Data, Stream]).
+
+%% Feed the binaries of an iolist one at a time. Cont is what
+%% remains of the enclosing lists.
+b2t_feed(Bin, Cont, Handle) when erlang:is_binary(Bin) ->
+    case erts_internal:binary_to_term_feed(Handle, Bin) of
+        more -> b2t_feed_cont(Cont, Handle);
+        {done, Term, Rest} -> {done, Term, Rest, Cont};
+        badarg -> badarg
+    end;
+b2t_feed([H|T], Cont, Handle) ->
+    b2t_feed(H, [T|Cont], Handle);
+b2t_feed([], Cont, Handle) ->
+    b2t_feed_cont(Cont, Handle);
+b2t_feed(B, Cont, Handle) when erlang:is_integer(B), B >= 0, B =< 255 ->
+    b2t_feed(<<B>>, Cont, Handle);
+b2t_feed(_, _, _) ->
+    badarg.
+
+b2t_feed_cont([Data|Cont], Handle) -> b2t_feed(Data, Cont, Handle);
+b2t_feed_cont([], _Handle) -> more.
+
+b2t_rest(Rest, []) -> Rest;
+b2t_rest(Rest, Cont) -> erlang:iolist_to_binary([Rest|Cont]).
+
 -record(cpu, {node = -1,
 	      processor = -1,
 	      processor_node = -1,
@@ -20,9 +20,10 @@
 -module(erts_code_purger).
 
 %% Purpose : Implement system process erts_code_purger
-%%           to handle code module purging.
+%%           to handle code module purging, and release of
+%%           literal areas not belonging to any module.
 
--export([start/0, purge/1, soft_purge/1]).
+-export([start/0, purge/1, soft_purge/1, release_literal_areas/0]).
 
 -spec start() -> term().
 start() ->
@@ -40,6 +41,13 @@ loop() ->
 	    Res = do_soft_purge(Mod),
 	    From ! {reply, soft_purge, Res, Ref};
 
+	release_literal_areas ->
+	    do_release_literal_areas();
+
+	{release_literal_areas,From,Ref} when is_pid(From) ->
+	    do_release_literal_areas(),
+	    From ! {reply, release_literal_areas, ok, Ref};
+
 	_Other -> ignore
     end,
     loop().
@@ -297,3 +305,74 @@ cpc_init(CpcS, [Pid|Pids], NoReqs) ->
     cpc_init(CpcS, Pids, NoReqs+1).
 
 % end of check_proc_code() implementation.
+
+%% release_literal_areas
+%%  Sent by the runtime system when literal areas not belonging to
+%%  any module, such as objects of ETS tables created with the
+%%  literal_objects option, are no longer used. Make all processes
+%%  copy literals they refer in these areas, and then free them.
+
+%% release_literal_areas()
+%%  Release the literal areas queued so far without waiting for the
+%%  notification from the runtime system, and return when done.
+
+release_literal_areas() ->
+    Ref = make_ref(),
+    erts_code_purger ! {release_literal_areas, self(), Ref},
+    receive
+	{reply, release_literal_areas, Result, Ref} ->
+	    Result
+    end.
+
+do_release_literal_areas() ->
+    case erts_internal:release_literal_areas(true) of
+	false ->
+	    ok;
+	true ->
+	    copy_literals(erlang:processes()),
+	    true = erts_internal:release_literal_areas(false),
+	    do_release_literal_areas()
+    end.
+
+%%
+%% copy_literals(Pids) - Request all processes to copy literals
+%%   in the literal areas being released. As for check_proc_code()
+%%   below, requests not allowing GC are sent to all processes at
+%%   once, and operations aborted due to GC need are restarted
+%%   allowing GC with at most ?MAX_CPC_GC_PROCS at a time.
+%%
+
+copy_literals(Pids) ->
+    Tag = erlang:make_ref(),
+    {priority, Prio} = erlang:process_info(erlang:self(), priority),
+    cla(Tag, Prio, cla_init(Tag, Prio, Pids, 0), 0, []).
+
+cla(_Tag, _Prio, 0, 0, []) ->
+    ok;
+cla(Tag, Prio, NoReq, NoGcReq0, NeedGC0) ->
+    {NoGcReq1, NeedGC1} = case NeedGC0 of
+			      [GcPid|Pids] when NoGcReq0 < ?MAX_CPC_GC_PROCS ->
+				  cla_request(Tag, Prio, GcPid, true),
+				  {NoGcReq0+1, Pids};
+			      _ ->
+				  {NoGcReq0, NeedGC0}
+			  end,
+    receive
+	{copy_literals, {Tag, Pid, false}, aborted} ->
+	    cla(Tag, Prio, NoReq-1, NoGcReq1, [Pid|NeedGC1]);
+	{copy_literals, {Tag, _Pid, false}, _Res} ->
+	    cla(Tag, Prio, NoReq-1, NoGcReq1, NeedGC1);
+	{copy_literals, {Tag, _Pid, true}, _Res} ->
+	    cla(Tag, Prio, NoReq, NoGcReq1-1, NeedGC1)
+    end.
+
+cla_request(Tag, Prio, Pid, AllowGc) ->
+    erts_internal:request_system_task(Pid, Prio,
+				      {copy_literals, {Tag, Pid, AllowGc},
+				       AllowGc}).
+
+cla_init(_Tag, _Prio, [], NoReqs) ->
+    NoReqs;
+cla_init(Tag, Prio, [Pid|Pids], NoReqs) ->
+    cla_request(Tag, Prio, Pid, false),
+    cla_init(Tag, Prio, Pids, NoReqs+1).
@@ -42,6 +42,8 @@
 
 -export([check_process_code/3]).
 -export([copy_literals/2]).
+-export([release_literal_areas/1]).
+-export([binary_to_term_stream/1, binary_to_term_feed/2]).
 -export([purge_module/1]).
 
 -export([flush_monitor_messages/3]).
@@ -204,7 +206,8 @@ port_info(_Result, _Item) ->
 -spec request_system_task(Pid, Prio, Request) -> 'ok' when
       Prio :: 'max' | 'high' | 'normal' | 'low',
       Request :: {'garbage_collect', term()}
-	       | {'check_process_code', term(), module(), non_neg_integer()},
+	       | {'check_process_code', term(), module(), non_neg_integer()}
+	       | {'copy_literals', term(), boolean()},
       Pid :: pid().
 
 request_system_task(_Pid, _Prio, _Request) ->
@@ -281,6 +284,26 @@ cpc_flags(OldFlags, Bit, false) ->
 copy_literals(_Mod, _Bool) ->
     erlang:nif_error(undefined).
 
+-spec release_literal_areas(Bool) -> 'true' | 'false' | 'aborted' when
+      Bool :: boolean().
+release_literal_areas(_Bool) ->
+    erlang:nif_error(undefined).
+
+-spec binary_to_term_stream(Safe) -> Handle when
+      Safe :: boolean(),
+      Handle :: binary().
+binary_to_term_stream(_Safe) ->
+    erlang:nif_error(undefined).
+
+-spec binary_to_term_feed(Handle, Chunk) -> 'more' | 'badarg' |
+                                             {'done', Term, Rest} when
+      Handle :: binary(),
+      Chunk :: binary(),
+      Term :: term(),
+      Rest :: binary().
+binary_to_term_feed(_Handle, _Chunk) ->
+    erlang:nif_error(undefined).
+
 -spec purge_module(Module) -> boolean() when
       Module :: module().
 purge_module(_Module) ->
@@ -584,9 +584,30 @@ write_file(_, _) ->
 %% Returns {error, Reason} | {ok, BytesCopied}
 %sendfile(_,_,_,_,_,_,_,_,_,_) ->
 %    {error, enotsup};
-sendfile(#file_descriptor{module = ?MODULE, data = {Port, _}},
-	 Dest, Offset, Bytes, _ChunkSize, Headers, Trailers,
-	 Flags) ->
+sendfile(#file_descriptor{module = ?MODULE, data = {_, FileFD}} = Fd,
+	 Dest, Offset, Bytes, ChunkSize, Headers, Trailers, Flags) ->
+    IntFlags = translate_sendfile_flags(Flags),
+    case erlang:port_get_data(Dest) of
+	Data when (Data == inet_tcp orelse Data == inet6_tcp),
+		  Headers == [], Trailers == [],
+		  IntFlags band ?EFILE_SENDFILE_USE_THREADS == 0 ->
+	    %% Let the inet driver send straight from the file, in order
+	    %% with any other output queued on the socket.
+	    case prim_inet:sendfile(Dest, FileFD, Offset, Bytes) of
+		{error, enotsup} ->
+		    efile_sendfile(Fd, Dest, Offset, Bytes, ChunkSize,
+				   Headers, Trailers, Flags);
+		Result ->
+		    Result
+	    end;
+	_ ->
+	    efile_sendfile(Fd, Dest, Offset, Bytes, ChunkSize,
+			   Headers, Trailers, Flags)
+    end.
+
+efile_sendfile(#file_descriptor{module = ?MODULE, data = {Port, _}},
+	       Dest, Offset, Bytes, _ChunkSize, Headers, Trailers,
+	       Flags) ->
     case erlang:port_get_data(Dest) of
 	Data when Data == inet_tcp; Data == inet6_tcp ->
 	    ok = inet:lock_socket(Dest,true),
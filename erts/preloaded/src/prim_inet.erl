@@ -31,7 +31,7 @@
 -export([connect/3, connect/4, async_connect/4]).
 -export([accept/1, accept/2, async_accept/2]).
 -export([shutdown/2]).
--export([send/2, send/3, sendto/4, sendmsg/3]).
+-export([send/2, send/3, sendto/4, sendmsg/3, sendfile/4]).
 -export([recv/2, recv/3, async_recv/3]).
 -export([unrecv/2]).
 -export([recvfrom/2, recvfrom/3]).
@@ -143,6 +143,36 @@ shutdown_1(S, How) ->
 	{error,_}=Error -> Error
     end.
 
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%%
+%% SENDFILE(insock(), FileFd, Offset, Length) -> {ok, BytesSent} | {error, Reason}
+%%
+%% Let the driver send Length bytes (0 = until end of file) from the open
+%% file descriptor FileFd, starting at Offset, directly to the socket.
+%% Data queued before the call is sent first.
+%%
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+sendfile(S, FileFd, Offset, Length)
+  when is_port(S), is_integer(FileFd), is_integer(Offset), Offset >= 0,
+       is_integer(Length), Length >= 0 ->
+    case ctl_cmd(S, ?TCP_REQ_SENDFILE,
+		 <<FileFd:32, Offset:64/unsigned, Length:64/unsigned>>) of
+	{ok, []} ->
+	    %% The monitor makes sure we do not wait for a reply from
+	    %% a port that has died, whether we are linked to it or not.
+	    Ref = erlang:monitor(port, S),
+	    receive
+		{sendfile, S, Result} ->
+		    erlang:demonitor(Ref, [flush]),
+		    Result;
+		{'DOWN', Ref, _, _, _} -> {error, closed}
+	    end;
+	{error, _}=Error -> Error
+    end;
+sendfile(_, _, _, _) ->
+    {error, badarg}.
+
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %%
 %% CLOSE(insock()) -> ok
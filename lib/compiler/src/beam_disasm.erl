@@ -1161,6 +1161,12 @@ resolve_inst({get_map_elements,Args0},_,_,_) ->
     List = resolve_args(List0),
     {get_map_elements,FLbl,Src,{list,List}};
 
+%%
+%% OTP 20.
+%%
+resolve_inst({recv_ref,[Src]},_,_,_) ->
+    {recv_ref,resolve_arg(Src)};
+
 %%
 %% Catches instructions that are not yet handled.
 %%
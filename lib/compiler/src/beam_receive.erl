@@ -64,6 +64,30 @@
 %%% We use a reference to a label (i.e. a position in the loaded code)
 %%% as the SomeUniqInteger.
 %%%
+%%% When the reference is not created in the same function, for
+%%% example when it is passed to a helper function or is part of a
+%%% monitor tuple, recv_mark/1 and recv_set/1 cannot be used. If the
+%%% receive statement can still only match out tuples that have a bound
+%%% variable as one of their elements, as in:
+%%%
+%%%    receive
+%%%       {Ref,Reply} -> Reply;
+%%%       {'DOWN',Ref,process,_,Reason} -> exit(Reason)
+%%%    end.
+%%%
+%%% we introduce the instruction:
+%%%
+%%%    recv_ref(Ref),
+%%%    receive
+%%%       ...
+%%%    end.
+%%%
+%%% If Ref is a reference when recv_ref/1 is executed, the runtime
+%%% system looks it up in an index of the message queue (built when
+%%% the message queue is long) and sets the current pointer for the
+%%% message queue to the first message that can contain the reference
+%%% as an element of a tuple. Otherwise the instruction does nothing.
+%%%
 
 module({Mod,Exp,Attr,Fs0,Lc}, _Opts) ->
     Fs = [function(F) || F <- Fs0],
@@ -77,7 +101,7 @@ module({Mod,Exp,Attr,Fs0,Lc}, _Opts) ->
 function({function,Name,Arity,Entry,Is}) ->
     try
 	D = beam_utils:index_labels(Is),
-	{function,Name,Arity,Entry,opt(Is, D, [])}
+	{function,Name,Arity,Entry,opt_index(opt(Is, D, []), D, [])}
     catch
 	Class:Error ->
 	    Stack = erlang:get_stacktrace(),
@@ -341,6 +365,134 @@ opt_ref_used_bl([{set,Ds,Ss,_}|Is], Regs0) ->
     end;
 opt_ref_used_bl([], Regs) -> Regs.
 
+%% opt_index([Instruction], LabelIndex, Acc) -> [Instruction]
+%%  Insert a recv_ref/1 instruction before each receive statement
+%%  not already optimized by recv_set/1 that only matches out
+%%  messages that contain the value of a Y register as an element
+%%  of a tuple.
+
+opt_index([{recv_set,_}=RecvSet,{label,_}=Lbl,{loop_rec,_,_}=Loop|Is],
+	  D, Acc) ->
+    opt_index(Is, D, [Loop,Lbl,RecvSet|Acc]);
+opt_index([{label,_}=Lbl,{loop_rec,{f,Fail},{x,0}}=Loop|Is], D, Acc) ->
+    Cands = index_candidates(Is, []),
+    case [Y || Y <- Cands, opt_ref_in_tuple(Is, Y, Fail, D)] of
+	[Y|_] ->
+	    opt_index(Is, D, [Loop,Lbl,{recv_ref,Y}|Acc]);
+	[] ->
+	    opt_index(Is, D, [Loop,Lbl|Acc])
+    end;
+opt_index([I|Is], D, Acc) ->
+    opt_index(Is, D, [I|Acc]);
+opt_index([], _, Acc) ->
+    reverse(Acc).
+
+%% index_candidates([Instruction], Acc) -> [Register]
+%%  Return the Y registers that are compared to something in the
+%%  body of the receive statement.
+
+index_candidates([{test,is_eq_exact,_,[_,_]=Args}|Is], Acc) ->
+    Ys = [Y || {y,_}=Y <- Args, not lists:member(Y, Acc)],
+    index_candidates(Is, Acc ++ Ys);
+index_candidates([{loop_rec_end,_}|_], Acc) ->
+    Acc;
+index_candidates([_|Is], Acc) ->
+    index_candidates(Is, Acc);
+index_candidates([], Acc) ->
+    Acc.
+
+%% opt_ref_in_tuple([Instruction], Ref, FailLabel, LabelIndex) -> true|false
+%%  Return 'true' if it is certain that only messages that are tuples
+%%  having the value of Ref as an element can be matched out. The
+%%  paths through the receive statement are followed in the same way
+%%  as in opt_ref_used/4, but a comparison is only safe if it is
+%%  between Ref and an element of the message, and Ref must not be
+%%  assigned before the comparison.
+
+opt_ref_in_tuple(Is, Ref, Fail, D) ->
+    Done = gb_sets:singleton(Fail),
+    Regs = {regs_init_x0(),regs_init()},
+    try
+	_ = opt_ref_in_tuple_1(Is, Ref, D, Done, Regs),
+	true
+    catch
+	throw:not_used ->
+	    false
+    end.
+
+opt_ref_in_tuple_1([{block,Bl}|Is], Ref, D, Done, Regs0) ->
+    Regs = opt_ref_in_tuple_bl(Bl, Ref, Regs0),
+    opt_ref_in_tuple_1(Is, Ref, D, Done, Regs);
+opt_ref_in_tuple_1([{test,is_eq_exact,{f,Fail},Args}|Is],
+		   Ref, D, Done0, Regs) ->
+    Done = opt_ref_in_tuple_at(Fail, Ref, D, Done0, Regs),
+    case is_ref_elem_comparison(Args, Ref, Regs) of
+	false -> opt_ref_in_tuple_1(Is, Ref, D, Done, Regs);
+	true -> Done
+    end;
+opt_ref_in_tuple_1([{test,_,{f,Fail},_}|Is], Ref, D, Done0, Regs) ->
+    Done = opt_ref_in_tuple_at(Fail, Ref, D, Done0, Regs),
+    opt_ref_in_tuple_1(Is, Ref, D, Done, Regs);
+opt_ref_in_tuple_1([{select,_,_,{f,Fail},List}|_], Ref, D, Done0, Regs) ->
+    Lbls = [F || {f,F} <- List] ++ [Fail],
+    foldl(fun(L, Done) ->
+		  opt_ref_in_tuple_at(L, Ref, D, Done, Regs)
+	  end, Done0, Lbls);
+opt_ref_in_tuple_1([{label,Lbl}|Is], Ref, D, Done, Regs) ->
+    case gb_sets:is_member(Lbl, Done) of
+	true -> Done;
+	false -> opt_ref_in_tuple_1(Is, Ref, D, Done, Regs)
+    end;
+opt_ref_in_tuple_1([{loop_rec_end,_}|_], _, _, Done, _) ->
+    Done;
+opt_ref_in_tuple_1([_|_], _, _, _, _) ->
+    throw(not_used).
+
+opt_ref_in_tuple_at(Fail, Ref, D, Done0, Regs) ->
+    case gb_sets:is_member(Fail, Done0) of
+	true ->
+	    Done0;
+	false ->
+	    Is = beam_utils:code_at(Fail, D),
+	    Done = opt_ref_in_tuple_1(Is, Ref, D, Done0, Regs),
+	    gb_sets:add(Fail, Done)
+    end.
+
+%% The register sets are the registers holding the message and the
+%% registers holding an element of the message.
+opt_ref_in_tuple_bl([{set,[],[],remove_message}|_], _, _) ->
+    throw(not_used);
+opt_ref_in_tuple_bl([{set,[Ref],_,_}|_], Ref, _) ->
+    throw(not_used);
+opt_ref_in_tuple_bl([{set,[Dst]=Ds,[Src],{get_tuple_element,_}}|Is],
+		    Ref, {Msg,Elems}=Regs0) ->
+    Regs = case regs_is_member(Src, Msg) of
+	       true -> {regs_kill(Ds, Msg),regs_add(Dst, Elems)};
+	       false -> regs_kill_both(Ds, Regs0)
+	   end,
+    opt_ref_in_tuple_bl(Is, Ref, Regs);
+opt_ref_in_tuple_bl([{set,[Dst]=Ds,[Src],move}|Is], Ref, Regs0) ->
+    {Msg,Elems} = regs_kill_both(Ds, Regs0),
+    Regs = case {regs_is_member(Src, Msg),regs_is_member(Src, Elems)} of
+	       {true,_} -> {regs_add(Dst, Msg),Elems};
+	       {_,true} -> {Msg,regs_add(Dst, Elems)};
+	       {false,false} -> {Msg,Elems}
+	   end,
+    opt_ref_in_tuple_bl(Is, Ref, Regs);
+opt_ref_in_tuple_bl([{set,Ds,_,_}|Is], Ref, Regs0) ->
+    case lists:member(Ref, Ds) of
+	true -> throw(not_used);
+	false -> opt_ref_in_tuple_bl(Is, Ref, regs_kill_both(Ds, Regs0))
+    end;
+opt_ref_in_tuple_bl([], _, Regs) -> Regs.
+
+regs_kill_both(Ds, {Msg,Elems}) ->
+    {regs_kill(Ds, Msg),regs_kill(Ds, Elems)}.
+
+is_ref_elem_comparison([R1,R2], Ref, {_,Elems}) ->
+    (R2 =:= Ref andalso regs_is_member(R1, Elems)) orelse
+    (R1 =:= Ref andalso regs_is_member(R2, Elems)).
+
 %%%
 %%% Functions for keeping track of a set of registers.
 %%%
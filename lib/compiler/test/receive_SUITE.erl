@@ -25,7 +25,7 @@
 	 init_per_group/2,end_per_group/2,
 	 init_per_testcase/2,end_per_testcase/2,
 	 export/1,recv/1,coverage/1,otp_7980/1,ref_opt/1,
-	 wait/1]).
+	 ref_index/1,wait/1]).
 
 -include_lib("common_test/include/ct.hrl").
 
@@ -45,7 +45,7 @@ all() ->
 
 groups() -> 
     [{p,test_lib:parallel(),
-      [recv,coverage,otp_7980,ref_opt,export,wait]}].
+      [recv,coverage,otp_7980,ref_opt,ref_index,export,wait]}].
 
 
 init_per_suite(Config) ->
@@ -260,6 +260,69 @@ cover_recv_instructions() ->
 	Ref -> ok
     end.
 
+ref_index(Config) when is_list(Config) ->
+    case ?MODULE of
+	receive_SUITE -> ref_index_1();
+	_ -> {skip,"Enough to run this case once."}
+    end.
+
+ref_index_1() ->
+    %% Only the receive statements that can only match out tuples
+    %% containing the bound reference should use the message queue
+    %% index.
+    {beam_file,?MODULE,_,_,_,Code} = beam_disasm:file(code:which(?MODULE)),
+    [_] = recv_ref_instrs(ref_index_wait, Code),
+    [_] = recv_ref_instrs(ref_index_nested, Code),
+    [] = recv_ref_instrs(ref_index_any, Code),
+
+    %% Receive messages by reference from a long message queue.
+    {Pid,Mref} =
+	spawn_monitor(
+	  fun() ->
+		  Refs = [make_ref() || _ <- lists:seq(1, 1000)],
+		  Seq = lists:seq(1, 1000),
+		  [self() ! {other,I} || I <- Seq],
+		  [self() ! {R,I} || {R,I} <- lists:zip(Refs, Seq)],
+		  [self() ! {'DOWN',R,x,y,I} || {R,I} <- lists:zip(Refs, Seq)],
+		  RevSeq = lists:reverse(Seq),
+		  RevSeq = [ref_index_wait(R) || R <- lists:reverse(Refs)],
+		  NegSeq = [-I || I <- Seq],
+		  NegSeq = [ref_index_wait(R) || R <- Refs],
+		  timeout = ref_index_wait(make_ref()),
+		  Ref = make_ref(),
+		  self() ! {Ref,{reply,done}},
+		  done = ref_index_nested(Ref),
+		  {other,1} = ref_index_any(make_ref()),
+		  exit(ok)
+	  end),
+    receive
+	{'DOWN',Mref,process,Pid,Reason} ->
+	    ok = Reason
+    end.
+
+recv_ref_instrs(Name, Code) ->
+    [I || {function,N,1,_,Is} <- Code, N =:= Name,
+	  {recv_ref,_}=I <- Is].
+
+ref_index_wait(Ref) ->
+    receive
+	{Ref,Reply} -> Reply;
+	{'DOWN',Ref,_,_,Reason} -> -Reason
+    after 0 ->
+	    timeout
+    end.
+
+ref_index_nested(Ref) ->
+    receive
+	{Ref,{reply,Reply}} -> Reply
+    end.
+
+ref_index_any(Ref) ->
+    receive
+	{Ref,Reply} -> Reply;
+	Other -> Other
+    end.
+
 export(Config) when is_list(Config) ->
     Ref = make_ref(),
     self() ! {result,Ref,42},
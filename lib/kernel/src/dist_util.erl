@@ -119,7 +119,8 @@ make_this_flags(RequestType, OtherNode) ->
 	 ?DFLAG_SMALL_ATOM_TAGS bor
 	 ?DFLAG_UTF8_ATOMS bor
 	 ?DFLAG_MAP_TAG bor
-	 ?DFLAG_BIG_CREATION).
+	 ?DFLAG_BIG_CREATION bor
+	 ?DFLAG_FRAGMENTS).
 
 handshake_other_started(#hs_data{request_type=ReqType}=HSData0) ->
     {PreOtherFlags,Node,Version} = recv_name(HSData0),
@@ -0,0 +1 @@
+{groups,"../kernel_test",pdict_SUITE,[pdict_bench]}.
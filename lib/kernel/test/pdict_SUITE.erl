@@ -21,6 +21,7 @@
 
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
 -define(M(A,B),m(A,B,?MODULE,?LINE)).
 -ifdef(DEBUG).
@@ -31,7 +32,7 @@
 
 -export([all/0, suite/0,groups/0,init_per_suite/1, end_per_suite/1, 
 	 init_per_group/2,end_per_group/2,
-	 mixed/1,
+	 mixed/1, colliding/1, pdict_bench/1,
 	 simple/1, complicated/1, heavy/1, simple_all_keys/1, info/1]).
 -export([init_per_testcase/2, end_per_testcase/2]).
 -export([other_process/2]).
@@ -48,10 +49,10 @@ suite() ->
 
 all() -> 
     [simple, complicated, heavy, simple_all_keys, info,
-     mixed].
+     mixed, colliding].
 
 groups() -> 
-    [].
+    [{pdict_bench, [], [pdict_bench]}].
 
 init_per_suite(Config) ->
     Config.
@@ -418,3 +419,115 @@ do_mixed([GoalN | _]=Goals, CurrN, Array0, C, Rand0) ->
 	    Array2 = array:resize(CurrN-1, Array1),
 	    do_mixed(Goals, CurrN-1, Array2, C+1, Rand2)
     end.
+
+
+%% Put and erase keys that hash to the same or neighbouring slots, in
+%% random order, comparing with a map after each operation.
+colliding(_Config) ->
+    Rand0 = rand:seed_s(exsplus),
+    io:format("Random seed = ~p\n\n", [rand:export_seed_s(Rand0)]),
+    erase(),
+    Keys = [N bsl 32 || N <- lists:seq(0, 99)] ++
+	[N bsl 16 || N <- lists:seq(0, 99)] ++
+	lists:seq(1, 100) ++
+	[{N} || N <- lists:seq(1, 100)] ++
+	[[N|N] || N <- lists:seq(1, 100)] ++
+	[(1 bsl 70) + N || N <- lists:seq(1, 100)] ++
+	[float(N) || N <- lists:seq(1, 100)],
+    KeyTup = list_to_tuple(Keys),
+    erts_debug:set_internal_state(available_internal_state, true),
+    try
+	Map = do_colliding(20000, KeyTup, #{}, Rand0),
+	Sorted = exact_sort(maps:to_list(Map)),
+	Sorted = exact_sort(get()),
+	Sorted = exact_sort(erase()),
+	[] = get()
+    after
+	erts_debug:set_internal_state(available_internal_state, false)
+    end,
+    ok.
+
+do_colliding(0, _, Map, _) ->
+    Map;
+do_colliding(N, KeyTup, Map, Rand0) ->
+    {Ix, Rand1} = rand:uniform_s(tuple_size(KeyTup), Rand0),
+    Key = element(Ix, KeyTup),
+    {R, Rand2} = rand:uniform_s(100, Rand1),
+    Old = maps:get(Key, Map, undefined),
+    %% provoke GC in put
+    erts_debug:set_internal_state(fill_heap, true),
+    Map1 = case R of
+	       _ when R =< 60 ->
+		   Old = put(Key, N),
+		   N = get(Key),
+		   Map#{Key => N};
+	       _ ->
+		   Old = erase(Key),
+		   undefined = get(Key),
+		   maps:remove(Key, Map)
+	   end,
+    case N rem 1000 of
+	0 ->
+	    Sorted = exact_sort(maps:keys(Map1)),
+	    Sorted = exact_sort(get_keys()),
+	    WithN = exact_sort([K || {K,V} <- maps:to_list(Map1), V =:= N]),
+	    WithN = exact_sort(get_keys(N));
+	_ ->
+	    ok
+    end,
+    do_colliding(N-1, KeyTup, Map1, Rand2).
+
+%% Sort keys that compare equal but do not match, such as 1 and 1.0,
+%% in a fixed order.
+exact_sort(L) ->
+    [binary_to_term(B) || B <- lists:sort([term_to_binary(T) || T <- L])].
+
+%% Measure get/put/erase throughput on dictionaries of a few sizes.
+pdict_bench(_Config) ->
+    Res = [bench_size(Size) || Size <- [10, 1000, 100000]],
+    {comment, lists:flatten([io_lib:format("~s ~w: ~w ops/ms; ",
+					   [Op, Size, Ops])
+			     || L <- Res, {Op, Size, Ops} <- L])}.
+
+bench_size(Size) ->
+    Parent = self(),
+    Pid = spawn_link(fun() -> Parent ! {self(), bench_ops(Size)} end),
+    receive {Pid, Res} -> Res end.
+
+bench_ops(Size) ->
+    Keys = [{key, N} || N <- lists:seq(1, Size)],
+    Rounds = max(1, 1000000 div Size),
+    _ = [put(K, 0) || K <- Keys],
+    Put = fun(K) -> put(K, K) end,
+    Get = fun(K) -> get(K) end,
+    Erase = fun(K) -> erase(K), put(K, 0) end,
+    [bench_op(Op, Keys, Rounds, F)
+     || {Op, F} <- [{put, Put}, {get, Get}, {"erase+put", Erase}]].
+
+bench_op(Op, Keys, Rounds, F) ->
+    Size = length(Keys),
+    garbage_collect(),
+    T0 = erlang:monotonic_time(),
+    bench_loop(Rounds, Keys, F),
+    T1 = erlang:monotonic_time(),
+    Ms = max(1, erlang:convert_time_unit(T1 - T0, native, milli_seconds)),
+    Ops = (Rounds * Size) div Ms,
+    ct_event:notify(#event{name = benchmark_data,
+			   data = [{suite, "pdict"},
+				   {name, lists:flatten(
+					    io_lib:format("~s ~w keys ops/ms",
+							  [Op, Size]))},
+				   {value, Ops}]}),
+    {Op, Size, Ops}.
+
+bench_loop(0, _, _) ->
+    ok;
+bench_loop(N, Keys, F) ->
+    bench_loop_1(Keys, F),
+    bench_loop(N - 1, Keys, F).
+
+bench_loop_1([K|Ks], F) ->
+    _ = F(K),
+    bench_loop_1(Ks, F);
+bench_loop_1([], _) ->
+    ok.
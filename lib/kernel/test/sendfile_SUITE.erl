@@ -40,6 +40,7 @@ tcs() ->
      ,t_sendfile_partial
      ,t_sendfile_offset
      ,t_sendfile_sendafter
+     ,t_sendfile_queued
      ,t_sendfile_recvafter
      ,t_sendfile_recvafter_remoteclose
      ,t_sendfile_sendduring
@@ -244,6 +245,26 @@ t_sendfile_sendafter(Config) ->
 
     ok = sendfile_send(Send).
 
+%% Check that data queued in the socket before and after the call is
+%% kept in order around the file contents. This is only guaranteed
+%% when the inet driver does the sending, i.e. without use_threads.
+t_sendfile_queued(Config) ->
+    Filename = proplists:get_value(small_file, Config),
+    SendfileOpts = [],
+
+    Send = fun(Sock) ->
+		   {Size, Data} = sendfile_file_info(Filename),
+		   ok = inet:setopts(Sock, [{sndbuf, 4096}]),
+		   Before = binary:copy(<<"before">>, 100000),
+		   ok = gen_tcp:send(Sock, Before),
+		   {ok, Size} = sendfile(Filename, Sock, SendfileOpts),
+		   ok = gen_tcp:send(Sock, <<"after">>),
+		   {ok, Size} = sendfile(Filename, Sock, SendfileOpts),
+		   <<Before/binary,Data/binary,"after",Data/binary>>
+	   end,
+
+    ok = sendfile_send(Send).
+
 t_sendfile_recvafter(Config) ->
     Filename = proplists:get_value(small_file, Config),
     SendfileOpts = proplists:get_value(sendfile_opts, Config),
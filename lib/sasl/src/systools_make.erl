@@ -1492,8 +1492,8 @@ preloaded() ->
     %% Sorted
     [erl_prim_loader,erl_tracer,erlang,
      erts_code_purger,
-     erts_internal,init,otp_ring0,prim_eval,prim_file,
-     prim_inet,prim_zip,zlib].
+     erts_internal,init,otp_ring0,persistent_term,
+     prim_eval,prim_file,prim_inet,prim_zip,zlib].
 
 %%______________________________________________________________________
 %% Kernel processes; processes that are specially treated by the init
@@ -137,7 +137,8 @@ give_away(_, _, _) ->
                  | {size, non_neg_integer()}
                  | {type, type()}
 		 | {write_concurrency, boolean()}
-		 | {read_concurrency, boolean()}.
+		 | {read_concurrency, boolean()}
+		 | {decentralized_counters, boolean()}.
 
 info(_) ->
     erlang:nif_error(undef).
@@ -147,7 +148,8 @@ info(_) ->
       Item :: compressed | fixed | heir | keypos | memory
             | name | named_table | node | owner | protection
             | safe_fixed | safe_fixed_monotonic_time | size | stats | type
-	    | write_concurrency | read_concurrency,
+	    | write_concurrency | read_concurrency
+	    | decentralized_counters,
       Value :: term().
 
 info(_, _) ->
@@ -281,7 +283,9 @@ member(_, _) ->
       Access :: access(),
       Tweaks :: {write_concurrency, boolean()}
               | {read_concurrency, boolean()}
-              | compressed,
+              | {decentralized_counters, boolean()}
+              | compressed
+              | literal_objects,
       Pos :: pos_integer(),
       HeirData :: term().
 
@@ -1329,10 +1333,14 @@ create_tab(I, TabArg) ->
 	     {read_concurrency, _}=Rcc -> [Rcc | L4];
 	     false -> L4
 	 end,
+    L6 = case lists:keyfind(decentralized_counters, 1, I) of
+	     {decentralized_counters, _}=Dc -> [Dc | L5];
+	     false -> L5
+	 end,
     case TabArg of
         [] ->
 	    try
-		Tab = ets:new(Name, L5),
+		Tab = ets:new(Name, L6),
 		{ok, Tab, Sz}
 	    catch _:_ ->
 		throw(cannot_create_table)
@@ -20,7 +20,7 @@
 -module(re).
 -export([grun/3,urun/3,ucompile/2,replace/3,replace/4,split/2,split/3]).
 
--type mp() :: {re_pattern, _, _, _, _}.
+-type mp() :: {re_pattern, _, _, _, _} | {re_pattern, _, _, _, _, _}.
 
 -type nl_spec() :: cr | crlf | lf | anycrlf | any.
 
@@ -29,7 +29,7 @@
                         | no_auto_capture | dupnames | ungreedy
                         | {newline, nl_spec()}
                         | bsr_anycrlf | bsr_unicode
-                        | no_start_optimize | ucp | never_utf.
+                        | no_start_optimize | ucp | never_utf | jit.
 
 %%% BIFs
 
@@ -95,9 +95,9 @@ run(_, _) ->
 run(_, _, _) ->
     erlang:nif_error(undef).
 
--spec inspect(MP,Item) -> {namelist, [ binary() ]} when
+-spec inspect(MP,Item) -> {namelist, [ binary() ]} | {jit, boolean()} when
       MP :: mp(),
-      Item :: namelist.
+      Item :: namelist | jit.
 
 inspect(_,_) ->
     erlang:nif_error(undef).
@@ -284,8 +284,8 @@ extend_subpatterns([],N) ->
 extend_subpatterns([H|T],N) ->
     [H | extend_subpatterns(T,N-1)].
 
-compile_split({re_pattern,N,_,_,_} = Comp, Options) ->
-    {Comp,N,Options};
+compile_split(Comp, Options) when element(1, Comp) =:= re_pattern ->
+    {Comp,element(2, Comp),Options};
 compile_split(Pat,Options0) when not is_tuple(Pat) ->
     Options = lists:filter(fun(O) ->
 				   (not runopt(O))
@@ -293,7 +293,8 @@ compile_split(Pat,Options0) when not is_tuple(Pat) ->
     case re:compile(Pat,Options) of
 	{error,Err} ->
 	    {error,Err};
-	{ok, {re_pattern,N,_,_,_} = Comp} ->
+	{ok, Comp} ->
+	    N = element(2, Comp),
 	    NewOpt = lists:filter(fun(OO) -> (not copt(OO)) end, Options0),
 	    {Comp,N,NewOpt}
     end;
@@ -506,17 +507,13 @@ do_replace(Subject,Repl,SubExprs0) ->
       end || Part <- Repl ].
 
 
-check_for_unicode({re_pattern,_,1,_,_},_) ->
-    true;
-check_for_unicode({re_pattern,_,0,_,_},_) ->
-    false;
+check_for_unicode(MP,_) when element(1, MP) =:= re_pattern ->
+    element(3, MP) =:= 1;
 check_for_unicode(_,L) ->
     lists:member(unicode,L).
 
-check_for_crlf({re_pattern,_,_,1,_},_) ->
-    true;
-check_for_crlf({re_pattern,_,_,0,_},_) ->
-    false;
+check_for_crlf(MP,_) when element(1, MP) =:= re_pattern ->
+    element(4, MP) =:= 1;
 check_for_crlf(_,L) ->
     case lists:keysearch(newline,1,L) of
 	{value,{newline,any}} -> true;
@@ -702,7 +699,7 @@ urun2(Subject0,RE0,Options0) ->
     RE = case RE0 of
 	     BinRE when is_binary(BinRE) ->
 		 BinRE;
-	     {re_pattern,_,_,_,_} = ReCompiled ->
+	     ReCompiled when element(1, ReCompiled) =:= re_pattern ->
 		 ReCompiled;
 	     ListRE ->
 		 unicode:characters_to_binary(ListRE,unicode)
@@ -862,6 +859,8 @@ copt(ungreedy) ->
     true;
 copt(unicode) ->
     true;
+copt(jit) ->
+    true;
 copt(_) ->
     false.
 
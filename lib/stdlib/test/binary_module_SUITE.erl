@@ -19,14 +19,16 @@
 %%
 -module(binary_module_SUITE).
 
--export([all/0, suite/0,
+-export([all/0, suite/0, groups/0,
 	 interesting/1,scope_return/1,random_ref_comp/1,random_ref_sr_comp/1,
 	 random_ref_fla_comp/1,parts/1, bin_to_list/1, list_to_bin/1,
-	 copy/1, referenced/1,guard/1,encode_decode/1,badargs/1,longest_common_trap/1]).
+	 copy/1, referenced/1,guard/1,encode_decode/1,badargs/1,longest_common_trap/1,
+	 scan_search/1, split_bench/1]).
 
 -export([random_number/1, make_unaligned/1]).
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
 suite() ->
     [{ct_hooks,[ts_install_cth]},
@@ -36,7 +38,10 @@ all() ->
     [scope_return,interesting, random_ref_fla_comp, random_ref_sr_comp,
      random_ref_comp, parts, bin_to_list, list_to_bin, copy,
      referenced, guard, encode_decode, badargs,
-     longest_common_trap].
+     longest_common_trap, scan_search].
+
+groups() ->
+    [{binary_bench, [], [split_bench]}].
 
 
 -define(MASK_ERROR(EXPR),mask_error((catch (EXPR)))).
@@ -316,6 +321,86 @@ longest_common_trap(Config) when is_list(Config) ->
     erts_debug:set_internal_state(available_internal_state,false),
     ok.
 
+%% Compare the scanning search paths for short patterns, and for
+%% multiple patterns with few distinct first bytes, with the reference
+%% implementation, both with and without trapping.
+scan_search(Config) when is_list(Config) ->
+    rand:seed(exsplus, {1,2,3}),
+    Alpha = "abc\r\n",
+    Str = fun(N) ->
+		  list_to_binary([lists:nth(rand:uniform(length(Alpha)), Alpha)
+				  || _ <- lists:seq(1, N)])
+	  end,
+    Subj = Str(3000),
+    Subjects = [Subj | [binary:part(Subj, 0, N) || N <- lists:seq(0, 40)]],
+    Patterns = [Str(N) || N <- lists:seq(1, 20), _ <- [1,2,3]] ++
+	[[<<"\n">>,<<"\r\n">>],
+	 [<<"ab">>,<<"ba">>,<<"c">>],
+	 [<<"aab">>,<<"ab">>,<<"b\r">>],
+	 [<<"\r">>,<<"\r\na">>,<<"\r\nab">>],
+	 [<<I>> || I <- lists:seq($a, $k)] ++ [<<"\r\n">>]],
+    scan_search_1(Subjects, Patterns),
+    erts_debug:set_internal_state(available_internal_state,true),
+    io:format("oldlimit: ~p~n",
+	      [erts_debug:set_internal_state(binary_loop_limit,10)]),
+    scan_search_1([Subj], Patterns),
+    io:format("limit was: ~p~n",
+	      [erts_debug:set_internal_state(binary_loop_limit,
+					     default)]),
+    erts_debug:set_internal_state(available_internal_state,false),
+    ok.
+
+scan_search_1(Subjects, Patterns) ->
+    [begin
+	 Res = binref:matches(S, P),
+	 Res = binary:matches(S, P),
+	 Res = binary:matches(make_unaligned(S), binary:compile_pattern(P)),
+	 [begin
+	      Scope = {Start, byte_size(S) - Start},
+	      ScopeRes = binref:matches(S, P, [{scope, Scope}]),
+	      ScopeRes = binary:matches(S, P, [{scope, Scope}]),
+	      First = binref:match(S, P, [{scope, Scope}]),
+	      First = binary:match(S, P, [{scope, Scope}])
+	  end || Start <- lists:seq(0, min(3, byte_size(S)))],
+	 Split = binref:split(S, P, [global]),
+	 Split = binary:split(S, P, [global])
+     end || S <- Subjects, P <- Patterns],
+    ok.
+
+%% Measure the throughput of splitting a large log-like binary into
+%% lines and of searching it for a word.
+split_bench(Config) when is_list(Config) ->
+    rand:seed(exsplus, {1,2,3}),
+    Line = fun(Sep) ->
+		   Len = 40 + rand:uniform(80),
+		   [[$a + rand:uniform(26) - 1 || _ <- lists:seq(1, Len)], Sep]
+	   end,
+    LF = iolist_to_binary([Line("\n") || _ <- lists:seq(1, 50000)]),
+    CRLF = iolist_to_binary([Line("\r\n") || _ <- lists:seq(1, 50000)]),
+    Cases = [{"split LF", LF, fun(B) -> binary:split(B, <<"\n">>, [global]) end},
+	     {"split CRLF", CRLF,
+	      fun(B) -> binary:split(B, <<"\r\n">>, [global]) end},
+	     {"split LF|CRLF", CRLF,
+	      fun(B) -> binary:split(B, [<<"\r\n">>,<<"\n">>], [global]) end},
+	     {"matches word", LF,
+	      fun(B) -> binary:matches(B, <<"error">>) end}],
+    Res = [split_bench_1(Name, Bin, F) || {Name, Bin, F} <- Cases],
+    {comment, lists:flatten([io_lib:format("~s: ~w MB/s; ", [N, V])
+			     || {N, V} <- Res])}.
+
+split_bench_1(Name, Bin, F) ->
+    N = 20,
+    T0 = erlang:monotonic_time(),
+    _ = [F(Bin) || _ <- lists:seq(1, N)],
+    T1 = erlang:monotonic_time(),
+    Us = max(1, erlang:convert_time_unit(T1 - T0, native, micro_seconds)),
+    MBs = (N * byte_size(Bin)) div Us,
+    ct_event:notify(#event{name = benchmark_data,
+			   data = [{suite, "binary_module"},
+				   {name, Name ++ " MB/s"},
+				   {value, MBs}]}),
+    {Name, MBs}.
+
 subj() ->
     Me = self(),
     spawn(fun() ->
@@ -66,12 +66,15 @@
 	 meta_lookup_named_read/1, meta_lookup_named_write/1,
 	 meta_newdel_unnamed/1, meta_newdel_named/1]).
 -export([smp_insert/1, smp_fixed_delete/1, smp_unfix_fix/1, smp_select_delete/1,
+         smp_ordered_set/1,
          otp_8166/1, otp_8732/1]).
 -export([exit_large_table_owner/1,
 	 exit_many_large_table_owner/1,
 	 exit_many_tables_owner/1,
 	 exit_many_many_tables_owner/1]).
--export([write_concurrency/1, heir/1, give_away/1, setopts/1]).
+-export([write_concurrency/1, decentralized_counters/1,
+         literal_objects/1,
+         heir/1, give_away/1, setopts/1]).
 -export([bad_table/1, types/1]).
 -export([otp_9932/1]).
 -export([otp_9423/1]).
@@ -149,9 +152,11 @@ all() ->
      otp_8732, meta_wb, grow_shrink, grow_pseudo_deleted,
      shrink_pseudo_deleted, {group, meta_smp}, smp_insert,
      smp_fixed_delete, smp_unfix_fix, smp_select_delete,
+     smp_ordered_set,
      otp_8166, exit_large_table_owner,
      exit_many_large_table_owner, exit_many_tables_owner,
-     exit_many_many_tables_owner, write_concurrency, heir,
+     exit_many_many_tables_owner, write_concurrency,
+     decentralized_counters, literal_objects, heir,
      give_away, setopts, bad_table, types,
      otp_10182,
      otp_9932,
@@ -2063,17 +2068,19 @@ write_concurrency(Config) when is_list(Config) ->
     Yes6 = ets_new(foo,[duplicate_bag,protected,{write_concurrency,true}]),
     No3 = ets_new(foo,[duplicate_bag,private,{write_concurrency,true}]),
 
-    No4 = ets_new(foo,[ordered_set,public,{write_concurrency,true}]),
-    No5 = ets_new(foo,[ordered_set,protected,{write_concurrency,true}]),
-    No6 = ets_new(foo,[ordered_set,private,{write_concurrency,true}]),
+    Yes7 = ets_new(foo,[ordered_set,public,{write_concurrency,true}]),
+    Yes8 = ets_new(foo,[ordered_set,protected,{write_concurrency,true}]),
+    No4 = ets_new(foo,[ordered_set,private,{write_concurrency,true}]),
 
     No7 = ets_new(foo,[public,{write_concurrency,false}]),
     No8 = ets_new(foo,[protected,{write_concurrency,false}]),
 
     YesMem = ets:info(Yes1,memory),
     NoHashMem = ets:info(No1,memory),
+    YesTreeMem = ets:info(Yes7,memory),
     NoTreeMem = ets:info(No4,memory),
-    io:format("YesMem=~p NoHashMem=~p NoTreeMem=~p\n",[YesMem,NoHashMem,NoTreeMem]),
+    io:format("YesMem=~p NoHashMem=~p YesTreeMem=~p NoTreeMem=~p\n",
+              [YesMem,NoHashMem,YesTreeMem,NoTreeMem]),
 
     YesMem = ets:info(Yes2,memory),
     YesMem = ets:info(Yes3,memory),
@@ -2082,17 +2089,18 @@ write_concurrency(Config) when is_list(Config) ->
     YesMem = ets:info(Yes6,memory),
     NoHashMem = ets:info(No2,memory),
     NoHashMem = ets:info(No3,memory),
-    NoTreeMem = ets:info(No5,memory),
-    NoTreeMem = ets:info(No6,memory),
+    YesTreeMem = ets:info(Yes8,memory),
     NoHashMem = ets:info(No7,memory),
     NoHashMem = ets:info(No8,memory),
 
     case erlang:system_info(smp_support) of
 	true ->
 	    true = YesMem > NoHashMem,
-	    true = YesMem > NoTreeMem;
+	    true = YesMem > NoTreeMem,
+	    true = YesTreeMem > NoTreeMem;
 	false ->
-	    true = YesMem =:= NoHashMem
+	    true = YesMem =:= NoHashMem,
+	    true = YesTreeMem =:= NoTreeMem
     end,
 
     {'EXIT',{badarg,_}} = (catch ets_new(foo,[public,{write_concurrency,foo}])),
@@ -2101,12 +2109,136 @@ write_concurrency(Config) when is_list(Config) ->
     {'EXIT',{badarg,_}} = (catch ets_new(foo,[public,write_concurrency])),
 
     lists:foreach(fun(T) -> ets:delete(T) end,
-		  [Yes1,Yes2,Yes3,Yes4,Yes5,Yes6,
-		   No1,No2,No3,No4,No5,No6,No7,No8]),
+		  [Yes1,Yes2,Yes3,Yes4,Yes5,Yes6,Yes7,Yes8,
+		   No1,No2,No3,No4,No7,No8]),
     verify_etsmem(EtsMem),
     ok.
 
 
+%% The 'decentralized_counters' option.
+decentralized_counters(Config) when is_list(Config) ->
+    EtsMem = etsmem(),
+    Smp = erlang:system_info(smp_support),
+    Types = [set, bag, duplicate_bag],
+    Tabs = [ets_new(foo,[Type,public,{write_concurrency,true},
+                         {decentralized_counters,true}]) || Type <- Types],
+    lists:foreach(fun(T) ->
+                          Smp = ets:info(T,decentralized_counters),
+                          {decentralized_counters,Smp} =
+                              lists:keyfind(decentralized_counters,1,
+                                            ets:info(T))
+                  end, Tabs),
+    No1 = ets_new(foo,[public,{decentralized_counters,true}]),
+    No2 = ets_new(foo,[private,{write_concurrency,true},
+                       {decentralized_counters,true}]),
+    No3 = ets_new(foo,[public,{write_concurrency,true},
+                       {decentralized_counters,false}]),
+    No4 = ets_new(foo,[ordered_set,public,{write_concurrency,true},
+                       {decentralized_counters,true}]),
+    lists:foreach(fun(T) -> false = ets:info(T,decentralized_counters) end,
+                  [No1,No2,No3,No4]),
+
+    %% Counters must add up when updated from many schedulers
+    NumOfObjs = 20000,
+    lists:foreach(
+      fun(T) ->
+              Mem = ets:info(T,memory),
+              InitF = fun([ProcN,NumOfProcs|_]) -> {ProcN,NumOfProcs} end,
+              Insert = fun({Key,_}) when Key > NumOfObjs ->
+                               [end_of_work];
+                          ({Key,Increment}) ->
+                               true = ets:insert(T,{Key,Key}),
+                               {Key+Increment,Increment}
+                       end,
+              Delete = fun({Key,_}) when Key > NumOfObjs ->
+                               [end_of_work];
+                          ({Key,Increment}) ->
+                               true = ets:delete(T,Key),
+                               {Key+Increment,Increment}
+                       end,
+              FiniF = fun(_) -> ok end,
+              run_workers_do(InitF,Insert,FiniF,NumOfObjs),
+              NumOfObjs = ets:info(T,size),
+              NumOfObjs = length(ets:tab2list(T)),
+              true = ets:info(T,memory) > Mem,
+              run_workers_do(InitF,Delete,FiniF,NumOfObjs),
+              0 = ets:info(T,size),
+              filltabint(T,1000),
+              1000 = ets:select_delete(T,[{'_',[],[true]}]),
+              filltabint(T,1000),
+              true = ets:delete_all_objects(T),
+              0 = ets:info(T,size)
+      end, Tabs),
+
+    {'EXIT',{badarg,_}} = (catch ets_new(foo,[{decentralized_counters,foo}])),
+    {'EXIT',{badarg,_}} = (catch ets_new(foo,[decentralized_counters])),
+    lists:foreach(fun(T) -> ets:delete(T) end, Tabs ++ [No1,No2,No3,No4]),
+    verify_etsmem(EtsMem),
+    ok.
+
+%% The 'literal_objects' option.
+literal_objects(Config) when is_list(Config) ->
+    EtsMem = etsmem(),
+    Big = lists:seq(1,10000),
+    Types = [set, bag, duplicate_bag],
+    lists:foreach(fun(Type) -> literal_objects_do(Type, Big) end, Types),
+
+    %% Ignored for ordered_set and compressed tables
+    lists:foreach(fun(Opts) ->
+                          T = ets_new(foo,[literal_objects | Opts]),
+                          ets:insert(T,{key,0}),
+                          1 = ets:update_counter(T,key,1),
+                          ets:delete(T)
+                  end, [[ordered_set],[set,compressed]]),
+    verify_etsmem(EtsMem),
+    ok.
+
+literal_objects_do(Type, Big) ->
+    T = ets_new(foo,[Type,public,literal_objects]),
+    true = ets:insert(T,{key,Big}),
+    [Obj] = ets:lookup(T,key),
+    [Obj2] = ets:lookup(T,key),
+    true = erts_debug:same(Obj,Obj2),
+    Elem = case Type of
+               set -> ets:lookup_element(T,key,2);
+               _ -> hd(ets:lookup_element(T,key,2))
+           end,
+    Big = Elem,
+    true = erts_debug:same(element(2,Obj),Elem),
+
+    %% Objects are immutable
+    {'EXIT',{badarg,_}} = (catch ets:update_counter(T,key,{2,1})),
+    {'EXIT',{badarg,_}} = (catch ets:update_element(T,key,{2,0})),
+
+    %% Replaced and deleted objects must stay intact in processes and
+    %% messages that still refer them.
+    Self = self(),
+    Holders = [spawn_link(fun() ->
+                                  [{key,Held}] = ets:lookup(T,key),
+                                  Self ! {self(), ready},
+                                  receive go -> ok end,
+                                  erlang:garbage_collect(),
+                                  Self ! {self(), lists:sum(Held)}
+                          end) || _ <- lists:seq(1,10)],
+    [receive {H, ready} -> ok end || H <- Holders],
+    Msgr = spawn_link(fun() -> receive go -> ok end,
+                               receive {msg, M} -> Self ! {self(), lists:sum(M)} end
+                      end),
+    Msgr ! {msg, Elem},
+    true = ets:delete(T,key),
+    true = ets:insert(T,{key,[x]}),
+    case Type of
+        set -> [{key,[x]}] = ets:lookup(T,key);
+        _ -> ok
+    end,
+    true = ets:delete(T),
+    %% The old objects were queued for release by the deletes above
+    ok = erts_code_purger:release_literal_areas(),
+    Sum = lists:sum(Big),
+    [begin H ! go, receive {H, Sum} -> ok end end || H <- [Msgr | Holders]],
+    Sum = lists:sum(element(2,Obj)),
+    ok.
+
 %% The 'heir' option.
 heir(Config) when is_list(Config) ->
     repeat_for_opts(heir_do).
@@ -5448,6 +5580,54 @@ smp_select_delete(Config) when is_list(Config) ->
     false = ets:info(T,fixed),
     ets:delete(T).
 
+%% Concurrent updates and traversals of an ordered_set with
+%% write_concurrency, which adapts its locking to the contention.
+smp_ordered_set(Config) when is_list(Config) ->
+    EtsMem = etsmem(),
+    T = ets_new(smp_ordered_set,[ordered_set,public,{write_concurrency,true}]),
+    true = ets:info(T,write_concurrency),
+    ordered_set = ets:info(T,type),
+    InitF = fun(_) -> ok end,
+    ExecF = fun(State) ->
+		    Key = rand:uniform(10000),
+		    case rand:uniform(8) of
+			1 -> true = ets:insert(T,{Key,Key});
+			2 -> true = ets:delete(T,Key);
+			3 -> ets:lookup(T,Key);
+			4 -> ets:update_counter(T,Key,{2,1},{Key,Key});
+			5 -> check_next(T,Key,ets:next(T,Key));
+			6 -> check_prev(T,Key,ets:prev(T,Key));
+			7 -> ets:insert(T,[{{Key,I},I} || I <- lists:seq(1,10)]);
+			8 -> ets:select_count(T,[{{'$1','_'},[{'<','$1',Key}],[true]}])
+		    end,
+		    State
+	    end,
+    FiniF = fun(_) -> ok end,
+    run_workers(InitF,ExecF,FiniF,20000),
+    Keys = ets:select(T,[{{'$1','_'},[],['$1']}]),
+    Keys = lists:sort(Keys),
+    Keys = ordered_keys(T,ets:first(T)),
+    Keys = lists:reverse(ordered_keys_rev(T,ets:last(T))),
+    Size = length(Keys),
+    Size = ets:info(T,size),
+    true = ets:delete_all_objects(T),
+    0 = ets:info(T,size),
+    '$end_of_table' = ets:first(T),
+    ets:delete(T),
+    verify_etsmem(EtsMem).
+
+check_next(_T,_Key,'$end_of_table') -> ok;
+check_next(_T,Key,Next) when Next > Key -> ok.
+
+check_prev(_T,_Key,'$end_of_table') -> ok;
+check_prev(_T,Key,Prev) when Prev < Key -> ok.
+
+ordered_keys(_T,'$end_of_table') -> [];
+ordered_keys(T,Key) -> [Key | ordered_keys(T,ets:next(T,Key))].
+
+ordered_keys_rev(_T,'$end_of_table') -> [];
+ordered_keys_rev(T,Key) -> [Key | ordered_keys_rev(T,ets:prev(T,Key))].
+
 %% Test different types.
 types(Config) when is_list(Config) ->
     init_externals(),
@@ -28,7 +28,7 @@
 	 pcre_compile_workspace_overflow/1,re_infinite_loop/1, 
 	 re_backwards_accented/1,opt_dupnames/1,opt_all_names/1,inspect/1,
 	 opt_no_start_optimize/1,opt_never_utf/1,opt_ucp/1,
-	 match_limit/1,sub_binaries/1,copt/1]).
+	 match_limit/1,sub_binaries/1,copt/1,opt_jit/1]).
 
 -include_lib("common_test/include/ct.hrl").
 -include_lib("kernel/include/file.hrl").
@@ -45,7 +45,7 @@ all() ->
      pcre_compile_workspace_overflow, re_infinite_loop, 
      re_backwards_accented, opt_dupnames, opt_all_names, 
      inspect, opt_no_start_optimize,opt_never_utf,opt_ucp,
-     match_limit, sub_binaries].
+     match_limit, sub_binaries, opt_jit].
 
 groups() -> 
     [].
@@ -887,3 +887,45 @@ sub_binaries(Config) when is_list(Config) ->
     {match,[D]}=re:run(Bin,"(a)",[{capture,[1],binary}]),
     255 = binary:referenced_byte_size(D),
     ok.
+
+%% Test that patterns compiled with the jit option give the same
+%% results as interpreted ones, also when run in the interpreter.
+opt_jit(Config) when is_list(Config) ->
+    {ok,MPI} = re:compile("(?<A>a+)(b|c)*d"),
+    {jit,false} = re:inspect(MPI,jit),
+    {ok,MP} = re:compile("(?<A>a+)(b|c)*d",[jit]),
+    {namelist,[<<"A">>]} = re:inspect(MP,namelist),
+    {'EXIT',{badarg,_}} = (catch re:run("aad",MP,[jit])),
+    {'EXIT',{badarg,_}} = (catch re:inspect(MP,jitk)),
+    Subjects = [<<"xxxaaabcbcd">>, "aaab", "ad", <<>>, [$a,<<"cd">>],
+		binary:copy(<<"bc">>,100000)],
+    Opts = [[], [{capture,all,binary}], [{capture,['A'],list}],
+	    [notbol], [{offset,4}], [anchored], [global],
+	    [{match_limit,5},report_errors]],
+    _ = [ Res = (catch re:run(S,MP,O)) || S <- Subjects, O <- Opts,
+					  Res <- [(catch re:run(S,MPI,O))]],
+    %% The machine code is not part of the external format
+    MPE = binary_to_term(term_to_binary(MP)),
+    {jit,false} = re:inspect(MPE,jit),
+    {match,[{3,8},{3,3},{9,1}]} = re:run(<<"xxxaaabcbcd">>,MPE),
+    %% Excessive backtracking and long subjects end up in the interpreter
+    Str = "http:/www.flickr.com/slideShow/index.gne?group_id=&user_id=69845378@N0",
+    {ok,EMail} = re:compile("[a-z0-9!#$%&'*+/=?^_`{|}~-]+"
+			    "(\.[a-z0-9!#$%&'*+/=?^_`{|}~-]+)*"
+			    "@.*([a-z0-9](?:[a-z0-9-]*[a-z0-9])?\.)+"
+			    "([a-zA-Z]{2}|com|org|net|gov|mil"
+			    "|biz|info|mobi|name|aero|jobs|museum)",[jit]),
+    nomatch = re:run(Str,EMail),
+    {error,match_limit} = re:run(Str,EMail,[report_errors]),
+    Long = <<(binary:copy(<<"ab">>,1000000))/binary,"abd">>,
+    {match,[{2000000,3}]} = re:run(Long,"b+d|ab+d$",[jit]),
+    {ok,UMP} = re:compile("\\x{e4}+",[unicode,jit]),
+    {match,[<<"\x{e4}\x{e4}"/utf8>>]} =
+	re:run([$a,16#e5,16#e4,16#e4],UMP,[{capture,all,binary}]),
+    [<<"a">>,<<"b">>,<<"c">>,<<>>] = re:split("a1b2c3","[0-9]",[jit]),
+    "aXbXcX" = re:replace("a1b2c3","[0-9]","X",
+			  [jit,global,{return,list}]),
+    case re:inspect(MP,jit) of
+	{jit,true} -> ok;
+	{jit,false} -> {comment,"No JIT on this platform"}
+    end.
@@ -0,0 +1,2 @@
+{groups,"../stdlib_test",unicode_SUITE,[unicode_bench]}.
+{groups,"../stdlib_test",binary_module_SUITE,[binary_bench]}.
@@ -20,6 +20,7 @@
 -module(unicode_SUITE).
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
 -export([all/0, suite/0,groups/0,
 	 utf8_illegal_sequences_bif/1,
@@ -29,6 +30,8 @@
 	 latin1/1,
 	 exceptions/1,
 	 binaries_errors_limit/1,
+	 long_binaries_errors/1,
+	 utf8_conversion_bench/1,
 	 ex_binaries_errors_utf8/1,
 	 ex_binaries_errors_utf16_little/1,
 	 ex_binaries_errors_utf16_big/1,
@@ -43,7 +46,7 @@ all() ->
     [utf8_illegal_sequences_bif,
      utf16_illegal_sequences_bif, random_lists, roundtrips,
      latin1, exceptions,
-     binaries_errors_limit,
+     binaries_errors_limit, long_binaries_errors,
      {group,binaries_errors}].
 
 groups() -> 
@@ -52,7 +55,8 @@ groups() ->
        ex_binaries_errors_utf16_little,
        ex_binaries_errors_utf16_big,
        ex_binaries_errors_utf32_little,
-       ex_binaries_errors_utf32_big]}].
+       ex_binaries_errors_utf32_big]},
+     {unicode_bench,[],[utf8_conversion_bench]}].
 
 binaries_errors_limit(Config) when is_list(Config) ->
     setlimit(10),
@@ -60,6 +64,44 @@ binaries_errors_limit(Config) when is_list(Config) ->
     setlimit(default),
     ok.
 
+%% Invalid and incomplete characters at all offsets within binaries
+%% long enough to be validated a block at a time.
+long_binaries_errors(Config) when is_list(Config) ->
+    long_binaries_errors_do(),
+    setlimit(10),
+    long_binaries_errors_do(),
+    setlimit(default),
+    ok.
+
+long_binaries_errors_do() ->
+    Chars = [$a,16#E9,16#20AC,16#1F600,16#4E2D,$z],
+    Bad = [<<16#80>>,<<16#C0,16#80>>,<<16#E0,16#80,16#80>>,
+	   <<16#ED,16#A0,16#80>>,<<16#F4,16#90,16#80,16#80>>,<<16#F8>>],
+    Incomplete = [<<16#C3>>,<<16#E2,16#82>>,<<16#F0,16#9F,16#98>>],
+    Tail = binary:copy(<<"abc",16#4E2D/utf8>>, 20),
+    [begin
+	 Prefix = << <<(lists:nth(I rem length(Chars) + 1, Chars))/utf8>>
+		     || I <- lists:seq(S, S + N) >>,
+	 L = unicode:characters_to_list(Prefix),
+	 [begin
+	      Rest = <<E/binary,T/binary>>,
+	      Bin = <<Prefix/binary,Rest/binary>>,
+	      {error,L,RestL} = unicode:characters_to_list(Bin),
+	      Rest = iolist_to_binary(RestL),
+	      {error,Prefix,RestB} = unicode:characters_to_binary(Bin),
+	      Rest = iolist_to_binary(RestB)
+	  end || E <- Bad ++ Incomplete, T <- [<<>>,Tail],
+		 not (T =:= <<>> andalso lists:member(E, Incomplete))],
+	 [begin
+	      Bin = <<Prefix/binary,E/binary>>,
+	      {incomplete,L,E} = unicode:characters_to_list(Bin),
+	      {incomplete,Prefix,E} = unicode:characters_to_binary(Bin)
+	  end || E <- Incomplete],
+	 L = unicode:characters_to_list(Prefix),
+	 Prefix = unicode:characters_to_binary(L)
+     end || S <- lists:seq(1, length(Chars)), N <- lists:seq(0, 80)],
+    ok.
+
 ex_binaries_errors_utf8(Config) when is_list(Config) ->
     %% Original smoke test, we should not forget the original offset...
     <<_:8,_:8,RR2/binary>> = <<$a,$b,164,165,$c>>,
@@ -1281,6 +1323,54 @@ make_unaligned(Bin0) when is_binary(Bin0) ->
 
 id(I) -> I.
 
+%% Throughput of characters_to_list/1 and characters_to_binary/1 on utf8
+%% binaries, reported in MB/s.
+utf8_conversion_bench(Config) when is_list(Config) ->
+    Size = 4 bsl 20,
+    Inputs = [{"ascii", bench_input("{\"key\": \"value\", \"n\": 12345},\n", Size)},
+	      {"mixed", bench_input("{\"namn\": \"Åsa Öberg\", \"ort\": \"Malmö\"},\n",
+				    Size)},
+	      {"cjk", bench_input([16#6F22,16#5B57,16#306E,16#30C6,16#30AD,
+				   16#30B9,16#30C8,16#4E2D,16#6587], Size)}],
+    Results =
+	[begin
+	     BinList = unicode:characters_to_list(Bin),
+	     ToList = bench_rate(fun() -> unicode:characters_to_list(Bin) end,
+				 byte_size(Bin)),
+	     ToBin = bench_rate(fun() -> unicode:characters_to_binary(
+					   [<<>>,Bin]) end,
+				byte_size(Bin)),
+	     FromList = bench_rate(fun() -> unicode:characters_to_binary(
+					      BinList) end,
+				   byte_size(Bin)),
+	     [{Name ++ "_to_list", ToList},
+	      {Name ++ "_to_binary", ToBin},
+	      {Name ++ "_from_list", FromList}]
+	 end || {Name, Bin} <- Inputs],
+    [ct_event:notify(#event{name = benchmark_data,
+			    data = [{suite,"unicode"},
+				    {name,Name},
+				    {value,Value}]})
+     || {Name, Value} <- lists:append(Results)],
+    {comment, lists:flatten(io_lib:format("~p MB/s",
+					  [lists:append(Results)]))}.
+
+bench_input(Chars, Size) ->
+    Bin = unicode:characters_to_binary(Chars),
+    binary:copy(Bin, Size div byte_size(Bin)).
+
+bench_rate(Fun, Bytes) ->
+    N = 10,
+    Fun(),
+    {Time, _} = timer:tc(fun() -> bench_loop(Fun, N) end),
+    N * Bytes div max(Time, 1).
+
+bench_loop(_Fun, 0) ->
+    ok;
+bench_loop(Fun, N) ->
+    _ = Fun(),
+    bench_loop(Fun, N-1).
+
 setlimit(X) ->
     erts_debug:set_internal_state(available_internal_state,true),
     io:format("Setting loop limit, old: ~p, now set to ~p~n",